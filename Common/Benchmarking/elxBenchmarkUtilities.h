@@ -0,0 +1,184 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef elxBenchmarkUtilities_h
+#define elxBenchmarkUtilities_h
+
+#include <itkContinuousIndex.h>
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+// Google Benchmark header file:
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace elastix
+{
+namespace BenchmarkUtilities
+{
+
+/// Creates a cubic image of the specified size, filled with a smooth blob whose center is shifted by the specified
+/// number of pixels, so that a moving image created with a different shift has to be registered to the fixed image.
+template <typename TImage>
+typename TImage::Pointer
+CreateImage(const itk::SizeValueType size, const double shift)
+{
+  const auto image = TImage::New();
+  image->SetRegions(TImage::SizeType::Filled(size));
+  image->Allocate();
+
+  const double center = 0.5 * static_cast<double>(size - 1) + shift;
+  const double sigma = 0.25 * static_cast<double>(size);
+
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    double squaredDistance = 0.0;
+    double ripple = 0.0;
+    for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+    {
+      const double x = static_cast<double>(it.GetIndex()[d]) - center;
+      squaredDistance += x * x;
+      ripple += std::sin(0.3 * x);
+    }
+    it.Set(static_cast<typename TImage::PixelType>(100.0 * std::exp(-squaredDistance / (2.0 * sigma * sigma)) +
+                                                   5.0 * ripple));
+  }
+  return image;
+}
+
+
+/// Creates a B-spline transform whose control point grid covers the specified image, with the specified number of
+/// control points along each dimension. The parameters describe a small smooth deformation. They are stored in the
+/// specified parameters object, because the transform only refers to them.
+template <typename TTransform, typename TImage>
+typename TTransform::Pointer
+CreateBSplineTransform(const TImage &                        image,
+                       const itk::SizeValueType              gridSize,
+                       typename TTransform::ParametersType & parameters)
+{
+  const unsigned int SplineOrder = TTransform::SplineOrder;
+  const auto         numberOfIntervals = gridSize - SplineOrder;
+  const auto         imageSize = image.GetBufferedRegion().GetSize();
+
+  typename TTransform::OriginType  origin;
+  typename TTransform::SpacingType spacing;
+  for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+  {
+    spacing[d] = image.GetSpacing()[d] * static_cast<double>(imageSize[d] - 1) / static_cast<double>(numberOfIntervals);
+    origin[d] = image.GetOrigin()[d] - spacing[d] * static_cast<double>(SplineOrder - 1) / 2.0;
+  }
+  typename TTransform::RegionType region;
+  region.SetSize(TTransform::SizeType::Filled(gridSize));
+
+  const auto transform = TTransform::New();
+  transform->SetGridOrigin(origin);
+  transform->SetGridSpacing(spacing);
+  transform->SetGridRegion(region);
+
+  parameters.SetSize(transform->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = 0.5 * std::sin(0.37 * i);
+  }
+  transform->SetParameters(parameters);
+  return transform;
+}
+
+
+/// Creates random continuous indices inside the buffered region of the specified image. A fixed seed is used, so that
+/// every run evaluates the same indices.
+template <typename TImage>
+std::vector<itk::ContinuousIndex<double, TImage::ImageDimension>>
+CreateRandomContinuousIndices(const TImage & image, const std::size_t numberOfIndices)
+{
+  const auto region = image.GetBufferedRegion();
+
+  std::mt19937                                                      randomNumberEngine{};
+  std::vector<itk::ContinuousIndex<double, TImage::ImageDimension>> indices(numberOfIndices);
+
+  for (auto & index : indices)
+  {
+    for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+    {
+      std::uniform_real_distribution<double> distribution(
+        static_cast<double>(region.GetIndex(d)),
+        static_cast<double>(region.GetIndex(d) + static_cast<itk::IndexValueType>(region.GetSize(d)) - 1));
+      index[d] = distribution(randomNumberEngine);
+    }
+  }
+  return indices;
+}
+
+
+/// Creates random physical points inside the buffered region of the specified image.
+template <typename TImage>
+std::vector<typename TImage::PointType>
+CreateRandomPoints(const TImage & image, const std::size_t numberOfPoints)
+{
+  const auto indices = CreateRandomContinuousIndices(image, numberOfPoints);
+
+  std::vector<typename TImage::PointType> points(numberOfPoints);
+  for (std::size_t i = 0; i < numberOfPoints; ++i)
+  {
+    image.TransformContinuousIndexToPhysicalPoint(indices[i], points[i]);
+  }
+  return points;
+}
+
+
+/// Adds the cartesian product of the specified argument values to a benchmark. The arguments are named, so that they
+/// appear in the names of the benchmarks, and in their JSON output.
+inline void
+AddArgumentsProduct(benchmark::internal::Benchmark &               benchmark,
+                    const std::vector<std::string> &               names,
+                    const std::vector<std::vector<std::int64_t>> & values)
+{
+  benchmark.ArgNames(names);
+
+  std::vector<std::size_t> position(values.size(), 0);
+  while (true)
+  {
+    std::vector<std::int64_t> arguments;
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+      arguments.push_back(values[i][position[i]]);
+    }
+    benchmark.Args(arguments);
+
+    /** Go to the next combination, the last argument changing fastest. */
+    std::size_t i = values.size();
+    while (i > 0 && ++position[i - 1] == values[i - 1].size())
+    {
+      position[--i] = 0;
+    }
+    if (i == 0)
+    {
+      break;
+    }
+  }
+}
+
+} // namespace BenchmarkUtilities
+} // namespace elastix
+
+
+#endif
@@ -0,0 +1,126 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header files to be benchmarked:
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkRecursiveBSplineTransform.h"
+
+#include "elxBenchmarkUtilities.h"
+
+#include <itkImage.h>
+
+// Google Benchmark header file:
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace
+{
+using elastix::BenchmarkUtilities::AddArgumentsProduct;
+using elastix::BenchmarkUtilities::CreateBSplineTransform;
+using elastix::BenchmarkUtilities::CreateImage;
+using elastix::BenchmarkUtilities::CreateRandomPoints;
+
+template <typename TScalar, unsigned int VDimension>
+using BSplineTransform = itk::AdvancedBSplineDeformableTransform<TScalar, VDimension, 3>;
+template <typename TScalar, unsigned int VDimension>
+using RecursiveBSplineTransform = itk::RecursiveBSplineTransform<TScalar, VDimension, 3>;
+
+/** The size of the image whose domain is covered by the control point grid. */
+constexpr itk::SizeValueType ImageSize = 64;
+
+
+// Adds the numbers of control points along each dimension, and the numbers of points of the transform benchmarks.
+void
+TransformArguments(benchmark::internal::Benchmark * benchmark)
+{
+  AddArgumentsProduct(*benchmark, { "grid", "points" }, { { 8, 32 }, { 4096 } });
+}
+
+
+// Benchmarks transforming points, like the metrics do for each sample.
+template <template <typename, unsigned int> class TTransform, unsigned int VDimension>
+void
+BSplineTransformPoint(benchmark::State & state)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using TransformType = TTransform<double, VDimension>;
+
+  const auto                             image = CreateImage<ImageType>(ImageSize, 0.0);
+  typename TransformType::ParametersType parameters;
+  const auto                             transform =
+    CreateBSplineTransform<TransformType>(*image, static_cast<itk::SizeValueType>(state.range(0)), parameters);
+  const auto points = CreateRandomPoints(*image, static_cast<std::size_t>(state.range(1)));
+
+  for (auto _ : state)
+  {
+    for (const auto & point : points)
+    {
+      benchmark::DoNotOptimize(transform->TransformPoint(point));
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * points.size()));
+}
+
+
+// Benchmarks the product of the transform Jacobian and the moving image gradient, like the metrics compute it for
+// each sample to get the derivative.
+template <template <typename, unsigned int> class TTransform, unsigned int VDimension>
+void
+BSplineJacobianWithImageGradientProduct(benchmark::State & state)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using TransformType = TTransform<double, VDimension>;
+
+  const auto                             image = CreateImage<ImageType>(ImageSize, 0.0);
+  typename TransformType::ParametersType parameters;
+  const auto                             transform =
+    CreateBSplineTransform<TransformType>(*image, static_cast<itk::SizeValueType>(state.range(0)), parameters);
+  const auto points = CreateRandomPoints(*image, static_cast<std::size_t>(state.range(1)));
+
+  typename TransformType::MovingImageGradientType movingImageGradient;
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    movingImageGradient[d] = 1.0 + d;
+  }
+  const auto                                         nnzji = transform->GetNumberOfNonZeroJacobianIndices();
+  typename TransformType::DerivativeType             imageJacobian(nnzji);
+  typename TransformType::NonZeroJacobianIndicesType nzji(nnzji);
+
+  for (auto _ : state)
+  {
+    for (const auto & point : points)
+    {
+      transform->EvaluateJacobianWithImageGradientProduct(point, movingImageGradient, imageJacobian, nzji);
+      benchmark::DoNotOptimize(imageJacobian.data_block());
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * points.size()));
+}
+
+} // namespace
+
+
+BENCHMARK_TEMPLATE(BSplineTransformPoint, BSplineTransform, 2)->Apply(TransformArguments);
+BENCHMARK_TEMPLATE(BSplineTransformPoint, BSplineTransform, 3)->Apply(TransformArguments);
+BENCHMARK_TEMPLATE(BSplineTransformPoint, RecursiveBSplineTransform, 2)->Apply(TransformArguments);
+BENCHMARK_TEMPLATE(BSplineTransformPoint, RecursiveBSplineTransform, 3)->Apply(TransformArguments);
+BENCHMARK_TEMPLATE(BSplineJacobianWithImageGradientProduct, BSplineTransform, 2)->Apply(TransformArguments);
+BENCHMARK_TEMPLATE(BSplineJacobianWithImageGradientProduct, BSplineTransform, 3)->Apply(TransformArguments);
+BENCHMARK_TEMPLATE(BSplineJacobianWithImageGradientProduct, RecursiveBSplineTransform, 2)->Apply(TransformArguments);
+BENCHMARK_TEMPLATE(BSplineJacobianWithImageGradientProduct, RecursiveBSplineTransform, 3)->Apply(TransformArguments);
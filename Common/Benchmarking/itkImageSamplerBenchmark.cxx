@@ -0,0 +1,181 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header files to be benchmarked:
+#include "itkImageFullSampler.h"
+#include "itkImageGridSampler.h"
+#include "itkImageRandomCoordinateSampler.h"
+#include "itkImageRandomSampler.h"
+#include "itkImageRandomSamplerSparseMask.h"
+#include "itkMultiInputImageRandomCoordinateSampler.h"
+
+#include "elxBenchmarkUtilities.h"
+
+#include <itkImage.h>
+#include <itkImageMaskSpatialObject.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+// Google Benchmark header file:
+#include <benchmark/benchmark.h>
+
+#include <type_traits> // For is_same
+
+namespace
+{
+using elastix::BenchmarkUtilities::AddArgumentsProduct;
+using elastix::BenchmarkUtilities::CreateImage;
+
+
+// Adds the image sizes, numbers of samples and numbers of threads of the sampler benchmarks.
+template <unsigned int VDimension>
+void
+SamplerArguments(benchmark::internal::Benchmark * benchmark)
+{
+  AddArgumentsProduct(*benchmark,
+                      { "size", "samples", "threads" },
+                      { VDimension == 2 ? std::vector<std::int64_t>{ 64, 256 } : std::vector<std::int64_t>{ 32, 96 },
+                        { 2048, 16384 },
+                        { 1, 4 } });
+}
+
+
+// Adds the image sizes and numbers of threads of the full sampler benchmarks, which take every pixel as a sample.
+template <unsigned int VDimension>
+void
+FullSamplerArguments(benchmark::internal::Benchmark * benchmark)
+{
+  AddArgumentsProduct(
+    *benchmark,
+    { "size", "threads" },
+    { VDimension == 2 ? std::vector<std::int64_t>{ 64, 256 } : std::vector<std::int64_t>{ 32, 96 }, { 1, 4 } });
+}
+
+
+// The samplers that only need an input image need no further configuration.
+template <typename TImage>
+void
+ConfigureSampler(itk::Object &, const TImage &)
+{}
+
+
+// The sparse mask sampler needs a mask. It gets a ball that covers about a third of a 2D and a sixth of a 3D image.
+template <typename TImage>
+void
+ConfigureSampler(itk::ImageRandomSamplerSparseMask<TImage> & sampler, const TImage & image)
+{
+  constexpr unsigned int Dimension = TImage::ImageDimension;
+  using MaskImageType = itk::Image<unsigned char, Dimension>;
+  using MaskSpatialObjectType = itk::ImageMaskSpatialObject<Dimension>;
+
+  const auto & region = image.GetBufferedRegion();
+  const auto   maskImage = MaskImageType::New();
+  maskImage->CopyInformation(&image);
+  maskImage->SetRegions(region);
+  maskImage->Allocate(true);
+
+  const double radius = region.GetSize(0) / 3.0;
+  for (itk::ImageRegionIteratorWithIndex<MaskImageType> it(maskImage, region); !it.IsAtEnd(); ++it)
+  {
+    double squaredDistance = 0.0;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      const double offset = it.GetIndex()[d] - region.GetIndex(d) - (region.GetSize(d) - 1) / 2.0;
+      squaredDistance += offset * offset;
+    }
+    it.Set(squaredDistance <= radius * radius ? 1 : 0);
+  }
+
+  const auto mask = MaskSpatialObjectType::New();
+  mask->SetImage(maskImage);
+  mask->Update();
+  sampler.SetMask(mask);
+}
+
+
+// The multi-input sampler gets a second, shifted, input image, which shares the input image region of the first.
+template <typename TImage>
+void
+ConfigureSampler(itk::MultiInputImageRandomCoordinateSampler<TImage> & sampler, const TImage & image)
+{
+  sampler.SetInput(1, CreateImage<TImage>(image.GetBufferedRegion().GetSize(0), 2.0));
+}
+
+
+// Benchmarks selecting a new set of samples, like the metrics do in each iteration when NewSamplesEveryIteration
+// is true.
+template <template <class> class TSampler, unsigned int VDimension>
+void
+ImageSamplerUpdate(benchmark::State & state)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using SamplerType = TSampler<ImageType>;
+
+  /** The full sampler has no number of samples argument. */
+  const bool isFullSampler = std::is_same<SamplerType, itk::ImageFullSampler<ImageType>>::value;
+  const auto image = CreateImage<ImageType>(static_cast<itk::SizeValueType>(state.range(0)), 0.0);
+
+  const auto sampler = SamplerType::New();
+  sampler->SetInput(image);
+  sampler->SetInputImageRegion(image->GetBufferedRegion());
+  if (isFullSampler)
+  {
+    sampler->SetNumberOfWorkUnits(static_cast<itk::ThreadIdType>(state.range(1)));
+  }
+  else
+  {
+    sampler->SetNumberOfSamples(static_cast<unsigned long>(state.range(1)));
+    sampler->SetNumberOfWorkUnits(static_cast<itk::ThreadIdType>(state.range(2)));
+  }
+  ConfigureSampler(*sampler, *image);
+
+  for (auto _ : state)
+  {
+    sampler->Modified();
+    sampler->Update();
+    benchmark::DoNotOptimize(sampler->GetOutput()->data());
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * sampler->GetOutput()->size()));
+}
+
+} // namespace
+
+
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::ImageFullSampler, 2)->Apply(FullSamplerArguments<2>)->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::ImageFullSampler, 3)->Apply(FullSamplerArguments<3>)->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::ImageGridSampler, 2)->Apply(SamplerArguments<2>)->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::ImageGridSampler, 3)->Apply(SamplerArguments<3>)->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::ImageRandomSampler, 2)->Apply(SamplerArguments<2>)->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::ImageRandomSampler, 3)->Apply(SamplerArguments<3>)->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::ImageRandomCoordinateSampler, 2)
+  ->Apply(SamplerArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::ImageRandomCoordinateSampler, 3)
+  ->Apply(SamplerArguments<3>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::ImageRandomSamplerSparseMask, 2)
+  ->Apply(SamplerArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::ImageRandomSamplerSparseMask, 3)
+  ->Apply(SamplerArguments<3>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::MultiInputImageRandomCoordinateSampler, 2)
+  ->Apply(SamplerArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(ImageSamplerUpdate, itk::MultiInputImageRandomCoordinateSampler, 3)
+  ->Apply(SamplerArguments<3>)
+  ->UseRealTime();
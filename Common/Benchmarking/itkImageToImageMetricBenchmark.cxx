@@ -0,0 +1,281 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header files to be benchmarked:
+#include "AdvancedKappaStatistic/itkAdvancedKappaStatisticImageToImageMetric.h"
+#include "AdvancedMattesMutualInformation/itkParzenWindowMutualInformationImageToImageMetric.h"
+#include "AdvancedMeanSquares/itkAdvancedMeanSquaresImageToImageMetric.h"
+#include "AdvancedNormalizedCorrelation/itkAdvancedNormalizedCorrelationImageToImageMetric.h"
+#include "BendingEnergyPenalty/itkTransformBendingEnergyPenaltyTerm.h"
+#include "GradientDifference/itkGradientDifferenceImageToImageMetric2.h"
+#include "NormalizedMutualInformation/itkParzenWindowNormalizedMutualInformationImageToImageMetric.h"
+#include "PatternIntensity/itkPatternIntensityImageToImageMetric.h"
+#include "SumSquaredTissueVolumeDifferenceMetric/itkSumSquaredTissueVolumeDifferenceImageToImageMetric.h"
+
+#include "elxBenchmarkUtilities.h"
+#include "elxElastixMain.h" // For xoutManager.
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkExponentialLimiterFunction.h"
+#include "itkHardLimiterFunction.h"
+#include "itkImageRandomCoordinateSampler.h"
+
+#include <itkBSplineInterpolateImageFunction.h>
+#include <itkImage.h>
+
+// Google Benchmark header file:
+#include <benchmark/benchmark.h>
+
+namespace
+{
+using elastix::BenchmarkUtilities::AddArgumentsProduct;
+using elastix::BenchmarkUtilities::CreateBSplineTransform;
+using elastix::BenchmarkUtilities::CreateImage;
+
+/** The number of control points along each dimension of the B-spline transform. */
+constexpr itk::SizeValueType GridSize = 8;
+
+/** The bending energy penalty is templated over the fixed image and the scalar type of the transform, instead of
+ * over the fixed and the moving image. */
+template <typename TFixedImage, typename TMovingImage>
+using TransformBendingEnergyPenalty = itk::TransformBendingEnergyPenaltyTerm<TFixedImage, double>;
+
+
+// Adds the image sizes, numbers of samples and numbers of threads of the metric benchmarks.
+template <unsigned int VDimension>
+void
+MetricArguments(benchmark::internal::Benchmark * benchmark)
+{
+  AddArgumentsProduct(*benchmark,
+                      { "size", "samples", "threads" },
+                      { VDimension == 2 ? std::vector<std::int64_t>{ 64, 256 } : std::vector<std::int64_t>{ 32, 96 },
+                        { 2048, 16384 },
+                        { 1, 4 } });
+}
+
+
+// Adds the image sizes and numbers of threads of the benchmarks of the metrics that compare all pixels, instead of
+// samples. The 3D sizes are smaller, as these metrics visit a neighborhood of each pixel.
+template <unsigned int VDimension>
+void
+FullImageMetricArguments(benchmark::internal::Benchmark * benchmark)
+{
+  AddArgumentsProduct(
+    *benchmark,
+    { "size", "threads" },
+    { VDimension == 2 ? std::vector<std::int64_t>{ 64, 256 } : std::vector<std::int64_t>{ 32, 64 }, { 1, 4 } });
+}
+
+
+// The metrics that only compare intensities need no further configuration.
+void
+ConfigureMetric(itk::Object &)
+{}
+
+
+// Configures the histogram based metrics like elastix does by default, with 32 histogram bins and without the
+// explicit PDF derivatives (UseFastAndLowMemoryVersion).
+template <typename TFixedImage, typename TMovingImage>
+void
+ConfigureMetric(itk::ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage> & metric)
+{
+  metric.SetNumberOfFixedHistogramBins(32);
+  metric.SetNumberOfMovingHistogramBins(32);
+  metric.SetFixedKernelBSplineOrder(0);
+  metric.SetMovingKernelBSplineOrder(3);
+  metric.SetUseExplicitPDFDerivatives(false);
+}
+
+
+// The benchmark images have no specific label, so the kappa statistic compares the nonzero pixels.
+template <typename TFixedImage, typename TMovingImage>
+void
+ConfigureMetric(itk::AdvancedKappaStatisticImageToImageMetric<TFixedImage, TMovingImage> & metric)
+{
+  metric.SetUseForegroundValue(false);
+}
+
+
+// Benchmarks GetValueAndDerivative of a metric with a cubic B-spline transform, a linear B-spline interpolator and a
+// random coordinate sampler that selects new samples in each iteration, which is the default of elastix.
+template <template <typename, typename> class TMetric, unsigned int VDimension>
+void
+MetricGetValueAndDerivative(benchmark::State & state)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using MetricType = TMetric<ImageType, ImageType>;
+  using TransformType = itk::AdvancedBSplineDeformableTransform<double, VDimension, 3>;
+  using InterpolatorType = itk::BSplineInterpolateImageFunction<ImageType, double, double>;
+  using SamplerType = itk::ImageRandomCoordinateSampler<ImageType>;
+  using RealType = typename MetricType::RealType;
+
+  /** The metric writes to xout while it is initialized. */
+  const elastix::xoutManager manager("", false, false);
+
+  const auto size = static_cast<itk::SizeValueType>(state.range(0));
+  const auto fixedImage = CreateImage<ImageType>(size, 0.0);
+  const auto movingImage = CreateImage<ImageType>(size, 2.0);
+
+  typename TransformType::ParametersType parameters;
+  const auto transform = CreateBSplineTransform<TransformType>(*fixedImage, GridSize, parameters);
+
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetSplineOrder(1);
+
+  const auto sampler = SamplerType::New();
+  sampler->SetNumberOfSamples(static_cast<unsigned long>(state.range(1)));
+
+  const auto metric = MetricType::New();
+  metric->SetFixedImage(fixedImage);
+  metric->SetMovingImage(movingImage);
+  metric->SetFixedImageRegion(fixedImage->GetBufferedRegion());
+  metric->SetTransform(transform);
+  metric->SetInterpolator(interpolator);
+  metric->SetImageSampler(sampler);
+  metric->SetUseMetricSingleThreaded(false);
+  metric->SetUseMultiThread(true);
+  metric->SetNumberOfWorkUnits(static_cast<itk::ThreadIdType>(state.range(2)));
+  if (metric->GetUseFixedImageLimiter())
+  {
+    metric->SetFixedImageLimiter(itk::HardLimiterFunction<RealType, VDimension>::New());
+  }
+  if (metric->GetUseMovingImageLimiter())
+  {
+    metric->SetMovingImageLimiter(itk::ExponentialLimiterFunction<RealType, VDimension>::New());
+  }
+  ConfigureMetric(*metric);
+  metric->Initialize();
+
+  typename MetricType::MeasureType    value{};
+  typename MetricType::DerivativeType derivative(metric->GetNumberOfParameters());
+
+  for (auto _ : state)
+  {
+    sampler->SelectNewSamplesOnUpdate();
+    metric->GetValueAndDerivative(parameters, value, derivative);
+    benchmark::DoNotOptimize(value);
+    benchmark::DoNotOptimize(derivative.data_block());
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(1));
+}
+
+
+// Benchmarks GetValueAndDerivative of a metric that compares all pixels of the fixed image, and so has no image
+// sampler, with a cubic B-spline transform and a linear B-spline interpolator. Without a ray casting interpolator,
+// these metrics compute the derivative analytically.
+template <template <typename, typename> class TMetric, unsigned int VDimension>
+void
+FullImageMetricGetValueAndDerivative(benchmark::State & state)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using MetricType = TMetric<ImageType, ImageType>;
+  using TransformType = itk::AdvancedBSplineDeformableTransform<double, VDimension, 3>;
+  using InterpolatorType = itk::BSplineInterpolateImageFunction<ImageType, double, double>;
+
+  /** The metric writes to xout while it is initialized. */
+  const elastix::xoutManager manager("", false, false);
+
+  const auto size = static_cast<itk::SizeValueType>(state.range(0));
+  const auto fixedImage = CreateImage<ImageType>(size, 0.0);
+  const auto movingImage = CreateImage<ImageType>(size, 2.0);
+
+  typename TransformType::ParametersType parameters;
+  const auto transform = CreateBSplineTransform<TransformType>(*fixedImage, GridSize, parameters);
+
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetSplineOrder(1);
+
+  const auto metric = MetricType::New();
+  metric->SetFixedImage(fixedImage);
+  metric->SetMovingImage(movingImage);
+  metric->SetFixedImageRegion(fixedImage->GetBufferedRegion());
+  metric->SetTransform(transform);
+  metric->SetInterpolator(interpolator);
+  metric->SetUseMetricSingleThreaded(false);
+  metric->SetUseMultiThread(true);
+  metric->SetNumberOfWorkUnits(static_cast<itk::ThreadIdType>(state.range(1)));
+  metric->Initialize();
+
+  typename MetricType::MeasureType    value{};
+  typename MetricType::DerivativeType derivative(metric->GetNumberOfParameters());
+
+  for (auto _ : state)
+  {
+    metric->GetValueAndDerivative(parameters, value, derivative);
+    benchmark::DoNotOptimize(value);
+    benchmark::DoNotOptimize(derivative.data_block());
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() *
+                                                    fixedImage->GetBufferedRegion().GetNumberOfPixels()));
+}
+
+} // namespace
+
+
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::AdvancedMeanSquaresImageToImageMetric, 2)
+  ->Apply(MetricArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::AdvancedMeanSquaresImageToImageMetric, 3)
+  ->Apply(MetricArguments<3>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::AdvancedNormalizedCorrelationImageToImageMetric, 2)
+  ->Apply(MetricArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::AdvancedNormalizedCorrelationImageToImageMetric, 3)
+  ->Apply(MetricArguments<3>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::ParzenWindowMutualInformationImageToImageMetric, 2)
+  ->Apply(MetricArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::ParzenWindowMutualInformationImageToImageMetric, 3)
+  ->Apply(MetricArguments<3>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::ParzenWindowNormalizedMutualInformationImageToImageMetric, 2)
+  ->Apply(MetricArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::ParzenWindowNormalizedMutualInformationImageToImageMetric, 3)
+  ->Apply(MetricArguments<3>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::AdvancedKappaStatisticImageToImageMetric, 2)
+  ->Apply(MetricArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::AdvancedKappaStatisticImageToImageMetric, 3)
+  ->Apply(MetricArguments<3>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::SumSquaredTissueVolumeDifferenceImageToImageMetric, 2)
+  ->Apply(MetricArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, itk::SumSquaredTissueVolumeDifferenceImageToImageMetric, 3)
+  ->Apply(MetricArguments<3>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, TransformBendingEnergyPenalty, 2)
+  ->Apply(MetricArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(MetricGetValueAndDerivative, TransformBendingEnergyPenalty, 3)
+  ->Apply(MetricArguments<3>)
+  ->UseRealTime();
+
+// PatternIntensity compares only the first slice of a 3D image, so it is benchmarked in 2D only.
+BENCHMARK_TEMPLATE(FullImageMetricGetValueAndDerivative, itk::PatternIntensityImageToImageMetric, 2)
+  ->Apply(FullImageMetricArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(FullImageMetricGetValueAndDerivative, itk::GradientDifferenceImageToImageMetric, 2)
+  ->Apply(FullImageMetricArguments<2>)
+  ->UseRealTime();
+BENCHMARK_TEMPLATE(FullImageMetricGetValueAndDerivative, itk::GradientDifferenceImageToImageMetric, 3)
+  ->Apply(FullImageMetricArguments<3>)
+  ->UseRealTime();
@@ -0,0 +1,211 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header files to be benchmarked:
+#include "itkAdvancedLinearInterpolateImageFunction.h"
+#include "itkReducedDimensionBSplineInterpolateImageFunction.h"
+#include <itkBSplineInterpolateImageFunction.h>
+#include <itkNearestNeighborInterpolateImageFunction.h>
+
+#include "elxBenchmarkUtilities.h"
+
+#include <itkImage.h>
+
+// Google Benchmark header file:
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace
+{
+using elastix::BenchmarkUtilities::AddArgumentsProduct;
+using elastix::BenchmarkUtilities::CreateImage;
+using elastix::BenchmarkUtilities::CreateRandomContinuousIndices;
+
+template <typename TImage>
+using BSplineInterpolator = itk::BSplineInterpolateImageFunction<TImage, double, double>;
+template <typename TImage>
+using BSplineInterpolatorFloat = itk::BSplineInterpolateImageFunction<TImage, double, float>;
+template <typename TImage>
+using ReducedDimensionBSplineInterpolator =
+  itk::ReducedDimensionBSplineInterpolateImageFunction<TImage, double, double>;
+
+
+// Adds the image sizes and numbers of points of the linear and the nearest neighbor interpolator benchmarks.
+template <unsigned int VDimension>
+void
+LinearInterpolatorArguments(benchmark::internal::Benchmark * benchmark)
+{
+  AddArgumentsProduct(
+    *benchmark,
+    { "size", "points" },
+    { VDimension == 2 ? std::vector<std::int64_t>{ 64, 256 } : std::vector<std::int64_t>{ 32, 96 }, { 4096 } });
+}
+
+
+// Adds the image sizes, numbers of points and spline orders of the B-spline interpolator benchmarks.
+template <unsigned int VDimension>
+void
+BSplineInterpolatorArguments(benchmark::internal::Benchmark * benchmark)
+{
+  AddArgumentsProduct(
+    *benchmark,
+    { "size", "points", "order" },
+    { VDimension == 2 ? std::vector<std::int64_t>{ 64, 256 } : std::vector<std::int64_t>{ 32, 96 },
+      { 4096 },
+      { 1, 3 } });
+}
+
+
+// Evaluates the value and the derivative, the way the metrics do.
+template <typename TInterpolator, typename TIndex, typename TValue, typename TDerivative>
+void
+EvaluateValueAndDerivative(const TInterpolator & interpolator,
+                           const TIndex &        index,
+                           TValue &              value,
+                           TDerivative &         derivative)
+{
+  interpolator.EvaluateValueAndDerivativeAtContinuousIndex(index, value, derivative);
+}
+
+
+// The reduced dimension B-spline interpolator evaluates the value and the derivative separately.
+template <typename TImage,
+          typename TCoordRep,
+          typename TCoefficient,
+          typename TIndex,
+          typename TValue,
+          typename TDerivative>
+void
+EvaluateValueAndDerivative(
+  const itk::ReducedDimensionBSplineInterpolateImageFunction<TImage, TCoordRep, TCoefficient> & interpolator,
+  const TIndex &                                                                                index,
+  TValue &                                                                                      value,
+  TDerivative &                                                                                 derivative)
+{
+  value = interpolator.EvaluateAtContinuousIndex(index);
+  derivative = interpolator.EvaluateDerivativeAtContinuousIndex(index);
+}
+
+
+// Times the evaluation of the value and the derivative at the specified indices.
+template <typename TInterpolator>
+void
+TimeValueAndDerivative(benchmark::State &                                               state,
+                       const TInterpolator &                                            interpolator,
+                       const std::vector<typename TInterpolator::ContinuousIndexType> & indices)
+{
+  typename TInterpolator::OutputType          value{};
+  typename TInterpolator::CovariantVectorType derivative;
+
+  for (auto _ : state)
+  {
+    for (const auto & index : indices)
+    {
+      EvaluateValueAndDerivative(interpolator, index, value, derivative);
+      benchmark::DoNotOptimize(value);
+      benchmark::DoNotOptimize(derivative);
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * indices.size()));
+}
+
+
+// Benchmarks the linear interpolator, which the metrics use when the Interpolator is "LinearInterpolator".
+template <unsigned int VDimension>
+void
+LinearInterpolatorValueAndDerivative(benchmark::State & state)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using InterpolatorType = itk::AdvancedLinearInterpolateImageFunction<ImageType, double>;
+
+  const auto image = CreateImage<ImageType>(static_cast<itk::SizeValueType>(state.range(0)), 0.0);
+
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetInputImage(image);
+
+  TimeValueAndDerivative(
+    state, *interpolator, CreateRandomContinuousIndices(*image, static_cast<std::size_t>(state.range(1))));
+}
+
+
+// Benchmarks the nearest neighbor interpolator, which the metrics use when the Interpolator is
+// "NearestNeighborInterpolator". It has no derivative, so only the value is evaluated.
+template <unsigned int VDimension>
+void
+NearestNeighborInterpolatorValue(benchmark::State & state)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using InterpolatorType = itk::NearestNeighborInterpolateImageFunction<ImageType, double>;
+
+  const auto image = CreateImage<ImageType>(static_cast<itk::SizeValueType>(state.range(0)), 0.0);
+
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetInputImage(image);
+
+  const auto indices = CreateRandomContinuousIndices(*image, static_cast<std::size_t>(state.range(1)));
+
+  for (auto _ : state)
+  {
+    for (const auto & index : indices)
+    {
+      benchmark::DoNotOptimize(interpolator->EvaluateAtContinuousIndex(index));
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * indices.size()));
+}
+
+
+// Benchmarks a B-spline interpolator of the specified spline order. Setting the input image, which computes the
+// B-spline coefficients, is not timed.
+template <template <typename> class TInterpolator, unsigned int VDimension>
+void
+BSplineInterpolatorValueAndDerivative(benchmark::State & state)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using InterpolatorType = TInterpolator<ImageType>;
+
+  const auto image = CreateImage<ImageType>(static_cast<itk::SizeValueType>(state.range(0)), 0.0);
+
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetSplineOrder(static_cast<unsigned int>(state.range(2)));
+  interpolator->SetInputImage(image);
+
+  TimeValueAndDerivative(
+    state, *interpolator, CreateRandomContinuousIndices(*image, static_cast<std::size_t>(state.range(1))));
+}
+
+} // namespace
+
+
+BENCHMARK_TEMPLATE(LinearInterpolatorValueAndDerivative, 2)->Apply(LinearInterpolatorArguments<2>);
+BENCHMARK_TEMPLATE(LinearInterpolatorValueAndDerivative, 3)->Apply(LinearInterpolatorArguments<3>);
+BENCHMARK_TEMPLATE(NearestNeighborInterpolatorValue, 2)->Apply(LinearInterpolatorArguments<2>);
+BENCHMARK_TEMPLATE(NearestNeighborInterpolatorValue, 3)->Apply(LinearInterpolatorArguments<3>);
+BENCHMARK_TEMPLATE(BSplineInterpolatorValueAndDerivative, BSplineInterpolator, 2)
+  ->Apply(BSplineInterpolatorArguments<2>);
+BENCHMARK_TEMPLATE(BSplineInterpolatorValueAndDerivative, BSplineInterpolator, 3)
+  ->Apply(BSplineInterpolatorArguments<3>);
+BENCHMARK_TEMPLATE(BSplineInterpolatorValueAndDerivative, BSplineInterpolatorFloat, 2)
+  ->Apply(BSplineInterpolatorArguments<2>);
+BENCHMARK_TEMPLATE(BSplineInterpolatorValueAndDerivative, BSplineInterpolatorFloat, 3)
+  ->Apply(BSplineInterpolatorArguments<3>);
+BENCHMARK_TEMPLATE(BSplineInterpolatorValueAndDerivative, ReducedDimensionBSplineInterpolator, 2)
+  ->Apply(BSplineInterpolatorArguments<2>);
+BENCHMARK_TEMPLATE(BSplineInterpolatorValueAndDerivative, ReducedDimensionBSplineInterpolator, 3)
+  ->Apply(BSplineInterpolatorArguments<3>);
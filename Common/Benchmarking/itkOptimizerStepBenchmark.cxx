@@ -0,0 +1,165 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header files to be benchmarked:
+#include "AdaptiveStochasticGradientDescent/itkAdaptiveStochasticGradientDescentOptimizer.h"
+#include "StandardGradientDescent/itkGradientDescentOptimizer2.h"
+
+#include <itkSingleValuedCostFunction.h>
+
+// Google Benchmark header file:
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+
+// A cost function that only has a number of parameters. The optimizer step does not evaluate the cost function, it
+// only asks for the number of parameters.
+class CostFunction : public itk::SingleValuedCostFunction
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(CostFunction);
+
+  using Self = CostFunction;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro(Self);
+
+  void
+  SetNumberOfParameters(const unsigned int numberOfParameters)
+  {
+    this->m_NumberOfParameters = numberOfParameters;
+  }
+
+  unsigned int
+  GetNumberOfParameters(void) const override
+  {
+    return this->m_NumberOfParameters;
+  }
+
+  MeasureType
+  GetValue(const ParametersType &) const override
+  {
+    return 0.0;
+  }
+
+  void
+  GetDerivative(const ParametersType &, DerivativeType & derivative) const override
+  {
+    derivative.Fill(0.0);
+  }
+
+protected:
+  CostFunction() = default;
+  ~CostFunction() override = default;
+
+private:
+  unsigned int m_NumberOfParameters{ 0 };
+};
+
+
+// Gives access to the state that the optimizer has before each step, so that the step can be timed without the
+// evaluation of the cost function.
+template <typename TOptimizer>
+class BenchmarkOptimizer : public TOptimizer
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(BenchmarkOptimizer);
+
+  using Self = BenchmarkOptimizer;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro(Self);
+
+  void
+  InitializeStep(itk::SingleValuedCostFunction & costFunction)
+  {
+    const unsigned int numberOfParameters = costFunction.GetNumberOfParameters();
+
+    typename TOptimizer::ParametersType position(numberOfParameters);
+    for (unsigned int i = 0; i < numberOfParameters; ++i)
+    {
+      position[i] = std::sin(0.37 * i);
+    }
+
+    this->SetCostFunction(&costFunction);
+    this->InitializeScales();
+    this->SetCurrentPosition(position);
+
+    /** Start after the first iteration, like most of the steps of a registration. */
+    this->m_CurrentIteration = 1;
+    this->m_Gradient.SetSize(numberOfParameters);
+    for (unsigned int i = 0; i < numberOfParameters; ++i)
+    {
+      this->m_Gradient[i] = 1e-3 * std::cos(0.37 * i);
+    }
+    this->InitializePreviousGradient(*this);
+  }
+
+protected:
+  BenchmarkOptimizer() = default;
+  ~BenchmarkOptimizer() override = default;
+
+private:
+  /** Only the adaptive optimizer compares the gradient with the one of the previous iteration. */
+  void
+  InitializePreviousGradient(itk::GradientDescentOptimizer2 &)
+  {}
+
+  void
+  InitializePreviousGradient(itk::AdaptiveStochasticGradientDescentOptimizer &)
+  {
+    this->m_PreviousGradient = this->m_Gradient;
+  }
+};
+
+
+// Adds the numbers of parameters of the optimizer benchmarks, which are typical for B-spline transforms.
+void
+OptimizerArguments(benchmark::internal::Benchmark * benchmark)
+{
+  benchmark->ArgName("parameters")->Arg(1000)->Arg(100000)->Arg(1000000);
+}
+
+
+// Benchmarks one step of an optimizer, which updates the parameters from the gradient.
+template <typename TOptimizer>
+void
+OptimizerAdvanceOneStep(benchmark::State & state)
+{
+  const auto costFunction = CostFunction::New();
+  costFunction->SetNumberOfParameters(static_cast<unsigned int>(state.range(0)));
+
+  const auto optimizer = BenchmarkOptimizer<TOptimizer>::New();
+  optimizer->InitializeStep(*costFunction);
+
+  for (auto _ : state)
+  {
+    optimizer->AdvanceOneStep();
+    benchmark::DoNotOptimize(optimizer->GetScaledCurrentPosition().data_block());
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+
+} // namespace
+
+
+BENCHMARK_TEMPLATE(OptimizerAdvanceOneStep, itk::GradientDescentOptimizer2)->Apply(OptimizerArguments);
+BENCHMARK_TEMPLATE(OptimizerAdvanceOneStep, itk::AdaptiveStochasticGradientDescentOptimizer)
+  ->Apply(OptimizerArguments);
@@ -37,6 +37,8 @@
 #include "itkAdvancedCombinationTransform.h"
 
 #include "itkPlatformMultiThreader.h"
+#include "itkWorkStealingThreadPool.h"
+#include "itkTimingProfile.h"
 
 namespace itk
 {
@@ -140,6 +142,7 @@ public:
   typedef typename ImageSamplerType::Pointer                      ImageSamplerPointer;
   typedef typename ImageSamplerType::OutputVectorContainerType    ImageSampleContainerType;
   typedef typename ImageSamplerType::OutputVectorContainerPointer ImageSampleContainerPointer;
+  typedef typename ImageSamplerType::ImageSampleSoAContainerType  ImageSampleSoAContainerType;
 
   /** Typedefs for Limiter support. */
   typedef LimiterFunctionBase<RealType, FixedImageDimension>  FixedImageLimiterType;
@@ -207,6 +210,11 @@ public:
    * This method allows the user to inspect this setting. */
   itkGetConstMacro(UseImageSampler, bool);
 
+  /** Inheriting classes can specify whether they read the samples in
+   * structure-of-arrays layout, see GetImageSampleSoAContainer().
+   * This method allows the user to inspect this setting. */
+  itkGetConstMacro(UseImageSampleSoAContainer, bool);
+
   /** Set/Get the required ratio of valid samples; default 0.25.
    * When less than this ratio*numberOfSamplesTried samples map
    * inside the moving image buffer, an exception will be thrown. */
@@ -249,6 +257,20 @@ public:
   itkSetMacro(ScaleGradientWithRespectToMovingImageOrientation, bool);
   itkGetConstMacro(ScaleGradientWithRespectToMovingImageOrientation, bool);
 
+  /** Set whether the gradient image of the moving image, which is computed when the
+   * interpolator does not provide derivatives, is shared with other metrics through
+   * the SharedImageCache. Default false.
+   */
+  itkSetMacro(UseSharedImageCache, bool);
+  itkGetConstMacro(UseSharedImageCache, bool);
+
+  /** Set the profile to which the time spent in the phases of the metric is added:
+   * sampling, transform point, Jacobian, interpolation and derivative accumulation.
+   * Default null, which means that nothing is timed.
+   */
+  itkSetObjectMacro(TimingProfile, TimingProfile);
+  itkGetModifiableObjectMacro(TimingProfile, TimingProfile);
+
   itkSetMacro(MovingImageDerivativeScales, MovingImageDerivativeScalesType);
   itkGetConstReferenceMacro(MovingImageDerivativeScales, MovingImageDerivativeScalesType);
 
@@ -284,6 +306,51 @@ public:
   itkGetConstReferenceMacro(UseMultiThread, bool);
   itkBooleanMacro(UseMultiThread);
 
+  /** Select the sparse accumulation of the per-thread derivatives. The derivatives
+   * are then divided in tiles of DerivativeTileSize parameters, and only the tiles
+   * that a thread actually touched are initialized and accumulated. This pays off for
+   * transforms with many parameters and a sparse Jacobian, like the B-spline, where the
+   * dense initialization and accumulation scale with threads x parameters.
+   * Only used when the transform has a sparse Jacobian; default: false.
+   */
+  itkSetMacro(UseSparseDerivativeAccumulation, bool);
+  itkGetConstReferenceMacro(UseSparseDerivativeAccumulation, bool);
+  itkBooleanMacro(UseSparseDerivativeAccumulation);
+
+  /** The number of parameters in a tile, see UseSparseDerivativeAccumulation. */
+  itkStaticConstMacro(DerivativeTileSize, unsigned int, 256);
+
+  /** Select the caching of the B-spline interpolation weights of the fixed image samples.
+   * When the sampler takes the same samples every iteration (the full and the grid sampler)
+   * and the transform is a B-spline (possibly combined with an initial transform), the
+   * support region and the weights of a sample do not change during a resolution. They are
+   * then computed once, and every iteration only gathers the coefficients. The weights are
+   * stored in single precision. Only used by metrics that support it, see
+   * GetSupportsBSplineWeightsCache(); default: false.
+   */
+  itkSetMacro(UseBSplineWeightsCache, bool);
+  itkGetConstReferenceMacro(UseBSplineWeightsCache, bool);
+  itkBooleanMacro(UseBSplineWeightsCache);
+
+  /** The maximum size of the B-spline weights cache in bytes. When the cache would need
+   * more memory, it is not used; default: 1 GiB.
+   */
+  itkSetMacro(MaximumBSplineWeightsCacheSize, SizeValueType);
+  itkGetConstMacro(MaximumBSplineWeightsCacheSize, SizeValueType);
+
+  /** Returns whether the metric reads the B-spline weights cache. The cache is only
+   * built for the metrics that do. This base class returns false.
+   */
+  virtual bool
+  GetSupportsBSplineWeightsCache(void) const
+  {
+    return false;
+  }
+
+  /** Get the number of bytes used by the B-spline weights cache; zero when it is not used. */
+  SizeValueType
+  GetBSplineWeightsCacheSize(void) const;
+
   /** Contains calls from GetValueAndDerivative that are thread-unsafe,
    * together with preparation for multi-threading.
    * Note that the only reason why this function is not protected, is
@@ -292,6 +359,18 @@ public:
   virtual void
   BeforeThreadedGetValueAndDerivative(const TransformParametersType & parameters) const;
 
+  /** Returns whether GetValueAndDerivative() may run concurrently with that of
+   * other metrics sharing the same transform. That is the case when all its
+   * thread-unsafe calls are in BeforeThreadedGetValueAndDerivative(), which the
+   * ComboMetric then calls beforehand. This base class returns false.
+   */
+  virtual bool
+  GetSupportsConcurrentGetValueAndDerivative(void) const
+  {
+    return false;
+  }
+
+
 protected:
   /** Constructor. */
   AdvancedImageToImageMetric();
@@ -410,10 +489,109 @@ protected:
   static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
   AccumulateDerivativesThreaderCallback(void * arg);
 
+  /** Execute a threader callback once for each work unit, on the persistent
+   * work-stealing thread pool. The callback receives a ThreadInfoType, just like
+   * with ThreaderType::SingleMethodExecute(), but no threads are created or joined.
+   */
+  void
+  ExecuteThreaderCallback(ThreadFunctionType callback, void * userData) const;
+
+  /** Execute a threader callback like above, and add the time of each work unit
+   * to the specified phase of the timing profile, if there is one.
+   */
+  void
+  ExecuteThreaderCallback(ThreadFunctionType callback, void * userData, TimingProfile::PhaseType phase) const;
+
+  /** Distribute the samples of the image sampler over the work units, in small
+   * chunks. Called by the Launch functions, before the threaded functions start.
+   */
+  void
+  InitializeSampleChunks(void) const;
+
+  /** Get the next chunk of samples [begin, end) to be processed by the work unit.
+   * Returns false when all samples are handed out. A work unit first processes its
+   * own contiguous part of the sample container, and then steals chunks from the
+   * other work units, so that the load is balanced when the cost per sample varies.
+   */
+  bool
+  GetNextSampleChunk(ThreadIdType threadID, SizeValueType & begin, SizeValueType & end) const
+  {
+    return this->m_SampleChunkScheduler.GetNextChunk(threadID, begin, end);
+  }
+
+  /** Prepare the derivative of a thread for adding contributions at the indices nzji.
+   * With sparse derivative accumulation, the tiles that contain these indices are
+   * marked as touched, and set to zero when they are touched for the first time
+   * since the last accumulation. Call this before adding to the derivative.
+   */
+  void
+  TouchDerivativeTiles(ThreadIdType threadID, const NonZeroJacobianIndicesType & nzji) const;
+
+  /** Prepare the complete derivative of a thread, for a dense update. */
+  void
+  TouchDerivativeTiles(ThreadIdType threadID) const;
+
+  /** Typedef for the B-spline transform, independent of the spline order. */
+  typedef AdvancedBSplineDeformableTransformBase<ScalarType, FixedImageDimension> BSplineTransformBaseType;
+
+  /** The B-spline weights cache, see UseBSplineWeightsCache. Per sample it stores the
+   * interpolation weights, the offset of the support region in the coefficient images,
+   * and the base point to which the B-spline displacement is added. The base point is
+   * the fixed point, or the fixed point mapped by the initial transform of a combination
+   * transform. The weights are evaluated at the point that the B-spline receives.
+   */
+  struct BSplineWeightsCacheType
+  {
+    bool                                                 m_IsValid;
+    unsigned int                                         m_NumberOfWeights;
+    NumberOfParametersType                               m_NumberOfParametersPerDimension;
+    std::vector<float>                                   m_Weights;
+    std::vector<OffsetValueType>                         m_SupportOffsets;
+    std::vector<MovingImagePointType>                    m_BasePoints;
+    std::vector<OffsetValueType>                         m_SupportElementOffsets;
+    const typename BSplineTransformBaseType::PixelType * m_Coefficients[FixedImageDimension];
+
+    /** The key: the cache is rebuilt when one of these changes. */
+    ModifiedTimeType                                       m_SamplesMTime;
+    SizeValueType                                          m_NumberOfSamples;
+    const BSplineTransformBaseType *                       m_BSplineTransform;
+    typename BSplineTransformBaseType::FixedParametersType m_BSplineFixedParameters;
+    const AdvancedTransformType *                          m_InitialTransform;
+    ModifiedTimeType                                       m_InitialTransformMTime;
+    bool                                                   m_UseComposition;
+  };
+  mutable BSplineWeightsCacheType m_BSplineWeightsCache;
+
+  /** Build the B-spline weights cache when the samples or the B-spline grid have changed,
+   * and get the coefficients of the current parameters. Called by
+   * BeforeThreadedGetValueAndDerivative(), after the sampler is updated.
+   */
+  void
+  UpdateBSplineWeightsCache(void) const;
+
+  /** Transform the sample at position pos of the sample container, using the B-spline
+   * weights cache. Only valid when m_BSplineWeightsCache.m_IsValid is true.
+   */
+  void
+  TransformPointUsingBSplineWeightsCache(SizeValueType pos, MovingImagePointType & mappedPoint) const;
+
+  /** Compute the inner product of the transform Jacobian with the moving image gradient
+   * for the sample at position pos, using the B-spline weights cache. Only valid when
+   * m_BSplineWeightsCache.m_IsValid is true.
+   */
+  void
+  EvaluateJacobianWithImageGradientProductUsingBSplineWeightsCache(
+    SizeValueType                     pos,
+    const MovingImageDerivativeType & movingImageDerivative,
+    DerivativeType &                  imageJacobian,
+    NonZeroJacobianIndicesType &      nonZeroJacobianIndices) const;
+
   /** Variables for multi-threading. */
-  bool m_UseMetricSingleThreaded;
-  bool m_UseMultiThread;
-  bool m_UseOpenMP;
+  bool         m_UseMetricSingleThreaded;
+  bool         m_UseMultiThread;
+  bool         m_UseOpenMP;
+  bool         m_UseSparseDerivativeAccumulation;
+  mutable bool m_SparseDerivativeAccumulation;
 
   /** Helper structs that multi-threads the computation of
    * the metric derivative using ITK threads.
@@ -428,6 +606,10 @@ protected:
   };
   mutable MultiThreaderParameterType m_ThreaderMetricParameters;
 
+  /** The thread pool and the distribution of the samples over the work units. */
+  WorkStealingThreadPool::Pointer    m_ThreadPool;
+  mutable WorkStealingChunkScheduler m_SampleChunkScheduler;
+
   /** Most metrics will perform multi-threading by letting
    * each thread compute a part of the value and derivative.
    *
@@ -451,9 +633,10 @@ protected:
   // test per thread struct with padding and alignment
   struct GetValueAndDerivativePerThreadStruct
   {
-    SizeValueType  st_NumberOfPixelsCounted;
-    MeasureType    st_Value;
-    DerivativeType st_Derivative;
+    SizeValueType              st_NumberOfPixelsCounted;
+    MeasureType                st_Value;
+    DerivativeType             st_Derivative;
+    std::vector<unsigned char> st_TouchedDerivativeTiles;
   };
   itkPadStruct(ITK_CACHE_LINE_ALIGNMENT,
                GetValueAndDerivativePerThreadStruct,
@@ -480,6 +663,22 @@ protected:
    * Make sure to set it before calling Initialize; default: false. */
   itkSetMacro(UseImageSampler, bool);
 
+  /** Inheriting classes can specify whether they read the samples in structure-of-arrays
+   * layout. If so, the image sampler is asked to generate that layout as well; default: false. */
+  itkSetMacro(UseImageSampleSoAContainer, bool);
+
+  /** Get the samples of the image sampler in structure-of-arrays layout: contiguous,
+   * cache line aligned arrays per coordinate and for the fixed image values. The sample
+   * order equals that of the regular sample container, so a thread may process the same
+   * range of samples in both. Only valid when UseImageSampleSoAContainer is true, and after
+   * BeforeThreadedGetValueAndDerivative() has updated the sampler.
+   */
+  const ImageSampleSoAContainerType *
+  GetImageSampleSoAContainer(void) const
+  {
+    return this->GetImageSampler()->GetSoAOutput();
+  }
+
   /** Check if enough samples have been found to compute a reliable
    * estimate of the value/derivative; throws an exception if not. */
   virtual void
@@ -534,6 +733,25 @@ protected:
   virtual bool
   TransformPoint(const FixedImagePointType & fixedImagePoint, MovingImagePointType & mappedPoint) const;
 
+  /** Transform an array of points from FixedImage domain to MovingImage domain.
+   * Uses the batched TransformPointBatch() of the transform, which avoids the
+   * per point overhead of TransformPoint().
+   */
+  virtual void
+  TransformPointBatch(const FixedImagePointType * fixedImagePoints,
+                      MovingImagePointType *      mappedPoints,
+                      std::size_t                 numberOfPoints) const;
+
+  /** Create a copy of a transform, whose parameters can be changed without affecting
+   * the original, for example to evaluate finite differences concurrently. Combination
+   * transforms are copied recursively, sharing their initial transforms. Other transforms
+   * are copied by their fixed parameters and parameters. Returns null when the transform
+   * cannot be copied, or when the copy does not map the corners of the fixed image like
+   * the original, because the transform has settings that are not in its parameters.
+   */
+  typename AdvancedTransformType::Pointer
+  CreateTransformCopy(const AdvancedTransformType * transform) const;
+
   /** This function returns a reference to the transform Jacobians.
    * This is either a reference to the full TransformJacobian or
    * a reference to a sparse Jacobians.
@@ -545,6 +763,16 @@ protected:
                             TransformJacobianType &      jacobian,
                             NonZeroJacobianIndicesType & nzji) const;
 
+  /** Compute the inner product of the transform Jacobian and the moving image gradient,
+   * with the EvaluateJacobianWithImageGradientProduct() of the advanced transform.
+   */
+  void
+  EvaluateTransformJacobianWithImageGradientProduct(
+    const FixedImagePointType &                                    fixedImagePoint,
+    const typename AdvancedTransformType::MovingImageGradientType & movingImageGradient,
+    DerivativeType &                                               imageJacobian,
+    NonZeroJacobianIndicesType &                                   nzji) const;
+
   /** Convenience method: check if point is inside the moving mask. *****************/
   virtual bool
   IsInsideMovingMask(const MovingImagePointType & point) const;
@@ -569,13 +797,18 @@ private:
 
   /** Private member variables. */
   bool   m_UseImageSampler;
+  bool   m_UseImageSampleSoAContainer;
+  bool   m_UseBSplineWeightsCache;
   bool   m_UseFixedImageLimiter;
   bool   m_UseMovingImageLimiter;
   double m_RequiredRatioOfValidSamples;
   bool   m_UseMovingImageDerivativeScales;
   bool   m_ScaleGradientWithRespectToMovingImageOrientation;
+  bool   m_UseSharedImageCache;
 
   MovingImageDerivativeScalesType m_MovingImageDerivativeScales;
+  SizeValueType                   m_MaximumBSplineWeightsCacheSize;
+  TimingProfile::Pointer          m_TimingProfile;
 };
 
 } // end namespace itk
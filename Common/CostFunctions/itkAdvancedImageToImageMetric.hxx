@@ -22,6 +22,7 @@
 
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
 #include "itkComputeImageExtremaFilter.h"
+#include "itkSharedImageCache.h"
 
 #ifdef ELASTIX_USE_OPENMP
 #  include <omp.h>
@@ -29,6 +30,9 @@
 
 #include "itkTimeProbe.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace itk
 {
 
@@ -49,8 +53,21 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AdvancedImageToImageMetri
 
   this->m_ImageSampler = nullptr;
   this->m_UseImageSampler = false;
+  this->m_UseImageSampleSoAContainer = false;
   this->m_RequiredRatioOfValidSamples = 0.25;
 
+  this->m_UseBSplineWeightsCache = false;
+  this->m_MaximumBSplineWeightsCacheSize = 1024 * 1024 * 1024;
+  this->m_BSplineWeightsCache.m_IsValid = false;
+  this->m_BSplineWeightsCache.m_NumberOfWeights = 0;
+  this->m_BSplineWeightsCache.m_NumberOfParametersPerDimension = 0;
+  this->m_BSplineWeightsCache.m_SamplesMTime = 0;
+  this->m_BSplineWeightsCache.m_NumberOfSamples = 0;
+  this->m_BSplineWeightsCache.m_BSplineTransform = nullptr;
+  this->m_BSplineWeightsCache.m_InitialTransform = nullptr;
+  this->m_BSplineWeightsCache.m_InitialTransformMTime = 0;
+  this->m_BSplineWeightsCache.m_UseComposition = false;
+
   this->m_LinearInterpolator = nullptr;
   this->m_BSplineInterpolator = nullptr;
   this->m_BSplineInterpolatorFloat = nullptr;
@@ -66,6 +83,7 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AdvancedImageToImageMetri
   this->m_TransformIsBSpline = false;
   this->m_UseMovingImageDerivativeScales = false;
   this->m_ScaleGradientWithRespectToMovingImageOrientation = false;
+  this->m_UseSharedImageCache = false;
   this->m_MovingImageDerivativeScales.Fill(1.0);
 
   this->m_FixedImageLimiter = nullptr;
@@ -86,6 +104,8 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AdvancedImageToImageMetri
   /** Threading related variables. */
   this->m_UseMetricSingleThreaded = true;
   this->m_UseMultiThread = false;
+  this->m_UseSparseDerivativeAccumulation = false;
+  this->m_SparseDerivativeAccumulation = false;
 
   /** OpenMP related. Switch to on when available */
 #ifdef ELASTIX_USE_OPENMP
@@ -99,6 +119,7 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AdvancedImageToImageMetri
 
   /** Initialize the m_ThreaderMetricParameters. */
   this->m_ThreaderMetricParameters.st_Metric = this;
+  this->m_ThreadPool = WorkStealingThreadPool::GetInstance();
 
   // Multi-threading structs
   this->m_GetValuePerThreadVariables = nullptr;
@@ -211,6 +232,14 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeThreadingParame
     this->m_GetValueAndDerivativePerThreadVariablesSize = numberOfThreads;
   }
 
+  /** Sparse accumulation only pays off when each sample touches a part of the parameters. */
+  const NumberOfParametersType numberOfParameters = this->GetNumberOfParameters();
+  this->m_SparseDerivativeAccumulation =
+    this->m_UseSparseDerivativeAccumulation && this->m_AdvancedTransform.IsNotNull() &&
+    this->m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices() < numberOfParameters;
+  const SizeValueType numberOfTiles =
+    this->m_SparseDerivativeAccumulation ? (numberOfParameters + DerivativeTileSize - 1) / DerivativeTileSize : 0;
+
   /** Some initialization. */
   for (ThreadIdType i = 0; i < numberOfThreads; ++i)
   {
@@ -219,9 +248,17 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeThreadingParame
 
     this->m_GetValueAndDerivativePerThreadVariables[i].st_NumberOfPixelsCounted = NumericTraits<SizeValueType>::Zero;
     this->m_GetValueAndDerivativePerThreadVariables[i].st_Value = NumericTraits<MeasureType>::Zero;
-    this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.SetSize(this->GetNumberOfParameters());
-    this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.Fill(
-      NumericTraits<DerivativeValueType>::ZeroValue());
+    this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.SetSize(numberOfParameters);
+
+    /** With sparse accumulation, the tiles are zeroed when they are first touched,
+     * so the memory of tiles that a thread never touches is not even used.
+     */
+    this->m_GetValueAndDerivativePerThreadVariables[i].st_TouchedDerivativeTiles.assign(numberOfTiles, 0);
+    if (!this->m_SparseDerivativeAccumulation)
+    {
+      this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.Fill(
+        NumericTraits<DerivativeValueType>::ZeroValue());
+    }
   }
 
 } // end InitializeThreadingParameters()
@@ -367,6 +404,10 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeImageSampler(vo
     this->m_ImageSampler->SetInput(this->m_FixedImage);
     this->m_ImageSampler->SetMask(this->m_FixedImageMask);
     this->m_ImageSampler->SetInputImageRegion(this->GetFixedImageRegion());
+    if (this->m_UseImageSampleSoAContainer)
+    {
+      this->m_ImageSampler->SetGenerateSoAOutput(true);
+    }
   }
 
 } // end InitializeImageSampler()
@@ -470,11 +511,30 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::CheckForBSplineInterpolat
     if (!this->m_InterpolatorIsBSpline && !this->m_InterpolatorIsBSplineFloat &&
         !this->m_InterpolatorIsReducedBSpline && !this->m_InterpolatorIsLinear && !interpolatorIsRayCast)
     {
-      this->m_CentralDifferenceGradientFilter = CentralDifferenceGradientFilterType::New();
-      this->m_CentralDifferenceGradientFilter->SetUseImageSpacing(true);
-      this->m_CentralDifferenceGradientFilter->SetInput(this->m_MovingImage);
-      this->m_CentralDifferenceGradientFilter->Update();
-      this->m_GradientImage = this->m_CentralDifferenceGradientFilter->GetOutput();
+      if (this->m_UseSharedImageCache)
+      {
+        /** Share the gradient image with the metrics of other registrations. */
+        const MovingImageType * movingImage = this->m_MovingImage;
+        this->m_CentralDifferenceGradientFilter = nullptr;
+        this->m_GradientImage = SharedImageCache::GetOrCreate<GradientImageType>(
+          movingImage, typeid(CentralDifferenceGradientFilterType).name(), [movingImage]() {
+            const CentralDifferenceGradientFilterPointer filter = CentralDifferenceGradientFilterType::New();
+            filter->SetUseImageSpacing(true);
+            filter->SetInput(movingImage);
+            filter->Update();
+            const typename GradientImageType::Pointer gradientImage = filter->GetOutput();
+            gradientImage->DisconnectPipeline();
+            return gradientImage;
+          });
+      }
+      else
+      {
+        this->m_CentralDifferenceGradientFilter = CentralDifferenceGradientFilterType::New();
+        this->m_CentralDifferenceGradientFilter->SetUseImageSpacing(true);
+        this->m_CentralDifferenceGradientFilter->SetInput(this->m_MovingImage);
+        this->m_CentralDifferenceGradientFilter->Update();
+        this->m_GradientImage = this->m_CentralDifferenceGradientFilter->GetOutput();
+      }
     }
     else
     {
@@ -570,6 +630,8 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateMovingImageValueA
   RealType &                   movingImageValue,
   MovingImageDerivativeType *  gradient) const
 {
+  const TimingProfile::ScopedTimer timer(this->m_TimingProfile, TimingProfile::Interpolation);
+
   /** Check if mapped point inside image buffer. */
   MovingImageContinuousIndexType cindex;
   this->m_Interpolator->ConvertPointToContinuousIndex(mappedPoint, cindex);
@@ -738,6 +800,8 @@ bool
 AdvancedImageToImageMetric<TFixedImage, TMovingImage>::TransformPoint(const FixedImagePointType & fixedImagePoint,
                                                                       MovingImagePointType &      mappedPoint) const
 {
+  const TimingProfile::ScopedTimer timer(this->m_TimingProfile, TimingProfile::TransformPoint);
+
   mappedPoint = this->m_Transform->TransformPoint(fixedImagePoint);
 
   /** For future use: return whether the sample is valid */
@@ -747,6 +811,102 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::TransformPoint(const Fixe
 } // end TransformPoint()
 
 
+/**
+ * ********************** TransformPointBatch ************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::TransformPointBatch(
+  const FixedImagePointType * fixedImagePoints,
+  MovingImagePointType *      mappedPoints,
+  std::size_t                 numberOfPoints) const
+{
+  const TimingProfile::ScopedTimer timer(this->m_TimingProfile, TimingProfile::TransformPoint);
+
+  this->m_AdvancedTransform->TransformPointBatch(fixedImagePoints, mappedPoints, numberOfPoints);
+
+} // end TransformPointBatch()
+
+
+/**
+ * ********************** CreateTransformCopy ************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+typename AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AdvancedTransformType::Pointer
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::CreateTransformCopy(
+  const AdvancedTransformType * transform) const
+{
+  typedef typename AdvancedTransformType::Pointer AdvancedTransformPointer;
+  if (transform == nullptr)
+  {
+    return nullptr;
+  }
+
+  AdvancedTransformPointer copy;
+  const CombinationTransformType * combinationTransform = dynamic_cast<const CombinationTransformType *>(transform);
+  if (combinationTransform != nullptr)
+  {
+    /** The initial transform does not depend on the parameters, so it is shared. */
+    if (!combinationTransform->GetTransformPointIsCombination())
+    {
+      return nullptr;
+    }
+    const AdvancedTransformPointer currentTransformCopy =
+      this->CreateTransformCopy(combinationTransform->GetCurrentTransform());
+    if (currentTransformCopy.IsNull())
+    {
+      return nullptr;
+    }
+    const typename CombinationTransformType::Pointer combinationCopy = CombinationTransformType::New();
+    combinationCopy->SetInitialTransform(
+      const_cast<AdvancedTransformType *>(combinationTransform->GetInitialTransform()));
+    combinationCopy->SetUseAddition(combinationTransform->GetUseAddition());
+    combinationCopy->SetCurrentTransform(currentTransformCopy);
+    copy = combinationCopy.GetPointer();
+  }
+  else
+  {
+    copy = dynamic_cast<AdvancedTransformType *>(transform->CreateAnother().GetPointer());
+    if (copy.IsNull())
+    {
+      return nullptr;
+    }
+    copy->SetFixedParameters(transform->GetFixedParameters());
+    copy->SetParameters(transform->GetParameters());
+  }
+
+  /** Check that the copy maps the corners of the fixed image like the original. */
+  const FixedImageRegionType & region = this->m_FixedImage->GetLargestPossibleRegion();
+  for (unsigned int corner = 0; corner < (1u << FixedImageDimension); ++corner)
+  {
+    FixedImageIndexType index = region.GetIndex();
+    for (unsigned int i = 0; i < FixedImageDimension; ++i)
+    {
+      if (corner & (1u << i))
+      {
+        index[i] += static_cast<IndexValueType>(region.GetSize(i)) - 1;
+      }
+    }
+    FixedImagePointType point;
+    this->m_FixedImage->TransformIndexToPhysicalPoint(index, point);
+
+    const MovingImagePointType expectedPoint = transform->TransformPoint(point);
+    const MovingImagePointType copiedPoint = copy->TransformPoint(point);
+    for (unsigned int i = 0; i < MovingImageDimension; ++i)
+    {
+      if (std::abs(copiedPoint[i] - expectedPoint[i]) > 1e-9 * (1.0 + std::abs(expectedPoint[i])))
+      {
+        return nullptr;
+      }
+    }
+  }
+  return copy;
+
+} // end CreateTransformCopy()
+
+
 /**
  * *************** EvaluateTransformJacobian ****************
  */
@@ -758,6 +918,8 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateTransformJacobian
   TransformJacobianType &      jacobian,
   NonZeroJacobianIndicesType & nzji) const
 {
+  const TimingProfile::ScopedTimer timer(this->m_TimingProfile, TimingProfile::Jacobian);
+
   /** Advanced transform: generic sparse Jacobian support */
   this->m_AdvancedTransform->GetJacobian(fixedImagePoint, jacobian, nzji);
 
@@ -768,6 +930,26 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateTransformJacobian
 } // end EvaluateTransformJacobian()
 
 
+/**
+ * *************** EvaluateTransformJacobianWithImageGradientProduct ****************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateTransformJacobianWithImageGradientProduct(
+  const FixedImagePointType &                                    fixedImagePoint,
+  const typename AdvancedTransformType::MovingImageGradientType & movingImageGradient,
+  DerivativeType &                                               imageJacobian,
+  NonZeroJacobianIndicesType &                                   nzji) const
+{
+  const TimingProfile::ScopedTimer timer(this->m_TimingProfile, TimingProfile::Jacobian);
+
+  this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProduct(
+    fixedImagePoint, movingImageGradient, imageJacobian, nzji);
+
+} // end EvaluateTransformJacobianWithImageGradientProduct()
+
+
 /**
  * ************************** IsInsideMovingMask *************************
  */
@@ -827,8 +1009,16 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::BeforeThreadedGetValueAnd
     this->SetTransformParameters(parameters);
     if (this->m_UseImageSampler)
     {
+      /** The sampler may have been replaced after Initialize(), for example
+       * to compute the exact metric value, so request the layout again. */
+      if (this->m_UseImageSampleSoAContainer)
+      {
+        this->GetImageSampler()->SetGenerateSoAOutput(true);
+      }
+      const TimingProfile::ScopedTimer timer(this->m_TimingProfile, TimingProfile::Sampling);
       this->GetImageSampler()->Update();
     }
+    this->UpdateBSplineWeightsCache();
   }
 
 } // end BeforeThreadedGetValueAndDerivative()
@@ -862,12 +1052,12 @@ template <class TFixedImage, class TMovingImage>
 void
 AdvancedImageToImageMetric<TFixedImage, TMovingImage>::LaunchGetValueThreaderCallback(void) const
 {
-  /** Setup threader. */
-  this->m_Threader->SetSingleMethod(this->GetValueThreaderCallback,
-                                    const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
+  /** Distribute the samples over the work units. */
+  this->InitializeSampleChunks();
 
   /** Launch. */
-  this->m_Threader->SingleMethodExecute();
+  this->ExecuteThreaderCallback(this->GetValueThreaderCallback,
+                                const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
 
 } // end LaunchGetValueThreaderCallback()
 
@@ -900,12 +1090,12 @@ template <class TFixedImage, class TMovingImage>
 void
 AdvancedImageToImageMetric<TFixedImage, TMovingImage>::LaunchGetValueAndDerivativeThreaderCallback(void) const
 {
-  /** Setup threader. */
-  this->m_Threader->SetSingleMethod(this->GetValueAndDerivativeThreaderCallback,
-                                    const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
+  /** Distribute the samples over the work units. */
+  this->InitializeSampleChunks();
 
   /** Launch. */
-  this->m_Threader->SingleMethodExecute();
+  this->ExecuteThreaderCallback(this->GetValueAndDerivativeThreaderCallback,
+                                const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
 
 } // end LaunchGetValueAndDerivativeThreaderCallback()
 
@@ -931,11 +1121,70 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AccumulateDerivativesThre
   unsigned int       jmax = (threadID + 1) * subSize;
   jmax = (jmax > numPar) ? numPar : jmax;
 
+  const DerivativeValueType zero = NumericTraits<DerivativeValueType>::Zero;
+  const DerivativeValueType normalization = 1.0 / temp->st_NormalizationFactor;
+
+  /** With sparse accumulation, this thread accumulates whole tiles, and per tile
+   * only the sub-derivatives that touched it. Instead of resetting the
+   * sub-derivatives, their tiles are marked as untouched again.
+   */
+  if (temp->st_Metric->m_SparseDerivativeAccumulation)
+  {
+    const unsigned int numTiles = (numPar + DerivativeTileSize - 1) / DerivativeTileSize;
+    const unsigned int tilesPerThread = (numTiles + nrOfThreads - 1) / nrOfThreads;
+    const unsigned int tmin = std::min(threadID * tilesPerThread, numTiles);
+    const unsigned int tmax = std::min((threadID + 1) * tilesPerThread, numTiles);
+
+    for (unsigned int tile = tmin; tile < tmax; ++tile)
+    {
+      const unsigned int    tileBegin = tile * DerivativeTileSize;
+      const unsigned int    tileEnd = std::min(tileBegin + DerivativeTileSize, numPar);
+      DerivativeValueType * derivative = temp->st_DerivativePointer;
+      bool                  tileIsSet = false;
+      for (ThreadIdType i = 0; i < nrOfThreads; ++i)
+      {
+        GetValueAndDerivativePerThreadStruct & threadVariables =
+          temp->st_Metric->m_GetValueAndDerivativePerThreadVariables[i];
+        if (!threadVariables.st_TouchedDerivativeTiles[tile])
+        {
+          continue;
+        }
+        threadVariables.st_TouchedDerivativeTiles[tile] = 0;
+
+        const DerivativeValueType * subDerivative = threadVariables.st_Derivative.data_block();
+        if (tileIsSet)
+        {
+          for (unsigned int j = tileBegin; j < tileEnd; ++j)
+          {
+            derivative[j] += subDerivative[j];
+          }
+        }
+        else
+        {
+          std::copy(subDerivative + tileBegin, subDerivative + tileEnd, derivative + tileBegin);
+          tileIsSet = true;
+        }
+      }
+
+      if (tileIsSet)
+      {
+        for (unsigned int j = tileBegin; j < tileEnd; ++j)
+        {
+          derivative[j] *= normalization;
+        }
+      }
+      else
+      {
+        std::fill(derivative + tileBegin, derivative + tileEnd, zero);
+      }
+    }
+
+    return itk::ITK_THREAD_RETURN_DEFAULT_VALUE;
+  }
+
   /** This thread accumulates all sub-derivatives into a single one, for the
    * range [ jmin, jmax [. Additionally, the sub-derivatives are reset.
    */
-  const DerivativeValueType zero = NumericTraits<DerivativeValueType>::Zero;
-  const DerivativeValueType normalization = 1.0 / temp->st_NormalizationFactor;
   for (unsigned int j = jmin; j < jmax; ++j)
   {
     DerivativeValueType tmp = zero;
@@ -954,6 +1203,393 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AccumulateDerivativesThre
 } // end AccumulateDerivativesThreaderCallback()
 
 
+/**
+ * *********************** TouchDerivativeTiles ***********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::TouchDerivativeTiles(
+  ThreadIdType                       threadID,
+  const NonZeroJacobianIndicesType & nzji) const
+{
+  if (!this->m_SparseDerivativeAccumulation)
+  {
+    return;
+  }
+
+  GetValueAndDerivativePerThreadStruct & threadVariables = this->m_GetValueAndDerivativePerThreadVariables[threadID];
+  unsigned char *                        touchedTiles = threadVariables.st_TouchedDerivativeTiles.data();
+  DerivativeValueType *                  derivative = threadVariables.st_Derivative.data_block();
+  const unsigned int                     numPar = this->GetNumberOfParameters();
+
+  /** The nonzero Jacobian indices mostly come in runs within the same tile,
+   * so first compare with the previous tile.
+   */
+  unsigned int previousTile = NumericTraits<unsigned int>::max();
+  for (const auto index : nzji)
+  {
+    const unsigned int tile = index / DerivativeTileSize;
+    if (tile != previousTile && !touchedTiles[tile])
+    {
+      touchedTiles[tile] = 1;
+      const unsigned int tileBegin = tile * DerivativeTileSize;
+      std::fill(derivative + tileBegin,
+                derivative + std::min(tileBegin + DerivativeTileSize, numPar),
+                NumericTraits<DerivativeValueType>::ZeroValue());
+    }
+    previousTile = tile;
+  }
+
+} // end TouchDerivativeTiles()
+
+
+/**
+ * *********************** TouchDerivativeTiles ***********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::TouchDerivativeTiles(ThreadIdType threadID) const
+{
+  if (!this->m_SparseDerivativeAccumulation)
+  {
+    return;
+  }
+
+  GetValueAndDerivativePerThreadStruct & threadVariables = this->m_GetValueAndDerivativePerThreadVariables[threadID];
+  const unsigned int                     numPar = this->GetNumberOfParameters();
+  for (unsigned int tile = 0; tile < threadVariables.st_TouchedDerivativeTiles.size(); ++tile)
+  {
+    if (!threadVariables.st_TouchedDerivativeTiles[tile])
+    {
+      threadVariables.st_TouchedDerivativeTiles[tile] = 1;
+      const unsigned int tileBegin = tile * DerivativeTileSize;
+      std::fill(threadVariables.st_Derivative.data_block() + tileBegin,
+                threadVariables.st_Derivative.data_block() + std::min(tileBegin + DerivativeTileSize, numPar),
+                NumericTraits<DerivativeValueType>::ZeroValue());
+    }
+  }
+
+} // end TouchDerivativeTiles()
+
+
+/**
+ * *********************** ExecuteThreaderCallback ***********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::ExecuteThreaderCallback(ThreadFunctionType callback,
+                                                                               void *             userData) const
+{
+  const ThreadIdType numberOfWorkUnits = Self::GetNumberOfWorkUnits();
+
+  this->m_ThreadPool->Execute(numberOfWorkUnits, [callback, userData, numberOfWorkUnits](ThreadIdType threadID) {
+    ThreadInfoType infoStruct = ThreadInfoType();
+    infoStruct.WorkUnitID = threadID;
+    infoStruct.NumberOfWorkUnits = numberOfWorkUnits;
+    infoStruct.UserData = userData;
+    infoStruct.ThreadFunction = callback;
+    callback(&infoStruct);
+  });
+
+} // end ExecuteThreaderCallback()
+
+
+/**
+ * *********************** ExecuteThreaderCallback ***********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::ExecuteThreaderCallback(ThreadFunctionType       callback,
+                                                                               void *                   userData,
+                                                                               TimingProfile::PhaseType phase) const
+{
+  if (this->m_TimingProfile.IsNull())
+  {
+    this->ExecuteThreaderCallback(callback, userData);
+    return;
+  }
+
+  const ThreadIdType numberOfWorkUnits = Self::GetNumberOfWorkUnits();
+  TimingProfile *    timingProfile = this->m_TimingProfile;
+
+  this->m_ThreadPool->Execute(
+    numberOfWorkUnits, [callback, userData, numberOfWorkUnits, timingProfile, phase](ThreadIdType threadID) {
+      const TimingProfile::ScopedTimer timer(timingProfile, phase);
+      ThreadInfoType                   infoStruct = ThreadInfoType();
+      infoStruct.WorkUnitID = threadID;
+      infoStruct.NumberOfWorkUnits = numberOfWorkUnits;
+      infoStruct.UserData = userData;
+      infoStruct.ThreadFunction = callback;
+      callback(&infoStruct);
+    });
+
+} // end ExecuteThreaderCallback()
+
+
+/**
+ * *********************** InitializeSampleChunks ***********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeSampleChunks(void) const
+{
+  SizeValueType numberOfSamples = 0;
+  if (this->m_UseImageSampler)
+  {
+    numberOfSamples = this->GetImageSampler()->GetOutput()->Size();
+  }
+  this->m_SampleChunkScheduler.Initialize(Self::GetNumberOfWorkUnits(), numberOfSamples);
+
+} // end InitializeSampleChunks()
+
+
+/**
+ * *********************** UpdateBSplineWeightsCache ***********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::UpdateBSplineWeightsCache(void) const
+{
+  BSplineWeightsCacheType & cache = this->m_BSplineWeightsCache;
+  cache.m_IsValid = false;
+
+  /** The cache only pays off when the metric reads it, and the samples are the same every iteration. */
+  if (!this->m_UseBSplineWeightsCache || !this->GetSupportsBSplineWeightsCache() || !this->m_UseImageSampler ||
+      this->GetImageSampler()->SelectingNewSamplesOnUpdateSupported())
+  {
+    return;
+  }
+
+  /** Find the B-spline transform, and the initial transform that is combined with it. The cache
+   * reproduces the plain combination only, so transforms that add to it are not supported.
+   */
+  const BSplineTransformBaseType * bsplineTransform =
+    dynamic_cast<const BSplineTransformBaseType *>(this->m_AdvancedTransform.GetPointer());
+  const AdvancedTransformType * initialTransform = nullptr;
+  bool                          useComposition = false;
+
+  const CombinationTransformType * combinationTransform =
+    dynamic_cast<const CombinationTransformType *>(this->m_AdvancedTransform.GetPointer());
+  if (combinationTransform != nullptr)
+  {
+    if (!combinationTransform->GetTransformPointIsCombination())
+    {
+      return;
+    }
+    bsplineTransform = dynamic_cast<const BSplineTransformBaseType *>(combinationTransform->GetCurrentTransform());
+    initialTransform = combinationTransform->GetInitialTransform();
+    useComposition = !combinationTransform->GetUseAddition();
+  }
+  if (bsplineTransform == nullptr || !bsplineTransform->GetSupportRegionIsContiguous() ||
+      bsplineTransform->GetCoefficientImages()[0].IsNull())
+  {
+    return;
+  }
+
+  /** Check if the cache would not exceed the maximum size. */
+  const ImageSampleContainerType * sampleContainer = this->GetImageSampler()->GetOutput();
+  const SizeValueType              numberOfSamples = sampleContainer->Size();
+  const unsigned int               numberOfWeights = bsplineTransform->GetNumberOfAffectedWeights();
+  const SizeValueType              bytesPerSample =
+    numberOfWeights * sizeof(float) + sizeof(OffsetValueType) + sizeof(MovingImagePointType);
+  if (numberOfSamples * bytesPerSample > this->m_MaximumBSplineWeightsCacheSize)
+  {
+    std::vector<float>().swap(cache.m_Weights);
+    std::vector<OffsetValueType>().swap(cache.m_SupportOffsets);
+    std::vector<MovingImagePointType>().swap(cache.m_BasePoints);
+    cache.m_NumberOfSamples = 0;
+    return;
+  }
+
+  /** Rebuild the cache when the samples, the B-spline grid or the initial transform have changed. */
+  const ModifiedTimeType initialTransformMTime = initialTransform ? initialTransform->GetMTime() : 0;
+  const auto &           bsplineFixedParameters = bsplineTransform->GetFixedParameters();
+  if (cache.m_SamplesMTime != sampleContainer->GetMTime() || cache.m_NumberOfSamples != numberOfSamples ||
+      cache.m_BSplineTransform != bsplineTransform || cache.m_BSplineFixedParameters != bsplineFixedParameters ||
+      cache.m_InitialTransform != initialTransform || cache.m_InitialTransformMTime != initialTransformMTime ||
+      cache.m_UseComposition != useComposition)
+  {
+    cache.m_NumberOfWeights = numberOfWeights;
+    cache.m_NumberOfParametersPerDimension = bsplineTransform->GetNumberOfParametersPerDimension();
+    cache.m_Weights.resize(numberOfSamples * numberOfWeights);
+    cache.m_SupportOffsets.resize(numberOfSamples);
+    cache.m_BasePoints.resize(numberOfSamples);
+    bsplineTransform->GetSupportOffsets(cache.m_SupportElementOffsets);
+
+    /** Compute the weights of contiguous parts of the samples on the thread pool.
+     * The weights are evaluated at the point that the B-spline receives, which is
+     * the fixed point mapped by the initial transform in case of composition.
+     */
+    const ThreadIdType numberOfWorkUnits = static_cast<ThreadIdType>(
+      std::max<SizeValueType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfSamples), 1));
+    const auto computeWeights = [&cache, sampleContainer, bsplineTransform, initialTransform, useComposition,
+                                 numberOfSamples, numberOfWorkUnits](ThreadIdType workUnit) {
+      const SizeValueType begin = workUnit * numberOfSamples / numberOfWorkUnits;
+      const SizeValueType end = (workUnit + 1) * numberOfSamples / numberOfWorkUnits;
+      for (SizeValueType pos = begin; pos < end; ++pos)
+      {
+        const FixedImagePointType & fixedPoint = sampleContainer->ElementAt(pos).m_ImageCoordinates;
+        FixedImagePointType         bsplinePoint = fixedPoint;
+        if (initialTransform != nullptr)
+        {
+          cache.m_BasePoints[pos] = initialTransform->TransformPoint(fixedPoint);
+          if (useComposition)
+          {
+            bsplinePoint = cache.m_BasePoints[pos];
+          }
+        }
+        else
+        {
+          cache.m_BasePoints[pos] = fixedPoint;
+        }
+
+        /** Outside the valid region the displacement and the Jacobian are zero. */
+        if (!bsplineTransform->ComputeWeightsAndSupportOffset(
+              bsplinePoint, &cache.m_Weights[pos * cache.m_NumberOfWeights], cache.m_SupportOffsets[pos]))
+        {
+          cache.m_SupportOffsets[pos] = -1;
+        }
+      }
+    };
+    this->m_ThreadPool->Execute(numberOfWorkUnits, computeWeights);
+
+    cache.m_SamplesMTime = sampleContainer->GetMTime();
+    cache.m_NumberOfSamples = numberOfSamples;
+    cache.m_BSplineTransform = bsplineTransform;
+    cache.m_BSplineFixedParameters = bsplineFixedParameters;
+    cache.m_InitialTransform = initialTransform;
+    cache.m_InitialTransformMTime = initialTransformMTime;
+    cache.m_UseComposition = useComposition;
+  }
+
+  /** The coefficients wrap the current parameters, which may be a different array every iteration. */
+  const typename BSplineTransformBaseType::ImagePointer * coefficientImages = bsplineTransform->GetCoefficientImages();
+  for (unsigned int d = 0; d < FixedImageDimension; ++d)
+  {
+    cache.m_Coefficients[d] = coefficientImages[d]->GetBufferPointer();
+  }
+  cache.m_IsValid = true;
+
+} // end UpdateBSplineWeightsCache()
+
+
+/**
+ * *********************** TransformPointUsingBSplineWeightsCache ***********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::TransformPointUsingBSplineWeightsCache(
+  SizeValueType          pos,
+  MovingImagePointType & mappedPoint) const
+{
+  const TimingProfile::ScopedTimer timer(this->m_TimingProfile, TimingProfile::TransformPoint);
+  const BSplineWeightsCacheType &  cache = this->m_BSplineWeightsCache;
+
+  /** Outside the valid region, the B-spline does not displace the point. */
+  mappedPoint = cache.m_BasePoints[pos];
+  const OffsetValueType supportOffset = cache.m_SupportOffsets[pos];
+  if (supportOffset < 0)
+  {
+    return;
+  }
+
+  /** Gather the coefficients of the support region, and multiply them with the weights. */
+  const unsigned int      numberOfWeights = cache.m_NumberOfWeights;
+  const float *           weights = cache.m_Weights.data() + pos * numberOfWeights;
+  const OffsetValueType * supportElementOffsets = cache.m_SupportElementOffsets.data();
+  for (unsigned int d = 0; d < FixedImageDimension; ++d)
+  {
+    const typename BSplineTransformBaseType::PixelType * coefficients = cache.m_Coefficients[d] + supportOffset;
+
+    ScalarType displacement = NumericTraits<ScalarType>::ZeroValue();
+    for (unsigned int k = 0; k < numberOfWeights; ++k)
+    {
+      displacement += weights[k] * coefficients[supportElementOffsets[k]];
+    }
+    mappedPoint[d] += displacement;
+  }
+
+} // end TransformPointUsingBSplineWeightsCache()
+
+
+/**
+ * ************** EvaluateJacobianWithImageGradientProductUsingBSplineWeightsCache **************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateJacobianWithImageGradientProductUsingBSplineWeightsCache(
+  SizeValueType                     pos,
+  const MovingImageDerivativeType & movingImageDerivative,
+  DerivativeType &                  imageJacobian,
+  NonZeroJacobianIndicesType &      nonZeroJacobianIndices) const
+{
+  const TimingProfile::ScopedTimer timer(this->m_TimingProfile, TimingProfile::Jacobian);
+  const BSplineWeightsCacheType &  cache = this->m_BSplineWeightsCache;
+  const unsigned int               numberOfWeights = cache.m_NumberOfWeights;
+  const OffsetValueType            supportOffset = cache.m_SupportOffsets[pos];
+
+  /** Outside the valid region the Jacobian is zero, see
+   * AdvancedBSplineDeformableTransform::EvaluateJacobianWithImageGradientProduct().
+   */
+  if (supportOffset < 0)
+  {
+    for (std::size_t i = 0; i < nonZeroJacobianIndices.size(); ++i)
+    {
+      nonZeroJacobianIndices[i] = i;
+    }
+    imageJacobian.Fill(0.0);
+    return;
+  }
+
+  /** The weights are the same for each dimension; the parameters of dimension d
+   * follow those of dimension d - 1.
+   */
+  const float *           weights = cache.m_Weights.data() + pos * numberOfWeights;
+  const OffsetValueType * supportElementOffsets = cache.m_SupportElementOffsets.data();
+  unsigned int            counter = 0;
+  for (unsigned int d = 0; d < FixedImageDimension; ++d)
+  {
+    const DerivativeValueType mig = movingImageDerivative[d];
+    const unsigned long       parameterOffset = d * cache.m_NumberOfParametersPerDimension + supportOffset;
+    for (unsigned int k = 0; k < numberOfWeights; ++k)
+    {
+      imageJacobian[counter] = weights[k] * mig;
+      nonZeroJacobianIndices[counter] = parameterOffset + supportElementOffsets[k];
+      ++counter;
+    }
+  }
+
+} // end EvaluateJacobianWithImageGradientProductUsingBSplineWeightsCache()
+
+
+/**
+ * *********************** GetBSplineWeightsCacheSize ***********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+SizeValueType
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::GetBSplineWeightsCacheSize(void) const
+{
+  const BSplineWeightsCacheType & cache = this->m_BSplineWeightsCache;
+  if (!cache.m_IsValid)
+  {
+    return 0;
+  }
+  return cache.m_Weights.capacity() * sizeof(float) + cache.m_SupportOffsets.capacity() * sizeof(OffsetValueType) +
+         cache.m_BasePoints.capacity() * sizeof(MovingImagePointType) +
+         cache.m_SupportElementOffsets.capacity() * sizeof(OffsetValueType);
+
+} // end GetBSplineWeightsCacheSize()
+
+
 /**
  * *********************** CheckNumberOfSamples ***********************
  */
@@ -986,6 +1622,7 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::PrintSelf(std::ostream &
   os << indent << "Variables related to the Sampler: " << std::endl;
   os << indent.GetNextIndent() << "ImageSampler: " << this->m_ImageSampler.GetPointer() << std::endl;
   os << indent.GetNextIndent() << "UseImageSampler: " << this->m_UseImageSampler << std::endl;
+  os << indent.GetNextIndent() << "UseImageSampleSoAContainer: " << this->m_UseImageSampleSoAContainer << std::endl;
 
   /** Variables for the Limiters. */
   os << indent << "Variables related to the Limiters: " << std::endl;
@@ -1025,6 +1662,12 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::PrintSelf(std::ostream &
   os << indent.GetNextIndent() << "UseMovingImageDerivativeScales: " << this->m_UseMovingImageDerivativeScales
      << std::endl;
   os << indent.GetNextIndent() << "MovingImageDerivativeScales: " << this->m_MovingImageDerivativeScales << std::endl;
+  os << indent.GetNextIndent() << "UseSparseDerivativeAccumulation: " << this->m_UseSparseDerivativeAccumulation
+     << std::endl;
+  os << indent.GetNextIndent() << "UseBSplineWeightsCache: " << this->m_UseBSplineWeightsCache << std::endl;
+  os << indent.GetNextIndent() << "MaximumBSplineWeightsCacheSize: " << this->m_MaximumBSplineWeightsCacheSize
+     << std::endl;
+  os << indent.GetNextIndent() << "BSplineWeightsCacheSize: " << this->GetBSplineWeightsCacheSize() << std::endl;
 
 } // end PrintSelf()
 
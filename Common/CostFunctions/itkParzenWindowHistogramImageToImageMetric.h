@@ -20,6 +20,9 @@
 
 #include "itkAdvancedImageToImageMetric.h"
 #include "itkKernelFunctionBase2.h"
+#include "itkParzenWindowVectorizedImplementation.h"
+
+#include <vector>
 
 
 namespace itk
@@ -262,6 +265,14 @@ protected:
   typedef KernelFunctionBase2<PDFValueType>    KernelFunctionType;
   typedef typename KernelFunctionType::Pointer KernelFunctionPointer;
 
+  /** The vectorized kernels for the joint histogram. */
+  typedef ParzenWindowVectorizedImplementation VectorizedImplementationType;
+
+  /** The maximum number of Parzen values of a sample in each direction.
+   * The B-spline order of the Parzen windows is at most three.
+   */
+  itkStaticConstMacro(MaximumParzenWindowSize, unsigned int, 4);
+
   /** Protected variables **************************** */
 
   /** Variables for Alpha (the normalization factor of the histogram). */
@@ -296,6 +307,13 @@ protected:
   /** Threading related parameters. */
   mutable std::vector<JointPDFPointer> m_ThreaderJointPDFs;
 
+  /** The memory of the joint histograms of the threads. The histograms are
+   * m_ThreaderJointPDFsStride values apart, and each starts at a cache line,
+   * so that the threads never write to the same cache line.
+   */
+  mutable std::vector<PDFValueType> m_ThreaderJointPDFsBuffer;
+  mutable SizeValueType             m_ThreaderJointPDFsStride;
+
   /** Helper structs that multi-threads the computation of
    * the metric derivative using ITK threads.
    */
@@ -328,7 +346,9 @@ protected:
   inline void
   ThreadedComputePDFs(ThreadIdType threadId);
 
-  /** Single-threadedly accumulate results. */
+  /** Accumulate the results of the threads. The joint histograms are summed with a
+   * pairwise tree reduction, which is multi-threaded for large histograms.
+   */
   inline void
   AfterThreadedComputePDFs(void) const;
 
@@ -352,6 +372,19 @@ protected:
                        const KernelFunctionType * kernel,
                        ParzenValueContainerType & parzenValues) const;
 
+  /** Compute the fixed or moving Parzen values into an array of MaximumParzenWindowSize
+   * values on the stack. The cubic B-spline window is evaluated with the vectorized kernel.
+   */
+  inline void
+  EvaluateFixedParzenValues(double          parzenWindowTerm,
+                            OffsetValueType parzenWindowIndex,
+                            PDFValueType *  parzenValues) const;
+
+  inline void
+  EvaluateMovingParzenValues(double         parzenWindowTerm,
+                             OffsetValueType parzenWindowIndex,
+                             PDFValueType *  parzenValues) const;
+
   /** Update the joint PDF with a pixel pair; on demand also updates the
    * pdf derivatives (if the Jacobian pointers are nonzero).
    */
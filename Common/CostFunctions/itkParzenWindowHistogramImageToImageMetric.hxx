@@ -26,6 +26,9 @@
 #include "itkImageScanlineIterator.h"
 #include "vnl/vnl_math.h"
 
+#include <algorithm>
+#include <cstdint>
+
 namespace itk
 {
 
@@ -74,6 +77,7 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ParzenWindow
   // Multi-threading structs
   this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables = nullptr;
   this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariablesSize = 0;
+  this->m_ThreaderJointPDFsStride = 0;
 
 } // end Constructor
 
@@ -466,22 +470,43 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::InitializeTh
     this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariablesSize = numberOfThreads;
   }
 
+  /** The joint histograms of the threads share one buffer. Each histogram is
+   * padded to a whole number of cache lines, and starts at a cache line boundary.
+   */
+  const SizeValueType numberOfBins = jointPDFRegion.GetNumberOfPixels();
+  const SizeValueType valuesPerCacheLine = ITK_CACHE_LINE_ALIGNMENT / sizeof(PDFValueType);
+  const SizeValueType stride = (numberOfBins + valuesPerCacheLine - 1) / valuesPerCacheLine * valuesPerCacheLine;
+  const SizeValueType bufferSize = numberOfThreads * stride + valuesPerCacheLine;
+  if (this->m_ThreaderJointPDFsBuffer.size() != bufferSize || this->m_ThreaderJointPDFsStride != stride)
+  {
+    std::vector<PDFValueType>(bufferSize).swap(this->m_ThreaderJointPDFsBuffer);
+    this->m_ThreaderJointPDFsStride = stride;
+  }
+  const std::size_t misalignment =
+    reinterpret_cast<std::uintptr_t>(this->m_ThreaderJointPDFsBuffer.data()) % ITK_CACHE_LINE_ALIGNMENT;
+  PDFValueType * const alignedBuffer =
+    this->m_ThreaderJointPDFsBuffer.data() +
+    (misalignment == 0 ? 0 : (ITK_CACHE_LINE_ALIGNMENT - misalignment) / sizeof(PDFValueType));
+
   /** Some initialization. */
   for (ThreadIdType i = 0; i < numberOfThreads; ++i)
   {
     this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables[i].st_NumberOfPixelsCounted =
       NumericTraits<SizeValueType>::Zero;
 
-    // Initialize the joint pdf
+    // Initialize the joint pdf, on its part of the buffer
     JointPDFPointer & jointPDF = this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables[i].st_JointPDF;
     if (jointPDF.IsNull())
     {
       jointPDF = JointPDFType::New();
     }
-    if (jointPDF->GetLargestPossibleRegion() != jointPDFRegion)
+    PDFValueType * const threadBuffer = alignedBuffer + i * stride;
+    if (jointPDF->GetLargestPossibleRegion() != jointPDFRegion || jointPDF->GetBufferPointer() != threadBuffer)
     {
+      JointPDFType::PixelContainerPointer pixelContainer = JointPDFType::PixelContainer::New();
+      pixelContainer->SetImportPointer(threadBuffer, numberOfBins, false);
       jointPDF->SetRegions(jointPDFRegion);
-      jointPDF->Allocate();
+      jointPDF->SetPixelContainer(pixelContainer);
     }
   }
 
@@ -544,6 +569,54 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::EvaluateParz
 } // end EvaluateParzenValues()
 
 
+/**
+ * ********************** EvaluateFixedParzenValues ***************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::EvaluateFixedParzenValues(
+  double          parzenWindowTerm,
+  OffsetValueType parzenWindowIndex,
+  PDFValueType *  parzenValues) const
+{
+  const double u = static_cast<double>(parzenWindowIndex) - parzenWindowTerm;
+  if (this->m_FixedKernelBSplineOrder == 3)
+  {
+    VectorizedImplementationType::EvaluateCubicBSplineWeights(
+      u, parzenValues, VectorizedImplementationType::GetInstructionSet());
+  }
+  else
+  {
+    this->m_FixedKernel->Evaluate(u, parzenValues);
+  }
+} // end EvaluateFixedParzenValues()
+
+
+/**
+ * ********************** EvaluateMovingParzenValues ***************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::EvaluateMovingParzenValues(
+  double          parzenWindowTerm,
+  OffsetValueType parzenWindowIndex,
+  PDFValueType *  parzenValues) const
+{
+  const double u = static_cast<double>(parzenWindowIndex) - parzenWindowTerm;
+  if (this->m_MovingKernelBSplineOrder == 3)
+  {
+    VectorizedImplementationType::EvaluateCubicBSplineWeights(
+      u, parzenValues, VectorizedImplementationType::GetInstructionSet());
+  }
+  else
+  {
+    this->m_MovingKernel->Evaluate(u, parzenValues);
+  }
+} // end EvaluateMovingParzenValues()
+
+
 /**
  * ********************** UpdateJointPDFAndDerivatives ***************
  */
@@ -557,8 +630,6 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
   const NonZeroJacobianIndicesType * nzji,
   JointPDFType *                     jointPDF) const
 {
-  typedef ImageScanlineIterator<JointPDFType> PDFIteratorType;
-
   /** Determine Parzen window arguments (see eq. 6 of Mattes paper [2]). */
   const double fixedImageParzenWindowTerm =
     fixedImageValue / this->m_FixedImageBinSize - this->m_FixedImageNormalizedMin;
@@ -571,65 +642,49 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
   const OffsetValueType movingImageParzenWindowIndex =
     static_cast<OffsetValueType>(std::floor(movingImageParzenWindowTerm + this->m_MovingParzenTermToIndexOffset));
 
-  /** The Parzen values. */
-  ParzenValueContainerType fixedParzenValues(this->m_JointPDFWindow.GetSize()[1]);
-  ParzenValueContainerType movingParzenValues(this->m_JointPDFWindow.GetSize()[0]);
-  this->EvaluateParzenValues(
-    fixedImageParzenWindowTerm, fixedImageParzenWindowIndex, this->m_FixedKernel, fixedParzenValues);
-  this->EvaluateParzenValues(
-    movingImageParzenWindowTerm, movingImageParzenWindowIndex, this->m_MovingKernel, movingParzenValues);
-
-  /** Position the JointPDFWindow. */
-  JointPDFIndexType pdfWindowIndex;
-  pdfWindowIndex[0] = movingImageParzenWindowIndex;
-  pdfWindowIndex[1] = fixedImageParzenWindowIndex;
-
-  /** For thread-safety, make a local copy of the support region,
-   * and use that one. Because each thread will modify it.
+  /** The Parzen values, which are stored on the stack. */
+  const unsigned int numberOfFixedParzenValues = this->m_JointPDFWindow.GetSize()[1];
+  const unsigned int numberOfMovingParzenValues = this->m_JointPDFWindow.GetSize()[0];
+  PDFValueType       fixedParzenValues[Self::MaximumParzenWindowSize];
+  PDFValueType       movingParzenValues[Self::MaximumParzenWindowSize];
+  this->EvaluateFixedParzenValues(fixedImageParzenWindowTerm, fixedImageParzenWindowIndex, fixedParzenValues);
+  this->EvaluateMovingParzenValues(movingImageParzenWindowTerm, movingImageParzenWindowIndex, movingParzenValues);
+
+  /** Add the outer product of the Parzen values to the Parzen window region of the
+   * joint pdf. The moving index is the first dimension, so each row of the
+   * window is contiguous in memory.
    */
-  JointPDFRegionType jointPDFWindow = this->m_JointPDFWindow;
-  jointPDFWindow.SetIndex(pdfWindowIndex);
-  PDFIteratorType it(jointPDF, jointPDFWindow);
-
-  if (!imageJacobian)
-  {
-    /** Loop over the Parzen window region and increment the values. */
-    for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
-    {
-      const double fv = fixedParzenValues[f];
-      for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
-      {
-        it.Value() += static_cast<PDFValueType>(fv * movingParzenValues[m]);
-        ++it;
-      }
-      it.NextLine();
-    }
-  }
-  else
+  const OffsetValueType rowStride = jointPDF->GetOffsetTable()[1];
+  PDFValueType * const  pdfWindowStart =
+    jointPDF->GetBufferPointer() + movingImageParzenWindowIndex + fixedImageParzenWindowIndex * rowStride;
+  VectorizedImplementationType::AddOuterProduct(pdfWindowStart,
+                                                rowStride,
+                                                fixedParzenValues,
+                                                numberOfFixedParzenValues,
+                                                movingParzenValues,
+                                                numberOfMovingParzenValues,
+                                                VectorizedImplementationType::GetInstructionSet());
+
+  if (imageJacobian)
   {
     /** Compute the derivatives of the moving Parzen window. */
-    ParzenValueContainerType derivativeMovingParzenValues(this->m_JointPDFWindow.GetSize()[0]);
-    this->EvaluateParzenValues(movingImageParzenWindowTerm,
-                               movingImageParzenWindowIndex,
-                               this->m_DerivativeMovingKernel,
-                               derivativeMovingParzenValues);
+    PDFValueType derivativeMovingParzenValues[Self::MaximumParzenWindowSize];
+    this->m_DerivativeMovingKernel->Evaluate(
+      static_cast<double>(movingImageParzenWindowIndex) - movingImageParzenWindowTerm, derivativeMovingParzenValues);
 
     const double et = static_cast<double>(this->m_MovingImageBinSize);
 
-    /** Loop over the Parzen window region and increment the values
-     * Also update the pdf derivatives.
-     */
-    for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+    /** Loop over the Parzen window region and update the pdf derivatives. */
+    JointPDFIndexType pdfIndex;
+    for (unsigned int f = 0; f < numberOfFixedParzenValues; ++f)
     {
-      const double fv = fixedParzenValues[f];
-      const double fv_et = fv / et;
-      for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
+      const double fv_et = fixedParzenValues[f] / et;
+      pdfIndex[1] = fixedImageParzenWindowIndex + f;
+      for (unsigned int m = 0; m < numberOfMovingParzenValues; ++m)
       {
-        it.Value() += static_cast<PDFValueType>(fv * movingParzenValues[m]);
-        this->UpdateJointPDFDerivatives(it.GetIndex(), fv_et * derivativeMovingParzenValues[m], *imageJacobian, *nzji);
-        ++it;
+        pdfIndex[0] = movingImageParzenWindowIndex + m;
+        this->UpdateJointPDFDerivatives(pdfIndex, fv_et * derivativeMovingParzenValues[m], *imageJacobian, *nzji);
       }
-      it.NextLine();
     }
   }
 
@@ -829,10 +884,13 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
   /** Pointers to the first pixels in the incremental joint pdfs. */
   PDFDerivativeValueType * incRightBasePtr = this->m_IncrementalJointPDFRight->GetBufferPointer();
   PDFDerivativeValueType * incLeftBasePtr = this->m_IncrementalJointPDFLeft->GetBufferPointer();
+  const OffsetValueType *  incOffsetTable = this->m_IncrementalJointPDFRight->GetOffsetTable();
 
-  /** The Parzen value containers. */
-  ParzenValueContainerType fixedParzenValues(this->m_JointPDFWindow.GetSize()[1]);
-  ParzenValueContainerType movingParzenValues(this->m_JointPDFWindow.GetSize()[0]);
+  /** The Parzen values, which are stored on the stack. */
+  const unsigned int numberOfFixedParzenValues = this->m_JointPDFWindow.GetSize()[1];
+  const unsigned int numberOfMovingParzenValues = this->m_JointPDFWindow.GetSize()[0];
+  PDFValueType       fixedParzenValues[Self::MaximumParzenWindowSize];
+  PDFValueType       movingParzenValues[Self::MaximumParzenWindowSize];
 
   /** Determine fixed image Parzen window arguments (see eq. 6 of Mattes paper [2]). */
   const double fixedImageParzenWindowTerm =
@@ -841,8 +899,7 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
   /** The lowest bin numbers affected by this pixel: */
   const OffsetValueType fixedImageParzenWindowIndex =
     static_cast<OffsetValueType>(std::floor(fixedImageParzenWindowTerm + this->m_FixedParzenTermToIndexOffset));
-  this->EvaluateParzenValues(
-    fixedImageParzenWindowTerm, fixedImageParzenWindowIndex, this->m_FixedKernel, fixedParzenValues);
+  this->EvaluateFixedParzenValues(fixedImageParzenWindowTerm, fixedImageParzenWindowIndex, fixedParzenValues);
 
   if (movingMaskValue > 1e-10)
   {
@@ -851,13 +908,7 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
       movingImageValue / this->m_MovingImageBinSize - this->m_MovingImageNormalizedMin;
     const OffsetValueType movingImageParzenWindowIndex =
       static_cast<OffsetValueType>(std::floor(movingImageParzenWindowTerm + this->m_MovingParzenTermToIndexOffset));
-    this->EvaluateParzenValues(
-      movingImageParzenWindowTerm, movingImageParzenWindowIndex, this->m_MovingKernel, movingParzenValues);
-
-    /** Position the JointPDFWindow (set the start index). */
-    JointPDFIndexType pdfIndex;
-    pdfIndex[0] = movingImageParzenWindowIndex;
-    pdfIndex[1] = fixedImageParzenWindowIndex;
+    this->EvaluateMovingParzenValues(movingImageParzenWindowTerm, movingImageParzenWindowIndex, movingParzenValues);
 
     /** Loop over the Parzen window region and do the following update:
      *
@@ -865,19 +916,32 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
      * m_IncrementalJointPDF<Right/Left>(k,M,F) -= movingMask * fixedParzen(F) * movingParzen(M);
      * for all k with nonzero Jacobian.
      */
-    for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+    PDFValueType fixedParzenValuesTimesMask[Self::MaximumParzenWindowSize];
+    for (unsigned int f = 0; f < numberOfFixedParzenValues; ++f)
     {
-      const double fv_mask = fixedParzenValues[f] * movingMaskValue;
-      for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
-      {
-        const PDFValueType fv_mask_mv = static_cast<PDFValueType>(fv_mask * movingParzenValues[m]);
-        this->m_JointPDF->GetPixel(pdfIndex) += fv_mask_mv;
+      fixedParzenValuesTimesMask[f] = fixedParzenValues[f] * movingMaskValue;
+    }
 
-        unsigned long offset =
-          static_cast<unsigned long>(pdfIndex[0] * this->m_IncrementalJointPDFRight->GetOffsetTable()[1] +
-                                     pdfIndex[1] * this->m_IncrementalJointPDFRight->GetOffsetTable()[2]);
+    const OffsetValueType rowStride = this->m_JointPDF->GetOffsetTable()[1];
+    PDFValueType * const  pdfWindowStart =
+      this->m_JointPDF->GetBufferPointer() + movingImageParzenWindowIndex + fixedImageParzenWindowIndex * rowStride;
+    VectorizedImplementationType::AddOuterProduct(pdfWindowStart,
+                                                  rowStride,
+                                                  fixedParzenValuesTimesMask,
+                                                  numberOfFixedParzenValues,
+                                                  movingParzenValues,
+                                                  numberOfMovingParzenValues,
+                                                  VectorizedImplementationType::GetInstructionSet());
+
+    for (unsigned int f = 0; f < numberOfFixedParzenValues; ++f)
+    {
+      for (unsigned int m = 0; m < numberOfMovingParzenValues; ++m)
+      {
+        const PDFValueType    fv_mask_mv = fixedParzenValuesTimesMask[f] * movingParzenValues[m];
+        const OffsetValueType offset = (movingImageParzenWindowIndex + m) * incOffsetTable[1] +
+                                       (fixedImageParzenWindowIndex + f) * incOffsetTable[2];
 
-        /** Get the pointer to the element with index [0, pdfIndex[0], pdfIndex[1]]. */
+        /** Get the pointer to the element with index [0, M, F]. */
         PDFDerivativeValueType * incRightPtr = incRightBasePtr + offset;
         PDFDerivativeValueType * incLeftPtr = incLeftBasePtr + offset;
 
@@ -890,14 +954,8 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
           *(rPtr) -= fv_mask_mv;
           *(lPtr) -= fv_mask_mv;
         } // end for i
-
-        ++(pdfIndex[0]);
-      } // end for m
-
-      pdfIndex[0] = movingImageParzenWindowIndex;
-      ++(pdfIndex[1]);
-
-    } // end for f
+      }   // end for m
+    }     // end for f
 
   } // end if movingMaskValue > 1e-10
 
@@ -909,8 +967,6 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
    * m_PerturbedAlpha<Right/Left>[k] += movingMask<Right/Left>[k] - movingMask;
    * for all k with nonzero Jacobian.
    */
-  JointPDFDerivativesIndexType rindex;
-  JointPDFDerivativesIndexType lindex;
   for (unsigned int i = 0; i < nzji.size(); ++i)
   {
     const unsigned int mu = nzji[i];
@@ -919,67 +975,53 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
 
     if (maskr > 1e-10)
     {
-      /** Compute Parzen stuff; note: we reuse the movingParzenValues container. */
+      /** Compute Parzen stuff; note: we reuse the movingParzenValues array. */
       const double movr = movingImageValuesRight[i];
       const double movParzenWindowTermRight = movr / this->m_MovingImageBinSize - this->m_MovingImageNormalizedMin;
       const OffsetValueType movParzenWindowIndexRight =
         static_cast<OffsetValueType>(std::floor(movParzenWindowTermRight + this->m_MovingParzenTermToIndexOffset));
-      this->EvaluateParzenValues(
-        movParzenWindowTermRight, movParzenWindowIndexRight, this->m_MovingKernel, movingParzenValues);
+      this->EvaluateMovingParzenValues(movParzenWindowTermRight, movParzenWindowIndexRight, movingParzenValues);
 
-      /** Initialize index in IncrementalJointPDFRight. */
-      rindex[0] = mu;
-      rindex[1] = movParzenWindowIndexRight;
-      rindex[2] = fixedImageParzenWindowIndex;
+      /** Get the pointer to the element with index [mu, movParzenWindowIndexRight, fixedImageParzenWindowIndex]. */
+      PDFDerivativeValueType * incRightPtr = incRightBasePtr + mu + movParzenWindowIndexRight * incOffsetTable[1] +
+                                             fixedImageParzenWindowIndex * incOffsetTable[2];
 
       /** Loop over Parzen window and update IncrementalJointPDFRight. */
-      for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+      for (unsigned int f = 0; f < numberOfFixedParzenValues; ++f)
       {
         const double fv_mask = fixedParzenValues[f] * maskr;
-        for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
+        for (unsigned int m = 0; m < numberOfMovingParzenValues; ++m)
         {
           const PDFValueType fv_mask_mv = static_cast<PDFValueType>(fv_mask * movingParzenValues[m]);
-          this->m_IncrementalJointPDFRight->GetPixel(rindex) += fv_mask_mv;
-          ++(rindex[1]);
+          incRightPtr[m * incOffsetTable[1] + f * incOffsetTable[2]] += fv_mask_mv;
         } // end for m
-
-        ++(rindex[2]);
-        rindex[1] = movParzenWindowIndexRight;
-
-      } // end for f
-    }   // end if maskr
+      }   // end for f
+    }     // end if maskr
 
     if (maskl > 1e-10)
     {
-      /** Compute Parzen stuff; note: we reuse the movingParzenValues container. */
+      /** Compute Parzen stuff; note: we reuse the movingParzenValues array. */
       const double movl = movingImageValuesLeft[i];
       const double movParzenWindowTermLeft = movl / this->m_MovingImageBinSize - this->m_MovingImageNormalizedMin;
       const OffsetValueType movParzenWindowIndexLeft =
         static_cast<OffsetValueType>(std::floor(movParzenWindowTermLeft + this->m_MovingParzenTermToIndexOffset));
-      this->EvaluateParzenValues(
-        movParzenWindowTermLeft, movParzenWindowIndexLeft, this->m_MovingKernel, movingParzenValues);
+      this->EvaluateMovingParzenValues(movParzenWindowTermLeft, movParzenWindowIndexLeft, movingParzenValues);
 
-      /** Initialize index in IncrementalJointPDFLeft. */
-      lindex[0] = mu;
-      lindex[1] = movParzenWindowIndexLeft;
-      lindex[2] = fixedImageParzenWindowIndex;
+      /** Get the pointer to the element with index [mu, movParzenWindowIndexLeft, fixedImageParzenWindowIndex]. */
+      PDFDerivativeValueType * incLeftPtr = incLeftBasePtr + mu + movParzenWindowIndexLeft * incOffsetTable[1] +
+                                            fixedImageParzenWindowIndex * incOffsetTable[2];
 
       /** Loop over Parzen window and update IncrementalJointPDFLeft. */
-      for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+      for (unsigned int f = 0; f < numberOfFixedParzenValues; ++f)
       {
         const double fv_mask = fixedParzenValues[f] * maskl;
-        for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
+        for (unsigned int m = 0; m < numberOfMovingParzenValues; ++m)
         {
           const PDFValueType fv_mask_mv = static_cast<PDFValueType>(fv_mask * movingParzenValues[m]);
-          this->m_IncrementalJointPDFLeft->GetPixel(lindex) += fv_mask_mv;
-          ++(lindex[1]);
+          incLeftPtr[m * incOffsetTable[1] + f * incOffsetTable[2]] += fv_mask_mv;
         } // end for m
-
-        ++(lindex[2]);
-        lindex[1] = movParzenWindowIndexLeft;
-
-      } // end for f
-    }   // end if maskl
+      }   // end for f
+    }     // end if maskl
 
     /** Update the perturbed alphas. */
     this->m_PerturbedAlphaRight[mu] += (maskr - movingMaskValue);
@@ -1134,67 +1176,66 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ThreadedComp
 
   /** Get a handle to the sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
-  const unsigned long         sampleContainerSize = sampleContainer->Size();
-
-  /** Get the samples for this thread. */
-  const unsigned long nrOfSamplesPerThreads = static_cast<unsigned long>(
-    std::ceil(static_cast<double>(sampleContainerSize) / static_cast<double>(Self::GetNumberOfWorkUnits())));
-
-  unsigned long pos_begin = nrOfSamplesPerThreads * threadId;
-  unsigned long pos_end = nrOfSamplesPerThreads * (threadId + 1);
-  pos_begin = (pos_begin > sampleContainerSize) ? sampleContainerSize : pos_begin;
-  pos_end = (pos_end > sampleContainerSize) ? sampleContainerSize : pos_end;
-
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator fiter;
-  typename ImageSampleContainerType::ConstIterator fbegin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator fend = sampleContainer->Begin();
-  fbegin += (int)pos_begin;
-  fend += (int)pos_end;
 
   /** Create variables to store intermediate results. circumvent false sharing */
   unsigned long numberOfPixelsCounted = 0;
 
-  /** Loop over sample container and compute contribution of each sample to pdfs. */
-  for (fiter = fbegin; fiter != fend; ++fiter)
+  /** Process the chunks of samples that this thread gets from the scheduler.
+   * A thread first processes its own part of the sample container, and then
+   * helps the other threads, see GetNextSampleChunk().
+   */
+  SizeValueType pos_begin = 0;
+  SizeValueType pos_end = 0;
+  while (this->GetNextSampleChunk(threadId, pos_begin, pos_end))
   {
-    /** Read fixed coordinates and initialize some variables. */
-    const FixedImagePointType & fixedPoint = (*fiter).Value().m_ImageCoordinates;
-    RealType                    movingImageValue;
-    MovingImagePointType        mappedPoint;
+    /** Create iterator over the samples of this chunk. */
+    typename ImageSampleContainerType::ConstIterator fiter;
+    typename ImageSampleContainerType::ConstIterator fbegin = sampleContainer->Begin();
+    typename ImageSampleContainerType::ConstIterator fend = sampleContainer->Begin();
+    fbegin += (int)pos_begin;
+    fend += (int)pos_end;
+
+    /** Loop over sample container and compute contribution of each sample to pdfs. */
+    for (fiter = fbegin; fiter != fend; ++fiter)
+    {
+      /** Read fixed coordinates and initialize some variables. */
+      const FixedImagePointType & fixedPoint = (*fiter).Value().m_ImageCoordinates;
+      RealType                    movingImageValue;
+      MovingImagePointType        mappedPoint;
 
-    /** Transform point and check if it is inside the B-spline support region. */
-    bool sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
+      /** Transform point and check if it is inside the B-spline support region. */
+      bool sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
 
-    /** Check if point is inside mask. */
-    if (sampleOk)
-    {
-      sampleOk = this->IsInsideMovingMask(mappedPoint);
-    }
+      /** Check if point is inside mask. */
+      if (sampleOk)
+      {
+        sampleOk = this->IsInsideMovingMask(mappedPoint);
+      }
 
-    /** Compute the moving image value and check if the point is
-     * inside the moving image buffer.
-     */
-    if (sampleOk)
-    {
-      sampleOk = this->EvaluateMovingImageValueAndDerivative(mappedPoint, movingImageValue, nullptr);
-    }
+      /** Compute the moving image value and check if the point is
+       * inside the moving image buffer.
+       */
+      if (sampleOk)
+      {
+        sampleOk = this->EvaluateMovingImageValueAndDerivative(mappedPoint, movingImageValue, nullptr);
+      }
 
-    if (sampleOk)
-    {
-      numberOfPixelsCounted++;
+      if (sampleOk)
+      {
+        numberOfPixelsCounted++;
 
-      /** Get the fixed image value. */
-      RealType fixedImageValue = static_cast<RealType>((*fiter).Value().m_ImageValue);
+        /** Get the fixed image value. */
+        RealType fixedImageValue = static_cast<RealType>((*fiter).Value().m_ImageValue);
 
-      /** Make sure the values fall within the histogram range. */
-      fixedImageValue = this->GetFixedImageLimiter()->Evaluate(fixedImageValue);
-      movingImageValue = this->GetMovingImageLimiter()->Evaluate(movingImageValue);
+        /** Make sure the values fall within the histogram range. */
+        fixedImageValue = this->GetFixedImageLimiter()->Evaluate(fixedImageValue);
+        movingImageValue = this->GetMovingImageLimiter()->Evaluate(movingImageValue);
 
-      /** Compute this sample's contribution to the joint distributions. */
-      this->UpdateJointPDFAndDerivatives(fixedImageValue, movingImageValue, nullptr, nullptr, jointPDF.GetPointer());
-    }
-  } // end iterating over fixed image spatial sample container for loop
+        /** Compute this sample's contribution to the joint distributions. */
+        this->UpdateJointPDFAndDerivatives(fixedImageValue, movingImageValue, nullptr, nullptr, jointPDF.GetPointer());
+      }
+    } // end iterating over fixed image spatial sample container for loop
+  } // end while loop over the chunks
 
   /** Only update these variables at the end to prevent unnecessary "false sharing". */
   this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables[threadId].st_NumberOfPixelsCounted =
@@ -1232,35 +1273,71 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::AfterThreade
   /** Compute alpha. */
   this->m_Alpha = 1.0 / static_cast<double>(this->m_NumberOfPixelsCounted);
 
-  /** Accumulate joint histogram. */
-  // could be multi-threaded too, by each thread updating only a part of the JointPDF.
-  typedef ImageScanlineIterator<JointPDFType> JointPDFIteratorType;
-  JointPDFIteratorType                        it(this->m_JointPDF, this->m_JointPDF->GetBufferedRegion());
-  std::vector<JointPDFIteratorType>           itT(numberOfThreads);
+  /** Accumulate the joint histograms of the threads with a pairwise tree reduction.
+   * At each level, the histogram of thread i receives the sum of its own histogram
+   * and the one of thread i + step. The last level writes the total into m_JointPDF.
+   * The histograms are split into blocks, which are summed on the thread pool when
+   * a level has enough work. The order of the summations does not depend on that.
+   */
+  typedef VectorizedImplementationType::InstructionSetType InstructionSetType;
+  const InstructionSetType instructionSet = VectorizedImplementationType::GetInstructionSet();
+  const SizeValueType      numberOfBins = this->m_JointPDF->GetBufferedRegion().GetNumberOfPixels();
+  PDFValueType * const     outputPDF = this->m_JointPDF->GetBufferPointer();
+
+  std::vector<PDFValueType *> threadPDFs(numberOfThreads);
   for (ThreadIdType i = 0; i < numberOfThreads; ++i)
   {
-    itT[i] = JointPDFIteratorType(this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables[i].st_JointPDF,
-                                  this->m_JointPDF->GetBufferedRegion());
+    JointPDFType * threadPDF = this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables[i].st_JointPDF;
+    threadPDFs[i] = threadPDF->GetBufferPointer();
   }
 
-  PDFValueType sum;
-  while (!it.IsAtEnd())
+  if (numberOfThreads == 1)
   {
-    while (!it.IsAtEndOfLine())
+    std::copy(threadPDFs[0], threadPDFs[0] + numberOfBins, outputPDF);
+    return;
+  }
+
+  const SizeValueType blockSize = 4096;
+  const SizeValueType minimumNumberOfValuesForThreading = 65536;
+  const SizeValueType numberOfBlocks = (numberOfBins + blockSize - 1) / blockSize;
+  for (ThreadIdType step = 1; step < numberOfThreads; step *= 2)
+  {
+    const bool          isLastLevel = 2 * step >= numberOfThreads;
+    const SizeValueType numberOfPairs = (numberOfThreads - step + 2 * step - 1) / (2 * step);
+    const SizeValueType numberOfTasks = numberOfPairs * numberOfBlocks;
+
+    /** Add one block of the histograms of one pair of threads. */
+    const auto addBlock = [&threadPDFs, outputPDF, instructionSet, numberOfBins, numberOfBlocks, blockSize, step,
+                           isLastLevel](SizeValueType task) {
+      const SizeValueType  first = 2 * step * (task / numberOfBlocks);
+      const SizeValueType  begin = (task % numberOfBlocks) * blockSize;
+      PDFValueType * const output = isLastLevel ? outputPDF : threadPDFs[first];
+      VectorizedImplementationType::AddHistograms(output + begin,
+                                                  threadPDFs[first] + begin,
+                                                  threadPDFs[first + step] + begin,
+                                                  std::min(blockSize, numberOfBins - begin),
+                                                  instructionSet);
+    };
+
+    /** Small levels are summed by this thread, because that is faster than starting the work units. */
+    const ThreadIdType numberOfWorkUnits =
+      static_cast<ThreadIdType>(std::min<SizeValueType>(numberOfTasks, numberOfThreads));
+    if (numberOfWorkUnits < 2 || numberOfPairs * numberOfBins < minimumNumberOfValuesForThreading)
     {
-      sum = NumericTraits<PDFValueType>::Zero;
-      for (ThreadIdType i = 0; i < numberOfThreads; ++i)
+      for (SizeValueType task = 0; task < numberOfTasks; ++task)
       {
-        sum += itT[i].Value();
-        ++itT[i];
+        addBlock(task);
       }
-      it.Set(sum);
-      ++it;
     }
-    it.NextLine();
-    for (ThreadIdType i = 0; i < numberOfThreads; ++i)
+    else
     {
-      itT[i].NextLine();
+      const auto addBlocks = [&addBlock, numberOfTasks, numberOfWorkUnits](ThreadIdType workUnit) {
+        for (SizeValueType task = workUnit; task < numberOfTasks; task += numberOfWorkUnits)
+        {
+          addBlock(task);
+        }
+      };
+      this->m_ThreadPool->Execute(numberOfWorkUnits, addBlocks);
     }
   }
 
@@ -1296,13 +1373,12 @@ template <class TFixedImage, class TMovingImage>
 void
 ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::LaunchComputePDFsThreaderCallback(void) const
 {
-  /** Setup threader. */
-  this->m_Threader->SetSingleMethod(
-    this->ComputePDFsThreaderCallback,
-    const_cast<void *>(static_cast<const void *>(&this->m_ParzenWindowHistogramThreaderParameters)));
+  /** Distribute the samples over the work units. */
+  this->InitializeSampleChunks();
 
   /** Launch. */
-  this->m_Threader->SingleMethodExecute();
+  this->ExecuteThreaderCallback(this->ComputePDFsThreaderCallback,
+                                const_cast<void *>(static_cast<const void *>(&this->m_ParzenWindowHistogramThreaderParameters)));
 
 } // end LaunchComputePDFsThreaderCallback()
 
@@ -0,0 +1,252 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParzenWindowVectorizedImplementation_h
+#define itkParzenWindowVectorizedImplementation_h
+
+#include "itkIntTypes.h"
+
+#include <cmath>
+
+/** The explicitly vectorized kernels are only compiled for x86 processors.
+ * They do not need any compiler flags: the AVX kernels are compiled for their
+ * own instruction set, which is selected at run time, based on the capabilities
+ * of the processor.
+ */
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) &&                            \
+  (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#  define ELASTIX_PARZEN_WINDOW_SIMD
+#  include <immintrin.h>
+#  if defined(__GNUC__) || defined(__clang__)
+#    define ELASTIX_PARZEN_WINDOW_TARGET_AVX __attribute__((target("avx")))
+#  else
+#    include <intrin.h>
+#    define ELASTIX_PARZEN_WINDOW_TARGET_AVX
+#  endif
+#endif
+
+namespace itk
+{
+
+/** \class ParzenWindowVectorizedImplementation
+ *
+ * \brief Explicitly vectorized kernels for the Parzen window joint histogram.
+ *
+ * The ParzenWindowHistogramImageToImageMetric adds each sample to the joint histogram
+ * with the outer product of the fixed and the moving Parzen values. The moving Parzen
+ * window is a cubic B-spline by default, whose four values fill one AVX register. Each
+ * row of the outer product is then added to the histogram with a single instruction.
+ * The four values of the cubic B-spline are themselves evaluated at once, as four
+ * polynomials in packed lanes.
+ *
+ * The results are equal to the ones of the scalar implementation: the kernels do not
+ * use fused multiply-add instructions, and perform the same operations in the same order.
+ *
+ * The instruction set is detected once, at run time. On other processors, and when the
+ * vectorized kernels are not compiled in, the scalar implementation is used.
+ *
+ * \ingroup RegistrationMetrics
+ */
+
+class ParzenWindowVectorizedImplementation
+{
+public:
+  /** The instruction sets for which a vectorized implementation may exist. */
+  typedef enum
+  {
+    Scalar = 0,
+    AVX = 1
+  } InstructionSetType;
+
+  /** Get the fastest instruction set that is supported by this processor.
+   * The detection is only done at the first call.
+   */
+  static InstructionSetType
+  GetInstructionSet(void)
+  {
+    static const InstructionSetType instructionSet = DetectInstructionSet();
+    return instructionSet;
+  }
+
+
+  /** Evaluate the cubic B-spline at the entire support, like
+   * BSplineKernelFunction2<3>::Evaluate( u, weights ).
+   */
+  static inline void
+  EvaluateCubicBSplineWeights(const double u, double * weights, InstructionSetType instructionSet)
+  {
+#ifdef ELASTIX_PARZEN_WINDOW_SIMD
+    if (instructionSet == AVX)
+    {
+      EvaluateCubicBSplineWeightsAVX(u, weights);
+      return;
+    }
+#endif
+    const double absValue = std::abs(u);
+    const double sqrValue = u * u;
+    const double uuu = sqrValue * absValue;
+
+    static const double onesixth = 1.0 / 6.0;
+    weights[0] = (8.0 - 12.0 * absValue + 6.0 * sqrValue - uuu) * onesixth;
+    weights[1] = (-5.0 + 21.0 * absValue - 15.0 * sqrValue + 3.0 * uuu) * onesixth;
+    weights[2] = (4.0 - 12.0 * absValue + 12.0 * sqrValue - 3.0 * uuu) * onesixth;
+    weights[3] = (-1.0 + 3.0 * absValue - 3.0 * sqrValue + uuu) * onesixth;
+  } // end EvaluateCubicBSplineWeights()
+
+
+  /** Add the outer product of the fixed and the moving Parzen values to a histogram:
+   *   histogram[ f * rowStride + m ] += fixedValues[ f ] * movingValues[ m ].
+   */
+  static inline void
+  AddOuterProduct(double *              histogram,
+                  const OffsetValueType rowStride,
+                  const double *        fixedValues,
+                  const unsigned int    numberOfFixedValues,
+                  const double *        movingValues,
+                  const unsigned int    numberOfMovingValues,
+                  InstructionSetType    instructionSet)
+  {
+#ifdef ELASTIX_PARZEN_WINDOW_SIMD
+    if (instructionSet == AVX && numberOfMovingValues == 4)
+    {
+      AddOuterProductAVX(histogram, rowStride, fixedValues, numberOfFixedValues, movingValues);
+      return;
+    }
+#endif
+    for (unsigned int f = 0; f < numberOfFixedValues; ++f)
+    {
+      const double fv = fixedValues[f];
+      double *     row = histogram + f * rowStride;
+      for (unsigned int m = 0; m < numberOfMovingValues; ++m)
+      {
+        row[m] += fv * movingValues[m];
+      }
+    }
+  } // end AddOuterProduct()
+
+
+  /** Add two histograms: output[ i ] = input0[ i ] + input1[ i ].
+   * The output may be equal to one of the inputs.
+   */
+  static inline void
+  AddHistograms(double *            output,
+                const double *      input0,
+                const double *      input1,
+                const SizeValueType size,
+                InstructionSetType  instructionSet)
+  {
+    SizeValueType i = 0;
+#ifdef ELASTIX_PARZEN_WINDOW_SIMD
+    if (instructionSet == AVX)
+    {
+      i = AddHistogramsAVX(output, input0, input1, size);
+    }
+#endif
+    for (; i < size; ++i)
+    {
+      output[i] = input0[i] + input1[i];
+    }
+  } // end AddHistograms()
+
+private:
+  /** Detect the fastest supported instruction set. */
+  static InstructionSetType
+  DetectInstructionSet(void)
+  {
+#ifdef ELASTIX_PARZEN_WINDOW_SIMD
+#  if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    const bool hasAVX = __builtin_cpu_supports("avx");
+#  else
+    /** Check the CPUID feature bit, and whether the operating system saves
+     * the YMM registers on a context switch.
+     */
+    int info[4];
+    __cpuid(info, 1);
+    const bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+    bool       hasAVX = false;
+    if (hasOSXSAVE && (info[2] & (1 << 28)) != 0)
+    {
+      hasAVX = (_xgetbv(0) & 0x06) == 0x06;
+    }
+#  endif
+    if (hasAVX)
+    {
+      return AVX;
+    }
+#endif
+    return Scalar;
+  } // end DetectInstructionSet()
+
+
+#ifdef ELASTIX_PARZEN_WINDOW_SIMD
+
+  /** The cubic B-spline weights, as four polynomials in |u| evaluated in packed lanes. */
+  ELASTIX_PARZEN_WINDOW_TARGET_AVX static void
+  EvaluateCubicBSplineWeightsAVX(const double u, double * weights)
+  {
+    const double absValue = std::abs(u);
+    const double sqrValue = u * u;
+    const double uuu = sqrValue * absValue;
+
+    const __m256d c0 = _mm256_setr_pd(8.0, -5.0, 4.0, -1.0);
+    const __m256d c1 = _mm256_setr_pd(-12.0, 21.0, -12.0, 3.0);
+    const __m256d c2 = _mm256_setr_pd(6.0, -15.0, 12.0, -3.0);
+    const __m256d c3 = _mm256_setr_pd(-1.0, 3.0, -3.0, 1.0);
+
+    __m256d w = _mm256_add_pd(c0, _mm256_mul_pd(c1, _mm256_set1_pd(absValue)));
+    w = _mm256_add_pd(w, _mm256_mul_pd(c2, _mm256_set1_pd(sqrValue)));
+    w = _mm256_add_pd(w, _mm256_mul_pd(c3, _mm256_set1_pd(uuu)));
+    _mm256_storeu_pd(weights, _mm256_mul_pd(w, _mm256_set1_pd(1.0 / 6.0)));
+  } // end EvaluateCubicBSplineWeightsAVX()
+
+
+  /** Add the outer product with four moving values, one histogram row per instruction. */
+  ELASTIX_PARZEN_WINDOW_TARGET_AVX static void
+  AddOuterProductAVX(double *              histogram,
+                     const OffsetValueType rowStride,
+                     const double *        fixedValues,
+                     const unsigned int    numberOfFixedValues,
+                     const double *        movingValues)
+  {
+    const __m256d mv = _mm256_loadu_pd(movingValues);
+    for (unsigned int f = 0; f < numberOfFixedValues; ++f)
+    {
+      double * row = histogram + f * rowStride;
+      _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), _mm256_mul_pd(_mm256_set1_pd(fixedValues[f]), mv)));
+    }
+  } // end AddOuterProductAVX()
+
+
+  /** Add the histograms in blocks of four values. Returns the number of values done. */
+  ELASTIX_PARZEN_WINDOW_TARGET_AVX static SizeValueType
+  AddHistogramsAVX(double * output, const double * input0, const double * input1, const SizeValueType size)
+  {
+    SizeValueType i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+      _mm256_storeu_pd(output + i, _mm256_add_pd(_mm256_loadu_pd(input0 + i), _mm256_loadu_pd(input1 + i)));
+    }
+    return i;
+  } // end AddHistogramsAVX()
+
+#endif // ELASTIX_PARZEN_WINDOW_SIMD
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkParzenWindowVectorizedImplementation_h
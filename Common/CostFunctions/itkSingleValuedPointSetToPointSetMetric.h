@@ -172,6 +172,16 @@ public:
   itkGetConstReferenceMacro(UseMetricSingleThreaded, bool);
   itkBooleanMacro(UseMetricSingleThreaded);
 
+  /** Returns whether GetValueAndDerivative() may run concurrently with that of
+   * other metrics sharing the same transform. This base class returns false.
+   */
+  virtual bool
+  GetSupportsConcurrentGetValueAndDerivative(void) const
+  {
+    return false;
+  }
+
+
 protected:
   SingleValuedPointSetToPointSetMetric();
   ~SingleValuedPointSetToPointSetMetric() override = default;
@@ -0,0 +1,133 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkAdvancedBSplineDeformableTransform.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+using TransformType = itk::AdvancedBSplineDeformableTransform<double, 3, 3>;
+
+
+// Creates a B-spline transform on a 7 x 6 x 5 grid with nonzero coefficients.
+TransformType::Pointer
+CreateTransform(TransformType::ParametersType & parameters)
+{
+  TransformType::OriginType origin;
+  origin[0] = -2.0;
+  origin[1] = -1.0;
+  origin[2] = -3.0;
+  TransformType::SpacingType spacing;
+  spacing[0] = 2.0;
+  spacing[1] = 3.0;
+  spacing[2] = 2.5;
+  TransformType::RegionType region;
+  region.SetSize(TransformType::SizeType{ { 7, 6, 5 } });
+
+  const auto transform = TransformType::New();
+  transform->SetGridOrigin(origin);
+  transform->SetGridSpacing(spacing);
+  transform->SetGridRegion(region);
+
+  parameters.SetSize(transform->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = std::sin(0.37 * i);
+  }
+  transform->SetParameters(parameters);
+  return transform;
+}
+
+} // namespace
+
+
+GTEST_TEST(AdvancedBSplineDeformableTransform, WeightsAndSupportOffsetReproduceTransformAndJacobian)
+{
+  TransformType::ParametersType parameters;
+  const auto                    transform = CreateTransform(parameters);
+
+  const unsigned int                          numberOfWeights = transform->GetNumberOfWeights();
+  const TransformType::NumberOfParametersType parametersPerDimension = transform->GetNumberOfParametersPerDimension();
+  const TransformType::NumberOfParametersType nnzji = transform->GetNumberOfNonZeroJacobianIndices();
+  std::vector<itk::OffsetValueType>           supportOffsets;
+  std::vector<float>                          weights(numberOfWeights);
+  TransformType::MovingImageGradientType      movingImageGradient;
+  TransformType::DerivativeType               imageJacobian(nnzji);
+  TransformType::NonZeroJacobianIndicesType   nzji(nnzji);
+  transform->GetSupportOffsets(supportOffsets);
+  ASSERT_EQ(supportOffsets.size(), numberOfWeights);
+
+  movingImageGradient[0] = 1.0;
+  movingImageGradient[1] = -2.0;
+  movingImageGradient[2] = 0.5;
+
+  for (unsigned int i = 0; i < 20; ++i)
+  {
+    TransformType::InputPointType point;
+    point[0] = 2.0 + 0.1 * i;
+    point[1] = 4.0 + 0.07 * i;
+    point[2] = 2.0 + 0.05 * i;
+
+    itk::OffsetValueType supportOffset = 0;
+    ASSERT_TRUE(transform->ComputeWeightsAndSupportOffset(point, weights.data(), supportOffset));
+
+    /** Gathering the coefficients gives the transformed point. */
+    const TransformType::OutputPointType expectedPoint = transform->TransformPoint(point);
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      double displacement = 0.0;
+      for (unsigned int k = 0; k < numberOfWeights; ++k)
+      {
+        displacement += weights[k] * parameters[d * parametersPerDimension + supportOffset + supportOffsets[k]];
+      }
+      EXPECT_NEAR(point[d] + displacement, expectedPoint[d], 1e-5);
+    }
+
+    /** The weights and offsets give the Jacobian and its nonzero indices. */
+    transform->EvaluateJacobianWithImageGradientProduct(point, movingImageGradient, imageJacobian, nzji);
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      for (unsigned int k = 0; k < numberOfWeights; ++k)
+      {
+        const auto expectedIndex = d * parametersPerDimension + supportOffset + supportOffsets[k];
+        EXPECT_EQ(nzji[d * numberOfWeights + k], static_cast<unsigned long>(expectedIndex));
+        EXPECT_NEAR(imageJacobian[d * numberOfWeights + k], weights[k] * movingImageGradient[d], 1e-6);
+      }
+    }
+  }
+}
+
+
+GTEST_TEST(AdvancedBSplineDeformableTransform, NoWeightsOutsideValidRegion)
+{
+  TransformType::ParametersType parameters;
+  const auto                    transform = CreateTransform(parameters);
+
+  TransformType::InputPointType point;
+  point.Fill(-100.0);
+
+  std::vector<float>   weights(transform->GetNumberOfWeights());
+  itk::OffsetValueType supportOffset = 0;
+  EXPECT_FALSE(transform->ComputeWeightsAndSupportOffset(point, weights.data(), supportOffset));
+}
@@ -0,0 +1,152 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "BSplineDeformableTransformWithDiffusion/itkDeformationFieldRegulizer.h"
+
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkAdvancedCombinationTransform.h"
+#include "itkAdvancedTranslationTransform.h"
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+using CombinationTransformType = itk::AdvancedCombinationTransform<double, 2>;
+using RegulizerType = itk::DeformationFieldRegulizer<CombinationTransformType>;
+using BSplineTransformType = itk::AdvancedBSplineDeformableTransform<double, 2, 3>;
+using TranslationTransformType = itk::AdvancedTranslationTransform<double, 2>;
+using PointType = RegulizerType::InputPointType;
+
+
+// Creates a regulizer with a B-spline current transform and a nonzero intermediary deformation field.
+RegulizerType::Pointer
+CreateRegulizer()
+{
+  BSplineTransformType::OriginType origin;
+  origin.Fill(-4.0);
+  BSplineTransformType::SpacingType spacing;
+  spacing.Fill(4.0);
+  BSplineTransformType::RegionType gridRegion;
+  gridRegion.SetSize(BSplineTransformType::SizeType{ { 8, 7 } });
+
+  const auto bsplineTransform = BSplineTransformType::New();
+  bsplineTransform->SetGridOrigin(origin);
+  bsplineTransform->SetGridSpacing(spacing);
+  bsplineTransform->SetGridRegion(gridRegion);
+  BSplineTransformType::ParametersType parameters(bsplineTransform->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = std::sin(0.37 * i);
+  }
+  bsplineTransform->SetParameters(parameters);
+
+  RegulizerType::RegionType fieldRegion;
+  fieldRegion.SetSize(RegulizerType::RegionType::SizeType{ { 20, 16 } });
+  RegulizerType::SpacingType fieldSpacing;
+  fieldSpacing.Fill(1.0);
+  RegulizerType::OriginType fieldOrigin;
+  fieldOrigin.Fill(0.0);
+
+  const auto regulizer = RegulizerType::New();
+  regulizer->SetCurrentTransform(bsplineTransform);
+  regulizer->SetDeformationFieldRegion(fieldRegion);
+  regulizer->SetDeformationFieldSpacing(fieldSpacing);
+  regulizer->SetDeformationFieldOrigin(fieldOrigin);
+  regulizer->InitializeDeformationFields();
+
+  const auto field = RegulizerType::VectorImageType::New();
+  field->SetRegions(fieldRegion);
+  field->SetSpacing(fieldSpacing);
+  field->SetOrigin(fieldOrigin);
+  field->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<RegulizerType::VectorImageType> it(field, fieldRegion); !it.IsAtEnd(); ++it)
+  {
+    RegulizerType::VectorPixelType displacement;
+    displacement[0] = std::cos(0.3 * it.GetIndex()[0] + 0.1 * it.GetIndex()[1]);
+    displacement[1] = 0.5 * std::sin(0.2 * it.GetIndex()[1]);
+    it.Set(displacement);
+  }
+  regulizer->UpdateIntermediaryDeformationFieldTransform(field);
+  return regulizer;
+}
+
+
+// Expects that TransformPointBatch gives the same points as TransformPoint.
+void
+ExpectBatchEqualsTransformPoint(const RegulizerType & regulizer)
+{
+  std::vector<PointType> inputPoints(150);
+  for (std::size_t n = 0; n < inputPoints.size(); ++n)
+  {
+    inputPoints[n][0] = 1.0 + 0.11 * n;
+    inputPoints[n][1] = 14.0 - 0.07 * n;
+  }
+
+  std::vector<PointType> outputPoints(inputPoints.size());
+  regulizer.TransformPointBatch(inputPoints.data(), outputPoints.data(), inputPoints.size());
+
+  for (std::size_t n = 0; n < inputPoints.size(); ++n)
+  {
+    const PointType expectedPoint = regulizer.TransformPoint(inputPoints[n]);
+    for (unsigned int d = 0; d < 2; ++d)
+    {
+      EXPECT_NEAR(outputPoints[n][d], expectedPoint[d], 1e-9);
+    }
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(DeformationFieldRegulizer, TransformPointBatchAddsIntermediaryDeformationField)
+{
+  const auto regulizer = CreateRegulizer();
+
+  /** The intermediary deformation field must make a difference, for the test to be meaningful. */
+  PointType point;
+  point[0] = 5.0;
+  point[1] = 6.0;
+  const PointType combinationPoint = regulizer->CombinationTransformType::TransformPoint(point);
+  EXPECT_GT(regulizer->TransformPoint(point).EuclideanDistanceTo(combinationPoint), 0.1);
+
+  ExpectBatchEqualsTransformPoint(*regulizer);
+}
+
+
+GTEST_TEST(DeformationFieldRegulizer, TransformPointBatchWithInitialTransform)
+{
+  const auto regulizer = CreateRegulizer();
+
+  const auto                               initialTransform = TranslationTransformType::New();
+  TranslationTransformType::ParametersType translation(2);
+  translation[0] = 0.75;
+  translation[1] = -1.25;
+  initialTransform->SetParameters(translation);
+  regulizer->SetInitialTransform(initialTransform);
+
+  regulizer->SetUseComposition(true);
+  ExpectBatchEqualsTransformPoint(*regulizer);
+
+  regulizer->SetUseAddition(true);
+  ExpectBatchEqualsTransformPoint(*regulizer);
+}
@@ -0,0 +1,165 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "GradientDifference/itkGradientDifferenceImageToImageMetric2.h"
+
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include <itkBSplineInterpolateImageFunction.h>
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+using BSplineTransformType = itk::AdvancedBSplineDeformableTransform<double, 2, 3>;
+using InterpolatorType = itk::BSplineInterpolateImageFunction<ImageType, double, double>;
+
+
+// The metric, with access to the subtraction factors, which the analytic derivative considers constant.
+class MetricType : public itk::GradientDifferenceImageToImageMetric<ImageType, ImageType>
+{
+public:
+  using Self = MetricType;
+  using Superclass = itk::GradientDifferenceImageToImageMetric<ImageType, ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro(Self);
+
+  // Retrieves the subtraction factors of the last call to GetValue() or GetValueAndDerivative().
+  void
+  GetSubtractionFactors(MovedGradientPixelType * subtractionFactor) const
+  {
+    this->ComputeSubtractionFactors(subtractionFactor);
+  }
+
+  // Computes the value like GetValue() does without ray casting, but with the specified subtraction factors.
+  MeasureType
+  GetValueForSubtractionFactors(const TransformParametersType & parameters,
+                                const MovedGradientPixelType *  subtractionFactor) const
+  {
+    this->BeforeThreadedGetValueAndDerivative(parameters);
+    this->ComputeMovedValues(false);
+    this->ComputeMovedSobelGradients();
+    return this->ComputeMeasureAndMovedValueDerivatives(subtractionFactor, false);
+  }
+};
+
+
+// Creates a smooth image of the specified size, whose origin is -margin, shifted by the specified offset.
+ImageType::Pointer
+CreateImage(const ImageType::SizeType & size, const double margin, const double offset)
+{
+  ImageType::PointType origin;
+  origin.Fill(-margin);
+
+  const auto image = ImageType::New();
+  image->SetRegions(size);
+  image->SetOrigin(origin);
+  image->Allocate();
+
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    const double x = point[0] + offset;
+    const double y = point[1] - offset;
+    it.Set(static_cast<float>(60.0 + 30.0 * std::sin(0.4 * x) * std::cos(0.3 * y) + 0.5 * x));
+  }
+  return image;
+}
+
+
+// Creates a B-spline transform whose grid covers the fixed image of the test, with a nonzero deformation.
+BSplineTransformType::Pointer
+CreateBSplineTransform(BSplineTransformType::ParametersType & parameters)
+{
+  BSplineTransformType::OriginType origin;
+  origin.Fill(-5.0);
+  BSplineTransformType::SpacingType spacing;
+  spacing.Fill(5.0);
+  BSplineTransformType::RegionType gridRegion;
+  gridRegion.SetSize(BSplineTransformType::SizeType{ { 7, 7 } });
+
+  const auto transform = BSplineTransformType::New();
+  transform->SetGridOrigin(origin);
+  transform->SetGridSpacing(spacing);
+  transform->SetGridRegion(gridRegion);
+  parameters.SetSize(transform->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = 0.5 * std::sin(0.7 * i);
+  }
+  transform->SetParameters(parameters);
+  return transform;
+}
+
+} // namespace
+
+
+// Tests that the analytic derivative, which is used without ray casting, equals the central finite
+// differences of the value with constant subtraction factors. The transform deforms the whole image,
+// including the border pixels, whose Sobel gradients use the clamped neighbors.
+GTEST_TEST(GradientDifferenceImageToImageMetric, AnalyticDerivativeEqualsFiniteDifferences)
+{
+  const auto fixedImage = CreateImage(ImageType::SizeType{ { 20, 18 } }, 0.0, 0.0);
+  const auto movingImage = CreateImage(ImageType::SizeType{ { 28, 26 } }, 4.0, 0.8);
+
+  BSplineTransformType::ParametersType parameters;
+  const auto                           transform = CreateBSplineTransform(parameters);
+
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetSplineOrder(3);
+
+  const auto metric = MetricType::New();
+  metric->SetFixedImage(fixedImage);
+  metric->SetMovingImage(movingImage);
+  metric->SetFixedImageRegion(fixedImage->GetBufferedRegion());
+  metric->SetTransform(transform);
+  metric->SetInterpolator(interpolator);
+  metric->Initialize();
+
+  MetricType::MeasureType    value{};
+  MetricType::DerivativeType derivative;
+  metric->GetValueAndDerivative(parameters, value, derivative);
+  ASSERT_EQ(derivative.GetSize(), parameters.GetSize());
+  EXPECT_DOUBLE_EQ(value, metric->GetValue(parameters));
+
+  MetricType::MovedGradientPixelType subtractionFactor[2];
+  metric->GetSubtractionFactors(subtractionFactor);
+  EXPECT_DOUBLE_EQ(value, metric->GetValueForSubtractionFactors(parameters, subtractionFactor));
+
+  const double maxAbsDerivative = derivative.inf_norm();
+  ASSERT_GT(maxAbsDerivative, 0.0);
+
+  const double                         delta = 1e-3;
+  BSplineTransformType::ParametersType testParameters = parameters;
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    testParameters[i] = parameters[i] - delta;
+    const double valuep0 = metric->GetValueForSubtractionFactors(testParameters, subtractionFactor);
+    testParameters[i] = parameters[i] + delta;
+    const double valuep1 = metric->GetValueForSubtractionFactors(testParameters, subtractionFactor);
+    testParameters[i] = parameters[i];
+
+    EXPECT_NEAR(derivative[i], (valuep1 - valuep0) / (2 * delta), 1e-4 * maxAbsDerivative) << "parameter " << i;
+  }
+}
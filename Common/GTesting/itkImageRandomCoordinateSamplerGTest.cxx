@@ -0,0 +1,105 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkImageRandomCoordinateSampler.h"
+
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkLinearInterpolateImageFunction.h>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+using SamplerType = itk::ImageRandomCoordinateSampler<ImageType>;
+using InterpolatorType = itk::LinearInterpolateImageFunction<ImageType, double>;
+
+
+// Creates an image whose pixel values are a linear function of the index, so that the linearly
+// interpolated value at a point can be computed exactly.
+ImageType::Pointer
+CreateRampImage(void)
+{
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.5;
+  spacing[1] = 0.5;
+
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 9, 8 } });
+  image->SetSpacing(spacing);
+  image->Allocate();
+
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<float>(it.GetIndex()[0] + 10 * it.GetIndex()[1]));
+  }
+  return image;
+}
+
+} // namespace
+
+
+GTEST_TEST(ImageRandomCoordinateSampler, AllocationFreeSamplingGeneratesValidSamples)
+{
+  const auto image = CreateRampImage();
+
+  const auto sampler = SamplerType::New();
+  sampler->SetInput(image);
+  sampler->SetInterpolator(InterpolatorType::New());
+  sampler->SetNumberOfSamples(1000);
+  sampler->SetNumberOfWorkUnits(4);
+  sampler->UseAllocationFreeSamplingOn();
+  sampler->Update();
+
+  const auto & samples = *sampler->GetOutput();
+  ASSERT_EQ(samples.size(), 1000u);
+
+  for (const auto & sample : samples)
+  {
+    itk::ContinuousIndex<double, 2> cindex;
+    ASSERT_TRUE(image->TransformPhysicalPointToContinuousIndex(sample.m_ImageCoordinates, cindex));
+    EXPECT_LE(cindex[0], 8.0 + 1e-9);
+    EXPECT_LE(cindex[1], 7.0 + 1e-9);
+    EXPECT_NEAR(sample.m_ImageValue, cindex[0] + 10.0 * cindex[1], 1e-2);
+  }
+}
+
+
+GTEST_TEST(ImageRandomCoordinateSampler, AllocationFreeSamplingReusesOutputMemory)
+{
+  const auto sampler = SamplerType::New();
+  sampler->SetInput(CreateRampImage());
+  sampler->SetNumberOfSamples(500);
+  sampler->SetNumberOfWorkUnits(3);
+  sampler->SetUseAllocationFreeSampling(true);
+  sampler->Update();
+
+  const auto * const firstSample = sampler->GetOutput()->data();
+  const auto         firstCoordinates = firstSample->m_ImageCoordinates;
+
+  // Select new samples, like NewSamplesEveryIteration does.
+  ASSERT_TRUE(sampler->SelectNewSamplesOnUpdate());
+  sampler->Update();
+
+  EXPECT_EQ(sampler->GetOutput()->size(), 500u);
+  EXPECT_EQ(sampler->GetOutput()->data(), firstSample);
+  EXPECT_NE(sampler->GetOutput()->front().m_ImageCoordinates, firstCoordinates);
+}
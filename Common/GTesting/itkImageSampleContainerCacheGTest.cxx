@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkImageSampleContainerCache.h"
+
+#include "itkImageFullSampler.h"
+#include "itkImageGridSampler.h"
+
+#include <itkImage.h>
+#include <itkImageRegionIterator.h>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+using CacheType = itk::ImageSampleContainerCache<ImageType>;
+using FullSamplerType = itk::ImageFullSampler<ImageType>;
+using GridSamplerType = itk::ImageGridSampler<ImageType>;
+using SampleContainerType = FullSamplerType::ImageSampleContainerType;
+
+
+// Creates an image with a different value for each pixel.
+ImageType::Pointer
+CreateImage(void)
+{
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 7, 6 } });
+  image->Allocate();
+
+  float value = 1.0f;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value += 1.0f;
+  }
+  return image;
+}
+
+
+void
+Expect_equal_samples(const SampleContainerType & actual, const SampleContainerType & expected)
+{
+  ASSERT_EQ(actual.size(), expected.size());
+  for (std::size_t i = 0; i < actual.size(); ++i)
+  {
+    EXPECT_EQ(actual[i].m_ImageCoordinates, expected[i].m_ImageCoordinates);
+    EXPECT_EQ(actual[i].m_ImageValue, expected[i].m_ImageValue);
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(ImageSampleContainerCache, FullAndGridSamplerShareSamples)
+{
+  const auto image = CreateImage();
+  const auto cache = CacheType::New();
+
+  const auto fullSampler = FullSamplerType::New();
+  fullSampler->SetInput(image);
+  fullSampler->SetSampleContainerCache(cache);
+  fullSampler->Update();
+
+  EXPECT_EQ(fullSampler->GetOutput()->size(), image->GetLargestPossibleRegion().GetNumberOfPixels());
+  EXPECT_EQ(cache->GetNumberOfEntries(), 1u);
+  EXPECT_EQ(cache->GetNumberOfHits(), 0u);
+
+  // A grid sampler with unit spacing takes the samples of the full sampler from the cache.
+  GridSamplerType::SampleGridSpacingType unitGridSpacing;
+  unitGridSpacing.Fill(1);
+
+  const auto gridSampler = GridSamplerType::New();
+  gridSampler->SetInput(image);
+  gridSampler->SetSampleGridSpacing(unitGridSpacing);
+  gridSampler->SetSampleContainerCache(cache);
+  gridSampler->Update();
+
+  EXPECT_EQ(cache->GetNumberOfEntries(), 1u);
+  EXPECT_EQ(cache->GetNumberOfHits(), 1u);
+  Expect_equal_samples(*gridSampler->GetOutput(), *fullSampler->GetOutput());
+
+  // The same samples are generated without a cache.
+  const auto gridSamplerWithoutCache = GridSamplerType::New();
+  gridSamplerWithoutCache->SetInput(image);
+  gridSamplerWithoutCache->SetSampleGridSpacing(unitGridSpacing);
+  gridSamplerWithoutCache->Update();
+  Expect_equal_samples(*gridSampler->GetOutput(), *gridSamplerWithoutCache->GetOutput());
+}
+
+
+GTEST_TEST(ImageSampleContainerCache, DistinguishesGridSpacings)
+{
+  const auto image = CreateImage();
+  const auto cache = CacheType::New();
+
+  GridSamplerType::SampleGridSpacingType gridSpacing;
+  gridSpacing.Fill(2);
+
+  const auto gridSampler = GridSamplerType::New();
+  gridSampler->SetInput(image);
+  gridSampler->SetSampleGridSpacing(gridSpacing);
+  gridSampler->SetSampleContainerCache(cache);
+  gridSampler->Update();
+
+  const auto fullSampler = FullSamplerType::New();
+  fullSampler->SetInput(image);
+  fullSampler->SetSampleContainerCache(cache);
+  fullSampler->Update();
+
+  EXPECT_EQ(cache->GetNumberOfEntries(), 2u);
+  EXPECT_EQ(cache->GetNumberOfHits(), 0u);
+  EXPECT_LT(gridSampler->GetOutput()->size(), fullSampler->GetOutput()->size());
+
+  cache->Clear();
+  EXPECT_EQ(cache->GetNumberOfEntries(), 0u);
+}
+
+
+GTEST_TEST(ImageSampleContainerCache, DoesNotReuseSamplesOfModifiedImage)
+{
+  const auto image = CreateImage();
+  const auto cache = CacheType::New();
+
+  const auto fullSampler = FullSamplerType::New();
+  fullSampler->SetInput(image);
+  fullSampler->SetSampleContainerCache(cache);
+  fullSampler->Update();
+
+  image->FillBuffer(42.0f);
+  image->Modified();
+
+  const auto otherFullSampler = FullSamplerType::New();
+  otherFullSampler->SetInput(image);
+  otherFullSampler->SetSampleContainerCache(cache);
+  otherFullSampler->Update();
+
+  // The outdated entry is replaced.
+  EXPECT_EQ(cache->GetNumberOfEntries(), 1u);
+  EXPECT_EQ(cache->GetNumberOfHits(), 0u);
+
+  for (const auto & sample : *otherFullSampler->GetOutput())
+  {
+    EXPECT_EQ(sample.m_ImageValue, 42.0f);
+  }
+}
@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkMemoryMappedImageFileReader.h"
+
+#include <itkImage.h>
+#include <itkImageFileWriter.h>
+#include <itkImageRegionConstIterator.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+using ReaderType = itk::MemoryMappedImageFileReader<ImageType>;
+
+
+// Creates a 7 x 6 x 5 image with a different value for each pixel.
+ImageType::Pointer
+CreateImage()
+{
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 7, 6, 5 } });
+  image->Allocate();
+  short * buffer = image->GetBufferPointer();
+  for (itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i)
+  {
+    buffer[i] = static_cast<short>(3 * static_cast<int>(i) - 100);
+  }
+  return image;
+}
+
+
+// Writes the image, and checks that it is read back equal, memory mapped or not.
+void
+Expect_equal_after_write_and_read(const std::string & fileName, bool useCompression, bool expectMemoryMapped)
+{
+  const auto image = CreateImage();
+  const auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetUseCompression(useCompression);
+  writer->Update();
+
+  const auto reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+  EXPECT_EQ(reader->GetImageIsMemoryMapped(), expectMemoryMapped);
+
+  const ImageType * output = reader->GetOutput();
+  ASSERT_EQ(output->GetBufferedRegion(), image->GetBufferedRegion());
+  itk::ImageRegionConstIterator<ImageType> expectedIt(image, image->GetBufferedRegion());
+  itk::ImageRegionConstIterator<ImageType> it(output, output->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it, ++expectedIt)
+  {
+    EXPECT_EQ(it.Get(), expectedIt.Get());
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(MemoryMappedImageFileReader, MapsUncompressedMetaImage)
+{
+  Expect_equal_after_write_and_read("MemoryMappedImageFileReaderGTest.mha", false, true);
+}
+
+
+GTEST_TEST(MemoryMappedImageFileReader, MapsUncompressedMetaImageWithRawDataFile)
+{
+  Expect_equal_after_write_and_read("MemoryMappedImageFileReaderGTest.mhd", false, true);
+}
+
+
+GTEST_TEST(MemoryMappedImageFileReader, ReadsCompressedMetaImage)
+{
+  Expect_equal_after_write_and_read("MemoryMappedImageFileReaderGTest_compressed.mha", true, false);
+}
+
+
+GTEST_TEST(MemoryMappedImageFileReader, WritingToMappedImageDoesNotChangeFile)
+{
+  const std::string fileName = "MemoryMappedImageFileReaderGTest_write.mha";
+  Expect_equal_after_write_and_read(fileName, false, true);
+
+  const auto reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+  reader->GetOutput()->GetBufferPointer()[0] = 12345;
+
+  const auto secondReader = ReaderType::New();
+  secondReader->SetFileName(fileName);
+  secondReader->Update();
+  EXPECT_EQ(secondReader->GetOutput()->GetBufferPointer()[0], -100);
+}
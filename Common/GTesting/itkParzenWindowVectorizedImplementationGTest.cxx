@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkParzenWindowVectorizedImplementation.h"
+
+#include "itkBSplineKernelFunction2.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+using ImplementationType = itk::ParzenWindowVectorizedImplementation;
+
+} // namespace
+
+
+GTEST_TEST(ParzenWindowVectorizedImplementation, CubicBSplineWeightsEqualKernelFunction)
+{
+  const auto kernel = itk::BSplineKernelFunction2<3>::New();
+
+  for (unsigned int i = 0; i <= 100; ++i)
+  {
+    /** The Parzen window arguments of the histogram metric lie in [-2, -1]. */
+    const double u = -2.0 + 0.01 * i;
+
+    double expectedWeights[4];
+    double scalarWeights[4];
+    double weights[4];
+    kernel->Evaluate(u, expectedWeights);
+    ImplementationType::EvaluateCubicBSplineWeights(u, scalarWeights, ImplementationType::Scalar);
+    ImplementationType::EvaluateCubicBSplineWeights(u, weights, ImplementationType::GetInstructionSet());
+
+    for (unsigned int k = 0; k < 4; ++k)
+    {
+      EXPECT_DOUBLE_EQ(scalarWeights[k], expectedWeights[k]);
+      EXPECT_DOUBLE_EQ(weights[k], expectedWeights[k]);
+    }
+  }
+}
+
+
+GTEST_TEST(ParzenWindowVectorizedImplementation, AddOuterProductEqualsScalarImplementation)
+{
+  const itk::OffsetValueType rowStride = 7;
+  const double               fixedValues[4] = { 0.1, 0.45, 0.35, 0.1 };
+  const double               movingValues[4] = { 1.0 / 6.0, 2.0 / 3.0, 1.0 / 6.0, 0.0 };
+
+  for (unsigned int numberOfFixedValues = 1; numberOfFixedValues <= 4; ++numberOfFixedValues)
+  {
+    for (unsigned int numberOfMovingValues = 1; numberOfMovingValues <= 4; ++numberOfMovingValues)
+    {
+      std::vector<double> expectedHistogram(5 * rowStride, 0.5);
+      std::vector<double> histogram(expectedHistogram);
+
+      for (unsigned int f = 0; f < numberOfFixedValues; ++f)
+      {
+        for (unsigned int m = 0; m < numberOfMovingValues; ++m)
+        {
+          expectedHistogram[(f + 1) * rowStride + m + 2] += fixedValues[f] * movingValues[m];
+        }
+      }
+      ImplementationType::AddOuterProduct(&histogram[rowStride + 2],
+                                          rowStride,
+                                          fixedValues,
+                                          numberOfFixedValues,
+                                          movingValues,
+                                          numberOfMovingValues,
+                                          ImplementationType::GetInstructionSet());
+      for (std::size_t i = 0; i < histogram.size(); ++i)
+      {
+        EXPECT_DOUBLE_EQ(histogram[i], expectedHistogram[i]);
+      }
+    }
+  }
+}
+
+
+GTEST_TEST(ParzenWindowVectorizedImplementation, AddHistograms)
+{
+  for (itk::SizeValueType size = 0; size < 11; ++size)
+  {
+    std::vector<double> input0(size);
+    std::vector<double> input1(size);
+    std::vector<double> expectedOutput(size);
+    for (itk::SizeValueType i = 0; i < size; ++i)
+    {
+      input0[i] = std::sin(0.3 * i);
+      input1[i] = std::cos(0.7 * i);
+      expectedOutput[i] = input0[i] + input1[i];
+    }
+
+    /** The output may be one of the inputs. */
+    ImplementationType::AddHistograms(
+      input0.data(), input0.data(), input1.data(), size, ImplementationType::GetInstructionSet());
+    EXPECT_EQ(input0, expectedOutput);
+  }
+}
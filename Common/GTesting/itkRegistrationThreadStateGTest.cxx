@@ -0,0 +1,112 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+// First include the header file to be tested:
+#include "itkRegistrationThreadState.h"
+
+#include <itkMultiThreaderBase.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+using StateType = itk::RegistrationThreadState;
+
+
+// Draws a sequence of random numbers, after seeding the generator of the calling thread.
+std::vector<double>
+DrawRandomSequence(const unsigned int seed)
+{
+  const auto randomGenerator = StateType::GetRandomGenerator();
+  randomGenerator->SetSeed(seed);
+
+  std::vector<double> sequence(100);
+  for (double & value : sequence)
+  {
+    value = randomGenerator->GetVariate();
+  }
+  return sequence;
+}
+
+} // namespace
+
+
+GTEST_TEST(RegistrationThreadState, RandomGeneratorIsSamePerThread)
+{
+  EXPECT_EQ(StateType::GetRandomGenerator(), StateType::GetRandomGenerator());
+
+  StateType::RandomGeneratorType * otherRandomGenerator = nullptr;
+  std::thread([&otherRandomGenerator] { otherRandomGenerator = StateType::GetRandomGenerator(); }).join();
+  EXPECT_NE(otherRandomGenerator, StateType::GetRandomGenerator().GetPointer());
+}
+
+
+GTEST_TEST(RegistrationThreadState, ConcurrentRandomSequencesDependOnSeedOnly)
+{
+  const auto expectedSequence = DrawRandomSequence(121212);
+
+  std::vector<std::vector<double>> sequences(4);
+  std::vector<std::thread>         threads;
+  for (auto & sequence : sequences)
+  {
+    threads.emplace_back([&sequence] {
+      for (unsigned int i = 0; i < 10; ++i)
+      {
+        sequence = DrawRandomSequence(121212);
+      }
+    });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  for (const auto & sequence : sequences)
+  {
+    EXPECT_EQ(sequence, expectedSequence);
+  }
+}
+
+
+GTEST_TEST(RegistrationThreadState, MaximumNumberOfThreadsIsPerThread)
+{
+  const itk::ThreadIdType defaultNumberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+
+  StateType::SetMaximumNumberOfThreads(0);
+  EXPECT_EQ(StateType::GetNumberOfThreads(), defaultNumberOfThreads);
+
+  StateType::SetMaximumNumberOfThreads(1);
+  EXPECT_EQ(StateType::GetMaximumNumberOfThreads(), 1U);
+  EXPECT_EQ(StateType::GetNumberOfThreads(), 1U);
+
+  itk::ThreadIdType otherMaximumNumberOfThreads = 1;
+  itk::ThreadIdType otherNumberOfThreads = 0;
+  std::thread([&otherMaximumNumberOfThreads, &otherNumberOfThreads] {
+    otherMaximumNumberOfThreads = StateType::GetMaximumNumberOfThreads();
+    otherNumberOfThreads = StateType::GetNumberOfThreads();
+  }).join();
+  EXPECT_EQ(otherMaximumNumberOfThreads, 0U);
+  EXPECT_EQ(otherNumberOfThreads, defaultNumberOfThreads);
+
+  StateType::SetMaximumNumberOfThreads(defaultNumberOfThreads + 1);
+  EXPECT_EQ(StateType::GetNumberOfThreads(), defaultNumberOfThreads);
+
+  StateType::SetMaximumNumberOfThreads(0);
+}
@@ -0,0 +1,164 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkSharedImageCache.h"
+
+#include <itkImage.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+using CacheType = itk::SharedImageCache;
+
+
+ImageType::Pointer
+CreateImage()
+{
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 4, 3 } });
+  image->Allocate(true);
+  return image;
+}
+
+
+// Gets a product of the image from the cache, created as a new image, and counts the number of creations.
+ImageType::Pointer
+GetOrCreateProduct(const ImageType::Pointer & image, const std::string & settings, std::atomic<int> & numberOfCalls)
+{
+  return CacheType::GetOrCreate<ImageType>(image.GetPointer(), settings, [&numberOfCalls]() {
+    ++numberOfCalls;
+    return CreateImage();
+  });
+}
+
+} // namespace
+
+
+GTEST_TEST(SharedImageCache, SharesProductOfSameImageAndSettings)
+{
+  CacheType::Clear();
+  const auto       image = CreateImage();
+  std::atomic<int> numberOfCalls(0);
+
+  const auto product1 = GetOrCreateProduct(image, "a", numberOfCalls);
+  const auto product2 = GetOrCreateProduct(image, "a", numberOfCalls);
+  EXPECT_EQ(product1, product2);
+  EXPECT_EQ(numberOfCalls.load(), 1);
+
+  const auto product3 = GetOrCreateProduct(image, "b", numberOfCalls);
+  EXPECT_NE(product1, product3);
+  EXPECT_EQ(numberOfCalls.load(), 2);
+  EXPECT_EQ(CacheType::GetNumberOfProducts(), 2u);
+}
+
+
+GTEST_TEST(SharedImageCache, DistinguishesGeometryOfSameBuffer)
+{
+  CacheType::Clear();
+  const auto       image = CreateImage();
+  std::atomic<int> numberOfCalls(0);
+
+  // Another image with the same pixel buffer, but another spacing.
+  const auto otherImage = ImageType::New();
+  otherImage->Graft(image);
+  ImageType::SpacingType spacing;
+  spacing.Fill(2.0);
+  otherImage->SetSpacing(spacing);
+  ASSERT_EQ(otherImage->GetPixelContainer(), image->GetPixelContainer());
+
+  const auto product1 = GetOrCreateProduct(image, "a", numberOfCalls);
+  const auto product2 = GetOrCreateProduct(otherImage, "a", numberOfCalls);
+  EXPECT_NE(product1, product2);
+  EXPECT_EQ(numberOfCalls.load(), 2);
+}
+
+
+GTEST_TEST(SharedImageCache, RemovesProductsOfReleasedImage)
+{
+  CacheType::Clear();
+  std::atomic<int> numberOfCalls(0);
+  auto             image = CreateImage();
+
+  const auto product = GetOrCreateProduct(image, "a", numberOfCalls);
+  EXPECT_EQ(CacheType::GetNumberOfProducts(), 1u);
+
+  image = nullptr;
+  EXPECT_EQ(CacheType::GetNumberOfProducts(), 0u);
+
+  // The product itself remains valid for its users.
+  EXPECT_EQ(product->GetReferenceCount(), 1);
+}
+
+
+GTEST_TEST(SharedImageCache, CreatesProductOnceForConcurrentRequests)
+{
+  CacheType::Clear();
+  const auto       image = CreateImage();
+  std::atomic<int> numberOfCalls(0);
+
+  const auto create = [&numberOfCalls]() {
+    ++numberOfCalls;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return CreateImage();
+  };
+
+  std::vector<ImageType::Pointer> products(8);
+  std::vector<std::thread>        threads;
+  for (std::size_t i = 0; i < products.size(); ++i)
+  {
+    threads.emplace_back([&products, &image, &create, i]() {
+      products[i] = CacheType::GetOrCreate<ImageType>(image.GetPointer(), "a", create);
+    });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ(numberOfCalls.load(), 1);
+  for (const auto & product : products)
+  {
+    EXPECT_EQ(product, products.front());
+  }
+}
+
+
+GTEST_TEST(SharedImageCache, DoesNotCacheFailure)
+{
+  CacheType::Clear();
+  const auto       image = CreateImage();
+  std::atomic<int> numberOfCalls(0);
+
+  const auto fail = []() -> ImageType::Pointer { throw std::runtime_error("failure"); };
+  EXPECT_THROW(CacheType::GetOrCreate<ImageType>(image.GetPointer(), "a", fail), std::runtime_error);
+  EXPECT_EQ(CacheType::GetNumberOfProducts(), 0u);
+
+  const auto product = GetOrCreateProduct(image, "a", numberOfCalls);
+  EXPECT_NE(product.GetPointer(), nullptr);
+  EXPECT_EQ(numberOfCalls.load(), 1);
+}
@@ -0,0 +1,137 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+// First include the header file to be tested:
+#include "itkTimingProfile.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using ProfileType = itk::TimingProfile;
+} // namespace
+
+
+GTEST_TEST(TimingProfile, AddsTimesOfAllThreads)
+{
+  const auto profile = ProfileType::New();
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&profile] {
+      for (unsigned int j = 0; j < 1000; ++j)
+      {
+        profile->AddTime(ProfileType::Jacobian, 0.5, 0.0);
+      }
+      profile->AddTime(ProfileType::OptimizerStep, 1.0, 0.25);
+    });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  const ProfileType::PhaseTimeType jacobianTime = profile->GetPhaseTime(ProfileType::Jacobian);
+  EXPECT_EQ(jacobianTime.WallTime, 2000.0);
+  EXPECT_EQ(jacobianTime.NumberOfCalls, 4000U);
+
+  const ProfileType::PhaseTimeType stepTime = profile->GetPhaseTime(ProfileType::OptimizerStep);
+  EXPECT_EQ(stepTime.WallTime, 4.0);
+  EXPECT_EQ(stepTime.CPUTime, 1.0);
+  EXPECT_EQ(stepTime.NumberOfCalls, 4U);
+
+  EXPECT_EQ(profile->GetPhaseTime(ProfileType::Sampling).NumberOfCalls, 0U);
+
+  profile->Reset();
+  EXPECT_EQ(profile->GetPhaseTime(ProfileType::Jacobian).NumberOfCalls, 0U);
+  EXPECT_EQ(profile->GetPhaseTime(ProfileType::OptimizerStep).WallTime, 0.0);
+}
+
+
+GTEST_TEST(TimingProfile, KeepsProfilesApart)
+{
+  const auto profile1 = ProfileType::New();
+  const auto profile2 = ProfileType::New();
+
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    profile1->AddTime(ProfileType::Sampling, 1.0, 1.0);
+    profile2->AddTime(ProfileType::Sampling, 2.0, 2.0);
+  }
+
+  EXPECT_EQ(profile1->GetPhaseTime(ProfileType::Sampling).WallTime, 10.0);
+  EXPECT_EQ(profile2->GetPhaseTime(ProfileType::Sampling).WallTime, 20.0);
+}
+
+
+// A thread forgets the times of the profiles that are destroyed, while it keeps using a profile that lives longer,
+// like a pool thread of a long running process does.
+GTEST_TEST(TimingProfile, KeepsTimesWhileOtherProfilesComeAndGo)
+{
+  const auto longLivedProfile = ProfileType::New();
+
+  std::thread thread([&longLivedProfile] {
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+      longLivedProfile->AddTime(ProfileType::Sampling, 1.0, 0.0);
+
+      const auto profile = ProfileType::New();
+      profile->AddTime(ProfileType::Sampling, 2.0, 0.0);
+      profile->AddTime(ProfileType::Sampling, 2.0, 0.0);
+      EXPECT_EQ(profile->GetPhaseTime(ProfileType::Sampling).WallTime, 4.0);
+    }
+  });
+  thread.join();
+
+  const ProfileType::PhaseTimeType phaseTime = longLivedProfile->GetPhaseTime(ProfileType::Sampling);
+  EXPECT_EQ(phaseTime.WallTime, 100.0);
+  EXPECT_EQ(phaseTime.NumberOfCalls, 100U);
+}
+
+
+GTEST_TEST(TimingProfile, ScopedTimerDoesNothingWithoutProfile)
+{
+  const auto profile = ProfileType::New();
+  {
+    const ProfileType::ScopedTimer timer(profile, ProfileType::StepSizeEstimation);
+    const ProfileType::ScopedTimer nullTimer(nullptr, ProfileType::StepSizeEstimation);
+  }
+  const ProfileType::PhaseTimeType phaseTime = profile->GetPhaseTime(ProfileType::StepSizeEstimation);
+  EXPECT_EQ(phaseTime.NumberOfCalls, 1U);
+  EXPECT_GE(phaseTime.WallTime, 0.0);
+  EXPECT_GE(phaseTime.CPUTime, 0.0);
+}
+
+
+GTEST_TEST(TimingProfile, WritesCalledPhasesAsJSON)
+{
+  const auto profile = ProfileType::New();
+  profile->AddTime(ProfileType::TransformPoint, 0.5, 0.0);
+  profile->AddTime(ProfileType::DerivativeAccumulation, 0.25, 0.125);
+
+  std::ostringstream json;
+  profile->WriteJSON(json);
+  EXPECT_EQ(json.str(),
+            "{\"TransformPoint\": { \"WallTime\": 0.5, \"NumberOfCalls\": 1 }, "
+            "\"DerivativeAccumulation\": { \"WallTime\": 0.25, \"CPUTime\": 0.125, \"NumberOfCalls\": 1 }}");
+}
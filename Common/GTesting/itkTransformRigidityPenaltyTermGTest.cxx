@@ -0,0 +1,275 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "RigidityPenalty/itkTransformRigidityPenaltyTerm.h"
+
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include <itkBSplineInterpolateImageFunction.h>
+#include <itkImage.h>
+#include <itkImageRegionIterator.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace
+{
+/** The conditions of the rigidity penalty that are used by a test. */
+struct Conditions
+{
+  bool linearity;
+  bool orthonormality;
+  bool properness;
+};
+
+
+template <unsigned int VDimension>
+struct RigidityPenaltyTestTypes
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using MetricType = itk::TransformRigidityPenaltyTerm<ImageType, double>;
+  using BSplineTransformType = itk::AdvancedBSplineDeformableTransform<double, VDimension, 3>;
+  using ParametersType = typename BSplineTransformType::ParametersType;
+  using RigidityImageType = typename MetricType::RigidityImageType;
+};
+
+
+// Creates a B-spline transform whose grid has the specified size, with a nonzero deformation.
+template <unsigned int VDimension>
+typename RigidityPenaltyTestTypes<VDimension>::BSplineTransformType::Pointer
+CreateBSplineTransform(const itk::Size<VDimension> &                                gridSize,
+                       typename RigidityPenaltyTestTypes<VDimension>::ParametersType & parameters)
+{
+  using BSplineTransformType = typename RigidityPenaltyTestTypes<VDimension>::BSplineTransformType;
+
+  typename BSplineTransformType::OriginType origin;
+  origin.Fill(-5.0);
+  typename BSplineTransformType::SpacingType spacing;
+  spacing.Fill(5.0);
+  typename BSplineTransformType::RegionType gridRegion;
+  gridRegion.SetSize(gridSize);
+
+  const auto transform = BSplineTransformType::New();
+  transform->SetGridOrigin(origin);
+  transform->SetGridSpacing(spacing);
+  transform->SetGridRegion(gridRegion);
+  parameters.SetSize(transform->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = 0.5 * std::sin(0.7 * i);
+  }
+  transform->SetParameters(parameters);
+  return transform;
+}
+
+
+// Creates a rigidity penalty for the specified transform, with rigidity coefficients that vary over the B-spline
+// grid, computed with the specified number of work units.
+template <unsigned int VDimension>
+typename RigidityPenaltyTestTypes<VDimension>::MetricType::Pointer
+CreateRigidityPenalty(typename RigidityPenaltyTestTypes<VDimension>::BSplineTransformType & transform,
+                      const Conditions &                                                  conditions,
+                      const itk::ThreadIdType                                             numberOfWorkUnits)
+{
+  using Types = RigidityPenaltyTestTypes<VDimension>;
+  using ImageType = typename Types::ImageType;
+  using RigidityImageType = typename Types::RigidityImageType;
+
+  /** The penalty does not look at the images, but its initialization needs them. */
+  itk::Size<VDimension> imageSize;
+  imageSize.Fill(10);
+  const auto image = ImageType::New();
+  image->SetRegions(imageSize);
+  image->Allocate(true);
+
+  /** The rigidity image coincides with the B-spline grid, so each control point has its own coefficient. */
+  const auto rigidityImage = RigidityImageType::New();
+  rigidityImage->SetRegions(transform.GetGridRegion());
+  rigidityImage->SetOrigin(transform.GetGridOrigin());
+  rigidityImage->SetSpacing(transform.GetGridSpacing());
+  rigidityImage->SetDirection(transform.GetGridDirection());
+  rigidityImage->Allocate();
+  unsigned int n = 0;
+  for (itk::ImageRegionIterator<RigidityImageType> it(rigidityImage, rigidityImage->GetBufferedRegion());
+       !it.IsAtEnd();
+       ++it, ++n)
+  {
+    it.Set(0.6 + 0.4 * std::sin(0.9 * n));
+  }
+
+  const auto metric = Types::MetricType::New();
+  metric->SetFixedImage(image);
+  metric->SetMovingImage(image);
+  metric->SetFixedImageRegion(image->GetBufferedRegion());
+  metric->SetTransform(&transform);
+  metric->SetInterpolator(itk::BSplineInterpolateImageFunction<ImageType, double, double>::New());
+  metric->SetUseLinearityCondition(conditions.linearity);
+  metric->SetCalculateLinearityCondition(conditions.linearity);
+  metric->SetUseOrthonormalityCondition(conditions.orthonormality);
+  metric->SetCalculateOrthonormalityCondition(conditions.orthonormality);
+  metric->SetUsePropernessCondition(conditions.properness);
+  metric->SetCalculatePropernessCondition(conditions.properness);
+  metric->SetFixedRigidityImage(rigidityImage);
+  metric->SetUseFixedRigidityImage(true);
+  metric->SetUseMovingRigidityImage(false);
+  metric->SetDilateRigidityImages(false);
+  metric->SetNumberOfWorkUnits(numberOfWorkUnits);
+  metric->Initialize();
+  return metric;
+}
+
+
+// Expects that the derivative equals the central finite differences of the value, for the control points that are
+// not on the border of the B-spline grid. At the border, the nearest neighbor boundary handling of the filters
+// makes the derivative an approximation, both before and after the filters were fused.
+template <unsigned int VDimension>
+void
+ExpectDerivativeEqualsFiniteDifferences(const itk::Size<VDimension> & gridSize, const Conditions & conditions)
+{
+  using Types = RigidityPenaltyTestTypes<VDimension>;
+
+  typename Types::ParametersType parameters;
+  const auto                     transform = CreateBSplineTransform(gridSize, parameters);
+  const auto                     metric = CreateRigidityPenalty<VDimension>(*transform, conditions, 3);
+
+  typename Types::MetricType::MeasureType    value{};
+  typename Types::MetricType::DerivativeType derivative;
+  metric->GetValueAndDerivative(parameters, value, derivative);
+  ASSERT_EQ(derivative.GetSize(), parameters.GetSize());
+  EXPECT_NEAR(value, metric->GetValue(parameters), 1e-12 * std::abs(value));
+
+  const double maxAbsDerivative = derivative.inf_norm();
+  ASSERT_GT(maxAbsDerivative, 0.0);
+
+  const itk::SizeValueType       numberOfControlPoints = transform->GetGridRegion().GetNumberOfPixels();
+  const double                   delta = 1e-4;
+  typename Types::ParametersType testParameters = parameters;
+  unsigned int                   numberOfComparedParameters = 0;
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    /** Skip the control points on the border of the grid. */
+    itk::SizeValueType remainder = i % numberOfControlPoints;
+    bool               isOnBorder = false;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      const itk::SizeValueType x = remainder % gridSize[d];
+      remainder /= gridSize[d];
+      isOnBorder = isOnBorder || x == 0 || x + 1 == gridSize[d];
+    }
+    if (isOnBorder)
+    {
+      continue;
+    }
+
+    testParameters[i] = parameters[i] - delta;
+    const double valuep0 = metric->GetValue(testParameters);
+    testParameters[i] = parameters[i] + delta;
+    const double valuep1 = metric->GetValue(testParameters);
+    testParameters[i] = parameters[i];
+
+    EXPECT_NEAR(derivative[i], (valuep1 - valuep0) / (2 * delta), 1e-5 * maxAbsDerivative) << "parameter " << i;
+    ++numberOfComparedParameters;
+  }
+  EXPECT_GT(numberOfComparedParameters, 0U);
+}
+
+
+// Expects that the value and the derivative do not depend on the number of work units, which determines how the
+// B-spline grid is split in slabs.
+template <unsigned int VDimension>
+void
+ExpectResultIndependentOfNumberOfWorkUnits(const itk::Size<VDimension> & gridSize, const Conditions & conditions)
+{
+  using Types = RigidityPenaltyTestTypes<VDimension>;
+
+  typename Types::ParametersType parameters;
+  const auto                     transform = CreateBSplineTransform(gridSize, parameters);
+
+  typename Types::MetricType::MeasureType    expectedValue{};
+  typename Types::MetricType::DerivativeType expectedDerivative;
+  CreateRigidityPenalty<VDimension>(*transform, conditions, 1)
+    ->GetValueAndDerivative(parameters, expectedValue, expectedDerivative);
+  ASSERT_GT(expectedDerivative.inf_norm(), 0.0);
+
+  for (const itk::ThreadIdType numberOfWorkUnits : { 2, 3, 5 })
+  {
+    const auto metric = CreateRigidityPenalty<VDimension>(*transform, conditions, numberOfWorkUnits);
+
+    typename Types::MetricType::MeasureType    value{};
+    typename Types::MetricType::DerivativeType derivative;
+    metric->GetValueAndDerivative(parameters, value, derivative);
+    EXPECT_NEAR(value, expectedValue, 1e-12 * std::abs(expectedValue)) << numberOfWorkUnits << " work units";
+    EXPECT_NEAR(metric->GetValue(parameters), expectedValue, 1e-12 * std::abs(expectedValue))
+      << numberOfWorkUnits << " work units";
+
+    /** The slabs only change the order of summation, so the results may differ in the last bits. */
+    ASSERT_EQ(derivative.GetSize(), expectedDerivative.GetSize());
+    for (unsigned int i = 0; i < derivative.GetSize(); ++i)
+    {
+      EXPECT_NEAR(derivative[i], expectedDerivative[i], 1e-12 * expectedDerivative.inf_norm()) << "parameter " << i;
+    }
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(TransformRigidityPenaltyTerm, LinearityDerivativeEqualsFiniteDifferences2D)
+{
+  ExpectDerivativeEqualsFiniteDifferences(itk::Size<2>{ { 8, 7 } }, Conditions{ true, false, false });
+}
+
+
+GTEST_TEST(TransformRigidityPenaltyTerm, OrthonormalityDerivativeEqualsFiniteDifferences2D)
+{
+  ExpectDerivativeEqualsFiniteDifferences(itk::Size<2>{ { 8, 7 } }, Conditions{ false, true, false });
+}
+
+
+GTEST_TEST(TransformRigidityPenaltyTerm, PropernessDerivativeEqualsFiniteDifferences2D)
+{
+  ExpectDerivativeEqualsFiniteDifferences(itk::Size<2>{ { 8, 7 } }, Conditions{ false, false, true });
+}
+
+
+GTEST_TEST(TransformRigidityPenaltyTerm, DerivativeEqualsFiniteDifferences2D)
+{
+  ExpectDerivativeEqualsFiniteDifferences(itk::Size<2>{ { 8, 7 } }, Conditions{ true, true, true });
+}
+
+
+// In 3D, only the linearity condition is compared with finite differences: the 3D subparts of the orthonormality
+// and properness conditions (mu1 part 2 and mu2 part 3 of the orthonormality, mu3 parts 1 and 3 of the properness)
+// are not the exact partial derivatives of their values. These expressions predate the threaded implementation.
+GTEST_TEST(TransformRigidityPenaltyTerm, LinearityDerivativeEqualsFiniteDifferences3D)
+{
+  ExpectDerivativeEqualsFiniteDifferences(itk::Size<3>{ { 6, 5, 7 } }, Conditions{ true, false, false });
+}
+
+
+GTEST_TEST(TransformRigidityPenaltyTerm, ResultIndependentOfNumberOfWorkUnits2D)
+{
+  ExpectResultIndependentOfNumberOfWorkUnits(itk::Size<2>{ { 8, 7 } }, Conditions{ true, true, true });
+}
+
+
+GTEST_TEST(TransformRigidityPenaltyTerm, ResultIndependentOfNumberOfWorkUnits3D)
+{
+  ExpectResultIndependentOfNumberOfWorkUnits(itk::Size<3>{ { 6, 5, 7 } }, Conditions{ true, true, true });
+}
@@ -0,0 +1,189 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkWorkStealingThreadPool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using itk::WorkStealingThreadPool;
+using itk::WorkStealingChunkScheduler;
+
+namespace
+{
+using ThreadIdType = itk::ThreadIdType;
+using SizeValueType = itk::SizeValueType;
+
+
+// Executes a loop over the range [0, size), using the scheduler, and checks that each index is visited once.
+void
+Expect_each_index_visited_once(const ThreadIdType  numberOfWorkUnits,
+                               const SizeValueType size,
+                               const SizeValueType chunkSize)
+{
+  WorkStealingChunkScheduler scheduler;
+  scheduler.Initialize(numberOfWorkUnits, size, chunkSize);
+
+  std::vector<std::atomic<unsigned int>> visits(size);
+  for (auto & visit : visits)
+  {
+    visit = 0;
+  }
+
+  WorkStealingThreadPool::GetInstance()->Execute(numberOfWorkUnits, [&scheduler, &visits](ThreadIdType workUnitID) {
+    SizeValueType begin, end;
+    while (scheduler.GetNextChunk(workUnitID, begin, end))
+    {
+      EXPECT_LT(begin, end);
+      EXPECT_LE(end - begin, scheduler.GetChunkSize());
+      for (SizeValueType i = begin; i < end; ++i)
+      {
+        ++visits[i];
+      }
+    }
+  });
+
+  for (const auto & visit : visits)
+  {
+    ASSERT_EQ(visit.load(), 1u);
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(WorkStealingThreadPool, ExecutesEachWorkUnitOnce)
+{
+  const auto pool = WorkStealingThreadPool::GetInstance();
+  ASSERT_NE(pool, nullptr);
+  EXPECT_EQ(pool, WorkStealingThreadPool::GetInstance());
+
+  for (ThreadIdType numberOfWorkUnits = 1; numberOfWorkUnits <= 9; ++numberOfWorkUnits)
+  {
+    std::vector<std::atomic<unsigned int>> calls(numberOfWorkUnits);
+    for (auto & call : calls)
+    {
+      call = 0;
+    }
+
+    // Repeated calls reuse the threads of the pool.
+    for (unsigned int repetition = 0; repetition < 10; ++repetition)
+    {
+      pool->Execute(numberOfWorkUnits, [&calls](ThreadIdType workUnitID) { ++calls[workUnitID]; });
+    }
+
+    for (const auto & call : calls)
+    {
+      EXPECT_EQ(call.load(), 10u);
+    }
+    EXPECT_GE(pool->GetNumberOfThreads(), numberOfWorkUnits - 1);
+  }
+}
+
+
+GTEST_TEST(WorkStealingThreadPool, SupportsNestedExecute)
+{
+  const auto       pool = WorkStealingThreadPool::GetInstance();
+  std::atomic<int> sum(0);
+
+  pool->Execute(4, [pool, &sum](ThreadIdType) {
+    pool->Execute(3, [&sum](ThreadIdType workUnitID) { sum += static_cast<int>(workUnitID) + 1; });
+  });
+
+  EXPECT_EQ(sum.load(), 4 * (1 + 2 + 3));
+}
+
+
+GTEST_TEST(WorkStealingThreadPool, PassesExceptionToCaller)
+{
+  const auto       pool = WorkStealingThreadPool::GetInstance();
+  std::atomic<int> numberOfCalls(0);
+
+  EXPECT_THROW(pool->Execute(4,
+                             [&numberOfCalls](ThreadIdType workUnitID) {
+                               ++numberOfCalls;
+                               if (workUnitID == 2)
+                               {
+                                 throw std::runtime_error("Exception from work unit 2");
+                               }
+                             }),
+               std::runtime_error);
+
+  // All work units are still executed.
+  EXPECT_EQ(numberOfCalls.load(), 4);
+}
+
+
+GTEST_TEST(WorkStealingChunkScheduler, VisitsEachIndexOnce)
+{
+  for (const ThreadIdType numberOfWorkUnits : { 1u, 2u, 3u, 8u })
+  {
+    for (const SizeValueType size : { 0ul, 1ul, 7ul, 1000ul, 12345ul })
+    {
+      for (const SizeValueType chunkSize : { 0ul, 1ul, 5ul, 100000ul })
+      {
+        Expect_each_index_visited_once(numberOfWorkUnits, size, chunkSize);
+      }
+    }
+  }
+}
+
+
+GTEST_TEST(WorkStealingChunkScheduler, StealsFromOtherWorkUnits)
+{
+  WorkStealingChunkScheduler scheduler;
+  scheduler.Initialize(4, 100, 10);
+  EXPECT_EQ(scheduler.GetChunkSize(), 10u);
+
+  // A single work unit processes the whole range: first its own part from the front,
+  // then the parts of the other work units from the back.
+  SizeValueType begin, end;
+  SizeValueType numberOfIndices = 0;
+
+  ASSERT_TRUE(scheduler.GetNextChunk(0, begin, end));
+  EXPECT_EQ(begin, 0u);
+  EXPECT_EQ(end, 10u);
+  numberOfIndices += end - begin;
+
+  ASSERT_TRUE(scheduler.GetNextChunk(0, begin, end));
+  EXPECT_EQ(begin, 10u);
+  EXPECT_EQ(end, 20u);
+  numberOfIndices += end - begin;
+
+  ASSERT_TRUE(scheduler.GetNextChunk(0, begin, end));
+  EXPECT_EQ(begin, 20u);
+  EXPECT_EQ(end, 25u);
+  numberOfIndices += end - begin;
+
+  ASSERT_TRUE(scheduler.GetNextChunk(0, begin, end));
+  EXPECT_EQ(begin, 40u);
+  EXPECT_EQ(end, 50u);
+  numberOfIndices += end - begin;
+
+  while (scheduler.GetNextChunk(0, begin, end))
+  {
+    numberOfIndices += end - begin;
+  }
+  EXPECT_EQ(numberOfIndices, 100u);
+  EXPECT_FALSE(scheduler.GetNextChunk(1, begin, end));
+}
@@ -67,8 +67,9 @@ public:
   itkStaticConstMacro(InputImageDimension, unsigned int, Superclass::InputImageDimension);
 
   /** Other typdefs. */
-  typedef typename InputImageType::IndexType InputImageIndexType;
-  typedef typename InputImageType::PointType InputImagePointType;
+  typedef typename InputImageType::IndexType  InputImageIndexType;
+  typedef typename InputImageType::PointType  InputImagePointType;
+  typedef typename InputImageType::OffsetType SampleGridSpacingType;
 
   /** Selecting new samples makes no sense if nothing changed.
    * The same samples would be selected anyway.
@@ -33,11 +33,23 @@ template <class TInputImage>
 void
 ImageFullSampler<TInputImage>::GenerateData(void)
 {
+  /** All voxels are sampled, so the samples are those of a grid with unit spacing. */
+  SampleGridSpacingType unitGridSpacing;
+  unitGridSpacing.Fill(1);
+
+  /** Reuse the samples, if they have been generated before. */
+  if (this->GetOutputFromSampleContainerCache(unitGridSpacing))
+  {
+    return;
+  }
+
   /** If desired we exercise a multi-threaded version. */
   if (this->m_UseMultiThread)
   {
     /** Calls ThreadedGenerateData(). */
-    return Superclass::GenerateData();
+    Superclass::GenerateData();
+    this->AddOutputToSampleContainerCache(unitGridSpacing);
+    return;
   }
 
   /** Get handles to the input image, output sample container, and the mask. */
@@ -123,6 +135,8 @@ ImageFullSampler<TInputImage>::GenerateData(void)
     }   // end for
   }     // end else (if mask exists)
 
+  this->AddOutputToSampleContainerCache(unitGridSpacing);
+
 } // end GenerateData()
 
 
@@ -78,6 +78,12 @@ ImageGridSampler<TInputImage>::GenerateData(void)
   /** Take into account the possibility of a smaller bounding box around the mask */
   this->SetNumberOfSamples(this->m_RequestedNumberOfSamples);
 
+  /** Reuse the samples, if they have been generated before. */
+  if (this->GetOutputFromSampleContainerCache(this->m_SampleGridSpacing))
+  {
+    return;
+  }
+
   /** Determine the grid. */
   SampleGridIndexType        index;
   SampleGridSizeType         sampleGridSize;
@@ -207,6 +213,8 @@ ImageGridSampler<TInputImage>::GenerateData(void)
     } // end t
   }   // else (if mask exists)
 
+  this->AddOutputToSampleContainerCache(this->m_SampleGridSpacing);
+
 } // end GenerateData()
 
 
@@ -21,7 +21,7 @@
 #include "itkImageRandomSamplerBase.h"
 #include "itkInterpolateImageFunction.h"
 #include "itkBSplineInterpolateImageFunction.h"
-#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkRegistrationThreadState.h"
 
 namespace itk
 {
@@ -100,6 +100,17 @@ public:
   itkGetConstMacro(UseRandomSampleRegion, bool);
   itkSetMacro(UseRandomSampleRegion, bool);
 
+  /** Set/Get whether the samples are generated without allocating sample containers, when no
+   * mask is used. In this mode the threads write their samples directly into their own part of
+   * the output, which keeps its memory as long as the number of samples does not grow. Each thread
+   * draws its random coordinates from its own generator, which is seeded by the main generator.
+   * The threads of the WorkStealingThreadPool are used, so no threads are created either.
+   * Default: false.
+   */
+  itkSetMacro(UseAllocationFreeSampling, bool);
+  itkGetConstMacro(UseAllocationFreeSampling, bool);
+  itkBooleanMacro(UseAllocationFreeSampling);
+
 protected:
   typedef typename InterpolatorType::ContinuousIndexType InputImageContinuousIndexType;
 
@@ -123,6 +134,10 @@ protected:
   void
   ThreadedGenerateData(const InputImageRegionType & inputRegionForThread, ThreadIdType threadId) override;
 
+  /** Generates the samples in the allocation-free mode. */
+  virtual void
+  AllocationFreeGenerateData(void);
+
   /** Generate a point randomly in a bounding box. */
   virtual void
   GenerateRandomCoordinate(const InputImageContinuousIndexType & smallestContIndex,
@@ -152,6 +167,10 @@ private:
   operator=(const Self &) = delete;
 
   bool m_UseRandomSampleRegion;
+  bool m_UseAllocationFreeSampling;
+
+  /** The random generators of the threads, in the allocation-free mode. */
+  std::vector<RandomGeneratorPointer> m_ThreaderRandomGenerators;
 };
 
 } // end namespace itk
@@ -19,8 +19,11 @@
 #define itkImageRandomCoordinateSampler_hxx
 
 #include "itkImageRandomCoordinateSampler.h"
+#include "itkWorkStealingThreadPool.h"
 #include "vnl/vnl_math.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
@@ -37,10 +40,11 @@ ImageRandomCoordinateSampler<TInputImage>::ImageRandomCoordinateSampler()
   this->m_Interpolator = bsplineInterpolator;
 
   /** Setup random generator. */
-  this->m_RandomGenerator = RandomGeneratorType::GetInstance();
+  this->m_RandomGenerator = RegistrationThreadState::GetRandomGenerator();
 
   this->m_UseRandomSampleRegion = false;
   this->m_SampleRegionSize.Fill(1.0);
+  this->m_UseAllocationFreeSampling = false;
 
 } // end Constructor
 
@@ -55,6 +59,10 @@ ImageRandomCoordinateSampler<TInputImage>::GenerateData(void)
 {
   /** Get a handle to the mask. If there was no mask supplied we exercise a multi-threaded version. */
   typename MaskType::ConstPointer mask = this->GetMask();
+  if (mask.IsNull() && this->m_UseAllocationFreeSampling)
+  {
+    return this->AllocationFreeGenerateData();
+  }
   if (mask.IsNull() && this->m_UseMultiThread)
   {
     /** Calls ThreadedGenerateData(). */
@@ -267,6 +275,81 @@ ImageRandomCoordinateSampler<TInputImage>::ThreadedGenerateData(const InputImage
 } // end ThreadedGenerateData()
 
 
+/**
+ * ******************* AllocationFreeGenerateData *******************
+ */
+
+template <class TInputImage>
+void
+ImageRandomCoordinateSampler<TInputImage>::AllocationFreeGenerateData(void)
+{
+  /** Get handles to the input image, output sample container, and interpolator. */
+  const InputImageType * const     inputImage = this->GetInput();
+  ImageSampleContainerType * const sampleContainer = this->GetOutput();
+  InterpolatorType * const         interpolator = this->GetModifiableInterpolator();
+
+  /** Set up the interpolator. */
+  interpolator->SetInputImage(inputImage);
+
+  /** Convert inputImageRegion to bounding box in physical space. */
+  InputImageSizeType unitSize;
+  unitSize.Fill(1);
+  InputImageIndexType           smallestIndex = this->GetCroppedInputImageRegion().GetIndex();
+  InputImageIndexType           largestIndex = smallestIndex + this->GetCroppedInputImageRegion().GetSize() - unitSize;
+  InputImageContinuousIndexType smallestImageCIndex(smallestIndex);
+  InputImageContinuousIndexType largestImageCIndex(largestIndex);
+  InputImageContinuousIndexType smallestCIndex, largestCIndex;
+  this->GenerateSampleRegion(smallestImageCIndex, largestImageCIndex, smallestCIndex, largestCIndex);
+
+  /** The output keeps its capacity when it is cleared by the pipeline,
+   * so resizing only allocates when the number of samples has grown.
+   */
+  const unsigned long numberOfSamples = this->GetNumberOfSamples();
+  sampleContainer->resize(numberOfSamples);
+
+  /** Split the random stream: the generator of each work unit is seeded by the main generator.
+   * The generators are only created once.
+   */
+  const ThreadIdType numberOfWorkUnits = static_cast<ThreadIdType>(
+    std::max<unsigned long>(std::min<unsigned long>(this->GetNumberOfWorkUnits(), numberOfSamples), 1));
+  while (this->m_ThreaderRandomGenerators.size() < numberOfWorkUnits)
+  {
+    this->m_ThreaderRandomGenerators.push_back(RandomGeneratorType::New());
+  }
+  for (ThreadIdType i = 0; i < numberOfWorkUnits; ++i)
+  {
+    this->m_ThreaderRandomGenerators[i]->SetSeed(this->m_RandomGenerator->GetIntegerVariate());
+  }
+
+  /** Each work unit fills its own contiguous part of the output. */
+  const auto generateSamples = [this, inputImage, sampleContainer, interpolator, numberOfSamples, numberOfWorkUnits,
+                                &smallestCIndex, &largestCIndex](ThreadIdType workUnitID) {
+    const unsigned long   begin = (workUnitID * numberOfSamples) / numberOfWorkUnits;
+    const unsigned long   end = ((workUnitID + 1) * numberOfSamples) / numberOfWorkUnits;
+    RandomGeneratorType & randomGenerator = *this->m_ThreaderRandomGenerators[workUnitID];
+
+    InputImageContinuousIndexType sampleCIndex;
+    for (unsigned long i = begin; i < end; ++i)
+    {
+      /** Create a random point out of InputImageDimension random numbers. */
+      for (unsigned int j = 0; j < InputImageDimension; ++j)
+      {
+        sampleCIndex[j] = static_cast<InputImagePointValueType>(
+          randomGenerator.GetUniformVariate(smallestCIndex[j], largestCIndex[j]));
+      }
+
+      /** Convert to point, and compute the value at the continuous index. */
+      ImageSampleType & sample = (*sampleContainer)[i];
+      inputImage->TransformContinuousIndexToPhysicalPoint(sampleCIndex, sample.m_ImageCoordinates);
+      sample.m_ImageValue = static_cast<ImageSampleValueType>(interpolator->EvaluateAtContinuousIndex(sampleCIndex));
+    }
+  };
+
+  WorkStealingThreadPool::GetInstance()->Execute(numberOfWorkUnits, generateSamples);
+
+} // end AllocationFreeGenerateData()
+
+
 /**
  * ******************* GenerateRandomCoordinate *******************
  */
@@ -340,6 +423,7 @@ ImageRandomCoordinateSampler<TInputImage>::PrintSelf(std::ostream & os, Indent i
 
   os << indent << "Interpolator: " << this->m_Interpolator.GetPointer() << std::endl;
   os << indent << "RandomGenerator: " << this->m_RandomGenerator.GetPointer() << std::endl;
+  os << indent << "UseAllocationFreeSampling: " << this->m_UseAllocationFreeSampling << std::endl;
 
 } // end PrintSelf()
 
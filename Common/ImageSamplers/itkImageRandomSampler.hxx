@@ -20,8 +20,7 @@
 
 #include "itkImageRandomSampler.h"
 
-#include "itkMersenneTwisterRandomVariateGenerator.h"
-#include "itkImageRandomConstIteratorWithIndex.h"
+#include "itkRegistrationThreadState.h"
 
 namespace itk
 {
@@ -49,10 +48,30 @@ ImageRandomSampler<TInputImage>::GenerateData(void)
   /** Reserve memory for the output. */
   sampleContainer->Reserve(this->GetNumberOfSamples());
 
-  /** Setup a random iterator over the input image. */
-  typedef ImageRandomConstIteratorWithIndex<InputImageType> RandomIteratorType;
-  RandomIteratorType                                        randIter(inputImage, this->GetCroppedInputImageRegion());
-  randIter.GoToBegin();
+  /** Draw random positions in the cropped region, like the ImageRandomConstIteratorWithIndex
+   * does, but from the random generator of this thread instead of the global one.
+   */
+  const RegistrationThreadState::RandomGeneratorType::Pointer randomGenerator =
+    RegistrationThreadState::GetRandomGenerator();
+  const InputImageRegionType region = this->GetCroppedInputImageRegion();
+  const double               numPixels = static_cast<double>(region.GetNumberOfPixels());
+  const auto                 getRandomIndex = [&randomGenerator, &region, numPixels]() {
+    unsigned long randomPosition =
+      static_cast<unsigned long>(randomGenerator->GetVariateWithOpenRange(numPixels - 0.5));
+    InputImageIndexType positionIndex;
+    for (unsigned int dim = 0; dim < InputImageDimension; dim++)
+    {
+      const unsigned long sizeInThisDimension = region.GetSize(dim);
+      const unsigned long residual = randomPosition % sizeInThisDimension;
+      positionIndex[dim] = residual + region.GetIndex(dim);
+      randomPosition -= residual;
+      randomPosition /= sizeInThisDimension;
+    }
+    return positionIndex;
+  };
+
+  /** Dummy jump, like the one of ImageRandomConstIteratorWithIndex::GoToBegin(). */
+  getRandomIndex();
 
   /** Setup an iterator over the output, which is of ImageSampleContainerType. */
   typename ImageSampleContainerType::Iterator      iter;
@@ -60,19 +79,14 @@ ImageRandomSampler<TInputImage>::GenerateData(void)
 
   if (mask.IsNull())
   {
-    /** number of samples + 1, because of the initial ++randIter. */
-    randIter.SetNumberOfSamples(this->GetNumberOfSamples() + 1);
-    /** Advance one, in order to generate the same sequence as when using a mask */
-    ++randIter;
     for (iter = sampleContainer->Begin(); iter != end; ++iter)
     {
-      /** Get the index, transform it to the physical coordinates and put it in the sample. */
-      InputImageIndexType index = randIter.GetIndex();
+      /** Jump to a random position. */
+      const InputImageIndexType index = getRandomIndex();
+      /** Transform the index to the physical coordinates and put it in the sample. */
       inputImage->TransformIndexToPhysicalPoint(index, (*iter).Value().m_ImageCoordinates);
       /** Get the value and put it in the sample. */
-      (*iter).Value().m_ImageValue = randIter.Get();
-      /** Jump to a random position. */
-      ++randIter;
+      (*iter).Value().m_ImageValue = static_cast<ImageSampleValueType>(inputImage->GetPixel(index));
 
     } // end for loop
   }   // end if no mask
@@ -85,9 +99,11 @@ ImageRandomSampler<TInputImage>::GenerateData(void)
     }
 
     /** Make sure we are not eternally trying to find samples: */
-    randIter.SetNumberOfSamples(10 * this->GetNumberOfSamples());
+    const unsigned long maximumNumberOfJumps = 10 * this->GetNumberOfSamples();
+    unsigned long       numberOfJumps = 0;
 
     /** Loop over the sample container. */
+    InputImageIndexType index;
     InputImagePointType inputPoint;
     bool                insideMask = false;
     for (iter = sampleContainer->Begin(); iter != end; ++iter)
@@ -96,9 +112,9 @@ ImageRandomSampler<TInputImage>::GenerateData(void)
       do
       {
         /** Jump to a random position. */
-        ++randIter;
+        index = getRandomIndex();
         /** Check if we are not trying eternally to find a valid point. */
-        if (randIter.IsAtEnd())
+        if (++numberOfJumps > maximumNumberOfJumps)
         {
           /** Squeeze the sample container to the size that is still valid. */
           typename ImageSampleContainerType::iterator stlnow = sampleContainer->begin();
@@ -108,8 +124,7 @@ ImageRandomSampler<TInputImage>::GenerateData(void)
           itkExceptionMacro(<< "Could not find enough image samples within "
                             << "reasonable time. Probably the mask is too small");
         }
-        /** Get the index, and transform it to the physical coordinates. */
-        InputImageIndexType index = randIter.GetIndex();
+        /** Transform the index to the physical coordinates. */
         inputImage->TransformIndexToPhysicalPoint(index, inputPoint);
         /** Check if it's inside the mask. */
         insideMask = mask->IsInsideInWorldSpace(inputPoint);
@@ -117,16 +132,16 @@ ImageRandomSampler<TInputImage>::GenerateData(void)
 
       /** Put the coordinates and the value in the sample. */
       (*iter).Value().m_ImageCoordinates = inputPoint;
-      (*iter).Value().m_ImageValue = randIter.Get();
+      (*iter).Value().m_ImageValue = static_cast<ImageSampleValueType>(inputImage->GetPixel(index));
 
     } // end for loop
-
-    /** Extra random sample to make sure the same sequence is generated
-     * with and without mask.
-     */
-    ++randIter;
   }
 
+  /** Extra random jump to make sure the same sequence is generated
+   * with and without mask, and by the multi-threaded version.
+   */
+  getRandomIndex();
+
 } // end GenerateData()
 
 
@@ -20,7 +20,7 @@
 
 #include "itkImageRandomSamplerBase.h"
 
-#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkRegistrationThreadState.h"
 #include "itkImageRandomConstIteratorWithIndex.h"
 
 namespace itk
@@ -48,7 +48,7 @@ ImageRandomSamplerBase<TInputImage>::BeforeThreadedGenerateData(void)
 {
   /** Create a random number generator. Also used in the ImageRandomConstIteratorWithIndex. */
   typedef typename Statistics::MersenneTwisterRandomVariateGenerator::Pointer GeneratorPointer;
-  GeneratorPointer localGenerator = Statistics::MersenneTwisterRandomVariateGenerator::GetInstance();
+  GeneratorPointer localGenerator = RegistrationThreadState::GetRandomGenerator();
   // \todo: should probably be global?
 
   /** Clear the random number list. */
@@ -19,7 +19,7 @@
 #define itkImageRandomSamplerSparseMask_h
 
 #include "itkImageRandomSamplerBase.h"
-#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkRegistrationThreadState.h"
 #include "itkImageFullSampler.h"
 
 namespace itk
@@ -31,7 +31,7 @@ template <class TInputImage>
 ImageRandomSamplerSparseMask<TInputImage>::ImageRandomSamplerSparseMask()
 {
   /** Setup random generator. */
-  this->m_RandomGenerator = RandomGeneratorType::GetInstance();
+  this->m_RandomGenerator = RegistrationThreadState::GetRandomGenerator();
 
   this->m_InternalFullSampler = InternalFullSamplerType::New();
 
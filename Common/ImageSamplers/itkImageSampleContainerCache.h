@@ -0,0 +1,156 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageSampleContainerCache_h
+#define itkImageSampleContainerCache_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkImageSample.h"
+#include "itkVectorDataContainer.h"
+#include "itkSpatialObject.h"
+
+#include <mutex>
+#include <vector>
+
+namespace itk
+{
+/** \class ImageSampleContainerCache
+ *
+ * \brief Stores the sample containers of deterministic image samplers, so that
+ * samplers with the same input can reuse them.
+ *
+ * The samples taken on a regular grid only depend on the input image, the mask,
+ * the (cropped) input image region and the grid spacing. These four form the key
+ * of a cached sample container. The modified times of the image and the mask are
+ * part of the key too, so that a container is never reused after its input has changed.
+ * The ImageFullSampler uses a grid spacing of one voxel, so a full sampler and a grid
+ * sampler with a grid spacing of one share their samples.
+ *
+ * The cache may be shared by several samplers, for example by the samplers of the
+ * metrics of a MultiMetricMultiResolutionRegistration, and may be accessed concurrently.
+ * It holds a reference to the images and masks of its entries, until it is cleared.
+ *
+ * \ingroup ImageSamplers
+ */
+
+template <class TInputImage>
+class ImageSampleContainerCache : public Object
+{
+public:
+  /** Standard ITK-stuff. */
+  typedef ImageSampleContainerCache Self;
+  typedef Object                    Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageSampleContainerCache, Object);
+
+  /** Typedefs. */
+  typedef TInputImage                                       InputImageType;
+  typedef typename InputImageType::ConstPointer             InputImageConstPointer;
+  typedef typename InputImageType::RegionType               InputImageRegionType;
+  typedef typename InputImageType::OffsetType               SampleGridSpacingType;
+  typedef ImageSample<InputImageType>                       ImageSampleType;
+  typedef VectorDataContainer<std::size_t, ImageSampleType> ImageSampleContainerType;
+  typedef typename ImageSampleContainerType::Pointer        ImageSampleContainerPointer;
+
+  /** The input image dimension. */
+  itkStaticConstMacro(InputImageDimension, unsigned int, InputImageType::ImageDimension);
+
+  typedef SpatialObject<Self::InputImageDimension> MaskType;
+  typedef typename MaskType::ConstPointer          MaskConstPointer;
+
+  /** Copy the cached samples into the sample container. Returns false, and
+   * leaves the sample container untouched, if the samples are not in the cache.
+   */
+  bool
+  GetSampleContainer(const InputImageType *        image,
+                     const MaskType *              mask,
+                     const InputImageRegionType &  region,
+                     const SampleGridSpacingType & gridSpacing,
+                     ImageSampleContainerType &    sampleContainer) const;
+
+  /** Store a copy of the sample container. Entries of the same image and mask
+   * that have become outdated are removed.
+   */
+  void
+  AddSampleContainer(const InputImageType *           image,
+                     const MaskType *                 mask,
+                     const InputImageRegionType &     region,
+                     const SampleGridSpacingType &    gridSpacing,
+                     const ImageSampleContainerType & sampleContainer);
+
+  /** Remove all entries, and release their memory. */
+  void
+  Clear(void);
+
+  /** Get the number of cached sample containers. */
+  SizeValueType
+  GetNumberOfEntries(void) const;
+
+  /** Get the number of times that a sample container was found in the cache. */
+  SizeValueType
+  GetNumberOfHits(void) const;
+
+protected:
+  /** The constructor. */
+  ImageSampleContainerCache();
+
+  /** The destructor. */
+  ~ImageSampleContainerCache() override = default;
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** The deleted copy constructor. */
+  ImageSampleContainerCache(const Self &) = delete;
+  /** The deleted assignment operator. */
+  void
+  operator=(const Self &) = delete;
+
+  /** A cached sample container, and the key by which it is found. */
+  struct EntryType
+  {
+    InputImageConstPointer      m_Image;
+    ModifiedTimeType            m_ImageMTime;
+    MaskConstPointer            m_Mask;
+    ModifiedTimeType            m_MaskMTime;
+    InputImageRegionType        m_Region;
+    SampleGridSpacingType       m_GridSpacing;
+    ImageSampleContainerPointer m_SampleContainer;
+  };
+
+  /** Member variables. */
+  std::vector<EntryType> m_Entries;
+  mutable SizeValueType  m_NumberOfHits;
+  mutable std::mutex     m_Mutex;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkImageSampleContainerCache.hxx"
+#endif
+
+#endif // end #ifndef itkImageSampleContainerCache_h
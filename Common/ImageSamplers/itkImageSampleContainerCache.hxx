@@ -0,0 +1,195 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageSampleContainerCache_hxx
+#define itkImageSampleContainerCache_hxx
+
+#include "itkImageSampleContainerCache.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+/**
+ * ******************* Constructor *******************
+ */
+
+template <class TInputImage>
+ImageSampleContainerCache<TInputImage>::ImageSampleContainerCache()
+{
+  this->m_NumberOfHits = 0;
+
+} // end Constructor
+
+
+/**
+ * ******************* GetSampleContainer *******************
+ */
+
+template <class TInputImage>
+bool
+ImageSampleContainerCache<TInputImage>::GetSampleContainer(const InputImageType *        image,
+                                                           const MaskType *              mask,
+                                                           const InputImageRegionType &  region,
+                                                           const SampleGridSpacingType & gridSpacing,
+                                                           ImageSampleContainerType &    sampleContainer) const
+{
+  if (image == nullptr)
+  {
+    return false;
+  }
+
+  const ModifiedTimeType imageMTime = image->GetMTime();
+  const ModifiedTimeType maskMTime = mask ? mask->GetMTime() : 0;
+
+  /** Look up the entry. The cached containers are never modified,
+   * so they can be copied after the lock is released.
+   */
+  ImageSampleContainerPointer cachedSampleContainer;
+  {
+    std::lock_guard<std::mutex> lock(this->m_Mutex);
+    for (const EntryType & entry : this->m_Entries)
+    {
+      if (entry.m_Image.GetPointer() == image && entry.m_ImageMTime == imageMTime &&
+          entry.m_Mask.GetPointer() == mask && entry.m_MaskMTime == maskMTime && entry.m_Region == region &&
+          entry.m_GridSpacing == gridSpacing)
+      {
+        cachedSampleContainer = entry.m_SampleContainer;
+        ++this->m_NumberOfHits;
+        break;
+      }
+    }
+  }
+
+  if (cachedSampleContainer.IsNull())
+  {
+    return false;
+  }
+
+  sampleContainer.assign(cachedSampleContainer->begin(), cachedSampleContainer->end());
+  return true;
+
+} // end GetSampleContainer()
+
+
+/**
+ * ******************* AddSampleContainer *******************
+ */
+
+template <class TInputImage>
+void
+ImageSampleContainerCache<TInputImage>::AddSampleContainer(const InputImageType *           image,
+                                                           const MaskType *                 mask,
+                                                           const InputImageRegionType &     region,
+                                                           const SampleGridSpacingType &    gridSpacing,
+                                                           const ImageSampleContainerType & sampleContainer)
+{
+  if (image == nullptr)
+  {
+    return;
+  }
+
+  EntryType newEntry;
+  newEntry.m_Image = image;
+  newEntry.m_ImageMTime = image->GetMTime();
+  newEntry.m_Mask = mask;
+  newEntry.m_MaskMTime = mask ? mask->GetMTime() : 0;
+  newEntry.m_Region = region;
+  newEntry.m_GridSpacing = gridSpacing;
+
+  /** Copy the samples before taking the lock. */
+  newEntry.m_SampleContainer = ImageSampleContainerType::New();
+  newEntry.m_SampleContainer->assign(sampleContainer.begin(), sampleContainer.end());
+
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+
+  /** Remove the entries that can never be found anymore, because their image or mask has changed. */
+  const auto isOutdated = [&newEntry](const EntryType & entry) {
+    return entry.m_Image.GetPointer() == newEntry.m_Image.GetPointer() &&
+           entry.m_Mask.GetPointer() == newEntry.m_Mask.GetPointer() &&
+           (entry.m_ImageMTime != newEntry.m_ImageMTime || entry.m_MaskMTime != newEntry.m_MaskMTime);
+  };
+  this->m_Entries.erase(std::remove_if(this->m_Entries.begin(), this->m_Entries.end(), isOutdated),
+                        this->m_Entries.end());
+
+  this->m_Entries.push_back(newEntry);
+
+} // end AddSampleContainer()
+
+
+/**
+ * ******************* Clear *******************
+ */
+
+template <class TInputImage>
+void
+ImageSampleContainerCache<TInputImage>::Clear(void)
+{
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+  std::vector<EntryType>().swap(this->m_Entries);
+
+} // end Clear()
+
+
+/**
+ * ******************* GetNumberOfEntries *******************
+ */
+
+template <class TInputImage>
+SizeValueType
+ImageSampleContainerCache<TInputImage>::GetNumberOfEntries(void) const
+{
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+  return static_cast<SizeValueType>(this->m_Entries.size());
+
+} // end GetNumberOfEntries()
+
+
+/**
+ * ******************* GetNumberOfHits *******************
+ */
+
+template <class TInputImage>
+SizeValueType
+ImageSampleContainerCache<TInputImage>::GetNumberOfHits(void) const
+{
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+  return this->m_NumberOfHits;
+
+} // end GetNumberOfHits()
+
+
+/**
+ * ******************* PrintSelf *******************
+ */
+
+template <class TInputImage>
+void
+ImageSampleContainerCache<TInputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << std::endl;
+  os << indent << "NumberOfHits: " << this->GetNumberOfHits() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkImageSampleContainerCache_hxx
@@ -0,0 +1,203 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageSampleSoAContainer_h
+#define itkImageSampleSoAContainer_h
+
+#include "itkDataObject.h"
+#include "itkObjectFactory.h"
+#include "itkImageSample.h"
+#include "itkVectorDataContainer.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class ImageSampleSoAContainer
+ *
+ * \brief Stores image samples as a structure of arrays.
+ *
+ * The VectorDataContainer of ImageSample objects, which is the regular output
+ * of the image samplers, stores the samples as an array of structures:
+ * the coordinates and the value of one sample are adjacent in memory.
+ * This class stores the same samples as a structure of arrays instead:
+ * one contiguous array per coordinate dimension, plus one array with the
+ * sample values. Each array starts at a cache line boundary.
+ *
+ * Loops that only need a part of the sample data, or that process the samples
+ * in blocks, then stream through memory linearly and can be vectorized by the
+ * compiler.
+ *
+ * \sa ImageSamplerBase::GetSoAOutput()
+ * \ingroup ImageSamplers
+ */
+
+template <class TImage>
+class ImageSampleSoAContainer : public DataObject
+{
+public:
+  /** Standard ITK-stuff. */
+  typedef ImageSampleSoAContainer  Self;
+  typedef DataObject               Superclass;
+  typedef SmartPointer<Self>       Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageSampleSoAContainer, DataObject);
+
+  /** The image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TImage::ImageDimension);
+
+  /** Typedefs. */
+  typedef ImageSample<TImage>                               ImageSampleType;
+  typedef typename ImageSampleType::PointType               PointType;
+  typedef typename PointType::ValueType                     CoordinateValueType;
+  typedef typename ImageSampleType::RealType                SampleValueType;
+  typedef VectorDataContainer<std::size_t, ImageSampleType> ImageSampleContainerType;
+
+  /** Set the number of samples. Memory is only reallocated when the
+   * current capacity is insufficient. The contents are undefined afterwards.
+   */
+  void
+  SetSize(std::size_t numberOfSamples);
+
+  /** Get the number of samples. */
+  std::size_t
+  Size(void) const
+  {
+    return this->m_Size;
+  }
+
+
+  /** Release all memory. */
+  void
+  Initialize(void) override;
+
+  /** Get a pointer to the contiguous array with coordinate 'dim' of all samples. */
+  CoordinateValueType *
+  GetCoordinates(unsigned int dim)
+  {
+    return this->m_Coordinates[dim];
+  }
+
+
+  const CoordinateValueType *
+  GetCoordinates(unsigned int dim) const
+  {
+    return this->m_Coordinates[dim];
+  }
+
+
+  /** Get a pointer to the contiguous array with the values of all samples. */
+  SampleValueType *
+  GetValues(void)
+  {
+    return this->m_Values;
+  }
+
+
+  const SampleValueType *
+  GetValues(void) const
+  {
+    return this->m_Values;
+  }
+
+
+  /** Gather the coordinates of sample i into a point. */
+  void
+  GetPoint(std::size_t i, PointType & point) const
+  {
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      point[d] = this->m_Coordinates[d][i];
+    }
+  }
+
+
+  /** Scatter a point and a value into sample i. */
+  void
+  SetSample(std::size_t i, const PointType & point, const SampleValueType & value)
+  {
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      this->m_Coordinates[d][i] = point[d];
+    }
+    this->m_Values[i] = value;
+  }
+
+
+  /** Copy the samples [first, last) of an array-of-structures container into
+   * this container, starting at sample position 'offset'. The container
+   * should already have the right size. Different threads may copy
+   * non-overlapping ranges concurrently.
+   */
+  void
+  CopyFrom(const ImageSampleType * first, const ImageSampleType * last, std::size_t offset);
+
+  /** Resize this container and copy all samples of an array-of-structures container into it. */
+  void
+  CopyFrom(const ImageSampleContainerType & samples);
+
+protected:
+  /** The constructor. */
+  ImageSampleSoAContainer();
+
+  /** The destructor. */
+  ~ImageSampleSoAContainer() override = default;
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** The deleted copy constructor. */
+  ImageSampleSoAContainer(const Self &) = delete;
+  /** The deleted assignment operator. */
+  void
+  operator=(const Self &) = delete;
+
+  /** Round a number of elements of type T up to a whole number of cache lines. */
+  template <class T>
+  static std::size_t
+  RoundUpToCacheLine(std::size_t numberOfElements);
+
+  /** Return the first address in the buffer that is aligned on a cache line. */
+  template <class T>
+  static T *
+  AlignOnCacheLine(std::vector<T> & buffer);
+
+  /** Member variables. */
+  std::size_t m_Size;
+  std::size_t m_Capacity;
+
+  std::vector<CoordinateValueType> m_CoordinateBuffer;
+  std::vector<SampleValueType>     m_ValueBuffer;
+  CoordinateValueType *            m_Coordinates[ImageDimension];
+  SampleValueType *                m_Values;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkImageSampleSoAContainer.hxx"
+#endif
+
+#endif // end #ifndef itkImageSampleSoAContainer_h
@@ -0,0 +1,204 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageSampleSoAContainer_hxx
+#define itkImageSampleSoAContainer_hxx
+
+#include "itkImageSampleSoAContainer.h"
+
+#include <cstdint>
+
+namespace itk
+{
+
+/**
+ * ******************* Constructor *******************
+ */
+
+template <class TImage>
+ImageSampleSoAContainer<TImage>::ImageSampleSoAContainer()
+{
+  this->m_Size = 0;
+  this->m_Capacity = 0;
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    this->m_Coordinates[d] = nullptr;
+  }
+  this->m_Values = nullptr;
+
+} // end Constructor
+
+
+/**
+ * ******************* RoundUpToCacheLine *******************
+ */
+
+template <class TImage>
+template <class T>
+std::size_t
+ImageSampleSoAContainer<TImage>::RoundUpToCacheLine(std::size_t numberOfElements)
+{
+  const std::size_t elementsPerCacheLine = ITK_CACHE_LINE_ALIGNMENT / sizeof(T);
+  return ((numberOfElements + elementsPerCacheLine - 1) / elementsPerCacheLine) * elementsPerCacheLine;
+
+} // end RoundUpToCacheLine()
+
+
+/**
+ * ******************* AlignOnCacheLine *******************
+ */
+
+template <class TImage>
+template <class T>
+T *
+ImageSampleSoAContainer<TImage>::AlignOnCacheLine(std::vector<T> & buffer)
+{
+  const std::uintptr_t alignment = ITK_CACHE_LINE_ALIGNMENT;
+  const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(buffer.data());
+  return reinterpret_cast<T *>((address + alignment - 1) & ~(alignment - 1));
+
+} // end AlignOnCacheLine()
+
+
+/**
+ * ******************* SetSize *******************
+ */
+
+template <class TImage>
+void
+ImageSampleSoAContainer<TImage>::SetSize(std::size_t numberOfSamples)
+{
+  if (numberOfSamples > this->m_Capacity)
+  {
+    /** Each coordinate array gets a whole number of cache lines, so that
+     * all of them start on a cache line boundary. One extra cache line
+     * per buffer is reserved to align the start of the buffer.
+     */
+    const std::size_t coordinateStride = RoundUpToCacheLine<CoordinateValueType>(numberOfSamples);
+    const std::size_t valueStride = RoundUpToCacheLine<SampleValueType>(numberOfSamples);
+
+    this->m_CoordinateBuffer.resize(ImageDimension * coordinateStride +
+                                    ITK_CACHE_LINE_ALIGNMENT / sizeof(CoordinateValueType));
+    this->m_ValueBuffer.resize(valueStride + ITK_CACHE_LINE_ALIGNMENT / sizeof(SampleValueType));
+
+    CoordinateValueType * coordinates = AlignOnCacheLine(this->m_CoordinateBuffer);
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      this->m_Coordinates[d] = coordinates + d * coordinateStride;
+    }
+    this->m_Values = AlignOnCacheLine(this->m_ValueBuffer);
+
+    this->m_Capacity = numberOfSamples;
+  }
+
+  this->m_Size = numberOfSamples;
+  this->Modified();
+
+} // end SetSize()
+
+
+/**
+ * ******************* Initialize *******************
+ */
+
+template <class TImage>
+void
+ImageSampleSoAContainer<TImage>::Initialize(void)
+{
+  this->Superclass::Initialize();
+
+  std::vector<CoordinateValueType>().swap(this->m_CoordinateBuffer);
+  std::vector<SampleValueType>().swap(this->m_ValueBuffer);
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    this->m_Coordinates[d] = nullptr;
+  }
+  this->m_Values = nullptr;
+  this->m_Size = 0;
+  this->m_Capacity = 0;
+
+} // end Initialize()
+
+
+/**
+ * ******************* CopyFrom *******************
+ */
+
+template <class TImage>
+void
+ImageSampleSoAContainer<TImage>::CopyFrom(const ImageSampleType * first,
+                                          const ImageSampleType * last,
+                                          std::size_t             offset)
+{
+  /** Transpose the samples, one output array at a time. This way each pass
+   * writes a single contiguous stream.
+   */
+  const std::size_t n = static_cast<std::size_t>(last - first);
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    CoordinateValueType * coordinates = this->m_Coordinates[d] + offset;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      coordinates[i] = first[i].m_ImageCoordinates[d];
+    }
+  }
+
+  SampleValueType * values = this->m_Values + offset;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    values[i] = first[i].m_ImageValue;
+  }
+
+} // end CopyFrom()
+
+
+/**
+ * ******************* CopyFrom *******************
+ */
+
+template <class TImage>
+void
+ImageSampleSoAContainer<TImage>::CopyFrom(const ImageSampleContainerType & samples)
+{
+  this->SetSize(samples.size());
+  if (!samples.empty())
+  {
+    this->CopyFrom(samples.data(), samples.data() + samples.size(), 0);
+  }
+
+} // end CopyFrom()
+
+
+/**
+ * ******************* PrintSelf *******************
+ */
+
+template <class TImage>
+void
+ImageSampleSoAContainer<TImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Size: " << this->m_Size << std::endl;
+  os << indent << "Capacity: " << this->m_Capacity << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkImageSampleSoAContainer_hxx
@@ -20,6 +20,8 @@
 
 #include "itkImageToVectorContainerFilter.h"
 #include "itkImageSample.h"
+#include "itkImageSampleSoAContainer.h"
+#include "itkImageSampleContainerCache.h"
 #include "itkVectorDataContainer.h"
 #include "itkSpatialObject.h"
 
@@ -73,6 +75,9 @@ public:
   typedef ImageSample<InputImageType>                       ImageSampleType;
   typedef VectorDataContainer<std::size_t, ImageSampleType> ImageSampleContainerType;
   typedef typename ImageSampleContainerType::Pointer        ImageSampleContainerPointer;
+  typedef ImageSampleSoAContainer<InputImageType>           ImageSampleSoAContainerType;
+  typedef typename ImageSampleSoAContainerType::Pointer     ImageSampleSoAContainerPointer;
+  typedef ImageSampleContainerCache<InputImageType>         ImageSampleContainerCacheType;
   typedef typename InputImageType::SizeType                 InputImageSizeType;
   typedef typename InputImageType::IndexType                InputImageIndexType;
   typedef typename InputImageType::PointType                InputImagePointType;
@@ -179,6 +184,35 @@ public:
   /** \todo: Temporary, should think about interface. */
   itkSetMacro(UseMultiThread, bool);
 
+  /** Set/Get whether the sampler also stores its samples in structure-of-arrays
+   * layout, see GetSoAOutput(). Default: false.
+   */
+  itkSetMacro(GenerateSoAOutput, bool);
+  itkGetConstMacro(GenerateSoAOutput, bool);
+  itkBooleanMacro(GenerateSoAOutput);
+
+  /** Get the samples in structure-of-arrays layout. The container holds the
+   * same samples, in the same order, as GetOutput(). It is only filled when
+   * GenerateSoAOutput is true, and it is updated together with the output.
+   */
+  virtual ImageSampleSoAContainerType *
+  GetSoAOutput(void) const
+  {
+    return this->m_SoAOutput.GetPointer();
+  }
+
+
+  /** Set/Get the cache from which the sampler may take its samples, instead of
+   * generating them. Only deterministic samplers (the full and the grid sampler)
+   * use the cache. The same cache may be set to several samplers. Default: none.
+   */
+  itkSetObjectMacro(SampleContainerCache, ImageSampleContainerCacheType);
+  itkGetModifiableObjectMacro(SampleContainerCache, ImageSampleContainerCacheType);
+
+  /** Regenerates the structure-of-arrays output after the regular output has been generated. */
+  void
+  UpdateOutputData(DataObject * output) override;
+
 protected:
   /** The constructor. */
   ImageSamplerBase();
@@ -219,6 +253,20 @@ protected:
   void
   AfterThreadedGenerateData(void) override;
 
+  /** Fill the structure-of-arrays output from the regular output. */
+  virtual void
+  GenerateSoAOutputData(void);
+
+  /** Fill the output with the samples of the grid with the given spacing within the cropped
+   * input image region, if they are in the sample container cache. Returns false otherwise.
+   */
+  virtual bool
+  GetOutputFromSampleContainerCache(const typename ImageSampleContainerCacheType::SampleGridSpacingType & gridSpacing);
+
+  /** Store the output in the sample container cache, as the samples of the grid with the given spacing. */
+  virtual void
+  AddOutputToSampleContainerCache(const typename ImageSampleContainerCacheType::SampleGridSpacingType & gridSpacing);
+
   /***/
   unsigned long                            m_NumberOfSamples;
   std::vector<ImageSampleContainerPointer> m_ThreaderSampleContainer;
@@ -226,6 +274,11 @@ protected:
   // tmp?
   bool m_UseMultiThread;
 
+  bool                           m_GenerateSoAOutput;
+  ImageSampleSoAContainerPointer m_SoAOutput;
+
+  typename ImageSampleContainerCacheType::Pointer m_SampleContainerCache;
+
 private:
   /** The deleted copy constructor. */
   ImageSamplerBase(const Self &) = delete;
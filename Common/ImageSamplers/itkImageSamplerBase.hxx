@@ -38,6 +38,10 @@ ImageSamplerBase<TInputImage>::ImageSamplerBase()
   // tmp?
   this->m_UseMultiThread = false;
 
+  this->m_GenerateSoAOutput = false;
+  this->m_SoAOutput = ImageSampleSoAContainerType::New();
+  this->m_SampleContainerCache = nullptr;
+
 } // end Constructor()
 
 
@@ -438,6 +442,83 @@ ImageSamplerBase<TInputImage>::AfterThreadedGenerateData(void)
 } // end AfterThreadedGenerateData()
 
 
+/**
+ * ******************* UpdateOutputData *******************
+ */
+
+template <class TInputImage>
+void
+ImageSamplerBase<TInputImage>::UpdateOutputData(DataObject * output)
+{
+  /** Generates the regular (array-of-structures) output. */
+  Superclass::UpdateOutputData(output);
+
+  if (this->m_GenerateSoAOutput)
+  {
+    this->GenerateSoAOutputData();
+  }
+
+} // end UpdateOutputData()
+
+
+/**
+ * ******************* GenerateSoAOutputData *******************
+ */
+
+template <class TInputImage>
+void
+ImageSamplerBase<TInputImage>::GenerateSoAOutputData(void)
+{
+  this->m_SoAOutput->CopyFrom(*this->GetOutput());
+
+} // end GenerateSoAOutputData()
+
+
+/**
+ * ******************* GetOutputFromSampleContainerCache *******************
+ */
+
+template <class TInputImage>
+bool
+ImageSamplerBase<TInputImage>::GetOutputFromSampleContainerCache(
+  const typename ImageSampleContainerCacheType::SampleGridSpacingType & gridSpacing)
+{
+  if (this->m_SampleContainerCache.IsNull())
+  {
+    return false;
+  }
+
+  /** Bring the mask up-to-date first, because its modified time is part of the key. */
+  const MaskType * mask = this->GetMask();
+  if (mask && mask->GetSource())
+  {
+    mask->GetSource()->Update();
+  }
+
+  return this->m_SampleContainerCache->GetSampleContainer(
+    this->GetInput(), mask, this->GetCroppedInputImageRegion(), gridSpacing, *this->GetOutput());
+
+} // end GetOutputFromSampleContainerCache()
+
+
+/**
+ * ******************* AddOutputToSampleContainerCache *******************
+ */
+
+template <class TInputImage>
+void
+ImageSamplerBase<TInputImage>::AddOutputToSampleContainerCache(
+  const typename ImageSampleContainerCacheType::SampleGridSpacingType & gridSpacing)
+{
+  if (this->m_SampleContainerCache.IsNotNull())
+  {
+    this->m_SampleContainerCache->AddSampleContainer(
+      this->GetInput(), this->GetMask(), this->GetCroppedInputImageRegion(), gridSpacing, *this->GetOutput());
+  }
+
+} // end AddOutputToSampleContainerCache()
+
+
 /**
  * ******************* PrintSelf *******************
  */
@@ -464,6 +545,8 @@ ImageSamplerBase<TInputImage>::PrintSelf(std::ostream & os, Indent indent) const
     os << indent.GetNextIndent() << this->m_InputImageRegionVector[i] << std::endl;
   }
   os << indent << "CroppedInputImageRegion" << this->m_CroppedInputImageRegion << std::endl;
+  os << indent << "GenerateSoAOutput: " << this->m_GenerateSoAOutput << std::endl;
+  os << indent << "SampleContainerCache: " << this->m_SampleContainerCache.GetPointer() << std::endl;
 
 } // end PrintSelf()
 
@@ -38,7 +38,7 @@ MultiInputImageRandomCoordinateSampler<TInputImage>::MultiInputImageRandomCoordi
   this->m_Interpolator = bsplineInterpolator;
 
   /** Setup the random generator. */
-  this->m_RandomGenerator = RandomGeneratorType::GetInstance();
+  this->m_RandomGenerator = RegistrationThreadState::GetRandomGenerator();
 
   this->m_UseRandomSampleRegion = false;
   this->m_SampleRegionSize.Fill(1.0);
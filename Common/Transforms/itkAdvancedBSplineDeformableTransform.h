@@ -236,6 +236,14 @@ public:
                  ParameterIndexArrayType & indices,
                  bool &                    inside) const;
 
+  /** Transform an array of points. Uses the same stack memory for all points,
+   * and converts blocks of points to continuous grid indices at once.
+   */
+  void
+  TransformPointBatch(const InputPointType * inputPoints,
+                      OutputPointType *      outputPoints,
+                      std::size_t            numberOfPoints) const override;
+
   /** Get number of weights. */
   unsigned long
   GetNumberOfWeights(void) const
@@ -250,10 +258,23 @@ public:
   NumberOfParametersType
   GetNumberOfNonZeroJacobianIndices(void) const override;
 
+  /** Compute the interpolation weights and the support region offset of a point. */
+  bool
+  ComputeWeightsAndSupportOffset(const InputPointType & point,
+                                 float *                weights,
+                                 OffsetValueType &      supportOffset) const override;
+
   /** Compute the Jacobian of the transformation. */
   void
   GetJacobian(const InputPointType & ipp, JacobianType & j, NonZeroJacobianIndicesType & nzji) const override;
 
+  /** Compute the Jacobian of the transformation for an array of points. */
+  void
+  GetJacobianBatch(const InputPointType *       inputPoints,
+                   JacobianType *               jacobians,
+                   NonZeroJacobianIndicesType * nonZeroJacobianIndices,
+                   std::size_t                  numberOfPoints) const override;
+
   /** Compute the inner product of the Jacobian with the moving image gradient.
    * The Jacobian is (partially) constructed inside this function, but not returned.
    */
@@ -322,6 +343,21 @@ protected:
   ComputeNonZeroJacobianIndices(NonZeroJacobianIndicesType & nonZeroJacobianIndices,
                                 const RegionType &           supportRegion) const override;
 
+  /** Helper functions for the single point and the batched versions of
+   * TransformPoint() and GetJacobian(), once the continuous grid index is known.
+   */
+  void
+  TransformPointInsideValidRegion(const InputPointType &      point,
+                                  const ContinuousIndexType & cindex,
+                                  OutputPointType &           outputPoint,
+                                  WeightsType &               weights,
+                                  ParameterIndexArrayType &   indices) const;
+
+  void
+  GetJacobianAtContinuousGridIndex(const ContinuousIndexType &  cindex,
+                                   JacobianType &               jacobian,
+                                   NonZeroJacobianIndicesType & nonZeroJacobianIndices) const;
+
   typedef typename Superclass::JacobianImageType JacobianImageType;
   typedef typename Superclass::JacobianPixelType JacobianPixelType;
 
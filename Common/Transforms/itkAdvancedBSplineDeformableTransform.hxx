@@ -247,6 +247,26 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::Tran
     return;
   }
 
+  this->TransformPointInsideValidRegion(point, cindex, outputPoint, weights, indices);
+
+} // end TransformPoint()
+
+
+/**
+ * ********************* TransformPointInsideValidRegion ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::TransformPointInsideValidRegion(
+  const InputPointType &      point,
+  const ContinuousIndexType & cindex,
+  OutputPointType &           outputPoint,
+  WeightsType &               weights,
+  ParameterIndexArrayType &   indices) const
+{
+  const InputPointType transformedPoint = point;
+
   // Compute interpolation weights
   IndexType supportIndex;
   this->m_WeightsFunction->ComputeStartIndex(cindex, supportIndex);
@@ -300,7 +320,7 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::Tran
     outputPoint[j] += transformedPoint[j];
   }
 
-} // end TransformPoint()
+} // end TransformPointInsideValidRegion()
 
 
 // Transform a point
@@ -325,6 +345,61 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::Tran
 }
 
 
+/**
+ * ********************* TransformPointBatch ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::TransformPointBatch(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  std::size_t            numberOfPoints) const
+{
+  /** Check if the coefficient image has been set. */
+  if (!this->m_CoefficientImages[0])
+  {
+    itkWarningMacro(<< "B-spline coefficients have not been set");
+    std::copy(inputPoints, inputPoints + numberOfPoints, outputPoints);
+    return;
+  }
+
+  /** Allocate memory on the stack, once for all points. */
+  const unsigned long                         numberOfWeights = WeightsFunctionType::NumberOfWeights;
+  typename WeightsType::ValueType             weightsArray[numberOfWeights];
+  typename ParameterIndexArrayType::ValueType indicesArray[numberOfWeights];
+  WeightsType                                 weights(weightsArray, numberOfWeights, false);
+  ParameterIndexArrayType                     indices(indicesArray, numberOfWeights, false);
+  ContinuousIndexType                         cindices[Self::BatchBlockSize];
+
+  /** Process the points in blocks. The conversion to continuous indices
+   * is done for a whole block at once.
+   */
+  for (std::size_t blockBegin = 0; blockBegin < numberOfPoints; blockBegin += Self::BatchBlockSize)
+  {
+    const std::size_t blockSize = std::min<std::size_t>(Self::BatchBlockSize, numberOfPoints - blockBegin);
+    this->TransformPointsToContinuousGridIndices(inputPoints + blockBegin, cindices, blockSize);
+
+    for (std::size_t i = 0; i < blockSize; ++i)
+    {
+      const InputPointType & point = inputPoints[blockBegin + i];
+      OutputPointType &      outputPoint = outputPoints[blockBegin + i];
+
+      // NOTE: if the support region does not lie totally within the grid
+      // we assume zero displacement and return the input point
+      if (!this->InsideValidRegion(cindices[i]))
+      {
+        outputPoint = point;
+        continue;
+      }
+
+      this->TransformPointInsideValidRegion(point, cindices[i], outputPoint, weights, indices);
+    }
+  }
+
+} // end TransformPointBatch()
+
+
 /**
  * ********************* GetNumberOfAffectedWeights ****************************
  */
@@ -375,6 +450,59 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::GetJ
   ContinuousIndexType cindex;
   this->TransformPointToContinuousGridIndex(ipp, cindex);
 
+  this->GetJacobianAtContinuousGridIndex(cindex, jacobian, nonZeroJacobianIndices);
+
+} // end GetJacobian()
+
+
+/**
+ * ********************* GetJacobianBatch ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::GetJacobianBatch(
+  const InputPointType *       inputPoints,
+  JacobianType *               jacobians,
+  NonZeroJacobianIndicesType * nonZeroJacobianIndices,
+  std::size_t                  numberOfPoints) const
+{
+  /** Sanity check. */
+  if (this->m_InputParametersPointer == nullptr)
+  {
+    itkExceptionMacro(<< "Cannot compute Jacobian: parameters not set");
+  }
+
+  /** Process the points in blocks. The conversion to continuous indices
+   * is done for a whole block at once.
+   */
+  ContinuousIndexType cindices[Self::BatchBlockSize];
+  for (std::size_t blockBegin = 0; blockBegin < numberOfPoints; blockBegin += Self::BatchBlockSize)
+  {
+    const std::size_t blockSize = std::min<std::size_t>(Self::BatchBlockSize, numberOfPoints - blockBegin);
+    this->TransformPointsToContinuousGridIndices(inputPoints + blockBegin, cindices, blockSize);
+
+    for (std::size_t i = 0; i < blockSize; ++i)
+    {
+      this->GetJacobianAtContinuousGridIndex(
+        cindices[i], jacobians[blockBegin + i], nonZeroJacobianIndices[blockBegin + i]);
+    }
+  }
+
+} // end GetJacobianBatch()
+
+
+/**
+ * ********************* GetJacobianAtContinuousGridIndex ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::GetJacobianAtContinuousGridIndex(
+  const ContinuousIndexType &  cindex,
+  JacobianType &               jacobian,
+  NonZeroJacobianIndicesType & nonZeroJacobianIndices) const
+{
   /** Initialize. */
   const NumberOfParametersType nnzji = this->GetNumberOfNonZeroJacobianIndices();
   if ((jacobian.cols() != nnzji) || (jacobian.rows() != SpaceDimension))
@@ -426,7 +554,7 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::GetJ
    */
   this->ComputeNonZeroJacobianIndices(nonZeroJacobianIndices, supportRegion);
 
-} // end GetJacobian()
+} // end GetJacobianAtContinuousGridIndex()
 
 
 /**
@@ -502,6 +630,53 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::Eval
 } // end EvaluateJacobianWithImageGradientProduct()
 
 
+/**
+ * ********************* ComputeWeightsAndSupportOffset ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+bool
+AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::ComputeWeightsAndSupportOffset(
+  const InputPointType & point,
+  float *                weights,
+  OffsetValueType &      supportOffset) const
+{
+  ContinuousIndexType cindex;
+  this->TransformPointToContinuousGridIndex(point, cindex);
+
+  /** NOTE: if the support region does not lie totally within the grid
+   * we assume zero displacement and zero Jacobian.
+   */
+  if (!this->InsideValidRegion(cindex))
+  {
+    return false;
+  }
+
+  /** Compute the B-spline weights on the stack. */
+  const unsigned long             numberOfWeights = WeightsFunctionType::NumberOfWeights;
+  typename WeightsType::ValueType weightsArray[numberOfWeights];
+  WeightsType                     weightsInternal(weightsArray, numberOfWeights, false);
+
+  IndexType supportIndex;
+  this->m_WeightsFunction->ComputeStartIndex(cindex, supportIndex);
+  this->m_WeightsFunction->Evaluate(cindex, supportIndex, weightsInternal);
+
+  for (unsigned long i = 0; i < numberOfWeights; ++i)
+  {
+    weights[i] = static_cast<float>(weightsArray[i]);
+  }
+
+  /** The offset of the first coefficient, like in ComputeNonZeroJacobianIndices(). */
+  supportOffset = 0;
+  for (unsigned int dim = 0; dim < SpaceDimension; ++dim)
+  {
+    supportOffset += supportIndex[dim] * this->m_GridOffsetTable[dim];
+  }
+  return true;
+
+} // end ComputeWeightsAndSupportOffset()
+
+
 /**
  * ********************* GetSpatialJacobian ****************************
  */
@@ -22,6 +22,8 @@
 #include "itkImage.h"
 #include "itkImageRegion.h"
 
+#include <vector>
+
 namespace itk
 {
 
@@ -293,6 +295,34 @@ public:
   NumberOfParametersType
   GetNumberOfNonZeroJacobianIndices(void) const override = 0;
 
+  /** Compute the interpolation weights at a point, in the order of the nonzero Jacobian
+   * indices, and the offset of the first coefficient of the support region in the
+   * coefficient images. Returns false, without computing the weights, when the support
+   * region does not lie totally within the grid. Together with GetSupportOffsets(), this
+   * allows callers to store the weights of points that do not change, like the fixed image
+   * samples of a registration, and to evaluate the transform by a gather of coefficients.
+   */
+  virtual bool
+  ComputeWeightsAndSupportOffset(const InputPointType & point,
+                                 float *                weights,
+                                 OffsetValueType &      supportOffset) const = 0;
+
+  /** Get the offsets of all coefficients of a support region in the coefficient images,
+   * relative to the first coefficient of the support region, in the order of the weights.
+   */
+  void
+  GetSupportOffsets(std::vector<OffsetValueType> & supportOffsets) const;
+
+  /** Returns whether the coefficients of a support region can be found by the offsets
+   * of GetSupportOffsets(). False for transforms whose support region wraps around the grid.
+   */
+  virtual bool
+  GetSupportRegionIsContiguous(void) const
+  {
+    return true;
+  }
+
+
   /** This typedef should be equal to the typedef used
    * in derived classes based on the weights function.
    */
@@ -314,6 +344,15 @@ protected:
   void
   TransformPointToContinuousGridIndex(const InputPointType & point, ContinuousIndexType & index) const;
 
+  /** Convert an array of input points to continuous indices inside the B-spline grid.
+   * Equivalent to calling TransformPointToContinuousGridIndex() for each point,
+   * but the conversion matrix is only loaded once.
+   */
+  void
+  TransformPointsToContinuousGridIndices(const InputPointType * points,
+                                         ContinuousIndexType *  indices,
+                                         std::size_t            numberOfPoints) const;
+
   void
   UpdatePointIndexConversions(void);
 
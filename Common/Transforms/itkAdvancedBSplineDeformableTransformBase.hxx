@@ -562,6 +562,48 @@ AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::InsideValidReg
 }
 
 
+/**
+ * ********************* GetSupportOffsets ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions>
+void
+AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::GetSupportOffsets(
+  std::vector<OffsetValueType> & supportOffsets) const
+{
+  /** Loop over the support region in the same order as the weights, which is
+   * the order of the ImageScanlineConstIterator: x fastest.
+   */
+  SizeValueType numberOfSupportPoints = 1;
+  for (unsigned int dim = 0; dim < SpaceDimension; ++dim)
+  {
+    numberOfSupportPoints *= this->m_SupportSize[dim];
+  }
+  supportOffsets.resize(numberOfSupportPoints);
+
+  IndexType localIndex;
+  localIndex.Fill(0);
+  for (OffsetValueType & supportOffset : supportOffsets)
+  {
+    supportOffset = 0;
+    for (unsigned int dim = 0; dim < SpaceDimension; ++dim)
+    {
+      supportOffset += localIndex[dim] * this->m_GridOffsetTable[dim];
+    }
+
+    for (unsigned int dim = 0; dim < SpaceDimension; ++dim)
+    {
+      if (static_cast<SizeValueType>(++localIndex[dim]) < this->m_SupportSize[dim])
+      {
+        break;
+      }
+      localIndex[dim] = 0;
+    }
+  }
+
+} // end GetSupportOffsets()
+
+
 template <class TScalarType, unsigned int NDimensions>
 void
 AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::TransformPointToContinuousGridIndex(
@@ -584,6 +626,45 @@ AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::TransformPoint
 }
 
 
+template <class TScalarType, unsigned int NDimensions>
+void
+AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::TransformPointsToContinuousGridIndices(
+  const InputPointType * points,
+  ContinuousIndexType *  indices,
+  std::size_t            numberOfPoints) const
+{
+  double matrix[SpaceDimension][SpaceDimension];
+  double origin[SpaceDimension];
+  for (unsigned int i = 0; i < SpaceDimension; i++)
+  {
+    for (unsigned int j = 0; j < SpaceDimension; j++)
+    {
+      matrix[i][j] = this->m_PointToIndexMatrix(i, j);
+    }
+    origin[i] = this->m_GridOrigin[i];
+  }
+
+  for (std::size_t p = 0; p < numberOfPoints; p++)
+  {
+    double tvector[SpaceDimension];
+    for (unsigned int j = 0; j < SpaceDimension; j++)
+    {
+      tvector[j] = points[p][j] - origin[j];
+    }
+
+    for (unsigned int i = 0; i < SpaceDimension; i++)
+    {
+      double cvalue = 0.0;
+      for (unsigned int j = 0; j < SpaceDimension; j++)
+      {
+        cvalue += matrix[i][j] * tvector[j];
+      }
+      indices[p][i] = static_cast<typename ContinuousIndexType::CoordRepType>(cvalue);
+    }
+  }
+}
+
+
 } // namespace itk
 
 #endif
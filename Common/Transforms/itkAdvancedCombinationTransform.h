@@ -231,6 +231,16 @@ public:
   bool
   GetInverse(Self * inverse) const;
 
+  /** Return whether TransformPoint() is exactly the combination of the initial and
+   * current transform. Subclasses that add a deformation of their own, like the
+   * DeformationFieldRegulizer, return false.
+   */
+  virtual bool
+  GetTransformPointIsCombination(void) const
+  {
+    return true;
+  }
+
   /** Return whether the transform is linear (or actually: affine)
    * Returns true when both initial and current transform are linear */
   bool
@@ -267,6 +277,26 @@ public:
   void
   GetSpatialJacobian(const InputPointType & ipp, SpatialJacobianType & sj) const override;
 
+  /** Batched versions of TransformPoint(), GetJacobian() and GetSpatialJacobian().
+   * The combination method is selected once for all points, and the batched
+   * functions of the initial and current transform are called per block of points.
+   */
+  void
+  TransformPointBatch(const InputPointType * inputPoints,
+                      OutputPointType *      outputPoints,
+                      std::size_t            numberOfPoints) const override;
+
+  void
+  GetJacobianBatch(const InputPointType *       inputPoints,
+                   JacobianType *               jacobians,
+                   NonZeroJacobianIndicesType * nonZeroJacobianIndices,
+                   std::size_t                  numberOfPoints) const override;
+
+  void
+  GetSpatialJacobianBatch(const InputPointType * inputPoints,
+                          SpatialJacobianType *  spatialJacobians,
+                          std::size_t            numberOfPoints) const override;
+
   /** Compute the spatial Hessian of the transformation. */
   void
   GetSpatialHessian(const InputPointType & ipp, SpatialHessianType & sh) const override;
@@ -20,6 +20,8 @@
 
 #include "itkAdvancedCombinationTransform.h"
 
+#include <algorithm> // For std::min.
+
 namespace itk
 {
 
@@ -1621,6 +1623,168 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianOfSpatialHess
 } // end GetJacobianOfSpatialHessian()
 
 
+/**
+ *
+ * ***********************************************************
+ * ***** Batched functions, which select the combination
+ * ***** method once for all points.
+ *
+ * ***********************************************************
+ *
+ */
+
+/**
+ * ****************** TransformPointBatch ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::TransformPointBatch(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  std::size_t            numberOfPoints) const
+{
+  if (this->m_CurrentTransform.IsNull())
+  {
+    this->NoCurrentTransformSet();
+  }
+
+  /** CURRENT ONLY: T(x) = T_1(x) */
+  if (this->m_InitialTransform.IsNull())
+  {
+    this->m_CurrentTransform->TransformPointBatch(inputPoints, outputPoints, numberOfPoints);
+    return;
+  }
+
+  OutputPointType initialOutputPoints[Self::BatchBlockSize];
+  for (std::size_t blockBegin = 0; blockBegin < numberOfPoints; blockBegin += Self::BatchBlockSize)
+  {
+    const std::size_t      blockSize = std::min<std::size_t>(Self::BatchBlockSize, numberOfPoints - blockBegin);
+    const InputPointType * blockInputPoints = inputPoints + blockBegin;
+    OutputPointType *      blockOutputPoints = outputPoints + blockBegin;
+
+    this->m_InitialTransform->TransformPointBatch(blockInputPoints, initialOutputPoints, blockSize);
+
+    if (this->m_UseAddition)
+    {
+      /** ADDITION: T(x) = T_0(x) + T_1(x) - x */
+      this->m_CurrentTransform->TransformPointBatch(blockInputPoints, blockOutputPoints, blockSize);
+      for (std::size_t i = 0; i < blockSize; ++i)
+      {
+        for (unsigned int d = 0; d < SpaceDimension; ++d)
+        {
+          blockOutputPoints[i][d] += (initialOutputPoints[i][d] - blockInputPoints[i][d]);
+        }
+      }
+    }
+    else
+    {
+      /** COMPOSITION: T(x) = T_1( T_0(x) ) */
+      this->m_CurrentTransform->TransformPointBatch(initialOutputPoints, blockOutputPoints, blockSize);
+    }
+  }
+
+} // end TransformPointBatch()
+
+
+/**
+ * ****************** GetJacobianBatch ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianBatch(
+  const InputPointType *       inputPoints,
+  JacobianType *               jacobians,
+  NonZeroJacobianIndicesType * nonZeroJacobianIndices,
+  std::size_t                  numberOfPoints) const
+{
+  if (this->m_CurrentTransform.IsNull())
+  {
+    this->NoCurrentTransformSet();
+  }
+
+  /** CURRENT ONLY and ADDITION: J(x) = J_1(x) */
+  if (this->m_InitialTransform.IsNull() || this->m_UseAddition)
+  {
+    this->m_CurrentTransform->GetJacobianBatch(inputPoints, jacobians, nonZeroJacobianIndices, numberOfPoints);
+    return;
+  }
+
+  /** COMPOSITION: J(x) = J_1( T_0(x) ) */
+  OutputPointType initialOutputPoints[Self::BatchBlockSize];
+  for (std::size_t blockBegin = 0; blockBegin < numberOfPoints; blockBegin += Self::BatchBlockSize)
+  {
+    const std::size_t blockSize = std::min<std::size_t>(Self::BatchBlockSize, numberOfPoints - blockBegin);
+
+    this->m_InitialTransform->TransformPointBatch(inputPoints + blockBegin, initialOutputPoints, blockSize);
+    this->m_CurrentTransform->GetJacobianBatch(
+      initialOutputPoints, jacobians + blockBegin, nonZeroJacobianIndices + blockBegin, blockSize);
+  }
+
+} // end GetJacobianBatch()
+
+
+/**
+ * ****************** GetSpatialJacobianBatch ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::GetSpatialJacobianBatch(
+  const InputPointType * inputPoints,
+  SpatialJacobianType *  spatialJacobians,
+  std::size_t            numberOfPoints) const
+{
+  if (this->m_CurrentTransform.IsNull())
+  {
+    this->NoCurrentTransformSet();
+  }
+
+  /** CURRENT ONLY: sJ(x) = sJ_1(x) */
+  if (this->m_InitialTransform.IsNull())
+  {
+    this->m_CurrentTransform->GetSpatialJacobianBatch(inputPoints, spatialJacobians, numberOfPoints);
+    return;
+  }
+
+  SpatialJacobianType identity;
+  identity.SetIdentity();
+
+  SpatialJacobianType initialSpatialJacobians[Self::BatchBlockSize];
+  OutputPointType     initialOutputPoints[Self::BatchBlockSize];
+  for (std::size_t blockBegin = 0; blockBegin < numberOfPoints; blockBegin += Self::BatchBlockSize)
+  {
+    const std::size_t      blockSize = std::min<std::size_t>(Self::BatchBlockSize, numberOfPoints - blockBegin);
+    const InputPointType * blockInputPoints = inputPoints + blockBegin;
+    SpatialJacobianType *  blockSpatialJacobians = spatialJacobians + blockBegin;
+
+    this->m_InitialTransform->GetSpatialJacobianBatch(blockInputPoints, initialSpatialJacobians, blockSize);
+
+    if (this->m_UseAddition)
+    {
+      /** ADDITION: sJ(x) = sJ_0(x) + sJ_1(x) - I */
+      this->m_CurrentTransform->GetSpatialJacobianBatch(blockInputPoints, blockSpatialJacobians, blockSize);
+      for (std::size_t i = 0; i < blockSize; ++i)
+      {
+        blockSpatialJacobians[i] = initialSpatialJacobians[i] + blockSpatialJacobians[i] - identity;
+      }
+    }
+    else
+    {
+      /** COMPOSITION: sJ(x) = sJ_1( T_0(x) ) * sJ_0(x) */
+      this->m_InitialTransform->TransformPointBatch(blockInputPoints, initialOutputPoints, blockSize);
+      this->m_CurrentTransform->GetSpatialJacobianBatch(initialOutputPoints, blockSpatialJacobians, blockSize);
+      for (std::size_t i = 0; i < blockSize; ++i)
+      {
+        blockSpatialJacobians[i] = blockSpatialJacobians[i] * initialSpatialJacobians[i];
+      }
+    }
+  }
+
+} // end GetSpatialJacobianBatch()
+
+
 } // end namespace itk
 
 #endif // end #ifndef itkAdvancedCombinationTransform_hxx
@@ -412,6 +412,19 @@ public:
   void
   GetSpatialJacobian(const InputPointType &, SpatialJacobianType &) const override;
 
+  /** Batched versions of TransformPoint() and GetSpatialJacobian(). GetJacobian()
+   * is not batched here, because subclasses override it for their own parameterization.
+   */
+  void
+  TransformPointBatch(const InputPointType * inputPoints,
+                      OutputPointType *      outputPoints,
+                      std::size_t            numberOfPoints) const override;
+
+  void
+  GetSpatialJacobianBatch(const InputPointType * inputPoints,
+                          SpatialJacobianType *  spatialJacobians,
+                          std::size_t            numberOfPoints) const override;
+
   /** Compute the spatial Hessian of the transformation. */
   void
   GetSpatialHessian(const InputPointType &, SpatialHessianType &) const override;
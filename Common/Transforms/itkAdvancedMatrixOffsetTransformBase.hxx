@@ -39,6 +39,8 @@
 #include "itkAdvancedMatrixOffsetTransformBase.h"
 #include "vnl/algo/vnl_matrix_inverse.h"
 
+#include <algorithm> // For std::fill.
+
 namespace itk
 {
 
@@ -571,6 +573,66 @@ AdvancedMatrixOffsetTransformBase<TScalarType, NInputDimensions, NOutputDimensio
 } // end GetSpatialJacobian()
 
 
+/**
+ * ********************* TransformPointBatch ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedMatrixOffsetTransformBase<TScalarType, NInputDimensions, NOutputDimensions>::TransformPointBatch(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  std::size_t            numberOfPoints) const
+{
+  /** Copy the matrix and the offset to plain arrays, so that the compiler
+   * can keep them in registers and vectorize the loop over the points.
+   */
+  ScalarType matrix[NOutputDimensions][NInputDimensions];
+  ScalarType offset[NOutputDimensions];
+  for (unsigned int i = 0; i < NOutputDimensions; ++i)
+  {
+    for (unsigned int j = 0; j < NInputDimensions; ++j)
+    {
+      matrix[i][j] = this->m_Matrix(i, j);
+    }
+    offset[i] = this->m_Offset[i];
+  }
+
+  for (std::size_t p = 0; p < numberOfPoints; ++p)
+  {
+    const InputPointType & inputPoint = inputPoints[p];
+    OutputPointType &      outputPoint = outputPoints[p];
+    for (unsigned int i = 0; i < NOutputDimensions; ++i)
+    {
+      ScalarType value = NumericTraits<ScalarType>::ZeroValue();
+      for (unsigned int j = 0; j < NInputDimensions; ++j)
+      {
+        value += matrix[i][j] * inputPoint[j];
+      }
+      outputPoint[i] = value + offset[i];
+    }
+  }
+
+} // end TransformPointBatch()
+
+
+/**
+ * ********************* GetSpatialJacobianBatch ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedMatrixOffsetTransformBase<TScalarType, NInputDimensions, NOutputDimensions>::GetSpatialJacobianBatch(
+  const InputPointType *,
+  SpatialJacobianType * spatialJacobians,
+  std::size_t           numberOfPoints) const
+{
+  /** The spatial Jacobian does not depend on the point. */
+  std::fill(spatialJacobians, spatialJacobians + numberOfPoints, this->GetMatrix());
+
+} // end GetSpatialJacobianBatch()
+
+
 /**
  * ********************* GetSpatialHessian ****************************
  */
@@ -222,6 +222,36 @@ public:
   virtual void
   GetSpatialJacobian(const InputPointType & ipp, SpatialJacobianType & sj) const = 0;
 
+  /** The number of points that subclasses process at once in their batched
+   * functions, when they need temporary arrays on the stack.
+   */
+  itkStaticConstMacro(BatchBlockSize, unsigned int, 64);
+
+  /** Batched versions of TransformPoint(), GetJacobian() and GetSpatialJacobian().
+   *
+   * These functions evaluate the transform for an array of numberOfPoints input
+   * points, and write the results to the output arrays, which should have room
+   * for at least numberOfPoints elements. The input and output arrays may not
+   * overlap. The default implementations simply call the single point version
+   * for each point. Subclasses can override them to avoid the per point
+   * overhead, e.g. of virtual function calls and repeated setup.
+   */
+  virtual void
+  TransformPointBatch(const InputPointType * inputPoints,
+                      OutputPointType *      outputPoints,
+                      std::size_t            numberOfPoints) const;
+
+  virtual void
+  GetJacobianBatch(const InputPointType *       inputPoints,
+                   JacobianType *               jacobians,
+                   NonZeroJacobianIndicesType * nonZeroJacobianIndices,
+                   std::size_t                  numberOfPoints) const;
+
+  virtual void
+  GetSpatialJacobianBatch(const InputPointType * inputPoints,
+                          SpatialJacobianType *  spatialJacobians,
+                          std::size_t            numberOfPoints) const;
+
   /** Override some pure virtual ITK4 functions. */
   void
   ComputeJacobianWithRespectToParameters(const InputPointType & itkNotUsed(p),
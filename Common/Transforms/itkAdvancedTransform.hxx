@@ -106,6 +106,64 @@ AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::EvaluateJac
 } // end EvaluateJacobianWithImageGradientProduct()
 
 
+/**
+ * ********************* TransformPointBatch ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::TransformPointBatch(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  std::size_t            numberOfPoints) const
+{
+  for (std::size_t i = 0; i < numberOfPoints; ++i)
+  {
+    outputPoints[i] = this->TransformPoint(inputPoints[i]);
+  }
+
+} // end TransformPointBatch()
+
+
+/**
+ * ********************* GetJacobianBatch ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::GetJacobianBatch(
+  const InputPointType *       inputPoints,
+  JacobianType *               jacobians,
+  NonZeroJacobianIndicesType * nonZeroJacobianIndices,
+  std::size_t                  numberOfPoints) const
+{
+  for (std::size_t i = 0; i < numberOfPoints; ++i)
+  {
+    this->GetJacobian(inputPoints[i], jacobians[i], nonZeroJacobianIndices[i]);
+  }
+
+} // end GetJacobianBatch()
+
+
+/**
+ * ********************* GetSpatialJacobianBatch ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::GetSpatialJacobianBatch(
+  const InputPointType * inputPoints,
+  SpatialJacobianType *  spatialJacobians,
+  std::size_t            numberOfPoints) const
+{
+  for (std::size_t i = 0; i < numberOfPoints; ++i)
+  {
+    this->GetSpatialJacobian(inputPoints[i], spatialJacobians[i]);
+  }
+
+} // end GetSpatialJacobianBatch()
+
+
 /**
  * ********************* GetNumberOfNonZeroJacobianIndices ****************************
  */
@@ -118,6 +118,14 @@ public:
                  ParameterIndexArrayType & indices,
                  bool &                    inside) const override;
 
+  /** Transform an array of points. Overridden to use the cyclic TransformPoint()
+   * for each point, instead of the block implementation of the superclass.
+   */
+  void
+  TransformPointBatch(const InputPointType * inputPoints,
+                      OutputPointType *      outputPoints,
+                      std::size_t            numberOfPoints) const override;
+
   /** Compute the Jacobian of the transformation. */
   virtual void
   GetJacobian(const InputPointType & ipp, WeightsType & weights, ParameterIndexArrayType & indices) const;
@@ -126,6 +134,14 @@ public:
   void
   GetSpatialJacobian(const InputPointType & ipp, SpatialJacobianType & sj) const override;
 
+  /** The support region may wrap around the last dimension of the grid. */
+  bool
+  GetSupportRegionIsContiguous(void) const override
+  {
+    return false;
+  }
+
+
 protected:
   CyclicBSplineDeformableTransform();
   ~CyclicBSplineDeformableTransform() override;
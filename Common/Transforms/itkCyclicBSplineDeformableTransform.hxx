@@ -234,6 +234,29 @@ CyclicBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::Transf
 }
 
 
+/** Transform an array of points. */
+template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+CyclicBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::TransformPointBatch(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  std::size_t            numberOfPoints) const
+{
+  /** Allocate memory on the stack, once for all points. */
+  const unsigned long                         numberOfWeights = WeightsFunctionType::NumberOfWeights;
+  typename WeightsType::ValueType             weightsArray[numberOfWeights];
+  typename ParameterIndexArrayType::ValueType indicesArray[numberOfWeights];
+  WeightsType                                 weights(weightsArray, numberOfWeights, false);
+  ParameterIndexArrayType                     indices(indicesArray, numberOfWeights, false);
+  bool                                        inside;
+
+  for (std::size_t i = 0; i < numberOfPoints; ++i)
+  {
+    this->TransformPoint(inputPoints[i], outputPoints[i], weights, indices, inside);
+  }
+}
+
+
 /** Compute the Jacobian in one position. */
 template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
 void
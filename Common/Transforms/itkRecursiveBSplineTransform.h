@@ -21,6 +21,7 @@
 #include "itkAdvancedBSplineDeformableTransform.h"
 
 #include "itkRecursiveBSplineInterpolationWeightFunction.h"
+#include "itkRecursiveBSplineTransformVectorizedImplementation.h"
 
 namespace itk
 {
@@ -119,6 +120,21 @@ public:
   typedef BSplineSecondOrderDerivativeKernelFunction2<itkGetStaticConstMacro(SplineOrder)>
     SecondOrderDerivativeKernelType;
 
+  /** The implementation of the recursive B-spline evaluation. For the 3D cubic
+   * B-spline it is explicitly vectorized, otherwise it is the recursive scalar one.
+   */
+  typedef RecursiveBSplineTransformVectorizedImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalarType>
+    ImplementationType;
+  typedef typename ImplementationType::InstructionSetType InstructionSetType;
+
+  /** Set/Get whether the explicitly vectorized (AVX2 or AVX-512) implementation
+   * is used, if it exists for this transform and the processor supports it.
+   * Otherwise the recursive scalar implementation is used. Default: true.
+   */
+  itkSetMacro(UseVectorizedImplementation, bool);
+  itkGetConstMacro(UseVectorizedImplementation, bool);
+  itkBooleanMacro(UseVectorizedImplementation);
+
   /** Interpolation kernel. */
   typename KernelType::Pointer                      m_Kernel;
   typename DerivativeKernelType::Pointer            m_DerivativeKernel;
@@ -131,12 +147,28 @@ public:
   OutputPointType
   TransformPoint(const InputPointType & point) const override;
 
+  /** Transform an array of points, with the recursive implementation.
+   * The weights memory, the coefficient buffer pointers and the offset table
+   * are set up once for all points.
+   */
+  void
+  TransformPointBatch(const InputPointType * inputPoints,
+                      OutputPointType *      outputPoints,
+                      std::size_t            numberOfPoints) const override;
+
   /** Compute the Jacobian of the transformation. */
   void
   GetJacobian(const InputPointType &       ipp,
               JacobianType &               j,
               NonZeroJacobianIndicesType & nonZeroJacobianIndices) const override;
 
+  /** Compute the Jacobian of the transformation for an array of points. */
+  void
+  GetJacobianBatch(const InputPointType *       inputPoints,
+                   JacobianType *               jacobians,
+                   NonZeroJacobianIndicesType * nonZeroJacobianIndices,
+                   std::size_t                  numberOfPoints) const override;
+
   /** Compute the inner product of the Jacobian with the moving image gradient.
    * The Jacobian is (partially) constructed inside this function, but not returned.
    */
@@ -193,15 +225,33 @@ protected:
 
   typename RecursiveBSplineWeightFunctionType::Pointer m_RecursiveBSplineWeightFunction;
 
+  /** The instruction set that is passed to the ImplementationType functions. */
+  InstructionSetType
+  GetImplementationInstructionSet(void) const
+  {
+    return this->m_UseVectorizedImplementation ? ImplementationType::GetInstructionSet() : ImplementationType::Scalar;
+  }
+
+
   /** Compute the nonzero Jacobian indices. */
   void
   ComputeNonZeroJacobianIndices(NonZeroJacobianIndicesType & nonZeroJacobianIndices,
                                 const RegionType &           supportRegion) const override;
 
+  /** Helper function for GetJacobian() and GetJacobianBatch(), once the
+   * continuous grid index is known.
+   */
+  void
+  GetJacobianAtContinuousGridIndex(const ContinuousIndexType &  cindex,
+                                   JacobianType &               jacobian,
+                                   NonZeroJacobianIndicesType & nonZeroJacobianIndices) const;
+
 private:
   RecursiveBSplineTransform(const Self &) = delete;
   void
   operator=(const Self &) = delete;
+
+  bool m_UseVectorizedImplementation;
 };
 
 } // end namespace itk
@@ -20,7 +20,7 @@
 
 #include "itkRecursiveBSplineTransform.h"
 
-#include "itkRecursiveBSplineTransformImplementation.h"
+#include <algorithm> // For std::copy and std::min.
 
 
 namespace itk
@@ -38,6 +38,7 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::RecursiveBSplineT
   this->m_Kernel = KernelType::New();
   this->m_DerivativeKernel = DerivativeKernelType::New();
   this->m_SecondOrderDerivativeKernel = SecondOrderDerivativeKernelType::New();
+  this->m_UseVectorizedImplementation = true;
 } // end Constructor()
 
 
@@ -98,10 +99,10 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::TransformPoint(co
     mu[j] = this->m_CoefficientImages[j]->GetBufferPointer() + totalOffsetToSupportIndex;
   }
 
-  /** Call the recursive TransformPoint function. */
+  /** Call the (vectorized) recursive TransformPoint function. */
   ScalarType displacement[SpaceDimension];
-  RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::TransformPoint(
-    displacement, mu, bsplineOffsetTable, weightsArray1D);
+  ImplementationType::TransformPoint(
+    displacement, mu, bsplineOffsetTable, weightsArray1D, this->GetImplementationInstructionSet());
 
   // The output point is the start point + displacement.
   for (unsigned int j = 0; j < SpaceDimension; ++j)
@@ -113,6 +114,92 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::TransformPoint(co
 } // end TransformPoint()
 
 
+/**
+ * ********************* TransformPointBatch ****************************
+ */
+
+template <class TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::TransformPointBatch(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  std::size_t            numberOfPoints) const
+{
+  /** Check if the coefficient image has been set. */
+  if (!this->m_CoefficientImages[0])
+  {
+    itkWarningMacro(<< "B-spline coefficients have not been set");
+    std::copy(inputPoints, inputPoints + numberOfPoints, outputPoints);
+    return;
+  }
+
+  /** Allocate weights on the stack, once for all points. */
+  const unsigned int              numberOfWeights = RecursiveBSplineWeightFunctionType::NumberOfWeights;
+  typename WeightsType::ValueType weightsArray1D[numberOfWeights];
+  WeightsType                     weights1D(weightsArray1D, numberOfWeights, false);
+
+  /** Initialize (helper) variables that do not depend on the point. */
+  const InstructionSetType instructionSet = this->GetImplementationInstructionSet();
+  const OffsetValueType *  bsplineOffsetTable = this->m_CoefficientImages[0]->GetOffsetTable();
+  ScalarType *             basePointers[SpaceDimension];
+  for (unsigned int j = 0; j < SpaceDimension; ++j)
+  {
+    basePointers[j] = this->m_CoefficientImages[j]->GetBufferPointer();
+  }
+
+  /** Process the points in blocks. The conversion to continuous indices
+   * is done for a whole block at once.
+   */
+  ContinuousIndexType cindices[Self::BatchBlockSize];
+  for (std::size_t blockBegin = 0; blockBegin < numberOfPoints; blockBegin += Self::BatchBlockSize)
+  {
+    const std::size_t blockSize = std::min<std::size_t>(Self::BatchBlockSize, numberOfPoints - blockBegin);
+    this->TransformPointsToContinuousGridIndices(inputPoints + blockBegin, cindices, blockSize);
+
+    for (std::size_t i = 0; i < blockSize; ++i)
+    {
+      const InputPointType & point = inputPoints[blockBegin + i];
+      OutputPointType &      outputPoint = outputPoints[blockBegin + i];
+
+      // NOTE: if the support region does not lie totally within the grid
+      // we assume zero displacement and return the input point
+      if (!this->InsideValidRegion(cindices[i]))
+      {
+        outputPoint = point;
+        continue;
+      }
+
+      // Compute interpolation weighs and store them in weights1D
+      IndexType supportIndex;
+      this->m_RecursiveBSplineWeightFunction->Evaluate(cindices[i], weights1D, supportIndex);
+
+      OffsetValueType totalOffsetToSupportIndex = 0;
+      for (unsigned int j = 0; j < SpaceDimension; ++j)
+      {
+        totalOffsetToSupportIndex += supportIndex[j] * bsplineOffsetTable[j];
+      }
+
+      ScalarType * mu[SpaceDimension];
+      for (unsigned int j = 0; j < SpaceDimension; ++j)
+      {
+        mu[j] = basePointers[j] + totalOffsetToSupportIndex;
+      }
+
+      /** Call the (vectorized) recursive TransformPoint function. */
+      ScalarType displacement[SpaceDimension];
+      ImplementationType::TransformPoint(displacement, mu, bsplineOffsetTable, weightsArray1D, instructionSet);
+
+      // The output point is the start point + displacement.
+      for (unsigned int j = 0; j < SpaceDimension; ++j)
+      {
+        outputPoint[j] = displacement[j] + point[j];
+      }
+    }
+  }
+
+} // end TransformPointBatch()
+
+
 /**
  * ********************* GetJacobian ****************************
  */
@@ -130,6 +217,53 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetJacobian(
   ContinuousIndexType cindex;
   this->TransformPointToContinuousGridIndex(ipp, cindex);
 
+  this->GetJacobianAtContinuousGridIndex(cindex, jacobian, nonZeroJacobianIndices);
+
+} // end GetJacobian()
+
+
+/**
+ * ********************* GetJacobianBatch ****************************
+ */
+
+template <class TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetJacobianBatch(
+  const InputPointType *       inputPoints,
+  JacobianType *               jacobians,
+  NonZeroJacobianIndicesType * nonZeroJacobianIndices,
+  std::size_t                  numberOfPoints) const
+{
+  /** Process the points in blocks. The conversion to continuous indices
+   * is done for a whole block at once.
+   */
+  ContinuousIndexType cindices[Self::BatchBlockSize];
+  for (std::size_t blockBegin = 0; blockBegin < numberOfPoints; blockBegin += Self::BatchBlockSize)
+  {
+    const std::size_t blockSize = std::min<std::size_t>(Self::BatchBlockSize, numberOfPoints - blockBegin);
+    this->TransformPointsToContinuousGridIndices(inputPoints + blockBegin, cindices, blockSize);
+
+    for (std::size_t i = 0; i < blockSize; ++i)
+    {
+      this->GetJacobianAtContinuousGridIndex(
+        cindices[i], jacobians[blockBegin + i], nonZeroJacobianIndices[blockBegin + i]);
+    }
+  }
+
+} // end GetJacobianBatch()
+
+
+/**
+ * ********************* GetJacobianAtContinuousGridIndex ****************************
+ */
+
+template <class TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetJacobianAtContinuousGridIndex(
+  const ContinuousIndexType &  cindex,
+  JacobianType &               jacobian,
+  NonZeroJacobianIndicesType & nonZeroJacobianIndices) const
+{
   /** Initialize. */
   const NumberOfParametersType nnzji = this->GetNumberOfNonZeroJacobianIndices();
   if ((jacobian.cols() != nnzji) || (jacobian.rows() != SpaceDimension))
@@ -163,11 +297,8 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetJacobian(
 
   /** Recursively compute the first numberOfIndices entries of the Jacobian.
    * They are directly written in the Jacobian matrix memory block.
-   * The pointer has changed after this function call.
    */
-  ParametersValueType * jacobianPointer = jacobian.data_block();
-  RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::GetJacobian(
-    jacobianPointer, weightsArray1D, 1.0);
+  ImplementationType::GetJacobian(jacobian.data_block(), weightsArray1D, this->GetImplementationInstructionSet());
 
   /** Compute the nonzero Jacobian indices.
    * Takes a significant portion of the computation time of this function.
@@ -177,7 +308,7 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetJacobian(
   supportRegion.SetIndex(supportIndex);
   this->ComputeNonZeroJacobianIndices(nonZeroJacobianIndices, supportRegion);
 
-} // end GetJacobian()
+} // end GetJacobianAtContinuousGridIndex()
 
 
 /**
@@ -222,18 +353,15 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::EvaluateJacobianW
   IndexType                       supportIndex;
   this->m_RecursiveBSplineWeightFunction->Evaluate(cindex, weights1D, supportIndex);
 
-  /** Recursively compute the inner product of the Jacobian and the moving image gradient.
-   * The pointer has changed after this function call.
-   */
+  /** Recursively compute the inner product of the Jacobian and the moving image gradient. */
   // ParametersValueType migArray[ SpaceDimension ];
   double migArray[SpaceDimension]; // InternalFloatType
   for (unsigned int j = 0; j < SpaceDimension; ++j)
   {
     migArray[j] = movingImageGradient[j];
   }
-  ParametersValueType * imageJacobianPointer = imageJacobian.data_block();
-  RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::
-    EvaluateJacobianWithImageGradientProduct(imageJacobianPointer, migArray, weightsArray1D, 1.0);
+  ImplementationType::EvaluateJacobianWithImageGradientProduct(
+    imageJacobian.data_block(), migArray, weightsArray1D, this->GetImplementationInstructionSet());
 
   /** Setup support region needed for the nonZeroJacobianIndices. */
   RegionType supportRegion;
@@ -306,8 +434,12 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetSpatialJacobia
 
   /** Recursively compute the spatial Jacobian. */
   double spatialJacobian[SpaceDimension * (SpaceDimension + 1)]; // double
-  RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::GetSpatialJacobian(
-    spatialJacobian, mu, bsplineOffsetTable, weightsPointer, derivativeWeightsPointer);
+  ImplementationType::GetSpatialJacobian(spatialJacobian,
+                                         mu,
+                                         bsplineOffsetTable,
+                                         weightsPointer,
+                                         derivativeWeightsPointer,
+                                         this->GetImplementationInstructionSet());
 
   /** Copy the correct elements to the spatial Jacobian.
    * The first SpaceDimension elements are actually the displacement, i.e. the recursive
@@ -497,16 +629,13 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetJacobianOfSpat
   this->m_RecursiveBSplineWeightFunction->Evaluate(cindex, weights1D, supportIndex);
   this->m_RecursiveBSplineWeightFunction->EvaluateDerivative(cindex, derivativeWeights1D, supportIndex);
 
-  /** Allocate memory for jsj. If you want also the Jacobian,
-   * numberOfIndices more elements are needed.
-   */
-  const double dummy[1] = { 1.0 };
-
-  /** Recursively expand all weights (destroys dummy), and multiply with dc. */
+  /** Recursively expand all weights, and multiply with dc. */
   const double * dc = this->m_PointToIndexMatrix2.GetVnlMatrix().data_block();
-  double *       jsjPtr2 = jsj[0].GetVnlMatrix().data_block();
-  RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::
-    GetJacobianOfSpatialJacobian(jsjPtr2, weightsPointer, derivativeWeightsPointer, dc, dummy);
+  ImplementationType::GetJacobianOfSpatialJacobian(jsj[0].GetVnlMatrix().data_block(),
+                                                   weightsPointer,
+                                                   derivativeWeightsPointer,
+                                                   dc,
+                                                   this->GetImplementationInstructionSet());
 
   /** Setup support region needed for the nonZeroJacobianIndices. */
   RegionType supportRegion;
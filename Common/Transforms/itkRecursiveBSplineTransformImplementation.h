@@ -496,7 +496,7 @@ public:
       jsj_out[j] = jsj[OutputDimension] * directionCosines[j];
       for (unsigned int k = 1; k < OutputDimension; ++k)
       {
-        jsj_out[k] += jsj[OutputDimension - k] * directionCosines[k * OutputDimension + j];
+        jsj_out[j] += jsj[OutputDimension - k] * directionCosines[k * OutputDimension + j];
       }
     }
 
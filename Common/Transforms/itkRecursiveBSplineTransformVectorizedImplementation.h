@@ -0,0 +1,825 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRecursiveBSplineTransformVectorizedImplementation_h
+#define itkRecursiveBSplineTransformVectorizedImplementation_h
+
+#include "itkRecursiveBSplineTransformImplementation.h"
+
+/** The explicitly vectorized kernels are only compiled for x86 processors.
+ * They do not need any compiler flags: the AVX2 and AVX-512 kernels are
+ * compiled for their own instruction set, and the instruction set is
+ * selected at run time, based on the capabilities of the processor.
+ */
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) &&                            \
+  (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#  define ELASTIX_RECURSIVE_BSPLINE_SIMD
+#  include <immintrin.h>
+#  if defined(__GNUC__) || defined(__clang__)
+#    define ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#    define ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#  else
+#    include <intrin.h>
+#    define ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX2
+#    define ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512
+#  endif
+#endif
+
+namespace itk
+{
+
+/** \class RecursiveBSplineTransformVectorizedImplementation
+ *
+ * \brief Selects an explicitly vectorized implementation of the recursive
+ * B-spline transform when one exists, and the RecursiveBSplineTransformImplementation
+ * otherwise.
+ *
+ * The general template has no vectorized implementation: all functions forward to the
+ * recursive scalar implementation. See the specialization for the 3D cubic case
+ * with double precision coefficients, which is the most common configuration.
+ *
+ * \ingroup ITKTransform
+ */
+
+template <unsigned int OutputDimension, unsigned int SpaceDimension, unsigned int SplineOrder, class TScalar>
+class ITK_TEMPLATE_EXPORT RecursiveBSplineTransformVectorizedImplementation
+{
+public:
+  /** The recursive implementation, used as the scalar fallback. */
+  typedef RecursiveBSplineTransformImplementation<OutputDimension, SpaceDimension, SplineOrder, TScalar>
+    ScalarImplementationType;
+
+  typedef typename ScalarImplementationType::ScalarType                   ScalarType;
+  typedef typename ScalarImplementationType::InternalFloatType            InternalFloatType;
+  typedef typename ScalarImplementationType::OutputPointType              OutputPointType;
+  typedef typename ScalarImplementationType::CoefficientPointerVectorType CoefficientPointerVectorType;
+
+  /** The instruction sets for which a vectorized implementation may exist. */
+  typedef enum
+  {
+    Scalar = 0,
+    AVX2 = 1,
+    AVX512 = 2
+  } InstructionSetType;
+
+  /** Whether a vectorized implementation exists for this configuration. */
+  itkStaticConstMacro(HasVectorizedImplementation, bool, false);
+
+  /** Get the instruction set that is used by the functions below. */
+  static InstructionSetType
+  GetInstructionSet(void)
+  {
+    return Scalar;
+  }
+
+
+  /** TransformPoint, see RecursiveBSplineTransformImplementation. */
+  static inline void
+  TransformPoint(OutputPointType                    opp,
+                 const CoefficientPointerVectorType mu,
+                 const OffsetValueType *            gridOffsetTable,
+                 const double *                     weights1D,
+                 InstructionSetType)
+  {
+    ScalarImplementationType::TransformPoint(opp, mu, gridOffsetTable, weights1D);
+  } // end TransformPoint()
+
+
+  /** GetJacobian, see RecursiveBSplineTransformImplementation. */
+  static inline void
+  GetJacobian(ScalarType * jacobians, const double * weights1D, InstructionSetType)
+  {
+    ScalarImplementationType::GetJacobian(jacobians, weights1D, 1.0);
+  } // end GetJacobian()
+
+
+  /** EvaluateJacobianWithImageGradientProduct, see RecursiveBSplineTransformImplementation. */
+  static inline void
+  EvaluateJacobianWithImageGradientProduct(ScalarType *              imageJacobian,
+                                           const InternalFloatType * movingImageGradient,
+                                           const double *            weights1D,
+                                           InstructionSetType)
+  {
+    ScalarImplementationType::EvaluateJacobianWithImageGradientProduct(
+      imageJacobian, movingImageGradient, weights1D, 1.0);
+  } // end EvaluateJacobianWithImageGradientProduct()
+
+
+  /** GetSpatialJacobian, see RecursiveBSplineTransformImplementation. */
+  static inline void
+  GetSpatialJacobian(InternalFloatType *                sj,
+                     const CoefficientPointerVectorType mu,
+                     const OffsetValueType *            gridOffsetTable,
+                     const double *                     weights1D,
+                     const double *                     derivativeWeights1D,
+                     InstructionSetType)
+  {
+    ScalarImplementationType::GetSpatialJacobian(sj, mu, gridOffsetTable, weights1D, derivativeWeights1D);
+  } // end GetSpatialJacobian()
+
+
+  /** GetJacobianOfSpatialJacobian, see RecursiveBSplineTransformImplementation. */
+  static inline void
+  GetJacobianOfSpatialJacobian(InternalFloatType * jsj,
+                               const double *      weights1D,
+                               const double *      derivativeWeights1D,
+                               const double *      directionCosines,
+                               InstructionSetType)
+  {
+    const double dummy[1] = { 1.0 };
+    ScalarImplementationType::GetJacobianOfSpatialJacobian(
+      jsj, weights1D, derivativeWeights1D, directionCosines, dummy);
+  } // end GetJacobianOfSpatialJacobian()
+};
+
+
+/** \class RecursiveBSplineTransformVectorizedImplementation
+ *
+ * \brief Explicitly vectorized implementation for the 3D cubic B-spline.
+ *
+ * The support region of a 3D cubic B-spline is a 4x4x4 neighborhood of
+ * coefficients. Its rows along the first dimension are contiguous in memory,
+ * and consist of exactly four doubles, which fill one AVX2 register. The AVX2
+ * kernels therefore process one row per instruction, and the AVX-512 kernels
+ * two rows per instruction. The tensor product of the 1D weights is formed
+ * with the same packed lanes.
+ *
+ * The fastest instruction set that is supported by the processor is detected
+ * once, at run time. On other processors, and when the vectorized kernels are
+ * not compiled in, the recursive scalar implementation is used.
+ *
+ * The results are equal to the ones of the scalar implementation, up to the
+ * order of the floating point summations.
+ *
+ * \ingroup ITKTransform
+ */
+
+template <>
+class RecursiveBSplineTransformVectorizedImplementation<3, 3, 3, double>
+{
+public:
+  /** The recursive implementation, used as the scalar fallback. */
+  typedef RecursiveBSplineTransformImplementation<3, 3, 3, double> ScalarImplementationType;
+  typedef ScalarImplementationType::ScalarType                     ScalarType;
+  typedef ScalarImplementationType::InternalFloatType              InternalFloatType;
+  typedef ScalarImplementationType::OutputPointType                OutputPointType;
+  typedef ScalarImplementationType::CoefficientPointerVectorType   CoefficientPointerVectorType;
+
+  /** The instruction sets for which a vectorized implementation may exist. */
+  typedef enum
+  {
+    Scalar = 0,
+    AVX2 = 1,
+    AVX512 = 2
+  } InstructionSetType;
+
+  /** Whether a vectorized implementation exists for this configuration. */
+#ifdef ELASTIX_RECURSIVE_BSPLINE_SIMD
+  itkStaticConstMacro(HasVectorizedImplementation, bool, true);
+#else
+  itkStaticConstMacro(HasVectorizedImplementation, bool, false);
+#endif
+
+  /** Get the fastest instruction set that is supported by this processor.
+   * The detection is only done at the first call.
+   */
+  static InstructionSetType
+  GetInstructionSet(void)
+  {
+    static const InstructionSetType instructionSet = DetectInstructionSet();
+    return instructionSet;
+  }
+
+
+  /** TransformPoint: computes the displacement. */
+  static inline void
+  TransformPoint(OutputPointType                    opp,
+                 const CoefficientPointerVectorType mu,
+                 const OffsetValueType *            gridOffsetTable,
+                 const double *                     weights1D,
+                 InstructionSetType                 instructionSet)
+  {
+#ifdef ELASTIX_RECURSIVE_BSPLINE_SIMD
+    if (instructionSet == AVX512)
+    {
+      TransformPointAVX512(opp, mu, gridOffsetTable, weights1D);
+      return;
+    }
+    if (instructionSet == AVX2)
+    {
+      TransformPointAVX2(opp, mu, gridOffsetTable, weights1D);
+      return;
+    }
+#endif
+    ScalarImplementationType::TransformPoint(opp, mu, gridOffsetTable, weights1D);
+  } // end TransformPoint()
+
+
+  /** GetJacobian: writes the diagonal blocks of the 3 x (3 * 64) Jacobian. */
+  static inline void
+  GetJacobian(ScalarType * jacobians, const double * weights1D, InstructionSetType instructionSet)
+  {
+#ifdef ELASTIX_RECURSIVE_BSPLINE_SIMD
+    if (instructionSet == AVX512)
+    {
+      GetJacobianAVX512(jacobians, weights1D);
+      return;
+    }
+    if (instructionSet == AVX2)
+    {
+      GetJacobianAVX2(jacobians, weights1D);
+      return;
+    }
+#endif
+    ScalarImplementationType::GetJacobian(jacobians, weights1D, 1.0);
+  } // end GetJacobian()
+
+
+  /** EvaluateJacobianWithImageGradientProduct: the product of the moving image
+   * gradient with the diagonal blocks of the Jacobian.
+   */
+  static inline void
+  EvaluateJacobianWithImageGradientProduct(ScalarType *              imageJacobian,
+                                           const InternalFloatType * movingImageGradient,
+                                           const double *            weights1D,
+                                           InstructionSetType        instructionSet)
+  {
+#ifdef ELASTIX_RECURSIVE_BSPLINE_SIMD
+    if (instructionSet == AVX512)
+    {
+      EvaluateJacobianWithImageGradientProductAVX512(imageJacobian, movingImageGradient, weights1D);
+      return;
+    }
+    if (instructionSet == AVX2)
+    {
+      EvaluateJacobianWithImageGradientProductAVX2(imageJacobian, movingImageGradient, weights1D);
+      return;
+    }
+#endif
+    ScalarImplementationType::EvaluateJacobianWithImageGradientProduct(
+      imageJacobian, movingImageGradient, weights1D, 1.0);
+  } // end EvaluateJacobianWithImageGradientProduct()
+
+
+  /** GetSpatialJacobian: computes the displacement, followed by the
+   * derivatives in the x, y and z direction, 12 values in total.
+   */
+  static inline void
+  GetSpatialJacobian(InternalFloatType *                sj,
+                     const CoefficientPointerVectorType mu,
+                     const OffsetValueType *            gridOffsetTable,
+                     const double *                     weights1D,
+                     const double *                     derivativeWeights1D,
+                     InstructionSetType                 instructionSet)
+  {
+#ifdef ELASTIX_RECURSIVE_BSPLINE_SIMD
+    if (instructionSet == AVX512)
+    {
+      GetSpatialJacobianAVX512(sj, mu, gridOffsetTable, weights1D, derivativeWeights1D);
+      return;
+    }
+    if (instructionSet == AVX2)
+    {
+      GetSpatialJacobianAVX2(sj, mu, gridOffsetTable, weights1D, derivativeWeights1D);
+      return;
+    }
+#endif
+    ScalarImplementationType::GetSpatialJacobian(sj, mu, gridOffsetTable, weights1D, derivativeWeights1D);
+  } // end GetSpatialJacobian()
+
+
+  /** GetJacobianOfSpatialJacobian: writes the non-zero rows of the 3 * 64
+   * matrices of the Jacobian of the spatial Jacobian, multiplied with the
+   * direction cosines.
+   */
+  static inline void
+  GetJacobianOfSpatialJacobian(InternalFloatType * jsj,
+                               const double *      weights1D,
+                               const double *      derivativeWeights1D,
+                               const double *      directionCosines,
+                               InstructionSetType  instructionSet)
+  {
+#ifdef ELASTIX_RECURSIVE_BSPLINE_SIMD
+    if (instructionSet == AVX512)
+    {
+      GetJacobianOfSpatialJacobianAVX512(jsj, weights1D, derivativeWeights1D, directionCosines);
+      return;
+    }
+    if (instructionSet == AVX2)
+    {
+      GetJacobianOfSpatialJacobianAVX2(jsj, weights1D, derivativeWeights1D, directionCosines);
+      return;
+    }
+#endif
+    const double dummy[1] = { 1.0 };
+    ScalarImplementationType::GetJacobianOfSpatialJacobian(
+      jsj, weights1D, derivativeWeights1D, directionCosines, dummy);
+  } // end GetJacobianOfSpatialJacobian()
+
+private:
+  /** Number of 1D weights per dimension, and number of coefficients in the support region. */
+  itkStaticConstMacro(NumberOfWeightsPerDimension, unsigned int, 4);
+  itkStaticConstMacro(NumberOfIndices, unsigned int, 64);
+
+  /** Detect the fastest supported instruction set. */
+  static InstructionSetType
+  DetectInstructionSet(void)
+  {
+#ifdef ELASTIX_RECURSIVE_BSPLINE_SIMD
+#  if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    const bool hasAVX2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    const bool hasAVX512 = hasAVX2 && __builtin_cpu_supports("avx512f");
+#  else
+    /** Check the CPUID feature bits, and whether the operating system saves the
+     * YMM and ZMM registers on a context switch.
+     */
+    int info[4];
+    __cpuid(info, 0);
+    const int maximumLeaf = info[0];
+    __cpuid(info, 1);
+    const bool hasFMA = (info[2] & (1 << 12)) != 0;
+    const bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+    bool       hasAVX2 = false;
+    bool       hasAVX512 = false;
+    if (hasFMA && hasOSXSAVE && maximumLeaf >= 7)
+    {
+      const unsigned long long xcr0 = _xgetbv(0);
+      __cpuidex(info, 7, 0);
+      hasAVX2 = ((info[1] & (1 << 5)) != 0) && ((xcr0 & 0x06) == 0x06);
+      hasAVX512 = hasAVX2 && ((info[1] & (1 << 16)) != 0) && ((xcr0 & 0xe6) == 0xe6);
+    }
+#  endif
+    if (hasAVX512)
+    {
+      return AVX512;
+    }
+    if (hasAVX2)
+    {
+      return AVX2;
+    }
+#endif
+    return Scalar;
+  } // end DetectInstructionSet()
+
+
+#ifdef ELASTIX_RECURSIVE_BSPLINE_SIMD
+
+  /** Sum the four lanes of an AVX register. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX2 static inline double
+  HorizontalSum(const __m256d v)
+  {
+    const __m128d sum2 = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(sum2, _mm_unpackhi_pd(sum2, sum2)));
+  }
+
+
+  /** Add the lower and the upper half of an AVX-512 register. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512 static inline __m256d
+  FoldHalves(const __m512d v)
+  {
+    return _mm256_add_pd(_mm512_castpd512_pd256(v), _mm512_extractf64x4_pd(v, 1));
+  }
+
+
+  /** Load two rows of four coefficients into one AVX-512 register. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512 static inline __m512d
+  LoadTwoRows(const double * row0, const double * row1)
+  {
+    return _mm512_insertf64x4(_mm512_broadcast_f64x4(_mm256_loadu_pd(row0)), _mm256_loadu_pd(row1), 1);
+  }
+
+
+  /** Broadcast a to the lower four lanes, and b to the upper four lanes. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512 static inline __m512d
+  SetTwoHalves(const double a, const double b)
+  {
+    return _mm512_insertf64x4(_mm512_set1_pd(a), _mm256_set1_pd(b), 1);
+  }
+
+
+  /** Broadcast the four lanes of an AVX register to both halves of an AVX-512 register. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512 static inline __m512d
+  BroadcastRow(const __m256d v)
+  {
+    return _mm512_broadcast_f64x4(v);
+  }
+
+
+  /** TransformPoint, AVX2 version.
+   * Per output dimension, the rows of the neighborhood are accumulated with
+   * the product of the y and z weights. The accumulated row is finally
+   * multiplied with the x weights and summed.
+   */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX2 static void
+  TransformPointAVX2(OutputPointType                    opp,
+                     const CoefficientPointerVectorType mu,
+                     const OffsetValueType *            gridOffsetTable,
+                     const double *                     weights1D)
+  {
+    const OffsetValueType oy = gridOffsetTable[1];
+    const OffsetValueType oz = gridOffsetTable[2];
+    const double *        wy = weights1D + NumberOfWeightsPerDimension;
+    const double *        wz = weights1D + 2 * NumberOfWeightsPerDimension;
+
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd();
+    for (unsigned int z = 0; z < 4; ++z)
+    {
+      const OffsetValueType offsetZ = z * oz;
+      for (unsigned int y = 0; y < 4; ++y)
+      {
+        const OffsetValueType offset = offsetZ + y * oy;
+        const __m256d         wzy = _mm256_set1_pd(wz[z] * wy[y]);
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(mu[0] + offset), wzy, acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(mu[1] + offset), wzy, acc1);
+        acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(mu[2] + offset), wzy, acc2);
+      }
+    }
+
+    const __m256d wx = _mm256_loadu_pd(weights1D);
+    opp[0] = HorizontalSum(_mm256_mul_pd(acc0, wx));
+    opp[1] = HorizontalSum(_mm256_mul_pd(acc1, wx));
+    opp[2] = HorizontalSum(_mm256_mul_pd(acc2, wx));
+  } // end TransformPointAVX2()
+
+
+  /** TransformPoint, AVX-512 version. Processes two rows per instruction. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512 static void
+  TransformPointAVX512(OutputPointType                    opp,
+                       const CoefficientPointerVectorType mu,
+                       const OffsetValueType *            gridOffsetTable,
+                       const double *                     weights1D)
+  {
+    const OffsetValueType oy = gridOffsetTable[1];
+    const OffsetValueType oz = gridOffsetTable[2];
+    const double *        wy = weights1D + NumberOfWeightsPerDimension;
+    const double *        wz = weights1D + 2 * NumberOfWeightsPerDimension;
+
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd();
+    for (unsigned int z = 0; z < 4; ++z)
+    {
+      const OffsetValueType offsetZ = z * oz;
+      for (unsigned int y = 0; y < 4; y += 2)
+      {
+        const OffsetValueType offset0 = offsetZ + y * oy;
+        const OffsetValueType offset1 = offset0 + oy;
+        const __m512d         wzy = SetTwoHalves(wz[z] * wy[y], wz[z] * wy[y + 1]);
+        acc0 = _mm512_fmadd_pd(LoadTwoRows(mu[0] + offset0, mu[0] + offset1), wzy, acc0);
+        acc1 = _mm512_fmadd_pd(LoadTwoRows(mu[1] + offset0, mu[1] + offset1), wzy, acc1);
+        acc2 = _mm512_fmadd_pd(LoadTwoRows(mu[2] + offset0, mu[2] + offset1), wzy, acc2);
+      }
+    }
+
+    const __m256d wx = _mm256_loadu_pd(weights1D);
+    opp[0] = HorizontalSum(_mm256_mul_pd(FoldHalves(acc0), wx));
+    opp[1] = HorizontalSum(_mm256_mul_pd(FoldHalves(acc1), wx));
+    opp[2] = HorizontalSum(_mm256_mul_pd(FoldHalves(acc2), wx));
+  } // end TransformPointAVX512()
+
+
+  /** GetJacobian, AVX2 version. One row of 4 tensor weights per instruction. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX2 static void
+  GetJacobianAVX2(ScalarType * jacobians, const double * weights1D)
+  {
+    /** The diagonal blocks are at row j, column j * 64 of the 3 x 192 matrix. */
+    const unsigned int blockOffset = NumberOfIndices * (3 + 1);
+    const __m256d      wx = _mm256_loadu_pd(weights1D);
+    const double *     wy = weights1D + NumberOfWeightsPerDimension;
+    const double *     wz = weights1D + 2 * NumberOfWeightsPerDimension;
+
+    for (unsigned int z = 0; z < 4; ++z)
+    {
+      for (unsigned int y = 0; y < 4; ++y)
+      {
+        const __m256d      w = _mm256_mul_pd(_mm256_set1_pd(wz[z] * wy[y]), wx);
+        const unsigned int m = 16 * z + 4 * y;
+        _mm256_storeu_pd(jacobians + m, w);
+        _mm256_storeu_pd(jacobians + blockOffset + m, w);
+        _mm256_storeu_pd(jacobians + 2 * blockOffset + m, w);
+      }
+    }
+  } // end GetJacobianAVX2()
+
+
+  /** GetJacobian, AVX-512 version. Two rows of 4 tensor weights per instruction. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512 static void
+  GetJacobianAVX512(ScalarType * jacobians, const double * weights1D)
+  {
+    const unsigned int blockOffset = NumberOfIndices * (3 + 1);
+    const __m512d      wx = BroadcastRow(_mm256_loadu_pd(weights1D));
+    const double *     wy = weights1D + NumberOfWeightsPerDimension;
+    const double *     wz = weights1D + 2 * NumberOfWeightsPerDimension;
+
+    for (unsigned int z = 0; z < 4; ++z)
+    {
+      for (unsigned int y = 0; y < 4; y += 2)
+      {
+        const __m512d      w = _mm512_mul_pd(SetTwoHalves(wz[z] * wy[y], wz[z] * wy[y + 1]), wx);
+        const unsigned int m = 16 * z + 4 * y;
+        _mm512_storeu_pd(jacobians + m, w);
+        _mm512_storeu_pd(jacobians + blockOffset + m, w);
+        _mm512_storeu_pd(jacobians + 2 * blockOffset + m, w);
+      }
+    }
+  } // end GetJacobianAVX512()
+
+
+  /** EvaluateJacobianWithImageGradientProduct, AVX2 version. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX2 static void
+  EvaluateJacobianWithImageGradientProductAVX2(ScalarType *              imageJacobian,
+                                               const InternalFloatType * movingImageGradient,
+                                               const double *            weights1D)
+  {
+    const __m256d  wx = _mm256_loadu_pd(weights1D);
+    const double * wy = weights1D + NumberOfWeightsPerDimension;
+    const double * wz = weights1D + 2 * NumberOfWeightsPerDimension;
+    const __m256d  g0 = _mm256_set1_pd(movingImageGradient[0]);
+    const __m256d  g1 = _mm256_set1_pd(movingImageGradient[1]);
+    const __m256d  g2 = _mm256_set1_pd(movingImageGradient[2]);
+
+    for (unsigned int z = 0; z < 4; ++z)
+    {
+      for (unsigned int y = 0; y < 4; ++y)
+      {
+        const __m256d      w = _mm256_mul_pd(_mm256_set1_pd(wz[z] * wy[y]), wx);
+        const unsigned int m = 16 * z + 4 * y;
+        _mm256_storeu_pd(imageJacobian + m, _mm256_mul_pd(w, g0));
+        _mm256_storeu_pd(imageJacobian + NumberOfIndices + m, _mm256_mul_pd(w, g1));
+        _mm256_storeu_pd(imageJacobian + 2 * NumberOfIndices + m, _mm256_mul_pd(w, g2));
+      }
+    }
+  } // end EvaluateJacobianWithImageGradientProductAVX2()
+
+
+  /** EvaluateJacobianWithImageGradientProduct, AVX-512 version. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512 static void
+  EvaluateJacobianWithImageGradientProductAVX512(ScalarType *              imageJacobian,
+                                                 const InternalFloatType * movingImageGradient,
+                                                 const double *            weights1D)
+  {
+    const __m512d  wx = BroadcastRow(_mm256_loadu_pd(weights1D));
+    const double * wy = weights1D + NumberOfWeightsPerDimension;
+    const double * wz = weights1D + 2 * NumberOfWeightsPerDimension;
+    const __m512d  g0 = _mm512_set1_pd(movingImageGradient[0]);
+    const __m512d  g1 = _mm512_set1_pd(movingImageGradient[1]);
+    const __m512d  g2 = _mm512_set1_pd(movingImageGradient[2]);
+
+    for (unsigned int z = 0; z < 4; ++z)
+    {
+      for (unsigned int y = 0; y < 4; y += 2)
+      {
+        const __m512d      w = _mm512_mul_pd(SetTwoHalves(wz[z] * wy[y], wz[z] * wy[y + 1]), wx);
+        const unsigned int m = 16 * z + 4 * y;
+        _mm512_storeu_pd(imageJacobian + m, _mm512_mul_pd(w, g0));
+        _mm512_storeu_pd(imageJacobian + NumberOfIndices + m, _mm512_mul_pd(w, g1));
+        _mm512_storeu_pd(imageJacobian + 2 * NumberOfIndices + m, _mm512_mul_pd(w, g2));
+      }
+    }
+  } // end EvaluateJacobianWithImageGradientProductAVX512()
+
+
+  /** GetSpatialJacobian, AVX2 version.
+   * Per output dimension three rows are accumulated: with the weights wz*wy,
+   * wz*dwy and dwz*wy. The first one gives the displacement and the x derivative
+   * after the multiplication with wx and dwx, respectively. The other two give the
+   * y and z derivatives after the multiplication with wx.
+   */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX2 static void
+  GetSpatialJacobianAVX2(InternalFloatType *                sj,
+                         const CoefficientPointerVectorType mu,
+                         const OffsetValueType *            gridOffsetTable,
+                         const double *                     weights1D,
+                         const double *                     derivativeWeights1D)
+  {
+    const OffsetValueType oy = gridOffsetTable[1];
+    const OffsetValueType oz = gridOffsetTable[2];
+    const double *        wy = weights1D + NumberOfWeightsPerDimension;
+    const double *        wz = weights1D + 2 * NumberOfWeightsPerDimension;
+    const double *        dwy = derivativeWeights1D + NumberOfWeightsPerDimension;
+    const double *        dwz = derivativeWeights1D + 2 * NumberOfWeightsPerDimension;
+
+    __m256d accW[3], accDY[3], accDZ[3];
+    for (unsigned int j = 0; j < 3; ++j)
+    {
+      accW[j] = _mm256_setzero_pd();
+      accDY[j] = _mm256_setzero_pd();
+      accDZ[j] = _mm256_setzero_pd();
+    }
+
+    for (unsigned int z = 0; z < 4; ++z)
+    {
+      const OffsetValueType offsetZ = z * oz;
+      for (unsigned int y = 0; y < 4; ++y)
+      {
+        const OffsetValueType offset = offsetZ + y * oy;
+        const __m256d         wzy = _mm256_set1_pd(wz[z] * wy[y]);
+        const __m256d         wzdy = _mm256_set1_pd(wz[z] * dwy[y]);
+        const __m256d         dzwy = _mm256_set1_pd(dwz[z] * wy[y]);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+          const __m256d row = _mm256_loadu_pd(mu[j] + offset);
+          accW[j] = _mm256_fmadd_pd(row, wzy, accW[j]);
+          accDY[j] = _mm256_fmadd_pd(row, wzdy, accDY[j]);
+          accDZ[j] = _mm256_fmadd_pd(row, dzwy, accDZ[j]);
+        }
+      }
+    }
+
+    const __m256d wx = _mm256_loadu_pd(weights1D);
+    const __m256d dwx = _mm256_loadu_pd(derivativeWeights1D);
+    for (unsigned int j = 0; j < 3; ++j)
+    {
+      sj[j] = HorizontalSum(_mm256_mul_pd(accW[j], wx));
+      sj[3 + j] = HorizontalSum(_mm256_mul_pd(accW[j], dwx));
+      sj[6 + j] = HorizontalSum(_mm256_mul_pd(accDY[j], wx));
+      sj[9 + j] = HorizontalSum(_mm256_mul_pd(accDZ[j], wx));
+    }
+  } // end GetSpatialJacobianAVX2()
+
+
+  /** GetSpatialJacobian, AVX-512 version. Processes two rows per instruction. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512 static void
+  GetSpatialJacobianAVX512(InternalFloatType *                sj,
+                           const CoefficientPointerVectorType mu,
+                           const OffsetValueType *            gridOffsetTable,
+                           const double *                     weights1D,
+                           const double *                     derivativeWeights1D)
+  {
+    const OffsetValueType oy = gridOffsetTable[1];
+    const OffsetValueType oz = gridOffsetTable[2];
+    const double *        wy = weights1D + NumberOfWeightsPerDimension;
+    const double *        wz = weights1D + 2 * NumberOfWeightsPerDimension;
+    const double *        dwy = derivativeWeights1D + NumberOfWeightsPerDimension;
+    const double *        dwz = derivativeWeights1D + 2 * NumberOfWeightsPerDimension;
+
+    __m512d accW[3], accDY[3], accDZ[3];
+    for (unsigned int j = 0; j < 3; ++j)
+    {
+      accW[j] = _mm512_setzero_pd();
+      accDY[j] = _mm512_setzero_pd();
+      accDZ[j] = _mm512_setzero_pd();
+    }
+
+    for (unsigned int z = 0; z < 4; ++z)
+    {
+      const OffsetValueType offsetZ = z * oz;
+      for (unsigned int y = 0; y < 4; y += 2)
+      {
+        const OffsetValueType offset0 = offsetZ + y * oy;
+        const OffsetValueType offset1 = offset0 + oy;
+        const __m512d         wzy = SetTwoHalves(wz[z] * wy[y], wz[z] * wy[y + 1]);
+        const __m512d         wzdy = SetTwoHalves(wz[z] * dwy[y], wz[z] * dwy[y + 1]);
+        const __m512d         dzwy = SetTwoHalves(dwz[z] * wy[y], dwz[z] * wy[y + 1]);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+          const __m512d rows = LoadTwoRows(mu[j] + offset0, mu[j] + offset1);
+          accW[j] = _mm512_fmadd_pd(rows, wzy, accW[j]);
+          accDY[j] = _mm512_fmadd_pd(rows, wzdy, accDY[j]);
+          accDZ[j] = _mm512_fmadd_pd(rows, dzwy, accDZ[j]);
+        }
+      }
+    }
+
+    const __m256d wx = _mm256_loadu_pd(weights1D);
+    const __m256d dwx = _mm256_loadu_pd(derivativeWeights1D);
+    for (unsigned int j = 0; j < 3; ++j)
+    {
+      const __m256d rowW = FoldHalves(accW[j]);
+      sj[j] = HorizontalSum(_mm256_mul_pd(rowW, wx));
+      sj[3 + j] = HorizontalSum(_mm256_mul_pd(rowW, dwx));
+      sj[6 + j] = HorizontalSum(_mm256_mul_pd(FoldHalves(accDY[j]), wx));
+      sj[9 + j] = HorizontalSum(_mm256_mul_pd(FoldHalves(accDZ[j]), wx));
+    }
+  } // end GetSpatialJacobianAVX512()
+
+
+  /** Store the rows of the Jacobian of the spatial Jacobian for the control
+   * points m, .., m + numberOfLanes - 1, given their direction cosine products
+   * g0, g1 and g2 in packed form. The matrix of output dimension i and control
+   * point m has index i * 64 + m, and only its row i is non-zero.
+   */
+  static inline void
+  ScatterJacobianOfSpatialJacobian(InternalFloatType * jsj,
+                                   const unsigned int  m,
+                                   const unsigned int  numberOfLanes,
+                                   const double *      g0,
+                                   const double *      g1,
+                                   const double *      g2)
+  {
+    for (unsigned int lane = 0; lane < numberOfLanes; ++lane)
+    {
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        InternalFloatType * row = jsj + 9 * (i * NumberOfIndices + m + lane) + 3 * i;
+        row[0] = g0[lane];
+        row[1] = g1[lane];
+        row[2] = g2[lane];
+      }
+    }
+  } // end ScatterJacobianOfSpatialJacobian()
+
+
+  /** GetJacobianOfSpatialJacobian, AVX2 version.
+   * The derivatives of the tensor weights in x, y and z direction are formed
+   * for one row of four control points, and multiplied with the direction cosines.
+   */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX2 static void
+  GetJacobianOfSpatialJacobianAVX2(InternalFloatType * jsj,
+                                   const double *      weights1D,
+                                   const double *      derivativeWeights1D,
+                                   const double *      directionCosines)
+  {
+    const __m256d  wx = _mm256_loadu_pd(weights1D);
+    const __m256d  dwx = _mm256_loadu_pd(derivativeWeights1D);
+    const double * wy = weights1D + NumberOfWeightsPerDimension;
+    const double * wz = weights1D + 2 * NumberOfWeightsPerDimension;
+    const double * dwy = derivativeWeights1D + NumberOfWeightsPerDimension;
+    const double * dwz = derivativeWeights1D + 2 * NumberOfWeightsPerDimension;
+
+    __m256d dc[9];
+    for (unsigned int k = 0; k < 9; ++k)
+    {
+      dc[k] = _mm256_set1_pd(directionCosines[k]);
+    }
+
+    double g[3][4];
+    for (unsigned int z = 0; z < 4; ++z)
+    {
+      for (unsigned int y = 0; y < 4; ++y)
+      {
+        const __m256d dx = _mm256_mul_pd(_mm256_set1_pd(wz[z] * wy[y]), dwx);
+        const __m256d dy = _mm256_mul_pd(_mm256_set1_pd(wz[z] * dwy[y]), wx);
+        const __m256d dz = _mm256_mul_pd(_mm256_set1_pd(dwz[z] * wy[y]), wx);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+          const __m256d gj = _mm256_fmadd_pd(dz, dc[6 + j], _mm256_fmadd_pd(dy, dc[3 + j], _mm256_mul_pd(dx, dc[j])));
+          _mm256_storeu_pd(g[j], gj);
+        }
+        ScatterJacobianOfSpatialJacobian(jsj, 16 * z + 4 * y, 4, g[0], g[1], g[2]);
+      }
+    }
+  } // end GetJacobianOfSpatialJacobianAVX2()
+
+
+  /** GetJacobianOfSpatialJacobian, AVX-512 version. Processes two rows of control points per instruction. */
+  ELASTIX_RECURSIVE_BSPLINE_TARGET_AVX512 static void
+  GetJacobianOfSpatialJacobianAVX512(InternalFloatType * jsj,
+                                     const double *      weights1D,
+                                     const double *      derivativeWeights1D,
+                                     const double *      directionCosines)
+  {
+    const __m512d  wx = BroadcastRow(_mm256_loadu_pd(weights1D));
+    const __m512d  dwx = BroadcastRow(_mm256_loadu_pd(derivativeWeights1D));
+    const double * wy = weights1D + NumberOfWeightsPerDimension;
+    const double * wz = weights1D + 2 * NumberOfWeightsPerDimension;
+    const double * dwy = derivativeWeights1D + NumberOfWeightsPerDimension;
+    const double * dwz = derivativeWeights1D + 2 * NumberOfWeightsPerDimension;
+
+    __m512d dc[9];
+    for (unsigned int k = 0; k < 9; ++k)
+    {
+      dc[k] = _mm512_set1_pd(directionCosines[k]);
+    }
+
+    double g[3][8];
+    for (unsigned int z = 0; z < 4; ++z)
+    {
+      for (unsigned int y = 0; y < 4; y += 2)
+      {
+        const __m512d dx = _mm512_mul_pd(SetTwoHalves(wz[z] * wy[y], wz[z] * wy[y + 1]), dwx);
+        const __m512d dy = _mm512_mul_pd(SetTwoHalves(wz[z] * dwy[y], wz[z] * dwy[y + 1]), wx);
+        const __m512d dz = _mm512_mul_pd(SetTwoHalves(dwz[z] * wy[y], dwz[z] * wy[y + 1]), wx);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+          const __m512d gj = _mm512_fmadd_pd(dz, dc[6 + j], _mm512_fmadd_pd(dy, dc[3 + j], _mm512_mul_pd(dx, dc[j])));
+          _mm512_storeu_pd(g[j], gj);
+        }
+        ScatterJacobianOfSpatialJacobian(jsj, 16 * z + 4 * y, 8, g[0], g[1], g[2]);
+      }
+    }
+  } // end GetJacobianOfSpatialJacobianAVX512()
+
+#endif // ELASTIX_RECURSIVE_BSPLINE_SIMD
+};
+
+} // end namespace itk
+
+#endif /* itkRecursiveBSplineTransformVectorizedImplementation_h */
@@ -98,6 +98,10 @@ namespace itk
  * compute only single level of the pyramid via SetCurrentLevel() and
  * SetComputeOnlyForCurrentLevel() methods.
  *
+ * With SetUseSharedImageCache(), the pyramid images are shared through the
+ * SharedImageCache with other pyramids that use the same settings for the same
+ * input image, for example in other registrations in the same process.
+ *
  * \author Denis P. Shamonin and Marius Staring. Division of Image Processing,
  * Department of Radiology, Leiden, The Netherlands
  *
@@ -222,6 +226,13 @@ public:
   itkGetConstMacro(ComputeOnlyForCurrentLevel, bool);
   itkBooleanMacro(ComputeOnlyForCurrentLevel);
 
+  /** Set whether the pyramid images are shared with other pyramids, through the
+   * SharedImageCache. The pyramid images must then not be modified. Default false.
+   */
+  itkSetMacro(UseSharedImageCache, bool);
+  itkGetConstMacro(UseSharedImageCache, bool);
+  itkBooleanMacro(UseSharedImageCache);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<ImageDimension, OutputImageDimension>));
@@ -271,6 +282,7 @@ protected:
   unsigned int          m_CurrentLevel;
   bool                  m_ComputeOnlyForCurrentLevel;
   bool                  m_SmoothingScheduleDefined;
+  bool                  m_UseSharedImageCache;
 
 private:
   /** Typedef for smoother. Smooth always happens first, then only from
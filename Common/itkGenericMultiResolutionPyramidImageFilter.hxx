@@ -23,6 +23,7 @@
 #include "itkResampleImageFilter.h"
 #include "itkShrinkImageFilter.h"
 #include "itkImageAlgorithm.h"
+#include "itkSharedImageCache.h"
 
 namespace // anonymous namespace
 {
@@ -64,6 +65,7 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
   temp.Fill(NumericTraits<ScalarRealType>::ZeroValue());
   this->m_SmoothingSchedule = temp;
   this->m_SmoothingScheduleDefined = false;
+  this->m_UseSharedImageCache = false;
 } // end Constructor
 
 
@@ -338,40 +340,76 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
 
     if (this->ComputeForCurrentLevel(level))
     {
-      // Allocate memory for each output
       OutputImagePointer outputPtr = this->GetOutput(level);
-      outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
-      outputPtr->Allocate();
-
-      // Setup the smoother
-      const bool smootherIsUsed = this->SetupSmoother(level, smoother, input);
-
-      // Setup the shrinker or resampler
-      const int shrinkerOrResamplerIsUsed = this->SetupShrinkerOrResampler(
-        level, smoother, smootherIsUsed, input, outputPtr, rescaleSameTypes, rescaleDifferentTypes);
+      const auto         computeLevel = [this,
+                                     level,
+                                     &input,
+                                     &outputPtr,
+                                     &smoother,
+                                     &rescaleSameTypes,
+                                     &rescaleDifferentTypes]() {
+        // Allocate memory for each output
+        outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
+        outputPtr->Allocate();
 
-      // Update the pipeline and graft or copy results to this filters output
-      if (shrinkerOrResamplerIsUsed == 0 && smootherIsUsed)
-      {
-        UpdateAndGraft<Self, SmootherType, OutputImageType>(this, smoother, outputPtr, level);
-      }
-      else if (shrinkerOrResamplerIsUsed == 0)
-      {
-        ImageAlgorithm::Copy(input.GetPointer(),
-                             outputPtr.GetPointer(),
-                             input->GetLargestPossibleRegion(),
-                             outputPtr->GetLargestPossibleRegion());
-      }
-      else if (shrinkerOrResamplerIsUsed == 1)
+        // Setup the smoother
+        const bool smootherIsUsed = this->SetupSmoother(level, smoother, input);
+
+        // Setup the shrinker or resampler
+        const int shrinkerOrResamplerIsUsed = this->SetupShrinkerOrResampler(
+          level, smoother, smootherIsUsed, input, outputPtr, rescaleSameTypes, rescaleDifferentTypes);
+
+        // Update the pipeline and graft or copy results to this filters output
+        if (shrinkerOrResamplerIsUsed == 0 && smootherIsUsed)
+        {
+          UpdateAndGraft<Self, SmootherType, OutputImageType>(this, smoother, outputPtr, level);
+        }
+        else if (shrinkerOrResamplerIsUsed == 0)
+        {
+          ImageAlgorithm::Copy(input.GetPointer(),
+                               outputPtr.GetPointer(),
+                               input->GetLargestPossibleRegion(),
+                               outputPtr->GetLargestPossibleRegion());
+        }
+        else if (shrinkerOrResamplerIsUsed == 1)
+        {
+          UpdateAndGraft<Self, ImageToImageFilterSameTypes, OutputImageType>(
+            this, rescaleSameTypes, outputPtr, level);
+        }
+        else if (shrinkerOrResamplerIsUsed == 2)
+        {
+          UpdateAndGraft<Self, ImageToImageFilterDifferentTypes, OutputImageType>(
+            this, rescaleDifferentTypes, outputPtr, level);
+        }
+        // no else needed
+      };
+
+      if (!this->m_UseSharedImageCache)
       {
-        UpdateAndGraft<Self, ImageToImageFilterSameTypes, OutputImageType>(this, rescaleSameTypes, outputPtr, level);
+        computeLevel();
+        continue;
       }
-      else if (shrinkerOrResamplerIsUsed == 2)
-      {
-        UpdateAndGraft<Self, ImageToImageFilterDifferentTypes, OutputImageType>(
-          this, rescaleDifferentTypes, outputPtr, level);
-      }
-      // no else needed
+
+      // Share the image of this level with the pyramids of other registrations. The cached
+      // image shares the pixel buffer with the output, but not the output object itself.
+      SigmaArrayType sigmaArray;
+      this->GetSigma(level, sigmaArray);
+      RescaleFactorArrayType shrinkFactors;
+      this->GetShrinkFactors(level, shrinkFactors);
+      std::ostringstream settings;
+      settings.precision(17);
+      settings << typeid(Self).name() << " sigma " << sigmaArray << " factors " << shrinkFactors << " shrinker "
+               << this->GetUseShrinkImageFilter() << " output " << outputPtr->GetLargestPossibleRegion()
+               << outputPtr->GetOrigin() << outputPtr->GetSpacing() << outputPtr->GetDirection();
+
+      const OutputImagePointer levelImage = SharedImageCache::GetOrCreate<OutputImageType>(
+        input.GetPointer(), settings.str(), [&computeLevel, &outputPtr]() {
+          computeLevel();
+          const OutputImagePointer image = OutputImageType::New();
+          image->Graft(outputPtr);
+          return image;
+        });
+      outputPtr->Graft(levelImage);
     }
   } // end for ilevel
 } // end GenerateData()
@@ -911,6 +949,7 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
   os << indent << "ComputeOnlyForCurrentLevel: " << (this->m_ComputeOnlyForCurrentLevel ? "true" : "false")
      << std::endl;
   os << indent << "SmoothingScheduleDefined: " << (this->m_SmoothingScheduleDefined ? "true" : "false") << std::endl;
+  os << indent << "UseSharedImageCache: " << (this->m_UseSharedImageCache ? "true" : "false") << std::endl;
   os << indent << "Smoothing Schedule: ";
   if (this->m_SmoothingSchedule.size() == 0)
   {
@@ -103,7 +103,9 @@ private:
 
     localInputImage->Graft(static_cast<const ScalarInputImageType *>(inputImage));
 
+    /** Only cast the buffered piece, which is less than the whole image when streaming. */
     caster->SetInput(localInputImage);
+    caster->GetOutput()->SetRequestedRegion(localInputImage->GetBufferedRegion());
     caster->Update();
 
     /** return the pixel buffer of the casted image */
@@ -27,6 +27,7 @@
 #include "itkVectorImage.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkMetaImageIO.h"
+#include "itkImageAlgorithm.h"
 
 namespace itk
 {
@@ -98,6 +99,23 @@ ImageFileCastWriter<TInputImage>::GenerateData(void)
   /** Setup the image IO for writing. */
   this->GetModifiableImageIO()->SetFileName(this->GetFileName());
 
+  /** When the image is streamed, only the current piece is written. Make sure
+   * that the buffer contains exactly this piece, like the ImageFileWriter does.
+   */
+  InputImageRegionType ioRegion;
+  ImageIORegionAdaptor<InputImageDimension>::Convert(
+    this->GetImageIO()->GetIORegion(), ioRegion, input->GetLargestPossibleRegion().GetIndex());
+  InputImagePointer cacheImage;
+  if (input->GetBufferedRegion() != ioRegion)
+  {
+    cacheImage = InputImageType::New();
+    cacheImage->CopyInformation(input);
+    cacheImage->SetBufferedRegion(ioRegion);
+    cacheImage->Allocate();
+    ImageAlgorithm::Copy(input, cacheImage.GetPointer(), ioRegion, ioRegion);
+    input = cacheImage;
+  }
+
   /** Get the number of Components */
   unsigned int numberOfComponents = this->GetImageIO()->GetNumberOfComponents();
 
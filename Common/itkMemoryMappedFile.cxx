@@ -0,0 +1,171 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMemoryMappedFile.h"
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+
+/**
+ * ****************** Constructor *********************************
+ */
+
+MemoryMappedFile::MemoryMappedFile()
+{
+  this->m_MappedAddress = nullptr;
+  this->m_MappedSize = 0;
+  this->m_Data = nullptr;
+  this->m_Size = 0;
+
+} // end Constructor
+
+
+/**
+ * ****************** Destructor *********************************
+ */
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  this->Unmap();
+
+} // end Destructor
+
+
+/**
+ * ****************** Map *********************************
+ */
+
+bool
+MemoryMappedFile::Map(const std::string & fileName, const uint64_t offset, const std::size_t size)
+{
+  this->Unmap();
+  if (size == 0)
+  {
+    return false;
+  }
+
+#ifdef _WIN32
+  const HANDLE file = CreateFileA(
+    fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || offset + size > static_cast<uint64_t>(fileSize.QuadPart))
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  /** The mapping stays valid after closing the handles. */
+  const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+  {
+    return false;
+  }
+
+  /** The offset of a view must be a multiple of the allocation granularity. */
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const uint64_t alignedOffset = offset - offset % systemInfo.dwAllocationGranularity;
+  const auto     delta = static_cast<std::size_t>(offset - alignedOffset);
+  void *         address = MapViewOfFile(mapping,
+                                 FILE_MAP_COPY,
+                                 static_cast<DWORD>(alignedOffset >> 32),
+                                 static_cast<DWORD>(alignedOffset & 0xFFFFFFFF),
+                                 size + delta);
+  CloseHandle(mapping);
+  if (address == nullptr)
+  {
+    return false;
+  }
+#else
+  const int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    return false;
+  }
+  struct stat fileStatus;
+  if (fstat(file, &fileStatus) != 0 || offset + size > static_cast<uint64_t>(fileStatus.st_size))
+  {
+    close(file);
+    return false;
+  }
+
+  /** The offset of a mapping must be a multiple of the page size.
+   * The mapping stays valid after closing the file.
+   */
+  const auto     pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  const uint64_t alignedOffset = offset - offset % pageSize;
+  const auto     delta = static_cast<std::size_t>(offset - alignedOffset);
+  void *         address =
+    mmap(nullptr, size + delta, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, static_cast<off_t>(alignedOffset));
+  close(file);
+  if (address == MAP_FAILED)
+  {
+    return false;
+  }
+#endif
+
+  this->m_MappedAddress = address;
+  this->m_MappedSize = size + delta;
+  this->m_Data = static_cast<char *>(address) + delta;
+  this->m_Size = size;
+  return true;
+
+} // end Map()
+
+
+/**
+ * ****************** Unmap *********************************
+ */
+
+void
+MemoryMappedFile::Unmap(void)
+{
+  if (this->m_MappedAddress != nullptr)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(this->m_MappedAddress);
+#else
+    munmap(this->m_MappedAddress, this->m_MappedSize);
+#endif
+  }
+  this->m_MappedAddress = nullptr;
+  this->m_MappedSize = 0;
+  this->m_Data = nullptr;
+  this->m_Size = 0;
+
+} // end Unmap()
+
+
+} // end namespace itk
@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFile_h
+#define itkMemoryMappedFile_h
+
+#include "itkIntTypes.h"
+
+#include <cstddef>
+#include <string>
+
+namespace itk
+{
+
+/** \class MemoryMappedFile
+ *
+ * \brief Maps a part of a file into memory.
+ *
+ * The mapping is private and copy-on-write: the pages are read lazily from the
+ * file, and are shared with other processes that map the same file, until they
+ * are written to. Writing to the mapped memory never changes the file.
+ *
+ * The mapping is released by Unmap(), or by the destructor.
+ *
+ * \ingroup Common
+ */
+
+class MemoryMappedFile
+{
+public:
+  /** The constructor. */
+  MemoryMappedFile();
+
+  /** The destructor, which releases the mapping. */
+  ~MemoryMappedFile();
+
+  /** Map size bytes of the file, starting at offset. Returns false if the file
+   * can not be opened, is too small, or can not be mapped.
+   */
+  bool
+  Map(const std::string & fileName, uint64_t offset, std::size_t size);
+
+  /** Release the mapping. */
+  void
+  Unmap(void);
+
+  /** Get a pointer to the mapped bytes, or nullptr if nothing is mapped. */
+  void *
+  GetData(void) const
+  {
+    return this->m_Data;
+  }
+
+
+  /** Get the number of mapped bytes. */
+  std::size_t
+  GetSize(void) const
+  {
+    return this->m_Size;
+  }
+
+
+private:
+  /** The deleted copy constructor. */
+  MemoryMappedFile(const MemoryMappedFile &) = delete;
+  /** The deleted assignment operator. */
+  void
+  operator=(const MemoryMappedFile &) = delete;
+
+  /** The start of the mapping, which is aligned to the page size, and its size. */
+  void *      m_MappedAddress;
+  std::size_t m_MappedSize;
+
+  /** The requested part of the mapping. */
+  void *      m_Data;
+  std::size_t m_Size;
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkMemoryMappedFile_h
@@ -0,0 +1,156 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImageFileReader_h
+#define itkMemoryMappedImageFileReader_h
+
+#include "itkImageFileReader.h"
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFile.h"
+
+#include <memory>
+#include <string>
+
+namespace itk
+{
+
+/** \class MemoryMappedImportImageContainer
+ *
+ * \brief A pixel container whose buffer is a memory mapped part of a file.
+ *
+ * The container owns the mapping, so the mapping is released when the last
+ * image that uses the container is destroyed.
+ *
+ * \ingroup Common
+ */
+
+template <typename TElementIdentifier, typename TElement>
+class ITK_TEMPLATE_EXPORT MemoryMappedImportImageContainer
+  : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  /** Standard class typedefs. */
+  typedef MemoryMappedImportImageContainer                   Self;
+  typedef ImportImageContainer<TElementIdentifier, TElement> Superclass;
+  typedef SmartPointer<Self>                                 Pointer;
+  typedef SmartPointer<const Self>                           ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedImportImageContainer, ImportImageContainer);
+
+  /** Map numberOfElements elements of the file, starting at offset, and use them
+   * as buffer. Returns false if the file can not be mapped.
+   */
+  bool
+  MapFile(const std::string & fileName, uint64_t offset, TElementIdentifier numberOfElements)
+  {
+    std::unique_ptr<MemoryMappedFile> mappedFile(new MemoryMappedFile);
+    if (!mappedFile->Map(fileName, offset, numberOfElements * sizeof(TElement)))
+    {
+      return false;
+    }
+    this->SetImportPointer(static_cast<TElement *>(mappedFile->GetData()), numberOfElements, false);
+    this->m_MappedFile = std::move(mappedFile);
+    return true;
+  }
+
+
+protected:
+  MemoryMappedImportImageContainer() = default;
+  ~MemoryMappedImportImageContainer() override = default;
+
+private:
+  MemoryMappedImportImageContainer(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  std::unique_ptr<MemoryMappedFile> m_MappedFile;
+};
+
+
+/** \class MemoryMappedImageFileReader
+ *
+ * \brief An image file reader that memory maps uncompressed MetaImage files.
+ *
+ * For an uncompressed binary MetaImage file (.mha or .mhd with raw data file)
+ * whose pixel type, byte order and dimension equal the ones of the output image,
+ * the pixel data is not read into a newly allocated buffer. Instead, the data
+ * is memory mapped, see MemoryMappedFile. The pixels are then read lazily, when
+ * they are accessed, and the memory is shared with other processes that read the
+ * same file, for example when many registrations run against the same atlas.
+ *
+ * All other files are read by the ImageFileReader, as usual.
+ *
+ * \ingroup Common
+ */
+
+template <class TOutputImage>
+class ITK_TEMPLATE_EXPORT MemoryMappedImageFileReader : public ImageFileReader<TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef MemoryMappedImageFileReader   Self;
+  typedef ImageFileReader<TOutputImage> Superclass;
+  typedef SmartPointer<Self>            Pointer;
+  typedef SmartPointer<const Self>      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedImageFileReader, ImageFileReader);
+
+  /** Some convenient typedefs. */
+  typedef TOutputImage                                                          OutputImageType;
+  typedef typename OutputImageType::PixelType                                   OutputImagePixelType;
+  typedef typename OutputImageType::RegionType                                  OutputImageRegionType;
+  typedef typename OutputImageType::SizeValueType                               SizeValueType;
+  typedef MemoryMappedImportImageContainer<SizeValueType, OutputImagePixelType> PixelContainerType;
+
+  /** Get whether the last read image was memory mapped. */
+  itkGetConstMacro(ImageIsMemoryMapped, bool);
+
+protected:
+  MemoryMappedImageFileReader();
+  ~MemoryMappedImageFileReader() override = default;
+
+  /** Memory map the image file if possible, and otherwise read it as usual. */
+  void
+  GenerateData(void) override;
+
+  /** Memory map the image file. Returns false if this is not possible. */
+  bool
+  MapImageFile(void);
+
+private:
+  MemoryMappedImageFileReader(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  bool m_ImageIsMemoryMapped;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkMemoryMappedImageFileReader.hxx"
+#endif
+
+#endif // end #ifndef itkMemoryMappedImageFileReader_h
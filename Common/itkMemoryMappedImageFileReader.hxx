@@ -0,0 +1,165 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImageFileReader_hxx
+#define itkMemoryMappedImageFileReader_hxx
+
+#include "itkMemoryMappedImageFileReader.h"
+
+#include "itkMetaImageIO.h"
+#include <itksys/SystemTools.hxx>
+
+#include <fstream>
+
+namespace itk
+{
+
+/**
+ * **************** Constructor ***************
+ */
+
+template <class TOutputImage>
+MemoryMappedImageFileReader<TOutputImage>::MemoryMappedImageFileReader()
+{
+  this->m_ImageIsMemoryMapped = false;
+} // end Constructor
+
+
+/**
+ * **************** GenerateData ***************
+ */
+
+template <class TOutputImage>
+void
+MemoryMappedImageFileReader<TOutputImage>::GenerateData(void)
+{
+  this->m_ImageIsMemoryMapped = this->MapImageFile();
+  if (!this->m_ImageIsMemoryMapped)
+  {
+    this->Superclass::GenerateData();
+  }
+
+} // end GenerateData()
+
+
+/**
+ * **************** MapImageFile ***************
+ */
+
+template <class TOutputImage>
+bool
+MemoryMappedImageFileReader<TOutputImage>::MapImageFile(void)
+{
+  /** Only entire MetaImage files with the same dimension as the output are mapped. */
+  MetaImageIO *     metaImageIO = dynamic_cast<MetaImageIO *>(this->GetImageIO());
+  OutputImageType * output = this->GetOutput();
+  if (metaImageIO == nullptr || metaImageIO->GetNumberOfDimensions() != OutputImageType::ImageDimension ||
+      output->GetRequestedRegion() != output->GetLargestPossibleRegion())
+  {
+    return false;
+  }
+
+  /** The pixel type in the file should be equal to the one of the output. */
+  const auto dummyImageIO = MetaImageIO::New();
+  dummyImageIO->SetPixelTypeInfo(static_cast<const OutputImagePixelType *>(nullptr));
+  if (metaImageIO->GetPixelType() != dummyImageIO->GetPixelType() ||
+      metaImageIO->GetComponentType() != dummyImageIO->GetComponentType() ||
+      metaImageIO->GetNumberOfComponents() != dummyImageIO->GetNumberOfComponents() ||
+      metaImageIO->GetComponentSize() * metaImageIO->GetNumberOfComponents() != sizeof(OutputImagePixelType))
+  {
+    return false;
+  }
+
+  /** The data should be stored uncompressed, binary, in the byte order of this machine,
+   * in a single data file.
+   */
+  MetaImage * metaImage = metaImageIO->GetMetaImagePointer();
+  if (metaImage->CompressedData() || !metaImage->BinaryData() ||
+      metaImage->BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB())
+  {
+    return false;
+  }
+  const std::string elementDataFileName = metaImage->ElementDataFileName();
+  if (elementDataFileName == "LIST" || elementDataFileName.find('%') != std::string::npos)
+  {
+    return false;
+  }
+
+  const SizeValueType numberOfPixels = output->GetLargestPossibleRegion().GetNumberOfPixels();
+  const uint64_t      dataSize = static_cast<uint64_t>(numberOfPixels) * sizeof(OutputImagePixelType);
+  std::string         dataFileName;
+  uint64_t            offset = 0;
+  if (elementDataFileName == "LOCAL")
+  {
+    /** The data directly follows the ElementDataFile line, which is the last line of the header. */
+    dataFileName = this->GetFileName();
+    std::ifstream headerFile(dataFileName, std::ios::in | std::ios::binary);
+    std::string   line;
+    bool          found = false;
+    while (!found && std::getline(headerFile, line))
+    {
+      const std::size_t first = line.find_first_not_of(" \t");
+      found = first != std::string::npos && line.compare(first, 15, "ElementDataFile") == 0;
+    }
+    if (!found)
+    {
+      return false;
+    }
+    offset = static_cast<uint64_t>(headerFile.tellg());
+  }
+  else
+  {
+    /** The data file is relative to the header file, unless it is a full path. */
+    dataFileName = elementDataFileName;
+    if (!itksys::SystemTools::FileIsFullPath(dataFileName.c_str()))
+    {
+      const std::string path = itksys::SystemTools::GetFilenamePath(this->GetFileName());
+      dataFileName = path.empty() ? dataFileName : path + "/" + dataFileName;
+    }
+
+    /** A header size of -1 means that the data is at the end of the data file. */
+    if (metaImage->HeaderSize() >= 0)
+    {
+      offset = static_cast<uint64_t>(metaImage->HeaderSize());
+    }
+    else
+    {
+      const uint64_t fileSize = static_cast<uint64_t>(itksys::SystemTools::FileLength(dataFileName));
+      if (fileSize < dataSize)
+      {
+        return false;
+      }
+      offset = fileSize - dataSize;
+    }
+  }
+
+  /** Use the mapped data as pixel buffer of the output. */
+  const auto pixelContainer = PixelContainerType::New();
+  if (!pixelContainer->MapFile(dataFileName, offset, numberOfPixels))
+  {
+    return false;
+  }
+  output->SetBufferedRegion(output->GetLargestPossibleRegion());
+  output->SetPixelContainer(pixelContainer);
+  return true;
+
+} // end MapImageFile()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkMemoryMappedImageFileReader_hxx
@@ -0,0 +1,94 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRegistrationThreadState.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+namespace
+{
+
+/** The state of the calling thread. */
+thread_local RegistrationThreadState::RandomGeneratorType::Pointer localRandomGenerator;
+thread_local ThreadIdType                                           localMaximumNumberOfThreads = 0;
+
+} // end unnamed namespace
+
+
+/**
+ * ****************** GetRandomGenerator *********************************
+ */
+
+RegistrationThreadState::RandomGeneratorType::Pointer
+RegistrationThreadState::GetRandomGenerator(void)
+{
+  /** New() creates a separate generator, unlike GetInstance(). */
+  if (localRandomGenerator.IsNull())
+  {
+    localRandomGenerator = RandomGeneratorType::New();
+  }
+  return localRandomGenerator;
+
+} // end GetRandomGenerator()
+
+
+/**
+ * ****************** SetMaximumNumberOfThreads *********************************
+ */
+
+void
+RegistrationThreadState::SetMaximumNumberOfThreads(const ThreadIdType maximumNumberOfThreads)
+{
+  localMaximumNumberOfThreads = maximumNumberOfThreads;
+
+} // end SetMaximumNumberOfThreads()
+
+
+/**
+ * ****************** GetMaximumNumberOfThreads *********************************
+ */
+
+ThreadIdType
+RegistrationThreadState::GetMaximumNumberOfThreads(void)
+{
+  return localMaximumNumberOfThreads;
+
+} // end GetMaximumNumberOfThreads()
+
+
+/**
+ * ****************** GetNumberOfThreads *********************************
+ */
+
+ThreadIdType
+RegistrationThreadState::GetNumberOfThreads(void)
+{
+  const ThreadIdType numberOfThreads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  if (localMaximumNumberOfThreads == 0)
+  {
+    return numberOfThreads;
+  }
+  return std::min(numberOfThreads, localMaximumNumberOfThreads);
+
+} // end GetNumberOfThreads()
+
+} // end namespace itk
@@ -0,0 +1,70 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRegistrationThreadState_h
+#define itkRegistrationThreadState_h
+
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkIntTypes.h"
+
+namespace itk
+{
+
+/** \class RegistrationThreadState
+ *
+ * \brief The state that is shared by the components of the registration that runs on the calling thread.
+ *
+ * Each thread has its own state, just like each thread has its own xout: a random generator,
+ * and the maximum number of threads that its registration may use. Registrations that run
+ * concurrently on different threads therefore do not influence each other.
+ *
+ * The random generator replaces the process-wide MersenneTwisterRandomVariateGenerator::GetInstance().
+ * It is seeded by each registration, so that the result of a registration does not depend
+ * on the registrations that run on other threads at the same time.
+ *
+ * \ingroup Common
+ */
+
+class RegistrationThreadState
+{
+public:
+  typedef Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+
+  /** Get the random generator of the calling thread. It is created at the first call. */
+  static RandomGeneratorType::Pointer
+  GetRandomGenerator(void);
+
+  /** Set the maximum number of threads of the registration on the calling thread.
+   * Zero means that the global default number of threads of ITK is used.
+   */
+  static void
+  SetMaximumNumberOfThreads(const ThreadIdType maximumNumberOfThreads);
+
+  /** Get the maximum number of threads of the registration on the calling thread. */
+  static ThreadIdType
+  GetMaximumNumberOfThreads(void);
+
+  /** Get the number of threads that the registration on the calling thread may use:
+   * the global default number of threads of ITK, limited by the maximum number of threads.
+   */
+  static ThreadIdType
+  GetNumberOfThreads(void);
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkRegistrationThreadState_h
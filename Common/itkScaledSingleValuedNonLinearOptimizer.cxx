@@ -225,6 +225,7 @@ ScaledSingleValuedNonLinearOptimizer::PrintSelf(std::ostream & os, Indent indent
   os << indent << "UnscaledCurrentPosition: " << this->m_UnscaledCurrentPosition << std::endl;
   os << indent << "ScaledCostFunction: " << this->m_ScaledCostFunction.GetPointer() << std::endl;
   os << indent << "Maximize: " << (this->m_Maximize ? "true" : "false") << std::endl;
+  os << indent << "TimingProfile: " << this->m_TimingProfile.GetPointer() << std::endl;
 
 } // end PrintSelf()
 
@@ -20,6 +20,7 @@
 
 #include "itkSingleValuedNonLinearOptimizer.h"
 #include "itkScaledSingleValuedCostFunction.h"
+#include "itkTimingProfile.h"
 
 namespace itk
 {
@@ -129,6 +130,13 @@ public:
 
   itkGetConstMacro(Maximize, bool);
 
+  /** Set the profile to which the time spent in the phases of the optimizer is added:
+   * the optimizer step and the step size estimation. Default null, which means that
+   * nothing is timed.
+   */
+  itkSetObjectMacro(TimingProfile, TimingProfile);
+  itkGetModifiableObjectMacro(TimingProfile, TimingProfile);
+
 protected:
   /** The constructor. */
   ScaledSingleValuedNonLinearOptimizer();
@@ -142,6 +150,7 @@ protected:
   /** Member variables. */
   ParametersType            m_ScaledCurrentPosition;
   ScaledCostFunctionPointer m_ScaledCostFunction;
+  TimingProfile::Pointer    m_TimingProfile;
 
   /** Set m_ScaledCurrentPosition. */
   virtual void
@@ -0,0 +1,176 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSharedImageCache.h"
+
+#include <future>
+#include <map>
+#include <mutex>
+
+namespace itk
+{
+
+namespace
+{
+
+/** The products that are derived from one source buffer. */
+struct SourceEntry
+{
+  Object::ConstPointer                                           SourceBuffer;
+  std::map<std::string, std::shared_future<DataObject::Pointer>> Products;
+};
+
+typedef std::map<const Object *, SourceEntry> SourceEntryMapType;
+
+std::mutex         cacheMutex;
+SourceEntryMapType cacheSourceEntries;
+
+
+/** Remove the entries of the source buffers that are only referenced by the cache.
+ * Removing products may release other source buffers, so repeat until nothing changes.
+ * The caller must hold the cache mutex.
+ */
+void
+RemoveUnusedEntries(void)
+{
+  bool removed = true;
+  while (removed)
+  {
+    removed = false;
+    for (auto it = cacheSourceEntries.begin(); it != cacheSourceEntries.end();)
+    {
+      if (it->second.SourceBuffer->GetReferenceCount() == 1)
+      {
+        it = cacheSourceEntries.erase(it);
+        removed = true;
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+} // end RemoveUnusedEntries()
+
+} // end namespace
+
+
+/**
+ * ********************* GetOrCreate ****************************
+ */
+
+DataObject::Pointer
+SharedImageCache::GetOrCreate(const Object * sourceBuffer, const std::string & key, const CreateFunctionType & create)
+{
+  if (sourceBuffer == nullptr)
+  {
+    return create();
+  }
+
+  std::promise<DataObject::Pointer>       promise;
+  std::shared_future<DataObject::Pointer> product;
+  bool                                    createProduct = false;
+  {
+    const std::lock_guard<std::mutex> lock(cacheMutex);
+    RemoveUnusedEntries();
+
+    SourceEntry & sourceEntry = cacheSourceEntries[sourceBuffer];
+    if (sourceEntry.SourceBuffer.IsNull())
+    {
+      sourceEntry.SourceBuffer = sourceBuffer;
+    }
+
+    /** The product may be created already, or being created by another thread. */
+    const auto found = sourceEntry.Products.find(key);
+    if (found != sourceEntry.Products.end())
+    {
+      product = found->second;
+    }
+    else
+    {
+      product = promise.get_future().share();
+      sourceEntry.Products[key] = product;
+      createProduct = true;
+    }
+  }
+
+  /** Create the product without holding the lock, such that other products can
+   * be requested in the meantime, also by the create function itself.
+   */
+  if (createProduct)
+  {
+    try
+    {
+      promise.set_value(create());
+    }
+    catch (...)
+    {
+      promise.set_exception(std::current_exception());
+
+      /** Do not cache the failure, such that a next request tries again. */
+      const std::lock_guard<std::mutex> lock(cacheMutex);
+      const auto                        sourceEntry = cacheSourceEntries.find(sourceBuffer);
+      if (sourceEntry != cacheSourceEntries.end())
+      {
+        sourceEntry->second.Products.erase(key);
+      }
+      throw;
+    }
+  }
+  return product.get();
+
+} // end GetOrCreate()
+
+
+/**
+ * ********************* Clear ****************************
+ */
+
+void
+SharedImageCache::Clear(void)
+{
+  SourceEntryMapType sourceEntries;
+  {
+    const std::lock_guard<std::mutex> lock(cacheMutex);
+    sourceEntries.swap(cacheSourceEntries);
+  }
+  /** The products are released here, without holding the lock. */
+
+} // end Clear()
+
+
+/**
+ * ********************* GetNumberOfProducts ****************************
+ */
+
+std::size_t
+SharedImageCache::GetNumberOfProducts(void)
+{
+  const std::lock_guard<std::mutex> lock(cacheMutex);
+  RemoveUnusedEntries();
+
+  std::size_t numberOfProducts = 0;
+  for (const auto & sourceEntry : cacheSourceEntries)
+  {
+    numberOfProducts += sourceEntry.second.Products.size();
+  }
+  return numberOfProducts;
+
+} // end GetNumberOfProducts()
+
+} // end namespace itk
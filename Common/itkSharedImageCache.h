@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSharedImageCache_h
+#define itkSharedImageCache_h
+
+#include "itkDataObject.h"
+
+#include <functional>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+
+namespace itk
+{
+
+/** \class SharedImageCache
+ *
+ * \brief A process-wide cache of the data objects that are derived from an image.
+ *
+ * Registrations that run in the same process, for example one per subject against
+ * a shared atlas, derive the same products from the same image: pyramid images,
+ * B-spline coefficient images, gradient images and eroded masks. This cache lets
+ * them compute such a product once, and share it.
+ *
+ * A product is identified by the pixel buffer of its source image, and by a key
+ * that describes the geometry of the source image and how the product is derived
+ * from it. The cache holds a reference to each source buffer, such that its address
+ * is not reused by another image while the products are cached. The products of a
+ * source buffer that is no longer referenced outside the cache are removed at the
+ * next request. A product should therefore not refer to its source image itself.
+ *
+ * The products are shared, so they must not be modified. The source images must not
+ * be modified either, as long as they are in use. When several threads request the
+ * same product at the same time, it is created once, and the other threads wait for it.
+ *
+ * \ingroup Common
+ */
+
+class SharedImageCache
+{
+public:
+  /** The function that creates a product, when it is not yet in the cache. */
+  typedef std::function<DataObject::Pointer(void)> CreateFunctionType;
+
+  /** Get the product with the specified key, derived from the specified source
+   * buffer. If it is not yet in the cache, it is created by calling create.
+   * An exception thrown by create is passed to all threads that requested the
+   * product, and nothing is cached.
+   */
+  static DataObject::Pointer
+  GetOrCreate(const Object * sourceBuffer, const std::string & key, const CreateFunctionType & create);
+
+  /** Get the product with the specified settings, derived from the specified image.
+   * The key consists of the settings, the type and the geometry of the image.
+   */
+  template <class TProduct, class TSourceImage>
+  static typename TProduct::Pointer
+  GetOrCreate(const TSourceImage *                                  sourceImage,
+              const std::string &                                   settings,
+              const std::function<typename TProduct::Pointer(void)> & create)
+  {
+    const DataObject::Pointer product = GetOrCreate(
+      sourceImage->GetPixelContainer(), MakeKey(sourceImage, settings), [&create]() -> DataObject::Pointer {
+        return create().GetPointer();
+      });
+    return dynamic_cast<TProduct *>(product.GetPointer());
+  }
+
+
+  /** Make a key from the settings, the type and the geometry of an image. */
+  template <class TSourceImage>
+  static std::string
+  MakeKey(const TSourceImage * sourceImage, const std::string & settings)
+  {
+    std::ostringstream key;
+    key.precision(17);
+    key << typeid(TSourceImage).name() << ' ' << sourceImage->GetBufferedRegion() << ' ' << sourceImage->GetOrigin()
+        << ' ' << sourceImage->GetSpacing() << ' ' << sourceImage->GetDirection() << ' ' << settings;
+    return key.str();
+  }
+
+
+  /** Remove all products from the cache. Products that are still in use are
+   * released when their last user releases them.
+   */
+  static void
+  Clear(void);
+
+  /** Get the number of cached products. */
+  static std::size_t
+  GetNumberOfProducts(void);
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkSharedImageCache_h
@@ -0,0 +1,314 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTimingProfile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <locale>
+#include <sstream>
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <time.h>
+#endif
+
+namespace itk
+{
+
+namespace
+{
+
+/** The identifier of the next profile. Zero is never used, it marks an empty cache. */
+std::atomic<SizeValueType> nextProfileIdentifier(1);
+
+} // end namespace
+
+
+/**
+ * ****************** Constructor *********************************
+ */
+
+TimingProfile::TimingProfile()
+  : m_Identifier(nextProfileIdentifier++)
+{} // end Constructor
+
+
+/**
+ * ****************** GetPhaseName *********************************
+ */
+
+const char *
+TimingProfile::GetPhaseName(const PhaseType phase)
+{
+  switch (phase)
+  {
+    case Sampling:
+      return "Sampling";
+    case TransformPoint:
+      return "TransformPoint";
+    case Jacobian:
+      return "Jacobian";
+    case Interpolation:
+      return "Interpolation";
+    case DerivativeAccumulation:
+      return "DerivativeAccumulation";
+    case OptimizerStep:
+      return "OptimizerStep";
+    case StepSizeEstimation:
+      return "StepSizeEstimation";
+    default:
+      return "Unknown";
+  }
+
+} // end GetPhaseName()
+
+
+/**
+ * ****************** GetMeasureCPUTime *********************************
+ */
+
+bool
+TimingProfile::GetMeasureCPUTime(const PhaseType phase)
+{
+  /** The phases that are timed once per sample only measure the wall time. */
+  return phase != TransformPoint && phase != Jacobian && phase != Interpolation;
+
+} // end GetMeasureCPUTime()
+
+
+/**
+ * ****************** GetWallClockTime *********************************
+ */
+
+double
+TimingProfile::GetWallClockTime(void)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+} // end GetWallClockTime()
+
+
+/**
+ * ****************** GetThreadCPUTime *********************************
+ */
+
+double
+TimingProfile::GetThreadCPUTime(void)
+{
+#ifdef _WIN32
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if (!::GetThreadTimes(::GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+  {
+    return 0.0;
+  }
+
+  /** The times are given in units of 100 nanoseconds. */
+  const auto toSeconds = [](const FILETIME & fileTime) {
+    ULARGE_INTEGER value;
+    value.LowPart = fileTime.dwLowDateTime;
+    value.HighPart = fileTime.dwHighDateTime;
+    return static_cast<double>(value.QuadPart) * 1e-7;
+  };
+  return toSeconds(kernelTime) + toSeconds(userTime);
+#else
+  struct timespec time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+  {
+    return 0.0;
+  }
+  return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+#endif
+
+} // end GetThreadCPUTime()
+
+
+/**
+ * ****************** GetTimesOfCallingThread *********************************
+ */
+
+TimingProfile::ThreadTimesType &
+TimingProfile::GetTimesOfCallingThread(void)
+{
+  /** Each thread remembers the times it uses for each profile, so that it only needs
+   * to lock the first time. The last profile is checked first, because a thread
+   * usually adds many times to the same profile in a row. The remembered times are
+   * weak references, which expire when their profile is destroyed.
+   */
+  typedef std::pair<SizeValueType, std::weak_ptr<ThreadTimesType>> ThreadTimesOfProfileType;
+  thread_local SizeValueType                         lastIdentifier = 0;
+  thread_local ThreadTimesType *                     lastThreadTimes = nullptr;
+  thread_local std::vector<ThreadTimesOfProfileType> threadTimesOfProfiles;
+
+  if (lastIdentifier == this->m_Identifier)
+  {
+    return *lastThreadTimes;
+  }
+
+  /** Forget the times of the destroyed profiles, so that the threads of a long running
+   * process, like the pool threads, do not collect the times of all profiles ever used.
+   */
+  threadTimesOfProfiles.erase(std::remove_if(threadTimesOfProfiles.begin(),
+                                             threadTimesOfProfiles.end(),
+                                             [](const ThreadTimesOfProfileType & threadTimesOfProfile) {
+                                               return threadTimesOfProfile.second.expired();
+                                             }),
+                              threadTimesOfProfiles.end());
+
+  /** This profile is alive, so its times are too. */
+  ThreadTimesType * threadTimes = nullptr;
+  for (const auto & threadTimesOfProfile : threadTimesOfProfiles)
+  {
+    if (threadTimesOfProfile.first == this->m_Identifier)
+    {
+      threadTimes = threadTimesOfProfile.second.lock().get();
+      break;
+    }
+  }
+
+  if (threadTimes == nullptr)
+  {
+    const std::lock_guard<std::mutex> lock(this->m_Mutex);
+    this->m_ThreadTimes.emplace_back(new ThreadTimesType);
+    threadTimes = this->m_ThreadTimes.back().get();
+    threadTimesOfProfiles.emplace_back(this->m_Identifier, this->m_ThreadTimes.back());
+  }
+
+  lastIdentifier = this->m_Identifier;
+  lastThreadTimes = threadTimes;
+  return *threadTimes;
+
+} // end GetTimesOfCallingThread()
+
+
+/**
+ * ****************** AddTime *********************************
+ */
+
+void
+TimingProfile::AddTime(const PhaseType phase, const double wallTime, const double cpuTime)
+{
+  PhaseTimeType & phaseTime = this->GetTimesOfCallingThread().Phases[phase];
+  phaseTime.WallTime += wallTime;
+  phaseTime.CPUTime += cpuTime;
+  ++phaseTime.NumberOfCalls;
+
+} // end AddTime()
+
+
+/**
+ * ****************** GetPhaseTime *********************************
+ */
+
+TimingProfile::PhaseTimeType
+TimingProfile::GetPhaseTime(const PhaseType phase) const
+{
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+
+  PhaseTimeType sum;
+  for (const auto & threadTimes : this->m_ThreadTimes)
+  {
+    const PhaseTimeType & phaseTime = threadTimes->Phases[phase];
+    sum.WallTime += phaseTime.WallTime;
+    sum.CPUTime += phaseTime.CPUTime;
+    sum.NumberOfCalls += phaseTime.NumberOfCalls;
+  }
+  return sum;
+
+} // end GetPhaseTime()
+
+
+/**
+ * ****************** Reset *********************************
+ */
+
+void
+TimingProfile::Reset(void)
+{
+  /** The times of the threads are kept, because the threads still refer to them. */
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+  for (const auto & threadTimes : this->m_ThreadTimes)
+  {
+    *threadTimes = ThreadTimesType();
+  }
+
+} // end Reset()
+
+
+/**
+ * ****************** WriteJSON *********************************
+ */
+
+void
+TimingProfile::WriteJSON(std::ostream & os) const
+{
+  std::ostringstream json;
+  json.imbue(std::locale::classic());
+  json.precision(9);
+
+  json << "{";
+  const char * separator = "";
+  for (unsigned int i = 0; i < NumberOfPhases; ++i)
+  {
+    const PhaseType     phase = static_cast<PhaseType>(i);
+    const PhaseTimeType phaseTime = this->GetPhaseTime(phase);
+    if (phaseTime.NumberOfCalls == 0)
+    {
+      continue;
+    }
+
+    json << separator << "\"" << GetPhaseName(phase) << "\": { \"WallTime\": " << phaseTime.WallTime;
+    if (GetMeasureCPUTime(phase))
+    {
+      json << ", \"CPUTime\": " << phaseTime.CPUTime;
+    }
+    json << ", \"NumberOfCalls\": " << phaseTime.NumberOfCalls << " }";
+    separator = ", ";
+  }
+  json << "}";
+
+  os << json.str();
+
+} // end WriteJSON()
+
+
+/**
+ * ****************** PrintSelf *********************************
+ */
+
+void
+TimingProfile::PrintSelf(std::ostream & os, Indent indent) const
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  for (unsigned int i = 0; i < NumberOfPhases; ++i)
+  {
+    const PhaseType     phase = static_cast<PhaseType>(i);
+    const PhaseTimeType phaseTime = this->GetPhaseTime(phase);
+    os << indent << GetPhaseName(phase) << ": " << phaseTime.WallTime << " s (" << phaseTime.NumberOfCalls
+       << " calls)\n";
+  }
+
+} // end PrintSelf()
+
+} // end namespace itk
@@ -0,0 +1,213 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTimingProfile_h
+#define itkTimingProfile_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace itk
+{
+
+/** \class TimingProfile
+ *
+ * \brief Collects the cumulative time spent in the phases of a registration component.
+ *
+ * A component, like a metric or an optimizer, adds the time of each call of a phase
+ * to its profile, typically with a ScopedTimer. The times are summed per thread,
+ * without locking, and added together when they are asked for. The times of a phase
+ * are therefore the total time of all threads that executed it, which may be more
+ * than the elapsed time when the phase is multi-threaded.
+ *
+ * The wall time is measured for all phases. The CPU time of the calling thread is
+ * only measured for the coarse phases, that are timed a few times per iteration.
+ * The phases that are timed once per sample (TransformPoint, Jacobian and Interpolation)
+ * only measure the wall time, because reading the CPU time of a thread requires a system
+ * call, which would take longer than the phase itself.
+ *
+ * The times may only be read or reset when none of the phases is being timed.
+ *
+ * \ingroup Common
+ */
+
+class TimingProfile : public Object
+{
+public:
+  /** Standard ITK-stuff. */
+  typedef TimingProfile            Self;
+  typedef Object                   Superclass;
+  typedef SmartPointer<Self>       Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(TimingProfile, Object);
+
+  /** The phases that are timed. */
+  typedef enum
+  {
+    Sampling = 0,
+    TransformPoint = 1,
+    Jacobian = 2,
+    Interpolation = 3,
+    DerivativeAccumulation = 4,
+    OptimizerStep = 5,
+    StepSizeEstimation = 6,
+    NumberOfPhases = 7
+  } PhaseType;
+
+  /** The cumulative times of a phase, in seconds, and the number of calls. */
+  struct PhaseTimeType
+  {
+    double        WallTime{ 0.0 };
+    double        CPUTime{ 0.0 };
+    SizeValueType NumberOfCalls{ 0 };
+  };
+
+  /** Get the name of a phase, as it is written to the JSON output. */
+  static const char *
+  GetPhaseName(const PhaseType phase);
+
+  /** Whether the CPU time is measured for a phase, or only the wall time. */
+  static bool
+  GetMeasureCPUTime(const PhaseType phase);
+
+  /** Get the current wall clock time, in seconds, from a steady clock. */
+  static double
+  GetWallClockTime(void);
+
+  /** Get the CPU time used by the calling thread so far, in seconds. */
+  static double
+  GetThreadCPUTime(void);
+
+  /** Add one call of a phase to the times of the calling thread. */
+  void
+  AddTime(const PhaseType phase, const double wallTime, const double cpuTime);
+
+  /** Get the times of a phase, summed over all threads. */
+  PhaseTimeType
+  GetPhaseTime(const PhaseType phase) const;
+
+  /** Set all times to zero. */
+  void
+  Reset(void);
+
+  /** Write the phases that were called at least once, as a JSON object with
+   * one member per phase: { "Sampling": { "WallTime": ..., "CPUTime": ...,
+   * "NumberOfCalls": ... }, ... }. The CPUTime is omitted for the phases that
+   * only measure the wall time.
+   */
+  void
+  WriteJSON(std::ostream & os) const;
+
+  /** \class ScopedTimer
+   * Times a phase from its construction to its destruction, or until Stop() is
+   * called, and adds the time to the profile. Does nothing when the profile is null.
+   */
+  class ScopedTimer
+  {
+  public:
+    ScopedTimer(TimingProfile * profile, const PhaseType phase)
+      : m_Profile(profile)
+      , m_Phase(phase)
+    {
+      if (this->m_Profile != nullptr)
+      {
+        this->m_MeasureCPUTime = GetMeasureCPUTime(phase);
+        this->m_CPUTime = this->m_MeasureCPUTime ? GetThreadCPUTime() : 0.0;
+        this->m_WallTime = GetWallClockTime();
+      }
+    }
+
+
+    ~ScopedTimer() { this->Stop(); }
+
+
+    /** Stop timing before the end of the scope. */
+    void
+    Stop(void)
+    {
+      if (this->m_Profile != nullptr)
+      {
+        const double wallTime = GetWallClockTime() - this->m_WallTime;
+        const double cpuTime = this->m_MeasureCPUTime ? GetThreadCPUTime() - this->m_CPUTime : 0.0;
+        this->m_Profile->AddTime(this->m_Phase, wallTime, cpuTime);
+        this->m_Profile = nullptr;
+      }
+    }
+
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &
+    operator=(const ScopedTimer &) = delete;
+
+  private:
+    TimingProfile * m_Profile;
+    const PhaseType m_Phase;
+    bool            m_MeasureCPUTime{ false };
+    double          m_WallTime{ 0.0 };
+    double          m_CPUTime{ 0.0 };
+  };
+
+protected:
+  /** The constructor. */
+  TimingProfile();
+  /** The destructor. */
+  ~TimingProfile() override = default;
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  TimingProfile(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  /** The times of all phases, of one thread. */
+  struct ThreadTimesType
+  {
+    PhaseTimeType Phases[NumberOfPhases];
+  };
+
+  /** Get the times of the calling thread. They are created at the first call of each thread. */
+  ThreadTimesType &
+  GetTimesOfCallingThread(void);
+
+  /** Identifies this profile in the thread local lookup of GetTimesOfCallingThread(). Unlike
+   * the address of the profile, it is never reused by another profile.
+   */
+  const SizeValueType m_Identifier;
+
+  /** The times of each thread that used this profile. They are shared, so that the threads
+   * can see when this profile is destroyed.
+   */
+  mutable std::mutex                            m_Mutex;
+  std::vector<std::shared_ptr<ThreadTimesType>> m_ThreadTimes;
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkTimingProfile_h
@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTransformixBinaryPointFile.h"
+
+#include <cstring>
+
+namespace itk
+{
+
+namespace
+{
+/** The signature at the start of a binary point file, including the terminating zero. */
+const char BinaryPointFileSignature[8] = "elxpts1";
+
+/** A dimension larger than this is considered to be written with another byte order. */
+const uint32_t MaximumDimension = 1024;
+} // namespace
+
+
+/**
+ * ****************** HasSignature *********************************
+ */
+
+bool
+TransformixBinaryPointFile::HasSignature(std::istream & stream)
+{
+  const std::streampos position = stream.tellg();
+  char                 signature[sizeof(BinaryPointFileSignature)] = {};
+  stream.read(signature, sizeof(signature));
+  const bool hasSignature =
+    stream.gcount() == sizeof(signature) && std::memcmp(signature, BinaryPointFileSignature, sizeof(signature)) == 0;
+
+  stream.clear();
+  stream.seekg(position);
+  return hasSignature;
+
+} // end HasSignature()
+
+
+/**
+ * ****************** ReadHeader *********************************
+ */
+
+bool
+TransformixBinaryPointFile::ReadHeader(std::istream & stream,
+                                       unsigned int & dimension,
+                                       bool &         pointsAreIndices,
+                                       uint64_t &     numberOfPoints)
+{
+  char     signature[sizeof(BinaryPointFileSignature)];
+  uint32_t fileDimension = 0;
+  uint32_t filePointsAreIndices = 0;
+  uint64_t fileNumberOfPoints = 0;
+
+  stream.read(signature, sizeof(signature));
+  stream.read(reinterpret_cast<char *>(&fileDimension), sizeof(fileDimension));
+  stream.read(reinterpret_cast<char *>(&filePointsAreIndices), sizeof(filePointsAreIndices));
+  stream.read(reinterpret_cast<char *>(&fileNumberOfPoints), sizeof(fileNumberOfPoints));
+
+  if (!stream || std::memcmp(signature, BinaryPointFileSignature, sizeof(signature)) != 0 || fileDimension == 0 ||
+      fileDimension > MaximumDimension || filePointsAreIndices > 1)
+  {
+    return false;
+  }
+
+  dimension = fileDimension;
+  pointsAreIndices = filePointsAreIndices == 1;
+  numberOfPoints = fileNumberOfPoints;
+  return true;
+
+} // end ReadHeader()
+
+
+/**
+ * ****************** WriteHeader *********************************
+ */
+
+void
+TransformixBinaryPointFile::WriteHeader(std::ostream &     stream,
+                                        const unsigned int dimension,
+                                        const bool         pointsAreIndices,
+                                        const uint64_t     numberOfPoints)
+{
+  const uint32_t fileDimension = dimension;
+  const uint32_t filePointsAreIndices = pointsAreIndices ? 1 : 0;
+
+  stream.write(BinaryPointFileSignature, sizeof(BinaryPointFileSignature));
+  stream.write(reinterpret_cast<const char *>(&fileDimension), sizeof(fileDimension));
+  stream.write(reinterpret_cast<const char *>(&filePointsAreIndices), sizeof(filePointsAreIndices));
+  stream.write(reinterpret_cast<const char *>(&numberOfPoints), sizeof(numberOfPoints));
+
+} // end WriteHeader()
+
+
+} // end namespace itk
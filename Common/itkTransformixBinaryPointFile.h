@@ -0,0 +1,71 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTransformixBinaryPointFile_h
+#define itkTransformixBinaryPointFile_h
+
+#include "itkIntTypes.h"
+
+#include <iostream>
+
+namespace itk
+{
+
+/** \class TransformixBinaryPointFile
+ *
+ * \brief Reads and writes the header of a binary transformix point file.
+ *
+ * A binary point file is a compact alternative for the text input point
+ * file, and for the outputpoints.txt written by transformix. It consists of
+ * a header of 24 bytes, followed by the coordinates as 32-bit floats:
+ *
+ * \li 8 bytes: the file signature "elxpts1" followed by a zero;
+ * \li 4 bytes: the dimension of the points, as unsigned integer;
+ * \li 4 bytes: 1 if the points are image indices, 0 if they are world coordinates;
+ * \li 8 bytes: the number of points, as unsigned integer;
+ * \li the coordinates, ordered as x0 y0 z0 x1 y1 z1 ...
+ *
+ * All values are stored in the byte order of the machine that wrote the file,
+ * which is checked by ReadHeader() via the dimension.
+ *
+ * \ingroup Common
+ */
+
+class TransformixBinaryPointFile
+{
+public:
+  /** The size of the header in bytes. */
+  itkStaticConstMacro(HeaderSize, unsigned int, 24);
+
+  /** Check whether the stream starts with the signature of a binary point file.
+   * The stream is put back at its original position.
+   */
+  static bool
+  HasSignature(std::istream & stream);
+
+  /** Read the header. Returns false if the stream does not contain a valid header. */
+  static bool
+  ReadHeader(std::istream & stream, unsigned int & dimension, bool & pointsAreIndices, uint64_t & numberOfPoints);
+
+  /** Write the header. */
+  static void
+  WriteHeader(std::ostream & stream, unsigned int dimension, bool pointsAreIndices, uint64_t numberOfPoints);
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkTransformixBinaryPointFile_h
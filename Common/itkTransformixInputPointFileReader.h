@@ -20,6 +20,7 @@
 #define itkTransformixInputPointFileReader_h
 
 #include "itkMeshFileReaderBase.h"
+#include "itkTransformixBinaryPointFile.h"
 
 #include <fstream>
 
@@ -40,6 +41,9 @@ namespace itk
  *
  * The second word in the text file represents the number of points that
  * should be read.
+ *
+ * Files that start with the signature of a TransformixBinaryPointFile are
+ * read as binary point files instead.
  **/
 
 template <class TOutputMesh>
@@ -81,6 +85,9 @@ public:
    */
   itkGetConstMacro(NumberOfPoints, unsigned long);
 
+  /** Get whether the file is a binary point file. */
+  itkGetConstMacro(FileIsBinary, bool);
+
   /** Prepare the allocation of the output mesh during the first back
    * propagation of the pipeline. Updates the PointsAreIndices and NumberOfPoints.
    */
@@ -97,6 +104,7 @@ protected:
 
   unsigned long m_NumberOfPoints;
   bool          m_PointsAreIndices;
+  bool          m_FileIsBinary;
 
   std::ifstream m_Reader;
 
@@ -21,6 +21,8 @@
 
 #include "itkTransformixInputPointFileReader.h"
 
+#include <vector>
+
 namespace itk
 {
 
@@ -33,6 +35,7 @@ TransformixInputPointFileReader<TOutputMesh>::TransformixInputPointFileReader()
 {
   this->m_NumberOfPoints = 0;
   this->m_PointsAreIndices = false;
+  this->m_FileIsBinary = false;
 } // end constructor
 
 
@@ -66,7 +69,45 @@ TransformixInputPointFileReader<TOutputMesh>::GenerateOutputInformation(void)
   {
     this->m_Reader.close();
   }
-  this->m_Reader.open(this->m_FileName.c_str());
+  this->m_Reader.open(this->m_FileName.c_str(), std::ios::in | std::ios::binary);
+
+  /** Read the header of a binary point file. */
+  this->m_FileIsBinary = TransformixBinaryPointFile::HasSignature(this->m_Reader);
+  if (this->m_FileIsBinary)
+  {
+    unsigned int dimension = 0;
+    uint64_t     numberOfPoints = 0;
+    if (!TransformixBinaryPointFile::ReadHeader(this->m_Reader, dimension, this->m_PointsAreIndices, numberOfPoints) ||
+        dimension != OutputMeshType::PointDimension)
+    {
+      std::ostringstream msg;
+      msg << "The header of the binary point file is invalid, or its dimension is not "
+          << OutputMeshType::PointDimension << "." << std::endl
+          << "Filename: " << this->m_FileName << std::endl;
+      MeshFileReaderException e(__FILE__, __LINE__, msg.str().c_str(), ITK_LOCATION);
+      throw e;
+    }
+
+    /** Check the number of points of the header against the size of the file, before any
+     * memory is allocated for them. Dividing the size avoids an overflow for a corrupt header.
+     */
+    const std::streampos coordinatesBegin = this->m_Reader.tellg();
+    this->m_Reader.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(this->m_Reader.tellg());
+    this->m_Reader.seekg(coordinatesBegin);
+    const uint64_t maximumNumberOfPoints =
+      (fileSize - TransformixBinaryPointFile::HeaderSize) / (uint64_t{ dimension } * sizeof(float));
+    if (!this->m_Reader || numberOfPoints > maximumNumberOfPoints)
+    {
+      std::ostringstream msg;
+      msg << "The binary point file is too small for its " << numberOfPoints << " points." << std::endl
+          << "Filename: " << this->m_FileName << std::endl;
+      MeshFileReaderException e(__FILE__, __LINE__, msg.str().c_str(), ITK_LOCATION);
+      throw e;
+    }
+    this->m_NumberOfPoints = static_cast<unsigned long>(numberOfPoints);
+    return;
+  }
 
   /** Read the first entry */
   std::string indexOrPoint;
@@ -114,7 +155,31 @@ TransformixInputPointFileReader<TOutputMesh>::GenerateData(void)
   PointsContainerPointer points = PointsContainerType::New();
 
   /** Read the file */
-  if (this->m_Reader.is_open())
+  if (this->m_Reader.is_open() && this->m_FileIsBinary)
+  {
+    /** Read all coordinates at once, and convert them to points. */
+    std::vector<float> coordinates(this->m_NumberOfPoints * dimension);
+    this->m_Reader.read(reinterpret_cast<char *>(coordinates.data()),
+                        static_cast<std::streamsize>(coordinates.size() * sizeof(float)));
+    if (!this->m_Reader)
+    {
+      std::ostringstream msg;
+      msg << "The file is not large enough. " << std::endl << "Filename: " << this->m_FileName << std::endl;
+      MeshFileReaderException e(__FILE__, __LINE__, msg.str().c_str(), ITK_LOCATION);
+      throw e;
+    }
+
+    points->Reserve(this->m_NumberOfPoints);
+    for (unsigned long i = 0; i < this->m_NumberOfPoints; ++i)
+    {
+      PointType & point = points->ElementAt(i);
+      for (unsigned int j = 0; j < dimension; j++)
+      {
+        point[j] = coordinates[i * dimension + j];
+      }
+    }
+  }
+  else if (this->m_Reader.is_open())
   {
     for (unsigned int i = 0; i < this->m_NumberOfPoints; ++i)
     {
@@ -0,0 +1,390 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWorkStealingThreadPool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace itk
+{
+
+/**
+ * ****************** JobType *********************************
+ */
+
+struct WorkStealingThreadPool::JobType
+{
+  JobType(const WorkUnitFunctionType & function, ThreadIdType numberOfWorkUnits)
+    : m_Function(function)
+    , m_NumberOfWorkUnits(numberOfWorkUnits)
+    , m_NextWorkUnit(0)
+    , m_NumberOfFinishedWorkUnits(0)
+  {}
+
+  const WorkUnitFunctionType & m_Function;
+  const ThreadIdType           m_NumberOfWorkUnits;
+
+  /** Guarded by the mutex of the pool. */
+  ThreadIdType m_NextWorkUnit;
+
+  /** Guarded by the mutex of the job. */
+  ThreadIdType            m_NumberOfFinishedWorkUnits;
+  std::exception_ptr      m_Exception;
+  std::mutex              m_Mutex;
+  std::condition_variable m_Finished;
+};
+
+
+/**
+ * ****************** Constructor *********************************
+ */
+
+WorkStealingThreadPool::WorkStealingThreadPool()
+{
+  this->m_Stopping = false;
+
+} // end Constructor
+
+
+/**
+ * ****************** Destructor *********************************
+ */
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->m_Mutex);
+    this->m_Stopping = true;
+  }
+  this->m_Condition.notify_all();
+
+  for (std::thread & thread : this->m_Threads)
+  {
+    thread.join();
+  }
+
+} // end Destructor
+
+
+/**
+ * ****************** GetInstance *********************************
+ */
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool::GetInstance(void)
+{
+  /** The initialization of a function-local static is thread-safe. */
+  static const Pointer instance = [] {
+    Pointer pool = new Self;
+    pool->UnRegister();
+    return pool;
+  }();
+  return instance;
+
+} // end GetInstance()
+
+
+/**
+ * ****************** GetNumberOfThreads *********************************
+ */
+
+ThreadIdType
+WorkStealingThreadPool::GetNumberOfThreads(void) const
+{
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+  return static_cast<ThreadIdType>(this->m_Threads.size());
+
+} // end GetNumberOfThreads()
+
+
+/**
+ * ****************** AddThreads *********************************
+ */
+
+void
+WorkStealingThreadPool::AddThreads(ThreadIdType numberOfThreads)
+{
+  /** Never create more threads than ITK allows. */
+  numberOfThreads = std::min(numberOfThreads, MultiThreaderBase::GetGlobalMaximumNumberOfThreads());
+
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+  while (this->m_Threads.size() < numberOfThreads)
+  {
+    this->m_Threads.emplace_back(&Self::ThreadExecute, this);
+  }
+
+} // end AddThreads()
+
+
+/**
+ * ****************** Execute *********************************
+ */
+
+void
+WorkStealingThreadPool::Execute(ThreadIdType numberOfWorkUnits, const WorkUnitFunctionType & function)
+{
+  if (numberOfWorkUnits == 0)
+  {
+    return;
+  }
+  if (numberOfWorkUnits == 1)
+  {
+    function(0);
+    return;
+  }
+
+  /** The calling thread executes work unit 0, so one thread less is needed. */
+  this->AddThreads(numberOfWorkUnits - 1);
+
+  /** Make the job available to the threads of the pool. */
+  JobType job(function, numberOfWorkUnits);
+  {
+    std::lock_guard<std::mutex> lock(this->m_Mutex);
+    job.m_NextWorkUnit = 1;
+    this->m_Jobs.push_back(&job);
+  }
+  this->m_Condition.notify_all();
+
+  /** Execute work unit 0, and then all work units that are not yet claimed by the pool. */
+  ExecuteWorkUnit(job, 0);
+  ThreadIdType workUnitID = 0;
+  while (this->ClaimWorkUnit(job, workUnitID))
+  {
+    ExecuteWorkUnit(job, workUnitID);
+  }
+
+  /** Wait for the work units that are executed by the pool. */
+  {
+    std::unique_lock<std::mutex> lock(job.m_Mutex);
+    job.m_Finished.wait(lock, [&job] { return job.m_NumberOfFinishedWorkUnits == job.m_NumberOfWorkUnits; });
+  }
+
+  if (job.m_Exception)
+  {
+    std::rethrow_exception(job.m_Exception);
+  }
+
+} // end Execute()
+
+
+/**
+ * ****************** ClaimWorkUnit *********************************
+ */
+
+bool
+WorkStealingThreadPool::ClaimWorkUnit(JobType & job, ThreadIdType & workUnitID)
+{
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+  if (job.m_NextWorkUnit >= job.m_NumberOfWorkUnits)
+  {
+    return false;
+  }
+
+  workUnitID = job.m_NextWorkUnit++;
+
+  /** Jobs in the queue always have work units left. */
+  if (job.m_NextWorkUnit == job.m_NumberOfWorkUnits)
+  {
+    this->m_Jobs.erase(std::find(this->m_Jobs.begin(), this->m_Jobs.end(), &job));
+  }
+  return true;
+
+} // end ClaimWorkUnit()
+
+
+/**
+ * ****************** ExecuteWorkUnit *********************************
+ */
+
+void
+WorkStealingThreadPool::ExecuteWorkUnit(JobType & job, ThreadIdType workUnitID)
+{
+  std::exception_ptr exception;
+  try
+  {
+    job.m_Function(workUnitID);
+  }
+  catch (...)
+  {
+    exception = std::current_exception();
+  }
+
+  /** The notification is done while holding the lock, because the job
+   * may be destroyed as soon as the caller of Execute() is woken up.
+   */
+  std::lock_guard<std::mutex> lock(job.m_Mutex);
+  if (exception && !job.m_Exception)
+  {
+    job.m_Exception = exception;
+  }
+  if (++job.m_NumberOfFinishedWorkUnits == job.m_NumberOfWorkUnits)
+  {
+    job.m_Finished.notify_all();
+  }
+
+} // end ExecuteWorkUnit()
+
+
+/**
+ * ****************** ThreadExecute *********************************
+ */
+
+void
+WorkStealingThreadPool::ThreadExecute(void)
+{
+  while (true)
+  {
+    JobType *    job = nullptr;
+    ThreadIdType workUnitID = 0;
+    {
+      std::unique_lock<std::mutex> lock(this->m_Mutex);
+      this->m_Condition.wait(lock, [this] { return this->m_Stopping || !this->m_Jobs.empty(); });
+      if (this->m_Jobs.empty())
+      {
+        return;
+      }
+
+      job = this->m_Jobs.front();
+      workUnitID = job->m_NextWorkUnit++;
+      if (job->m_NextWorkUnit == job->m_NumberOfWorkUnits)
+      {
+        this->m_Jobs.pop_front();
+      }
+    }
+
+    ExecuteWorkUnit(*job, workUnitID);
+  }
+
+} // end ThreadExecute()
+
+
+/**
+ * ****************** PrintSelf *********************************
+ */
+
+void
+WorkStealingThreadPool::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfThreads: " << this->GetNumberOfThreads() << std::endl;
+
+} // end PrintSelf()
+
+
+/**
+ * ****************** WorkStealingChunkScheduler *********************************
+ */
+
+WorkStealingChunkScheduler::WorkStealingChunkScheduler()
+{
+  this->m_Ranges = nullptr;
+  this->m_NumberOfWorkUnits = 0;
+  this->m_RangesSize = 0;
+  this->m_ChunkSize = 1;
+
+} // end Constructor
+
+
+/**
+ * ****************** Destructor *********************************
+ */
+
+WorkStealingChunkScheduler::~WorkStealingChunkScheduler()
+{
+  delete[] this->m_Ranges;
+
+} // end Destructor
+
+
+/**
+ * ****************** Initialize *********************************
+ */
+
+void
+WorkStealingChunkScheduler::Initialize(ThreadIdType numberOfWorkUnits, SizeValueType size, SizeValueType chunkSize)
+{
+  numberOfWorkUnits = std::max<ThreadIdType>(numberOfWorkUnits, 1);
+  if (numberOfWorkUnits > this->m_RangesSize)
+  {
+    delete[] this->m_Ranges;
+    this->m_Ranges = new AlignedRangeStruct[numberOfWorkUnits];
+    this->m_RangesSize = numberOfWorkUnits;
+  }
+  this->m_NumberOfWorkUnits = numberOfWorkUnits;
+
+  /** Each work unit initially gets an equal contiguous part. */
+  const SizeValueType partSize = (size + numberOfWorkUnits - 1) / numberOfWorkUnits;
+  if (chunkSize == 0)
+  {
+    chunkSize = partSize / DefaultNumberOfChunksPerWorkUnit;
+  }
+  this->m_ChunkSize = std::max<SizeValueType>(chunkSize, 1);
+
+  for (ThreadIdType i = 0; i < numberOfWorkUnits; ++i)
+  {
+    this->m_Ranges[i].m_Begin = std::min(i * partSize, size);
+    this->m_Ranges[i].m_End = std::min((i + 1) * partSize, size);
+  }
+
+} // end Initialize()
+
+
+/**
+ * ****************** GetNextChunk *********************************
+ */
+
+bool
+WorkStealingChunkScheduler::GetNextChunk(ThreadIdType workUnitID, SizeValueType & begin, SizeValueType & end)
+{
+  /** Take a chunk from the front of the own part. */
+  {
+    RangeStruct &               range = this->m_Ranges[workUnitID];
+    std::lock_guard<std::mutex> lock(range.m_Mutex);
+    if (range.m_Begin < range.m_End)
+    {
+      begin = range.m_Begin;
+      end = std::min(begin + this->m_ChunkSize, range.m_End);
+      range.m_Begin = end;
+      return true;
+    }
+  }
+
+  /** Steal a chunk from the back of the part of another work unit. The parts
+   * only shrink, so when all of them are empty, the loop is done.
+   */
+  for (ThreadIdType i = 1; i < this->m_NumberOfWorkUnits; ++i)
+  {
+    RangeStruct &               range = this->m_Ranges[(workUnitID + i) % this->m_NumberOfWorkUnits];
+    std::lock_guard<std::mutex> lock(range.m_Mutex);
+    if (range.m_Begin < range.m_End)
+    {
+      end = range.m_End;
+      begin = (end - range.m_Begin > this->m_ChunkSize) ? end - this->m_ChunkSize : range.m_Begin;
+      range.m_End = begin;
+      return true;
+    }
+  }
+
+  return false;
+
+} // end GetNextChunk()
+
+
+} // end namespace itk
@@ -0,0 +1,220 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWorkStealingThreadPool_h
+#define itkWorkStealingThreadPool_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkMultiThreaderBase.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace itk
+{
+
+/** \class WorkStealingThreadPool
+ *
+ * \brief A persistent pool of threads that executes a function once for each work unit.
+ *
+ * Execute() runs a function for the work units 0 .. numberOfWorkUnits - 1, like
+ * PlatformMultiThreader::SingleMethodExecute(), but without creating and joining
+ * threads on each call: the threads are created once, and wait for work in between.
+ * The calling thread executes work unit 0 itself, and executes all work units
+ * that have not been picked up by a pool thread by the time it is done with its own.
+ * Therefore Execute() may be called concurrently, and from within a work unit.
+ *
+ * Each work unit is executed exactly once. An exception thrown by a work unit is
+ * passed on to the caller of Execute(), after all work units have finished.
+ *
+ * Use WorkStealingChunkScheduler to balance the load of a loop over the work units.
+ *
+ * \ingroup Common
+ */
+
+class WorkStealingThreadPool : public Object
+{
+public:
+  /** Standard ITK-stuff. */
+  typedef WorkStealingThreadPool   Self;
+  typedef Object                   Superclass;
+  typedef SmartPointer<Self>       Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(WorkStealingThreadPool, Object);
+
+  /** Get the process-wide thread pool. */
+  static Pointer
+  GetInstance(void);
+
+  /** The function executed for each work unit. */
+  typedef std::function<void(ThreadIdType)> WorkUnitFunctionType;
+
+  /** Execute the function for each work unit, and wait until all are done. */
+  void
+  Execute(ThreadIdType numberOfWorkUnits, const WorkUnitFunctionType & function);
+
+  /** Get the number of threads in the pool, not counting the calling thread. */
+  ThreadIdType
+  GetNumberOfThreads(void) const;
+
+protected:
+  /** The constructor. */
+  WorkStealingThreadPool();
+
+  /** The destructor, which stops and joins the threads. */
+  ~WorkStealingThreadPool() override;
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** The deleted copy constructor. */
+  WorkStealingThreadPool(const Self &) = delete;
+  /** The deleted assignment operator. */
+  void
+  operator=(const Self &) = delete;
+
+  /** The administration of one call to Execute(). */
+  struct JobType;
+
+  /** Add threads to the pool until it contains numberOfThreads threads. */
+  void
+  AddThreads(ThreadIdType numberOfThreads);
+
+  /** Get the next work unit of the job that is not yet executed. Returns false if there is none. */
+  bool
+  ClaimWorkUnit(JobType & job, ThreadIdType & workUnitID);
+
+  /** Execute one work unit of a job, and register that it is finished. */
+  static void
+  ExecuteWorkUnit(JobType & job, ThreadIdType workUnitID);
+
+  /** The function executed by the threads of the pool. */
+  void
+  ThreadExecute(void);
+
+  /** Member variables. */
+  std::vector<std::thread> m_Threads;
+  std::deque<JobType *>    m_Jobs;
+  mutable std::mutex       m_Mutex;
+  std::condition_variable  m_Condition;
+  bool                     m_Stopping;
+};
+
+
+/** \class WorkStealingChunkScheduler
+ *
+ * \brief Distributes the indices of a loop over work units, in small chunks.
+ *
+ * The range [0, size) is initially divided in contiguous parts, one for each work unit.
+ * A work unit takes its chunks from the front of its own part. When its own part is
+ * exhausted, it steals chunks from the back of the parts of the other work units.
+ * This way all work units stay busy when the cost per index varies, for example
+ * because of mask rejection, or samples that map outside the moving image,
+ * while each work unit still mostly processes neighbouring indices.
+ *
+ * A typical loop over the work units looks like:
+ *
+ * \code
+ *   SizeValueType begin, end;
+ *   while (scheduler.GetNextChunk(workUnitID, begin, end))
+ *   {
+ *     for (SizeValueType i = begin; i < end; ++i) { ... }
+ *   }
+ * \endcode
+ *
+ * GetNextChunk() may be called concurrently by different work units.
+ *
+ * \ingroup Common
+ */
+
+class WorkStealingChunkScheduler
+{
+public:
+  /** The default number of chunks per work unit. */
+  itkStaticConstMacro(DefaultNumberOfChunksPerWorkUnit, unsigned int, 16);
+
+  /** The constructor. */
+  WorkStealingChunkScheduler();
+
+  /** The destructor. */
+  ~WorkStealingChunkScheduler();
+
+  /** Distribute [0, size) over the work units. A chunk size of zero selects
+   * the chunk size such that each work unit initially gets
+   * DefaultNumberOfChunksPerWorkUnit chunks.
+   */
+  void
+  Initialize(ThreadIdType numberOfWorkUnits, SizeValueType size, SizeValueType chunkSize = 0);
+
+  /** Get the next chunk [begin, end) to be processed by the work unit.
+   * Returns false when all indices have been handed out.
+   */
+  bool
+  GetNextChunk(ThreadIdType workUnitID, SizeValueType & begin, SizeValueType & end);
+
+  /** Get the chunk size. */
+  SizeValueType
+  GetChunkSize(void) const
+  {
+    return this->m_ChunkSize;
+  }
+
+
+  /** Get the number of work units. */
+  ThreadIdType
+  GetNumberOfWorkUnits(void) const
+  {
+    return this->m_NumberOfWorkUnits;
+  }
+
+
+private:
+  /** The deleted copy constructor. */
+  WorkStealingChunkScheduler(const WorkStealingChunkScheduler &) = delete;
+  /** The deleted assignment operator. */
+  void
+  operator=(const WorkStealingChunkScheduler &) = delete;
+
+  /** The part of the range that is not yet handed out, for one work unit. */
+  struct RangeStruct
+  {
+    std::mutex    m_Mutex;
+    SizeValueType m_Begin;
+    SizeValueType m_End;
+  };
+  itkPadStruct(ITK_CACHE_LINE_ALIGNMENT, RangeStruct, PaddedRangeStruct);
+  itkAlignedTypedef(ITK_CACHE_LINE_ALIGNMENT, PaddedRangeStruct, AlignedRangeStruct);
+
+  /** Member variables. */
+  AlignedRangeStruct * m_Ranges;
+  ThreadIdType         m_NumberOfWorkUnits;
+  ThreadIdType         m_RangesSize;
+  SizeValueType        m_ChunkSize;
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkWorkStealingThreadPool_h
@@ -60,6 +60,10 @@ namespace elastix
  *    for rescaling the image, or the ResampleImageFilter. Skrinker is faster.\n
  *    example: <tt>(ImagePyramidUseShrinkImageFilter "true")</tt>\n
  *    Default false, so by default the resampler is used.
+ * \parameter UseSharedImageCache: Flag to specify if the pyramid images are shared with other
+ *    registrations in the same process, see ElastixBase.\n
+ *    example: <tt>(UseSharedImageCache "true")</tt>\n
+ *    Default false.
  *
  * \ingroup ImagePyramids
  */
@@ -124,6 +128,13 @@ public:
   void
   BeforeEachResolution(void) override;
 
+  /** Release the pyramid image of a level. When the images are computed per
+   * resolution, the image of the first level is released as well, since the
+   * pyramid computes only the current level anyway.
+   */
+  void
+  ReleasePyramidImage(const unsigned int level) override;
+
 protected:
   /** The constructor. */
   FixedGenericPyramid() = default;
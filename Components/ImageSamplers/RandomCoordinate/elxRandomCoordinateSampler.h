@@ -65,6 +65,13 @@ namespace elastix
  *    and in the second resolution 30mm.\n
  *    Default: sampleRegionSize[i] = min ( fixedImageSize[i], max_i ( fixedImageSize[i]/3 ) ),
  *    with fixedImageSize in mm. So, approximately 1/3 of the fixed image size.
+ * \parameter UseAllocationFreeSampling: Defines whether the samples are generated by multiple
+ *    threads directly into the sample container, without allocating a container per thread.
+ *    This saves time when new samples are selected in every iteration, see the
+ *    NewSamplesEveryIteration parameter. It is only used when no fixed image mask is given.
+ *    The random coordinates differ from the ones of the default mode.\n
+ *    example: <tt>(UseAllocationFreeSampling "true")</tt>\n
+ *    Default: false. The parameter can be specified for each resolution.
  * \parameter FixedImageBSplineInterpolationOrder: When using a RandomCoordinate sampler,
  *    the fixed image needs to be interpolated. This is done using a B-spline interpolator.
  *    With this option you can specify the order of interpolation.\n
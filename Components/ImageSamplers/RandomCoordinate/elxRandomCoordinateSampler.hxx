@@ -63,6 +63,12 @@ RandomCoordinateSampler<TElastix>::BeforeEachResolution(void)
     useRandomSampleRegion, "UseRandomSampleRegion", this->GetComponentLabel(), level, 0);
   this->SetUseRandomSampleRegion(useRandomSampleRegion);
 
+  /** Set the UseAllocationFreeSampling bool. */
+  bool useAllocationFreeSampling = false;
+  this->GetConfiguration()->ReadParameter(
+    useAllocationFreeSampling, "UseAllocationFreeSampling", this->GetComponentLabel(), level, 0);
+  this->SetUseAllocationFreeSampling(useAllocationFreeSampling);
+
   /** Set the SampleRegionSize. */
   if (useRandomSampleRegion)
   {
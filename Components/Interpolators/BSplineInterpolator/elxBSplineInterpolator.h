@@ -108,6 +108,17 @@ public:
   void
   BeforeEachResolution(void) override;
 
+  /** Release the B-spline coefficient image. */
+  void
+  ReleaseMemory(void) override;
+
+  /** Set the input image, and compute its B-spline coefficient image. With
+   * (UseSharedImageCache "true"), the coefficient image is shared with the
+   * registrations of the same image in this process.
+   */
+  void
+  SetInputImage(const InputImageType * inputData) override;
+
 protected:
   /** The constructor. */
   BSplineInterpolator() = default;
@@ -120,6 +131,8 @@ private:
   /** The deleted assignment operator. */
   void
   operator=(const Self &) = delete;
+
+  bool m_UseSharedImageCache{ false };
 };
 
 } // end namespace elastix
@@ -20,6 +20,7 @@
 #define elxBSplineInterpolator_hxx
 
 #include "elxBSplineInterpolator.h"
+#include "itkSharedImageCache.h"
 
 namespace elastix
 {
@@ -53,9 +54,73 @@ BSplineInterpolator<TElastix>::BeforeEachResolution(void)
   /** Set the splineOrder. */
   this->SetSplineOrder(splineOrder);
 
+  /** Read whether the coefficient image is shared with other registrations. */
+  bool useSharedImageCache = false;
+  this->GetConfiguration()->ReadParameter(useSharedImageCache, "UseSharedImageCache", 0, false);
+  this->m_UseSharedImageCache = useSharedImageCache;
+
 } // end BeforeEachResolution()
 
 
+/**
+ * ***************** ReleaseMemory ***********************
+ */
+
+template <class TElastix>
+void
+BSplineInterpolator<TElastix>::ReleaseMemory(void)
+{
+  if (this->m_Coefficients.IsNotNull())
+  {
+    const_cast<CoefficientImageType *>(this->m_Coefficients.GetPointer())->ReleaseData();
+  }
+
+} // end ReleaseMemory()
+
+
+/**
+ * ***************** SetInputImage ***********************
+ */
+
+template <class TElastix>
+void
+BSplineInterpolator<TElastix>::SetInputImage(const InputImageType * inputData)
+{
+  if (!this->m_UseSharedImageCache || inputData == nullptr)
+  {
+    this->Superclass1::SetInputImage(inputData);
+    return;
+  }
+
+  /** Get the coefficient image from the cache, or compute it like the superclass does. */
+  const unsigned int splineOrder = this->GetSplineOrder();
+  std::ostringstream settings;
+  settings << typeid(CoefficientFilter).name() << " order " << splineOrder;
+  const typename CoefficientImageType::Pointer coefficients =
+    itk::SharedImageCache::GetOrCreate<CoefficientImageType>(inputData, settings.str(), [inputData, splineOrder]() {
+      const CoefficientFilterPointer filter = CoefficientFilter::New();
+      filter->SetSplineOrder(splineOrder);
+      filter->SetInput(inputData);
+      filter->Update();
+      const typename CoefficientImageType::Pointer image = filter->GetOutput();
+      image->DisconnectPipeline();
+      return image;
+    });
+
+  /** Use a copy of the shared image object, such that ReleaseMemory() releases
+   * only the reference of this interpolator to the shared pixel buffer.
+   */
+  const typename CoefficientImageType::Pointer coefficientsOfThisInterpolator = CoefficientImageType::New();
+  coefficientsOfThisInterpolator->Graft(coefficients);
+  this->m_Coefficients = coefficientsOfThisInterpolator;
+
+  /** Set the input image like the superclass does, apart from the coefficients. */
+  this->Superclass1::Superclass::SetInputImage(inputData);
+  this->m_DataLength = inputData->GetBufferedRegion().GetSize();
+
+} // end SetInputImage()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef elxBSplineInterpolator_hxx
@@ -138,6 +138,14 @@ public:
                         MeasureType &                   Value,
                         DerivativeType &                Derivative) const override;
 
+  /** GetValueAndDerivative() only reads the transform, so it may run concurrently with other metrics. */
+  bool
+  GetSupportsConcurrentGetValueAndDerivative(void) const override
+  {
+    return true;
+  }
+
+
   /** Computes the moving gradient image dM/dx. */
   void
   ComputeGradient(void) override;
@@ -143,6 +143,16 @@ public:
   MeasureType
   GetValue(const ParametersType & parameters) const override;
 
+  /** The analytic GetValueAndDerivative() only reads the transform, so it may run
+   * concurrently with other metrics. The finite difference derivative does not qualify.
+   */
+  bool
+  GetSupportsConcurrentGetValueAndDerivative(void) const override
+  {
+    return !this->GetUseFiniteDifferenceDerivative();
+  }
+
+
   /** Set/get whether to apply the technique introduced by Nicholas Tustison; default: false */
   itkGetConstMacro(UseJacobianPreconditioning, bool);
   itkSetMacro(UseJacobianPreconditioning, bool);
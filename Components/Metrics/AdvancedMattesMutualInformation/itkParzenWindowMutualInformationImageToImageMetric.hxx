@@ -449,101 +449,104 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Thre
 
   /** Get a handle to the sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
-  const unsigned long         sampleContainerSize = sampleContainer->Size();
 
-  /** Get the samples for this thread. */
-  const unsigned long nrOfSamplesPerThreads = static_cast<unsigned long>(
-    std::ceil(static_cast<double>(sampleContainerSize) / static_cast<double>(Self::GetNumberOfWorkUnits())));
-
-  unsigned long pos_begin = nrOfSamplesPerThreads * threadId;
-  unsigned long pos_end = nrOfSamplesPerThreads * (threadId + 1);
-  pos_begin = (pos_begin > sampleContainerSize) ? sampleContainerSize : pos_begin;
-  pos_end = (pos_end > sampleContainerSize) ? sampleContainerSize : pos_end;
-
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator fiter;
-  typename ImageSampleContainerType::ConstIterator fbegin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator fend = sampleContainer->Begin();
-  fbegin += (int)pos_begin;
-  fend += (int)pos_end;
-
-  /** Loop over sample container and compute contribution of each sample to pdfs. */
-  for (fiter = fbegin; fiter != fend; ++fiter)
+  /** Process the chunks of samples that this thread gets from the scheduler.
+   * A thread first processes its own part of the sample container, and then
+   * helps the other threads, see GetNextSampleChunk().
+   */
+  SizeValueType pos_begin = 0;
+  SizeValueType pos_end = 0;
+  while (this->GetNextSampleChunk(threadId, pos_begin, pos_end))
   {
-    /** Read fixed coordinates and create some variables. */
-    const FixedImagePointType & fixedPoint = (*fiter).Value().m_ImageCoordinates;
-    RealType                    movingImageValue;
-    MovingImageDerivativeType   movingImageDerivative;
-    MovingImagePointType        mappedPoint;
+    /** Create iterator over the samples of this chunk. */
+    typename ImageSampleContainerType::ConstIterator fiter;
+    typename ImageSampleContainerType::ConstIterator fbegin = sampleContainer->Begin();
+    typename ImageSampleContainerType::ConstIterator fend = sampleContainer->Begin();
+    fbegin += (int)pos_begin;
+    fend += (int)pos_end;
+
+    /** Loop over sample container and compute contribution of each sample to pdfs. */
+    for (fiter = fbegin; fiter != fend; ++fiter)
+    {
+      /** Read fixed coordinates and create some variables. */
+      const FixedImagePointType & fixedPoint = (*fiter).Value().m_ImageCoordinates;
+      RealType                    movingImageValue;
+      MovingImageDerivativeType   movingImageDerivative;
+      MovingImagePointType        mappedPoint;
 
-    /** Transform point and check if it is inside the B-spline support region. */
-    bool sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
+      /** Transform point and check if it is inside the B-spline support region. */
+      bool sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
 
-    /** Check if the point is inside the moving mask. */
-    if (sampleOk)
-    {
-      sampleOk = this->IsInsideMovingMask(mappedPoint);
-    }
+      /** Check if the point is inside the moving mask. */
+      if (sampleOk)
+      {
+        sampleOk = this->IsInsideMovingMask(mappedPoint);
+      }
 
-    /** Compute the moving image value, its derivative, and check
-     * if the point is inside the moving image buffer.
-     */
-    if (sampleOk)
-    {
-      sampleOk = this->EvaluateMovingImageValueAndDerivative(mappedPoint, movingImageValue, &movingImageDerivative);
-    }
+      /** Compute the moving image value, its derivative, and check
+       * if the point is inside the moving image buffer.
+       */
+      if (sampleOk)
+      {
+        sampleOk = this->EvaluateMovingImageValueAndDerivative(mappedPoint, movingImageValue, &movingImageDerivative);
+      }
 
-    if (sampleOk)
-    {
-      /** Get the fixed image value. */
-      RealType fixedImageValue = static_cast<RealType>((*fiter).Value().m_ImageValue);
+      if (sampleOk)
+      {
+        /** Get the fixed image value. */
+        RealType fixedImageValue = static_cast<RealType>((*fiter).Value().m_ImageValue);
 
-      /** Make sure the values fall within the histogram range. */
-      fixedImageValue = this->GetFixedImageLimiter()->Evaluate(fixedImageValue);
-      movingImageValue = this->GetMovingImageLimiter()->Evaluate(movingImageValue, movingImageDerivative);
+        /** Make sure the values fall within the histogram range. */
+        fixedImageValue = this->GetFixedImageLimiter()->Evaluate(fixedImageValue);
+        movingImageValue = this->GetMovingImageLimiter()->Evaluate(movingImageValue, movingImageDerivative);
 
 #if 0
-      /** Get the TransformJacobian dT/dmu. */
-      this->EvaluateTransformJacobian( fixedPoint, jacobian, nzji );
+        /** Get the TransformJacobian dT/dmu. */
+        this->EvaluateTransformJacobian( fixedPoint, jacobian, nzji );
 
-      /** Compute the inner products (dM/dx)^T (dT/dmu). */
-      this->EvaluateTransformJacobianInnerProduct(
-        jacobian, movingImageDerivative, imageJacobian );
+        /** Compute the inner products (dM/dx)^T (dT/dmu). */
+        this->EvaluateTransformJacobianInnerProduct(
+          jacobian, movingImageDerivative, imageJacobian );
 #else
-      /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
-      this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProduct(
-        fixedPoint, movingImageDerivative, imageJacobian, nzji);
+        /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
+        this->EvaluateTransformJacobianWithImageGradientProduct(
+          fixedPoint, movingImageDerivative, imageJacobian, nzji);
 #endif
 
-      /** If desired, apply the technique introduced by Tustison. */
-      TransformJacobianType jacobian;
-      if (this->GetUseJacobianPreconditioning())
-      {
-        this->EvaluateTransformJacobian(fixedPoint, jacobian, nzji);
-
-        this->ComputeJacobianPreconditioner(jacobian, nzji, jacobianPreconditioner, preconditioningDivisor);
-        DerivativeValueType * imjacit = imageJacobian.begin();
-        DerivativeValueType * jacprecit = jacobianPreconditioner.begin();
-        for (unsigned int i = 0; i < nzji.size(); ++i)
+        /** If desired, apply the technique introduced by Tustison. */
+        TransformJacobianType jacobian;
+        if (this->GetUseJacobianPreconditioning())
         {
-          while (imjacit != imageJacobian.end())
+          this->EvaluateTransformJacobian(fixedPoint, jacobian, nzji);
+
+          this->ComputeJacobianPreconditioner(jacobian, nzji, jacobianPreconditioner, preconditioningDivisor);
+          DerivativeValueType * imjacit = imageJacobian.begin();
+          DerivativeValueType * jacprecit = jacobianPreconditioner.begin();
+          for (unsigned int i = 0; i < nzji.size(); ++i)
           {
-            (*imjacit) *= (*jacprecit);
-            ++imjacit;
-            ++jacprecit;
+            while (imjacit != imageJacobian.end())
+            {
+              (*imjacit) *= (*jacprecit);
+              ++imjacit;
+              ++jacprecit;
+            }
           }
         }
-      }
 
-      /** Compute this sample's contribution to the joint distributions. */
-      this->UpdateDerivativeLowMemory(fixedImageValue, movingImageValue, imageJacobian, nzji, derivative);
+        /** Compute this sample's contribution to the joint distributions. */
+        this->TouchDerivativeTiles(threadId, nzji);
+        this->UpdateDerivativeLowMemory(fixedImageValue, movingImageValue, imageJacobian, nzji, derivative);
 
-    } // end sampleOk
-  }   // end loop over sample container
+      } // end sampleOk
+    }   // end loop over sample container
+  } // end while loop over the chunks
 
   /** If desired, apply the technique introduced by Tustison. */
   if (this->GetUseJacobianPreconditioning())
   {
+    /** The complete derivative is scaled, so it must be initialized completely. */
+    this->TouchDerivativeTiles(threadId);
+
     DerivativeValueType * derivit = derivative.begin();
     DerivativeValueType * divisit = preconditioningDivisor.begin();
 
@@ -607,9 +610,9 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Afte
     this->m_ThreaderMetricParameters.st_DerivativePointer = derivative.begin();
     this->m_ThreaderMetricParameters.st_NormalizationFactor = 1.0;
 
-    this->m_Threader->SetSingleMethod(this->AccumulateDerivativesThreaderCallback,
-                                      const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
-    this->m_Threader->SingleMethodExecute();
+    this->ExecuteThreaderCallback(this->AccumulateDerivativesThreaderCallback,
+                                  const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)),
+                                  TimingProfile::DerivativeAccumulation);
   }
 
 } // end AfterThreadedComputeDerivativeLowMemory()
@@ -647,13 +650,12 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage,
                                                 TMovingImage>::LaunchComputeDerivativeLowMemoryThreaderCallback(void)
   const
 {
-  /** Setup threader. */
-  this->m_Threader->SetSingleMethod(
-    this->ComputeDerivativeLowMemoryThreaderCallback,
-    const_cast<void *>(static_cast<const void *>(&this->m_ParzenWindowMutualInformationThreaderParameters)));
+  /** Distribute the samples over the work units. */
+  this->InitializeSampleChunks();
 
   /** Launch. */
-  this->m_Threader->SingleMethodExecute();
+  this->ExecuteThreaderCallback(this->ComputeDerivativeLowMemoryThreaderCallback,
+                                const_cast<void *>(static_cast<const void *>(&this->m_ParzenWindowMutualInformationThreaderParameters)));
 
 } // end LaunchComputeDerivativeLowMemoryThreaderCallback()
 
@@ -772,25 +774,26 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Upda
   const int movingParzenWindowIndex =
     static_cast<int>(std::floor(movingImageParzenWindowTerm + this->m_MovingParzenTermToIndexOffset));
 
-  /** Compute the fixed Parzen values. */
-  ParzenValueContainerType fixedParzenValues(this->m_JointPDFWindow.GetSize()[1]);
-  this->EvaluateParzenValues(
-    fixedImageParzenWindowTerm, fixedParzenWindowIndex, this->m_FixedKernel, fixedParzenValues);
+  /** Compute the fixed Parzen values, on the stack. */
+  const unsigned int numberOfFixedParzenValues = this->m_JointPDFWindow.GetSize()[1];
+  const unsigned int numberOfMovingParzenValues = this->m_JointPDFWindow.GetSize()[0];
+  PDFValueType       fixedParzenValues[Self::MaximumParzenWindowSize];
+  this->EvaluateFixedParzenValues(fixedImageParzenWindowTerm, fixedParzenWindowIndex, fixedParzenValues);
 
   /** Compute the derivatives of the moving Parzen window. */
-  ParzenValueContainerType derivativeMovingParzenValues(this->m_JointPDFWindow.GetSize()[0]);
-  this->EvaluateParzenValues(
-    movingImageParzenWindowTerm, movingParzenWindowIndex, this->m_DerivativeMovingKernel, derivativeMovingParzenValues);
+  PDFValueType derivativeMovingParzenValues[Self::MaximumParzenWindowSize];
+  this->m_DerivativeMovingKernel->Evaluate(static_cast<double>(movingParzenWindowIndex) - movingImageParzenWindowTerm,
+                                           derivativeMovingParzenValues);
 
   /** Get the moving image bin size. */
   const double et = static_cast<double>(this->m_MovingImageBinSize);
 
   /** Loop over the Parzen window region and increment sum. */
   PDFValueType sum = 0.0;
-  for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+  for (unsigned int f = 0; f < numberOfFixedParzenValues; ++f)
   {
     const double fv_et = fixedParzenValues[f] / et;
-    for (unsigned int m = 0; m < derivativeMovingParzenValues.GetSize(); ++m)
+    for (unsigned int m = 0; m < numberOfMovingParzenValues; ++m)
     {
       sum += this->m_PRatioArray[f + fixedParzenWindowIndex][m + movingParzenWindowIndex] * fv_et *
              derivativeMovingParzenValues[m];
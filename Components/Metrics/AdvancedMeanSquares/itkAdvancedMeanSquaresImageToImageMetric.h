@@ -78,6 +78,7 @@ public:
   typedef typename Superclass::FixedImageRegionType            FixedImageRegionType;
   typedef typename Superclass::TransformType                   TransformType;
   typedef typename Superclass::TransformPointer                TransformPointer;
+  typedef typename Superclass::AdvancedTransformType           AdvancedTransformType;
   typedef typename Superclass::InputPointType                  InputPointType;
   typedef typename Superclass::OutputPointType                 OutputPointType;
   typedef typename Superclass::TransformParametersType         TransformParametersType;
@@ -105,6 +106,7 @@ public:
   typedef typename Superclass::ImageSamplerPointer             ImageSamplerPointer;
   typedef typename Superclass::ImageSampleContainerType        ImageSampleContainerType;
   typedef typename Superclass::ImageSampleContainerPointer     ImageSampleContainerPointer;
+  typedef typename Superclass::ImageSampleSoAContainerType     ImageSampleSoAContainerType;
   typedef typename Superclass::FixedImageLimiterType           FixedImageLimiterType;
   typedef typename Superclass::MovingImageLimiterType          MovingImageLimiterType;
   typedef typename Superclass::FixedImageLimiterOutputType     FixedImageLimiterOutputType;
@@ -146,6 +148,21 @@ public:
                         MeasureType &                   value,
                         DerivativeType &                derivative) const override;
 
+  /** GetValueAndDerivative() only reads the transform, so it may run concurrently with other metrics. */
+  bool
+  GetSupportsConcurrentGetValueAndDerivative(void) const override
+  {
+    return true;
+  }
+
+  /** GetValueAndDerivative() reads the B-spline weights cache, when it is valid. */
+  bool
+  GetSupportsBSplineWeightsCache(void) const override
+  {
+    return true;
+  }
+
+
   /** Experimental feature: compute SelfHessian */
   void
   GetSelfHessian(const TransformParametersType & parameters, HessianType & H) const override;
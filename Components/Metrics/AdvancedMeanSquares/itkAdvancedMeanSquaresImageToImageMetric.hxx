@@ -20,9 +20,11 @@
 
 #include "itkAdvancedMeanSquaresImageToImageMetric.h"
 #include "vnl/algo/vnl_matrix_update.h"
-#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkRegistrationThreadState.h"
 #include "itkComputeImageExtremaFilter.h"
 
+#include <algorithm> // For std::min.
+
 #ifdef ELASTIX_USE_OPENMP
 #  include <omp.h>
 #endif
@@ -38,6 +40,7 @@ template <class TFixedImage, class TMovingImage>
 AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::AdvancedMeanSquaresImageToImageMetric()
 {
   this->SetUseImageSampler(true);
+  this->SetUseImageSampleSoAContainer(true);
   this->SetUseFixedImageLimiter(false);
   this->SetUseMovingImageLimiter(false);
 
@@ -315,70 +318,89 @@ template <class TFixedImage, class TMovingImage>
 void
 AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetValue(ThreadIdType threadId)
 {
-  /** Get a handle to the sample container. */
-  ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
-  const unsigned long         sampleContainerSize = sampleContainer->Size();
-
-  /** Get the samples for this thread. */
-  const unsigned long nrOfSamplesPerThreads = static_cast<unsigned long>(
-    std::ceil(static_cast<double>(sampleContainerSize) / static_cast<double>(Self::GetNumberOfWorkUnits())));
-
-  unsigned long pos_begin = nrOfSamplesPerThreads * threadId;
-  unsigned long pos_end = nrOfSamplesPerThreads * (threadId + 1);
-  pos_begin = (pos_begin > sampleContainerSize) ? sampleContainerSize : pos_begin;
-  pos_end = (pos_end > sampleContainerSize) ? sampleContainerSize : pos_end;
-
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator threader_fiter;
-  typename ImageSampleContainerType::ConstIterator threader_fbegin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator threader_fend = sampleContainer->Begin();
-
-  threader_fbegin += (int)pos_begin;
-  threader_fend += (int)pos_end;
+  /** Get a handle to the samples, stored as a structure of arrays. */
+  const ImageSampleSoAContainerType * samples = this->GetImageSampleSoAContainer();
 
   /** Create variables to store intermediate results. circumvent false sharing */
   unsigned long numberOfPixelsCounted = 0;
   MeasureType   measure = NumericTraits<MeasureType>::Zero;
 
-  /** Loop over the fixed image to calculate the mean squares. */
-  for (threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter)
-  {
-    /** Read fixed coordinates and initialize some variables. */
-    const FixedImagePointType & fixedPoint = (*threader_fiter).Value().m_ImageCoordinates;
-    RealType                    movingImageValue;
-    MovingImagePointType        mappedPoint;
+  /** Loop over the fixed image samples in blocks. The fixed points of a block
+   * are read from the sample container, and mapped with a single batched call.
+   */
+  const typename ImageSampleSoAContainerType::SampleValueType * fixedImageValues = samples->GetValues();
+  const unsigned long                                           blockSize = AdvancedTransformType::BatchBlockSize;
+  FixedImagePointType                                           fixedPoints[AdvancedTransformType::BatchBlockSize];
+  MovingImagePointType                                          mappedPoints[AdvancedTransformType::BatchBlockSize];
 
-    /** Transform point and check if it is inside the B-spline support region. */
-    bool sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
+  /** Use the B-spline weights cache, when it is available for these samples. */
+  const bool useBSplineWeightsCache = this->m_BSplineWeightsCache.m_IsValid;
 
-    /** Check if point is inside mask. */
-    if (sampleOk)
+  /** Process the chunks of samples that this thread gets from the scheduler.
+   * A thread first processes its own part of the sample container, and then
+   * helps the other threads, see GetNextSampleChunk().
+   */
+  SizeValueType pos_begin = 0;
+  SizeValueType pos_end = 0;
+  while (this->GetNextSampleChunk(threadId, pos_begin, pos_end))
+  {
+    for (unsigned long blockBegin = pos_begin; blockBegin < pos_end; blockBegin += blockSize)
     {
-      sampleOk = this->IsInsideMovingMask(mappedPoint); // thread-safe?
-    }
+      const unsigned long blockEnd = std::min(blockBegin + blockSize, pos_end);
 
-    /** Compute the moving image value M(T(x)) and check if
-     * the point is inside the moving image buffer.
-     */
-    if (sampleOk)
-    {
-      sampleOk = this->EvaluateMovingImageValueAndDerivative(mappedPoint, movingImageValue, nullptr);
-    }
+      /** Read the fixed coordinates and transform them. With the B-spline weights
+       * cache, only the coefficients of the support regions have to be gathered.
+       */
+      if (useBSplineWeightsCache)
+      {
+        for (unsigned long pos = blockBegin; pos < blockEnd; ++pos)
+        {
+          this->TransformPointUsingBSplineWeightsCache(pos, mappedPoints[pos - blockBegin]);
+        }
+      }
+      else
+      {
+        for (unsigned long pos = blockBegin; pos < blockEnd; ++pos)
+        {
+          samples->GetPoint(pos, fixedPoints[pos - blockBegin]);
+        }
+        this->TransformPointBatch(fixedPoints, mappedPoints, blockEnd - blockBegin);
+      }
 
-    if (sampleOk)
-    {
-      numberOfPixelsCounted++;
+      for (unsigned long pos = blockBegin; pos < blockEnd; ++pos)
+      {
+        /** Initialize some variables. */
+        const MovingImagePointType & mappedPoint = mappedPoints[pos - blockBegin];
+        RealType                     movingImageValue;
 
-      /** Get the fixed image value. */
-      const RealType & fixedImageValue = static_cast<RealType>((*threader_fiter).Value().m_ImageValue);
+        /** Check if point is inside mask. */
+        bool sampleOk = this->IsInsideMovingMask(mappedPoint); // thread-safe?
 
-      /** The difference squared. */
-      const RealType diff = movingImageValue - fixedImageValue;
-      measure += diff * diff;
+        /** Compute the moving image value M(T(x)) and check if
+         * the point is inside the moving image buffer.
+         */
+        if (sampleOk)
+        {
+          sampleOk = this->EvaluateMovingImageValueAndDerivative(mappedPoint, movingImageValue, nullptr);
+        }
 
-    } // end if sampleOk
+        if (sampleOk)
+        {
+          numberOfPixelsCounted++;
 
-  } // end for loop over the image sample container
+          /** Get the fixed image value. */
+          const RealType fixedImageValue = static_cast<RealType>(fixedImageValues[pos]);
+
+          /** The difference squared. */
+          const RealType diff = movingImageValue - fixedImageValue;
+          measure += diff * diff;
+
+        } // end if sampleOk
+
+      } // end for loop over the block
+
+    } // end for loop over the image samples
+  } // end while loop over the chunks
 
   /** Only update these variables at the end to prevent unnecessary "false sharing". */
   this->m_GetValueAndDerivativePerThreadVariables[threadId].st_NumberOfPixelsCounted = numberOfPixelsCounted;
@@ -539,7 +561,7 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::GetValueAndDer
         jacobian, movingImageDerivative, imageJacobian );
 #else
       /** Compute the inner product of the transform Jacobian and the moving image gradient. */
-      this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProduct(
+      this->EvaluateTransformJacobianWithImageGradientProduct(
         fixedPoint, movingImageDerivative, imageJacobian, nzji);
 #endif
 
@@ -629,83 +651,113 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetVal
    */
   DerivativeType & derivative = this->m_GetValueAndDerivativePerThreadVariables[threadId].st_Derivative;
 
-  /** Get a handle to the sample container. */
-  ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
-  const unsigned long         sampleContainerSize = sampleContainer->Size();
-
-  /** Get the samples for this thread. */
-  const unsigned long nrOfSamplesPerThreads = static_cast<unsigned long>(
-    std::ceil(static_cast<double>(sampleContainerSize) / static_cast<double>(Self::GetNumberOfWorkUnits())));
-
-  unsigned long pos_begin = nrOfSamplesPerThreads * threadId;
-  unsigned long pos_end = nrOfSamplesPerThreads * (threadId + 1);
-  pos_begin = (pos_begin > sampleContainerSize) ? sampleContainerSize : pos_begin;
-  pos_end = (pos_end > sampleContainerSize) ? sampleContainerSize : pos_end;
-
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator threader_fiter;
-  typename ImageSampleContainerType::ConstIterator threader_fbegin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator threader_fend = sampleContainer->Begin();
-
-  threader_fbegin += (int)pos_begin;
-  threader_fend += (int)pos_end;
+  /** Get a handle to the samples, stored as a structure of arrays. */
+  const ImageSampleSoAContainerType * samples = this->GetImageSampleSoAContainer();
 
   /** Create variables to store intermediate results. circumvent false sharing */
   unsigned long numberOfPixelsCounted = 0;
   MeasureType   measure = NumericTraits<MeasureType>::Zero;
 
-  /** Loop over the fixed image to calculate the mean squares. */
-  for (threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter)
-  {
-    /** Read fixed coordinates and initialize some variables. */
-    const FixedImagePointType & fixedPoint = (*threader_fiter).Value().m_ImageCoordinates;
-    RealType                    movingImageValue;
-    MovingImagePointType        mappedPoint;
-    MovingImageDerivativeType   movingImageDerivative;
-
-    /** Transform point and check if it is inside the B-spline support region. */
-    bool sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
+  /** Loop over the fixed image samples in blocks. The fixed points of a block
+   * are read from the sample container, and mapped with a single batched call.
+   */
+  const typename ImageSampleSoAContainerType::SampleValueType * fixedImageValues = samples->GetValues();
+  const unsigned long                                           blockSize = AdvancedTransformType::BatchBlockSize;
+  FixedImagePointType                                           fixedPoints[AdvancedTransformType::BatchBlockSize];
+  MovingImagePointType                                          mappedPoints[AdvancedTransformType::BatchBlockSize];
 
-    /** Check if point is inside mask. */
-    if (sampleOk)
-    {
-      sampleOk = this->IsInsideMovingMask(mappedPoint); // thread-safe?
-    }
+  /** Use the B-spline weights cache, when it is available for these samples. */
+  const bool useBSplineWeightsCache = this->m_BSplineWeightsCache.m_IsValid;
 
-    /** Compute the moving image value M(T(x)) and derivative dM/dx and check if
-     * the point is inside the moving image buffer.
-     */
-    if (sampleOk)
+  /** Process the chunks of samples that this thread gets from the scheduler.
+   * A thread first processes its own part of the sample container, and then
+   * helps the other threads, see GetNextSampleChunk().
+   */
+  SizeValueType pos_begin = 0;
+  SizeValueType pos_end = 0;
+  while (this->GetNextSampleChunk(threadId, pos_begin, pos_end))
+  {
+    for (unsigned long blockBegin = pos_begin; blockBegin < pos_end; blockBegin += blockSize)
     {
-      sampleOk = this->EvaluateMovingImageValueAndDerivative(mappedPoint, movingImageValue, &movingImageDerivative);
-    }
+      const unsigned long blockEnd = std::min(blockBegin + blockSize, pos_end);
 
-    if (sampleOk)
-    {
-      numberOfPixelsCounted++;
+      /** Read the fixed coordinates and transform them. With the B-spline weights
+       * cache, only the coefficients of the support regions have to be gathered.
+       */
+      if (useBSplineWeightsCache)
+      {
+        for (unsigned long pos = blockBegin; pos < blockEnd; ++pos)
+        {
+          this->TransformPointUsingBSplineWeightsCache(pos, mappedPoints[pos - blockBegin]);
+        }
+      }
+      else
+      {
+        for (unsigned long pos = blockBegin; pos < blockEnd; ++pos)
+        {
+          samples->GetPoint(pos, fixedPoints[pos - blockBegin]);
+        }
+        this->TransformPointBatch(fixedPoints, mappedPoints, blockEnd - blockBegin);
+      }
 
-      /** Get the fixed image value. */
-      const RealType & fixedImageValue = static_cast<RealType>((*threader_fiter).Value().m_ImageValue);
+      for (unsigned long pos = blockBegin; pos < blockEnd; ++pos)
+      {
+        /** Initialize some variables. */
+        const FixedImagePointType &  fixedPoint = fixedPoints[pos - blockBegin];
+        const MovingImagePointType & mappedPoint = mappedPoints[pos - blockBegin];
+        RealType                     movingImageValue;
+        MovingImageDerivativeType    movingImageDerivative;
+
+        /** Check if point is inside mask. */
+        bool sampleOk = this->IsInsideMovingMask(mappedPoint); // thread-safe?
+
+        /** Compute the moving image value M(T(x)) and derivative dM/dx and check if
+         * the point is inside the moving image buffer.
+         */
+        if (sampleOk)
+        {
+          sampleOk = this->EvaluateMovingImageValueAndDerivative(mappedPoint, movingImageValue, &movingImageDerivative);
+        }
+
+        if (sampleOk)
+        {
+          numberOfPixelsCounted++;
+
+          /** Get the fixed image value. */
+          const RealType fixedImageValue = static_cast<RealType>(fixedImageValues[pos]);
 
 #if 0
-      /** Get the TransformJacobian dT/dmu. */
-      this->EvaluateTransformJacobian( fixedPoint, jacobian, nzji );
+          /** Get the TransformJacobian dT/dmu. */
+          this->EvaluateTransformJacobian( fixedPoint, jacobian, nzji );
 
-      /** Compute the inner products (dM/dx)^T (dT/dmu). */
-      this->EvaluateTransformJacobianInnerProduct(
-        jacobian, movingImageDerivative, imageJacobian );
+          /** Compute the inner products (dM/dx)^T (dT/dmu). */
+          this->EvaluateTransformJacobianInnerProduct(
+            jacobian, movingImageDerivative, imageJacobian );
 #else
-      /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
-      this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProduct(
-        fixedPoint, movingImageDerivative, imageJacobian, nzji);
+          /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
+          if (useBSplineWeightsCache)
+          {
+            this->EvaluateJacobianWithImageGradientProductUsingBSplineWeightsCache(
+              pos, movingImageDerivative, imageJacobian, nzji);
+          }
+          else
+          {
+            this->EvaluateTransformJacobianWithImageGradientProduct(
+              fixedPoint, movingImageDerivative, imageJacobian, nzji);
+          }
 #endif
 
-      /** Compute this pixel's contribution to the measure and derivatives. */
-      this->UpdateValueAndDerivativeTerms(fixedImageValue, movingImageValue, imageJacobian, nzji, measure, derivative);
+          /** Compute this pixel's contribution to the measure and derivatives. */
+          this->TouchDerivativeTiles(threadId, nzji);
+          this->UpdateValueAndDerivativeTerms(
+            fixedImageValue, movingImageValue, imageJacobian, nzji, measure, derivative);
 
-    } // end if sampleOk
+        } // end if sampleOk
 
-  } // end for loop over the image sample container
+      } // end for loop over the block
+
+    } // end for loop over the image samples
+  } // end while loop over the chunks
 
   /** Only update these variables at the end to prevent unnecessary "false sharing". */
   this->m_GetValueAndDerivativePerThreadVariables[threadId].st_NumberOfPixelsCounted = numberOfPixelsCounted;
@@ -771,9 +823,9 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::AfterThreadedG
     this->m_ThreaderMetricParameters.st_DerivativePointer = derivative.begin();
     this->m_ThreaderMetricParameters.st_NormalizationFactor = 1.0 / normal_sum;
 
-    this->m_Threader->SetSingleMethod(this->AccumulateDerivativesThreaderCallback,
-                                      const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
-    this->m_Threader->SingleMethodExecute();
+    this->ExecuteThreaderCallback(this->AccumulateDerivativesThreaderCallback,
+                                  const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)),
+                                  TimingProfile::DerivativeAccumulation);
   }
 #ifdef ELASTIX_USE_OPENMP
   // compute multi-threadedly with openmp
@@ -857,7 +909,7 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::GetSelfHessian
 
   /** Initialize some variables. */
   this->m_NumberOfPixelsCounted = 0;
-  RandomGeneratorType::Pointer randomGenerator = RandomGeneratorType::GetInstance();
+  RandomGeneratorType::Pointer randomGenerator = RegistrationThreadState::GetRandomGenerator();
   randomGenerator->Initialize();
 
   /** Array that stores dM(x)/dmu, and the sparse jacobian+indices. */
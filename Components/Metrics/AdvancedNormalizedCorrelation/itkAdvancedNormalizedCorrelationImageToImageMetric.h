@@ -172,6 +172,14 @@ public:
                         MeasureType &                   value,
                         DerivativeType &                derivative) const override;
 
+  /** GetValueAndDerivative() only reads the transform, so it may run concurrently with other metrics. */
+  bool
+  GetSupportsConcurrentGetValueAndDerivative(void) const override
+  {
+    return true;
+  }
+
+
   /** Set/Get SubtractMean boolean. If true, the sample mean is subtracted
    * from the sample values in the cross-correlation formula and
    * typically results in narrower valleys in the cost function.
@@ -142,6 +142,14 @@ public:
                         MeasureType &          value,
                         DerivativeType &       derivative) const override;
 
+  /** GetValueAndDerivative() only reads the transform, so it may run concurrently with other metrics. */
+  bool
+  GetSupportsConcurrentGetValueAndDerivative(void) const override
+  {
+    return true;
+  }
+
+
   /** Get value and derivatives for each thread. */
   inline void
   ThreadedGetValueAndDerivative(ThreadIdType threadID) override;
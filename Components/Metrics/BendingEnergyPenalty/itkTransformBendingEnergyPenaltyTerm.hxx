@@ -422,136 +422,136 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::ThreadedGetValueAnd
 
   /** Get a handle to the sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
-  const unsigned long         sampleContainerSize = sampleContainer->Size();
-
-  /** Get the samples for this thread. */
-  const unsigned long nrOfSamplesPerThreads = static_cast<unsigned long>(
-    std::ceil(static_cast<double>(sampleContainerSize) / static_cast<double>(Self::GetNumberOfWorkUnits())));
-
-  unsigned long pos_begin = nrOfSamplesPerThreads * threadId;
-  unsigned long pos_end = nrOfSamplesPerThreads * (threadId + 1);
-  pos_begin = (pos_begin > sampleContainerSize) ? sampleContainerSize : pos_begin;
-  pos_end = (pos_end > sampleContainerSize) ? sampleContainerSize : pos_end;
-
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator fiter;
-  typename ImageSampleContainerType::ConstIterator fbegin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator fend = sampleContainer->Begin();
-  fbegin += (int)pos_begin;
-  fend += (int)pos_end;
 
   /** Create variables to store intermediate results. circumvent false sharing */
   unsigned long numberOfPixelsCounted = 0;
   MeasureType   measure = NumericTraits<MeasureType>::Zero;
 
-  /** Loop over the fixed image to calculate the penalty term and its derivative. */
-  for (fiter = fbegin; fiter != fend; ++fiter)
+  /** Process the chunks of samples that this thread gets from the scheduler.
+   * A thread first processes its own part of the sample container, and then
+   * helps the other threads, see GetNextSampleChunk().
+   */
+  SizeValueType pos_begin = 0;
+  SizeValueType pos_end = 0;
+  while (this->GetNextSampleChunk(threadId, pos_begin, pos_end))
   {
-    /** Read fixed coordinates and initialize some variables. */
-    const FixedImagePointType & fixedPoint = (*fiter).Value().m_ImageCoordinates;
-    MovingImagePointType        mappedPoint;
-
-    /** Although the mapped point is not needed to compute the penalty term,
-     * we compute in order to check if it maps inside the support region of
-     * the B-spline and if it maps inside the moving image mask.
-     */
-
-    /** Transform point and check if it is inside the B-spline support region. */
-    bool sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
-
-    /** Check if point is inside mask. */
-    if (sampleOk)
-    {
-      sampleOk = this->IsInsideMovingMask(mappedPoint);
-    }
-
-    if (sampleOk)
+    /** Create iterator over the samples of this chunk. */
+    typename ImageSampleContainerType::ConstIterator fiter;
+    typename ImageSampleContainerType::ConstIterator fbegin = sampleContainer->Begin();
+    typename ImageSampleContainerType::ConstIterator fend = sampleContainer->Begin();
+    fbegin += (int)pos_begin;
+    fend += (int)pos_end;
+
+    /** Loop over the fixed image to calculate the penalty term and its derivative. */
+    for (fiter = fbegin; fiter != fend; ++fiter)
     {
-      numberOfPixelsCounted++;
+      /** Read fixed coordinates and initialize some variables. */
+      const FixedImagePointType & fixedPoint = (*fiter).Value().m_ImageCoordinates;
+      MovingImagePointType        mappedPoint;
 
-      /** Get the spatial Hessian of the transformation at the current point.
-       * This is needed to compute the bending energy.
+      /** Although the mapped point is not needed to compute the penalty term,
+       * we compute in order to check if it maps inside the support region of
+       * the B-spline and if it maps inside the moving image mask.
        */
-      this->m_AdvancedTransform->GetJacobianOfSpatialHessian(
-        fixedPoint, spatialHessian, jacobianOfSpatialHessian, nonZeroJacobianIndices);
 
-      /** Prepare some stuff for the computation of the metric (derivative). */
-      FixedArray<InternalMatrixType, FixedImageDimension> A;
-      for (unsigned int k = 0; k < FixedImageDimension; ++k)
-      {
-        A[k] = spatialHessian[k].GetVnlMatrix();
-      }
+      /** Transform point and check if it is inside the B-spline support region. */
+      bool sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
 
-      /** Compute the contribution to the metric value of this point. */
-      for (unsigned int k = 0; k < FixedImageDimension; ++k)
+      /** Check if point is inside mask. */
+      if (sampleOk)
       {
-        measure += vnl_math::sqr(A[k].frobenius_norm());
+        sampleOk = this->IsInsideMovingMask(mappedPoint);
       }
 
-      /** Make a distinction between a B-spline transform and other transforms. */
-      if (!transformIsBSpline)
+      if (sampleOk)
       {
-        /** Compute the contribution to the metric derivative of this point. */
-        for (unsigned int mu = 0; mu < nonZeroJacobianIndices.size(); ++mu)
-        {
-          for (unsigned int k = 0; k < FixedImageDimension; ++k)
-          {
-            /** This computes:
-             * \sum_i \sum_j A_ij B_ij = element_product(A,B).mean()*B.size()
-             */
-            const InternalMatrixType & B = jacobianOfSpatialHessian[mu][k].GetVnlMatrix();
+        numberOfPixelsCounted++;
 
-            RealType                                    matrixElementProduct = 0.0;
-            typename InternalMatrixType::const_iterator itA = A[k].begin();
-            typename InternalMatrixType::const_iterator itB = B.begin();
-            typename InternalMatrixType::const_iterator itAend = A[k].end();
-            while (itA != itAend)
-            {
-              matrixElementProduct += (*itA) * (*itB);
-              ++itA;
-              ++itB;
-            }
+        /** Get the spatial Hessian of the transformation at the current point.
+         * This is needed to compute the bending energy.
+         */
+        this->m_AdvancedTransform->GetJacobianOfSpatialHessian(
+          fixedPoint, spatialHessian, jacobianOfSpatialHessian, nonZeroJacobianIndices);
+        this->TouchDerivativeTiles(threadId, nonZeroJacobianIndices);
 
-            derivative[nonZeroJacobianIndices[mu]] += 2.0 * matrixElementProduct;
-          }
+        /** Prepare some stuff for the computation of the metric (derivative). */
+        FixedArray<InternalMatrixType, FixedImageDimension> A;
+        for (unsigned int k = 0; k < FixedImageDimension; ++k)
+        {
+          A[k] = spatialHessian[k].GetVnlMatrix();
         }
-      }
-      else
-      {
-        /** For the B-spline transform we know that only 1/FixedImageDimension
-         * part of the JacobianOfSpatialHessian is non-zero.
-         *
-         * In addition we know that jsh[ mu + numParPerDim * k ][ k ] is the same for all k.
-         */
 
-        /** Compute the contribution to the metric derivative of this point. */
-        const unsigned int numParPerDim = nonZeroJacobianIndices.size() / FixedImageDimension;
-        for (unsigned int mu = 0; mu < numParPerDim; ++mu)
+        /** Compute the contribution to the metric value of this point. */
+        for (unsigned int k = 0; k < FixedImageDimension; ++k)
         {
-          const InternalMatrixType & B = jacobianOfSpatialHessian[mu + numParPerDim * 0][0].GetVnlMatrix();
+          measure += vnl_math::sqr(A[k].frobenius_norm());
+        }
 
-          for (unsigned int k = 0; k < FixedImageDimension; ++k)
+        /** Make a distinction between a B-spline transform and other transforms. */
+        if (!transformIsBSpline)
+        {
+          /** Compute the contribution to the metric derivative of this point. */
+          for (unsigned int mu = 0; mu < nonZeroJacobianIndices.size(); ++mu)
           {
-            /** This computes:
-             * \sum_i \sum_j A_ij B_ij = element_product(A,B).mean()*B.size()
-             */
-            RealType                                    matrixElementProduct = 0.0;
-            typename InternalMatrixType::const_iterator itA = A[k].begin();
-            typename InternalMatrixType::const_iterator itB = B.begin();
-            typename InternalMatrixType::const_iterator itAend = A[k].end();
-            while (itA != itAend)
+            for (unsigned int k = 0; k < FixedImageDimension; ++k)
             {
-              matrixElementProduct += (*itA) * (*itB);
-              ++itA;
-              ++itB;
+              /** This computes:
+               * \sum_i \sum_j A_ij B_ij = element_product(A,B).mean()*B.size()
+               */
+              const InternalMatrixType & B = jacobianOfSpatialHessian[mu][k].GetVnlMatrix();
+
+              RealType                                    matrixElementProduct = 0.0;
+              typename InternalMatrixType::const_iterator itA = A[k].begin();
+              typename InternalMatrixType::const_iterator itB = B.begin();
+              typename InternalMatrixType::const_iterator itAend = A[k].end();
+              while (itA != itAend)
+              {
+                matrixElementProduct += (*itA) * (*itB);
+                ++itA;
+                ++itB;
+              }
+
+              derivative[nonZeroJacobianIndices[mu]] += 2.0 * matrixElementProduct;
             }
-
-            derivative[nonZeroJacobianIndices[mu + numParPerDim * k]] += 2.0 * matrixElementProduct;
           }
         }
-      } // end if B-spline
-    }   // end if sampleOk
-  }     // end for loop over the image sample container
+        else
+        {
+          /** For the B-spline transform we know that only 1/FixedImageDimension
+           * part of the JacobianOfSpatialHessian is non-zero.
+           *
+           * In addition we know that jsh[ mu + numParPerDim * k ][ k ] is the same for all k.
+           */
+
+          /** Compute the contribution to the metric derivative of this point. */
+          const unsigned int numParPerDim = nonZeroJacobianIndices.size() / FixedImageDimension;
+          for (unsigned int mu = 0; mu < numParPerDim; ++mu)
+          {
+            const InternalMatrixType & B = jacobianOfSpatialHessian[mu + numParPerDim * 0][0].GetVnlMatrix();
+
+            for (unsigned int k = 0; k < FixedImageDimension; ++k)
+            {
+              /** This computes:
+               * \sum_i \sum_j A_ij B_ij = element_product(A,B).mean()*B.size()
+               */
+              RealType                                    matrixElementProduct = 0.0;
+              typename InternalMatrixType::const_iterator itA = A[k].begin();
+              typename InternalMatrixType::const_iterator itB = B.begin();
+              typename InternalMatrixType::const_iterator itAend = A[k].end();
+              while (itA != itAend)
+              {
+                matrixElementProduct += (*itA) * (*itB);
+                ++itA;
+                ++itB;
+              }
+
+              derivative[nonZeroJacobianIndices[mu + numParPerDim * k]] += 2.0 * matrixElementProduct;
+            }
+          }
+        } // end if B-spline
+      }   // end if sampleOk
+    }     // end for loop over the image sample container
+  } // end while loop over the chunks
 
   /** Only update these variables at the end to prevent unnecessary "false sharing". */
   this->m_GetValueAndDerivativePerThreadVariables[threadId].st_NumberOfPixelsCounted = numberOfPixelsCounted;
@@ -617,9 +617,9 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::AfterThreadedGetVal
     this->m_ThreaderMetricParameters.st_NormalizationFactor =
       static_cast<DerivativeValueType>(this->m_NumberOfPixelsCounted);
 
-    this->m_Threader->SetSingleMethod(this->AccumulateDerivativesThreaderCallback,
-                                      const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
-    this->m_Threader->SingleMethodExecute();
+    this->ExecuteThreaderCallback(this->AccumulateDerivativesThreaderCallback,
+                                  const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)),
+                                  TimingProfile::DerivativeAccumulation);
   }
 #ifdef ELASTIX_USE_OPENMP
   // compute multi-threadedly with openmp
@@ -90,6 +90,14 @@ public:
                         MeasureType &                   Value,
                         DerivativeType &                Derivative) const override;
 
+  /** GetValueAndDerivative() only reads the transform, so it may run concurrently with other metrics. */
+  bool
+  GetSupportsConcurrentGetValueAndDerivative(void) const override
+  {
+    return true;
+  }
+
+
 protected:
   CorrespondingPointsEuclideanDistancePointMetric();
   ~CorrespondingPointsEuclideanDistancePointMetric() override = default;
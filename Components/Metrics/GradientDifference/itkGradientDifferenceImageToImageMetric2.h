@@ -45,6 +45,9 @@
 #include "itkAdvancedCombinationTransform.h"
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace itk
 {
 /** \class GradientDifferenceImageToImageMetric
@@ -69,6 +72,16 @@ namespace itk
  * Cerebral Angiograms,", IEEE Transactions on Medical Imaging,
  * 22(11):1417-1426.
  *
+ * With an AdvancedRayCastInterpolateImageFunction the moving image is projected
+ * onto the fixed image (2D-3D registration), and the derivative is computed by
+ * finite differences, because the ray caster does not provide the derivative of
+ * the projection. The parameters are then evaluated concurrently, each work unit
+ * with its own copy of the projection pipeline and the transform. With any other
+ * interpolator the moving image is sampled at the pixels of the fixed image, and
+ * the derivative is computed analytically, through the adjoint of the Sobel
+ * filters, the moving image gradient and the transform Jacobian. The subtraction
+ * factors are considered constant for the derivative.
+ *
  * \ingroup RegistrationMetrics
  */
 template <class TFixedImage, class TMovingImage>
@@ -114,6 +127,9 @@ public:
   typedef typename MovingImageType::RegionType         MovingImageRegionType;
   typedef typename itk::Optimizer                      OptimizerType;
   typedef typename OptimizerType::ScalesType           ScalesType;
+  typedef typename Superclass::FixedImageRegionType    FixedImageRegionType;
+  typedef typename Superclass::DerivativeValueType     DerivativeValueType;
+  typedef typename Superclass::NumberOfParametersType  NumberOfParametersType;
 
   itkStaticConstMacro(FixedImageDimension, unsigned int, FixedImageType::ImageDimension);
   itkStaticConstMacro(MovedImageDimension, unsigned int, MovingImageType::ImageDimension);
@@ -173,6 +189,12 @@ protected:
   void
   ComputeMovedGradientRange(void) const;
 
+  /** Compute the subtraction factors from the maximum fixed image gradients and the maximum
+   * moved image gradients of the last call to ComputeMovedGradientRange() or ComputeMovedSobelGradients().
+   */
+  void
+  ComputeSubtractionFactors(MovedGradientPixelType * subtractionFactor) const;
+
   /** Compute the variance and range of the moving image gradients. */
   void
   ComputeVariance(void) const;
@@ -181,10 +203,112 @@ protected:
   MeasureType
   ComputeMeasure(const TransformParametersType & parameters, const double * subtractionFactor) const;
 
+  /** Compute the similarity measure of the specified moved gradient images, for ComputeMeasure(). */
+  MeasureType
+  ComputeMeasureOfGradientImages(const MovedGradientImageType * const * movedGradientImages,
+                                 const double *                         subtractionFactor) const;
+
   typedef NeighborhoodOperatorImageFilter<FixedGradientImageType, FixedGradientImageType> FixedSobelFilter;
 
   typedef NeighborhoodOperatorImageFilter<MovedGradientImageType, MovedGradientImageType> MovedSobelFilter;
 
+  /** Typedefs for the concurrent finite differences. */
+  typedef typename Superclass::AdvancedTransformType AdvancedTransformType;
+  typedef typename AdvancedTransformType::Pointer    AdvancedTransformPointer;
+
+  /** A copy of the projection pipeline of the ray casting mode, with its own copy of the
+   * transform and its own references to the moving image, so that the finite differences
+   * of the derivative can be evaluated concurrently.
+   */
+  struct ProjectionPipelineType
+  {
+    AdvancedTransformPointer                                 m_Transform;
+    RayCastInterpolatorPointer                               m_Interpolator;
+    typename TransformMovingImageFilterType::Pointer         m_TransformMovingImageFilter;
+    CastMovedImageFilterPointer                              m_CastMovedImageFilter;
+    ZeroFluxNeumannBoundaryCondition<MovedGradientImageType> m_MovedBoundCond;
+    typename MovedSobelFilter::Pointer                       m_MovedSobelFilters[MovedImageDimension];
+  };
+
+  /** Create a copy of the projection pipeline, whose filters use the specified number of
+   * work units. Returns false when the transform cannot be copied.
+   */
+  bool
+  CreateProjectionPipeline(ProjectionPipelineType & pipeline, ThreadIdType numberOfFilterWorkUnits) const;
+
+  /** Compute the value for the current parameters of the transform of a projection pipeline,
+   * like GetValue() does in the ray casting mode.
+   */
+  MeasureType
+  ComputeProjectionValue(ProjectionPipelineType & pipeline) const;
+
+  /** Typedefs for the analytic derivative. */
+  typedef typename Superclass::FixedImageIndexType        FixedImageIndexType;
+  typedef typename Superclass::FixedImagePointType        FixedImagePointType;
+  typedef typename Superclass::MovingImagePointType       MovingImagePointType;
+  typedef typename Superclass::MovingImageDerivativeType  MovingImageDerivativeType;
+  typedef typename Superclass::NonZeroJacobianIndicesType NonZeroJacobianIndicesType;
+  typedef typename FixedImageType::OffsetType             FixedImageOffsetType;
+
+  /** Sample the moving image at the pixels of the fixed image, and optionally its
+   * gradient. Only used for the analytic derivative.
+   */
+  void
+  ComputeMovedValues(bool computeGradient) const;
+
+  /** Compute the Sobel gradients of the sampled moving image, with the same boundary
+   * condition as the Sobel filters, and their range. Only used for the analytic derivative.
+   */
+  void
+  ComputeMovedSobelGradients(void) const;
+
+  /** Compute the similarity measure from the Sobel gradients of the sampled moving image,
+   * like ComputeMeasure(). Optionally the derivative of the measure to each moving image
+   * value is computed as well. Only used for the analytic derivative.
+   */
+  MeasureType
+  ComputeMeasureAndMovedValueDerivatives(const MovedGradientPixelType * subtractionFactor,
+                                         bool                           computeDerivatives) const;
+
+  /** Get the index of the fixed image pixel at position pos in the sampled moving image. */
+  FixedImageIndexType
+  GetGridIndex(SizeValueType pos) const
+  {
+    FixedImageIndexType index = this->m_GridRegion.GetIndex();
+    for (unsigned int i = 0; i < FixedImageDimension; ++i)
+    {
+      index[i] += static_cast<IndexValueType>(pos % this->m_GridRegion.GetSize(i));
+      pos /= this->m_GridRegion.GetSize(i);
+    }
+    return index;
+  }
+
+  /** Get the position in the sampled moving image of the nearest pixel to an index, which
+   * is the zero flux Neumann boundary condition of the Sobel filters.
+   */
+  SizeValueType
+  GetClampedGridPosition(const FixedImageIndexType & index) const
+  {
+    SizeValueType pos = 0;
+    SizeValueType stride = 1;
+    for (unsigned int i = 0; i < FixedImageDimension; ++i)
+    {
+      const IndexValueType first = this->m_GridRegion.GetIndex(i);
+      const IndexValueType last = first + static_cast<IndexValueType>(this->m_GridRegion.GetSize(i)) - 1;
+      pos += static_cast<SizeValueType>(std::min(std::max(index[i], first), last) - first) * stride;
+      stride *= this->m_GridRegion.GetSize(i);
+    }
+    return pos;
+  }
+
+  /** Compute the analytic derivative of the pixels that this thread gets from the scheduler. */
+  void
+  ThreadedGetValueAndDerivative(ThreadIdType threadID) override;
+
+  /** Gather the derivatives of all threads. */
+  void
+  AfterThreadedGetValueAndDerivative(MeasureType & value, DerivativeType & derivative) const override;
+
 private:
   GradientDifferenceImageToImageMetric(const Self &) = delete;
   void
@@ -227,6 +351,24 @@ private:
   double                      m_DerivativeDelta;
   double                      m_Rescalingfactor;
   CombinationTransformPointer m_CombinationTransform;
+
+  /** Variables for the analytic derivative. The grid region is the fixed image region at
+   * which the moving image is sampled; the vectors store per grid pixel, and the gradients
+   * per grid pixel and dimension. The Sobel operators are stored by their nonzero taps.
+   */
+  bool                                           m_UseAnalyticDerivative;
+  FixedImageRegionType                           m_GridRegion;
+  std::vector<FixedImageOffsetType>              m_SobelOffsets[FixedImageDimension];
+  std::vector<MovedGradientPixelType>            m_SobelWeights[FixedImageDimension];
+  OffsetValueType                                m_SobelRadius;
+  std::vector<FixedGradientPixelType>            m_FixedSobelGradients;
+  std::vector<unsigned char>                     m_FixedPixelIsValid;
+  mutable std::vector<RealType>                  m_MovedValues;
+  mutable std::vector<MovingImageDerivativeType> m_MovedGradients;
+  mutable std::vector<unsigned char>             m_MovedPixelIsInside;
+  mutable std::vector<MovedGradientPixelType>    m_MovedSobelGradients;
+  mutable std::vector<MovedGradientPixelType>    m_MovedSobelGradientDerivatives;
+  mutable std::vector<DerivativeValueType>       m_MovedValueDerivatives;
 };
 
 } // end namespace itk
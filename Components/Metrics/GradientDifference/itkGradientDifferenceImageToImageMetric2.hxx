@@ -77,6 +77,8 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::GradientDiffere
 
   this->m_DerivativeDelta = 0.001;
   this->m_Rescalingfactor = 1.0;
+  this->m_UseAnalyticDerivative = false;
+  this->m_SobelRadius = 0;
 }
 
 
@@ -111,36 +113,97 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::Initialize(void
   /** Resampling for 3D->2D */
   RayCastInterpolatorType * rayCaster =
     dynamic_cast<RayCastInterpolatorType *>(const_cast<InterpolatorType *>(this->GetInterpolator()));
-  if (rayCaster != nullptr)
+  this->m_UseAnalyticDerivative = rayCaster == nullptr;
+  if (!this->m_UseAnalyticDerivative)
   {
     this->m_TransformMovingImageFilter->SetTransform(rayCaster->GetTransform());
+    this->m_TransformMovingImageFilter->SetInterpolator(this->m_Interpolator);
+    this->m_TransformMovingImageFilter->SetInput(this->m_MovingImage);
+    this->m_TransformMovingImageFilter->SetDefaultPixelValue(0);
+    this->m_TransformMovingImageFilter->SetSize(this->m_FixedImage->GetLargestPossibleRegion().GetSize());
+    this->m_TransformMovingImageFilter->SetOutputOrigin(this->m_FixedImage->GetOrigin());
+    this->m_TransformMovingImageFilter->SetOutputSpacing(this->m_FixedImage->GetSpacing());
+    this->m_TransformMovingImageFilter->SetOutputDirection(this->m_FixedImage->GetDirection());
+    this->m_TransformMovingImageFilter->Update();
+
+    this->m_CastMovedImageFilter->SetInput(this->m_TransformMovingImageFilter->GetOutput());
+
+    for (iFilter = 0; iFilter < MovedImageDimension; iFilter++)
+    {
+      this->m_MovedSobelOperators[iFilter].SetDirection(iFilter);
+      this->m_MovedSobelOperators[iFilter].CreateDirectional();
+      this->m_MovedSobelFilters[iFilter] = MovedSobelFilter::New();
+      this->m_MovedSobelFilters[iFilter]->OverrideBoundaryCondition(&this->m_MovedBoundCond);
+      this->m_MovedSobelFilters[iFilter]->SetOperator(this->m_MovedSobelOperators[iFilter]);
+      this->m_MovedSobelFilters[iFilter]->SetInput(this->m_CastMovedImageFilter->GetOutput());
+      this->m_MovedSobelFilters[iFilter]->UpdateLargestPossibleRegion();
+    }
   }
   else
   {
-    itkExceptionMacro(<< "ERROR: the NormalizedGradientCorrelationImageToImageMetric is currently "
-                      << "only suitable for 2D-3D registration.\n"
-                      << "  Therefore it expects an interpolator of type RayCastInterpolator.");
-  }
-  this->m_TransformMovingImageFilter->SetInterpolator(this->m_Interpolator);
-  this->m_TransformMovingImageFilter->SetInput(this->m_MovingImage);
-  this->m_TransformMovingImageFilter->SetDefaultPixelValue(0);
-  this->m_TransformMovingImageFilter->SetSize(this->m_FixedImage->GetLargestPossibleRegion().GetSize());
-  this->m_TransformMovingImageFilter->SetOutputOrigin(this->m_FixedImage->GetOrigin());
-  this->m_TransformMovingImageFilter->SetOutputSpacing(this->m_FixedImage->GetSpacing());
-  this->m_TransformMovingImageFilter->SetOutputDirection(this->m_FixedImage->GetDirection());
-  this->m_TransformMovingImageFilter->Update();
+    /** The analytic derivative needs the sparse Jacobian of an advanced transform. */
+    if (!this->m_TransformIsAdvanced)
+    {
+      itkExceptionMacro(<< "ERROR: the GradientDifferenceImageToImageMetric expects an AdvancedTransform "
+                        << "when the interpolator is not of type RayCastInterpolator.");
+    }
 
-  this->m_CastMovedImageFilter->SetInput(this->m_TransformMovingImageFilter->GetOutput());
+    /** The moving image is sampled at all pixels of the fixed image, like the resampler does. */
+    this->m_GridRegion = this->m_FixedImage->GetLargestPossibleRegion();
+    const SizeValueType numberOfPixels = this->m_GridRegion.GetNumberOfPixels();
 
-  for (iFilter = 0; iFilter < MovedImageDimension; iFilter++)
-  {
-    this->m_MovedSobelOperators[iFilter].SetDirection(iFilter);
-    this->m_MovedSobelOperators[iFilter].CreateDirectional();
-    this->m_MovedSobelFilters[iFilter] = MovedSobelFilter::New();
-    this->m_MovedSobelFilters[iFilter]->OverrideBoundaryCondition(&this->m_MovedBoundCond);
-    this->m_MovedSobelFilters[iFilter]->SetOperator(this->m_MovedSobelOperators[iFilter]);
-    this->m_MovedSobelFilters[iFilter]->SetInput(this->m_CastMovedImageFilter->GetOutput());
-    this->m_MovedSobelFilters[iFilter]->UpdateLargestPossibleRegion();
+    /** Store the nonzero taps of the Sobel operators, which are applied to the sampled moving image. */
+    this->m_SobelRadius = 0;
+    for (iFilter = 0; iFilter < FixedImageDimension; iFilter++)
+    {
+      const auto & sobelOperator = this->m_FixedSobelOperators[iFilter];
+      this->m_SobelOffsets[iFilter].clear();
+      this->m_SobelWeights[iFilter].clear();
+      for (unsigned int k = 0; k < sobelOperator.Size(); ++k)
+      {
+        if (sobelOperator[k] != NumericTraits<FixedGradientPixelType>::ZeroValue())
+        {
+          this->m_SobelOffsets[iFilter].push_back(sobelOperator.GetOffset(k));
+          this->m_SobelWeights[iFilter].push_back(sobelOperator[k]);
+        }
+      }
+      for (unsigned int i = 0; i < FixedImageDimension; ++i)
+      {
+        this->m_SobelRadius =
+          std::max<OffsetValueType>(this->m_SobelRadius, static_cast<OffsetValueType>(sobelOperator.GetRadius(i)));
+      }
+    }
+
+    /** Store the fixed image gradients, and whether the pixels are in the fixed image
+     * region and inside the fixed image mask, like in ComputeMeasure().
+     */
+    const FixedImageRegionType & fixedImageRegion = this->GetFixedImageRegion();
+    this->m_FixedSobelGradients.resize(numberOfPixels * FixedImageDimension);
+    this->m_FixedPixelIsValid.resize(numberOfPixels);
+    for (SizeValueType pos = 0; pos < numberOfPixels; ++pos)
+    {
+      const FixedImageIndexType index = this->GetGridIndex(pos);
+      for (unsigned int i = 0; i < FixedImageDimension; ++i)
+      {
+        this->m_FixedSobelGradients[pos * FixedImageDimension + i] =
+          this->m_FixedSobelFilters[i]->GetOutput()->GetPixel(index);
+      }
+
+      bool sampleOK = fixedImageRegion.IsInside(index);
+      if (sampleOK && !this->m_FixedImageMask.IsNull())
+      {
+        FixedImagePointType point;
+        this->m_FixedImage->TransformIndexToPhysicalPoint(index, point);
+        sampleOK = this->m_FixedImageMask->IsInsideInWorldSpace(point);
+      }
+      this->m_FixedPixelIsValid[pos] = sampleOK;
+    }
+
+    /** The per thread derivatives are also needed when UseMultiThread is off. */
+    if (!this->m_UseMultiThread)
+    {
+      this->InitializeThreadingParameters();
+    }
   }
 
   /** Compute the variance */
@@ -212,6 +275,23 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMovedGra
 }
 
 
+/**
+ * ******************** ComputeSubtractionFactors ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeSubtractionFactors(
+  MovedGradientPixelType * subtractionFactor) const
+{
+  for (unsigned int iDimension = 0; iDimension < FixedImageDimension; iDimension++)
+  {
+    subtractionFactor[iDimension] = this->m_MaxFixedGradient[iDimension] / this->m_MaxMovedGradient[iDimension];
+  }
+
+} // end ComputeSubtractionFactors()
+
+
 /**
  * ******************** ComputeVariance ******************************
  */
@@ -358,10 +438,34 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMeasure(
   this->BeforeThreadedGetValueAndDerivative(parameters);
   // this->SetTransformParameters( parameters );
 
-  unsigned int iDimension;
   this->m_TransformMovingImageFilter->Modified();
   this->m_TransformMovingImageFilter->UpdateLargestPossibleRegion();
-  MeasureType measure = NumericTraits<MeasureType>::Zero;
+
+  const MovedGradientImageType * movedGradientImages[MovedImageDimension];
+  for (unsigned int iDimension = 0; iDimension < FixedImageDimension; iDimension++)
+  {
+    this->m_FixedSobelFilters[iDimension]->UpdateLargestPossibleRegion();
+    this->m_MovedSobelFilters[iDimension]->UpdateLargestPossibleRegion();
+    movedGradientImages[iDimension] = this->m_MovedSobelFilters[iDimension]->GetOutput();
+  }
+
+  return this->ComputeMeasureOfGradientImages(movedGradientImages, subtractionFactor);
+
+} // end ComputeMeasure()
+
+
+/**
+ * ******************** ComputeMeasureOfGradientImages ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+typename GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::MeasureType
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMeasureOfGradientImages(
+  const MovedGradientImageType * const * movedGradientImages,
+  const double *                         subtractionFactor) const
+{
+  unsigned int iDimension;
+  MeasureType  measure = NumericTraits<MeasureType>::Zero;
 
   typename FixedImageType::IndexType currentIndex;
   typename FixedImageType::PointType point;
@@ -388,10 +492,7 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMeasure(
 
     typedef itk::ImageRegionConstIteratorWithIndex<MovedGradientImageType> MovedIteratorType;
 
-    MovedIteratorType movedIterator(this->m_MovedSobelFilters[iDimension]->GetOutput(), this->GetFixedImageRegion());
-
-    this->m_FixedSobelFilters[iDimension]->UpdateLargestPossibleRegion();
-    this->m_MovedSobelFilters[iDimension]->UpdateLargestPossibleRegion();
+    MovedIteratorType movedIterator(movedGradientImages[iDimension], this->GetFixedImageRegion());
 
     bool sampleOK = false;
 
@@ -437,7 +538,349 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMeasure(
 
   return measure /= -this->m_Rescalingfactor; // negative for minimization
 
-} // end ComputeMeasure()
+} // end ComputeMeasureOfGradientImages()
+
+
+/**
+ * ******************** CreateProjectionPipeline ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+bool
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::CreateProjectionPipeline(
+  ProjectionPipelineType & pipeline,
+  ThreadIdType             numberOfFilterWorkUnits) const
+{
+  const RayCastInterpolatorType * rayCaster = dynamic_cast<const RayCastInterpolatorType *>(this->GetInterpolator());
+  pipeline.m_Transform =
+    this->CreateTransformCopy(dynamic_cast<const AdvancedTransformType *>(rayCaster->GetTransform()));
+  if (pipeline.m_Transform.IsNull())
+  {
+    return false;
+  }
+
+  /** The moving image is grafted, so that the pipelines do not share its requested region. */
+  const auto movingImage = MovingImageType::New();
+  movingImage->Graft(this->m_MovingImage);
+
+  pipeline.m_Interpolator = RayCastInterpolatorType::New();
+  pipeline.m_Interpolator->SetInputImage(movingImage);
+  pipeline.m_Interpolator->SetTransform(pipeline.m_Transform);
+  pipeline.m_Interpolator->SetFocalPoint(rayCaster->GetFocalPoint());
+  pipeline.m_Interpolator->SetThreshold(rayCaster->GetThreshold());
+
+  /** Set up the filters like Initialize() does. */
+  pipeline.m_TransformMovingImageFilter = TransformMovingImageFilterType::New();
+  pipeline.m_TransformMovingImageFilter->SetTransform(pipeline.m_Transform);
+  pipeline.m_TransformMovingImageFilter->SetInterpolator(pipeline.m_Interpolator);
+  pipeline.m_TransformMovingImageFilter->SetInput(movingImage);
+  pipeline.m_TransformMovingImageFilter->SetDefaultPixelValue(0);
+  pipeline.m_TransformMovingImageFilter->SetSize(this->m_FixedImage->GetLargestPossibleRegion().GetSize());
+  pipeline.m_TransformMovingImageFilter->SetOutputOrigin(this->m_FixedImage->GetOrigin());
+  pipeline.m_TransformMovingImageFilter->SetOutputSpacing(this->m_FixedImage->GetSpacing());
+  pipeline.m_TransformMovingImageFilter->SetOutputDirection(this->m_FixedImage->GetDirection());
+  pipeline.m_TransformMovingImageFilter->SetNumberOfWorkUnits(numberOfFilterWorkUnits);
+
+  pipeline.m_CastMovedImageFilter = CastMovedImageFilterType::New();
+  pipeline.m_CastMovedImageFilter->SetInput(pipeline.m_TransformMovingImageFilter->GetOutput());
+  pipeline.m_CastMovedImageFilter->SetNumberOfWorkUnits(numberOfFilterWorkUnits);
+
+  for (unsigned int iFilter = 0; iFilter < MovedImageDimension; iFilter++)
+  {
+    pipeline.m_MovedSobelFilters[iFilter] = MovedSobelFilter::New();
+    pipeline.m_MovedSobelFilters[iFilter]->OverrideBoundaryCondition(&pipeline.m_MovedBoundCond);
+    pipeline.m_MovedSobelFilters[iFilter]->SetOperator(this->m_MovedSobelOperators[iFilter]);
+    pipeline.m_MovedSobelFilters[iFilter]->SetInput(pipeline.m_CastMovedImageFilter->GetOutput());
+    pipeline.m_MovedSobelFilters[iFilter]->SetNumberOfWorkUnits(numberOfFilterWorkUnits);
+  }
+  return true;
+
+} // end CreateProjectionPipeline()
+
+
+/**
+ * ******************** ComputeProjectionValue ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+typename GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::MeasureType
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeProjectionValue(
+  ProjectionPipelineType & pipeline) const
+{
+  /** The transform parameters have changed, so project again and update the gradient images. */
+  pipeline.m_TransformMovingImageFilter->Modified();
+
+  const MovedGradientImageType * movedGradientImages[MovedImageDimension];
+  for (unsigned int iFilter = 0; iFilter < MovedImageDimension; iFilter++)
+  {
+    pipeline.m_MovedSobelFilters[iFilter]->UpdateLargestPossibleRegion();
+    movedGradientImages[iFilter] = pipeline.m_MovedSobelFilters[iFilter]->GetOutput();
+  }
+
+  /** Compute the subtraction factors from the maximum moved image gradients, like
+   * ComputeMovedGradientRange() does, but without storing the range in the metric.
+   */
+  MovedGradientPixelType subtractionFactor[FixedImageDimension];
+  for (unsigned int iDimension = 0; iDimension < FixedImageDimension; iDimension++)
+  {
+    typedef itk::ImageRegionConstIteratorWithIndex<MovedGradientImageType> IteratorType;
+
+    IteratorType           iterate(movedGradientImages[iDimension], this->GetFixedImageRegion());
+    MovedGradientPixelType maxMovedGradient = iterate.Get();
+    for (; !iterate.IsAtEnd(); ++iterate)
+    {
+      maxMovedGradient = std::max(maxMovedGradient, iterate.Get());
+    }
+    subtractionFactor[iDimension] = this->m_MaxFixedGradient[iDimension] / maxMovedGradient;
+  }
+
+  return this->ComputeMeasureOfGradientImages(movedGradientImages, subtractionFactor);
+
+} // end ComputeProjectionValue()
+
+
+/**
+ * ******************** ComputeMovedValues ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMovedValues(bool computeGradient) const
+{
+  const SizeValueType numberOfPixels = this->m_GridRegion.GetNumberOfPixels();
+  this->m_MovedValues.resize(numberOfPixels);
+  this->m_MovedPixelIsInside.resize(numberOfPixels);
+  if (computeGradient)
+  {
+    this->m_MovedGradients.resize(numberOfPixels);
+  }
+
+  /** Sample contiguous parts of the grid on the thread pool. Outside the moving
+   * image the value is zero, like the default pixel value of the resampler.
+   */
+  const ThreadIdType numberOfWorkUnits = static_cast<ThreadIdType>(
+    std::max<SizeValueType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfPixels), 1));
+  const auto computeMovedValues = [this, computeGradient, numberOfPixels, numberOfWorkUnits](ThreadIdType workUnit) {
+    const SizeValueType begin = workUnit * numberOfPixels / numberOfWorkUnits;
+    const SizeValueType end = (workUnit + 1) * numberOfPixels / numberOfWorkUnits;
+    for (SizeValueType pos = begin; pos < end; ++pos)
+    {
+      FixedImagePointType  fixedPoint;
+      MovingImagePointType mappedPoint;
+      this->m_FixedImage->TransformIndexToPhysicalPoint(this->GetGridIndex(pos), fixedPoint);
+
+      RealType movingImageValue = NumericTraits<RealType>::ZeroValue();
+      bool     sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
+      if (sampleOk)
+      {
+        sampleOk = this->EvaluateMovingImageValueAndDerivative(
+          mappedPoint, movingImageValue, computeGradient ? &this->m_MovedGradients[pos] : nullptr);
+      }
+      this->m_MovedValues[pos] = sampleOk ? movingImageValue : NumericTraits<RealType>::ZeroValue();
+      this->m_MovedPixelIsInside[pos] = sampleOk;
+    }
+  };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, computeMovedValues);
+
+} // end ComputeMovedValues()
+
+
+/**
+ * ******************** ComputeMovedSobelGradients ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMovedSobelGradients(void) const
+{
+  const SizeValueType numberOfPixels = this->m_GridRegion.GetNumberOfPixels();
+  this->m_MovedSobelGradients.resize(numberOfPixels * FixedImageDimension);
+
+  /** Each work unit also finds the range of its gradients in the fixed image region,
+   * like ComputeMovedGradientRange().
+   */
+  const ThreadIdType numberOfWorkUnits = static_cast<ThreadIdType>(
+    std::max<SizeValueType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfPixels), 1));
+  std::vector<MovedGradientPixelType> minGradients(numberOfWorkUnits * FixedImageDimension,
+                                                   NumericTraits<MovedGradientPixelType>::max());
+  std::vector<MovedGradientPixelType> maxGradients(numberOfWorkUnits * FixedImageDimension,
+                                                   NumericTraits<MovedGradientPixelType>::NonpositiveMin());
+
+  const auto computeSobelGradients =
+    [this, numberOfPixels, numberOfWorkUnits, &minGradients, &maxGradients](ThreadIdType workUnit) {
+      const SizeValueType          begin = workUnit * numberOfPixels / numberOfWorkUnits;
+      const SizeValueType          end = (workUnit + 1) * numberOfPixels / numberOfWorkUnits;
+      const FixedImageRegionType & fixedImageRegion = this->GetFixedImageRegion();
+      MovedGradientPixelType *     minGradient = &minGradients[workUnit * FixedImageDimension];
+      MovedGradientPixelType *     maxGradient = &maxGradients[workUnit * FixedImageDimension];
+
+      for (SizeValueType pos = begin; pos < end; ++pos)
+      {
+        const FixedImageIndexType index = this->GetGridIndex(pos);
+        const bool                isInsideFixedImageRegion = fixedImageRegion.IsInside(index);
+        for (unsigned int i = 0; i < FixedImageDimension; ++i)
+        {
+          MovedGradientPixelType gradient = NumericTraits<MovedGradientPixelType>::ZeroValue();
+          for (std::size_t k = 0; k < this->m_SobelOffsets[i].size(); ++k)
+          {
+            const SizeValueType neighborPos = this->GetClampedGridPosition(index + this->m_SobelOffsets[i][k]);
+            gradient += this->m_SobelWeights[i][k] * this->m_MovedValues[neighborPos];
+          }
+          this->m_MovedSobelGradients[pos * FixedImageDimension + i] = gradient;
+
+          if (isInsideFixedImageRegion)
+          {
+            minGradient[i] = std::min(minGradient[i], gradient);
+            maxGradient[i] = std::max(maxGradient[i], gradient);
+          }
+        }
+      }
+    };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, computeSobelGradients);
+
+  for (unsigned int i = 0; i < FixedImageDimension; ++i)
+  {
+    this->m_MinMovedGradient[i] = minGradients[i];
+    this->m_MaxMovedGradient[i] = maxGradients[i];
+    for (ThreadIdType workUnit = 1; workUnit < numberOfWorkUnits; ++workUnit)
+    {
+      const SizeValueType rangePos = workUnit * FixedImageDimension + i;
+      this->m_MinMovedGradient[i] = std::min(this->m_MinMovedGradient[i], minGradients[rangePos]);
+      this->m_MaxMovedGradient[i] = std::max(this->m_MaxMovedGradient[i], maxGradients[rangePos]);
+    }
+  }
+
+} // end ComputeMovedSobelGradients()
+
+
+/**
+ * ******************** ComputeMeasureAndMovedValueDerivatives ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+typename GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::MeasureType
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMeasureAndMovedValueDerivatives(
+  const MovedGradientPixelType * subtractionFactor,
+  bool                           computeDerivatives) const
+{
+  const SizeValueType numberOfPixels = this->m_GridRegion.GetNumberOfPixels();
+  if (computeDerivatives)
+  {
+    this->m_MovedSobelGradientDerivatives.resize(numberOfPixels * FixedImageDimension);
+    this->m_MovedValueDerivatives.resize(numberOfPixels);
+  }
+
+  const ThreadIdType numberOfWorkUnits = static_cast<ThreadIdType>(
+    std::max<SizeValueType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfPixels), 1));
+  std::vector<MeasureType> measures(numberOfWorkUnits, NumericTraits<MeasureType>::Zero);
+
+  /** Compute the measure, and its derivative to the moving image Sobel gradients. */
+  const auto computeMeasure =
+    [this, subtractionFactor, computeDerivatives, numberOfPixels, numberOfWorkUnits, &measures](ThreadIdType workUnit) {
+      const SizeValueType begin = workUnit * numberOfPixels / numberOfWorkUnits;
+      const SizeValueType end = (workUnit + 1) * numberOfPixels / numberOfWorkUnits;
+
+      MeasureType measure = NumericTraits<MeasureType>::Zero;
+      for (SizeValueType pos = begin; pos < end; ++pos)
+      {
+        for (unsigned int i = 0; i < FixedImageDimension; ++i)
+        {
+          const SizeValueType    gradientPos = pos * FixedImageDimension + i;
+          MovedGradientPixelType gradientDerivative = NumericTraits<MovedGradientPixelType>::ZeroValue();
+          if (this->m_FixedPixelIsValid[pos] &&
+              this->m_Variance[i] != NumericTraits<MovedGradientPixelType>::ZeroValue())
+          {
+            const MovedGradientPixelType diff = this->m_FixedSobelGradients[gradientPos] -
+                                                subtractionFactor[i] * this->m_MovedSobelGradients[gradientPos];
+            const MovedGradientPixelType denominator = this->m_Variance[i] + diff * diff;
+            measure += this->m_Variance[i] / denominator;
+            gradientDerivative = -2.0 * subtractionFactor[i] * diff * this->m_Variance[i] /
+                                 (denominator * denominator * this->m_Rescalingfactor);
+          }
+          if (computeDerivatives)
+          {
+            this->m_MovedSobelGradientDerivatives[gradientPos] = gradientDerivative;
+          }
+        }
+      }
+      measures[workUnit] = measure;
+    };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, computeMeasure);
+
+  /** Propagate the derivatives through the Sobel filters to the moving image values. A moving
+   * image value M(z) contributes to the Sobel gradient at x through the tap k when the position
+   * x + offset_k, clamped to the grid, equals z. Near the border, several positions are clamped
+   * to z, so the derivative gathers the contributions of all of them, and no two work units
+   * write to the same value.
+   */
+  if (computeDerivatives)
+  {
+    const auto computeMovedValueDerivatives = [this, numberOfPixels, numberOfWorkUnits](ThreadIdType workUnit) {
+      const SizeValueType begin = workUnit * numberOfPixels / numberOfWorkUnits;
+      const SizeValueType end = (workUnit + 1) * numberOfPixels / numberOfWorkUnits;
+
+      for (SizeValueType pos = begin; pos < end; ++pos)
+      {
+        /** Outside the moving image, the moving image value does not depend on the transform. */
+        if (!this->m_MovedPixelIsInside[pos])
+        {
+          this->m_MovedValueDerivatives[pos] = NumericTraits<DerivativeValueType>::ZeroValue();
+          continue;
+        }
+
+        /** The positions that are clamped to this pixel. */
+        const FixedImageIndexType index = this->GetGridIndex(pos);
+        FixedImageRegionType      clampedRegion;
+        for (unsigned int i = 0; i < FixedImageDimension; ++i)
+        {
+          const IndexValueType first = this->m_GridRegion.GetIndex(i);
+          const IndexValueType last = first + static_cast<IndexValueType>(this->m_GridRegion.GetSize(i)) - 1;
+          const IndexValueType lower = index[i] == first ? index[i] - this->m_SobelRadius : index[i];
+          const IndexValueType upper = index[i] == last ? index[i] + this->m_SobelRadius : index[i];
+          clampedRegion.SetIndex(i, lower);
+          clampedRegion.SetSize(i, static_cast<SizeValueType>(upper - lower + 1));
+        }
+
+        DerivativeValueType movedValueDerivative = NumericTraits<DerivativeValueType>::ZeroValue();
+        const SizeValueType numberOfClampedPositions = clampedRegion.GetNumberOfPixels();
+        for (SizeValueType n = 0; n < numberOfClampedPositions; ++n)
+        {
+          FixedImageIndexType clampedIndex = clampedRegion.GetIndex();
+          SizeValueType       remainder = n;
+          for (unsigned int i = 0; i < FixedImageDimension; ++i)
+          {
+            clampedIndex[i] += static_cast<IndexValueType>(remainder % clampedRegion.GetSize(i));
+            remainder /= clampedRegion.GetSize(i);
+          }
+
+          for (unsigned int i = 0; i < FixedImageDimension; ++i)
+          {
+            for (std::size_t k = 0; k < this->m_SobelOffsets[i].size(); ++k)
+            {
+              const FixedImageIndexType gradientIndex = clampedIndex - this->m_SobelOffsets[i][k];
+              if (this->m_GridRegion.IsInside(gradientIndex))
+              {
+                const SizeValueType gradientPos = this->GetClampedGridPosition(gradientIndex);
+                movedValueDerivative += this->m_SobelWeights[i][k] *
+                                        this->m_MovedSobelGradientDerivatives[gradientPos * FixedImageDimension + i];
+              }
+            }
+          }
+        }
+        this->m_MovedValueDerivatives[pos] = movedValueDerivative;
+      }
+    };
+    this->m_ThreadPool->Execute(numberOfWorkUnits, computeMovedValueDerivatives);
+  }
+
+  MeasureType measure = NumericTraits<MeasureType>::Zero;
+  for (const MeasureType partialMeasure : measures)
+  {
+    measure += partialMeasure;
+  }
+  return measure / -this->m_Rescalingfactor; // negative for minimization
+
+} // end ComputeMeasureAndMovedValueDerivatives()
 
 
 /**
@@ -450,7 +893,19 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::GetValue(
   const TransformParametersType & parameters) const
 {
   unsigned int iFilter;
-  unsigned int iDimension;
+
+  /** Without ray casting, compute the value from the sampled moving image. */
+  if (this->m_UseAnalyticDerivative)
+  {
+    this->BeforeThreadedGetValueAndDerivative(parameters);
+    this->ComputeMovedValues(false);
+    this->ComputeMovedSobelGradients();
+
+    MovedGradientPixelType subtractionFactor[FixedImageDimension];
+    this->ComputeSubtractionFactors(subtractionFactor);
+    return this->ComputeMeasureAndMovedValueDerivatives(subtractionFactor, false);
+  }
+
   this->SetTransformParameters(parameters);
   this->m_TransformMovingImageFilter->Modified();
   this->m_TransformMovingImageFilter->UpdateLargestPossibleRegion();
@@ -467,10 +922,7 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::GetValue(
   MovedGradientPixelType subtractionFactor[FixedImageDimension];
   MeasureType            currentMeasure;
 
-  for (iDimension = 0; iDimension < FixedImageDimension; iDimension++)
-  {
-    subtractionFactor[iDimension] = this->m_MaxFixedGradient[iDimension] / this->m_MaxMovedGradient[iDimension];
-  }
+  this->ComputeSubtractionFactors(subtractionFactor);
 
   currentMeasure = this->ComputeMeasure(parameters, subtractionFactor);
 
@@ -489,11 +941,59 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::GetDerivative(
   const TransformParametersType & parameters,
   DerivativeType &                derivative) const
 {
+  /** The analytic derivative is computed together with the value. */
+  if (this->m_UseAnalyticDerivative)
+  {
+    MeasureType dummyvalue = NumericTraits<MeasureType>::Zero;
+    this->GetValueAndDerivative(parameters, dummyvalue, derivative);
+    return;
+  }
+
   TransformParametersType testPoint;
   testPoint = parameters;
   const unsigned int numberOfParameters = this->GetNumberOfParameters();
   derivative = DerivativeType(numberOfParameters);
 
+  /** Evaluate the parameters concurrently, each work unit with its own copy of the projection
+   * pipeline. The filters of the copies share the threads that remain.
+   */
+  const ThreadIdType numberOfWorkUnits =
+    static_cast<ThreadIdType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfParameters));
+  if (numberOfWorkUnits > 1)
+  {
+    const ThreadIdType numberOfFilterWorkUnits =
+      std::max<ThreadIdType>(Self::GetNumberOfWorkUnits() / numberOfWorkUnits, 1);
+    std::vector<ProjectionPipelineType> pipelines(numberOfWorkUnits);
+    bool                                pipelinesCreated = true;
+    for (ProjectionPipelineType & pipeline : pipelines)
+    {
+      pipelinesCreated = pipelinesCreated && this->CreateProjectionPipeline(pipeline, numberOfFilterWorkUnits);
+    }
+
+    if (pipelinesCreated)
+    {
+      const auto computeDerivatives =
+        [this, &pipelines, &parameters, &derivative, numberOfParameters, numberOfWorkUnits](ThreadIdType workUnit) {
+          ProjectionPipelineType & pipeline = pipelines[workUnit];
+          TransformParametersType  workUnitTestPoint = parameters;
+          for (unsigned int i = workUnit; i < numberOfParameters; i += numberOfWorkUnits)
+          {
+            workUnitTestPoint[i] -= this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
+            pipeline.m_Transform->SetParameters(workUnitTestPoint);
+            const MeasureType valuep0 = this->ComputeProjectionValue(pipeline);
+            workUnitTestPoint[i] += 2 * this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
+            pipeline.m_Transform->SetParameters(workUnitTestPoint);
+            const MeasureType valuep1 = this->ComputeProjectionValue(pipeline);
+            derivative[i] = (valuep1 - valuep0) / (2 * this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]));
+            workUnitTestPoint[i] = parameters[i];
+          }
+        };
+      this->m_ThreadPool->Execute(numberOfWorkUnits, computeDerivatives);
+      return;
+    }
+  }
+
+  /** Otherwise evaluate the parameters one by one. */
   for (unsigned int i = 0; i < numberOfParameters; i++)
   {
     testPoint[i] -= this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
@@ -518,12 +1018,105 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::GetValueAndDeri
   MeasureType &                   Value,
   DerivativeType &                derivative) const
 {
-  Value = this->GetValue(parameters);
-  this->GetDerivative(parameters, derivative);
+  if (!this->m_UseAnalyticDerivative)
+  {
+    Value = this->GetValue(parameters);
+    this->GetDerivative(parameters, derivative);
+    return;
+  }
+
+  /** Call non-thread-safe stuff, such as this->SetTransformParameters( parameters ). */
+  this->BeforeThreadedGetValueAndDerivative(parameters);
+
+  /** Sample the moving image and its gradient, and compute the derivative of the
+   * metric value to each moving image value.
+   */
+  this->ComputeMovedValues(true);
+  this->ComputeMovedSobelGradients();
+
+  MovedGradientPixelType subtractionFactor[FixedImageDimension];
+  this->ComputeSubtractionFactors(subtractionFactor);
+  Value = this->ComputeMeasureAndMovedValueDerivatives(subtractionFactor, true);
+
+  /** Launch multi-threading derivative, distributing the grid pixels over the work units. */
+  this->m_SampleChunkScheduler.Initialize(Self::GetNumberOfWorkUnits(), this->m_GridRegion.GetNumberOfPixels());
+  this->ExecuteThreaderCallback(this->GetValueAndDerivativeThreaderCallback,
+                                const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
+
+  /** Gather the derivatives from all threads. */
+  derivative.SetSize(this->GetNumberOfParameters());
+  this->AfterThreadedGetValueAndDerivative(Value, derivative);
 
 } // end GetValueAndDerivative()
 
 
+/**
+ * ******************** ThreadedGetValueAndDerivative ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetValueAndDerivative(ThreadIdType threadId)
+{
+  /** Initialize array that stores dM(x)/dmu, and the sparse Jacobian + indices. */
+  const NumberOfParametersType nnzji = this->m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices();
+  NonZeroJacobianIndicesType   nzji = NonZeroJacobianIndicesType(nnzji);
+  DerivativeType               imageJacobian(nnzji);
+
+  /** Get a handle to the pre-allocated derivative for the current thread. */
+  DerivativeType & derivative = this->m_GetValueAndDerivativePerThreadVariables[threadId].st_Derivative;
+
+  /** The derivative is the sum over the grid pixels of dValue/dM(x) (dM/dx)^T (dT/dmu). */
+  SizeValueType pos_begin = 0;
+  SizeValueType pos_end = 0;
+  while (this->GetNextSampleChunk(threadId, pos_begin, pos_end))
+  {
+    for (SizeValueType pos = pos_begin; pos < pos_end; ++pos)
+    {
+      const DerivativeValueType movedValueDerivative = this->m_MovedValueDerivatives[pos];
+      if (movedValueDerivative == NumericTraits<DerivativeValueType>::ZeroValue())
+      {
+        continue;
+      }
+
+      /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
+      FixedImagePointType fixedPoint;
+      this->m_FixedImage->TransformIndexToPhysicalPoint(this->GetGridIndex(pos), fixedPoint);
+      this->EvaluateTransformJacobianWithImageGradientProduct(
+        fixedPoint, this->m_MovedGradients[pos], imageJacobian, nzji);
+
+      this->TouchDerivativeTiles(threadId, nzji);
+      for (unsigned int i = 0; i < nnzji; ++i)
+      {
+        derivative[nzji[i]] += movedValueDerivative * imageJacobian[i];
+      }
+    } // end for loop over the grid pixels
+  }   // end while loop over the chunks
+
+} // end ThreadedGetValueAndDerivative()
+
+
+/**
+ * ******************** AfterThreadedGetValueAndDerivative ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::AfterThreadedGetValueAndDerivative(
+  MeasureType & itkNotUsed(value),
+  DerivativeType &              derivative) const
+{
+  /** The value is already computed; accumulate the derivatives multi-threaded. */
+  this->m_ThreaderMetricParameters.st_DerivativePointer = derivative.begin();
+  this->m_ThreaderMetricParameters.st_NormalizationFactor = 1.0;
+
+  this->ExecuteThreaderCallback(this->AccumulateDerivativesThreaderCallback,
+                                const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)),
+                                TimingProfile::DerivativeAccumulation);
+
+} // end AfterThreadedGetValueAndDerivative()
+
+
 } // end namespace itk
 
 #endif // end #ifndef itkGradientDifferenceImageToImageMetric2_hxx
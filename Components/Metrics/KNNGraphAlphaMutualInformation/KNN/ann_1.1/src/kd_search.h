@@ -36,13 +36,15 @@
 //		These are active for the life of each call to annkSearch(). They
 //		are set to save the number of variables that need to be passed
 //		among the various search procedures.
+//		They are thread-local, so that searches in different threads do
+//		not interfere.
 //----------------------------------------------------------------------
 
-extern int           ANNkdDim;      // dimension of space (static copy)
-extern ANNpoint      ANNkdQ;        // query point (static copy)
-extern double        ANNkdMaxErr;   // max tolerable squared error
-extern ANNpointArray ANNkdPts;      // the points (static copy)
-extern ANNmin_k *    ANNkdPointMK;  // set of k closest points
-extern int           ANNptsVisited; // number of points visited
+extern thread_local int           ANNkdDim;      // dimension of space (static copy)
+extern thread_local ANNpoint      ANNkdQ;        // query point (static copy)
+extern thread_local double        ANNkdMaxErr;   // max tolerable squared error
+extern thread_local ANNpointArray ANNkdPts;      // the points (static copy)
+extern thread_local ANNmin_k *    ANNkdPointMK;  // set of k closest points
+extern thread_local int           ANNptsVisited; // number of points visited
 
 #endif
@@ -40,6 +40,9 @@
 /** Include for the spatial derivatives. */
 #include "itkArray2D.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace itk
 {
 /**
@@ -311,6 +314,14 @@ private:
                                                    TransformJacobianIndicesContainerType & jacobiansIndices,
                                                    SpatialDerivativeContainerType &        spatialDerivatives) const;
 
+  /** This function generates the tree for the list sample. When the tree was
+   * already generated for a list sample with the same values, for example the
+   * fixed image samples in case the samples do not change, then nothing is done,
+   * and the tree keeps on using the list sample that it was generated for.
+   */
+  void
+  UpdateBinaryKNNTree(BinaryKNNTreeType * tree, ListSampleType * listSample) const;
+
   /** This function calculates the spatial derivative of the
    * featureNr feature image at the point mappedPoint.
    * \todo move this to base class.
@@ -325,17 +325,12 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
    * and connect them to the searchers.
    */
 
-  /** Generate the tree for the fixed image samples. */
-  this->m_BinaryKNNTreeFixed->SetSample(listSampleFixed);
-  this->m_BinaryKNNTreeFixed->GenerateTree();
-
-  /** Generate the tree for the moving image samples. */
-  this->m_BinaryKNNTreeMoving->SetSample(listSampleMoving);
-  this->m_BinaryKNNTreeMoving->GenerateTree();
-
-  /** Generate the tree for the joint image samples. */
-  this->m_BinaryKNNTreeJoint->SetSample(listSampleJoint);
-  this->m_BinaryKNNTreeJoint->GenerateTree();
+  /** Generate the trees for the fixed, moving and joint image samples.
+   * A tree is reused when its samples did not change since it was generated.
+   */
+  this->UpdateBinaryKNNTree(this->m_BinaryKNNTreeFixed, listSampleFixed);
+  this->UpdateBinaryKNNTree(this->m_BinaryKNNTreeMoving, listSampleMoving);
+  this->UpdateBinaryKNNTree(this->m_BinaryKNNTreeJoint, listSampleJoint);
 
   /** Initialize tree searchers. */
   this->m_BinaryKNNTreeSearcherFixed->SetBinaryTree(this->m_BinaryKNNTreeFixed);
@@ -375,14 +370,7 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
    * where d1 and d2 are the possibly different dimensions of the two feature sets.
    */
 
-  /** Temporary variables. */
   typedef typename NumericTraits<MeasureType>::AccumulateType AccumulateType;
-  MeasurementVectorType                                       z_F, z_M, z_J;
-  IndexArrayType                                              indices_F, indices_M, indices_J;
-  DistanceArrayType                                           distances_F, distances_M, distances_J;
-
-  MeasureType    H, G;
-  AccumulateType sumG = NumericTraits<AccumulateType>::Zero;
 
   /** Get the size of the feature vectors. */
   unsigned int fixedSize = this->GetNumberOfFixedImages();
@@ -393,59 +381,96 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
   unsigned int k = this->m_BinaryKNNTreeSearcherFixed->GetKNearestNeighbors();
   double       twoGamma = jointSize * (1.0 - this->m_Alpha);
 
-  /** Loop over all query points, i.e. all samples. */
-  for (unsigned long i = 0; i < this->m_NumberOfPixelsCounted; i++)
-  {
-    /** Get the i-th query point. */
-    listSampleFixed->GetMeasurementVector(i, z_F);
-    listSampleMoving->GetMeasurementVector(i, z_M);
-    listSampleJoint->GetMeasurementVector(i, z_J);
-
-    /** Search for the K nearest neighbours of the current query point. */
-    this->m_BinaryKNNTreeSearcherFixed->Search(z_F, indices_F, distances_F);
-    this->m_BinaryKNNTreeSearcherMoving->Search(z_M, indices_M, distances_M);
-    this->m_BinaryKNNTreeSearcherJoint->Search(z_J, indices_J, distances_J);
-
-    /** Add the distances between the points to get the total graph length.
-     * The outcommented implementation calculates: sum J/sqrt(F*M)
-     *
-    for ( unsigned int j = 0; j < K; j++ )
-    {
-    enumerator = std::sqrt( distsJ[ j ] );
-    denominator = std::sqrt( std::sqrt( distsF[ j ] ) * std::sqrt( distsM[ j ] ) );
-    if ( denominator > 1e-14 )
+  /** Search the nearest neighbours of the query points in parallel. Each work
+   * unit handles a contiguous range of query points, and computes its own sum.
+   */
+  const SizeValueType         numberOfSamples = this->m_NumberOfPixelsCounted;
+  const ThreadIdType          numberOfWorkUnits = static_cast<ThreadIdType>(
+    std::max<SizeValueType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfSamples), 1));
+  std::vector<AccumulateType> sumGValues(numberOfWorkUnits);
+
+  const auto computeSumG = [this,
+                            &listSampleFixed,
+                            &listSampleMoving,
+                            &listSampleJoint,
+                            k,
+                            twoGamma,
+                            numberOfSamples,
+                            numberOfWorkUnits,
+                            &sumGValues](ThreadIdType workUnit) {
+    MeasurementVectorType z_F, z_M, z_J;
+    IndexArrayType        indices_F, indices_M, indices_J;
+    DistanceArrayType     distances_F, distances_M, distances_J;
+
+    MeasureType    H, G;
+    AccumulateType sumG = NumericTraits<AccumulateType>::Zero;
+
+    /** Loop over the query points of this work unit. */
+    const SizeValueType begin = workUnit * numberOfSamples / numberOfWorkUnits;
+    const SizeValueType end = (workUnit + 1) * numberOfSamples / numberOfWorkUnits;
+    for (SizeValueType i = begin; i < end; i++)
     {
-    contribution += std::pow( enumerator / denominator, twoGamma );
-    }
-    }*/
+      /** Get the i-th query point. */
+      listSampleFixed->GetMeasurementVector(i, z_F);
+      listSampleMoving->GetMeasurementVector(i, z_M);
+      listSampleJoint->GetMeasurementVector(i, z_J);
+
+      /** Search for the K nearest neighbours of the current query point. */
+      this->m_BinaryKNNTreeSearcherFixed->Search(z_F, indices_F, distances_F);
+      this->m_BinaryKNNTreeSearcherMoving->Search(z_M, indices_M, distances_M);
+      this->m_BinaryKNNTreeSearcherJoint->Search(z_J, indices_J, distances_J);
+
+      /** Add the distances between the points to get the total graph length.
+       * The outcommented implementation calculates: sum J/sqrt(F*M)
+       *
+      for ( unsigned int j = 0; j < K; j++ )
+      {
+      enumerator = std::sqrt( distsJ[ j ] );
+      denominator = std::sqrt( std::sqrt( distsF[ j ] ) * std::sqrt( distsM[ j ] ) );
+      if ( denominator > 1e-14 )
+      {
+      contribution += std::pow( enumerator / denominator, twoGamma );
+      }
+      }*/
 
-    /** Add the distances of all neighbours of the query point,
-     * for the three graphs:
-     * sum M / sqrt( sum F * sum M)
-     */
+      /** Add the distances of all neighbours of the query point,
+       * for the three graphs:
+       * sum M / sqrt( sum F * sum M)
+       */
 
-    /** Variables to compute the measure. */
-    AccumulateType Gamma_F = NumericTraits<AccumulateType>::Zero;
-    AccumulateType Gamma_M = NumericTraits<AccumulateType>::Zero;
-    AccumulateType Gamma_J = NumericTraits<AccumulateType>::Zero;
+      /** Variables to compute the measure. */
+      AccumulateType Gamma_F = NumericTraits<AccumulateType>::Zero;
+      AccumulateType Gamma_M = NumericTraits<AccumulateType>::Zero;
+      AccumulateType Gamma_J = NumericTraits<AccumulateType>::Zero;
 
-    /** Loop over the neighbours. */
-    for (unsigned int p = 0; p < k; p++)
-    {
-      Gamma_F += std::sqrt(distances_F[p]);
-      Gamma_M += std::sqrt(distances_M[p]);
-      Gamma_J += std::sqrt(distances_J[p]);
-    } // end loop over the k neighbours
-
-    /** Calculate the contribution of this query point. */
-    H = std::sqrt(Gamma_F * Gamma_M);
-    if (H > this->m_AvoidDivisionBy)
-    {
-      /** Compute some sums. */
-      G = Gamma_J / H;
-      sumG += std::pow(G, twoGamma);
-    }
-  } // end looping over all query points
+      /** Loop over the neighbours. */
+      for (unsigned int p = 0; p < k; p++)
+      {
+        Gamma_F += std::sqrt(distances_F[p]);
+        Gamma_M += std::sqrt(distances_M[p]);
+        Gamma_J += std::sqrt(distances_J[p]);
+      } // end loop over the k neighbours
+
+      /** Calculate the contribution of this query point. */
+      H = std::sqrt(Gamma_F * Gamma_M);
+      if (H > this->m_AvoidDivisionBy)
+      {
+        /** Compute some sums. */
+        G = Gamma_J / H;
+        sumG += std::pow(G, twoGamma);
+      }
+    } // end looping over the query points
+
+    sumGValues[workUnit] = sumG;
+  };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, computeSumG);
+
+  /** Add the sums of the work units. */
+  AccumulateType sumG = NumericTraits<AccumulateType>::Zero;
+  for (ThreadIdType workUnit = 0; workUnit < numberOfWorkUnits; ++workUnit)
+  {
+    sumG += sumGValues[workUnit];
+  }
 
   /**
    * *************** Finally, calculate the metric value \alpha MI ******************
@@ -549,17 +574,12 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
    * and connect them to the searchers.
    */
 
-  /** Generate the tree for the fixed image samples. */
-  this->m_BinaryKNNTreeFixed->SetSample(listSampleFixed);
-  this->m_BinaryKNNTreeFixed->GenerateTree();
-
-  /** Generate the tree for the moving image samples. */
-  this->m_BinaryKNNTreeMoving->SetSample(listSampleMoving);
-  this->m_BinaryKNNTreeMoving->GenerateTree();
-
-  /** Generate the tree for the joint image samples. */
-  this->m_BinaryKNNTreeJoint->SetSample(listSampleJoint);
-  this->m_BinaryKNNTreeJoint->GenerateTree();
+  /** Generate the trees for the fixed, moving and joint image samples.
+   * A tree is reused when its samples did not change since it was generated.
+   */
+  this->UpdateBinaryKNNTree(this->m_BinaryKNNTreeFixed, listSampleFixed);
+  this->UpdateBinaryKNNTree(this->m_BinaryKNNTreeMoving, listSampleMoving);
+  this->UpdateBinaryKNNTree(this->m_BinaryKNNTreeJoint, listSampleJoint);
 
   /** Initialize tree searchers. */
   this->m_BinaryKNNTreeSearcherFixed->SetBinaryTree(this->m_BinaryKNNTreeFixed);
@@ -599,20 +619,7 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
    * where d1 and d2 are the possibly different dimensions of the two feature sets.
    */
 
-  /** Temporary variables. */
   typedef typename NumericTraits<MeasureType>::AccumulateType AccumulateType;
-  MeasurementVectorType                                       z_F, z_M, z_J, z_M_ip, z_J_ip, diff_M, diff_J;
-  IndexArrayType                                              indices_F, indices_M, indices_J;
-  DistanceArrayType                                           distances_F, distances_M, distances_J;
-  MeasureType                                                 distance_F, distance_M, distance_J;
-
-  MeasureType    H, G, Gpow;
-  AccumulateType sumG = NumericTraits<AccumulateType>::Zero;
-
-  DerivativeType contribution(this->GetNumberOfParameters());
-  contribution.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
-  DerivativeType dGamma_M(this->GetNumberOfParameters());
-  DerivativeType dGamma_J(this->GetNumberOfParameters());
 
   /** Get the size of the feature vectors. */
   unsigned int fixedSize = this->GetNumberOfFixedImages();
@@ -623,85 +630,137 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
   unsigned int k = this->m_BinaryKNNTreeSearcherFixed->GetKNearestNeighbors();
   double       twoGamma = jointSize * (1.0 - this->m_Alpha);
 
-  /** Loop over all query points, i.e. all samples. */
-  for (unsigned long i = 0; i < this->m_NumberOfPixelsCounted; i++)
-  {
-    /** Get the i-th query point. */
-    listSampleFixed->GetMeasurementVector(i, z_F);
-    listSampleMoving->GetMeasurementVector(i, z_M);
-    listSampleJoint->GetMeasurementVector(i, z_J);
+  /** Search the nearest neighbours of the query points in parallel. Each work
+   * unit handles a contiguous range of query points, and computes its own sum
+   * and contribution to the derivative.
+   */
+  const SizeValueType         numberOfSamples = this->m_NumberOfPixelsCounted;
+  const ThreadIdType          numberOfWorkUnits = static_cast<ThreadIdType>(
+    std::max<SizeValueType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfSamples), 1));
+  std::vector<AccumulateType> sumGValues(numberOfWorkUnits);
+  std::vector<DerivativeType> contributionValues(numberOfWorkUnits);
+
+  const auto computeSumGAndContribution = [this,
+                                           &listSampleFixed,
+                                           &listSampleMoving,
+                                           &listSampleJoint,
+                                           &jacobianContainer,
+                                           &jacobianIndicesContainer,
+                                           &spatialDerivativesContainer,
+                                           k,
+                                           twoGamma,
+                                           numberOfSamples,
+                                           numberOfWorkUnits,
+                                           &sumGValues,
+                                           &contributionValues](ThreadIdType workUnit) {
+    MeasurementVectorType z_F, z_M, z_J, z_M_ip, z_J_ip, diff_M, diff_J;
+    IndexArrayType        indices_F, indices_M, indices_J;
+    DistanceArrayType     distances_F, distances_M, distances_J;
+    MeasureType           distance_F, distance_M, distance_J;
+
+    MeasureType    H, G, Gpow;
+    AccumulateType sumG = NumericTraits<AccumulateType>::Zero;
+
+    DerivativeType & contribution = contributionValues[workUnit];
+    contribution.SetSize(this->GetNumberOfParameters());
+    contribution.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
+    DerivativeType dGamma_M(this->GetNumberOfParameters());
+    DerivativeType dGamma_J(this->GetNumberOfParameters());
+
+    /** Loop over the query points of this work unit. */
+    const SizeValueType begin = workUnit * numberOfSamples / numberOfWorkUnits;
+    const SizeValueType end = (workUnit + 1) * numberOfSamples / numberOfWorkUnits;
+    for (SizeValueType i = begin; i < end; i++)
+    {
+      /** Get the i-th query point. */
+      listSampleFixed->GetMeasurementVector(i, z_F);
+      listSampleMoving->GetMeasurementVector(i, z_M);
+      listSampleJoint->GetMeasurementVector(i, z_J);
 
-    /** Search for the k nearest neighbours of the current query point. */
-    this->m_BinaryKNNTreeSearcherFixed->Search(z_F, indices_F, distances_F);
-    this->m_BinaryKNNTreeSearcherMoving->Search(z_M, indices_M, distances_M);
-    this->m_BinaryKNNTreeSearcherJoint->Search(z_J, indices_J, distances_J);
+      /** Search for the k nearest neighbours of the current query point. */
+      this->m_BinaryKNNTreeSearcherFixed->Search(z_F, indices_F, distances_F);
+      this->m_BinaryKNNTreeSearcherMoving->Search(z_M, indices_M, distances_M);
+      this->m_BinaryKNNTreeSearcherJoint->Search(z_J, indices_J, distances_J);
 
-    /** Variables to compute the measure and its derivative. */
-    AccumulateType Gamma_F = NumericTraits<AccumulateType>::Zero;
-    AccumulateType Gamma_M = NumericTraits<AccumulateType>::Zero;
-    AccumulateType Gamma_J = NumericTraits<AccumulateType>::Zero;
+      /** Variables to compute the measure and its derivative. */
+      AccumulateType Gamma_F = NumericTraits<AccumulateType>::Zero;
+      AccumulateType Gamma_M = NumericTraits<AccumulateType>::Zero;
+      AccumulateType Gamma_J = NumericTraits<AccumulateType>::Zero;
 
-    SpatialDerivativeType D1sparse, D2sparse_M, D2sparse_J;
-    D1sparse = spatialDerivativesContainer[i] * jacobianContainer[i];
+      SpatialDerivativeType D1sparse, D2sparse_M, D2sparse_J;
+      D1sparse = spatialDerivativesContainer[i] * jacobianContainer[i];
 
-    dGamma_M.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
-    dGamma_J.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
+      dGamma_M.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
+      dGamma_J.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
 
-    /** Loop over the neighbours. */
-    for (unsigned int p = 0; p < k; p++)
-    {
-      /** Get the neighbour point z_ip^M. */
-      listSampleMoving->GetMeasurementVector(indices_M[p], z_M_ip);
-      listSampleMoving->GetMeasurementVector(indices_J[p], z_J_ip);
-
-      /** Get the distances. */
-      distance_F = std::sqrt(distances_F[p]);
-      distance_M = std::sqrt(distances_M[p]);
-      distance_J = std::sqrt(distances_J[p]);
-
-      /** Compute Gamma's. */
-      Gamma_F += distance_F;
-      Gamma_M += distance_M;
-      Gamma_J += distance_J;
-
-      /** Get the difference of z_ip^M with z_i^M. */
-      diff_M = z_M - z_M_ip;
-      diff_J = z_M - z_J_ip;
-
-      /** Compute derivatives. */
-      D2sparse_M = spatialDerivativesContainer[indices_M[p]] * jacobianContainer[indices_M[p]];
-      D2sparse_J = spatialDerivativesContainer[indices_J[p]] * jacobianContainer[indices_J[p]];
-
-      /** Update the dGamma's. */
-      this->UpdateDerivativeOfGammas(D1sparse,
-                                     D2sparse_M,
-                                     D2sparse_J,
-                                     jacobianIndicesContainer[i],
-                                     jacobianIndicesContainer[indices_M[p]],
-                                     jacobianIndicesContainer[indices_J[p]],
-                                     diff_M,
-                                     diff_J,
-                                     distance_M,
-                                     distance_J,
-                                     dGamma_M,
-                                     dGamma_J);
-
-    } // end loop over the k neighbours
-
-    /** Compute contributions. */
-    H = std::sqrt(Gamma_F * Gamma_M);
-    if (H > this->m_AvoidDivisionBy)
-    {
-      /** Compute some sums. */
-      G = Gamma_J / H;
-      sumG += std::pow(G, twoGamma);
+      /** Loop over the neighbours. */
+      for (unsigned int p = 0; p < k; p++)
+      {
+        /** Get the neighbour point z_ip^M. */
+        listSampleMoving->GetMeasurementVector(indices_M[p], z_M_ip);
+        listSampleMoving->GetMeasurementVector(indices_J[p], z_J_ip);
+
+        /** Get the distances. */
+        distance_F = std::sqrt(distances_F[p]);
+        distance_M = std::sqrt(distances_M[p]);
+        distance_J = std::sqrt(distances_J[p]);
+
+        /** Compute Gamma's. */
+        Gamma_F += distance_F;
+        Gamma_M += distance_M;
+        Gamma_J += distance_J;
+
+        /** Get the difference of z_ip^M with z_i^M. */
+        diff_M = z_M - z_M_ip;
+        diff_J = z_M - z_J_ip;
+
+        /** Compute derivatives. */
+        D2sparse_M = spatialDerivativesContainer[indices_M[p]] * jacobianContainer[indices_M[p]];
+        D2sparse_J = spatialDerivativesContainer[indices_J[p]] * jacobianContainer[indices_J[p]];
+
+        /** Update the dGamma's. */
+        this->UpdateDerivativeOfGammas(D1sparse,
+                                       D2sparse_M,
+                                       D2sparse_J,
+                                       jacobianIndicesContainer[i],
+                                       jacobianIndicesContainer[indices_M[p]],
+                                       jacobianIndicesContainer[indices_J[p]],
+                                       diff_M,
+                                       diff_J,
+                                       distance_M,
+                                       distance_J,
+                                       dGamma_M,
+                                       dGamma_J);
+
+      } // end loop over the k neighbours
+
+      /** Compute contributions. */
+      H = std::sqrt(Gamma_F * Gamma_M);
+      if (H > this->m_AvoidDivisionBy)
+      {
+        /** Compute some sums. */
+        G = Gamma_J / H;
+        sumG += std::pow(G, twoGamma);
 
-      /** Compute the contribution to the derivative. */
-      Gpow = std::pow(G, twoGamma - 1.0);
-      contribution += (Gpow / H) * (dGamma_J - (0.5 * Gamma_J / Gamma_M) * dGamma_M);
-    }
+        /** Compute the contribution to the derivative. */
+        Gpow = std::pow(G, twoGamma - 1.0);
+        contribution += (Gpow / H) * (dGamma_J - (0.5 * Gamma_J / Gamma_M) * dGamma_M);
+      }
+    } // end looping over the query points
+
+    sumGValues[workUnit] = sumG;
+  };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, computeSumGAndContribution);
 
-  } // end looping over all query points
+  /** Add the sums and the contributions of the work units. */
+  AccumulateType sumG = NumericTraits<AccumulateType>::Zero;
+  DerivativeType contribution(this->GetNumberOfParameters());
+  contribution.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
+  for (ThreadIdType workUnit = 0; workUnit < numberOfWorkUnits; ++workUnit)
+  {
+    sumG += sumGValues[workUnit];
+    contribution += contributionValues[workUnit];
+  }
 
   /**
    * *************** Finally, calculate the metric value and derivative ******************
@@ -893,6 +952,45 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::
 } // end ComputeListSampleValuesAndDerivativePlusJacobian()
 
 
+/**
+ * ************************ UpdateBinaryKNNTree *************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::UpdateBinaryKNNTree(
+  BinaryKNNTreeType * tree,
+  ListSampleType *    listSample) const
+{
+  /** Check if the tree was generated for a list sample with the same values. */
+  const ListSampleType * treeSample = tree->GetSample();
+  if (treeSample != nullptr && treeSample != listSample &&
+      tree->GetActualNumberOfDataPoints() == listSample->GetActualSize() &&
+      tree->GetDataDimension() == listSample->GetMeasurementVectorSize())
+  {
+    const unsigned long numberOfPoints = listSample->GetActualSize();
+    const unsigned int  dimension = listSample->GetMeasurementVectorSize();
+    const auto          treePoints = treeSample->GetInternalContainer();
+    const auto          points = listSample->GetInternalContainer();
+
+    bool equal = true;
+    for (unsigned long i = 0; i < numberOfPoints && equal; ++i)
+    {
+      equal = std::equal(points[i], points[i] + dimension, treePoints[i]);
+    }
+    if (equal)
+    {
+      return;
+    }
+  }
+
+  /** Generate the tree for the new list sample. */
+  tree->SetSample(listSample);
+  tree->GenerateTree();
+
+} // end UpdateBinaryKNNTree()
+
+
 /**
  * ************************ EvaluateMovingFeatureImageDerivatives *************************
  */
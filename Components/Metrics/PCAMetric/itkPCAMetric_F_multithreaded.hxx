@@ -936,15 +936,11 @@ template <class TFixedImage, class TMovingImage>
 void
 PCAMetric<TFixedImage, TMovingImage>::LaunchGetSamplesThreaderCallback(void) const
 {
-  /** Setup local threader. */
-  // \todo: is a global threader better performance-wise? check
-  typename ThreaderType::Pointer local_threader = ThreaderType::New();
-  local_threader->SetNumberOfWorkUnits(Self::GetNumberOfWorkUnits());
-  local_threader->SetSingleMethod(this->GetSamplesThreaderCallback,
-                                  const_cast<void *>(static_cast<const void *>(&this->m_PCAMetricThreaderParameters)));
-
-  /** Launch. */
-  local_threader->SingleMethodExecute();
+  /** Launch on the thread pool. The samples are distributed statically over the
+   * work units, because the data blocks of the work units are concatenated in order.
+   */
+  this->ExecuteThreaderCallback(this->GetSamplesThreaderCallback,
+                                const_cast<void *>(static_cast<const void *>(&this->m_PCAMetricThreaderParameters)));
 
 } // end LaunchGetSamplesThreaderCallback()
 
@@ -1139,15 +1135,11 @@ template <class TFixedImage, class TMovingImage>
 void
 PCAMetric<TFixedImage, TMovingImage>::LaunchComputeDerivativeThreaderCallback(void) const
 {
-  /** Setup local threader. */
-  // \todo: is a global threader better performance-wise? check
-  typename ThreaderType::Pointer local_threader = ThreaderType::New();
-  local_threader->SetNumberOfWorkUnits(Self::GetNumberOfWorkUnits());
-  local_threader->SetSingleMethod(this->ComputeDerivativeThreaderCallback,
-                                  const_cast<void *>(static_cast<const void *>(&this->m_PCAMetricThreaderParameters)));
-
-  /** Launch. */
-  local_threader->SingleMethodExecute();
+  /** Launch on the thread pool. The samples are distributed statically over the
+   * work units, because the data blocks of the work units are concatenated in order.
+   */
+  this->ExecuteThreaderCallback(this->ComputeDerivativeThreaderCallback,
+                                const_cast<void *>(static_cast<const void *>(&this->m_PCAMetricThreaderParameters)));
 
 } // end LaunchComputeDerivativeThreaderCallback()
 
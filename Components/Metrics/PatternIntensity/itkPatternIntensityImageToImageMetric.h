@@ -30,13 +30,26 @@
 #include "itkAdvancedCombinationTransform.h"
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
 
+#include <vector>
+
 namespace itk
 {
 
 /** \class PatternIntensityImageToImageMetric
  * \brief Computes similarity between two objects to be registered
  *
+ * With an AdvancedRayCastInterpolateImageFunction the moving image is projected
+ * onto the fixed image (2D-3D registration). The ray caster does not provide the
+ * derivative of the projection, so the derivative is then computed by finite
+ * differences, which costs two projections per transform parameter. The parameters
+ * are evaluated concurrently, each work unit with its own copy of the projection
+ * pipeline and the transform.
  *
+ * With any other interpolator the moving image is sampled at the pixels of the
+ * fixed image, and the derivative is computed analytically: the derivative of the
+ * measure to each moving image value is multiplied with the moving image gradient
+ * and the transform Jacobian. The moving image values and the derivative are
+ * computed multi-threaded.
  *
  * \ingroup RegistrationMetrics
  */
@@ -101,6 +114,8 @@ public:
   typedef typename Superclass::MovingImageDerivativeScalesType MovingImageDerivativeScalesType;
   typedef typename itk::Optimizer                              OptimizerType;
   typedef typename OptimizerType::ScalesType                   ScalesType;
+  typedef typename Superclass::DerivativeValueType             DerivativeValueType;
+  typedef typename Superclass::NumberOfParametersType          NumberOfParametersType;
 
   /** The fixed image dimension. */
   itkStaticConstMacro(FixedImageDimension, unsigned int, FixedImageType::ImageDimension);
@@ -174,6 +189,86 @@ protected:
   MeasureType
   ComputePIDiff(const TransformParametersType & parameters, float scalingfactor) const;
 
+  /** Compute the pattern intensity of a difference image, for ComputePIDiff(). */
+  MeasureType
+  ComputePIOfDifferenceImage(const TransformedMovingImageType * differenceImage) const;
+
+  /** Typedefs for the concurrent finite differences. */
+  typedef typename Superclass::AdvancedTransformType AdvancedTransformType;
+  typedef typename AdvancedTransformType::Pointer    AdvancedTransformPointer;
+
+  /** A copy of the projection pipeline of the ray casting mode, with its own copy of the
+   * transform and its own references to the images, so that the finite differences of the
+   * derivative can be evaluated concurrently.
+   */
+  struct ProjectionPipelineType
+  {
+    AdvancedTransformPointer          m_Transform;
+    RayCastInterpolatorPointer        m_Interpolator;
+    TransformMovingImageFilterPointer m_TransformMovingImageFilter;
+    MultiplyImageFilterPointer        m_MultiplyImageFilter;
+    DifferenceImageFilterPointer      m_DifferenceImageFilter;
+  };
+
+  /** Create a copy of the projection pipeline, whose filters use the specified number of
+   * work units. Returns false when the transform cannot be copied.
+   */
+  bool
+  CreateProjectionPipeline(ProjectionPipelineType & pipeline, ThreadIdType numberOfFilterWorkUnits) const;
+
+  /** Compute the value for the current parameters of the transform of a projection pipeline,
+   * like GetValue() does in the ray casting mode.
+   */
+  MeasureType
+  ComputeProjectionValue(const ProjectionPipelineType & pipeline) const;
+
+  /** Typedefs for the analytic derivative. */
+  typedef typename Superclass::FixedImageIndexType        FixedImageIndexType;
+  typedef typename Superclass::FixedImagePointType        FixedImagePointType;
+  typedef typename Superclass::MovingImagePointType       MovingImagePointType;
+  typedef typename Superclass::MovingImageDerivativeType  MovingImageDerivativeType;
+  typedef typename Superclass::NonZeroJacobianIndicesType NonZeroJacobianIndicesType;
+
+  /** Sample the moving image at the pixels of the fixed image, and optionally its
+   * gradient. Only used for the analytic derivative.
+   */
+  void
+  ComputeMovedValues(bool computeGradient) const;
+
+  /** Compute the pattern intensity of the difference image from the sampled moving
+   * image, like ComputePIDiff(). Optionally the derivative of the metric value to each
+   * moving image value is computed as well. Only used for the analytic derivative.
+   */
+  MeasureType
+  ComputePIDiffAndMovedValueDerivatives(double scalingfactor, bool computeDerivatives) const;
+
+  /** Find the normalization factor that gives the lowest metric value, like GetValue()
+   * does for OptimizeNormalizationFactor. Only used for the analytic derivative.
+   */
+  double
+  ComputeOptimalNormalizationFactor(void) const;
+
+  /** Get the index of the fixed image pixel at position pos in the sampled moving image. */
+  FixedImageIndexType
+  GetGridIndex(SizeValueType pos) const
+  {
+    FixedImageIndexType index = this->m_GridRegion.GetIndex();
+    for (unsigned int i = 0; i < FixedImageDimension; ++i)
+    {
+      index[i] += static_cast<IndexValueType>(pos % this->m_GridRegion.GetSize(i));
+      pos /= this->m_GridRegion.GetSize(i);
+    }
+    return index;
+  }
+
+  /** Compute the analytic derivative of the pixels that this thread gets from the scheduler. */
+  void
+  ThreadedGetValueAndDerivative(ThreadIdType threadID) override;
+
+  /** Gather the derivatives of all threads. */
+  void
+  AfterThreadedGetValueAndDerivative(MeasureType & value, DerivativeType & derivative) const override;
+
 private:
   PatternIntensityImageToImageMetric(const Self &) = delete;
   void
@@ -192,6 +287,18 @@ private:
   ScalesType                         m_Scales;
   MeasureType                        m_FixedMeasure;
   CombinationTransformPointer        m_CombinationTransform;
+
+  /** Variables for the analytic derivative. The grid region is the part of the fixed
+   * image at which the moving image is sampled; the vectors store per grid pixel.
+   */
+  bool                                           m_UseAnalyticDerivative;
+  FixedImageRegionType                           m_GridRegion;
+  std::vector<RealType>                          m_FixedValues;
+  std::vector<unsigned char>                     m_FixedPixelIsValid;
+  mutable std::vector<RealType>                  m_MovedValues;
+  mutable std::vector<MovingImageDerivativeType> m_MovedGradients;
+  mutable std::vector<unsigned char>             m_MovedPixelIsInside;
+  mutable std::vector<DerivativeValueType>       m_MovedValueDerivatives;
 };
 
 } // end namespace itk
@@ -22,6 +22,7 @@
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkNumericTraits.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <iomanip>
@@ -45,6 +46,7 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::PatternIntensityI
   this->m_NeighborhoodRadius = 3;
   this->m_FixedMeasure = 0;
   this->m_OptimizeNormalizationFactor = false;
+  this->m_UseAnalyticDerivative = false;
   this->m_TransformMovingImageFilter = TransformMovingImageFilterType::New();
   this->m_CombinationTransform = CombinationTransformType::New();
   this->m_RescaleImageFilter = RescaleIntensityImageFilterType::New();
@@ -64,37 +66,88 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::Initialize(void)
 {
   Superclass::Initialize();
 
+  this->m_NormalizationFactor = this->m_FixedImageTrueMax / this->m_MovingImageTrueMax;
+
   /** Resampling for 3D->2D */
   RayCastInterpolatorType * rayCaster =
     dynamic_cast<RayCastInterpolatorType *>(const_cast<InterpolatorType *>(this->GetInterpolator()));
-  if (rayCaster != nullptr)
+  this->m_UseAnalyticDerivative = rayCaster == nullptr;
+  if (!this->m_UseAnalyticDerivative)
   {
     this->m_TransformMovingImageFilter->SetTransform(rayCaster->GetTransform());
+    this->m_TransformMovingImageFilter->SetInterpolator(this->m_Interpolator);
+    this->m_TransformMovingImageFilter->SetInput(this->m_MovingImage);
+    this->m_TransformMovingImageFilter->SetDefaultPixelValue(0);
+
+    this->m_TransformMovingImageFilter->SetSize(this->m_FixedImage->GetLargestPossibleRegion().GetSize());
+    this->m_TransformMovingImageFilter->SetOutputOrigin(this->m_FixedImage->GetOrigin());
+    this->m_TransformMovingImageFilter->SetOutputSpacing(this->m_FixedImage->GetSpacing());
+    this->m_TransformMovingImageFilter->SetOutputDirection(this->m_FixedImage->GetDirection());
+    this->m_TransformMovingImageFilter->UpdateLargestPossibleRegion();
+
+    // this->InitializeLimiters();
+
+    this->m_MultiplyImageFilter->SetInput(this->m_TransformMovingImageFilter->GetOutput());
+    this->m_MultiplyImageFilter->SetConstant(this->m_NormalizationFactor);
+    this->m_DifferenceImageFilter->SetInput1(this->m_FixedImage);
+    this->m_DifferenceImageFilter->SetInput2(this->m_MultiplyImageFilter->GetOutput());
+    this->m_DifferenceImageFilter->UpdateLargestPossibleRegion();
   }
   else
   {
-    itkExceptionMacro(<< "ERROR: the NormalizedGradientCorrelationImageToImageMetric is currently "
-                      << "only suitable for 2D-3D registration.\n"
-                      << "  Therefore it expects an interpolator of type RayCastInterpolator.");
-  }
-  this->m_TransformMovingImageFilter->SetInterpolator(this->m_Interpolator);
-  this->m_TransformMovingImageFilter->SetInput(this->m_MovingImage);
-  this->m_TransformMovingImageFilter->SetDefaultPixelValue(0);
+    /** The analytic derivative needs the sparse Jacobian of an advanced transform. */
+    if (!this->m_TransformIsAdvanced)
+    {
+      itkExceptionMacro(<< "ERROR: the PatternIntensityImageToImageMetric expects an AdvancedTransform "
+                        << "when the interpolator is not of type RayCastInterpolator.");
+    }
 
-  this->m_TransformMovingImageFilter->SetSize(this->m_FixedImage->GetLargestPossibleRegion().GetSize());
-  this->m_TransformMovingImageFilter->SetOutputOrigin(this->m_FixedImage->GetOrigin());
-  this->m_TransformMovingImageFilter->SetOutputSpacing(this->m_FixedImage->GetSpacing());
-  this->m_TransformMovingImageFilter->SetOutputDirection(this->m_FixedImage->GetDirection());
-  this->m_TransformMovingImageFilter->UpdateLargestPossibleRegion();
+    /** The moving image is sampled at the pixels of the fixed image that ComputePIDiff()
+     * visits, including their neighborhoods. Like there, only the first slice is used.
+     */
+    this->m_GridRegion = this->m_FixedImage->GetLargestPossibleRegion();
+    for (unsigned int i = 2; i < FixedImageDimension; ++i)
+    {
+      this->m_GridRegion.SetSize(i, 1);
+    }
+    const SizeValueType numberOfPixels = this->m_GridRegion.GetNumberOfPixels();
+
+    /** Store the fixed image values, and whether the pixels are in the region
+     * of ComputePIDiff() and inside the fixed image mask.
+     */
+    typename FixedImageType::SizeType neighborhoodRadius;
+    neighborhoodRadius.Fill(0);
+    for (unsigned int i = 0; i < 2; ++i) // Only 2D
+    {
+      neighborhoodRadius[i] = this->m_NeighborhoodRadius;
+    }
+    FixedImageRegionType innerRegion = this->m_GridRegion;
+    innerRegion.ShrinkByRadius(neighborhoodRadius);
 
-  // this->InitializeLimiters();
+    this->m_FixedValues.resize(numberOfPixels);
+    this->m_FixedPixelIsValid.resize(numberOfPixels);
+    for (SizeValueType pos = 0; pos < numberOfPixels; ++pos)
+    {
+      const FixedImageIndexType index = this->GetGridIndex(pos);
+      this->m_FixedValues[pos] = static_cast<RealType>(this->m_FixedImage->GetPixel(index));
+
+      bool sampleOK = innerRegion.IsInside(index);
+      if (sampleOK && !this->m_FixedImageMask.IsNull())
+      {
+        FixedImagePointType point;
+        this->m_FixedImage->TransformIndexToPhysicalPoint(index, point);
+        sampleOK = this->m_FixedImageMask->IsInsideInWorldSpace(point);
+      }
+      this->m_FixedPixelIsValid[pos] = sampleOK;
+    }
+
+    /** The per thread derivatives are also needed when UseMultiThread is off. */
+    if (!this->m_UseMultiThread)
+    {
+      this->InitializeThreadingParameters();
+    }
+  }
 
-  this->m_NormalizationFactor = this->m_FixedImageTrueMax / this->m_MovingImageTrueMax;
-  this->m_MultiplyImageFilter->SetInput(this->m_TransformMovingImageFilter->GetOutput());
-  this->m_MultiplyImageFilter->SetConstant(this->m_NormalizationFactor);
-  this->m_DifferenceImageFilter->SetInput1(this->m_FixedImage);
-  this->m_DifferenceImageFilter->SetInput2(this->m_MultiplyImageFilter->GetOutput());
-  this->m_DifferenceImageFilter->UpdateLargestPossibleRegion();
   this->m_FixedMeasure = this->ComputePIFixed();
 
   /* to rescale the similarity measure between 0-1;*/
@@ -243,6 +296,21 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIDiff(con
   this->m_TransformMovingImageFilter->Modified();
   this->m_MultiplyImageFilter->SetConstant(scalingfactor);
   this->m_DifferenceImageFilter->UpdateLargestPossibleRegion();
+
+  return this->ComputePIOfDifferenceImage(this->m_DifferenceImageFilter->GetOutput());
+
+} // end ComputePIDiff()
+
+
+/**
+ * ********************* ComputePIOfDifferenceImage ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+typename PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::MeasureType
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIOfDifferenceImage(
+  const TransformedMovingImageType * differenceImage) const
+{
   MeasureType measure = NumericTraits<MeasureType>::Zero;
   MeasureType diff = NumericTraits<MeasureType>::Zero;
 
@@ -266,7 +334,7 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIDiff(con
   iterationRegion.SetSize(iterationSize);
 
   typedef itk::ImageRegionConstIteratorWithIndex<TransformedMovingImageType> DifferenceImageIteratorType;
-  DifferenceImageIteratorType differenceImageIt(this->m_DifferenceImageFilter->GetOutput(), iterationRegion);
+  DifferenceImageIteratorType differenceImageIt(differenceImage, iterationRegion);
   differenceImageIt.GoToBegin();
 
   neighboriterationRegion.SetSize(neighborIterationSize);
@@ -306,7 +374,7 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIDiff(con
       }
 
       neighboriterationRegion.SetIndex(neighborIndex);
-      DifferenceImageIteratorType neighborIt(this->m_DifferenceImageFilter->GetOutput(), neighboriterationRegion);
+      DifferenceImageIteratorType neighborIt(differenceImage, neighboriterationRegion);
       neighborIt.GoToBegin();
 
       while (!neighborIt.IsAtEnd())
@@ -323,7 +391,286 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIDiff(con
 
   return measure;
 
-} // end ComputePIDiff()
+} // end ComputePIOfDifferenceImage()
+
+
+/**
+ * ********************* CreateProjectionPipeline ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+bool
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::CreateProjectionPipeline(
+  ProjectionPipelineType & pipeline,
+  ThreadIdType             numberOfFilterWorkUnits) const
+{
+  const RayCastInterpolatorType * rayCaster = dynamic_cast<const RayCastInterpolatorType *>(this->GetInterpolator());
+  pipeline.m_Transform =
+    this->CreateTransformCopy(dynamic_cast<const AdvancedTransformType *>(rayCaster->GetTransform()));
+  if (pipeline.m_Transform.IsNull())
+  {
+    return false;
+  }
+
+  /** The images are grafted, so that the pipelines do not share the requested regions of the images. */
+  const auto fixedImage = FixedImageType::New();
+  fixedImage->Graft(this->m_FixedImage);
+  const auto movingImage = MovingImageType::New();
+  movingImage->Graft(this->m_MovingImage);
+
+  pipeline.m_Interpolator = RayCastInterpolatorType::New();
+  pipeline.m_Interpolator->SetInputImage(movingImage);
+  pipeline.m_Interpolator->SetTransform(pipeline.m_Transform);
+  pipeline.m_Interpolator->SetFocalPoint(rayCaster->GetFocalPoint());
+  pipeline.m_Interpolator->SetThreshold(rayCaster->GetThreshold());
+
+  /** Set up the filters like Initialize() does. */
+  pipeline.m_TransformMovingImageFilter = TransformMovingImageFilterType::New();
+  pipeline.m_TransformMovingImageFilter->SetTransform(pipeline.m_Transform);
+  pipeline.m_TransformMovingImageFilter->SetInterpolator(pipeline.m_Interpolator);
+  pipeline.m_TransformMovingImageFilter->SetInput(movingImage);
+  pipeline.m_TransformMovingImageFilter->SetDefaultPixelValue(0);
+  pipeline.m_TransformMovingImageFilter->SetSize(this->m_FixedImage->GetLargestPossibleRegion().GetSize());
+  pipeline.m_TransformMovingImageFilter->SetOutputOrigin(this->m_FixedImage->GetOrigin());
+  pipeline.m_TransformMovingImageFilter->SetOutputSpacing(this->m_FixedImage->GetSpacing());
+  pipeline.m_TransformMovingImageFilter->SetOutputDirection(this->m_FixedImage->GetDirection());
+  pipeline.m_TransformMovingImageFilter->SetNumberOfWorkUnits(numberOfFilterWorkUnits);
+
+  pipeline.m_MultiplyImageFilter = MultiplyImageFilterType::New();
+  pipeline.m_MultiplyImageFilter->SetInput(pipeline.m_TransformMovingImageFilter->GetOutput());
+  pipeline.m_MultiplyImageFilter->SetNumberOfWorkUnits(numberOfFilterWorkUnits);
+  pipeline.m_DifferenceImageFilter = DifferenceImageFilterType::New();
+  pipeline.m_DifferenceImageFilter->SetInput1(fixedImage);
+  pipeline.m_DifferenceImageFilter->SetInput2(pipeline.m_MultiplyImageFilter->GetOutput());
+  pipeline.m_DifferenceImageFilter->SetNumberOfWorkUnits(numberOfFilterWorkUnits);
+  return true;
+
+} // end CreateProjectionPipeline()
+
+
+/**
+ * ********************* ComputeProjectionValue ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+typename PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::MeasureType
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputeProjectionValue(
+  const ProjectionPipelineType & pipeline) const
+{
+  /** The transform parameters have changed, so project again. */
+  pipeline.m_TransformMovingImageFilter->Modified();
+
+  if (!this->m_OptimizeNormalizationFactor)
+  {
+    pipeline.m_MultiplyImageFilter->SetConstant(this->m_NormalizationFactor);
+    pipeline.m_DifferenceImageFilter->UpdateLargestPossibleRegion();
+    const MeasureType measure = this->ComputePIOfDifferenceImage(pipeline.m_DifferenceImageFilter->GetOutput());
+    return -(measure - this->m_FixedMeasure) / this->m_Rescalingfactor;
+  }
+
+  /** Like GetValue(), take the lowest value of a range of normalization factors. Only the
+   * multiplication and the subtraction are repeated for each factor, not the projection.
+   */
+  float       tmpfactor = 0.0;
+  float       factorstep = (this->m_NormalizationFactor * 10 - tmpfactor) / 100;
+  MeasureType currentMeasure = 1e10;
+
+  while (tmpfactor <= this->m_NormalizationFactor * 1.0)
+  {
+    pipeline.m_MultiplyImageFilter->SetConstant(tmpfactor);
+    pipeline.m_DifferenceImageFilter->UpdateLargestPossibleRegion();
+    const MeasureType measure = this->ComputePIOfDifferenceImage(pipeline.m_DifferenceImageFilter->GetOutput());
+    const MeasureType tmpMeasure = (measure - this->m_FixedMeasure) / -this->m_Rescalingfactor;
+
+    if (tmpMeasure < currentMeasure)
+    {
+      currentMeasure = tmpMeasure;
+    }
+
+    tmpfactor += factorstep;
+  }
+
+  return currentMeasure;
+
+} // end ComputeProjectionValue()
+
+
+/**
+ * ********************* ComputeMovedValues ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputeMovedValues(bool computeGradient) const
+{
+  const SizeValueType numberOfPixels = this->m_GridRegion.GetNumberOfPixels();
+  this->m_MovedValues.resize(numberOfPixels);
+  this->m_MovedPixelIsInside.resize(numberOfPixels);
+  if (computeGradient)
+  {
+    this->m_MovedGradients.resize(numberOfPixels);
+  }
+
+  /** Sample contiguous parts of the grid on the thread pool. Outside the moving
+   * image the value is zero, like the default pixel value of the resampler.
+   */
+  const ThreadIdType numberOfWorkUnits = static_cast<ThreadIdType>(
+    std::max<SizeValueType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfPixels), 1));
+  const auto computeMovedValues = [this, computeGradient, numberOfPixels, numberOfWorkUnits](ThreadIdType workUnit) {
+    const SizeValueType begin = workUnit * numberOfPixels / numberOfWorkUnits;
+    const SizeValueType end = (workUnit + 1) * numberOfPixels / numberOfWorkUnits;
+    for (SizeValueType pos = begin; pos < end; ++pos)
+    {
+      FixedImagePointType  fixedPoint;
+      MovingImagePointType mappedPoint;
+      this->m_FixedImage->TransformIndexToPhysicalPoint(this->GetGridIndex(pos), fixedPoint);
+
+      RealType movingImageValue = NumericTraits<RealType>::ZeroValue();
+      bool     sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
+      if (sampleOk)
+      {
+        sampleOk = this->EvaluateMovingImageValueAndDerivative(
+          mappedPoint, movingImageValue, computeGradient ? &this->m_MovedGradients[pos] : nullptr);
+      }
+      this->m_MovedValues[pos] = sampleOk ? movingImageValue : NumericTraits<RealType>::ZeroValue();
+      this->m_MovedPixelIsInside[pos] = sampleOk;
+    }
+  };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, computeMovedValues);
+
+} // end ComputeMovedValues()
+
+
+/**
+ * ********************* ComputePIDiffAndMovedValueDerivatives ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+typename PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::MeasureType
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIDiffAndMovedValueDerivatives(
+  double scalingfactor,
+  bool   computeDerivatives) const
+{
+  const SizeValueType numberOfPixels = this->m_GridRegion.GetNumberOfPixels();
+  if (computeDerivatives)
+  {
+    this->m_MovedValueDerivatives.resize(numberOfPixels);
+  }
+
+  /** The measure sums sigma^2 / ( sigma^2 + ( d(x) - d(y) )^2 ) over the valid pixels x and
+   * their neighbors y, with the difference image d = F - s M. The derivative to M(z) gets a
+   * contribution of each neighbor y of z, as x = z and as x = y, provided that x is valid.
+   * Only the neighborhoods are needed, so the pixels can be processed independently.
+   */
+  const ThreadIdType numberOfWorkUnits = static_cast<ThreadIdType>(
+    std::max<SizeValueType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfPixels), 1));
+  std::vector<MeasureType> measures(numberOfWorkUnits, NumericTraits<MeasureType>::Zero);
+
+  const auto computePIDiff = [this, scalingfactor, computeDerivatives, numberOfPixels, numberOfWorkUnits, &measures](
+                               ThreadIdType workUnit) {
+    const SizeValueType   begin = workUnit * numberOfPixels / numberOfWorkUnits;
+    const SizeValueType   end = (workUnit + 1) * numberOfPixels / numberOfWorkUnits;
+    const OffsetValueType sizeX = this->m_GridRegion.GetSize(0);
+    const OffsetValueType sizeY = this->m_GridRegion.GetSize(1);
+    const OffsetValueType radius = this->m_NeighborhoodRadius;
+    const double          sigma2 = this->m_NoiseConstant;
+    const double          derivativeFactor = scalingfactor / this->m_Rescalingfactor;
+
+    MeasureType measure = NumericTraits<MeasureType>::Zero;
+    for (SizeValueType pos = begin; pos < end; ++pos)
+    {
+      const bool currentIsValid = this->m_FixedPixelIsValid[pos];
+      if (!currentIsValid && !computeDerivatives)
+      {
+        continue;
+      }
+
+      const OffsetValueType x = static_cast<OffsetValueType>(pos) % sizeX;
+      const OffsetValueType y = (static_cast<OffsetValueType>(pos) / sizeX) % sizeY;
+      const double          currentDiff = this->m_FixedValues[pos] - scalingfactor * this->m_MovedValues[pos];
+      double                movedValueDerivative = 0.0;
+
+      for (OffsetValueType ny = std::max<OffsetValueType>(y - radius, 0);
+           ny <= std::min<OffsetValueType>(y + radius, sizeY - 1);
+           ++ny)
+      {
+        for (OffsetValueType nx = std::max<OffsetValueType>(x - radius, 0);
+             nx <= std::min<OffsetValueType>(x + radius, sizeX - 1);
+             ++nx)
+        {
+          const SizeValueType neighborPos = pos + (ny - y) * sizeX + (nx - x);
+          const int           numberOfTerms = currentIsValid + this->m_FixedPixelIsValid[neighborPos];
+          if (numberOfTerms == 0)
+          {
+            continue;
+          }
+
+          const double diff =
+            currentDiff - (this->m_FixedValues[neighborPos] - scalingfactor * this->m_MovedValues[neighborPos]);
+          const double denominator = sigma2 + diff * diff;
+          if (currentIsValid)
+          {
+            measure += sigma2 / denominator;
+          }
+          if (computeDerivatives)
+          {
+            movedValueDerivative -= numberOfTerms * 2.0 * diff * sigma2 / (denominator * denominator);
+          }
+        } // end for nx
+      }   // end for ny
+
+      /** Outside the moving image, the moving image value does not depend on the transform. */
+      if (computeDerivatives)
+      {
+        this->m_MovedValueDerivatives[pos] =
+          this->m_MovedPixelIsInside[pos] ? derivativeFactor * movedValueDerivative : 0.0;
+      }
+    } // end for pos
+
+    measures[workUnit] = measure;
+  };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, computePIDiff);
+
+  MeasureType measure = NumericTraits<MeasureType>::Zero;
+  for (const MeasureType partialMeasure : measures)
+  {
+    measure += partialMeasure;
+  }
+  return measure;
+
+} // end ComputePIDiffAndMovedValueDerivatives()
+
+
+/**
+ * ********************* ComputeOptimalNormalizationFactor ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+double
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputeOptimalNormalizationFactor(void) const
+{
+  float       tmpfactor = 0.0;
+  float       factorstep = (this->m_NormalizationFactor * 10 - tmpfactor) / 100;
+  float       bestfactor = tmpfactor;
+  MeasureType currentMeasure = 1e10;
+
+  while (tmpfactor <= this->m_NormalizationFactor * 1.0)
+  {
+    const MeasureType measure = this->ComputePIDiffAndMovedValueDerivatives(tmpfactor, false);
+    const MeasureType tmpMeasure = (measure - this->m_FixedMeasure) / -this->m_Rescalingfactor;
+
+    if (tmpMeasure < currentMeasure)
+    {
+      currentMeasure = tmpMeasure;
+      bestfactor = tmpfactor;
+    }
+
+    tmpfactor += factorstep;
+  }
+
+  return bestfactor;
+
+} // end ComputeOptimalNormalizationFactor()
 
 
 /**
@@ -351,6 +698,16 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::GetValue(
   this->BeforeThreadedGetValueAndDerivative(parameters);
   // this->SetTransformParameters( parameters );
 
+  /** Without ray casting, compute the value from the sampled moving image. */
+  if (this->m_UseAnalyticDerivative)
+  {
+    this->ComputeMovedValues(false);
+    const double scalingfactor = this->m_OptimizeNormalizationFactor ? this->ComputeOptimalNormalizationFactor()
+                                                                     : this->m_NormalizationFactor;
+    const MeasureType measure = this->ComputePIDiffAndMovedValueDerivatives(scalingfactor, false);
+    return -(measure - this->m_FixedMeasure) / this->m_Rescalingfactor;
+  }
+
   this->m_TransformMovingImageFilter->Modified();
   this->m_DifferenceImageFilter->UpdateLargestPossibleRegion();
   MeasureType measure = 1e10;
@@ -397,11 +754,59 @@ void
 PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::GetDerivative(const TransformParametersType & parameters,
                                                                              DerivativeType & derivative) const
 {
+  /** The analytic derivative is computed together with the value. */
+  if (this->m_UseAnalyticDerivative)
+  {
+    MeasureType dummyvalue = NumericTraits<MeasureType>::Zero;
+    this->GetValueAndDerivative(parameters, dummyvalue, derivative);
+    return;
+  }
+
   TransformParametersType testPoint;
   testPoint = parameters;
   const unsigned int numberOfParameters = this->GetNumberOfParameters();
   derivative = DerivativeType(numberOfParameters);
 
+  /** Evaluate the parameters concurrently, each work unit with its own copy of the projection
+   * pipeline. The filters of the copies share the threads that remain.
+   */
+  const ThreadIdType numberOfWorkUnits =
+    static_cast<ThreadIdType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfParameters));
+  if (numberOfWorkUnits > 1)
+  {
+    const ThreadIdType numberOfFilterWorkUnits =
+      std::max<ThreadIdType>(Self::GetNumberOfWorkUnits() / numberOfWorkUnits, 1);
+    std::vector<ProjectionPipelineType> pipelines(numberOfWorkUnits);
+    bool                                pipelinesCreated = true;
+    for (ProjectionPipelineType & pipeline : pipelines)
+    {
+      pipelinesCreated = pipelinesCreated && this->CreateProjectionPipeline(pipeline, numberOfFilterWorkUnits);
+    }
+
+    if (pipelinesCreated)
+    {
+      const auto computeDerivatives =
+        [this, &pipelines, &parameters, &derivative, numberOfParameters, numberOfWorkUnits](ThreadIdType workUnit) {
+          const ProjectionPipelineType & pipeline = pipelines[workUnit];
+          TransformParametersType        workUnitTestPoint = parameters;
+          for (unsigned int i = workUnit; i < numberOfParameters; i += numberOfWorkUnits)
+          {
+            workUnitTestPoint[i] -= this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
+            pipeline.m_Transform->SetParameters(workUnitTestPoint);
+            const MeasureType valuep0 = this->ComputeProjectionValue(pipeline);
+            workUnitTestPoint[i] += 2 * this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
+            pipeline.m_Transform->SetParameters(workUnitTestPoint);
+            const MeasureType valuep1 = this->ComputeProjectionValue(pipeline);
+            derivative[i] = (valuep1 - valuep0) / (2 * this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]));
+            workUnitTestPoint[i] = parameters[i];
+          }
+        };
+      this->m_ThreadPool->Execute(numberOfWorkUnits, computeDerivatives);
+      return;
+    }
+  }
+
+  /** Otherwise evaluate the parameters one by one. */
   for (unsigned int i = 0; i < numberOfParameters; i++)
   {
     testPoint[i] -= this->m_DerivativeDelta / std::sqrt(this->m_Scales[i]);
@@ -426,12 +831,105 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::GetValueAndDeriva
   MeasureType &                   Value,
   DerivativeType &                derivative) const
 {
-  Value = this->GetValue(parameters);
-  this->GetDerivative(parameters, derivative);
+  if (!this->m_UseAnalyticDerivative)
+  {
+    Value = this->GetValue(parameters);
+    this->GetDerivative(parameters, derivative);
+    return;
+  }
+
+  /** Call non-thread-safe stuff, such as this->SetTransformParameters( parameters ). */
+  this->BeforeThreadedGetValueAndDerivative(parameters);
+
+  /** Sample the moving image and its gradient, and compute the derivative of the
+   * metric value to each moving image value. The normalization factor is a constant
+   * for the derivative, also when it is optimized.
+   */
+  this->ComputeMovedValues(true);
+  const double      scalingfactor = this->m_OptimizeNormalizationFactor ? this->ComputeOptimalNormalizationFactor()
+                                                                        : this->m_NormalizationFactor;
+  const MeasureType measure = this->ComputePIDiffAndMovedValueDerivatives(scalingfactor, true);
+  Value = -(measure - this->m_FixedMeasure) / this->m_Rescalingfactor;
+
+  /** Launch multi-threading derivative, distributing the grid pixels over the work units. */
+  this->m_SampleChunkScheduler.Initialize(Self::GetNumberOfWorkUnits(), this->m_GridRegion.GetNumberOfPixels());
+  this->ExecuteThreaderCallback(this->GetValueAndDerivativeThreaderCallback,
+                                const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
+
+  /** Gather the derivatives from all threads. */
+  derivative.SetSize(this->GetNumberOfParameters());
+  this->AfterThreadedGetValueAndDerivative(Value, derivative);
 
 } // end GetValueAndDerivative()
 
 
+/**
+ * ********************* ThreadedGetValueAndDerivative ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetValueAndDerivative(ThreadIdType threadId)
+{
+  /** Initialize array that stores dM(x)/dmu, and the sparse Jacobian + indices. */
+  const NumberOfParametersType nnzji = this->m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices();
+  NonZeroJacobianIndicesType   nzji = NonZeroJacobianIndicesType(nnzji);
+  DerivativeType               imageJacobian(nnzji);
+
+  /** Get a handle to the pre-allocated derivative for the current thread. */
+  DerivativeType & derivative = this->m_GetValueAndDerivativePerThreadVariables[threadId].st_Derivative;
+
+  /** The derivative is the sum over the grid pixels of dValue/dM(x) (dM/dx)^T (dT/dmu). */
+  SizeValueType pos_begin = 0;
+  SizeValueType pos_end = 0;
+  while (this->GetNextSampleChunk(threadId, pos_begin, pos_end))
+  {
+    for (SizeValueType pos = pos_begin; pos < pos_end; ++pos)
+    {
+      const DerivativeValueType movedValueDerivative = this->m_MovedValueDerivatives[pos];
+      if (movedValueDerivative == NumericTraits<DerivativeValueType>::ZeroValue())
+      {
+        continue;
+      }
+
+      /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
+      FixedImagePointType fixedPoint;
+      this->m_FixedImage->TransformIndexToPhysicalPoint(this->GetGridIndex(pos), fixedPoint);
+      this->EvaluateTransformJacobianWithImageGradientProduct(
+        fixedPoint, this->m_MovedGradients[pos], imageJacobian, nzji);
+
+      this->TouchDerivativeTiles(threadId, nzji);
+      for (unsigned int i = 0; i < nnzji; ++i)
+      {
+        derivative[nzji[i]] += movedValueDerivative * imageJacobian[i];
+      }
+    } // end for loop over the grid pixels
+  }   // end while loop over the chunks
+
+} // end ThreadedGetValueAndDerivative()
+
+
+/**
+ * ********************* AfterThreadedGetValueAndDerivative ******************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::AfterThreadedGetValueAndDerivative(
+  MeasureType & itkNotUsed(value),
+  DerivativeType &              derivative) const
+{
+  /** The value is already computed; accumulate the derivatives multi-threaded. */
+  this->m_ThreaderMetricParameters.st_DerivativePointer = derivative.begin();
+  this->m_ThreaderMetricParameters.st_NormalizationFactor = 1.0;
+
+  this->ExecuteThreaderCallback(this->AccumulateDerivativesThreaderCallback,
+                                const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)),
+                                TimingProfile::DerivativeAccumulation);
+
+} // end AfterThreadedGetValueAndDerivative()
+
+
 } // end namespace itk
 
 #endif // end itkPatternIntensityImageToImageMetric_hxx
@@ -35,6 +35,9 @@
 #include "itkBinaryBallStructuringElement.h"
 #include "itkImageRegionIterator.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace itk
 {
 /**
@@ -152,6 +155,8 @@ public:
   typedef typename BSplineTransformType::ImageType   CoefficientImageType;
   typedef typename CoefficientImageType::Pointer     CoefficientImagePointer;
   typedef typename CoefficientImageType::SpacingType CoefficientImageSpacingType;
+  typedef typename CoefficientImageType::RegionType  CoefficientImageRegionType;
+  typedef typename CoefficientImageType::PixelType   CoefficientPixelType;
 
   /** Typedef support for neighborhoods, filters, etc. */
   typedef Neighborhood<ScalarType, itkGetStaticConstMacro(FixedImageDimension)>       NeighborhoodType;
@@ -319,9 +324,26 @@ private:
   void
   CreateNDOperator(NeighborhoodType & F, const std::string & whichF, const CoefficientImageSpacingType & spacing) const;
 
-  /** Private function used for the filtering. It performs 1D separable filtering. */
-  CoefficientImagePointer
-  FilterSeparable(const CoefficientImageType *, const std::vector<NeighborhoodType> & Operators) const;
+  /** Private function used for the filtering. It performs 1D separable filtering
+   * with several sets of operators at once, one output per set. The sets that start
+   * with the same 1D operators share the intermediate results of those operators,
+   * so that only ImageDimension - 1 intermediate images exist at any time.
+   */
+  void
+  FilterSeparable(const CoefficientImageType *                               image,
+                  const std::vector<const std::vector<NeighborhoodType> *> & operatorSets,
+                  std::vector<CoefficientImagePointer> &                     outputs) const;
+
+  /** Private function that splits a region of the B-spline grid in slabs along the
+   * last dimension, one for each work unit. Work unit w handles the pixel offsets
+   * slabOffsets[ w ] up to slabOffsets[ w + 1 ]. Returns the number of work units.
+   */
+  ThreadIdType
+  ComputeSlabOffsets(const CoefficientImageRegionType & region, std::vector<SizeValueType> & slabOffsets) const;
+
+  /** Private function that adds the rigidity coefficients together. */
+  ScalarType
+  ComputeRigidityCoefficientSum(void) const;
 
   /** Member variables. */
   BSplineTransformPointer m_BSplineTransform;
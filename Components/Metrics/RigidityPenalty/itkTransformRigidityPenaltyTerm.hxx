@@ -338,116 +338,118 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::FillRigidityCoefficientI
   /** Make sure that the transform is up to date. */
   this->m_Transform->SetParameters(parameters);
 
-  /** Create and reset an iterator over m_RigidityCoefficientImage. */
-  RigidityImageIteratorType it(this->m_RigidityCoefficientImage,
-                               this->m_RigidityCoefficientImage->GetLargestPossibleRegion());
-  it.GoToBegin();
-
-  /** Fill m_RigidityCoefficientImage. */
-  RigidityPixelType      fixedValue, movingValue, in;
-  RigidityImagePointType point;
-  point.Fill(0.0f);
-  RigidityImageIndexType index1, index2;
-  index1.Fill(0);
-  index2.Fill(0);
-  fixedValue = NumericTraits<RigidityPixelType>::Zero;
-  movingValue = NumericTraits<RigidityPixelType>::Zero;
-  in = NumericTraits<RigidityPixelType>::Zero;
-  bool isInFixedImage = false;
-  bool isInMovingImage = false;
-  while (!it.IsAtEnd())
-  {
-    /** Get current pixel in world coordinates. */
-    this->m_RigidityCoefficientImage->TransformIndexToPhysicalPoint(it.GetIndex(), point);
-
-    /** Get the corresponding indices in the fixed and moving RigidityImage's.
-     * NOTE: Floating point index results are truncated to integers.
-     */
-    if (this->m_UseFixedRigidityImage)
-    {
-      isInFixedImage = this->m_FixedRigidityImageDilated->TransformPhysicalPointToIndex(point, index1);
-      // \todo: Note that we should actually use the inverted initial transform
-      // here, a little bit like:
-      // isInFixedImage = this->m_FixedRigidityImageDilated
-      //   ->TransformPhysicalPointToIndex( this->Transform->GetInitialTransform()
-      //   ->GetInverse()->TransformPoint( point ), index1 );
-      // This is needed to compensate for the B-spline grid shift that has been
-      // performed earlier, which causes the B-spline grid region and thus the
-      // m_RigidityCoefficientImage region to be different from the fixed (coefffient)
-      // image region.
-      //
-      // Since in general the inverse does not exist, alternative strategies may be:
-      // 1) Approximate the inverse of the initial transform using inverse deformation
-      //    field approximation filters available in the ITK
-      // 2) Instead op looping over m_RigidityCoefficientImage, we can loop over
-      //    m_FixedRigidityImageDilated, employ the normal forward initial transform,
-      //    and fill m_RigidityCoefficientImage this way. A downside is that holes may
-      //    be created in the m_RigidityCoefficientImage, although this has low
-      //    likelihood, since the resolution of m_RigidityCoefficientImage is much
-      //    lower than the fixed (rigidity) image. And we could check for these holes
-      //    afterwards.
-      // WARNING: So, currently the rigidity penalty term does not correctly support
-      // initial transforms, in case a fixed coefficient image is provided. It works
-      // correctly if only a moving coefficient image is provided.
-      // Perhaps we should remove the option to supply the fixed coefficient image,
-      // since the moving one should really be used.
-    }
-    if (this->m_UseMovingRigidityImage)
-    {
-      isInMovingImage = this->m_MovingRigidityImageDilated->TransformPhysicalPointToIndex(
-        // this->m_Transform->TransformPoint( point ), index2 );
-        this->m_BSplineTransform->TransformPoint(point),
-        index2);
-    }
-
-    /** Get the values at those positions. */
-    if (this->m_UseFixedRigidityImage)
-    {
-      if (isInFixedImage)
+  /** Fill m_RigidityCoefficientImage, one slab per work unit. */
+  std::vector<SizeValueType> slabOffsets;
+  const ThreadIdType         numberOfWorkUnits =
+    this->ComputeSlabOffsets(this->m_RigidityCoefficientImage->GetBufferedRegion(), slabOffsets);
+
+  const auto fillSlab = [this, &slabOffsets](ThreadIdType workUnit) {
+    RigidityPixelType * rigidityCoefficients = this->m_RigidityCoefficientImage->GetBufferPointer();
+
+    RigidityPixelType      fixedValue, movingValue, in;
+    RigidityImagePointType point;
+    point.Fill(0.0f);
+    RigidityImageIndexType index1, index2;
+    index1.Fill(0);
+    index2.Fill(0);
+    fixedValue = NumericTraits<RigidityPixelType>::Zero;
+    movingValue = NumericTraits<RigidityPixelType>::Zero;
+    in = NumericTraits<RigidityPixelType>::Zero;
+    bool isInFixedImage = false;
+    bool isInMovingImage = false;
+    for (SizeValueType n = slabOffsets[workUnit]; n < slabOffsets[workUnit + 1]; ++n)
+    {
+      /** Get current pixel in world coordinates. */
+      this->m_RigidityCoefficientImage->TransformIndexToPhysicalPoint(
+        this->m_RigidityCoefficientImage->ComputeIndex(static_cast<OffsetValueType>(n)), point);
+
+      /** Get the corresponding indices in the fixed and moving RigidityImage's.
+       * NOTE: Floating point index results are truncated to integers.
+       */
+      if (this->m_UseFixedRigidityImage)
       {
-        fixedValue = this->m_FixedRigidityImageDilated->GetPixel(index1);
+        isInFixedImage = this->m_FixedRigidityImageDilated->TransformPhysicalPointToIndex(point, index1);
+        // \todo: Note that we should actually use the inverted initial transform
+        // here, a little bit like:
+        // isInFixedImage = this->m_FixedRigidityImageDilated
+        //   ->TransformPhysicalPointToIndex( this->Transform->GetInitialTransform()
+        //   ->GetInverse()->TransformPoint( point ), index1 );
+        // This is needed to compensate for the B-spline grid shift that has been
+        // performed earlier, which causes the B-spline grid region and thus the
+        // m_RigidityCoefficientImage region to be different from the fixed (coefffient)
+        // image region.
+        //
+        // Since in general the inverse does not exist, alternative strategies may be:
+        // 1) Approximate the inverse of the initial transform using inverse deformation
+        //    field approximation filters available in the ITK
+        // 2) Instead op looping over m_RigidityCoefficientImage, we can loop over
+        //    m_FixedRigidityImageDilated, employ the normal forward initial transform,
+        //    and fill m_RigidityCoefficientImage this way. A downside is that holes may
+        //    be created in the m_RigidityCoefficientImage, although this has low
+        //    likelihood, since the resolution of m_RigidityCoefficientImage is much
+        //    lower than the fixed (rigidity) image. And we could check for these holes
+        //    afterwards.
+        // WARNING: So, currently the rigidity penalty term does not correctly support
+        // initial transforms, in case a fixed coefficient image is provided. It works
+        // correctly if only a moving coefficient image is provided.
+        // Perhaps we should remove the option to supply the fixed coefficient image,
+        // since the moving one should really be used.
       }
-      else
+      if (this->m_UseMovingRigidityImage)
       {
-        fixedValue = 0.0;
+        isInMovingImage = this->m_MovingRigidityImageDilated->TransformPhysicalPointToIndex(
+          // this->m_Transform->TransformPoint( point ), index2 );
+          this->m_BSplineTransform->TransformPoint(point),
+          index2);
       }
-    }
 
-    if (this->m_UseMovingRigidityImage)
-    {
-      if (isInMovingImage)
+      /** Get the values at those positions. */
+      if (this->m_UseFixedRigidityImage)
       {
-        movingValue = this->m_MovingRigidityImageDilated->GetPixel(index2);
+        if (isInFixedImage)
+        {
+          fixedValue = this->m_FixedRigidityImageDilated->GetPixel(index1);
+        }
+        else
+        {
+          fixedValue = 0.0;
+        }
       }
-      else
+
+      if (this->m_UseMovingRigidityImage)
       {
-        movingValue = 0.0;
+        if (isInMovingImage)
+        {
+          movingValue = this->m_MovingRigidityImageDilated->GetPixel(index2);
+        }
+        else
+        {
+          movingValue = 0.0;
+        }
       }
-    }
-
-    /** Determine the maximum. */
-    if (this->m_UseFixedRigidityImage && this->m_UseMovingRigidityImage)
-    {
-      in = (fixedValue > movingValue ? fixedValue : movingValue);
-    }
-    else if (this->m_UseFixedRigidityImage && !this->m_UseMovingRigidityImage)
-    {
-      in = fixedValue;
-    }
-    else if (!this->m_UseFixedRigidityImage && this->m_UseMovingRigidityImage)
-    {
-      in = movingValue;
-    }
-    /** else{} is not happening here, because we assume that one of them is true.
-     * In our case we checked that in the derived class: elxMattesMIWRR.
-     */
 
-    /** Set it. */
-    it.Set(in);
+      /** Determine the maximum. */
+      if (this->m_UseFixedRigidityImage && this->m_UseMovingRigidityImage)
+      {
+        in = (fixedValue > movingValue ? fixedValue : movingValue);
+      }
+      else if (this->m_UseFixedRigidityImage && !this->m_UseMovingRigidityImage)
+      {
+        in = fixedValue;
+      }
+      else if (!this->m_UseFixedRigidityImage && this->m_UseMovingRigidityImage)
+      {
+        in = movingValue;
+      }
+      /** else{} is not happening here, because we assume that one of them is true.
+       * In our case we checked that in the derived class: elxMattesMIWRR.
+       */
 
-    /** Increase iterator. */
-    ++it;
-  } // end while loop over rigidity coefficient image
+      /** Set it. */
+      rigidityCoefficients[n] = in;
+    } // end for loop over the slab
+  };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, fillSlab);
 
   /** Remember that the rigidity coefficient image is filled. */
   this->m_RigidityCoefficientImageIsFilled = true;
@@ -498,18 +500,8 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValue(const Parameter
    *
    ************************************************************************* */
 
-  /** Create iterator over the rigidity coeficient image. */
-  CoefficientImageIteratorType it_RCI(this->m_RigidityCoefficientImage,
-                                      this->m_RigidityCoefficientImage->GetLargestPossibleRegion());
-  it_RCI.GoToBegin();
-  ScalarType rigidityCoefficientSum = NumericTraits<ScalarType>::Zero;
-
   /** Add the rigidity coefficients together. */
-  while (!it_RCI.IsAtEnd())
-  {
-    rigidityCoefficientSum += it_RCI.Get();
-    ++it_RCI;
-  }
+  const ScalarType rigidityCoefficientSum = this->ComputeRigidityCoefficientSum();
 
   /** Check for early termination. */
   if (rigidityCoefficientSum < 1e-14)
@@ -528,31 +520,12 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValue(const Parameter
     Operators_D(ImageDimension), Operators_E(ImageDimension), Operators_F(ImageDimension), Operators_G(ImageDimension),
     Operators_H(ImageDimension), Operators_I(ImageDimension);
 
-  /** Create B-spline coefficient images that are filtered once. */
-  std::vector<CoefficientImagePointer> ui_FA(ImageDimension), ui_FB(ImageDimension), ui_FC(ImageDimension),
-    ui_FD(ImageDimension), ui_FE(ImageDimension), ui_FF(ImageDimension), ui_FG(ImageDimension), ui_FH(ImageDimension),
-    ui_FI(ImageDimension);
-
-  /** For all dimensions ... */
+  /** For all dimensions create the apropiate operators.
+   * The operators C, D and E from the paper are here created
+   * by Create1DOperator D, E and G, because of the 3D case and history.
+   */
   for (unsigned int i = 0; i < ImageDimension; i++)
   {
-    /** ... create the filtered images ... */
-    ui_FA[i] = CoefficientImageType::New();
-    ui_FB[i] = CoefficientImageType::New();
-    ui_FD[i] = CoefficientImageType::New();
-    ui_FE[i] = CoefficientImageType::New();
-    ui_FG[i] = CoefficientImageType::New();
-    if (ImageDimension == 3)
-    {
-      ui_FC[i] = CoefficientImageType::New();
-      ui_FF[i] = CoefficientImageType::New();
-      ui_FH[i] = CoefficientImageType::New();
-      ui_FI[i] = CoefficientImageType::New();
-    }
-    /** ... and the apropiate operators.
-     * The operators C, D and E from the paper are here created
-     * by Create1DOperator D, E and G, because of the 3D case and history.
-     */
     this->Create1DOperator(Operators_A[i], "FA_xi", i + 1, spacing);
     this->Create1DOperator(Operators_B[i], "FB_xi", i + 1, spacing);
     this->Create1DOperator(Operators_D[i], "FD_xi", i + 1, spacing);
@@ -567,243 +540,205 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValue(const Parameter
     }
   } // end for loop
 
-  /** TASK 2:
-   * Filter the B-spline coefficient images.
-   *
-   ************************************************************************* */
-
-  /** Filter the inputImages. */
-  for (unsigned int i = 0; i < ImageDimension; i++)
+  /** Select the operators that are needed for the conditions that are calculated,
+   * and the B-spline coefficient images that are filtered with them.
+   */
+  std::vector<CoefficientImagePointer> ui_FA(ImageDimension), ui_FB(ImageDimension), ui_FC(ImageDimension),
+    ui_FD(ImageDimension), ui_FE(ImageDimension), ui_FF(ImageDimension), ui_FG(ImageDimension), ui_FH(ImageDimension),
+    ui_FI(ImageDimension);
+  std::vector<const std::vector<NeighborhoodType> *>  operatorSets;
+  std::vector<std::vector<CoefficientImagePointer> *> filteredImages;
+  if (this->m_CalculateOrthonormalityCondition || this->m_CalculatePropernessCondition)
+  {
+    operatorSets.push_back(&Operators_A);
+    filteredImages.push_back(&ui_FA);
+    operatorSets.push_back(&Operators_B);
+    filteredImages.push_back(&ui_FB);
+    if (ImageDimension == 3)
+    {
+      operatorSets.push_back(&Operators_C);
+      filteredImages.push_back(&ui_FC);
+    }
+  }
+  if (this->m_CalculateLinearityCondition)
   {
-    ui_FA[i] = this->FilterSeparable(inputImages[i], Operators_A);
-    ui_FB[i] = this->FilterSeparable(inputImages[i], Operators_B);
-    ui_FD[i] = this->FilterSeparable(inputImages[i], Operators_D);
-    ui_FE[i] = this->FilterSeparable(inputImages[i], Operators_E);
-    ui_FG[i] = this->FilterSeparable(inputImages[i], Operators_G);
+    operatorSets.push_back(&Operators_D);
+    filteredImages.push_back(&ui_FD);
+    operatorSets.push_back(&Operators_E);
+    filteredImages.push_back(&ui_FE);
+    operatorSets.push_back(&Operators_G);
+    filteredImages.push_back(&ui_FG);
     if (ImageDimension == 3)
     {
-      ui_FC[i] = this->FilterSeparable(inputImages[i], Operators_C);
-      ui_FF[i] = this->FilterSeparable(inputImages[i], Operators_F);
-      ui_FH[i] = this->FilterSeparable(inputImages[i], Operators_H);
-      ui_FI[i] = this->FilterSeparable(inputImages[i], Operators_I);
+      operatorSets.push_back(&Operators_F);
+      filteredImages.push_back(&ui_FF);
+      operatorSets.push_back(&Operators_H);
+      filteredImages.push_back(&ui_FH);
+      operatorSets.push_back(&Operators_I);
+      filteredImages.push_back(&ui_FI);
     }
   }
 
-  /** TASK 3:
-   * Create iterators.
+  /** TASK 2:
+   * Filter the B-spline coefficient images.
    *
    ************************************************************************* */
 
-  /** Create iterators over ui_F?. */
-  std::vector<CoefficientImageIteratorType> itA(ImageDimension), itB(ImageDimension), itC(ImageDimension),
-    itD(ImageDimension), itE(ImageDimension), itF(ImageDimension), itG(ImageDimension), itH(ImageDimension),
-    itI(ImageDimension);
-
-  /** Create iterators. */
+  /** Filter the inputImages with all selected operators at once. */
   for (unsigned int i = 0; i < ImageDimension; i++)
   {
-    /** Create iterators. */
-    itA[i] = CoefficientImageIteratorType(ui_FA[i], ui_FA[i]->GetLargestPossibleRegion());
-    itB[i] = CoefficientImageIteratorType(ui_FB[i], ui_FB[i]->GetLargestPossibleRegion());
-    itD[i] = CoefficientImageIteratorType(ui_FD[i], ui_FD[i]->GetLargestPossibleRegion());
-    itE[i] = CoefficientImageIteratorType(ui_FE[i], ui_FE[i]->GetLargestPossibleRegion());
-    itG[i] = CoefficientImageIteratorType(ui_FG[i], ui_FG[i]->GetLargestPossibleRegion());
-    if (ImageDimension == 3)
+    std::vector<CoefficientImagePointer> outputs;
+    this->FilterSeparable(inputImages[i], operatorSets, outputs);
+    for (unsigned int k = 0; k < operatorSets.size(); ++k)
     {
-      itC[i] = CoefficientImageIteratorType(ui_FC[i], ui_FC[i]->GetLargestPossibleRegion());
-      itF[i] = CoefficientImageIteratorType(ui_FF[i], ui_FF[i]->GetLargestPossibleRegion());
-      itH[i] = CoefficientImageIteratorType(ui_FH[i], ui_FH[i]->GetLargestPossibleRegion());
-      itI[i] = CoefficientImageIteratorType(ui_FI[i], ui_FI[i]->GetLargestPossibleRegion());
+      (*filteredImages[k])[i] = outputs[k];
     }
-    /** Reset iterators. */
-    itA[i].GoToBegin();
-    itB[i].GoToBegin();
-    itD[i].GoToBegin();
-    itE[i].GoToBegin();
-    itG[i].GoToBegin();
-    if (ImageDimension == 3)
+  }
+
+  /** Get direct access to the filtered images. */
+  const auto getBuffers = [](const std::vector<CoefficientImagePointer> & images) {
+    std::vector<const CoefficientPixelType *> buffers(images.size(), nullptr);
+    for (unsigned int i = 0; i < images.size(); i++)
     {
-      itC[i].GoToBegin();
-      itF[i].GoToBegin();
-      itH[i].GoToBegin();
-      itI[i].GoToBegin();
+      if (images[i].IsNotNull())
+      {
+        buffers[i] = images[i]->GetBufferPointer();
+      }
     }
-  }
+    return buffers;
+  };
+  const auto A = getBuffers(ui_FA);
+  const auto B = getBuffers(ui_FB);
+  const auto C = getBuffers(ui_FC);
+  const auto D = getBuffers(ui_FD);
+  const auto E = getBuffers(ui_FE);
+  const auto F = getBuffers(ui_FF);
+  const auto G = getBuffers(ui_FG);
+  const auto H = getBuffers(ui_FH);
+  const auto I = getBuffers(ui_FI);
+  const RigidityPixelType * rigidityCoefficients = this->m_RigidityCoefficientImage->GetBufferPointer();
+
+  /** Split the B-spline grid in slabs, one for each work unit. */
+  std::vector<SizeValueType> slabOffsets;
+  const ThreadIdType         numberOfWorkUnits =
+    this->ComputeSlabOffsets(this->m_RigidityCoefficientImage->GetBufferedRegion(), slabOffsets);
 
-  /** TASK 4A:
+  /** TASK 3:
    * Do the actual calculation of the rigidity penalty term value.
-   * Calculate the orthonormality term.
+   * Calculate the orthonormality, properness and linearity terms in
+   * a single pass over the B-spline grid, one slab per work unit.
    *
    ************************************************************************* */
 
-  /** Reset all iterators. */
-  it_RCI.GoToBegin();
-
-  if (this->m_CalculateOrthonormalityCondition)
-  {
-    ScalarType mu1_A, mu2_A, mu3_A, mu1_B, mu2_B, mu3_B, mu1_C, mu2_C, mu3_C;
-    while (!itA[0].IsAtEnd())
-    {
-      /** Copy values: this way we avoid calling Get() so many times.
+  std::vector<MeasureType> orthonormalityValues(numberOfWorkUnits);
+  std::vector<MeasureType> propernessValues(numberOfWorkUnits);
+  std::vector<MeasureType> linearityValues(numberOfWorkUnits);
+
+  const auto computeValues = [this,
+                              &slabOffsets,
+                              &A,
+                              &B,
+                              &C,
+                              &D,
+                              &E,
+                              &F,
+                              &G,
+                              &H,
+                              &I,
+                              rigidityCoefficients,
+                              &orthonormalityValues,
+                              &propernessValues,
+                              &linearityValues](ThreadIdType workUnit) {
+    MeasureType orthonormalityValue = NumericTraits<MeasureType>::Zero;
+    MeasureType propernessValue = NumericTraits<MeasureType>::Zero;
+    MeasureType linearityValue = NumericTraits<MeasureType>::Zero;
+    ScalarType  mu1_A, mu2_A, mu3_A, mu1_B, mu2_B, mu3_B, mu1_C, mu2_C, mu3_C;
+    for (SizeValueType n = slabOffsets[workUnit]; n < slabOffsets[workUnit + 1]; ++n)
+    {
+      const ScalarType rigidityCoefficient = rigidityCoefficients[n];
+
+      /** Copy values: this way we avoid the indexing so many times.
        * It also improves code readability.
        */
-      mu1_A = itA[0].Get();
-      mu2_A = itA[1].Get();
-      mu1_B = itB[0].Get();
-      mu2_B = itB[1].Get();
-      if (ImageDimension == 3)
-      {
-        mu3_A = itA[2].Get();
-        mu3_B = itB[2].Get();
-        mu1_C = itC[0].Get();
-        mu2_C = itC[1].Get();
-        mu3_C = itC[2].Get();
-      }
-
-      if (ImageDimension == 2)
-      {
-        this->m_OrthonormalityConditionValue +=
-          it_RCI.Get() * (std::pow(+(1.0 + mu1_A) * (1.0 + mu1_A) + mu2_A * mu2_A - 1.0, 2.0) +
-                          std::pow(+mu1_B * mu1_B + (1.0 + mu2_B) * (1.0 + mu2_B) - 1.0, 2.0) +
-                          std::pow(+(1.0 + mu1_A) * mu1_B + mu2_A * (1.0 + mu2_B), 2.0));
-      }
-      else if (ImageDimension == 3)
+      if (this->m_CalculateOrthonormalityCondition || this->m_CalculatePropernessCondition)
       {
-        this->m_OrthonormalityConditionValue +=
-          it_RCI.Get() * (std::pow(+(1.0 + mu1_A) * (1.0 + mu1_A) + mu2_A * mu2_A + mu3_A * mu3_A - 1.0, 2.0) +
-                          std::pow(+(1.0 + mu1_A) * mu1_B + mu2_A * (1.0 + mu2_B) + mu3_A * mu3_B, 2.0) +
-                          std::pow(+(1.0 + mu1_A) * mu1_C + mu2_A * mu2_C + mu3_A * (1.0 + mu3_C), 2.0) +
-                          std::pow(+mu1_B * mu1_B + (1.0 + mu2_B) * (1.0 + mu2_B) + mu3_B * mu3_B - 1.0, 2.0) +
-                          std::pow(+mu1_B * mu1_C + (1.0 + mu2_B) * mu2_C + mu3_B * (1.0 + mu3_C), 2.0) +
-                          std::pow(+mu1_C * mu1_C + mu2_C * mu2_C + (1.0 + mu3_C) * (1.0 + mu3_C) - 1.0, 2.0));
-      }
-
-      /** Increase all iterators. */
-      for (unsigned int i = 0; i < ImageDimension; i++)
-      {
-        ++itA[i];
-        ++itB[i];
+        mu1_A = A[0][n];
+        mu2_A = A[1][n];
+        mu1_B = B[0][n];
+        mu2_B = B[1][n];
         if (ImageDimension == 3)
         {
-          ++itC[i];
+          mu3_A = A[2][n];
+          mu3_B = B[2][n];
+          mu1_C = C[0][n];
+          mu2_C = C[1][n];
+          mu3_C = C[2][n];
         }
       }
-      ++it_RCI;
-    } // end while
-  }   // end if do orthonormality
 
-  /** TASK 4B:
-   * Do the actual calculation of the rigidity penalty term value.
-   * Calculate the properness term.
-   *
-   ************************************************************************* */
-
-  /** Reset all iterators. */
-  for (unsigned int i = 0; i < ImageDimension; i++)
-  {
-    itA[i].GoToBegin();
-    itB[i].GoToBegin();
-    if (ImageDimension == 3)
-    {
-      itC[i].GoToBegin();
-    }
-  }
-  it_RCI.GoToBegin();
-
-  if (this->m_CalculatePropernessCondition)
-  {
-    ScalarType mu1_A, mu2_A, mu3_A, mu1_B, mu2_B, mu3_B, mu1_C, mu2_C, mu3_C;
-    while (!itA[0].IsAtEnd())
-    {
-      /** Copy values: this way we avoid calling Get() so many times.
-       * It also improves code readability.
-       */
-      mu1_A = itA[0].Get();
-      mu2_A = itA[1].Get();
-      mu1_B = itB[0].Get();
-      mu2_B = itB[1].Get();
-      if (ImageDimension == 3)
+      /** Calculate the value of the orthonormality condition. */
+      if (this->m_CalculateOrthonormalityCondition && ImageDimension == 2)
       {
-        mu3_A = itA[2].Get();
-        mu3_B = itB[2].Get();
-        mu1_C = itC[0].Get();
-        mu2_C = itC[1].Get();
-        mu3_C = itC[2].Get();
+        orthonormalityValue +=
+          rigidityCoefficient * (std::pow(+(1.0 + mu1_A) * (1.0 + mu1_A) + mu2_A * mu2_A - 1.0, 2.0) +
+                                 std::pow(+mu1_B * mu1_B + (1.0 + mu2_B) * (1.0 + mu2_B) - 1.0, 2.0) +
+                                 std::pow(+(1.0 + mu1_A) * mu1_B + mu2_A * (1.0 + mu2_B), 2.0));
+      }
+      else if (this->m_CalculateOrthonormalityCondition && ImageDimension == 3)
+      {
+        orthonormalityValue +=
+          rigidityCoefficient * (std::pow(+(1.0 + mu1_A) * (1.0 + mu1_A) + mu2_A * mu2_A + mu3_A * mu3_A - 1.0, 2.0) +
+                                 std::pow(+(1.0 + mu1_A) * mu1_B + mu2_A * (1.0 + mu2_B) + mu3_A * mu3_B, 2.0) +
+                                 std::pow(+(1.0 + mu1_A) * mu1_C + mu2_A * mu2_C + mu3_A * (1.0 + mu3_C), 2.0) +
+                                 std::pow(+mu1_B * mu1_B + (1.0 + mu2_B) * (1.0 + mu2_B) + mu3_B * mu3_B - 1.0, 2.0) +
+                                 std::pow(+mu1_B * mu1_C + (1.0 + mu2_B) * mu2_C + mu3_B * (1.0 + mu3_C), 2.0) +
+                                 std::pow(+mu1_C * mu1_C + mu2_C * mu2_C + (1.0 + mu3_C) * (1.0 + mu3_C) - 1.0, 2.0));
       }
 
-      if (ImageDimension == 2)
+      /** Calculate the value of the properness condition. */
+      if (this->m_CalculatePropernessCondition && ImageDimension == 2)
       {
-        this->m_PropernessConditionValue +=
-          it_RCI.Get() * (std::pow(+(1.0 + mu1_A) * (1.0 + mu2_B) - mu2_A * mu1_B - 1.0, 2.0));
+        propernessValue += rigidityCoefficient * (std::pow(+(1.0 + mu1_A) * (1.0 + mu2_B) - mu2_A * mu1_B - 1.0, 2.0));
       }
-      else if (ImageDimension == 3)
+      else if (this->m_CalculatePropernessCondition && ImageDimension == 3)
       {
-        this->m_PropernessConditionValue +=
-          it_RCI.Get() * (std::pow(-mu1_C * (1.0 + mu2_B) * mu3_A + mu1_B * mu2_C * mu3_A + mu1_C * mu2_A * mu3_B -
-                                     (1.0 + mu1_A) * mu2_C * mu3_B - mu1_B * mu2_A * (1.0 + mu3_C) +
-                                     (1.0 + mu1_A) * (1.0 + mu2_B) * (1.0 + mu3_C) - 1.0,
-                                   2.0));
+        propernessValue +=
+          rigidityCoefficient * (std::pow(-mu1_C * (1.0 + mu2_B) * mu3_A + mu1_B * mu2_C * mu3_A +
+                                            mu1_C * mu2_A * mu3_B - (1.0 + mu1_A) * mu2_C * mu3_B -
+                                            mu1_B * mu2_A * (1.0 + mu3_C) +
+                                            (1.0 + mu1_A) * (1.0 + mu2_B) * (1.0 + mu3_C) - 1.0,
+                                          2.0));
       }
 
-      /** Increase all iterators. */
-      for (unsigned int i = 0; i < ImageDimension; i++)
+      /** Calculate the value of the linearity condition. */
+      if (this->m_CalculateLinearityCondition)
       {
-        ++itA[i];
-        ++itB[i];
-        if (ImageDimension == 3)
+        for (unsigned int i = 0; i < ImageDimension; i++)
         {
-          ++itC[i];
+          linearityValue += rigidityCoefficient * (+D[i][n] * D[i][n] + E[i][n] * E[i][n] + G[i][n] * G[i][n]);
+          if (ImageDimension == 3)
+          {
+            linearityValue += rigidityCoefficient * (+F[i][n] * F[i][n] + H[i][n] * H[i][n] + I[i][n] * I[i][n]);
+          }
         }
       }
-      ++it_RCI;
+    } // end for
 
-    } // end while
-  }   // end if do properness
+    orthonormalityValues[workUnit] = orthonormalityValue;
+    propernessValues[workUnit] = propernessValue;
+    linearityValues[workUnit] = linearityValue;
+  };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, computeValues);
 
-  /** TASK 4C:
-   * Do the actual calculation of the rigidity penalty term value.
-   * Calculate the linearity term.
-   *
-   ************************************************************************* */
-
-  /** Reset all iterators. */
-  it_RCI.GoToBegin();
-
-  if (this->m_CalculateLinearityCondition)
+  /** Add the contributions of the work units. */
+  for (ThreadIdType workUnit = 0; workUnit < numberOfWorkUnits; ++workUnit)
   {
-    while (!itD[0].IsAtEnd())
-    {
-      /** Linearity condition part. */
-      for (unsigned int i = 0; i < ImageDimension; i++)
-      {
-        this->m_LinearityConditionValue +=
-          it_RCI.Get() * (+itD[i].Get() * itD[i].Get() + itE[i].Get() * itE[i].Get() + itG[i].Get() * itG[i].Get());
-        if (ImageDimension == 3)
-        {
-          this->m_LinearityConditionValue +=
-            it_RCI.Get() * (+itF[i].Get() * itF[i].Get() + itH[i].Get() * itH[i].Get() + itI[i].Get() * itI[i].Get());
-        }
-      } // end loop over i
-
-      /** Increase all iterators. */
-      for (unsigned int i = 0; i < ImageDimension; i++)
-      {
-        ++itD[i];
-        ++itE[i];
-        ++itG[i];
-        if (ImageDimension == 3)
-        {
-          ++itF[i];
-          ++itH[i];
-          ++itI[i];
-        }
-      }
-      ++it_RCI;
-
-    } // end while
-  }   // end if do properness
+    this->m_OrthonormalityConditionValue += orthonormalityValues[workUnit];
+    this->m_PropernessConditionValue += propernessValues[workUnit];
+    this->m_LinearityConditionValue += linearityValues[workUnit];
+  }
 
-  /** TASK 5:
+  /** TASK 4:
    * Do the actual calculation of the rigidity penalty term value.
    *
    ************************************************************************* */
@@ -941,18 +876,8 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
    *
    ************************************************************************* */
 
-  /** Create iterator over the rigidity coeficient image. */
-  CoefficientImageIteratorType it_RCI(this->m_RigidityCoefficientImage,
-                                      this->m_RigidityCoefficientImage->GetLargestPossibleRegion());
-  it_RCI.GoToBegin();
-  ScalarType rigidityCoefficientSum = NumericTraits<ScalarType>::Zero;
-
   /** Add the rigidity coefficients together. */
-  while (!it_RCI.IsAtEnd())
-  {
-    rigidityCoefficientSum += it_RCI.Get();
-    ++it_RCI;
-  }
+  const ScalarType rigidityCoefficientSum = this->ComputeRigidityCoefficientSum();
 
   /** Check for early termination. */
   if (rigidityCoefficientSum < 1e-14)
@@ -971,31 +896,12 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
     Operators_D(ImageDimension), Operators_E(ImageDimension), Operators_F(ImageDimension), Operators_G(ImageDimension),
     Operators_H(ImageDimension), Operators_I(ImageDimension);
 
-  /** Create B-spline coefficient images that are filtered once. */
-  std::vector<CoefficientImagePointer> ui_FA(ImageDimension), ui_FB(ImageDimension), ui_FC(ImageDimension),
-    ui_FD(ImageDimension), ui_FE(ImageDimension), ui_FF(ImageDimension), ui_FG(ImageDimension), ui_FH(ImageDimension),
-    ui_FI(ImageDimension);
-
-  /** For all dimensions ... */
+  /** For all dimensions create the apropiate operators.
+   * The operators C, D and E from the paper are here created
+   * by Create1DOperator D, E and G, because of the 3D case and history.
+   */
   for (unsigned int i = 0; i < ImageDimension; i++)
   {
-    /** ... create the filtered images ... */
-    ui_FA[i] = CoefficientImageType::New();
-    ui_FB[i] = CoefficientImageType::New();
-    ui_FD[i] = CoefficientImageType::New();
-    ui_FE[i] = CoefficientImageType::New();
-    ui_FG[i] = CoefficientImageType::New();
-    if (ImageDimension == 3)
-    {
-      ui_FC[i] = CoefficientImageType::New();
-      ui_FF[i] = CoefficientImageType::New();
-      ui_FH[i] = CoefficientImageType::New();
-      ui_FI[i] = CoefficientImageType::New();
-    }
-    /** ... and the apropiate operators.
-     * The operators C, D and E from the paper are here created
-     * by Create1DOperator D, E and G, because of the 3D case and history.
-     */
     this->Create1DOperator(Operators_A[i], "FA_xi", i + 1, spacing);
     this->Create1DOperator(Operators_B[i], "FB_xi", i + 1, spacing);
     this->Create1DOperator(Operators_D[i], "FD_xi", i + 1, spacing);
@@ -1010,330 +916,303 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
     }
   } // end for loop
 
-  /** TASK 2:
-   * Filter the B-spline coefficient images.
-   *
-   ************************************************************************* */
-
-  /** Filter the inputImages. */
-  for (unsigned int i = 0; i < ImageDimension; i++)
+  /** Select the operators that are needed for the conditions that are calculated,
+   * and the B-spline coefficient images that are filtered with them.
+   */
+  std::vector<CoefficientImagePointer> ui_FA(ImageDimension), ui_FB(ImageDimension), ui_FC(ImageDimension),
+    ui_FD(ImageDimension), ui_FE(ImageDimension), ui_FF(ImageDimension), ui_FG(ImageDimension), ui_FH(ImageDimension),
+    ui_FI(ImageDimension);
+  std::vector<const std::vector<NeighborhoodType> *>  operatorSets;
+  std::vector<std::vector<CoefficientImagePointer> *> filteredImages;
+  if (this->m_CalculateOrthonormalityCondition || this->m_CalculatePropernessCondition)
+  {
+    operatorSets.push_back(&Operators_A);
+    filteredImages.push_back(&ui_FA);
+    operatorSets.push_back(&Operators_B);
+    filteredImages.push_back(&ui_FB);
+    if (ImageDimension == 3)
+    {
+      operatorSets.push_back(&Operators_C);
+      filteredImages.push_back(&ui_FC);
+    }
+  }
+  if (this->m_CalculateLinearityCondition)
   {
-    ui_FA[i] = this->FilterSeparable(inputImages[i], Operators_A);
-    ui_FB[i] = this->FilterSeparable(inputImages[i], Operators_B);
-    ui_FD[i] = this->FilterSeparable(inputImages[i], Operators_D);
-    ui_FE[i] = this->FilterSeparable(inputImages[i], Operators_E);
-    ui_FG[i] = this->FilterSeparable(inputImages[i], Operators_G);
+    operatorSets.push_back(&Operators_D);
+    filteredImages.push_back(&ui_FD);
+    operatorSets.push_back(&Operators_E);
+    filteredImages.push_back(&ui_FE);
+    operatorSets.push_back(&Operators_G);
+    filteredImages.push_back(&ui_FG);
     if (ImageDimension == 3)
     {
-      ui_FC[i] = this->FilterSeparable(inputImages[i], Operators_C);
-      ui_FF[i] = this->FilterSeparable(inputImages[i], Operators_F);
-      ui_FH[i] = this->FilterSeparable(inputImages[i], Operators_H);
-      ui_FI[i] = this->FilterSeparable(inputImages[i], Operators_I);
+      operatorSets.push_back(&Operators_F);
+      filteredImages.push_back(&ui_FF);
+      operatorSets.push_back(&Operators_H);
+      filteredImages.push_back(&ui_FH);
+      operatorSets.push_back(&Operators_I);
+      filteredImages.push_back(&ui_FI);
     }
   }
 
-  /** TASK 3:
-   * Create subparts and iterators.
+  /** TASK 2:
+   * Filter the B-spline coefficient images.
    *
    ************************************************************************* */
 
-  /** Create iterators over ui_F?. */
-  std::vector<CoefficientImageIteratorType> itA(ImageDimension), itB(ImageDimension), itC(ImageDimension),
-    itD(ImageDimension), itE(ImageDimension), itF(ImageDimension), itG(ImageDimension), itH(ImageDimension),
-    itI(ImageDimension);
-
-  /** Create iterators. */
+  /** Filter the inputImages with all selected operators at once. */
   for (unsigned int i = 0; i < ImageDimension; i++)
   {
-    /** Create iterators. */
-    itA[i] = CoefficientImageIteratorType(ui_FA[i], ui_FA[i]->GetLargestPossibleRegion());
-    itB[i] = CoefficientImageIteratorType(ui_FB[i], ui_FB[i]->GetLargestPossibleRegion());
-    itD[i] = CoefficientImageIteratorType(ui_FD[i], ui_FD[i]->GetLargestPossibleRegion());
-    itE[i] = CoefficientImageIteratorType(ui_FE[i], ui_FE[i]->GetLargestPossibleRegion());
-    itG[i] = CoefficientImageIteratorType(ui_FG[i], ui_FG[i]->GetLargestPossibleRegion());
-    if (ImageDimension == 3)
+    std::vector<CoefficientImagePointer> outputs;
+    this->FilterSeparable(inputImages[i], operatorSets, outputs);
+    for (unsigned int k = 0; k < operatorSets.size(); ++k)
     {
-      itC[i] = CoefficientImageIteratorType(ui_FC[i], ui_FC[i]->GetLargestPossibleRegion());
-      itF[i] = CoefficientImageIteratorType(ui_FF[i], ui_FF[i]->GetLargestPossibleRegion());
-      itH[i] = CoefficientImageIteratorType(ui_FH[i], ui_FH[i]->GetLargestPossibleRegion());
-      itI[i] = CoefficientImageIteratorType(ui_FI[i], ui_FI[i]->GetLargestPossibleRegion());
+      (*filteredImages[k])[i] = outputs[k];
     }
-    /** Reset iterators. */
-    itA[i].GoToBegin();
-    itB[i].GoToBegin();
-    itD[i].GoToBegin();
-    itE[i].GoToBegin();
-    itG[i].GoToBegin();
-    if (ImageDimension == 3)
+  }
+
+  /** Get direct access to the filtered images. */
+  const auto getBuffers = [](const std::vector<CoefficientImagePointer> & images) {
+    std::vector<const CoefficientPixelType *> buffers(images.size(), nullptr);
+    for (unsigned int i = 0; i < images.size(); i++)
     {
-      itC[i].GoToBegin();
-      itF[i].GoToBegin();
-      itH[i].GoToBegin();
-      itI[i].GoToBegin();
+      if (images[i].IsNotNull())
+      {
+        buffers[i] = images[i]->GetBufferPointer();
+      }
     }
-  }
+    return buffers;
+  };
+  const auto A = getBuffers(ui_FA);
+  const auto B = getBuffers(ui_FB);
+  const auto C = getBuffers(ui_FC);
+  const auto D = getBuffers(ui_FD);
+  const auto E = getBuffers(ui_FE);
+  const auto F = getBuffers(ui_FF);
+  const auto G = getBuffers(ui_FG);
+  const auto H = getBuffers(ui_FH);
+  const auto I = getBuffers(ui_FI);
+  const RigidityPixelType * rigidityCoefficients = this->m_RigidityCoefficientImage->GetBufferPointer();
+
+  /** Split the B-spline grid in slabs, one for each work unit. */
+  std::vector<SizeValueType> slabOffsets;
+  const ThreadIdType         numberOfWorkUnits =
+    this->ComputeSlabOffsets(this->m_RigidityCoefficientImage->GetBufferedRegion(), slabOffsets);
+
+  /** TASK 3:
+   * Create the orthonormality and properness subparts.
+   * The linearity subparts are twice the filtered images, so they are not stored.
+   *
+   ************************************************************************* */
 
   /** Create orthonormality and properness parts. */
   std::vector<std::vector<CoefficientImagePointer>> OCparts(ImageDimension);
   std::vector<std::vector<CoefficientImagePointer>> PCparts(ImageDimension);
+  std::vector<std::vector<CoefficientPixelType *>>  OCp(ImageDimension);
+  std::vector<std::vector<CoefficientPixelType *>>  PCp(ImageDimension);
   for (unsigned int i = 0; i < ImageDimension; i++)
   {
     OCparts[i].resize(ImageDimension);
     PCparts[i].resize(ImageDimension);
+    OCp[i].resize(ImageDimension, nullptr);
+    PCp[i].resize(ImageDimension, nullptr);
     for (unsigned int j = 0; j < ImageDimension; j++)
     {
-      OCparts[i][j] = CoefficientImageType::New();
-      OCparts[i][j]->SetRegions(inputImages[0]->GetLargestPossibleRegion());
-      OCparts[i][j]->Allocate();
-      PCparts[i][j] = CoefficientImageType::New();
-      PCparts[i][j]->SetRegions(inputImages[0]->GetLargestPossibleRegion());
-      PCparts[i][j]->Allocate();
-    }
-  }
-
-  /** Create linearity parts. */
-  unsigned int                                      NofLParts = 3 * ImageDimension - 3;
-  std::vector<std::vector<CoefficientImagePointer>> LCparts(ImageDimension);
-  for (unsigned int i = 0; i < ImageDimension; i++)
-  {
-    LCparts[i].resize(NofLParts);
-    for (unsigned int j = 0; j < NofLParts; j++)
-    {
-      LCparts[i][j] = CoefficientImageType::New();
-      LCparts[i][j]->SetRegions(inputImages[0]->GetLargestPossibleRegion());
-      LCparts[i][j]->Allocate();
-    }
-  }
-
-  /** Create iterators over all parts. */
-  std::vector<std::vector<CoefficientImageIteratorType>> itOCp(ImageDimension);
-  std::vector<std::vector<CoefficientImageIteratorType>> itPCp(ImageDimension);
-  std::vector<std::vector<CoefficientImageIteratorType>> itLCp(ImageDimension);
-  for (unsigned int i = 0; i < ImageDimension; i++)
-  {
-    itOCp[i].resize(ImageDimension);
-    itPCp[i].resize(ImageDimension);
-    itLCp[i].resize(NofLParts);
-    for (unsigned int j = 0; j < ImageDimension; j++)
-    {
-      itOCp[i][j] = CoefficientImageIteratorType(OCparts[i][j], OCparts[i][j]->GetLargestPossibleRegion());
-      itOCp[i][j].GoToBegin();
-      itPCp[i][j] = CoefficientImageIteratorType(PCparts[i][j], PCparts[i][j]->GetLargestPossibleRegion());
-      itPCp[i][j].GoToBegin();
-    }
-    for (unsigned int j = 0; j < NofLParts; j++)
-    {
-      itLCp[i][j] = CoefficientImageIteratorType(LCparts[i][j], LCparts[i][j]->GetLargestPossibleRegion());
-      itLCp[i][j].GoToBegin();
+      if (this->m_CalculateOrthonormalityCondition)
+      {
+        OCparts[i][j] = CoefficientImageType::New();
+        OCparts[i][j]->SetRegions(inputImages[0]->GetLargestPossibleRegion());
+        OCparts[i][j]->Allocate();
+        OCp[i][j] = OCparts[i][j]->GetBufferPointer();
+      }
+      if (this->m_CalculatePropernessCondition)
+      {
+        PCparts[i][j] = CoefficientImageType::New();
+        PCparts[i][j]->SetRegions(inputImages[0]->GetLargestPossibleRegion());
+        PCparts[i][j]->Allocate();
+        PCp[i][j] = PCparts[i][j]->GetBufferPointer();
+      }
     }
   }
 
-  /** TASK 4A:
-   * Do the calculation of the orthonormality subparts.
+  /** TASK 4:
+   * Do the calculation of the condition values and of the orthonormality
+   * and properness subparts, in a single pass over the B-spline grid,
+   * one slab per work unit.
    *
    ************************************************************************* */
 
-  /** Reset all iterators. */
-  it_RCI.GoToBegin();
-
-  if (this->m_CalculateOrthonormalityCondition)
-  {
-    ScalarType mu1_A, mu2_A, mu3_A, mu1_B, mu2_B, mu3_B, mu1_C, mu2_C, mu3_C;
-    ScalarType valueOC;
-    while (!itOCp[0][0].IsAtEnd())
-    {
-      /** Copy values: this way we avoid calling Get() so many times.
+  std::vector<MeasureType> orthonormalityValues(numberOfWorkUnits);
+  std::vector<MeasureType> propernessValues(numberOfWorkUnits);
+  std::vector<MeasureType> linearityValues(numberOfWorkUnits);
+
+  const auto computeValuesAndParts = [this,
+                                      &slabOffsets,
+                                      &A,
+                                      &B,
+                                      &C,
+                                      &D,
+                                      &E,
+                                      &F,
+                                      &G,
+                                      &H,
+                                      &I,
+                                      rigidityCoefficients,
+                                      &OCp,
+                                      &PCp,
+                                      &orthonormalityValues,
+                                      &propernessValues,
+                                      &linearityValues](ThreadIdType workUnit) {
+    MeasureType orthonormalityValue = NumericTraits<MeasureType>::Zero;
+    MeasureType propernessValue = NumericTraits<MeasureType>::Zero;
+    MeasureType linearityValue = NumericTraits<MeasureType>::Zero;
+    ScalarType  mu1_A, mu2_A, mu3_A, mu1_B, mu2_B, mu3_B, mu1_C, mu2_C, mu3_C;
+    ScalarType  valueOC, valuePC;
+    for (SizeValueType n = slabOffsets[workUnit]; n < slabOffsets[workUnit + 1]; ++n)
+    {
+      const ScalarType rigidityCoefficient = rigidityCoefficients[n];
+
+      /** Copy values: this way we avoid the indexing so many times.
        * It also improves code readability.
        */
-      mu1_A = itA[0].Get();
-      mu2_A = itA[1].Get();
-      mu1_B = itB[0].Get();
-      mu2_B = itB[1].Get();
-      if (ImageDimension == 3)
+      if (this->m_CalculateOrthonormalityCondition || this->m_CalculatePropernessCondition)
       {
-        mu3_A = itA[2].Get();
-        mu3_B = itB[2].Get();
-        mu1_C = itC[0].Get();
-        mu2_C = itC[1].Get();
-        mu3_C = itC[2].Get();
+        mu1_A = A[0][n];
+        mu2_A = A[1][n];
+        mu1_B = B[0][n];
+        mu2_B = B[1][n];
+        if (ImageDimension == 3)
+        {
+          mu3_A = A[2][n];
+          mu3_B = B[2][n];
+          mu1_C = C[0][n];
+          mu2_C = C[1][n];
+          mu3_C = C[2][n];
+        }
       }
-      if (ImageDimension == 2)
+
+      /** The orthonormality condition. */
+      if (this->m_CalculateOrthonormalityCondition && ImageDimension == 2)
       {
         /** Calculate the value of the orthonormality condition. */
-        this->m_OrthonormalityConditionValue +=
-          it_RCI.Get() * (std::pow(+(1.0 + mu1_A) * (1.0 + mu1_A) + mu2_A * mu2_A - 1.0, 2.0) +
-                          std::pow(+mu1_B * mu1_B + (1.0 + mu2_B) * (1.0 + mu2_B) - 1.0, 2.0) +
-                          std::pow(+(1.0 + mu1_A) * mu1_B + mu2_A * (1.0 + mu2_B), 2.0));
+        orthonormalityValue +=
+          rigidityCoefficient * (std::pow(+(1.0 + mu1_A) * (1.0 + mu1_A) + mu2_A * mu2_A - 1.0, 2.0) +
+                                 std::pow(+mu1_B * mu1_B + (1.0 + mu2_B) * (1.0 + mu2_B) - 1.0, 2.0) +
+                                 std::pow(+(1.0 + mu1_A) * mu1_B + mu2_A * (1.0 + mu2_B), 2.0));
         /** Calculate the derivative of the orthonormality condition. */
         /** mu1, part 1 */
         valueOC = +2.0 * (1.0 + mu1_A) * (1.0 + mu1_A) * (1.0 + mu1_A) + 2.0 * mu2_A * mu2_A * (1.0 + mu1_A) -
                   2.0 * (1.0 + mu1_A) + mu1_B * mu1_B * (1.0 + mu1_A) + mu2_A * (1.0 + mu2_B) * mu1_B;
-        itOCp[0][0].Set(2.0 * valueOC);
+        OCp[0][0][n] = 2.0 * valueOC;
         /** mu1, part2*/
         valueOC = +mu1_B * (1.0 + mu1_A) * (1.0 + mu1_A) + mu2_A * (1.0 + mu2_B) * (1.0 + mu1_A) +
                   2.0 * mu1_B * mu1_B * mu1_B + 2.0 * mu1_B * (1.0 + mu2_B) * (1.0 + mu2_B) - 2.0 * mu1_B;
-        itOCp[0][1].Set(2.0 * valueOC);
+        OCp[0][1][n] = 2.0 * valueOC;
         /** mu2, part 1 */
         valueOC = +2.0 * mu2_A * mu2_A * mu2_A + 2.0 * mu2_A * (1.0 + mu1_A) * (1.0 + mu1_A) - 2.0 * mu2_A +
                   mu2_A * (1.0 + mu2_B) * (1.0 + mu2_B) + mu1_B * (1.0 + mu1_A) * (1.0 + mu2_B);
-        itOCp[1][0].Set(2.0 * valueOC);
+        OCp[1][0][n] = 2.0 * valueOC;
         /** mu2, part2*/
         valueOC = +mu2_A * mu2_A * (1.0 + mu2_B) + mu1_B * (1.0 + mu1_A) * mu2_A +
                   2.0 * (1.0 + mu2_B) * (1.0 + mu2_B) * (1.0 + mu2_B) + 2.0 * mu1_B * mu1_B * (1.0 + mu2_B) -
                   2.0 * (1.0 + mu2_B);
-        itOCp[1][1].Set(2.0 * valueOC);
+        OCp[1][1][n] = 2.0 * valueOC;
       } // end if dim == 2
-      else if (ImageDimension == 3)
+      else if (this->m_CalculateOrthonormalityCondition && ImageDimension == 3)
       {
         /** Calculate the value of the orthonormality condition. */
-        this->m_OrthonormalityConditionValue +=
-          it_RCI.Get() * (std::pow(+(1.0 + mu1_A) * (1.0 + mu1_A) + mu2_A * mu2_A + mu3_A * mu3_A - 1.0, 2.0) +
-                          std::pow(+(1.0 + mu1_A) * mu1_B + mu2_A * (1.0 + mu2_B) + mu3_A * mu3_B, 2.0) +
-                          std::pow(+(1.0 + mu1_A) * mu1_C + mu2_A * mu2_C + mu3_A * (1.0 + mu3_C), 2.0) +
-                          std::pow(+mu1_B * mu1_B + (1.0 + mu2_B) * (1.0 + mu2_B) + mu3_B * mu3_B - 1.0, 2.0) +
-                          std::pow(+mu1_B * mu1_C + (1.0 + mu2_B) * mu2_C + mu3_B * (1.0 + mu3_C), 2.0) +
-                          std::pow(+mu1_C * mu1_C + mu2_C * mu2_C + (1.0 + mu3_C) * (1.0 + mu3_C) - 1.0, 2.0));
+        orthonormalityValue +=
+          rigidityCoefficient * (std::pow(+(1.0 + mu1_A) * (1.0 + mu1_A) + mu2_A * mu2_A + mu3_A * mu3_A - 1.0, 2.0) +
+                                 std::pow(+(1.0 + mu1_A) * mu1_B + mu2_A * (1.0 + mu2_B) + mu3_A * mu3_B, 2.0) +
+                                 std::pow(+(1.0 + mu1_A) * mu1_C + mu2_A * mu2_C + mu3_A * (1.0 + mu3_C), 2.0) +
+                                 std::pow(+mu1_B * mu1_B + (1.0 + mu2_B) * (1.0 + mu2_B) + mu3_B * mu3_B - 1.0, 2.0) +
+                                 std::pow(+mu1_B * mu1_C + (1.0 + mu2_B) * mu2_C + mu3_B * (1.0 + mu3_C), 2.0) +
+                                 std::pow(+mu1_C * mu1_C + mu2_C * mu2_C + (1.0 + mu3_C) * (1.0 + mu3_C) - 1.0, 2.0));
         /** Calculate the derivative of the orthonormality condition. */
         /** mu1, part 1 */
         valueOC = +2.0 * (1.0 + mu1_A) * (1.0 + mu1_A) * (1.0 + mu1_A) + 2.0 * mu2_A * mu2_A * (1.0 + mu1_A) +
                   2.0 * (1.0 + mu1_A) * mu3_A * mu3_A - 2.0 * (1.0 + mu1_A) + mu1_B * mu1_B * (1.0 + mu1_A) +
                   mu2_A * (1.0 + mu2_B) * mu1_B + mu1_B * mu3_A * mu3_B + (1.0 + mu1_A) * mu1_C * mu1_C +
                   mu1_C * mu2_A * mu2_C + mu1_C * mu3_A * (1.0 + mu3_C);
-        itOCp[0][0].Set(2.0 * valueOC);
+        OCp[0][0][n] = 2.0 * valueOC;
         /** mu1, part2 */
         valueOC = +(1.0 + mu1_A) * (1.0 + mu1_A) * mu1_B + (1.0 + mu1_A) * mu2_A * mu3_B +
                   (1.0 + mu1_A) * mu3_A * mu3_B + mu1_B * mu1_B * mu1_B + mu1_B * (1.0 + mu2_B) * (1.0 + mu2_B) +
                   mu1_B * mu3_B * mu3_B - mu1_B + mu1_B * mu1_C * mu1_C + mu1_C * (1.0 + mu2_B) * mu2_C +
                   mu1_C * mu3_B * (1.0 + mu3_C);
-        itOCp[0][1].Set(2.0 * valueOC);
+        OCp[0][1][n] = 2.0 * valueOC;
         /** mu1, part3 */
         valueOC = +(1.0 + mu1_A) * (1.0 + mu1_A) * mu1_C + (1.0 + mu1_A) * mu2_A * mu2_C +
                   (1.0 + mu1_A) * mu3_A * (1.0 + mu3_C) + mu1_B * mu1_B * mu1_C + mu1_B * (1.0 + mu2_B) * mu2_C +
                   mu1_B * mu3_B * (1.0 + mu3_C) + 2.0 * mu1_C * mu1_C * mu1_C + 2.0 * mu1_C * mu2_C * mu2_C +
                   2.0 * mu1_C * (1.0 + mu3_C) * (1.0 + mu3_C) - 2.0 * mu1_C;
-        itOCp[0][2].Set(2.0 * valueOC);
+        OCp[0][2][n] = 2.0 * valueOC;
         /** mu2, part 1 */
         valueOC = +2.0 * mu2_A * mu2_A * mu2_A + 2.0 * mu2_A * (1.0 + mu1_A) * (1.0 + mu1_A) - 2.0 * mu2_A +
                   2.0 * mu2_A * mu3_A * mu3_A + mu2_A * (1.0 + mu2_B) * (1.0 + mu2_B) +
                   mu1_B * (1.0 + mu1_A) * (1.0 + mu2_B) + (1.0 + mu2_B) * mu3_A * mu3_B + mu2_A * mu2_C * mu2_C +
                   (1.0 + mu1_A) * mu1_C * mu2_C + mu2_C * mu3_A * (1.0 + mu3_C);
-        itOCp[1][0].Set(2.0 * valueOC);
+        OCp[1][0][n] = 2.0 * valueOC;
         /** mu2, part2 */
         valueOC = +mu2_A * mu2_A * (1.0 + mu2_B) + mu1_B * (1.0 + mu1_A) * mu2_A + mu2_A * mu3_A * mu3_B +
                   2.0 * (1.0 + mu2_B) * (1.0 + mu2_B) * (1.0 + mu2_B) + 2.0 * mu1_B * mu1_B * (1.0 + mu2_B) -
                   2.0 * (1.0 + mu2_B) + 2.0 * (1.0 + mu2_B) * mu3_B * mu3_B + (1.0 + mu2_B) * mu2_C * mu2_C +
                   mu1_B * mu1_C * mu2_C + mu2_C * mu3_B * (1.0 + mu3_C);
-        itOCp[1][1].Set(2.0 * valueOC);
+        OCp[1][1][n] = 2.0 * valueOC;
         /** mu2, part 3 */
         valueOC = +mu2_A * mu2_A * mu2_C + (1.0 + mu1_A) * mu1_C * mu2_A + mu2_A * mu3_A * (1.0 + mu3_C) +
                   (1.0 + mu2_B) * (1.0 + mu2_B) * mu2_C + mu1_B * mu1_C * mu2_B +
                   (1.0 + mu2_B) * mu3_B * (1.0 + mu3_C) + 2.0 * mu2_C * mu2_C * mu2_C + 2.0 * mu1_C * mu1_C * mu2_C +
                   2.0 * mu2_C * (1.0 + mu3_C) * (1.0 + mu3_C) - 2.0 * mu2_C;
-        itOCp[1][2].Set(2.0 * valueOC);
+        OCp[1][2][n] = 2.0 * valueOC;
         /** mu3, part 1 */
         valueOC = +2.0 * mu3_A * mu3_A * mu3_A + 2.0 * mu3_A * (1.0 + mu1_A) * (1.0 + mu1_A) - 2.0 * mu3_A +
                   2.0 * mu2_A * mu2_A * mu3_A + mu3_A * mu3_B * mu3_B + mu1_B * (1.0 + mu1_A) * mu3_B +
                   (1.0 + mu2_B) * mu2_A * mu3_B + mu3_A * (1.0 + mu3_C) * (1.0 + mu3_C) +
                   (1.0 + mu1_A) * mu1_C * (1.0 + mu3_C) + mu2_C * mu2_A * (1.0 + mu3_C);
-        itOCp[2][0].Set(2.0 * valueOC);
+        OCp[2][0][n] = 2.0 * valueOC;
         /** mu3, part2 */
         valueOC = +mu3_A * mu3_A * mu3_B + mu1_B * (1.0 + mu1_A) * mu3_A + mu2_A * mu3_A * (1.0 + mu2_B) +
                   2.0 * mu3_B * mu3_B * mu3_B + 2.0 * mu1_B * mu1_B * mu3_B - 2.0 * mu3_B +
                   2.0 * (1.0 + mu2_B) * (1.0 + mu2_B) * mu3_B + mu3_B * (1.0 + mu3_C) * (1.0 + mu3_C) +
                   mu1_B * mu1_C * (1.0 + mu3_C) + mu2_C * (1.0 + mu2_B) * (1.0 + mu3_C);
-        itOCp[2][1].Set(2.0 * valueOC);
+        OCp[2][1][n] = 2.0 * valueOC;
         /** mu3, part 3 */
         valueOC = +mu3_A * mu3_A * (1.0 + mu3_C) + (1.0 + mu1_A) * mu1_C * mu3_A + mu2_A * mu3_A * mu2_C +
                   mu3_B * mu3_B * (1.0 + mu3_C) + mu1_B * mu1_C * mu3_B + (1.0 + mu2_B) * mu3_B * mu2_C +
                   2.0 * (1.0 + mu3_C) * (1.0 + mu3_C) * (1.0 + mu3_C) + 2.0 * mu1_C * mu1_C * (1.0 + mu3_C) +
                   2.0 * mu2_C * mu2_C * (1.0 + mu3_C) - 2.0 * (1.0 + mu3_C);
-        itOCp[2][2].Set(2.0 * valueOC);
+        OCp[2][2][n] = 2.0 * valueOC;
       } // end if dim == 3
 
-      /** Increase all iterators. */
-      for (unsigned int i = 0; i < ImageDimension; i++)
-      {
-        ++itA[i];
-        ++itB[i];
-        if (ImageDimension == 3)
-        {
-          ++itC[i];
-        }
-        for (unsigned int j = 0; j < ImageDimension; j++)
-        {
-          ++itOCp[i][j];
-        }
-      }
-      ++it_RCI;
-
-    } // end while
-  }   // end if do orthonormality
-
-  /** TASK 4B:
-   * Do the calculation of the properness parts.
-   *
-   ************************************************************************* */
-
-  /** Reset all iterators. */
-  for (unsigned int i = 0; i < ImageDimension; i++)
-  {
-    itA[i].GoToBegin();
-    itB[i].GoToBegin();
-    if (ImageDimension == 3)
-    {
-      itC[i].GoToBegin();
-    }
-  }
-  it_RCI.GoToBegin();
-
-  if (this->m_CalculatePropernessCondition)
-  {
-    ScalarType mu1_A, mu2_A, mu3_A, mu1_B, mu2_B, mu3_B, mu1_C, mu2_C, mu3_C;
-    ScalarType valuePC;
-    while (!itPCp[0][0].IsAtEnd())
-    {
-      /** Copy values: this way we avoid calling Get() so many times.
-       * It also improves code readability.
-       */
-      mu1_A = itA[0].Get();
-      mu2_A = itA[1].Get();
-      mu1_B = itB[0].Get();
-      mu2_B = itB[1].Get();
-      if (ImageDimension == 3)
-      {
-        mu3_A = itA[2].Get();
-        mu3_B = itB[2].Get();
-        mu1_C = itC[0].Get();
-        mu2_C = itC[1].Get();
-        mu3_C = itC[2].Get();
-      }
-      if (ImageDimension == 2)
+      /** The properness condition. */
+      if (this->m_CalculatePropernessCondition && ImageDimension == 2)
       {
         /** Calculate the value of the properness condition. */
-        this->m_PropernessConditionValue +=
-          it_RCI.Get() * (std::pow(+(1.0 + mu1_A) * (1.0 + mu2_B) - mu2_A * mu1_B - 1.0, 2.0));
+        propernessValue += rigidityCoefficient * (std::pow(+(1.0 + mu1_A) * (1.0 + mu2_B) - mu2_A * mu1_B - 1.0, 2.0));
         /** Calculate the derivative of the properness condition. */
         /** mu1, part 1 */
         valuePC = +(1.0 + mu2_B) * (1.0 + mu2_B) * (1.0 + mu1_A) - mu2_A * (1.0 + mu2_B) * mu1_B - (1.0 + mu2_B);
-        itPCp[0][0].Set(2.0 * valuePC);
+        PCp[0][0][n] = 2.0 * valuePC;
         /** mu1, part 2 */
         valuePC = +mu2_A + mu2_A * mu2_A * mu1_B - mu2_A * (1.0 + mu2_B) * (1.0 + mu1_A);
-        itPCp[0][1].Set(2.0 * valuePC);
+        PCp[0][1][n] = 2.0 * valuePC;
         /** mu2, part 1 */
         valuePC = +mu1_B * mu1_B * mu2_A - mu1_B * (1.0 + mu1_A) * (1.0 + mu2_B) + mu1_B;
-        itPCp[1][0].Set(2.0 * valuePC);
+        PCp[1][0][n] = 2.0 * valuePC;
         /** mu2, part 2 */
         valuePC = -(1.0 + mu1_A) + (1.0 + mu1_A) * (1.0 + mu1_A) * (1.0 + mu2_B) - mu1_B * (1.0 + mu1_A) * mu2_A;
-        itPCp[1][1].Set(2.0 * valuePC);
+        PCp[1][1][n] = 2.0 * valuePC;
       } // end if dim == 2
-      else if (ImageDimension == 3)
+      else if (this->m_CalculatePropernessCondition && ImageDimension == 3)
       {
         /** Calculate the value of the properness condition. */
-        this->m_PropernessConditionValue +=
-          it_RCI.Get() * (std::pow(-mu1_C * (1.0 + mu2_B) * mu3_A + mu1_B * mu2_C * mu3_A + mu1_C * mu2_A * mu3_B -
-                                     (1.0 + mu1_A) * mu2_C * mu3_B - mu1_B * mu2_A * (1.0 + mu3_C) +
-                                     (1.0 + mu1_A) * (1.0 + mu2_B) * (1.0 + mu3_C) - 1.0,
-                                   2.0));
+        propernessValue +=
+          rigidityCoefficient * (std::pow(-mu1_C * (1.0 + mu2_B) * mu3_A + mu1_B * mu2_C * mu3_A +
+                                            mu1_C * mu2_A * mu3_B - (1.0 + mu1_A) * mu2_C * mu3_B -
+                                            mu1_B * mu2_A * (1.0 + mu3_C) +
+                                            (1.0 + mu1_A) * (1.0 + mu2_B) * (1.0 + mu3_C) - 1.0,
+                                          2.0));
         /** Calculate the derivative of the properness condition. */
         /** mu1, part 1 */
         valuePC = +(1.0 + mu1_A) * mu2_C * mu2_C * mu3_B * mu3_B +
@@ -1345,7 +1224,7 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
                   mu1_B * mu2_A * mu2_C * mu3_B * (1.0 + mu3_C) -
                   2.0 * (1.0 + mu1_A) * (1.0 + mu2_B) * mu2_C * mu3_B * (1.0 + mu3_C) + mu2_C * mu3_B -
                   mu1_B * mu2_A * (1.0 + mu2_B) * (1.0 + mu3_C) * (1.0 + mu3_C) - (1.0 + mu2_B) * (1.0 + mu3_C);
-        itPCp[0][0].Set(2.0 * valuePC);
+        PCp[0][0][n] = 2.0 * valuePC;
         /** mu1, part 2 */
         valuePC = +mu1_B * mu2_C * mu2_C * mu3_A * mu3_A + mu1_B * mu2_A * mu2_A * (1.0 + mu3_C) * (1.0 + mu3_C) -
                   mu1_C * (1.0 + mu2_B) * mu2_C * mu3_A * mu3_A +
@@ -1355,7 +1234,7 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
                   mu1_C * mu2_A * mu2_A * mu3_B * (1.0 + mu3_C) +
                   (1.0 + mu1_A) * mu2_A * mu2_C * mu3_B * (1.0 + mu3_C) -
                   (1.0 + mu1_A) * mu2_A * (1.0 + mu2_B) * (1.0 + mu3_C) * (1.0 + mu3_C) + mu2_A * (1.0 + mu3_C);
-        itPCp[0][1].Set(2.0 * valuePC);
+        PCp[0][1][n] = 2.0 * valuePC;
         /** mu1, part 3 */
         valuePC = +mu1_C * (1.0 + mu2_B) * (1.0 + mu2_B) * mu3_A * mu3_A + mu1_C * mu2_A * mu2_A * mu3_B * mu3_B -
                   mu1_B * (1.0 + mu2_B) * mu2_C * mu3_A * mu3_A - 2.0 * mu1_C * mu2_A * (1.0 + mu2_B) * mu3_A * mu3_B +
@@ -1365,7 +1244,7 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
                   mu1_B * mu2_A * mu2_C * mu3_A * mu3_B - (1.0 + mu1_A) * mu2_A * mu2_C * mu3_B * mu3_B -
                   mu1_B * mu2_A * mu2_A * mu3_B * (1.0 + mu3_C) +
                   (1.0 + mu1_A) * mu2_A * (1.0 + mu2_B) * mu3_B * (1.0 + mu3_C) - mu2_A * mu3_B;
-        itPCp[0][2].Set(2.0 * valuePC);
+        PCp[0][2][n] = 2.0 * valuePC;
         /** mu2, part 1 */
         valuePC = +mu1_C * mu1_C * mu2_A * mu3_B * mu3_B + mu1_B * mu1_B * mu2_A * (1.0 + mu3_C) * (1.0 + mu3_C) -
                   mu1_C * mu1_C * (1.0 + mu2_B) * mu3_A * mu3_B +
@@ -1375,7 +1254,7 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
                   (1.0 + mu1_A) * mu1_C * (1.0 + mu2_B) * mu3_B * (1.0 + mu3_C) - mu1_C * mu3_B +
                   (1.0 + mu1_A) * mu1_B * mu2_C * mu3_B * (1.0 + mu3_C) -
                   (1.0 + mu1_A) * mu1_B * (1.0 + mu2_B) * (1.0 + mu3_C) * (1.0 + mu3_C) + mu1_B * (1.0 + mu3_C);
-        itPCp[1][0].Set(2.0 * valuePC);
+        PCp[1][0][n] = 2.0 * valuePC;
         /** mu2, part 2 */
         valuePC = +mu1_C * mu1_C * (1.0 + mu2_B) * mu3_A * mu3_A +
                   (1.0 + mu1_A) * (1.0 + mu1_A) * (1.0 + mu2_B) * (1.0 + mu3_C) * (1.0 + mu3_C) -
@@ -1386,7 +1265,7 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
                   (1.0 + mu1_A) * mu1_C * mu2_A * mu3_B * (1.0 + mu3_C) -
                   (1.0 + mu1_A) * (1.0 + mu1_A) * mu2_C * mu3_B * (1.0 + mu3_C) -
                   (1.0 + mu1_A) * mu1_B * mu2_A * (1.0 + mu3_C) * (1.0 + mu3_C) - (1.0 + mu1_A) * (1.0 + mu3_C);
-        itPCp[1][1].Set(2.0 * valuePC);
+        PCp[1][1][n] = 2.0 * valuePC;
         /** mu2, part 3 */
         valuePC = +mu1_B * mu1_B * mu2_C * mu3_A * mu3_A + (1.0 + mu1_A) * (1.0 + mu1_A) * mu2_C * mu3_B * mu3_B -
                   mu1_B * mu1_C * (1.0 + mu2_B) * mu3_A * mu3_A +
@@ -1396,7 +1275,7 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
                   (1.0 + mu1_A) * mu1_C * mu2_A * mu3_B * mu3_B +
                   (1.0 + mu1_A) * mu1_B * mu2_A * mu3_B * (1.0 + mu3_C) -
                   (1.0 + mu1_A) * (1.0 + mu1_A) * (1.0 + mu2_B) * mu3_B * (1.0 + mu3_C) + (1.0 + mu1_A) * mu3_B;
-        itPCp[1][2].Set(2.0 * valuePC);
+        PCp[1][2][n] = 2.0 * valuePC;
         /** mu3, part 1 */
         valuePC = +mu1_C * mu1_C * (1.0 + mu2_B) * (1.0 + mu2_B) * mu3_A + mu1_B * mu1_B * mu2_C * mu2_C * mu3_A -
                   2.0 * mu1_B * mu1_C * (1.0 + mu2_B) * mu2_C * mu3_A - mu1_C * mu1_C * mu2_A * (1.0 + mu2_B) * mu3_B +
@@ -1406,7 +1285,7 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
                   mu1_B * mu1_C * mu2_A * mu2_C * mu3_B - (1.0 + mu1_A) * mu1_B * mu2_C * mu2_C * mu3_B -
                   mu1_B * mu1_B * mu2_A * mu2_C * (1.0 + mu3_C) +
                   (1.0 + mu1_A) * mu1_B * (1.0 + mu2_B) * mu2_C * (1.0 + mu3_C) + mu1_B * mu2_C;
-        itPCp[2][0].Set(2.0 * valuePC);
+        PCp[2][0][n] = 2.0 * valuePC;
         /** mu3, part 2 */
         valuePC = +mu1_C * mu1_C * mu2_A * mu2_A * mu3_B + (1.0 + mu1_A) * (1.0 + mu1_A) * mu2_C * mu2_C * mu3_B -
                   mu1_C * mu1_C * mu2_A * (1.0 + mu2_B) * mu3_A +
@@ -1416,7 +1295,7 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
                   (1.0 + mu1_A) * mu1_C * mu2_A * (1.0 + mu2_B) * (1.0 + mu3_C) - mu1_C * mu2_A +
                   (1.0 + mu1_A) * mu1_B * mu2_A * mu2_C * (1.0 + mu3_C) -
                   (1.0 + mu1_A) * (1.0 + mu1_A) * (1.0 + mu2_B) * mu2_C * (1.0 + mu3_C) + (1.0 + mu1_A) * mu2_C;
-        itPCp[2][1].Set(2.0 * valuePC);
+        PCp[2][1][n] = 2.0 * valuePC;
         /** mu3, part 3 */
         valuePC = +mu1_B * mu1_B * mu2_A * mu2_A * (1.0 + mu3_C) +
                   (1.0 + mu1_A) * (1.0 + mu1_A) * (1.0 + mu2_B) * (1.0 + mu2_B) * (1.0 + mu3_C) +
@@ -1428,106 +1307,36 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
                   (1.0 + mu1_A) * (1.0 + mu1_A) * (1.0 + mu2_B) * mu2_C * mu3_B -
                   2.0 * (1.0 + mu1_A) * mu1_B * mu2_A * (1.0 + mu2_B) * (1.0 + mu3_C) + mu1_B * mu2_A -
                   (1.0 + mu1_A) * (1.0 + mu2_B);
-        itPCp[2][2].Set(2.0 * valuePC);
+        PCp[2][2][n] = 2.0 * valuePC;
       } // end if dim == 3
 
-      /** Increase all iterators. */
-      for (unsigned int i = 0; i < ImageDimension; i++)
+      /** Calculate the value of the linearity condition. */
+      if (this->m_CalculateLinearityCondition)
       {
-        ++itA[i];
-        ++itB[i];
-        if (ImageDimension == 3)
-        {
-          ++itC[i];
-        }
-        for (unsigned int j = 0; j < ImageDimension; j++)
+        for (unsigned int i = 0; i < ImageDimension; i++)
         {
-          ++itPCp[i][j];
+          linearityValue += rigidityCoefficient * (+D[i][n] * D[i][n] + E[i][n] * E[i][n] + G[i][n] * G[i][n]);
+          if (ImageDimension == 3)
+          {
+            linearityValue += rigidityCoefficient * (+F[i][n] * F[i][n] + H[i][n] * H[i][n] + I[i][n] * I[i][n]);
+          }
         }
       }
-      ++it_RCI;
-
-    } // end while
-  }   // end if do properness
-
-  /** TASK 4C:
-   * Do the calculation of the linearity parts.
-   *
-   ************************************************************************* */
+    } // end for
 
-  /** Reset all iterators. */
-  it_RCI.GoToBegin();
+    orthonormalityValues[workUnit] = orthonormalityValue;
+    propernessValues[workUnit] = propernessValue;
+    linearityValues[workUnit] = linearityValue;
+  };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, computeValuesAndParts);
 
-  if (this->m_CalculateLinearityCondition)
+  /** Add the contributions of the work units. */
+  for (ThreadIdType workUnit = 0; workUnit < numberOfWorkUnits; ++workUnit)
   {
-    while (!itLCp[0][0].IsAtEnd())
-    {
-      /** Linearity condition part. */
-      for (unsigned int i = 0; i < ImageDimension; i++)
-      {
-        /** Calculate the value of the linearity condition. */
-        this->m_LinearityConditionValue +=
-          it_RCI.Get() * (+itD[i].Get() * itD[i].Get() + itE[i].Get() * itE[i].Get() + itG[i].Get() * itG[i].Get());
-        if (ImageDimension == 3)
-        {
-          this->m_LinearityConditionValue +=
-            it_RCI.Get() * (+itF[i].Get() * itF[i].Get() + itH[i].Get() * itH[i].Get() + itI[i].Get() * itI[i].Get());
-        }
-      } // end loop over i
-
-      /** Calculate the derivative of the linearity condition. */
-      if (ImageDimension == 2)
-      {
-        itLCp[0][0].Set(2.0 * itD[0].Get());
-        itLCp[0][1].Set(2.0 * itE[0].Get());
-        itLCp[0][2].Set(2.0 * itG[0].Get());
-        itLCp[1][0].Set(2.0 * itD[1].Get());
-        itLCp[1][1].Set(2.0 * itE[1].Get());
-        itLCp[1][2].Set(2.0 * itG[1].Get());
-      } // end if dim == 2
-      else if (ImageDimension == 3)
-      {
-        itLCp[0][0].Set(2.0 * itD[0].Get());
-        itLCp[0][1].Set(2.0 * itE[0].Get());
-        itLCp[0][2].Set(2.0 * itG[0].Get());
-        itLCp[0][3].Set(2.0 * itF[0].Get());
-        itLCp[0][4].Set(2.0 * itH[0].Get());
-        itLCp[0][5].Set(2.0 * itI[0].Get());
-        itLCp[1][0].Set(2.0 * itD[1].Get());
-        itLCp[1][1].Set(2.0 * itE[1].Get());
-        itLCp[1][2].Set(2.0 * itG[1].Get());
-        itLCp[1][3].Set(2.0 * itF[1].Get());
-        itLCp[1][4].Set(2.0 * itH[1].Get());
-        itLCp[1][5].Set(2.0 * itI[1].Get());
-        itLCp[2][0].Set(2.0 * itD[2].Get());
-        itLCp[2][1].Set(2.0 * itE[2].Get());
-        itLCp[2][2].Set(2.0 * itG[2].Get());
-        itLCp[2][3].Set(2.0 * itF[2].Get());
-        itLCp[2][4].Set(2.0 * itH[2].Get());
-        itLCp[2][5].Set(2.0 * itI[2].Get());
-      } // end if dim == 3
-
-      /** Increase all iterators. */
-      for (unsigned int i = 0; i < ImageDimension; i++)
-      {
-        ++itD[i];
-        ++itE[i];
-        ++itG[i];
-        if (ImageDimension == 3)
-        {
-          ++itF[i];
-          ++itH[i];
-          ++itI[i];
-        }
-        for (unsigned int j = 0; j < NofLParts; j++)
-        {
-          ++itLCp[i][j];
-        }
-      }
-      ++it_RCI;
-
-    } // end while
-  }   // end if do linearity
+    this->m_OrthonormalityConditionValue += orthonormalityValues[workUnit];
+    this->m_PropernessConditionValue += propernessValues[workUnit];
+    this->m_LinearityConditionValue += linearityValues[workUnit];
+  }
 
   /** TASK 5:
    * Do the actual calculation of the rigidity penalty term value.
@@ -1563,73 +1372,10 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
   value = this->m_RigidityPenaltyTermValue;
 
   /** TASK 6:
-   * Create filtered versions of the subparts.
-   * Create all necessary iterators and operators.
+   * Create the ND operators.
+   *
    ************************************************************************* */
 
-  /** Create filtered orthonormality, properness and linearity parts. */
-  std::vector<CoefficientImagePointer> OCpartsF(ImageDimension);
-  std::vector<CoefficientImagePointer> PCpartsF(ImageDimension);
-  std::vector<CoefficientImagePointer> LCpartsF(ImageDimension);
-  for (unsigned int i = 0; i < ImageDimension; i++)
-  {
-    OCpartsF[i] = CoefficientImageType::New();
-    OCpartsF[i]->SetRegions(inputImages[0]->GetLargestPossibleRegion());
-    OCpartsF[i]->Allocate();
-    PCpartsF[i] = CoefficientImageType::New();
-    PCpartsF[i]->SetRegions(inputImages[0]->GetLargestPossibleRegion());
-    PCpartsF[i]->Allocate();
-    LCpartsF[i] = CoefficientImageType::New();
-    LCpartsF[i]->SetRegions(inputImages[0]->GetLargestPossibleRegion());
-    LCpartsF[i]->Allocate();
-  }
-
-  /** Create neighborhood iterators over the subparts. */
-  std::vector<std::vector<NeighborhoodIteratorType>> nitOCp(ImageDimension);
-  std::vector<std::vector<NeighborhoodIteratorType>> nitPCp(ImageDimension);
-  std::vector<std::vector<NeighborhoodIteratorType>> nitLCp(ImageDimension);
-  RadiusType                                         radius;
-  radius.Fill(1);
-  for (unsigned int i = 0; i < ImageDimension; i++)
-  {
-    nitOCp[i].resize(ImageDimension);
-    nitPCp[i].resize(ImageDimension);
-    nitLCp[i].resize(NofLParts);
-    for (unsigned int j = 0; j < ImageDimension; j++)
-    {
-      nitOCp[i][j] = NeighborhoodIteratorType(radius, OCparts[i][j], OCparts[i][j]->GetLargestPossibleRegion());
-      nitOCp[i][j].GoToBegin();
-      nitPCp[i][j] = NeighborhoodIteratorType(radius, PCparts[i][j], PCparts[i][j]->GetLargestPossibleRegion());
-      nitPCp[i][j].GoToBegin();
-    }
-    for (unsigned int j = 0; j < NofLParts; j++)
-    {
-      nitLCp[i][j] = NeighborhoodIteratorType(radius, LCparts[i][j], LCparts[i][j]->GetLargestPossibleRegion());
-      nitLCp[i][j].GoToBegin();
-    }
-  }
-
-  /** Create iterators over the filtered parts. */
-  std::vector<CoefficientImageIteratorType> itOCpf(ImageDimension);
-  std::vector<CoefficientImageIteratorType> itPCpf(ImageDimension);
-  std::vector<CoefficientImageIteratorType> itLCpf(ImageDimension);
-  for (unsigned int i = 0; i < ImageDimension; i++)
-  {
-    itOCpf[i] = CoefficientImageIteratorType(OCpartsF[i], OCpartsF[i]->GetLargestPossibleRegion());
-    itOCpf[i].GoToBegin();
-    itPCpf[i] = CoefficientImageIteratorType(PCpartsF[i], PCpartsF[i]->GetLargestPossibleRegion());
-    itPCpf[i].GoToBegin();
-    itLCpf[i] = CoefficientImageIteratorType(LCpartsF[i], LCpartsF[i]->GetLargestPossibleRegion());
-    itLCpf[i].GoToBegin();
-  }
-
-  /** Create a neigborhood iterator over the rigidity image. */
-  NeighborhoodIteratorType nit_RCI(
-    radius, this->m_RigidityCoefficientImage, this->m_RigidityCoefficientImage->GetLargestPossibleRegion());
-  nit_RCI.GoToBegin();
-  unsigned int neighborhoodSize = nit_RCI.Size();
-
-  /** Create ND operators. */
   NeighborhoodType Operator_A, Operator_B, Operator_C, Operator_D, Operator_E, Operator_F, Operator_G, Operator_H,
     Operator_I;
   this->CreateNDOperator(Operator_A, "FA", spacing);
@@ -1651,262 +1397,190 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
       this->CreateNDOperator(Operator_I, "FI", spacing);
     }
   }
+  const unsigned int neighborhoodSize = Operator_A.Size();
 
-  /** TASK 7A:
-   * Calculate the filtered versions of the orthonormality subparts.
-   * These are F_A * {subpart_0} + F_B * {subpart_1},
-   * and (for 3D) + F_C * {subpart_2}, for all dimensions.
+  /** TASK 7:
+   * Calculate the filtered versions of the subparts, and add them
+   * to create the final derivative, one slab per work unit.
+   * The filtered orthonormality and properness subparts are
+   * F_A * {subpart_0} + F_B * {subpart_1}, and (for 3D) + F_C * {subpart_2}.
+   * The filtered linearity subparts are sum_i F_{D,E,G,F,H,I} * {subpart_i}.
+   * The filtered subparts are not stored, but directly added to the derivative.
+   *
    ************************************************************************* */
 
-  if (this->m_CalculateOrthonormalityCondition)
-  {
-    while (!itOCpf[0].IsAtEnd())
-    {
-      /** Create and reset tmp with zeros. */
-      std::vector<double> tmp(ImageDimension, 0.0);
-
-      /** Loop over all dimensions. */
-      for (unsigned int i = 0; i < ImageDimension; i++)
+  // NOTE: unlike the values, for the derivatives weight * derivative is returned.
+  const SizeValueType      numberOfPixels = this->m_RigidityCoefficientImage->GetBufferedRegion().GetNumberOfPixels();
+  const auto               gridSize = this->m_RigidityCoefficientImage->GetBufferedRegion().GetSize();
+  const double             rigidityCoefficientSumSqr = rigidityCoefficientSum * rigidityCoefficientSum;
+  std::vector<MeasureType> gradMagLCValues(numberOfWorkUnits);
+  std::vector<MeasureType> gradMagOCValues(numberOfWorkUnits);
+  std::vector<MeasureType> gradMagPCValues(numberOfWorkUnits);
+
+  const auto computeDerivative = [this,
+                                  &slabOffsets,
+                                  &D,
+                                  &E,
+                                  &F,
+                                  &G,
+                                  &H,
+                                  &I,
+                                  rigidityCoefficients,
+                                  &OCp,
+                                  &PCp,
+                                  &Operator_A,
+                                  &Operator_B,
+                                  &Operator_C,
+                                  &Operator_D,
+                                  &Operator_E,
+                                  &Operator_F,
+                                  &Operator_G,
+                                  &Operator_H,
+                                  &Operator_I,
+                                  neighborhoodSize,
+                                  numberOfPixels,
+                                  gridSize,
+                                  rigidityCoefficientSum,
+                                  rigidityCoefficientSumSqr,
+                                  &derivative,
+                                  &gradMagLCValues,
+                                  &gradMagOCValues,
+                                  &gradMagPCValues](ThreadIdType workUnit) {
+    MeasureType                gradMagLC = NumericTraits<MeasureType>::Zero;
+    MeasureType                gradMagOC = NumericTraits<MeasureType>::Zero;
+    MeasureType                gradMagPC = NumericTraits<MeasureType>::Zero;
+    std::vector<SizeValueType> neighbors(neighborhoodSize);
+    for (SizeValueType n = slabOffsets[workUnit]; n < slabOffsets[workUnit + 1]; ++n)
+    {
+      /** Compute the positions of the neighbors, in the same order as the
+       * elements of the operators. Outside the grid the nearest position
+       * is taken, like the ZeroFluxNeumannBoundaryCondition does.
+       */
+      OffsetValueType steps[ImageDimension][3];
+      SizeValueType   remainder = n;
+      OffsetValueType stride = 1;
+      for (unsigned int d = 0; d < ImageDimension; d++)
       {
-        /** Loop over the neighborhood. */
-        for (unsigned int k = 0; k < neighborhoodSize; ++k)
-        {
-          /** Calculation of the inner product. */
-          tmp[i] += Operator_A.GetElement(k)   // FA *
-                    * nitOCp[i][0].GetPixel(k) // subpart[ i ][ 0 ]
-                    * nit_RCI.GetPixel(k);     // c(k)
-          tmp[i] += Operator_B.GetElement(k)   // FB *
-                    * nitOCp[i][1].GetPixel(k) // subpart[ i ][ 1 ]
-                    * nit_RCI.GetPixel(k);     // c(k)
-          if (ImageDimension == 3)
-          {
-            tmp[i] += Operator_C.GetElement(k)   // FC *
-                      * nitOCp[i][2].GetPixel(k) // subpart[ i ][ 2 ]
-                      * nit_RCI.GetPixel(k);     // c(k)
-          }
-        } // end loop over neighborhood
-
-        /** Set the result in the filtered part. */
-        itOCpf[i].Set(tmp[i]);
-
-      } // end loop over dimension i
-
-      /** Increase all iterators. */
-      ++nit_RCI;
-      for (unsigned int i = 0; i < ImageDimension; i++)
+        const SizeValueType x = remainder % gridSize[d];
+        remainder /= gridSize[d];
+        steps[d][0] = x > 0 ? -stride : 0;
+        steps[d][1] = 0;
+        steps[d][2] = x + 1 < gridSize[d] ? stride : 0;
+        stride *= static_cast<OffsetValueType>(gridSize[d]);
+      }
+      for (unsigned int k = 0; k < neighborhoodSize; ++k)
       {
-        ++itOCpf[i];
-        for (unsigned int j = 0; j < ImageDimension; j++)
+        OffsetValueType offset = 0;
+        unsigned int    position = k;
+        for (unsigned int d = 0; d < ImageDimension; d++)
         {
-          ++nitOCp[i][j];
+          offset += steps[d][position % 3];
+          position /= 3;
         }
+        neighbors[k] = n + offset;
       }
-    } // end while
-  }   // end if do orthonormality
-
-  /** TASK 7B:
-   * Calculate the filtered versions of the properness subparts.
-   * These are F_A * {subpart_0} + F_B * {subpart_1},
-   * and (for 3D) + F_C * {subpart_2}, for all dimensions.
-   ************************************************************************* */
-
-  nit_RCI.GoToBegin();
-  if (this->m_CalculatePropernessCondition)
-  {
-    while (!itPCpf[0].IsAtEnd())
-    {
-      /** Create and reset tmp with zeros. */
-      std::vector<double> tmp(ImageDimension, 0.0);
 
       /** Loop over all dimensions. */
       for (unsigned int i = 0; i < ImageDimension; i++)
       {
-        /** Loop over the neighborhood. */
-        for (unsigned int k = 0; k < neighborhoodSize; ++k)
+        /** Calculation of the inner products over the neighborhood. */
+        double tmpOC = 0.0;
+        double tmpPC = 0.0;
+        double tmpLC = 0.0;
+        if (this->m_CalculateOrthonormalityCondition)
         {
-          /** Calculation of the inner product. */
-          tmp[i] += Operator_A.GetElement(k)   // FA *
-                    * nitPCp[i][0].GetPixel(k) // subpart[ i ][ 0 ]
-                    * nit_RCI.GetPixel(k);     // c(k)
-          tmp[i] += Operator_B.GetElement(k)   // FB *
-                    * nitPCp[i][1].GetPixel(k) // subpart[ i ][ 1 ]
-                    * nit_RCI.GetPixel(k);     // c(k)
-          if (ImageDimension == 3)
+          for (unsigned int k = 0; k < neighborhoodSize; ++k)
           {
-            tmp[i] += Operator_C.GetElement(k)   // FC *
-                      * nitPCp[i][2].GetPixel(k) // subpart[ i ][ 2 ]
-                      * nit_RCI.GetPixel(k);     // c(k)
+            const SizeValueType nk = neighbors[k];
+            tmpOC += Operator_A.GetElement(k) * OCp[i][0][nk] * rigidityCoefficients[nk];
+            tmpOC += Operator_B.GetElement(k) * OCp[i][1][nk] * rigidityCoefficients[nk];
+            if (ImageDimension == 3)
+            {
+              tmpOC += Operator_C.GetElement(k) * OCp[i][2][nk] * rigidityCoefficients[nk];
+            }
           }
-        } // end loop over neighborhood
-
-        /** Set the result in the filtered part. */
-        itPCpf[i].Set(tmp[i]);
-
-      } // end loop over dimension i
-
-      /** Increase all iterators. */
-      ++nit_RCI;
-      for (unsigned int i = 0; i < ImageDimension; i++)
-      {
-        ++itPCpf[i];
-        for (unsigned int j = 0; j < ImageDimension; j++)
+        }
+        if (this->m_CalculatePropernessCondition)
         {
-          ++nitPCp[i][j];
+          for (unsigned int k = 0; k < neighborhoodSize; ++k)
+          {
+            const SizeValueType nk = neighbors[k];
+            tmpPC += Operator_A.GetElement(k) * PCp[i][0][nk] * rigidityCoefficients[nk];
+            tmpPC += Operator_B.GetElement(k) * PCp[i][1][nk] * rigidityCoefficients[nk];
+            if (ImageDimension == 3)
+            {
+              tmpPC += Operator_C.GetElement(k) * PCp[i][2][nk] * rigidityCoefficients[nk];
+            }
+          }
         }
-      }
-    } // end while
-  }   // end if do properness
-
-  /** TASK 7C:
-   * Calculate the filtered versions of the linearity subparts.
-   * These are sum_{i=1}^{NofLParts} F_{D,E,G,F,H,I} * {subpart_i}.
-   ************************************************************************* */
-
-  nit_RCI.GoToBegin();
-  if (this->m_CalculateLinearityCondition)
-  {
-    while (!itLCpf[0].IsAtEnd())
-    {
-      /** Create and reset tmp with zeros. */
-      std::vector<double> tmp(ImageDimension, 0.0);
-
-      /** Loop over all dimensions. */
-      for (unsigned int i = 0; i < ImageDimension; i++)
-      {
-        /** Loop over the neighborhood. */
-        for (unsigned int k = 0; k < neighborhoodSize; ++k)
+        if (this->m_CalculateLinearityCondition)
         {
-          /** Calculation of the inner product. */
-          tmp[i] += Operator_D.GetElement(k)   // FD *
-                    * nitLCp[i][0].GetPixel(k) // subpart[ i ][ 0 ]
-                    * nit_RCI.GetPixel(k);     // c(k)
-          tmp[i] += Operator_E.GetElement(k)   // FE *
-                    * nitLCp[i][1].GetPixel(k) // subpart[ i ][ 1 ]
-                    * nit_RCI.GetPixel(k);     // c(k)
-          tmp[i] += Operator_G.GetElement(k)   // FG *
-                    * nitLCp[i][2].GetPixel(k) // subpart[ i ][ 1 ]
-                    * nit_RCI.GetPixel(k);     // c(k)
-          if (ImageDimension == 3)
+          for (unsigned int k = 0; k < neighborhoodSize; ++k)
           {
-            tmp[i] += Operator_F.GetElement(k)   // FF *
-                      * nitLCp[i][3].GetPixel(k) // subpart[ i ][ 1 ]
-                      * nit_RCI.GetPixel(k);     // c(k)
-            tmp[i] += Operator_H.GetElement(k)   // FH *
-                      * nitLCp[i][4].GetPixel(k) // subpart[ i ][ 1 ]
-                      * nit_RCI.GetPixel(k);     // c(k)
-            tmp[i] += Operator_I.GetElement(k)   // FI *
-                      * nitLCp[i][5].GetPixel(k) // subpart[ i ][ 1 ]
-                      * nit_RCI.GetPixel(k);     // c(k)
+            const SizeValueType nk = neighbors[k];
+            tmpLC += Operator_D.GetElement(k) * (2.0 * D[i][nk]) * rigidityCoefficients[nk];
+            tmpLC += Operator_E.GetElement(k) * (2.0 * E[i][nk]) * rigidityCoefficients[nk];
+            tmpLC += Operator_G.GetElement(k) * (2.0 * G[i][nk]) * rigidityCoefficients[nk];
+            if (ImageDimension == 3)
+            {
+              tmpLC += Operator_F.GetElement(k) * (2.0 * F[i][nk]) * rigidityCoefficients[nk];
+              tmpLC += Operator_H.GetElement(k) * (2.0 * H[i][nk]) * rigidityCoefficients[nk];
+              tmpLC += Operator_I.GetElement(k) * (2.0 * I[i][nk]) * rigidityCoefficients[nk];
+            }
           }
-        } // end loop over neighborhood
+        }
 
-        /** Set the result in the filtered part. */
-        itLCpf[i].Set(tmp[i]);
+        /** Compute gradient magnitude of LC. */
+        const ScalarType weightedLC = this->m_LinearityConditionWeight * tmpLC;
+        gradMagLC += weightedLC * weightedLC / rigidityCoefficientSumSqr;
 
-      } // end loop over dimension i
+        /** Compute gradient magnitude of OC. */
+        const ScalarType weightedOC = this->m_OrthonormalityConditionWeight * tmpOC;
+        gradMagOC += weightedOC * weightedOC / rigidityCoefficientSumSqr;
 
-      /** Increase all iterators. */
-      ++nit_RCI;
-      for (unsigned int i = 0; i < ImageDimension; i++)
-      {
-        ++itLCpf[i];
-        for (unsigned int j = 0; j < NofLParts; j++)
+        /** Compute gradient magnitude of PC. */
+        const ScalarType weightedPC = this->m_PropernessConditionWeight * tmpPC;
+        gradMagPC += weightedPC * weightedPC / rigidityCoefficientSumSqr;
+
+        /** Compute derivative contribution. */
+        ScalarType tmpDIs = NumericTraits<ScalarType>::Zero;
+        if (this->m_UseLinearityCondition)
         {
-          ++nitLCp[i][j];
+          tmpDIs += weightedLC;
         }
-      }
-    } // end while
-  }   // end if do linearity
-
-  /** TASK 8:
-   * Add it all to create the final derivative images.
-   ************************************************************************* */
+        if (this->m_UseOrthonormalityCondition)
+        {
+          tmpDIs += weightedOC;
+        }
+        if (this->m_UsePropernessCondition)
+        {
+          tmpDIs += weightedPC;
+        }
+        derivative[i * numberOfPixels + n] = tmpDIs / rigidityCoefficientSum;
 
-  /** Create derivative images, each holding a component of the vector field. */
-  std::vector<CoefficientImagePointer> derivativeImages(ImageDimension);
-  for (unsigned int i = 0; i < ImageDimension; i++)
-  {
-    derivativeImages[i] = CoefficientImageType::New();
-    derivativeImages[i]->SetRegions(inputImages[i]->GetLargestPossibleRegion());
-    derivativeImages[i]->Allocate();
-  }
+      } // end loop over dimension i
+    }   // end for
 
-  /** Create iterators over the derivative images. */
-  std::vector<CoefficientImageIteratorType> itDIs(ImageDimension);
-  for (unsigned int i = 0; i < ImageDimension; i++)
-  {
-    itDIs[i] = CoefficientImageIteratorType(derivativeImages[i], derivativeImages[i]->GetLargestPossibleRegion());
-    itDIs[i].GoToBegin();
-    itOCpf[i].GoToBegin();
-    itPCpf[i].GoToBegin();
-    itLCpf[i].GoToBegin();
-  }
+    gradMagLCValues[workUnit] = gradMagLC;
+    gradMagOCValues[workUnit] = gradMagOC;
+    gradMagPCValues[workUnit] = gradMagPC;
+  };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, computeDerivative);
 
-  /** Do the addition. */
-  // NOTE: unlike the values, for the derivatives weight * derivative is returned.
+  /** Set the gradient magnitudes of the several terms. */
   MeasureType gradMagLC = NumericTraits<MeasureType>::Zero;
   MeasureType gradMagOC = NumericTraits<MeasureType>::Zero;
   MeasureType gradMagPC = NumericTraits<MeasureType>::Zero;
-  double      rigidityCoefficientSumSqr = rigidityCoefficientSum * rigidityCoefficientSum;
-  while (!itDIs[0].IsAtEnd())
+  for (ThreadIdType workUnit = 0; workUnit < numberOfWorkUnits; ++workUnit)
   {
-    for (unsigned int i = 0; i < ImageDimension; i++)
-    {
-      ScalarType tmpDIs = NumericTraits<ScalarType>::Zero;
-
-      /** Compute gradient magnitude of LC. */
-      ScalarType tmpLC = this->m_LinearityConditionWeight * itLCpf[i].Get();
-      gradMagLC += tmpLC * tmpLC / rigidityCoefficientSumSqr;
-
-      /** Compute gradient magnitude of OC. */
-      ScalarType tmpOC = this->m_OrthonormalityConditionWeight * itOCpf[i].Get();
-      gradMagOC += tmpOC * tmpOC / rigidityCoefficientSumSqr;
-
-      /** Compute gradient magnitude of PC. */
-      ScalarType tmpPC = this->m_PropernessConditionWeight * itPCpf[i].Get();
-      gradMagPC += tmpPC * tmpPC / rigidityCoefficientSumSqr;
-
-      /** Compute derivative contribution. */
-      if (this->m_UseLinearityCondition)
-      {
-        tmpDIs += tmpLC;
-      }
-      if (this->m_UseOrthonormalityCondition)
-      {
-        tmpDIs += tmpOC;
-      }
-      if (this->m_UsePropernessCondition)
-      {
-        tmpDIs += tmpPC;
-      }
-      itDIs[i].Set(tmpDIs);
-
-      /** Update iterators. */
-      ++itDIs[i];
-      ++itOCpf[i];
-      ++itPCpf[i];
-      ++itLCpf[i];
-    }
-  } // end while
-
-  /** Set the gradient magnitudes of the several terms. */
+    gradMagLC += gradMagLCValues[workUnit];
+    gradMagOC += gradMagOCValues[workUnit];
+    gradMagPC += gradMagPCValues[workUnit];
+  }
   this->m_LinearityConditionGradientMagnitude = std::sqrt(gradMagLC);
   this->m_OrthonormalityConditionGradientMagnitude = std::sqrt(gradMagOC);
   this->m_PropernessConditionGradientMagnitude = std::sqrt(gradMagPC);
 
-  /** Rearrange to create a derivative. */
-  unsigned int j = 0;
-  for (unsigned int i = 0; i < ImageDimension; i++)
-  {
-    itDIs[i].GoToBegin();
-    while (!itDIs[i].IsAtEnd())
-    {
-      derivative[j] = itDIs[i].Get() / rigidityCoefficientSum;
-      ++itDIs[i];
-      j++;
-    } // end while
-  }   // end for
-
 } // end GetValueAndDerivative()
 
 
@@ -2162,35 +1836,173 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::Create1DOperator(
  */
 
 template <class TFixedImage, class TScalarType>
-typename TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::CoefficientImagePointer
+void
 TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::FilterSeparable(
-  const CoefficientImageType *          image,
-  const std::vector<NeighborhoodType> & Operators) const
+  const CoefficientImageType *                               image,
+  const std::vector<const std::vector<NeighborhoodType> *> & operatorSets,
+  std::vector<CoefficientImagePointer> &                     outputs) const
 {
-  /** Create filters, supply them with boundary conditions and operators. */
-  std::vector<typename NOIFType::Pointer> filters(ImageDimension);
-  for (unsigned int i = 0; i < ImageDimension; i++)
+  const CoefficientImageRegionType region = image->GetBufferedRegion();
+  const SizeValueType              numberOfPixels = region.GetNumberOfPixels();
+
+  /** Split the image in slabs, one for each work unit. */
+  std::vector<SizeValueType> slabOffsets;
+  const ThreadIdType         numberOfWorkUnits = this->ComputeSlabOffsets(region, slabOffsets);
+
+  /** Sort the operator sets, such that the sets that start with the same
+   * 1D operators are next to each other.
+   */
+  std::vector<std::size_t> order(operatorSets.size());
+  for (std::size_t k = 0; k < order.size(); ++k)
   {
-    filters[i] = NOIFType::New();
-    filters[i]->SetOperator(Operators[i]);
+    order[k] = k;
   }
+  std::stable_sort(order.begin(), order.end(), [&operatorSets](const std::size_t k1, const std::size_t k2) {
+    for (unsigned int d = 0; d < ImageDimension; d++)
+    {
+      for (unsigned int t = 0; t < 3; ++t)
+      {
+        const ScalarType weight1 = (*operatorSets[k1])[d][t];
+        const ScalarType weight2 = (*operatorSets[k2])[d][t];
+        if (weight1 != weight2)
+        {
+          return weight1 < weight2;
+        }
+      }
+    }
+    return false;
+  });
 
-  /** Set up the mini-pipline. */
-  filters[0]->SetInput(image);
-  for (unsigned int i = 1; i < ImageDimension; i++)
+  /** The results of the first ImageDimension - 1 operators of the previous set.
+   * Only these intermediate images are kept, the others are never created.
+   */
+  std::vector<std::vector<CoefficientPixelType>> intermediates(ImageDimension - 1,
+                                                               std::vector<CoefficientPixelType>(numberOfPixels));
+  const std::vector<NeighborhoodType> *          previousOperators = nullptr;
+
+  outputs.resize(operatorSets.size());
+  for (const std::size_t k : order)
   {
-    filters[i]->SetInput(filters[i - 1]->GetOutput());
-  }
+    const std::vector<NeighborhoodType> & operators = *operatorSets[k];
 
-  /** Execute the mini-pipeline. */
-  filters[ImageDimension - 1]->Update();
+    /** Skip the leading operators that are shared with the previous set. */
+    unsigned int firstDimension = 0;
+    while (previousOperators != nullptr && firstDimension + 1 < ImageDimension &&
+           operators[firstDimension][0] == (*previousOperators)[firstDimension][0] &&
+           operators[firstDimension][1] == (*previousOperators)[firstDimension][1] &&
+           operators[firstDimension][2] == (*previousOperators)[firstDimension][2])
+    {
+      ++firstDimension;
+    }
 
-  /** Return the filtered image. */
-  return filters[ImageDimension - 1]->GetOutput();
+    /** Create the output, like the NeighborhoodOperatorImageFilter does. */
+    outputs[k] = CoefficientImageType::New();
+    outputs[k]->CopyInformation(image);
+    outputs[k]->SetRegions(region);
+    outputs[k]->Allocate();
+
+    /** Apply the remaining 1D operators. Outside the image the nearest pixel
+     * is taken, like the ZeroFluxNeumannBoundaryCondition does. The terms are
+     * added in the same order as in the NeighborhoodInnerProduct.
+     */
+    SizeValueType stride = 1;
+    for (unsigned int d = 0; d < firstDimension; d++)
+    {
+      stride *= region.GetSize(d);
+    }
+    for (unsigned int d = firstDimension; d < ImageDimension; d++)
+    {
+      const CoefficientPixelType * input = d == 0 ? image->GetBufferPointer() : intermediates[d - 1].data();
+      CoefficientPixelType *       output =
+        d + 1 == ImageDimension ? outputs[k]->GetBufferPointer() : intermediates[d].data();
+      const ScalarType             weight0 = operators[d][0];
+      const ScalarType             weight1 = operators[d][1];
+      const ScalarType             weight2 = operators[d][2];
+      const SizeValueType          size = region.GetSize(d);
+
+      const auto filterSlab =
+        [&slabOffsets, input, output, weight0, weight1, weight2, stride, size](ThreadIdType workUnit) {
+          for (SizeValueType n = slabOffsets[workUnit]; n < slabOffsets[workUnit + 1]; ++n)
+          {
+            const SizeValueType x = (n / stride) % size;
+            const SizeValueType previous = x > 0 ? n - stride : n;
+            const SizeValueType next = x + 1 < size ? n + stride : n;
+            output[n] = weight0 * input[previous] + weight1 * input[n] + weight2 * input[next];
+          }
+        };
+      this->m_ThreadPool->Execute(numberOfWorkUnits, filterSlab);
+
+      stride *= size;
+    }
+
+    previousOperators = &operators;
+  }
 
 } // end FilterSeparable()
 
 
+/**
+ * ************************** ComputeSlabOffsets ********************
+ */
+
+template <class TFixedImage, class TScalarType>
+ThreadIdType
+TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::ComputeSlabOffsets(
+  const CoefficientImageRegionType & region,
+  std::vector<SizeValueType> &       slabOffsets) const
+{
+  /** The slabs are contiguous ranges of slices along the last dimension. */
+  const SizeValueType numberOfSlices = region.GetSize(ImageDimension - 1);
+  const SizeValueType sliceSize = numberOfSlices > 0 ? region.GetNumberOfPixels() / numberOfSlices : 0;
+  const ThreadIdType  numberOfWorkUnits = static_cast<ThreadIdType>(
+    std::max<SizeValueType>(std::min<SizeValueType>(Self::GetNumberOfWorkUnits(), numberOfSlices), 1));
+
+  slabOffsets.resize(numberOfWorkUnits + 1);
+  for (ThreadIdType workUnit = 0; workUnit <= numberOfWorkUnits; ++workUnit)
+  {
+    slabOffsets[workUnit] = workUnit * numberOfSlices / numberOfWorkUnits * sliceSize;
+  }
+  return numberOfWorkUnits;
+
+} // end ComputeSlabOffsets()
+
+
+/**
+ * ************************** ComputeRigidityCoefficientSum ********************
+ */
+
+template <class TFixedImage, class TScalarType>
+typename TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::ScalarType
+TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::ComputeRigidityCoefficientSum(void) const
+{
+  std::vector<SizeValueType> slabOffsets;
+  const ThreadIdType         numberOfWorkUnits =
+    this->ComputeSlabOffsets(this->m_RigidityCoefficientImage->GetBufferedRegion(), slabOffsets);
+
+  /** Add the rigidity coefficients of each slab together. */
+  const RigidityPixelType * rigidityCoefficients = this->m_RigidityCoefficientImage->GetBufferPointer();
+  std::vector<ScalarType>   slabSums(numberOfWorkUnits);
+
+  const auto addSlab = [&slabOffsets, rigidityCoefficients, &slabSums](ThreadIdType workUnit) {
+    ScalarType sum = NumericTraits<ScalarType>::Zero;
+    for (SizeValueType n = slabOffsets[workUnit]; n < slabOffsets[workUnit + 1]; ++n)
+    {
+      sum += rigidityCoefficients[n];
+    }
+    slabSums[workUnit] = sum;
+  };
+  this->m_ThreadPool->Execute(numberOfWorkUnits, addSlab);
+
+  ScalarType rigidityCoefficientSum = NumericTraits<ScalarType>::Zero;
+  for (ThreadIdType workUnit = 0; workUnit < numberOfWorkUnits; ++workUnit)
+  {
+    rigidityCoefficientSum += slabSums[workUnit];
+  }
+  return rigidityCoefficientSum;
+
+} // end ComputeRigidityCoefficientSum()
+
+
 /**
  * ************************ CreateNDOperator *********************
  */
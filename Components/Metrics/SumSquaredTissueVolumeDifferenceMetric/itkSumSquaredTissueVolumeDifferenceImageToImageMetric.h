@@ -144,6 +144,14 @@ public:
                         MeasureType &                   Value,
                         DerivativeType &                Derivative) const override;
 
+  /** GetValueAndDerivative() only reads the transform, so it may run concurrently with other metrics. */
+  bool
+  GetSupportsConcurrentGetValueAndDerivative(void) const override
+  {
+    return true;
+  }
+
+
   /** Get value and derivatives single-threaded */
   void
   GetValueAndDerivativeSingleThreaded(const TransformParametersType & parameters,
@@ -151,6 +151,13 @@ MovingGenericPyramid<TElastix>::SetMovingSchedule(void)
   this->m_Configuration->ReadParameter(computeThisResolution, "ComputePyramidImagesPerResolution", 0, false);
   this->SetComputeOnlyForCurrentLevel(computeThisResolution);
 
+  /** Decide whether or not to share the pyramid images with the registrations
+   * of other images in this process, that use the same settings.
+   */
+  bool useSharedImageCache = false;
+  this->m_Configuration->ReadParameter(useSharedImageCache, "UseSharedImageCache", 0, false);
+  this->SetUseSharedImageCache(useSharedImageCache);
+
 } // end SetMovingSchedule()
 
 
@@ -174,6 +181,26 @@ MovingGenericPyramid<TElastix>::BeforeEachResolution(void)
 } // end BeforeEachResolution()
 
 
+/**
+ * ******************* ReleasePyramidImage ***********************
+ */
+
+template <class TElastix>
+void
+MovingGenericPyramid<TElastix>::ReleasePyramidImage(const unsigned int level)
+{
+  if (this->GetComputeOnlyForCurrentLevel() && level < this->GetNumberOfOutputs())
+  {
+    this->GetOutput(level)->ReleaseData();
+  }
+  else
+  {
+    this->Superclass2::ReleasePyramidImage(level);
+  }
+
+} // end ReleasePyramidImage()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef elxMovingGenericPyramid_hxx
@@ -64,7 +64,7 @@ AdaGrad<TElastix>::AdaGrad()
   this->m_SigmoidScaleFactor = 0.1;
   this->m_GlobalStepSize = 0;
 
-  this->m_RandomGenerator = RandomGeneratorType::GetInstance();
+  this->m_RandomGenerator = itk::RegistrationThreadState::GetRandomGenerator();
   this->m_AdvancedTransform = nullptr;
 
   this->m_UseNoiseCompensation = true;
@@ -415,6 +415,8 @@ template <class TElastix>
 void
 AdaGrad<TElastix>::AdvanceOneStep(void)
 {
+  itk::TimingProfile::ScopedTimer timer(this->m_TimingProfile, itk::TimingProfile::OptimizerStep);
+
   /** Get space dimension. */
   const unsigned int spaceDimension = this->GetScaledCostFunction()->GetNumberOfParameters();
 
@@ -442,6 +444,7 @@ AdaGrad<TElastix>::AdvanceOneStep(void)
   }
 
   this->Superclass1::UpdateCurrentTime();
+  timer.Stop();
   this->InvokeEvent(itk::IterationEvent());
 
 } // end AdvanceOneStep()
@@ -460,6 +463,7 @@ AdaGrad<TElastix>::ResumeOptimization(void)
    */
   if (this->GetAutomaticParameterEstimation() && !this->m_AutomaticParameterEstimationDone)
   {
+    const itk::TimingProfile::ScopedTimer timer(this->m_TimingProfile, itk::TimingProfile::StepSizeEstimation);
     this->AutomaticPreconditionerEstimation();
     this->m_AutomaticParameterEstimationDone = true; // hack
   }
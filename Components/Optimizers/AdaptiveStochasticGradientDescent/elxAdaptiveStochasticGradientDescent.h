@@ -25,7 +25,7 @@
 #include "itkComputeDisplacementDistribution.h" // For FASGD step size
 #include "elxProgressCommand.h"
 #include "itkAdvancedTransform.h"
-#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkRegistrationThreadState.h"
 
 
 namespace elastix
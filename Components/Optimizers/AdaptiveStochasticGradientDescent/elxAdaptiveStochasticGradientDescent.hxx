@@ -53,7 +53,7 @@ AdaptiveStochasticGradientDescent<TElastix>::AdaptiveStochasticGradientDescent()
   this->m_NumberOfSamplesForExactGradient = 100000;
   this->m_SigmoidScaleFactor = 0.1;
 
-  this->m_RandomGenerator = RandomGeneratorType::GetInstance();
+  this->m_RandomGenerator = itk::RegistrationThreadState::GetRandomGenerator();
   this->m_AdvancedTransform = nullptr;
 
   this->m_UseNoiseCompensation = true;
@@ -410,6 +410,7 @@ AdaptiveStochasticGradientDescent<TElastix>::ResumeOptimization(void)
 
   if (this->GetAutomaticParameterEstimation() && !this->m_AutomaticParameterEstimationDone)
   {
+    const itk::TimingProfile::ScopedTimer timer(this->m_TimingProfile, itk::TimingProfile::StepSizeEstimation);
     this->AutomaticParameterEstimation();
     // hack
     this->m_AutomaticParameterEstimationDone = true;
@@ -77,7 +77,7 @@ AdaptiveStochasticLBFGS<TElastix>::AdaptiveStochasticLBFGS()
   this->m_Bound = 0;
   this->m_WindowScale = 5;
 
-  this->m_RandomGenerator = RandomGeneratorType::GetInstance();
+  this->m_RandomGenerator = itk::RegistrationThreadState::GetRandomGenerator();
   this->m_AdvancedTransform = nullptr;
 
   this->m_UseNoiseCompensation = true;
@@ -603,6 +603,7 @@ AdaptiveStochasticLBFGS<TElastix>::ResumeOptimization(void)
    */
   if (this->GetAutomaticParameterEstimation() && !this->m_AutomaticParameterEstimationDone)
   {
+    const itk::TimingProfile::ScopedTimer timer(this->m_TimingProfile, itk::TimingProfile::StepSizeEstimation);
     this->AutomaticParameterEstimation();
     // hack
     this->m_AutomaticParameterEstimationDone = true;
@@ -23,7 +23,7 @@
 
 #include "elxProgressCommand.h"
 #include "itkAdvancedTransform.h"
-#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkRegistrationThreadState.h"
 #include "itkComputeJacobianTerms.h"
 #include "itkComputeDisplacementDistribution.h"
 #include "itkPlatformMultiThreader.h"
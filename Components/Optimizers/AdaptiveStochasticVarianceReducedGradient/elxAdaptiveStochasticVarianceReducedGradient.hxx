@@ -73,7 +73,7 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::AdaptiveStochasticVarianceR
   this->m_NumberOfInnerIterations = 50;
   this->m_OutsideIterations = 10;
 
-  this->m_RandomGenerator = RandomGeneratorType::GetInstance();
+  this->m_RandomGenerator = itk::RegistrationThreadState::GetRandomGenerator();
   this->m_AdvancedTransform = nullptr;
 
   this->m_UseNoiseCompensation = true;
@@ -529,6 +529,7 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::ResumeOptimization(void)
      * function. */
     if (this->GetAutomaticParameterEstimation() && !this->m_AutomaticParameterEstimationDone)
     {
+      const itk::TimingProfile::ScopedTimer timer(this->m_TimingProfile, itk::TimingProfile::StepSizeEstimation);
       this->AutomaticParameterEstimation();
       // hack
       this->m_AutomaticParameterEstimationDone = true;
@@ -557,7 +558,7 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::ResumeOptimization(void)
 
     timeCollector.Start("g1");
     this->GetRegistration()->GetAsITKBaseType()->GetModifiableMetric()->SetNumberOfWorkUnits(
-      this->GetRegistration()->GetAsITKBaseType()->GetMetric()->GetThreader()->GetGlobalDefaultNumberOfThreads());
+      itk::RegistrationThreadState::GetNumberOfThreads());
     this->GetScaledDerivativeWithExceptionHandling(previousPosition, this->m_MeanGradient);
     // this->GetScaledValueAndDerivative( this->GetScaledCurrentPosition() ,this->m_Value, this->m_PreviousGradient );
     timeCollector.Stop("g1");
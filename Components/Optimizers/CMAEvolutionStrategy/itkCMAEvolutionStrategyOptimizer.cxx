@@ -36,7 +36,7 @@ CMAEvolutionStrategyOptimizer::CMAEvolutionStrategyOptimizer()
 {
   itkDebugMacro("Constructor");
 
-  this->m_RandomGenerator = RandomGeneratorType::GetInstance();
+  this->m_RandomGenerator = RegistrationThreadState::GetRandomGenerator();
 
   this->m_CurrentValue = NumericTraits<MeasureType>::Zero;
   this->m_CurrentIteration = 0;
@@ -26,7 +26,7 @@
 
 #include "itkArray.h"
 #include "itkArray2D.h"
-#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkRegistrationThreadState.h"
 #include "vnl/vnl_diag_matrix.h"
 
 namespace itk
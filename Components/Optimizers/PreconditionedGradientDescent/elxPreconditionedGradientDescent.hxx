@@ -347,6 +347,7 @@ PreconditionedGradientDescent<TElastix>::ResumeOptimization(void)
 
   if (this->GetAutomaticParameterEstimation() && !this->m_AutomaticParameterEstimationDone)
   {
+    const itk::TimingProfile::ScopedTimer timer(this->m_TimingProfile, itk::TimingProfile::StepSizeEstimation);
     this->AutomaticParameterEstimation();
     this->m_AutomaticParameterEstimationDone = true;
   }
@@ -26,7 +26,7 @@
 #include "itkComputePreconditionerUsingDisplacementDistribution.h"
 #include "elxProgressCommand.h"
 #include "itkAdvancedTransform.h"
-#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkRegistrationThreadState.h"
 #include "itkAdvancedBSplineDeformableTransformBase.h"
 #include "itkImageRandomSampler.h"
 
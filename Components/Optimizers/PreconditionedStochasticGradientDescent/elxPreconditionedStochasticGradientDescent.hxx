@@ -64,7 +64,7 @@ PreconditionedStochasticGradientDescent<TElastix>::PreconditionedStochasticGradi
   this->m_SigmoidScaleFactor = 0.1;
   this->m_GlobalStepSize = 0;
 
-  this->m_RandomGenerator = RandomGeneratorType::GetInstance();
+  this->m_RandomGenerator = itk::RegistrationThreadState::GetRandomGenerator();
   this->m_AdvancedTransform = nullptr;
 
   this->m_UseNoiseCompensation = true;
@@ -419,6 +419,8 @@ template <class TElastix>
 void
 PreconditionedStochasticGradientDescent<TElastix>::AdvanceOneStep(void)
 {
+  itk::TimingProfile::ScopedTimer timer(this->m_TimingProfile, itk::TimingProfile::OptimizerStep);
+
   /** Get space dimension. */
   const unsigned int spaceDimension = this->GetScaledCostFunction()->GetNumberOfParameters();
 
@@ -443,6 +445,7 @@ PreconditionedStochasticGradientDescent<TElastix>::AdvanceOneStep(void)
   }
 
   this->Superclass1::UpdateCurrentTime();
+  timer.Stop();
   this->InvokeEvent(itk::IterationEvent());
 
 } // end AdvanceOneStep()
@@ -461,6 +464,7 @@ PreconditionedStochasticGradientDescent<TElastix>::ResumeOptimization(void)
    */
   if (this->GetAutomaticParameterEstimation() && !this->m_AutomaticParameterEstimationDone)
   {
+    const itk::TimingProfile::ScopedTimer timer(this->m_TimingProfile, itk::TimingProfile::StepSizeEstimation);
     this->AutomaticPreconditionerEstimation();
     this->m_AutomaticParameterEstimationDone = true; // hack
   }
@@ -199,6 +199,7 @@ GradientDescentOptimizer2 ::AdvanceOneStep(void)
   ParametersType & newPosition = this->m_ScaledCurrentPosition;
 
   /** Advance one step. */
+  TimingProfile::ScopedTimer timer(this->m_TimingProfile, TimingProfile::OptimizerStep);
 #if 1 // force single-threaded since it is fastest most of the times
       //#ifndef ELASTIX_USE_OPENMP // If no OpenMP detected then use single-threaded code
   /** Get a reference to the current position. */
@@ -222,6 +223,7 @@ GradientDescentOptimizer2 ::AdvanceOneStep(void)
     newPosition[j] = currentPosition[j] - this->m_LearningRate * this->m_Gradient[j];
   }
 #endif
+  timer.Stop();
 
   this->InvokeEvent(IterationEvent());
 
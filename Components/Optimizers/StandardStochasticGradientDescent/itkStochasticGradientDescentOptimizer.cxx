@@ -211,6 +211,7 @@ StochasticGradientDescentOptimizer::AdvanceOneStep(void)
   ParametersType & newPosition = this->m_ScaledCurrentPosition;
 
   /** Advance one step. */
+  TimingProfile::ScopedTimer timer(this->m_TimingProfile, TimingProfile::OptimizerStep);
   // single-threadedly
   if (!this->m_UseMultiThread || true) // for now force single-threaded since it is fastest most of the times
   // if( !this->m_UseMultiThread && false ) // force multi-threaded
@@ -301,6 +302,7 @@ StochasticGradientDescentOptimizer::AdvanceOneStep(void)
     local_threader->SetSingleMethod(AdvanceOneStepThreaderCallback, &temp);
     local_threader->SingleMethodExecute();
   }
+  timer.Stop();
 
   this->InvokeEvent(IterationEvent());
 
@@ -20,6 +20,7 @@
 
 #include "elxIncludes.h" // include first to avoid MSVS warning
 #include "itkMultiMetricMultiResolutionImageRegistrationMethod.h"
+#include "itkImageSampleContainerCache.h"
 
 namespace elastix
 {
@@ -82,6 +83,17 @@ namespace elastix
  *    or simple static, fixed weights. \n
  *    example: <tt>(UseRelativeWeights "false" "true")</tt> \n
  *    The default is "false", which means using Metric\<i\>Weight.
+ * \parameter UseParallelMetricEvaluation: Whether the metrics are computed
+ *    concurrently instead of one after another, in each resolution. Metrics that
+ *    do not support this are still computed one after another. \n
+ *    example: <tt>(UseParallelMetricEvaluation "false" "true")</tt> \n
+ *    The default is "false".
+ * \parameter UseSampleContainerCache: Whether the full and grid image samplers
+ *    of the metrics share their samples, in each resolution. Samplers with the same
+ *    fixed image, mask, region and grid spacing then generate their samples only once.
+ *    This saves computation time, at the cost of the memory of one extra copy of the samples. \n
+ *    example: <tt>(UseSampleContainerCache "false" "true")</tt> \n
+ *    The default is "false".
  * \parameter Metric\<i\>Use: Whether the i-th metric is only computed or
  *    also used, in each resolution. \n
  *    example: <tt>(Metric0Use "false" "true")</tt> \n
@@ -194,6 +206,7 @@ public:
   /** Execute stuff before each resolution:
    * \li Update masks with an erosion.
    * \li Set the metric weights.
+   * \li Set the sample container cache to the image samplers.
    */
   void
   BeforeEachResolution(void) override;
@@ -232,7 +245,11 @@ protected:
   virtual void
   SetComponents(void);
 
-  bool m_ShowExactMetricValue;
+  /** The cache of the samples shared by the image samplers. */
+  typedef itk::ImageSampleContainerCache<FixedImageType> ImageSampleContainerCacheType;
+
+  bool                                            m_ShowExactMetricValue;
+  typename ImageSampleContainerCacheType::Pointer m_SampleContainerCache;
 
 private:
   /** The deleted copy constructor. */
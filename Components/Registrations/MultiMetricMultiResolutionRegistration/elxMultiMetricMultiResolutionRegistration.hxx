@@ -32,6 +32,7 @@ template <class TElastix>
 MultiMetricMultiResolutionRegistration<TElastix>::MultiMetricMultiResolutionRegistration()
 {
   this->m_ShowExactMetricValue = false;
+  this->m_SampleContainerCache = ImageSampleContainerCacheType::New();
 } // end constructor
 
 
@@ -192,6 +193,23 @@ MultiMetricMultiResolutionRegistration<TElastix>::BeforeEachResolution(void)
   this->GetConfiguration()->ReadParameter(useRelativeWeights, "UseRelativeWeights", 0);
   this->GetCombinationMetric()->SetUseRelativeWeights(useRelativeWeights);
 
+  /** Set whether the metrics are computed concurrently. */
+  bool useParallelMetricEvaluation = false;
+  this->GetConfiguration()->ReadParameter(useParallelMetricEvaluation, "UseParallelMetricEvaluation", 0);
+  this->GetCombinationMetric()->SetUseParallelMetricEvaluation(useParallelMetricEvaluation);
+
+  /** Set whether the image samplers share their samples. The samples of
+   * the previous resolution are not needed anymore, so release them.
+   */
+  bool useSampleContainerCache = false;
+  this->GetConfiguration()->ReadParameter(useSampleContainerCache, "UseSampleContainerCache", "", level, 0);
+  this->m_SampleContainerCache->Clear();
+  for (unsigned int i = 0; i < this->GetElastix()->GetNumberOfImageSamplers(); ++i)
+  {
+    this->GetElastix()->GetElxImageSamplerBase(i)->GetAsITKBaseType()->SetSampleContainerCache(
+      useSampleContainerCache ? this->m_SampleContainerCache.GetPointer() : nullptr);
+  }
+
   /** Set the metric weights. The default metric weight is 1.0 / nrOfMetrics. */
   if (!useRelativeWeights)
   {
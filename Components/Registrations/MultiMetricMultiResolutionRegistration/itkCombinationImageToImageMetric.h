@@ -202,6 +202,14 @@ public:
   itkSetMacro(UseRelativeWeights, bool);
   itkGetMacro(UseRelativeWeights, bool);
 
+  /** Set and Get the UseParallelMetricEvaluation variable. If true, GetValueAndDerivative()
+   * computes the sub metrics that support it concurrently, sharing one thread pool with
+   * their own multi-threading, and combines their derivatives in one parallel pass.
+   * Default: false.
+   */
+  itkSetMacro(UseParallelMetricEvaluation, bool);
+  itkGetMacro(UseParallelMetricEvaluation, bool);
+
   /** Select which metrics are used.
    * This is useful in case you want to compute a certain measure, but not
    * actually use it during the registration.
@@ -451,6 +459,7 @@ protected:
   std::vector<double>                          m_MetricWeights;
   std::vector<double>                          m_MetricRelativeWeights;
   bool                                         m_UseRelativeWeights;
+  bool                                         m_UseParallelMetricEvaluation;
   std::vector<bool>                            m_UseMetric;
   mutable std::vector<MeasureType>             m_MetricValues;
   mutable std::vector<DerivativeType>          m_MetricDerivatives;
@@ -478,6 +487,20 @@ private:
    */
   double
   GetFinalMetricWeight(unsigned int pos) const;
+
+  /** Returns whether metric pos may be computed concurrently with the others. */
+  bool
+  GetMetricSupportsConcurrentEvaluation(unsigned int pos) const;
+
+  /** Compute the values, derivatives and derivative magnitudes of all metrics,
+   * concurrently where possible.
+   */
+  void
+  GetValueAndDerivativeOfMetricsConcurrently(const ParametersType & parameters) const;
+
+  /** Compute the weighted sum of the metric derivatives, multi-threaded. */
+  void
+  CombineMetricDerivatives(DerivativeType & derivative) const;
 };
 
 } // end namespace itk
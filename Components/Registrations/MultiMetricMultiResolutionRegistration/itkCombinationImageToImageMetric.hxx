@@ -22,6 +22,9 @@
 #include "itkTimeProbe.h"
 #include "itkMath.h"
 
+#include <algorithm>
+#include <vector>
+
 /** Macros to reduce some copy-paste work.
  * These macros provide the implementation of
  * all Set/GetFixedImage, Set/GetInterpolator etc methods
@@ -146,6 +149,7 @@ CombinationImageToImageMetric<TFixedImage, TMovingImage>::CombinationImageToImag
 {
   this->m_NumberOfMetrics = 0;
   this->m_UseRelativeWeights = false;
+  this->m_UseParallelMetricEvaluation = false;
   this->ComputeGradientOff();
 
 } // end Constructor
@@ -164,6 +168,7 @@ CombinationImageToImageMetric<TFixedImage, TMovingImage>::PrintSelf(std::ostream
 
   /** Add debugging information. */
   os << "NumberOfMetrics: " << this->m_NumberOfMetrics << std::endl;
+  os << "UseParallelMetricEvaluation: " << (this->m_UseParallelMetricEvaluation ? "true\n" : "false\n");
   for (unsigned int i = 0; i < this->m_NumberOfMetrics; i++)
   {
     os << "Metric " << i << ":\n";
@@ -807,23 +812,30 @@ CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetValueAndDerivative(
   /** Initialize some threading related parameters. */
   this->InitializeThreadingParameters();
 
-  /** Compute all metric values and derivatives. */
-  for (unsigned int i = 0; i < this->m_NumberOfMetrics; i++)
+  /** Compute all metric values, derivatives and derivative magnitudes. */
+  if (this->m_UseParallelMetricEvaluation)
   {
-    /** Compute ... */
-    timer.Reset();
-    timer.Start();
-    this->m_Metrics[i]->GetValueAndDerivative(parameters, this->m_MetricValues[i], this->m_MetricDerivatives[i]);
-    timer.Stop();
-
-    /** Store computation time. */
-    this->m_MetricComputationTime[i] = timer.GetMean() * 1000.0;
+    this->GetValueAndDerivativeOfMetricsConcurrently(parameters);
   }
-
-  /** Compute the derivative magnitude. */
-  for (unsigned int i = 0; i < this->m_NumberOfMetrics; i++)
+  else
   {
-    this->m_MetricDerivativesMagnitude[i] = this->m_MetricDerivatives[i].magnitude();
+    for (unsigned int i = 0; i < this->m_NumberOfMetrics; i++)
+    {
+      /** Compute ... */
+      timer.Reset();
+      timer.Start();
+      this->m_Metrics[i]->GetValueAndDerivative(parameters, this->m_MetricValues[i], this->m_MetricDerivatives[i]);
+      timer.Stop();
+
+      /** Store computation time. */
+      this->m_MetricComputationTime[i] = timer.GetMean() * 1000.0;
+    }
+
+    /** Compute the derivative magnitude. */
+    for (unsigned int i = 0; i < this->m_NumberOfMetrics; i++)
+    {
+      this->m_MetricDerivativesMagnitude[i] = this->m_MetricDerivatives[i].magnitude();
+    }
   }
 
   /** Combine the metric values. */
@@ -837,6 +849,13 @@ CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetValueAndDerivative(
     }
   }
 
+  /** Combine the metric derivatives in a single parallel pass. */
+  if (this->m_UseParallelMetricEvaluation)
+  {
+    this->CombineMetricDerivatives(derivative);
+    return;
+  }
+
   /** Combine the metric derivatives. First, the first derivative. */
   if (this->m_UseMetric[0])
   {
@@ -861,6 +880,130 @@ CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetValueAndDerivative(
 } // end GetValueAndDerivative()
 
 
+/**
+ * ********************* GetMetricSupportsConcurrentEvaluation ****************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+bool
+CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetMetricSupportsConcurrentEvaluation(unsigned int pos) const
+{
+  const ImageMetricType *    testPtr1 = dynamic_cast<const ImageMetricType *>(this->GetMetric(pos));
+  const PointSetMetricType * testPtr2 = dynamic_cast<const PointSetMetricType *>(this->GetMetric(pos));
+  if (testPtr1)
+  {
+    return testPtr1->GetSupportsConcurrentGetValueAndDerivative();
+  }
+  if (testPtr2)
+  {
+    return testPtr2->GetSupportsConcurrentGetValueAndDerivative();
+  }
+  return false;
+
+} // end GetMetricSupportsConcurrentEvaluation()
+
+
+/**
+ * ********************* GetValueAndDerivativeOfMetricsConcurrently ****************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetValueAndDerivativeOfMetricsConcurrently(
+  const ParametersType & parameters) const
+{
+  /** Compute, time and store the value, derivative and derivative magnitude of metric i. */
+  const auto computeMetric = [this, &parameters](const unsigned int i) {
+    itk::TimeProbe timer;
+    timer.Start();
+    this->m_Metrics[i]->GetValueAndDerivative(parameters, this->m_MetricValues[i], this->m_MetricDerivatives[i]);
+    timer.Stop();
+
+    this->m_MetricComputationTime[i] = timer.GetMean() * 1000.0;
+    this->m_MetricDerivativesMagnitude[i] = this->m_MetricDerivatives[i].magnitude();
+  };
+
+  /** Metrics that may change the shared transform during GetValueAndDerivative()
+   * are computed one after another, before the others.
+   */
+  std::vector<unsigned int> concurrentMetrics;
+  for (unsigned int i = 0; i < this->m_NumberOfMetrics; i++)
+  {
+    if (this->GetMetricSupportsConcurrentEvaluation(i))
+    {
+      concurrentMetrics.push_back(i);
+    }
+    else
+    {
+      computeMetric(i);
+    }
+  }
+
+  /** The remaining metrics are computed concurrently, one work unit each. A metric
+   * that is multi-threaded itself executes its threads on the same thread pool, so
+   * the threads that are done with a small metric help out with the larger ones.
+   */
+  this->m_ThreadPool->Execute(static_cast<ThreadIdType>(concurrentMetrics.size()),
+                              [&computeMetric, &concurrentMetrics](ThreadIdType workUnitID) {
+                                computeMetric(concurrentMetrics[workUnitID]);
+                              });
+
+} // end GetValueAndDerivativeOfMetricsConcurrently()
+
+
+/**
+ * ********************* CombineMetricDerivatives ****************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+CombinationImageToImageMetric<TFixedImage, TMovingImage>::CombineMetricDerivatives(DerivativeType & derivative) const
+{
+  /** Collect the final weights and derivatives of the metrics that are used. */
+  std::vector<double>                      weights;
+  std::vector<const DerivativeValueType *> metricDerivatives;
+  for (unsigned int i = 0; i < this->m_NumberOfMetrics; i++)
+  {
+    if (this->m_UseMetric[i])
+    {
+      weights.push_back(this->GetFinalMetricWeight(i));
+      metricDerivatives.push_back(this->m_MetricDerivatives[i].data_block());
+    }
+  }
+
+  const unsigned int numPar = this->GetNumberOfParameters();
+  derivative.SetSize(numPar);
+  DerivativeValueType * derivativePtr = derivative.data_block();
+
+  /** Each work unit computes the weighted sum of all derivatives for a contiguous
+   * range of parameters, so that the combined derivative is written only once.
+   * Small derivatives are not worth the threading overhead.
+   */
+  const unsigned int minimumNumberOfParametersPerWorkUnit = 4096;
+  const ThreadIdType numberOfWorkUnits = std::max<ThreadIdType>(
+    std::min<ThreadIdType>(this->GetNumberOfWorkUnits(), numPar / minimumNumberOfParametersPerWorkUnit), 1);
+  const unsigned int subSize = (numPar + numberOfWorkUnits - 1) / numberOfWorkUnits;
+
+  this->m_ThreadPool->Execute(
+    numberOfWorkUnits, [&weights, &metricDerivatives, derivativePtr, numPar, subSize](ThreadIdType workUnitID) {
+      const unsigned int jmin = std::min(workUnitID * subSize, numPar);
+      const unsigned int jmax = std::min((workUnitID + 1) * subSize, numPar);
+      const std::size_t  numberOfUsedMetrics = weights.size();
+
+      for (unsigned int j = jmin; j < jmax; ++j)
+      {
+        DerivativeValueType sum = NumericTraits<DerivativeValueType>::ZeroValue();
+        for (std::size_t k = 0; k < numberOfUsedMetrics; ++k)
+        {
+          sum += weights[k] * metricDerivatives[k][j];
+        }
+        derivativePtr[j] = sum;
+      }
+    });
+
+} // end CombineMetricDerivatives()
+
+
 /**
  * ********************* GetSelfHessian ****************************
  */
@@ -110,6 +110,21 @@ public:
   OutputPointType
   TransformPoint(const InputPointType & inputPoint) const override;
 
+  /** Method to transform an array of points. Like TransformPoint(), it adds the
+   * intermediary deformation field to the batched result of the superclass.
+   */
+  void
+  TransformPointBatch(const InputPointType * inputPoints,
+                      OutputPointType *      outputPoints,
+                      std::size_t            numberOfPoints) const override;
+
+  /** TransformPoint() adds the intermediary deformation field to the combination. */
+  bool
+  GetTransformPointIsCombination(void) const override
+  {
+    return false;
+  }
+
 protected:
   /** The constructor. */
   DeformationFieldRegulizer();
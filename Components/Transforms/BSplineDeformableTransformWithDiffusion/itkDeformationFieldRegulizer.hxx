@@ -112,6 +112,32 @@ DeformationFieldRegulizer<TAnyITKTransform>::TransformPoint(const InputPointType
 } // end TransformPoint()
 
 
+/**
+ * *********************** TransformPointBatch ***********************
+ */
+
+template <class TAnyITKTransform>
+void
+DeformationFieldRegulizer<TAnyITKTransform>::TransformPointBatch(const InputPointType * inputPoints,
+                                                                 OutputPointType *      outputPoints,
+                                                                 std::size_t            numberOfPoints) const
+{
+  /** Get the outputpoints of any ITK Transform. */
+  this->Superclass::TransformPointBatch(inputPoints, outputPoints, numberOfPoints);
+
+  /** Add the deformation field: don't forget to subtract ipp. */
+  for (std::size_t n = 0; n < numberOfPoints; ++n)
+  {
+    const OutputPointType oppDF = this->m_IntermediaryDeformationFieldTransform->TransformPoint(inputPoints[n]);
+    for (unsigned int i = 0; i < OutputSpaceDimension; i++)
+    {
+      outputPoints[n][i] += oppDF[i] - inputPoints[n][i];
+    }
+  }
+
+} // end TransformPointBatch()
+
+
 /**
  * ******** UpdateIntermediaryDeformationFieldTransform *********
  */
@@ -20,6 +20,7 @@
 
 #include "elxFixedImagePyramidBase.h"
 #include "itkImageFileCastWriter.h"
+#include "itkRegistrationThreadState.h"
 
 namespace elastix
 {
@@ -35,6 +36,12 @@ FixedImagePyramidBase<TElastix>::BeforeRegistrationBase(void)
   /** Call SetFixedSchedule.*/
   this->SetFixedSchedule();
 
+  /** Limit the pyramid to the threads of this registration. */
+  if (itk::RegistrationThreadState::GetMaximumNumberOfThreads() > 0)
+  {
+    this->GetAsITKBaseType()->SetNumberOfWorkUnits(itk::RegistrationThreadState::GetNumberOfThreads());
+  }
+
 } // end BeforeRegistrationBase()
 
 
@@ -199,6 +206,22 @@ FixedImagePyramidBase<TElastix>::WritePyramidImage(const std::string &  filename
 } // end WritePyramidImage()
 
 
+/**
+ * ******************* ReleasePyramidImage ********************
+ */
+
+template <class TElastix>
+void
+FixedImagePyramidBase<TElastix>::ReleasePyramidImage(const unsigned int level)
+{
+  if (level > 0 && level < this->GetAsITKBaseType()->GetNumberOfOutputs())
+  {
+    this->GetAsITKBaseType()->GetOutput(level)->ReleaseData();
+  }
+
+} // end ReleasePyramidImage()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef elxFixedImagePyramidBase_hxx
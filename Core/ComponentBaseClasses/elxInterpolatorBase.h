@@ -82,6 +82,15 @@ public:
   }
 
 
+  /** Release the memory that the interpolator allocated for the current
+   * resolution, such as B-spline coefficient images. It is allocated again
+   * when the input image of the next resolution is set.
+   */
+  virtual void
+  ReleaseMemory(void)
+  {}
+
+
 protected:
   /** The constructor. */
   InterpolatorBase() = default;
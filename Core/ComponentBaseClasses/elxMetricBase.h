@@ -63,6 +63,26 @@ namespace elastix
  *    CheckNumberOfSamples. \n
  *    example: <tt>(RequiredRatioOfValidSamples 0.1)</tt> \n
  *    The default is 0.25.
+ * \parameter UseSparseDerivativeAccumulation: Whether the multi-threaded metrics only
+ *    initialize and accumulate the parts of the per-thread derivatives that are actually
+ *    touched. Saves time and memory for transforms with many parameters and a sparse
+ *    Jacobian, like the B-spline. Can be given for each resolution. \n
+ *    example: <tt>(UseSparseDerivativeAccumulation "true")</tt> \n
+ *    The default is false.
+ * \parameter UseBSplineWeightsCache: Whether the B-spline interpolation weights of the
+ *    fixed image samples are computed once per resolution, instead of every iteration.
+ *    Only used with a sampler that takes the same samples every iteration (Full or Grid),
+ *    a B-spline transform other than BSplineTransformWithDiffusion, and a metric that
+ *    supports it, like AdvancedMeanSquares. For those metrics, the memory use is reported
+ *    in the log after each resolution. Can be given for each
+ *    resolution. \n
+ *    example: <tt>(UseBSplineWeightsCache "true")</tt> \n
+ *    The default is false.
+ * \parameter MaximumBSplineWeightsCacheSize: The maximum memory, in megabytes, that the
+ *    B-spline weights cache may use. When more memory would be needed, the cache is not used.
+ *    Can be given for each resolution. \n
+ *    example: <tt>(MaximumBSplineWeightsCacheSize 512)</tt> \n
+ *    The default is 1024.
  *
  * \ingroup Metrics
  * \ingroup ComponentBaseClasses
@@ -161,6 +181,12 @@ public:
   void
   AfterEachIterationBase(void) override;
 
+  /** Execute stuff after each resolution:
+   * \li Report the memory used by the B-spline weights cache, if it was requested.
+   */
+  void
+  AfterEachResolutionBase(void) override;
+
   /** Force the metric to base its computation on a new subset of image samples.
    * Not every metric may have implemented this.
    */
@@ -187,6 +213,13 @@ public:
   virtual ImageSamplerBaseType *
   GetAdvancedMetricImageSampler(void) const;
 
+  /** Get the profile with the time spent in the phases of the metric in the current
+   * resolution. Returns null when the metric is not of AdvancedMetricType, or when
+   * WriteTimingProfile is false.
+   */
+  virtual const itk::TimingProfile *
+  GetAdvancedMetricTimingProfile(void) const;
+
   /** Get if the exact metric value is computed */
   virtual bool
   GetShowExactMetricValue(void) const
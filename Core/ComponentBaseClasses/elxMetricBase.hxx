@@ -168,11 +168,79 @@ MetricBase<TElastix>::BeforeEachResolutionBase(void)
       }
     }
 
+    /** Should the per-thread derivatives be accumulated sparsely? */
+    bool useSparseDerivativeAccumulation = false;
+    this->GetConfiguration()->ReadParameter(
+      useSparseDerivativeAccumulation, "UseSparseDerivativeAccumulation", this->GetComponentLabel(), level, 0);
+    thisAsAdvanced->SetUseSparseDerivativeAccumulation(useSparseDerivativeAccumulation);
+
+    /** Should the B-spline weights of the samples be computed once per resolution? */
+    bool useBSplineWeightsCache = false;
+    this->GetConfiguration()->ReadParameter(
+      useBSplineWeightsCache, "UseBSplineWeightsCache", this->GetComponentLabel(), level, 0);
+    thisAsAdvanced->SetUseBSplineWeightsCache(useBSplineWeightsCache);
+
+    unsigned long maximumBSplineWeightsCacheSize = 1024;
+    this->GetConfiguration()->ReadParameter(
+      maximumBSplineWeightsCacheSize, "MaximumBSplineWeightsCacheSize", this->GetComponentLabel(), level, 0, false);
+    thisAsAdvanced->SetMaximumBSplineWeightsCacheSize(maximumBSplineWeightsCacheSize * 1024 * 1024);
+
+    /** Should a moving image gradient be shared with other registrations? */
+    bool useSharedImageCache = false;
+    this->GetConfiguration()->ReadParameter(useSharedImageCache, "UseSharedImageCache", 0, false);
+    thisAsAdvanced->SetUseSharedImageCache(useSharedImageCache);
+
+    /** Should the time spent in the phases of the metric be measured? */
+    bool writeTimingProfile = false;
+    this->GetConfiguration()->ReadParameter(writeTimingProfile, "WriteTimingProfile", 0, false);
+    if (!writeTimingProfile)
+    {
+      thisAsAdvanced->SetTimingProfile(nullptr);
+    }
+    else if (thisAsAdvanced->GetTimingProfile() == nullptr)
+    {
+      thisAsAdvanced->SetTimingProfile(itk::TimingProfile::New());
+    }
+    else
+    {
+      thisAsAdvanced->GetModifiableTimingProfile()->Reset();
+    }
+
   } // end advanced metric
 
 } // end BeforeEachResolutionBase()
 
 
+/**
+ * ******************* AfterEachResolutionBase ******************
+ */
+
+template <class TElastix>
+void
+MetricBase<TElastix>::AfterEachResolutionBase(void)
+{
+  /** Report the memory used by the B-spline weights cache, for the metrics that use it. */
+  const AdvancedMetricType * thisAsAdvanced = dynamic_cast<const AdvancedMetricType *>(this);
+  if (thisAsAdvanced != nullptr && thisAsAdvanced->GetUseBSplineWeightsCache() &&
+      thisAsAdvanced->GetSupportsBSplineWeightsCache())
+  {
+    const itk::SizeValueType cacheSize = thisAsAdvanced->GetBSplineWeightsCacheSize();
+    if (cacheSize > 0)
+    {
+      elxout << "  B-spline weights cache of " << this->GetComponentLabel() << ": " << cacheSize / (1024.0 * 1024.0)
+             << " MB" << std::endl;
+    }
+    else
+    {
+      elxout << "  B-spline weights cache of " << this->GetComponentLabel()
+             << ": not used. It requires a Full or Grid sampler, a B-spline transform, "
+             << "and at most MaximumBSplineWeightsCacheSize memory." << std::endl;
+    }
+  }
+
+} // end AfterEachResolutionBase()
+
+
 /**
  * ******************* AfterEachIterationBase ******************
  */
@@ -267,6 +335,7 @@ MetricBase<TElastix>::GetExactValue(const ParametersType & parameters)
   this->m_ExactMetricSampler->SetMask(currentSampler->GetMask());
   this->m_ExactMetricSampler->SetInputImageRegion(currentSampler->GetInputImageRegion());
   this->m_ExactMetricSampler->SetSampleGridSpacing(this->m_ExactMetricSampleGridSpacing);
+  this->m_ExactMetricSampler->SetSampleContainerCache(currentSampler->GetSampleContainerCache());
   this->m_ExactMetricSampler->Update();
   this->SetAdvancedMetricImageSampler(this->m_ExactMetricSampler);
 
@@ -360,6 +429,26 @@ MetricBase<TElastix>::GetAdvancedMetricImageSampler(void) const
 
 } // end GetAdvancedMetricImageSampler()
 
+
+/**
+ * ******************* GetAdvancedMetricTimingProfile ******************
+ */
+
+template <class TElastix>
+const itk::TimingProfile *
+MetricBase<TElastix>::GetAdvancedMetricTimingProfile(void) const
+{
+  /** Cast this to AdvancedMetricType. */
+  const AdvancedMetricType * thisAsAdvanced = dynamic_cast<const AdvancedMetricType *>(this);
+  if (thisAsAdvanced == nullptr)
+  {
+    return nullptr;
+  }
+
+  return thisAsAdvanced->GetTimingProfile();
+
+} // end GetAdvancedMetricTimingProfile()
+
 } // end namespace elastix
 
 #endif // end #ifndef elxMetricBase_hxx
@@ -122,6 +122,14 @@ public:
   WritePyramidImage(const std::string &  filename,
                     const unsigned int & level); // const;
 
+  /** Method to release the pyramid image of a level, after that resolution.
+   * The image of the first level is kept: the registration updates the pyramid
+   * through that image at each resolution, which would otherwise compute all
+   * levels again.
+   */
+  virtual void
+  ReleasePyramidImage(const unsigned int level);
+
 protected:
   /** The constructor. */
   MovingImagePyramidBase() = default;
@@ -21,6 +21,7 @@
 
 #include "elxMovingImagePyramidBase.h"
 #include "itkImageFileCastWriter.h"
+#include "itkRegistrationThreadState.h"
 
 namespace elastix
 {
@@ -36,6 +37,12 @@ MovingImagePyramidBase<TElastix>::BeforeRegistrationBase(void)
   /** Call SetMovingSchedule.*/
   this->SetMovingSchedule();
 
+  /** Limit the pyramid to the threads of this registration. */
+  if (itk::RegistrationThreadState::GetMaximumNumberOfThreads() > 0)
+  {
+    this->GetAsITKBaseType()->SetNumberOfWorkUnits(itk::RegistrationThreadState::GetNumberOfThreads());
+  }
+
 } // end BeforeRegistrationBase()
 
 
@@ -202,6 +209,22 @@ MovingImagePyramidBase<TElastix>::WritePyramidImage(const std::string &  filenam
 } // end WritePyramidImage()
 
 
+/**
+ * ******************* ReleasePyramidImage ********************
+ */
+
+template <class TElastix>
+void
+MovingImagePyramidBase<TElastix>::ReleasePyramidImage(const unsigned int level)
+{
+  if (level > 0 && level < this->GetAsITKBaseType()->GetNumberOfOutputs())
+  {
+    this->GetAsITKBaseType()->GetOutput(level)->ReleaseData();
+  }
+
+} // end ReleasePyramidImage()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef elxMovingImagePyramidBase_hxx
@@ -24,6 +24,7 @@
 
 #include "elxBaseComponentSE.h"
 #include "itkOptimizer.h"
+#include "itkScaledSingleValuedNonLinearOptimizer.h"
 
 namespace elastix
 {
@@ -96,6 +97,7 @@ public:
 
   /** Execute stuff before each new pyramid resolution:
    * \li Find out if new samples are used every new iteration in this resolution.
+   * \li Create or reset the timing profile, if WriteTimingProfile is true.
    */
   void
   BeforeEachResolutionBase() override;
@@ -112,6 +114,13 @@ public:
   virtual void
   SetSinusScales(double amplitude, double frequency, unsigned long numberOfParameters);
 
+  /** Get the profile with the time spent in the phases of the optimizer in the current
+   * resolution. Returns null when the optimizer is not a ScaledSingleValuedNonLinearOptimizer,
+   * or when WriteTimingProfile is false.
+   */
+  virtual const itk::TimingProfile *
+  GetScaledOptimizerTimingProfile(void) const;
+
 protected:
   /** The constructor. */
   OptimizerBase();
@@ -75,6 +75,27 @@ OptimizerBase<TElastix>::BeforeEachResolutionBase(void)
   this->GetConfiguration()->ReadParameter(
     this->m_NewSamplesEveryIteration, "NewSamplesEveryIteration", this->GetComponentLabel(), level, 0);
 
+  /** Should the time spent in the phases of the optimizer be measured? */
+  itk::ScaledSingleValuedNonLinearOptimizer * thisAsScaled =
+    dynamic_cast<itk::ScaledSingleValuedNonLinearOptimizer *>(this);
+  if (thisAsScaled != nullptr)
+  {
+    bool writeTimingProfile = false;
+    this->GetConfiguration()->ReadParameter(writeTimingProfile, "WriteTimingProfile", 0, false);
+    if (!writeTimingProfile)
+    {
+      thisAsScaled->SetTimingProfile(nullptr);
+    }
+    else if (thisAsScaled->GetTimingProfile() == nullptr)
+    {
+      thisAsScaled->SetTimingProfile(itk::TimingProfile::New());
+    }
+    else
+    {
+      thisAsScaled->GetModifiableTimingProfile()->Reset();
+    }
+  }
+
 } // end BeforeEachResolutionBase()
 
 
@@ -163,6 +184,26 @@ OptimizerBase<TElastix>::SetSinusScales(double amplitude, double frequency, unsi
 } // end SetSinusScales()
 
 
+/**
+ * ****************** GetScaledOptimizerTimingProfile ********************
+ */
+
+template <class TElastix>
+const itk::TimingProfile *
+OptimizerBase<TElastix>::GetScaledOptimizerTimingProfile(void) const
+{
+  const itk::ScaledSingleValuedNonLinearOptimizer * thisAsScaled =
+    dynamic_cast<const itk::ScaledSingleValuedNonLinearOptimizer *>(this);
+  if (thisAsScaled == nullptr)
+  {
+    return nullptr;
+  }
+
+  return thisAsScaled->GetTimingProfile();
+
+} // end GetScaledOptimizerTimingProfile()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef elxOptimizerBase_hxx
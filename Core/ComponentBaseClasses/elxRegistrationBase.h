@@ -210,6 +210,20 @@ protected:
                                   unsigned int                   level) const;
 
 private:
+  /** Create the spatial object of GenerateFixedMaskSpatialObject(), which may share it. */
+  FixedMaskSpatialObjectPointer
+  CreateFixedMaskSpatialObject(const FixedMaskImageType *    maskImage,
+                               bool                          useMaskErosion,
+                               const FixedImagePyramidType * pyramid,
+                               unsigned int                  level) const;
+
+  /** Create the spatial object of GenerateMovingMaskSpatialObject(), which may share it. */
+  MovingMaskSpatialObjectPointer
+  CreateMovingMaskSpatialObject(const MovingMaskImageType *    maskImage,
+                                bool                           useMaskErosion,
+                                const MovingImagePyramidType * pyramid,
+                                unsigned int                   level) const;
+
   /** The deleted copy constructor. */
   RegistrationBase(const Self &) = delete;
   /** The deleted assignment operator. */
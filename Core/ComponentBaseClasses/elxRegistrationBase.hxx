@@ -19,6 +19,7 @@
 #define elxRegistrationBase_hxx
 
 #include "elxRegistrationBase.h"
+#include "itkSharedImageCache.h"
 
 namespace elastix
 {
@@ -106,7 +107,40 @@ RegistrationBase<TElastix>::GenerateFixedMaskSpatialObject(const FixedMaskImageT
   {
     return fixedMaskSpatialObject;
   }
-  fixedMaskSpatialObject = FixedMaskSpatialObjectType::New();
+
+  /** Share the eroded mask with the registrations of the same mask in this process.
+   * Without erosion, the spatial object refers to the mask image itself, which would
+   * then never be removed from the cache.
+   */
+  bool useSharedImageCache = false;
+  this->m_Configuration->ReadParameter(useSharedImageCache, "UseSharedImageCache", 0, false);
+  if (!useSharedImageCache || !useMaskErosion || !pyramid)
+  {
+    return this->CreateFixedMaskSpatialObject(maskImage, useMaskErosion, pyramid, level);
+  }
+
+  std::ostringstream settings;
+  settings << "FixedMaskSpatialObject erosion " << pyramid->GetSchedule() << " level " << level;
+  return itk::SharedImageCache::GetOrCreate<FixedMaskSpatialObjectType>(
+    maskImage, settings.str(), [this, maskImage, useMaskErosion, pyramid, level]() {
+      return this->CreateFixedMaskSpatialObject(maskImage, useMaskErosion, pyramid, level);
+    });
+
+} // end GenerateFixedMaskSpatialObject()
+
+
+/**
+ * ******************* CreateFixedMaskSpatialObject **********************
+ */
+
+template <class TElastix>
+typename RegistrationBase<TElastix>::FixedMaskSpatialObjectPointer
+RegistrationBase<TElastix>::CreateFixedMaskSpatialObject(const FixedMaskImageType *    maskImage,
+                                                         bool                          useMaskErosion,
+                                                         const FixedImagePyramidType * pyramid,
+                                                         unsigned int                  level) const
+{
+  FixedMaskSpatialObjectPointer fixedMaskSpatialObject = FixedMaskSpatialObjectType::New();
 
   /** Just convert to spatial object if no erosion is needed. */
   if (!useMaskErosion || !pyramid)
@@ -149,7 +183,7 @@ RegistrationBase<TElastix>::GenerateFixedMaskSpatialObject(const FixedMaskImageT
   fixedMaskSpatialObject->Update();
   return fixedMaskSpatialObject;
 
-} // end GenerateFixedMaskSpatialObject()
+} // end CreateFixedMaskSpatialObject()
 
 
 /**
@@ -168,7 +202,40 @@ RegistrationBase<TElastix>::GenerateMovingMaskSpatialObject(const MovingMaskImag
   {
     return movingMaskSpatialObject;
   }
-  movingMaskSpatialObject = MovingMaskSpatialObjectType::New();
+
+  /** Share the eroded mask with the registrations of the same mask in this process.
+   * Without erosion, the spatial object refers to the mask image itself, which would
+   * then never be removed from the cache.
+   */
+  bool useSharedImageCache = false;
+  this->m_Configuration->ReadParameter(useSharedImageCache, "UseSharedImageCache", 0, false);
+  if (!useSharedImageCache || !useMaskErosion || !pyramid)
+  {
+    return this->CreateMovingMaskSpatialObject(maskImage, useMaskErosion, pyramid, level);
+  }
+
+  std::ostringstream settings;
+  settings << "MovingMaskSpatialObject erosion " << pyramid->GetSchedule() << " level " << level;
+  return itk::SharedImageCache::GetOrCreate<MovingMaskSpatialObjectType>(
+    maskImage, settings.str(), [this, maskImage, useMaskErosion, pyramid, level]() {
+      return this->CreateMovingMaskSpatialObject(maskImage, useMaskErosion, pyramid, level);
+    });
+
+} // end GenerateMovingMaskSpatialObject()
+
+
+/**
+ * ******************* CreateMovingMaskSpatialObject **********************
+ */
+
+template <class TElastix>
+typename RegistrationBase<TElastix>::MovingMaskSpatialObjectPointer
+RegistrationBase<TElastix>::CreateMovingMaskSpatialObject(const MovingMaskImageType *    maskImage,
+                                                          bool                           useMaskErosion,
+                                                          const MovingImagePyramidType * pyramid,
+                                                          unsigned int                   level) const
+{
+  MovingMaskSpatialObjectPointer movingMaskSpatialObject = MovingMaskSpatialObjectType::New();
 
   /** Just convert to spatial object if no erosion is needed. */
   if (!useMaskErosion || !pyramid)
@@ -211,7 +278,7 @@ RegistrationBase<TElastix>::GenerateMovingMaskSpatialObject(const MovingMaskImag
   movingMaskSpatialObject->Update();
   return movingMaskSpatialObject;
 
-} // end GenerateMovingMaskSpatialObject()
+} // end CreateMovingMaskSpatialObject()
 
 
 } // end namespace elastix
@@ -25,6 +25,8 @@
 #include "itkResampleImageFilter.h"
 #include "elxProgressCommand.h"
 
+#include <cstddef> // For size_t.
+
 namespace elastix
 {
 /**
@@ -64,6 +66,15 @@ namespace elastix
  *    of the written image is desired.\n
  *    example: <tt>(CompressResultImage "true")</tt> \n
  *    The default is "false".
+ * \parameter ResultImageMemoryBudget: the maximum amount of memory, in megabytes, that
+ *    is used for the result image while it is resampled and written. When the result image
+ *    needs more, it is resampled and written in slabs, via the streaming pipeline of ITK.
+ *    Streaming requires a file format that supports streamed writing, such as uncompressed
+ *    mhd or mha. Otherwise the whole image is resampled at once. Note that the moving image
+ *    is still completely in memory. The budget also applies to the deformation field and
+ *    the spatial Jacobian images that are written by transformix.\n
+ *    example: <tt>(ResultImageMemoryBudget 4096)</tt> \n
+ *    The default is 0, which means that the memory is not limited.
  *
  * \ingroup Resamplers
  * \ingroup ComponentBaseClasses
@@ -193,6 +204,13 @@ public:
   virtual void
   CreateItkResultImage(void);
 
+  /** Get the number of slabs in which an image on the output grid of the resampler
+   * is generated and written, according to the ResultImageMemoryBudget. The size of
+   * a pixel includes all intermediate copies of the pixel, for example after casting.
+   */
+  unsigned int
+  GetNumberOfStreamDivisions(const std::size_t sizeOfPixel) const;
+
 protected:
   /** The constructor. */
   ResamplerBase();
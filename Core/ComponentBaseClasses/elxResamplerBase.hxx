@@ -24,8 +24,12 @@
 #include "itkImageFileCastWriter.h"
 #include "itkChangeInformationImageFilter.h"
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
+#include "itkRegistrationThreadState.h"
 #include "itkTimeProbe.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace elastix
 {
 
@@ -285,6 +289,12 @@ ResamplerBase<TElastix>::SetComponents(void)
 
   this->GetAsITKBaseType()->SetInput(dynamic_cast<InputImageType *>(this->m_Elastix->GetMovingImage()));
 
+  /** Limit the resampler to the threads of this registration. */
+  if (itk::RegistrationThreadState::GetMaximumNumberOfThreads() > 0)
+  {
+    this->GetAsITKBaseType()->SetNumberOfWorkUnits(itk::RegistrationThreadState::GetNumberOfThreads());
+  }
+
 } // end SetComponents()
 
 
@@ -308,21 +318,34 @@ ResamplerBase<TElastix>::ResampleAndWriteResultImage(const char * filename, cons
     progressObserver->SetEndString("%");
   }
 
-  /** Do the resampling. */
-  try
+  /** Do the resampling. When the result image is streamed, the resampling is
+   * done by the writer instead, which requests the slabs one by one. Each slab
+   * is in memory twice: once as resampled, and once as cast to the
+   * ResultImagePixelType, which takes at most the size of a double.
+   */
+  const unsigned int numberOfStreamDivisions =
+    this->GetNumberOfStreamDivisions(sizeof(OutputPixelType) + sizeof(double));
+  if (numberOfStreamDivisions > 1)
   {
-    this->GetAsITKBaseType()->Update();
+    elxout << "  Resampling and writing the result image in " << numberOfStreamDivisions << " slabs" << std::endl;
   }
-  catch (itk::ExceptionObject & excp)
+  else
   {
-    /** Add information to the exception. */
-    excp.SetLocation("ResamplerBase - WriteResultImage()");
-    std::string err_str = excp.GetDescription();
-    err_str += "\nError occurred while resampling the image.\n";
-    excp.SetDescription(err_str);
-
-    /** Pass the exception to an higher level. */
-    throw excp;
+    try
+    {
+      this->GetAsITKBaseType()->Update();
+    }
+    catch (itk::ExceptionObject & excp)
+    {
+      /** Add information to the exception. */
+      excp.SetLocation("ResamplerBase - WriteResultImage()");
+      std::string err_str = excp.GetDescription();
+      err_str += "\nError occurred while resampling the image.\n";
+      excp.SetDescription(err_str);
+
+      /** Pass the exception to an higher level. */
+      throw excp;
+    }
   }
 
   /** Perform the writing. */
@@ -397,6 +420,7 @@ ResamplerBase<TElastix>::WriteResultImage(OutputImageType * image, const char *
   writer->SetFileName(filename);
   writer->SetOutputComponentType(resultImagePixelType.c_str());
   writer->SetUseCompression(doCompression);
+  writer->SetNumberOfStreamDivisions(this->GetNumberOfStreamDivisions(sizeof(OutputPixelType) + sizeof(double)));
 
   /** Do the writing. */
   if (showProgress)
@@ -422,6 +446,38 @@ ResamplerBase<TElastix>::WriteResultImage(OutputImageType * image, const char *
 } // end WriteResultImage()
 
 
+/**
+ * ******************* GetNumberOfStreamDivisions ********************
+ */
+
+template <class TElastix>
+unsigned int
+ResamplerBase<TElastix>::GetNumberOfStreamDivisions(const std::size_t sizeOfPixel) const
+{
+  /** Read the memory budget of the output image, in megabytes. */
+  double memoryBudget = 0.0;
+  this->m_Configuration->ReadParameter(memoryBudget, "ResultImageMemoryBudget", 0, false);
+  if (!(memoryBudget > 0.0))
+  {
+    return 1;
+  }
+
+  /** Compute the size of the whole output image. */
+  const SizeType & size = this->GetAsITKBaseType()->GetSize();
+  double           numberOfBytes = static_cast<double>(sizeOfPixel);
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    numberOfBytes *= static_cast<double>(size[i]);
+  }
+
+  /** The slabs are at least one slice thick. */
+  const double numberOfDivisions = std::ceil(numberOfBytes / (memoryBudget * 1024.0 * 1024.0));
+  const double numberOfSlices = static_cast<double>(size[ImageDimension - 1]);
+  return static_cast<unsigned int>(std::max(std::min(numberOfDivisions, numberOfSlices), 1.0));
+
+} // end GetNumberOfStreamDivisions()
+
+
 /*
  * ******************* CreateItkResultImage ********************
  * \todo: avoid code duplication with WriteResultImage function
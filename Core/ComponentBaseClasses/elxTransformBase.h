@@ -30,6 +30,7 @@
 
 // ITK header files:
 #include <itkImage.h>
+#include <itkImageSource.h>
 #include <itkOptimizerParameters.h>
 
 #include <memory> // For unique_ptr.
@@ -109,6 +110,11 @@ namespace elastix
  * The location is relative to the path from where elastix/transformix is started!\n
  * Default: "NoInitialTransform", which (obviously) means that there is no initial transform
  * to be loaded.
+ * \transformparameter WriteOutputPointsOnly: Controls whether transformix writes only the
+ * transformed points to outputpoints.txt, one point per line, when transforming an input point
+ * file. Otherwise also the input points, indices and deformations are written.\n
+ * example: <tt>(WriteOutputPointsOnly "true")</tt>\n
+ * Default: false.
  *
  * The command line arguments used by this class are:
  * \commandlinearg -t0: optional argument for elastix for specifying an initial transform
@@ -121,9 +127,14 @@ namespace elastix
  *    "point", depending if the user supplies voxel indices or real world coordinates.
  *    The second line should be the number of points that should be transformed. The
  *    third and following lines give the indices or points.\n
+ *    Instead, a binary point file may be supplied, as described by itk::TransformixBinaryPointFile.
+ *    The transformed points are then written to outputpoints.bin, as binary point file that
+ *    contains only the output points. The points are transformed multi-threaded.\n
  *    It is also possible to deform all points, thereby generating a deformation field
  *    image. This is done by:\n
  *    example: <tt>-def all</tt> \n
+ *    The deformation field image is generated while it is written, in slabs when it
+ *    exceeds the ResultImageMemoryBudget of the resampler.
  *
  * \ingroup Transforms
  * \ingroup ComponentBaseClasses
@@ -188,6 +199,7 @@ public:
   /** Typedef's for TransformPointsAllPoints. */
   typedef itk::Vector<float, FixedImageDimension>          VectorPixelType;
   typedef itk::Image<VectorPixelType, FixedImageDimension> DeformationFieldImageType;
+  typedef itk::ImageSource<DeformationFieldImageType>      DeformationFieldImageSourceType;
 
   /** Typedefs needed for AutomaticScalesEstimation function */
   typedef typename RegistrationType::ITKBaseType      ITKRegistrationType;
@@ -296,6 +308,14 @@ protected:
   AutomaticScalesEstimationStackTransform(const unsigned int & numSubTransforms, ScalesType & scales) const;
 
 private:
+  /** Create the pipeline that generates the deformation field, without updating it,
+   * so that the field can be generated as a whole, or in slabs while writing it.
+   * The generator at the start of the pipeline is returned via the argument, because
+   * the pipeline only holds a weak reference to it.
+   */
+  typename DeformationFieldImageSourceType::Pointer
+  CreateDeformationFieldImageSource(itk::ProcessObject::Pointer & generator) const;
+
   /** Function to read the initial transform parameters from the specified configuration object.
    */
   void
@@ -27,6 +27,9 @@
 #include "itkPointSet.h"
 #include "itkDefaultStaticMeshTraits.h"
 #include "itkTransformixInputPointFileReader.h"
+#include "itkTransformixBinaryPointFile.h"
+#include "itkRegistrationThreadState.h"
+#include "itkWorkStealingThreadPool.h"
 #include <itksys/SystemTools.hxx>
 #include "itkVector.h"
 #include "itkTransformToDisplacementFieldFilter.h"
@@ -42,6 +45,7 @@
 #include "itkTransformMeshFilter.h"
 #include "itkCommonEnums.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iomanip> // For setprecision.
@@ -787,6 +791,10 @@ TransformBase<TElastix>::TransformPointsSomePoints(const std::string & filename)
   }
 
   /** Some user-feedback. */
+  if (ippReader->GetFileIsBinary())
+  {
+    elxout << "  Input point file is a binary point file." << std::endl;
+  }
   if (ippReader->GetPointsAreIndices())
   {
     elxout << "  Input points are specified as image indices." << std::endl;
@@ -801,13 +809,23 @@ TransformBase<TElastix>::TransformPointsSomePoints(const std::string & filename)
   /** Get the set of input points. */
   typename PointSetType::Pointer inputPointSet = ippReader->GetOutput();
 
-  /** Create the storage classes. */
-  std::vector<FixedImageIndexType>   inputindexvec(nrofpoints);
-  std::vector<InputPointType>        inputpointvec(nrofpoints);
-  std::vector<OutputPointType>       outputpointvec(nrofpoints);
-  std::vector<FixedImageIndexType>   outputindexfixedvec(nrofpoints);
-  std::vector<MovingImageIndexType>  outputindexmovingvec(nrofpoints);
-  std::vector<DeformationVectorType> deformationvec(nrofpoints);
+  /** Check whether only the output points have to be written. A binary
+   * output point file always contains only the output points.
+   */
+  const bool binaryOutput = ippReader->GetFileIsBinary();
+  bool       outputPointsOnly = false;
+  this->m_Configuration->ReadParameter(outputPointsOnly, "WriteOutputPointsOnly", 0, false);
+  const bool allFields = !binaryOutput && !outputPointsOnly;
+
+  /** Create the storage classes. Only the ones that are written are allocated. */
+  const std::size_t                  numberOfStoredFields = allFields ? nrofpoints : 0;
+  std::vector<FixedImageIndexType>   inputindexvec(numberOfStoredFields);
+  std::vector<InputPointType>        inputpointvec(numberOfStoredFields);
+  std::vector<OutputPointType>       outputpointvec(binaryOutput ? 0 : nrofpoints);
+  std::vector<FixedImageIndexType>   outputindexfixedvec(numberOfStoredFields);
+  std::vector<MovingImageIndexType>  outputindexmovingvec(numberOfStoredFields);
+  std::vector<DeformationVectorType> deformationvec(numberOfStoredFields);
+  std::vector<float>                 outputcoordinatevec(binaryOutput ? nrofpoints * FixedImageDimension : 0);
 
   /** Make a temporary image with the right region info,
    * which we can use to convert between points and indices.
@@ -826,10 +844,6 @@ TransformBase<TElastix>::TransformPointsSomePoints(const std::string & filename)
   dummyImage->SetSpacing(spacing);
   dummyImage->SetDirection(direction);
 
-  /** Temp vars */
-  FixedImageContinuousIndexType  fixedcindex;
-  MovingImageContinuousIndexType movingcindex;
-
   /** Also output moving image indices if a moving image was supplied. */
   bool                              alsoMovingIndices = false;
   typename MovingImageType::Pointer movingImage = this->GetElastix()->GetMovingImage();
@@ -838,77 +852,143 @@ TransformBase<TElastix>::TransformPointsSomePoints(const std::string & filename)
     alsoMovingIndices = true;
   }
 
-  /** Read the input points, as index or as point. */
-  if (!(ippReader->GetPointsAreIndices()))
-  {
-    for (unsigned int j = 0; j < nrofpoints; j++)
+  /** Read the input points, as index or as point, and apply the transform.
+   * The points are divided in contiguous ranges, one for each work unit.
+   */
+  elxout << "  The input points are transformed." << std::endl;
+  const bool              pointsAreIndices = ippReader->GetPointsAreIndices();
+  const itk::ThreadIdType numberOfWorkUnits = static_cast<itk::ThreadIdType>(std::max<std::size_t>(
+    std::min<std::size_t>(itk::RegistrationThreadState::GetNumberOfThreads(), nrofpoints), 1));
+  const auto              transformPoints = [this,
+                                             nrofpoints,
+                                             numberOfWorkUnits,
+                                             &inputPointSet,
+                                             &dummyImage,
+                                             &movingImage,
+                                             pointsAreIndices,
+                                             allFields,
+                                             binaryOutput,
+                                             alsoMovingIndices,
+                                             &inputindexvec,
+                                             &inputpointvec,
+                                             &outputpointvec,
+                                             &outputindexfixedvec,
+                                             &outputindexmovingvec,
+                                             &deformationvec,
+                                             &outputcoordinatevec](itk::ThreadIdType workUnit) {
+    /** Temp vars */
+    FixedImageContinuousIndexType  fixedcindex;
+    MovingImageContinuousIndexType movingcindex;
+    FixedImageIndexType            inputindex;
+    InputPointType                 inputpoint;
+
+    const std::size_t begin = static_cast<std::size_t>(workUnit) * nrofpoints / numberOfWorkUnits;
+    const std::size_t end = static_cast<std::size_t>(workUnit + 1) * nrofpoints / numberOfWorkUnits;
+    for (std::size_t j = begin; j < end; ++j)
     {
-      /** Compute index of nearest voxel in fixed image. */
       InputPointType point;
       point.Fill(0.0f);
       inputPointSet->GetPoint(j, &point);
-      inputpointvec[j] = point;
-      dummyImage->TransformPhysicalPointToContinuousIndex(point, fixedcindex);
-      for (unsigned int i = 0; i < FixedImageDimension; i++)
+      if (!pointsAreIndices)
       {
-        inputindexvec[j][i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(fixedcindex[i]));
+        /** Compute index of nearest voxel in fixed image. */
+        inputpoint = point;
+        dummyImage->TransformPhysicalPointToContinuousIndex(point, fixedcindex);
+        for (unsigned int i = 0; i < FixedImageDimension; i++)
+        {
+          inputindex[i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(fixedcindex[i]));
+        }
       }
-    }
-  }
-  else // so: inputasindex
-  {
-    for (unsigned int j = 0; j < nrofpoints; j++)
-    {
-      /** The read point from the inutPointSet is actually an index
-       * Cast to the proper type.
-       */
-      InputPointType point;
-      point.Fill(0.0f);
-      inputPointSet->GetPoint(j, &point);
+      else // so: inputasindex
+      {
+        /** The read point from the inutPointSet is actually an index
+         * Cast to the proper type.
+         */
+        for (unsigned int i = 0; i < FixedImageDimension; i++)
+        {
+          inputindex[i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(point[i]));
+        }
+        /** Compute the input point in physical coordinates. */
+        dummyImage->TransformIndexToPhysicalPoint(inputindex, inputpoint);
+      }
+
+      /** Call TransformPoint. */
+      const OutputPointType outputpoint = this->GetAsITKBaseType()->TransformPoint(inputpoint);
+      if (binaryOutput)
+      {
+        for (unsigned int i = 0; i < FixedImageDimension; i++)
+        {
+          outputcoordinatevec[j * FixedImageDimension + i] = static_cast<float>(outputpoint[i]);
+        }
+        continue;
+      }
+      outputpointvec[j] = outputpoint;
+      if (!allFields)
+      {
+        continue;
+      }
+      inputindexvec[j] = inputindex;
+      inputpointvec[j] = inputpoint;
+
+      /** Transform back to index in fixed image domain. */
+      dummyImage->TransformPhysicalPointToContinuousIndex(outputpoint, fixedcindex);
       for (unsigned int i = 0; i < FixedImageDimension; i++)
       {
-        inputindexvec[j][i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(point[i]));
+        outputindexfixedvec[j][i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(fixedcindex[i]));
       }
-      /** Compute the input point in physical coordinates. */
-      dummyImage->TransformIndexToPhysicalPoint(inputindexvec[j], inputpointvec[j]);
+
+      if (alsoMovingIndices)
+      {
+        /** Transform back to index in moving image domain. */
+        movingImage->TransformPhysicalPointToContinuousIndex(outputpoint, movingcindex);
+        for (unsigned int i = 0; i < MovingImageDimension; i++)
+        {
+          outputindexmovingvec[j][i] =
+            static_cast<MovingImageIndexValueType>(itk::Math::Round<double>(movingcindex[i]));
+        }
+      }
+
+      /** Compute displacement. */
+      deformationvec[j].CastFrom(outputpoint - inputpoint);
     }
-  }
+  };
+  itk::WorkStealingThreadPool::GetInstance()->Execute(numberOfWorkUnits, transformPoints);
 
-  /** Apply the transform. */
-  elxout << "  The input points are transformed." << std::endl;
-  for (unsigned int j = 0; j < nrofpoints; j++)
-  {
-    /** Call TransformPoint. */
-    outputpointvec[j] = this->GetAsITKBaseType()->TransformPoint(inputpointvec[j]);
+  /** Create filename and file stream. */
+  std::string outputPointsFileName = this->m_Configuration->GetCommandLineArgument("-out");
+  outputPointsFileName += binaryOutput ? "outputpoints.bin" : "outputpoints.txt";
+  elxout << "  The transformed points are saved in: " << outputPointsFileName << std::endl;
 
-    /** Transform back to index in fixed image domain. */
-    dummyImage->TransformPhysicalPointToContinuousIndex(outputpointvec[j], fixedcindex);
-    for (unsigned int i = 0; i < FixedImageDimension; i++)
+  /** Write the binary output points at once. */
+  if (binaryOutput)
+  {
+    std::ofstream outputPointsFile(outputPointsFileName, std::ios::out | std::ios::binary);
+    itk::TransformixBinaryPointFile::WriteHeader(outputPointsFile, FixedImageDimension, false, nrofpoints);
+    outputPointsFile.write(reinterpret_cast<const char *>(outputcoordinatevec.data()),
+                           static_cast<std::streamsize>(outputcoordinatevec.size() * sizeof(float)));
+    if (!outputPointsFile)
     {
-      outputindexfixedvec[j][i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(fixedcindex[i]));
+      xl::xout["error"] << "  Error while writing output point file." << std::endl;
     }
+    return;
+  }
 
-    if (alsoMovingIndices)
+  std::ofstream outputPointsFile(outputPointsFileName);
+  outputPointsFile << std::showpoint << std::fixed;
+
+  /** Print only the output points, one point per line. */
+  if (outputPointsOnly)
+  {
+    for (unsigned int j = 0; j < nrofpoints; j++)
     {
-      /** Transform back to index in moving image domain. */
-      movingImage->TransformPhysicalPointToContinuousIndex(outputpointvec[j], movingcindex);
-      for (unsigned int i = 0; i < MovingImageDimension; i++)
+      for (unsigned int i = 0; i < FixedImageDimension; i++)
       {
-        outputindexmovingvec[j][i] = static_cast<MovingImageIndexValueType>(itk::Math::Round<double>(movingcindex[i]));
+        outputPointsFile << outputpointvec[j][i] << (i + 1 < FixedImageDimension ? " " : "\n");
       }
     }
-
-    /** Compute displacement. */
-    deformationvec[j].CastFrom(outputpointvec[j] - inputpointvec[j]);
+    return;
   }
 
-  /** Create filename and file stream. */
-  std::string outputPointsFileName = this->m_Configuration->GetCommandLineArgument("-out");
-  outputPointsFileName += "outputpoints.txt";
-  std::ofstream outputPointsFile(outputPointsFileName);
-  outputPointsFile << std::showpoint << std::fixed;
-  elxout << "  The transformed points are saved in: " << outputPointsFileName << std::endl;
-
   /** Print the results. */
   for (unsigned int j = 0; j < nrofpoints; j++)
   {
@@ -957,7 +1037,7 @@ TransformBase<TElastix>::TransformPointsSomePoints(const std::string & filename)
       }
     }
 
-    outputPointsFile << "]" << std::endl;
+    outputPointsFile << "]\n";
   } // end for nrofpoints
 
 } // end TransformPointsSomePoints()
@@ -1054,29 +1134,33 @@ template <class TElastix>
 void
 TransformBase<TElastix>::TransformPointsAllPoints(void) const
 {
-  typename DeformationFieldImageType::Pointer deformationfield = this->GenerateDeformationFieldImage();
-  // put deformation field in container
-  this->m_Elastix->SetResultDeformationField(deformationfield.GetPointer());
-
-  if (!BaseComponent::IsElastixLibrary())
+  /** The library interface returns the whole deformation field. */
+  if (BaseComponent::IsElastixLibrary())
   {
-    WriteDeformationFieldImage(deformationfield);
+    typename DeformationFieldImageType::Pointer deformationfield = this->GenerateDeformationFieldImage();
+    // put deformation field in container
+    this->m_Elastix->SetResultDeformationField(deformationfield.GetPointer());
+    return;
   }
 
+  /** Otherwise the deformation field is only generated while it is written,
+   * possibly in slabs, so that it does not need to fit in memory.
+   */
+  itk::ProcessObject::Pointer generator;
+  const auto                  defSource = this->CreateDeformationFieldImageSource(generator);
+  const auto                  progressObserver = ProgressCommandType::CreateAndConnect(*generator);
+  this->WriteDeformationFieldImage(defSource->GetOutput());
+
 } // end TransformPointsAllPoints()
 
 
 /**
- * ************** GenerateDeformationFieldImage **********************
- *
- * This function transforms all indexes to a physical point.
- * The difference vector (= the deformation at that index) is
- * stored in an image of vectors (of floats).
+ * ************** CreateDeformationFieldImageSource **********************
  */
 
 template <class TElastix>
-typename TransformBase<TElastix>::DeformationFieldImageType::Pointer
-TransformBase<TElastix>::GenerateDeformationFieldImage(void) const
+typename TransformBase<TElastix>::DeformationFieldImageSourceType::Pointer
+TransformBase<TElastix>::CreateDeformationFieldImageSource(itk::ProcessObject::Pointer & generator) const
 {
   /** Typedef's. */
   typedef typename FixedImageType::DirectionType FixedImageDirectionType;
@@ -1092,6 +1176,7 @@ TransformBase<TElastix>::GenerateDeformationFieldImage(void) const
   defGenerator->SetOutputStartIndex(this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType()->GetOutputStartIndex());
   defGenerator->SetOutputDirection(this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType()->GetOutputDirection());
   defGenerator->SetTransform(const_cast<const ITKBaseType *>(this->GetAsITKBaseType()));
+  generator = defGenerator;
 
   /** Possibly change direction cosines to their original value, as specified
    * in the tp-file, or by the fixed image. This is only necessary when
@@ -1103,13 +1188,33 @@ TransformBase<TElastix>::GenerateDeformationFieldImage(void) const
   infoChanger->SetChangeDirection(retdc & !this->GetElastix()->GetUseDirectionCosines());
   infoChanger->SetInput(defGenerator->GetOutput());
 
+  return infoChanger.GetPointer();
+} // end CreateDeformationFieldImageSource()
+
+
+/**
+ * ************** GenerateDeformationFieldImage **********************
+ *
+ * This function transforms all indexes to a physical point.
+ * The difference vector (= the deformation at that index) is
+ * stored in an image of vectors (of floats).
+ */
+
+template <class TElastix>
+typename TransformBase<TElastix>::DeformationFieldImageType::Pointer
+TransformBase<TElastix>::GenerateDeformationFieldImage(void) const
+{
+  /** Create the pipeline that generates the deformation field. */
+  itk::ProcessObject::Pointer generator;
+  const auto                  defSource = this->CreateDeformationFieldImageSource(generator);
+
   /** Track the progress of the generation of the deformation field. */
   const auto progressObserver =
-    BaseComponent::IsElastixLibrary() ? nullptr : ProgressCommandType::CreateAndConnect(*defGenerator);
+    BaseComponent::IsElastixLibrary() ? nullptr : ProgressCommandType::CreateAndConnect(*generator);
 
   try
   {
-    infoChanger->Update();
+    defSource->Update();
   }
   catch (itk::ExceptionObject & excp)
   {
@@ -1123,7 +1228,7 @@ TransformBase<TElastix>::GenerateDeformationFieldImage(void) const
     throw excp;
   }
 
-  return infoChanger->GetOutput();
+  return defSource->GetOutput();
 } // end GenerateDeformationFieldImage()
 
 
@@ -1148,6 +1253,8 @@ TransformBase<TElastix>::WriteDeformationFieldImage(
   const auto defWriter = DeformationFieldWriterType::New();
   defWriter->SetInput(deformationfield);
   defWriter->SetFileName(makeFileName.str().c_str());
+  defWriter->SetNumberOfStreamDivisions(
+    this->m_Elastix->GetElxResamplerBase()->GetNumberOfStreamDivisions(sizeof(VectorPixelType)));
 
   /** Do the writing. */
   elxout << "  Computing and writing the deformation field ..." << std::endl;
@@ -1237,6 +1344,8 @@ TransformBase<TElastix>::ComputeDeterminantOfSpatialJacobian(void) const
   const auto jacWriter = JacobianWriterType::New();
   jacWriter->SetInput(infoChanger->GetOutput());
   jacWriter->SetFileName(makeFileName.str().c_str());
+  jacWriter->SetNumberOfStreamDivisions(
+    this->m_Elastix->GetElxResamplerBase()->GetNumberOfStreamDivisions(sizeof(typename JacobianImageType::PixelType)));
 
   /** Do the writing. */
   elxout << "  Computing and writing the spatial Jacobian determinant..." << std::endl;
@@ -1324,6 +1433,8 @@ TransformBase<TElastix>::ComputeSpatialJacobian(void) const
   const auto jacWriter = JacobianWriterType::New();
   jacWriter->SetInput(infoChanger->GetOutput());
   jacWriter->SetFileName(makeFileName.str().c_str());
+  jacWriter->SetNumberOfStreamDivisions(
+    this->m_Elastix->GetElxResamplerBase()->GetNumberOfStreamDivisions(sizeof(typename JacobianImageType::PixelType)));
   /** Hack to change the pixel type to vector. Not necessary for mhd. */
   const auto jacStartWriteCommand = PixelTypeChangeCommandType::New();
   if (resultImageFormat != "mhd")
@@ -18,7 +18,24 @@
 #include "elxElastixBase.h"
 #include <Core/elxVersionMacros.h>
 #include <sstream>
-#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkRegistrationThreadState.h"
+#include "itkWorkStealingThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  ifndef PSAPI_VERSION
+#    define PSAPI_VERSION 2 // GetProcessMemoryInfo() from kernel32, without linking psapi.
+#  endif
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <sys/resource.h>
+#endif
 
 namespace elastix
 {
@@ -191,6 +208,85 @@ ElastixBase::GenerateDataObjectContainer(DataObjectPointer dataObject)
 }
 
 
+/**
+ * ********************* ExecuteImageReadTasks ***********************
+ */
+
+void
+ElastixBase::ExecuteImageReadTasks(ImageReadTaskContainerType & tasks, unsigned int maximumNumberOfThreads)
+{
+  if (tasks.empty())
+  {
+    return;
+  }
+  if (maximumNumberOfThreads == 0)
+  {
+    maximumNumberOfThreads = itk::RegistrationThreadState::GetNumberOfThreads();
+  }
+  const itk::ThreadIdType numberOfWorkUnits = static_cast<itk::ThreadIdType>(
+    std::max<std::size_t>(std::min<std::size_t>(maximumNumberOfThreads, tasks.size()), 1));
+
+  /** The image IO factories are registered at the first request. Do that now,
+   * before the readers request them concurrently.
+   */
+  itk::ObjectFactoryBase::CreateAllInstance("itkImageIOBase");
+
+  /** Each work unit takes the next task that is not yet started, so that
+   * a large file does not delay the files behind it.
+   */
+  std::atomic<std::size_t> nextTask(0);
+  const auto               executeTasks = [&tasks, &nextTask](itk::ThreadIdType) {
+    for (std::size_t i = nextTask++; i < tasks.size(); i = nextTask++)
+    {
+      itk::TimeProbe timer;
+      timer.Start();
+      tasks[i].ReadFunction();
+      timer.Stop();
+      tasks[i].ReadTime = timer.GetMean();
+    }
+  };
+  itk::WorkStealingThreadPool::GetInstance()->Execute(numberOfWorkUnits, executeTasks);
+
+  /** Print the time spent on each file. */
+  for (const auto & task : tasks)
+  {
+    elxout << "  Reading " << task.ImageDescription << " " << task.FileName << " took "
+           << static_cast<unsigned long>(task.ReadTime * 1000) << " ms." << std::endl;
+  }
+
+} // end ExecuteImageReadTasks()
+
+
+/**
+ * ********************* GetPeakMemoryUsage ***********************
+ */
+
+std::size_t
+ElastixBase::GetPeakMemoryUsage(void)
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+  {
+    return static_cast<std::size_t>(counters.PeakWorkingSetSize / 1024);
+  }
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+  {
+#  if defined(__APPLE__)
+    /** On macOS the maximum resident set size is in bytes, elsewhere in kilobytes. */
+    return static_cast<std::size_t>(usage.ru_maxrss / 1024);
+#  else
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#  endif
+  }
+#endif
+  return 0;
+
+} // end GetPeakMemoryUsage()
+
+
 /**
  * ********************* SetDBIndex ***********************
  */
@@ -350,12 +446,13 @@ ElastixBase::BeforeAllBase(void)
   /** Set the random seed. Use 121212 as a default, which is the same as
    * the default in the MersenneTwister code.
    * Use silent parameter file readout, to avoid annoying warning when
-   * starting elastix */
-  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
-  typedef RandomGeneratorType::IntegerType                       SeedType;
-  unsigned int                                                   randomSeed = 121212;
+   * starting elastix. The random generator is the one of this thread, so
+   * registrations on other threads do not disturb its sequence. */
+  typedef itk::RegistrationThreadState::RandomGeneratorType RandomGeneratorType;
+  typedef RandomGeneratorType::IntegerType                  SeedType;
+  unsigned int                                              randomSeed = 121212;
   this->GetConfiguration()->ReadParameter(randomSeed, "RandomSeed", 0, false);
-  RandomGeneratorType::Pointer randomGenerator = RandomGeneratorType::GetInstance();
+  RandomGeneratorType::Pointer randomGenerator = itk::RegistrationThreadState::GetRandomGenerator();
   randomGenerator->SetSeed(static_cast<SeedType>(randomSeed));
 
   /** Return a value. */
@@ -38,12 +38,16 @@
 #include <itkChangeInformationImageFilter.h>
 #include <itkDataObject.h>
 #include <itkImageFileReader.h>
+#include <itkMemoryMappedImageFileReader.h>
 #include <itkObject.h>
 #include <itkTimeProbe.h>
 #include <itkVectorContainer.h>
 
 #include <fstream>
+#include <functional>
 #include <iomanip>
+#include <string>
+#include <vector>
 
 /** Like itkGet/SetObjectMacro, but in these macros the itkDebugMacro is
  * not called. Besides, they are not virtual, since
@@ -97,6 +101,37 @@ namespace elastix
  *   Most importantly, it affects the output precision of the parameters in the transform parameter file.\n
  *   example: <tt>(DefaultOutputPrecision 6)</tt>\n
  *   Default value: 6.
+ * \parameter MemoryMapInputImages: Whether uncompressed MetaImage input images and masks are
+ *   memory mapped instead of read into memory, see itk::MemoryMappedImageFileReader. The pixels are
+ *   then read lazily, and shared between processes that read the same file. This parameter is also
+ *   used by transformix, for the input image.\n
+ *   example: <tt>(MemoryMapInputImages "true")</tt>\n
+ *   Default value: false.
+ * \parameter NumberOfImageReaderThreads: The maximum number of image and mask files that elastix
+ *   reads at the same time.\n
+ *   example: <tt>(NumberOfImageReaderThreads 4)</tt>\n
+ *   Default value: 0, which means the default number of threads.
+ * \parameter ComputePyramidImagesPerResolution: Besides computing the pyramid images of the
+ *   generic pyramids per resolution, elastix then releases the pyramid images and the B-spline
+ *   coefficient images of the interpolators after each resolution, such that only the images of
+ *   the current resolution are kept in memory. The peak memory use is printed after each resolution.\n
+ *   example: <tt>(ComputePyramidImagesPerResolution "true")</tt>\n
+ *   Default value: false.
+ * \parameter UseSharedImageCache: Whether products that are derived from the input images are
+ *   shared with the other registrations in the same process, through the itk::SharedImageCache.
+ *   This saves setup time and memory when many registrations use the same image, for example an
+ *   atlas. Shared are the images of the generic pyramids, the B-spline coefficient images of the
+ *   interpolators, the moving image gradient of the advanced metrics, and the eroded masks.\n
+ *   example: <tt>(UseSharedImageCache "true")</tt>\n
+ *   Default value: false.
+ * \parameter WriteTimingProfile: Whether the time spent in the phases of the metrics and the optimizer
+ *   is measured, and written after each resolution to the file TimingProfile.<ElastixLevel>.R<Resolution>.json,
+ *   next to the IterationInfo file. The phases are sampling, transform point, Jacobian, interpolation,
+ *   derivative accumulation, optimizer step and step size estimation. The times are summed over all
+ *   threads, see itk::TimingProfile. Measuring the phases that are done for each sample takes some time
+ *   itself, so the registration is slower with this parameter.\n
+ *   example: <tt>(WriteTimingProfile "true")</tt>\n
+ *   Default value: false.
  *
  * The command line arguments used by this class are:
  * \commandlinearg -f: mandatory argument for elastix with the file name of the fixed image. \n
@@ -428,6 +463,31 @@ protected:
 
   std::ofstream m_IterationInfoFile;
 
+  /** A task that reads one image file, as created by MultipleImageLoader::AddImageReadTasks(). */
+  struct ImageReadTask
+  {
+    std::string           FileName;
+    std::string           ImageDescription;
+    std::function<void()> ReadFunction;
+    double                ReadTime{ 0.0 };
+  };
+  typedef std::vector<ImageReadTask> ImageReadTaskContainerType;
+
+  /** Executes the image read tasks concurrently, reading at most maximumNumberOfThreads
+   * files at the same time. Zero selects the number of threads of the registration
+   * on the calling thread, see itk::RegistrationThreadState. The time spent
+   * on each file is printed afterwards. An exception thrown while reading a file is
+   * passed to the caller, after all tasks have finished.
+   */
+  static void
+  ExecuteImageReadTasks(ImageReadTaskContainerType & tasks, unsigned int maximumNumberOfThreads = 0);
+
+  /** Returns the peak memory use (the maximum resident set size) of this process
+   * so far, in kilobytes. Returns zero when it cannot be determined.
+   */
+  static std::size_t
+  GetPeakMemoryUsage(void);
+
   /** Convenient mini class to load the files specified by a filename container
    * The function GenerateImageContainer can be used without instantiating an
    * object of this class, since it is static. It has 2 arguments: the
@@ -436,9 +496,16 @@ protected:
    * includes this short description and the fileName which caused the error.
    * See ElastixTemplate::Run() for an example of usage.
    *
+   * The files are read concurrently. To read the files of several filename containers
+   * at the same time, first call AddImageReadTasks() for each of them, and then
+   * ExecuteImageReadTasks() once. The returned containers are filled by the latter.
+   *
    * The useDirection option is built in as a means to ignore the direction
    * cosines. Set it to false to force the direction cosines to identity.
    * The original direction cosines are returned separately.
+   *
+   * With the memoryMapImages option, uncompressed MetaImage files are memory
+   * mapped by the MemoryMappedImageFileReader.
    */
   template <class TImage>
   class MultipleImageLoader
@@ -450,54 +517,106 @@ protected:
     GenerateImageContainer(const FileNameContainerType * const fileNameContainer,
                            const std::string &                 imageDescription,
                            bool                                useDirectionCosines,
-                           DirectionType *                     originalDirectionCosines = nullptr)
+                           DirectionType *                     originalDirectionCosines = nullptr,
+                           bool                                memoryMapImages = false)
+    {
+      ImageReadTaskContainerType tasks;
+      const auto                 imageContainer = AddImageReadTasks(
+        fileNameContainer, imageDescription, useDirectionCosines, tasks, originalDirectionCosines, memoryMapImages);
+      ExecuteImageReadTasks(tasks);
+      return imageContainer;
+
+    } // end static method GenerateImageContainer
+
+
+    /** Adds a task for each file to the tasks, and returns the image container that these
+     * tasks fill. The original direction cosines are the ones of the last file, like before.
+     */
+    static DataObjectContainerPointer
+    AddImageReadTasks(const FileNameContainerType * const fileNameContainer,
+                      const std::string &                 imageDescription,
+                      bool                                useDirectionCosines,
+                      ImageReadTaskContainerType &        tasks,
+                      DirectionType *                     originalDirectionCosines = nullptr,
+                      bool                                memoryMapImages = false)
     {
       const auto imageContainer = DataObjectContainerType::New();
+      imageContainer->Reserve(fileNameContainer->Size());
 
-      /** Loop over all image filenames. */
-      for (const auto & fileName : *fileNameContainer)
+      /** Each task stores its image at its own position in the container. */
+      for (unsigned int i = 0; i < fileNameContainer->Size(); ++i)
       {
-        /** Setup reader. */
-        const auto imageReader = itk::ImageFileReader<TImage>::New();
-        imageReader->SetFileName(fileName);
-        const auto    infoChanger = itk::ChangeInformationImageFilter<TImage>::New();
-        DirectionType direction;
-        direction.SetIdentity();
-        infoChanger->SetOutputDirection(direction);
-        infoChanger->SetChangeDirection(!useDirectionCosines);
-        infoChanger->SetInput(imageReader->GetOutput());
-
-        /** Do the reading. */
-        try
-        {
-          infoChanger->Update();
-        }
-        catch (itk::ExceptionObject & excp)
-        {
-          /** Add information to the exception. */
-          std::string err_str = excp.GetDescription();
-          err_str += "\nError occurred while reading the image described as " + imageDescription + ", with file name " +
-                     imageReader->GetFileName() + "\n";
-          excp.SetDescription(err_str);
-          /** Pass the exception to the caller of this function. */
-          throw excp;
-        }
-
-        /** Store loaded image in the image container, as a DataObjectPointer. */
-        const auto image = infoChanger->GetOutput();
-        imageContainer->push_back(image);
-
-        /** Store the original direction cosines */
-        if (originalDirectionCosines != nullptr)
-        {
-          *originalDirectionCosines = imageReader->GetOutput()->GetDirection();
-        }
-
-      } // end for
-
+        const std::string         fileName = fileNameContainer->ElementAt(i);
+        DirectionType *           direction = i + 1 == fileNameContainer->Size() ? originalDirectionCosines : nullptr;
+        DataObjectContainerType * container = imageContainer.GetPointer();
+
+        ImageReadTask task;
+        task.FileName = fileName;
+        task.ImageDescription = imageDescription;
+        task.ReadFunction =
+          [fileName, imageDescription, useDirectionCosines, direction, memoryMapImages, container, i]() {
+            container->SetElement(
+              i, ReadImage(fileName, imageDescription, useDirectionCosines, direction, memoryMapImages));
+          };
+        tasks.push_back(task);
+      }
       return imageContainer;
 
-    } // end static method GenerateImageContainer
+    } // end static method AddImageReadTasks
+
+
+    /** Reads one image file. */
+    static DataObjectPointer
+    ReadImage(const std::string & fileName,
+              const std::string & imageDescription,
+              bool                useDirectionCosines,
+              DirectionType *     originalDirectionCosines,
+              bool                memoryMapImages = false)
+    {
+      /** Setup reader. */
+      typename itk::ImageFileReader<TImage>::Pointer imageReader;
+      if (memoryMapImages)
+      {
+        imageReader = itk::MemoryMappedImageFileReader<TImage>::New();
+      }
+      else
+      {
+        imageReader = itk::ImageFileReader<TImage>::New();
+      }
+      imageReader->SetFileName(fileName);
+      const auto    infoChanger = itk::ChangeInformationImageFilter<TImage>::New();
+      DirectionType direction;
+      direction.SetIdentity();
+      infoChanger->SetOutputDirection(direction);
+      infoChanger->SetChangeDirection(!useDirectionCosines);
+      infoChanger->SetInput(imageReader->GetOutput());
+
+      /** Do the reading. */
+      try
+      {
+        infoChanger->Update();
+      }
+      catch (itk::ExceptionObject & excp)
+      {
+        /** Add information to the exception. */
+        std::string err_str = excp.GetDescription();
+        err_str += "\nError occurred while reading the image described as " + imageDescription + ", with file name " +
+                   imageReader->GetFileName() + "\n";
+        excp.SetDescription(err_str);
+        /** Pass the exception to the caller of this function. */
+        throw excp;
+      }
+
+      /** Store the original direction cosines */
+      if (originalDirectionCosines != nullptr)
+      {
+        *originalDirectionCosines = imageReader->GetOutput()->GetDirection();
+      }
+
+      /** Return the loaded image, as a DataObjectPointer. */
+      return infoChanger->GetOutput();
+
+    } // end static method ReadImage
 
 
     MultipleImageLoader() = default;
@@ -29,6 +29,7 @@
 
 #include "elxMacro.h"
 #include "itkPlatformMultiThreader.h"
+#include "itkRegistrationThreadState.h"
 
 #ifdef ELASTIX_USE_OPENCL
 #  include "itkOpenCLContext.h"
@@ -908,10 +909,21 @@ ElastixMain::SetMaximumNumberOfThreads(void) const
   /** Get the number of threads from the command line. */
   std::string maximumNumberOfThreadsString = this->m_Configuration->GetCommandLineArgument("-threads");
 
-  /** If supplied, set the maximum number of threads. */
-  if (maximumNumberOfThreadsString != "")
+  /** If supplied, set the maximum number of threads. The maximum only applies to
+   * the registration on this thread, such that registrations that run concurrently
+   * on other threads keep their own maximum. Otherwise the maximum of a previous
+   * registration on this thread is reset.
+   */
+  const int maximumNumberOfThreads =
+    maximumNumberOfThreadsString.empty() ? 0 : atoi(maximumNumberOfThreadsString.c_str());
+  itk::RegistrationThreadState::SetMaximumNumberOfThreads(
+    maximumNumberOfThreads > 0 ? static_cast<itk::ThreadIdType>(maximumNumberOfThreads) : 0);
+
+  /** The elastix and transformix executables run a single registration per process,
+   * so they can also limit the threads of the ITK filters, by the global maximum.
+   */
+  if (maximumNumberOfThreads > 0 && !BaseComponent::IsElastixLibrary())
   {
-    const int maximumNumberOfThreads = atoi(maximumNumberOfThreadsString.c_str());
     itk::MultiThreaderBase::SetGlobalMaximumNumberOfThreads(maximumNumberOfThreads);
   }
 } // end SetMaximumNumberOfThreads()
@@ -306,6 +306,8 @@ public:
   /** Set maximum number of threads, which is read from the command line arguments.
    * Syntax:
    * -threads \<int\>
+   * The maximum is set for the registration on the calling thread, see
+   * itk::RegistrationThreadState. The executables also set it as the global maximum of ITK.
    */
   virtual void
   SetMaximumNumberOfThreads(void) const;
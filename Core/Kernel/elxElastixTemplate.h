@@ -26,6 +26,7 @@
 #include "itkImage.h"
 #include "itkImageFileReader.h"
 #include "itkImageToImageMetric.h"
+#include "itkMemoryUsageObserver.h"
 
 #include "elxRegistrationBase.h"
 #include "elxFixedImagePyramidBase.h"
@@ -38,6 +39,7 @@
 #include "elxResampleInterpolatorBase.h"
 #include "elxTransformBase.h"
 
+#include <locale>
 #include <sstream>
 
 /**
@@ -276,6 +278,10 @@ private:
   void
   OpenIterationInfoFile(void);
 
+  /** Write the timing profiles of the metrics and the optimizer of the current resolution. */
+  void
+  WriteTimingProfile(void);
+
   /** Used by the callback functions, BeforeEachResolution() etc.).
    * This method calls a function in each component, in the following order:
    * \li Registration
@@ -152,13 +152,44 @@ ElastixTemplate<TFixedImage, TMovingImage>::Run(void)
   this->m_Timer0.Start();
   elxout << "\nReading images..." << std::endl;
 
-  /** Read images and masks, if not set already. */
-  const bool              useDirCos = this->GetUseDirectionCosines();
-  FixedImageDirectionType fixDirCos;
+  /** Read images and masks, if not set already. All files are read concurrently. */
+  const bool                 useDirCos = this->GetUseDirectionCosines();
+  bool                       memoryMapImages = false;
+  FixedImageDirectionType    fixDirCos;
+  ImageReadTaskContainerType readTasks;
+  DataObjectContainerPointer fixedImageContainer;
+  DataObjectContainerPointer movingImageContainer;
+  DataObjectContainerPointer fixedMaskContainer;
+  DataObjectContainerPointer movingMaskContainer;
+  this->GetConfiguration()->ReadParameter(memoryMapImages, "MemoryMapInputImages", 0, false);
   if (this->GetFixedImage() == nullptr)
   {
-    this->SetFixedImageContainer(MultipleImageLoader<FixedImageType>::GenerateImageContainer(
-      this->GetFixedImageFileNameContainer(), "Fixed Image", useDirCos, &fixDirCos));
+    fixedImageContainer = MultipleImageLoader<FixedImageType>::AddImageReadTasks(
+      this->GetFixedImageFileNameContainer(), "Fixed Image", useDirCos, readTasks, &fixDirCos, memoryMapImages);
+  }
+  if (this->GetMovingImage() == nullptr)
+  {
+    movingImageContainer = MultipleImageLoader<MovingImageType>::AddImageReadTasks(
+      this->GetMovingImageFileNameContainer(), "Moving Image", useDirCos, readTasks, nullptr, memoryMapImages);
+  }
+  if (this->GetFixedMask() == nullptr)
+  {
+    fixedMaskContainer = MultipleImageLoader<FixedMaskType>::AddImageReadTasks(
+      this->GetFixedMaskFileNameContainer(), "Fixed Mask", useDirCos, readTasks, nullptr, memoryMapImages);
+  }
+  if (this->GetMovingMask() == nullptr)
+  {
+    movingMaskContainer = MultipleImageLoader<MovingMaskType>::AddImageReadTasks(
+      this->GetMovingMaskFileNameContainer(), "Moving Mask", useDirCos, readTasks, nullptr, memoryMapImages);
+  }
+
+  unsigned int numberOfImageReaderThreads = 0;
+  this->GetConfiguration()->ReadParameter(numberOfImageReaderThreads, "NumberOfImageReaderThreads", 0, false);
+  ExecuteImageReadTasks(readTasks, numberOfImageReaderThreads);
+
+  if (fixedImageContainer.IsNotNull())
+  {
+    this->SetFixedImageContainer(fixedImageContainer);
     this->SetOriginalFixedImageDirection(fixDirCos);
   }
   else
@@ -173,21 +204,17 @@ ElastixTemplate<TFixedImage, TMovingImage>::Run(void)
     fixDirCos = fixedIm->GetDirection();
     this->SetOriginalFixedImageDirection(fixDirCos);
   }
-
-  if (this->GetMovingImage() == nullptr)
+  if (movingImageContainer.IsNotNull())
   {
-    this->SetMovingImageContainer(MultipleImageLoader<MovingImageType>::GenerateImageContainer(
-      this->GetMovingImageFileNameContainer(), "Moving Image", useDirCos));
+    this->SetMovingImageContainer(movingImageContainer);
   }
-  if (this->GetFixedMask() == nullptr)
+  if (fixedMaskContainer.IsNotNull())
   {
-    this->SetFixedMaskContainer(MultipleImageLoader<FixedMaskType>::GenerateImageContainer(
-      this->GetFixedMaskFileNameContainer(), "Fixed Mask", useDirCos));
+    this->SetFixedMaskContainer(fixedMaskContainer);
   }
-  if (this->GetMovingMask() == nullptr)
+  if (movingMaskContainer.IsNotNull())
   {
-    this->SetMovingMaskContainer(MultipleImageLoader<MovingMaskType>::GenerateImageContainer(
-      this->GetMovingMaskFileNameContainer(), "Moving Mask", useDirCos));
+    this->SetMovingMaskContainer(movingMaskContainer);
   }
 
   /** Print the time spent on reading images. */
@@ -284,10 +311,12 @@ ElastixTemplate<TFixedImage, TMovingImage>::ApplyTransform(void)
 
     /** Load the image from disk, if it wasn't set already by the user. */
     const bool useDirCos = this->GetUseDirectionCosines();
+    bool       memoryMapImages = false;
+    this->GetConfiguration()->ReadParameter(memoryMapImages, "MemoryMapInputImages", 0, false);
     if (this->GetMovingImage() == nullptr)
     {
       this->SetMovingImageContainer(MultipleImageLoader<MovingImageType>::GenerateImageContainer(
-        this->GetMovingImageFileNameContainer(), "Input Image", useDirCos));
+        this->GetMovingImageFileNameContainer(), "Input Image", useDirCos, nullptr, memoryMapImages));
     } // end if !moving image
 
     /** Tell the user. */
@@ -583,6 +612,42 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterEachResolution(void)
   CallInEachComponent(&BaseComponentType::AfterEachResolutionBase);
   CallInEachComponent(&BaseComponentType::AfterEachResolution);
 
+  /** Write the time spent in the phases of the metrics and the optimizer. */
+  bool writeTimingProfile = false;
+  this->GetConfiguration()->ReadParameter(writeTimingProfile, "WriteTimingProfile", 0, false);
+  if (writeTimingProfile)
+  {
+    this->WriteTimingProfile();
+  }
+
+  /** When the pyramid images are computed per resolution, release the images
+   * of this resolution: the pyramid images and the B-spline coefficients of the
+   * interpolators are computed again for the next resolution anyway.
+   */
+  bool computePyramidImagesPerResolution = false;
+  this->GetConfiguration()->ReadParameter(
+    computePyramidImagesPerResolution, "ComputePyramidImagesPerResolution", 0, false);
+  if (computePyramidImagesPerResolution)
+  {
+    for (unsigned int i = 0; i < this->GetNumberOfFixedImagePyramids(); ++i)
+    {
+      this->GetElxFixedImagePyramidBase(i)->ReleasePyramidImage(level);
+    }
+    for (unsigned int i = 0; i < this->GetNumberOfMovingImagePyramids(); ++i)
+    {
+      this->GetElxMovingImagePyramidBase(i)->ReleasePyramidImage(level);
+    }
+    for (unsigned int i = 0; i < this->GetNumberOfInterpolators(); ++i)
+    {
+      this->GetElxInterpolatorBase(i)->ReleaseMemory();
+    }
+  }
+
+  /** Print the peak memory use. */
+  itk::MemoryUsageObserver memoryUsageObserver;
+  elxout << "Peak memory use after resolution " << level << ": " << this->GetPeakMemoryUsage() / 1024
+         << " MB (currently " << memoryUsageObserver.GetMemoryUsage() / 1024 << " MB).\n";
+
   /** Create a TransformParameter-file for the current resolution. */
   bool writeTransformParameterEachResolution = false;
   this->GetConfiguration()->ReadParameter(
@@ -1039,6 +1104,68 @@ ElastixTemplate<TFixedImage, TMovingImage>::OpenIterationInfoFile(void)
 } // end OpenIterationInfoFile()
 
 
+/**
+ * ************** WriteTimingProfile *************************
+ *
+ * Write a file called TimingProfile.<ElastixLevel>.R<Resolution>.json,
+ * with the timing profiles of the metrics and the optimizer.
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ElastixTemplate<TFixedImage, TMovingImage>::WriteTimingProfile(void)
+{
+  const unsigned long level = this->GetElxRegistrationBase()->GetAsITKBaseType()->GetCurrentLevel();
+
+  /** Create the TimingProfile filename for this resolution. */
+  std::ostringstream makeFileName("");
+  makeFileName << this->m_Configuration->GetCommandLineArgument("-out") << "TimingProfile."
+               << this->m_Configuration->GetElastixLevel() << ".R" << level << ".json";
+  std::string fileName = makeFileName.str();
+
+  std::ofstream timingProfileFile(fileName.c_str());
+  if (!timingProfileFile.is_open())
+  {
+    xl::xout["error"] << "ERROR: File \"" << fileName << "\" could not be opened!" << std::endl;
+    return;
+  }
+  timingProfileFile.imbue(std::locale::classic());
+  timingProfileFile.precision(9);
+
+  timingProfileFile << "{\n"
+                    << "  \"ElastixLevel\": " << this->m_Configuration->GetElastixLevel() << ",\n"
+                    << "  \"Resolution\": " << level << ",\n"
+                    << "  \"NumberOfIterations\": " << this->m_IterationCounter << ",\n"
+                    << "  \"ResolutionWallTime\": " << this->m_ResolutionTimer.GetMean() << ",\n"
+                    << "  \"Components\": [";
+
+  /** Write one object for each component that has a timing profile. */
+  const char * separator = "\n";
+  const auto   writeComponent = [&timingProfileFile, &separator](const BaseComponentType *  component,
+                                                                const itk::TimingProfile * timingProfile) {
+    if (timingProfile != nullptr)
+    {
+      timingProfileFile << separator << "    { \"Component\": \"" << component->GetComponentLabel()
+                        << "\", \"Name\": \"" << component->elxGetClassName() << "\", \"Phases\": ";
+      timingProfile->WriteJSON(timingProfileFile);
+      timingProfileFile << " }";
+      separator = ",\n";
+    }
+  };
+  for (unsigned int i = 0; i < this->GetNumberOfMetrics(); ++i)
+  {
+    writeComponent(this->GetElxMetricBase(i), this->GetElxMetricBase(i)->GetAdvancedMetricTimingProfile());
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfOptimizers(); ++i)
+  {
+    writeComponent(this->GetElxOptimizerBase(i), this->GetElxOptimizerBase(i)->GetScaledOptimizerTimingProfile());
+  }
+
+  timingProfileFile << "\n  ]\n}\n";
+
+} // end WriteTimingProfile()
+
+
 /**
  * ************** GetOriginalFixedImageDirection *********************
  * Determine the original fixed image direction (it might have been
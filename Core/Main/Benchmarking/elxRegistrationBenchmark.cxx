@@ -0,0 +1,391 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Registration throughput benchmark. Registers synthetic fixed and moving images with representative parameter maps,
+// and reports the time per resolution, the number of iterations per second, the peak memory use and the final metric
+// value of each registration. The images are synthesized in memory, so no data is needed.
+//
+// Besides the options of Google Benchmark, the following options are supported:
+//   --sizes2d=<n,...>        image sizes of the 2D registrations (default: 128,256)
+//   --sizes3d=<n,...>        image sizes of the 3D registrations (default: 64,96)
+//   --threads=<n,...>        numbers of threads, zero selects all threads (default: 0)
+//   --iterations=<n>         maximum number of iterations per resolution (default: 256)
+//   --resolutions=<n>        number of resolutions (default: 3)
+//   --output_directory=<dir> directory of the elastix output of each registration (default: ElastixLibBenchmarkOutput)
+//
+// The peak memory use is the maximum resident set size of the process so far. To measure it for one registration,
+// select that registration with --benchmark_filter.
+
+#include <itkElastixRegistrationMethod.h>
+
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itksys/SystemTools.hxx>
+
+// Google Benchmark header file:
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using ParameterMapType = elastix::ParameterObject::ParameterMapType;
+using ParameterValueVectorType = elastix::ParameterObject::ParameterValueVectorType;
+
+
+/// The options of the benchmark, in addition to those of Google Benchmark.
+struct Options
+{
+  std::vector<std::int64_t> Sizes2D{ 128, 256 };
+  std::vector<std::int64_t> Sizes3D{ 64, 96 };
+  std::vector<std::int64_t> Threads{ 0 };
+  unsigned int              NumberOfIterations{ 256 };
+  unsigned int              NumberOfResolutions{ 3 };
+  std::string               OutputDirectory{ "ElastixLibBenchmarkOutput" };
+};
+
+
+/// The results of a registration, as read from its output directory.
+struct RegistrationResult
+{
+  std::vector<double> ResolutionTimes;
+  unsigned long       NumberOfIterations{ 0 };
+  double              FinalMetricValue{ 0.0 };
+  double              PeakMemoryUsage{ 0.0 };
+};
+
+
+/// Creates a cubic image of the specified size with a smooth blob. The moving image is sampled at translated and
+/// smoothly deformed coordinates, so that every transform has something to recover.
+template <typename TImage>
+typename TImage::Pointer
+CreateImage(const itk::SizeValueType size, const bool isMoving)
+{
+  constexpr unsigned int ImageDimension = TImage::ImageDimension;
+
+  const auto image = TImage::New();
+  image->SetRegions(TImage::SizeType::Filled(size));
+  image->Allocate();
+
+  const double center = 0.5 * static_cast<double>(size - 1);
+  const double sigma = 0.25 * static_cast<double>(size);
+  const double pi = std::acos(-1.0);
+
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    double squaredDistance = 0.0;
+    double ripple = 0.0;
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      double x = static_cast<double>(it.GetIndex()[d]);
+      if (isMoving)
+      {
+        const double y = static_cast<double>(it.GetIndex()[(d + 1) % ImageDimension]);
+        x += 0.02 * static_cast<double>(size) * (1.0 + std::sin(2.0 * pi * y / static_cast<double>(size)));
+      }
+      x -= center;
+      squaredDistance += x * x;
+      ripple += std::sin(0.2 * x);
+    }
+    it.Set(static_cast<typename TImage::PixelType>(100.0 * std::exp(-squaredDistance / (2.0 * sigma * sigma)) +
+                                                   10.0 * ripple));
+  }
+  return image;
+}
+
+
+/// Creates the parameter map of the specified registration configuration: "rigid", "affine", "bspline_mi",
+/// "bspline_msd" or "multimetric". The maps are the default parameter maps of elastix, which use mutual information.
+ParameterMapType
+CreateParameterMap(const std::string & configuration, const Options & options)
+{
+  ParameterMapType parameterMap;
+
+  if (configuration == "rigid" || configuration == "affine")
+  {
+    parameterMap = elastix::ParameterObject::GetDefaultParameterMap(configuration, options.NumberOfResolutions);
+  }
+  else
+  {
+    /** The default B-spline map is a multi-metric map, with a bending energy penalty next to mutual information. */
+    parameterMap = elastix::ParameterObject::GetDefaultParameterMap("bspline", options.NumberOfResolutions);
+    if (configuration != "multimetric")
+    {
+      parameterMap["Registration"] = ParameterValueVectorType{ "MultiResolutionRegistration" };
+      parameterMap["Metric"] = ParameterValueVectorType{ configuration == "bspline_msd"
+                                                           ? "AdvancedMeanSquares"
+                                                           : "AdvancedMattesMutualInformation" };
+      parameterMap.erase("Metric0Weight");
+      parameterMap.erase("Metric1Weight");
+    }
+  }
+
+  parameterMap["MaximumNumberOfIterations"] = ParameterValueVectorType{ std::to_string(options.NumberOfIterations) };
+  parameterMap["WriteIterationInfo"] = ParameterValueVectorType{ "true" };
+  parameterMap["WriteResultImage"] = ParameterValueVectorType{ "false" };
+  return parameterMap;
+}
+
+
+/// Reads the value that follows the specified prefix and the next ": " in a line of the log.
+bool
+ReadLogValue(const std::string & line, const std::string & prefix, double & value)
+{
+  if (line.compare(0, prefix.size(), prefix) != 0)
+  {
+    return false;
+  }
+  const auto position = line.find(": ", prefix.size());
+  if (position == std::string::npos)
+  {
+    return false;
+  }
+  std::istringstream stream(line.substr(position + 2));
+  stream.imbue(std::locale::classic());
+  return static_cast<bool>(stream >> value);
+}
+
+
+/// Reads the results of a registration from the log file and the IterationInfo files in its output directory.
+RegistrationResult
+ReadRegistrationResult(const std::string & outputDirectory, const unsigned int numberOfResolutions)
+{
+  RegistrationResult result;
+
+  /** The time and the peak memory use of each resolution are written to the log. */
+  std::ifstream logFile(outputDirectory + "elastix.log");
+  std::string   line;
+  while (std::getline(logFile, line))
+  {
+    double value = 0.0;
+    if (ReadLogValue(line, "Time spent in resolution ", value))
+    {
+      result.ResolutionTimes.push_back(value);
+    }
+    else if (ReadLogValue(line, "Peak memory use after resolution ", value))
+    {
+      result.PeakMemoryUsage = std::max(result.PeakMemoryUsage, value);
+    }
+  }
+
+  /** Each IterationInfo file has a header line, and a line for each iteration. The final metric value is in the
+   * "2:Metric" column of the last line of the last resolution, like elx_compare_finalmetricvalue.py reads it.
+   */
+  for (unsigned int resolution = 0; resolution < numberOfResolutions; ++resolution)
+  {
+    std::ifstream iterationInfoFile(outputDirectory + "IterationInfo.0.R" + std::to_string(resolution) + ".txt");
+    std::string   header;
+    if (!std::getline(iterationInfoFile, header))
+    {
+      continue;
+    }
+
+    std::size_t metricColumn = 0;
+    {
+      std::istringstream headerStream(header);
+      std::string        name;
+      while (std::getline(headerStream, name, '\t') && name != "2:Metric")
+      {
+        ++metricColumn;
+      }
+    }
+
+    std::string lastLine;
+    while (std::getline(iterationInfoFile, line))
+    {
+      if (!line.empty())
+      {
+        lastLine = line;
+        ++result.NumberOfIterations;
+      }
+    }
+
+    std::istringstream lastLineStream(lastLine);
+    std::string        value;
+    std::size_t        column = 0;
+    while (column <= metricColumn && std::getline(lastLineStream, value, '\t'))
+    {
+      ++column;
+    }
+    std::istringstream valueStream(value);
+    valueStream.imbue(std::locale::classic());
+    valueStream >> result.FinalMetricValue;
+  }
+  return result;
+}
+
+
+/// Benchmarks a registration of synthetic images with the parameter map of the specified configuration.
+template <unsigned int VDimension>
+void
+Registration(benchmark::State & state, const std::string & configuration, const Options & options)
+{
+  using ImageType = itk::Image<float, VDimension>;
+
+  const auto size = static_cast<itk::SizeValueType>(state.range(0));
+  const auto threads = static_cast<int>(state.range(1));
+  const auto fixedImage = CreateImage<ImageType>(size, false);
+  const auto movingImage = CreateImage<ImageType>(size, true);
+
+  const auto parameterObject = elastix::ParameterObject::New();
+  parameterObject->SetParameterMap(CreateParameterMap(configuration, options));
+
+  const std::string outputDirectory = options.OutputDirectory + "/" + configuration + "_" + std::to_string(VDimension) +
+                                      "D_size" + std::to_string(size) + "_threads" + std::to_string(threads) + "/";
+  if (!itksys::SystemTools::MakeDirectory(outputDirectory))
+  {
+    state.SkipWithError(("Output directory \"" + outputDirectory + "\" cannot be created").c_str());
+    return;
+  }
+
+  for (auto _ : state)
+  {
+    const auto filter = itk::ElastixRegistrationMethod<ImageType, ImageType>::New();
+    filter->SetFixedImage(fixedImage);
+    filter->SetMovingImage(movingImage);
+    filter->SetParameterObject(parameterObject);
+    filter->SetOutputDirectory(outputDirectory);
+    filter->LogToFileOn();
+    filter->LogToConsoleOff();
+    filter->SetNumberOfThreads(threads);
+    filter->Update();
+  }
+
+  /** The results of the last registration, which are the same as the others apart from the timing. */
+  const RegistrationResult result = ReadRegistrationResult(outputDirectory, options.NumberOfResolutions);
+
+  for (std::size_t resolution = 0; resolution < result.ResolutionTimes.size(); ++resolution)
+  {
+    state.counters["R" + std::to_string(resolution) + "_seconds"] = result.ResolutionTimes[resolution];
+  }
+  const double numberOfIterations =
+    static_cast<double>(result.NumberOfIterations) * static_cast<double>(state.iterations());
+  state.counters["iterations_per_second"] = benchmark::Counter(numberOfIterations, benchmark::Counter::kIsRate);
+  state.counters["peak_memory_MB"] = result.PeakMemoryUsage;
+  state.counters["final_metric"] = result.FinalMetricValue;
+}
+
+
+/// Registers the benchmarks of all configurations, dimensions, image sizes and numbers of threads.
+void
+RegisterRegistrationBenchmarks(const Options & options)
+{
+  for (const std::string configuration : { "rigid", "affine", "bspline_mi", "bspline_msd", "multimetric" })
+  {
+    const auto register2D = benchmark::RegisterBenchmark(
+      ("Registration2D/" + configuration).c_str(), Registration<2>, configuration, options);
+    const auto register3D = benchmark::RegisterBenchmark(
+      ("Registration3D/" + configuration).c_str(), Registration<3>, configuration, options);
+
+    for (const auto registered : { register2D, register3D })
+    {
+      registered->ArgNames({ "size", "threads" })->Unit(benchmark::kMillisecond)->UseRealTime();
+      for (const auto size : registered == register2D ? options.Sizes2D : options.Sizes3D)
+      {
+        for (const auto threads : options.Threads)
+        {
+          registered->Args({ size, threads });
+        }
+      }
+    }
+  }
+}
+
+
+/// Reads a comma separated list of numbers.
+std::vector<std::int64_t>
+ReadNumbers(const std::string & text)
+{
+  std::vector<std::int64_t> numbers;
+  std::istringstream        stream(text);
+  std::string               number;
+  while (std::getline(stream, number, ','))
+  {
+    numbers.push_back(std::stoll(number));
+  }
+  return numbers;
+}
+
+} // namespace
+
+
+int
+main(int argc, char ** argv)
+{
+  benchmark::Initialize(&argc, argv);
+
+  /** The arguments that are left are the options of this benchmark. */
+  Options options;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string argument = argv[i];
+    const auto        position = argument.find('=');
+    const std::string name = argument.substr(0, position);
+    const std::string value = position == std::string::npos ? "" : argument.substr(position + 1);
+
+    try
+    {
+      if (name == "--sizes2d")
+      {
+        options.Sizes2D = ReadNumbers(value);
+      }
+      else if (name == "--sizes3d")
+      {
+        options.Sizes3D = ReadNumbers(value);
+      }
+      else if (name == "--threads")
+      {
+        options.Threads = ReadNumbers(value);
+      }
+      else if (name == "--iterations")
+      {
+        options.NumberOfIterations = static_cast<unsigned int>(std::stoul(value));
+      }
+      else if (name == "--resolutions")
+      {
+        options.NumberOfResolutions = static_cast<unsigned int>(std::stoul(value));
+      }
+      else if (name == "--output_directory")
+      {
+        options.OutputDirectory = value;
+      }
+      else
+      {
+        std::cerr << "Unknown option: " << argument << std::endl;
+        return 1;
+      }
+    }
+    catch (const std::exception &)
+    {
+      std::cerr << "Invalid value of option: " << argument << std::endl;
+      return 1;
+    }
+  }
+
+  RegisterRegistrationBenchmarks(options);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,145 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+// First include the header file to be tested:
+#include <itkElastixBatchRegistrationMethod.h>
+
+#include "elxCoreMainGTestUtilities.h"
+
+// ITK header file:
+#include <itkImage.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+constexpr auto ImageDimension = 2U;
+using ImageType = itk::Image<float, ImageDimension>;
+using SizeType = itk::Size<ImageDimension>;
+using IndexType = itk::Index<ImageDimension>;
+using OffsetType = itk::Offset<ImageDimension>;
+using BatchRegistrationType = itk::ElastixBatchRegistrationMethod<ImageType, ImageType>;
+
+
+// Creates a small (5x6) binary image, with a 2x2 square at the specified index.
+ImageType::Pointer
+CreateImage(const IndexType & regionIndex)
+{
+  const auto image = ImageType::New();
+  image->SetRegions(SizeType{ { 5, 6 } });
+  image->Allocate(true);
+  elx::CoreMainGTestUtilities::FillImageRegion(*image, regionIndex, SizeType::Filled(2));
+  return image;
+}
+
+
+elastix::ParameterObject::Pointer
+CreateParameterObject()
+{
+  const auto parameterObject = elastix::ParameterObject::New();
+  parameterObject->SetParameterMap(
+    std::map<std::string, std::vector<std::string>>{ { "ImageSampler", { "Full" } },
+                                                     { "MaximumNumberOfIterations", { "2" } },
+                                                     { "Metric", { "AdvancedNormalizedCorrelation" } },
+                                                     { "Optimizer", { "AdaptiveStochasticGradientDescent" } },
+                                                     { "Transform", { "TranslationTransform" } } });
+  return parameterObject;
+}
+
+
+// Expects the translation of each pair to be the specified offset.
+void
+ExpectTranslations(const BatchRegistrationType & batch, const std::vector<OffsetType> & translationOffsets)
+{
+  ASSERT_EQ(batch.GetNumberOfRegistrations(), translationOffsets.size());
+
+  for (unsigned int n = 0; n < translationOffsets.size(); ++n)
+  {
+    ASSERT_NE(batch.GetResultImage(n), nullptr);
+    const auto & transformParameterMaps = batch.GetTransformParameterObject(n)->GetParameterMap();
+    ASSERT_EQ(transformParameterMaps.size(), 1);
+
+    const auto & transformParameters = transformParameterMaps.front().at("TransformParameters");
+    ASSERT_EQ(transformParameters.size(), ImageDimension);
+
+    for (unsigned i{}; i < ImageDimension; ++i)
+    {
+      EXPECT_EQ(std::round(std::stod(transformParameters[i])), translationOffsets[n][i]);
+    }
+  }
+}
+
+} // namespace
+
+
+// Tests registering one fixed image to several moving images, which are translated with respect to it.
+GTEST_TEST(itkElastixBatchRegistrationMethod, OneFixedImageManyMovingImages)
+{
+  const IndexType               fixedImageRegionIndex{ { 1, 3 } };
+  const std::vector<OffsetType> translationOffsets{ { { 1, -2 } }, { { 0, 1 } }, { { -1, -1 } }, { { 2, 0 } } };
+
+  const auto batch = BatchRegistrationType::New();
+  batch->AddFixedImage(CreateImage(fixedImageRegionIndex));
+  for (const auto & translationOffset : translationOffsets)
+  {
+    batch->AddMovingImage(CreateImage(fixedImageRegionIndex + translationOffset));
+  }
+  batch->SetParameterObject(CreateParameterObject());
+  batch->SetMaximumNumberOfConcurrentRegistrations(2);
+  batch->Update();
+
+  ExpectTranslations(*batch, translationOffsets);
+}
+
+
+// Tests registering several fixed images to one moving image.
+GTEST_TEST(itkElastixBatchRegistrationMethod, ManyFixedImagesOneMovingImage)
+{
+  const IndexType               movingImageRegionIndex{ { 2, 2 } };
+  const std::vector<OffsetType> translationOffsets{ { { 1, -1 } }, { { -1, 1 } }, { { 0, -2 } } };
+
+  const auto batch = BatchRegistrationType::New();
+  for (const auto & translationOffset : translationOffsets)
+  {
+    batch->AddFixedImage(CreateImage(movingImageRegionIndex - translationOffset));
+  }
+  batch->AddMovingImage(CreateImage(movingImageRegionIndex));
+  batch->SetParameterObject(CreateParameterObject());
+  batch->SetNumberOfThreadsPerRegistration(2);
+  batch->Update();
+
+  ExpectTranslations(*batch, translationOffsets);
+}
+
+
+GTEST_TEST(itkElastixBatchRegistrationMethod, ThrowsWhenBothSidesHaveManyImages)
+{
+  const auto batch = BatchRegistrationType::New();
+  batch->AddFixedImage(CreateImage(IndexType{ { 1, 1 } }));
+  batch->AddFixedImage(CreateImage(IndexType{ { 1, 2 } }));
+  batch->AddMovingImage(CreateImage(IndexType{ { 2, 1 } }));
+  batch->AddMovingImage(CreateImage(IndexType{ { 2, 2 } }));
+  batch->SetParameterObject(CreateParameterObject());
+
+  EXPECT_THROW(batch->Update(), itk::ExceptionObject);
+}
@@ -31,7 +31,9 @@
 #include <algorithm> // For transform
 #include <map>
 #include <string>
+#include <thread>
 #include <utility> // For pair
+#include <vector>
 
 
 // Tests registering two small (5x6) binary images, which are translated with respect to each other.
@@ -106,3 +108,89 @@ GTEST_TEST(itkElastixRegistrationMethod, Translation)
     EXPECT_EQ(std::round(std::stod(transformParameters[i])), translationOffset[i]);
   }
 }
+
+
+// Tests running registrations concurrently on different threads, each limited to a single thread.
+GTEST_TEST(itkElastixRegistrationMethod, ConcurrentRegistrations)
+{
+  constexpr auto ImageDimension = 2U;
+  using ImageType = itk::Image<float, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+  using IndexType = itk::Index<ImageDimension>;
+  using OffsetType = itk::Offset<ImageDimension>;
+
+  const OffsetType translationOffset{ { 1, -2 } };
+  const auto       regionSize = SizeType::Filled(2);
+  const SizeType   imageSize{ { 5, 6 } };
+  const IndexType  fixedImageRegionIndex{ { 1, 3 } };
+
+  const auto fixedImage = ImageType::New();
+  fixedImage->SetRegions(imageSize);
+  fixedImage->Allocate(true);
+  elx::CoreMainGTestUtilities::FillImageRegion(*fixedImage, fixedImageRegionIndex, regionSize);
+
+  const auto movingImage = ImageType::New();
+  movingImage->SetRegions(imageSize);
+  movingImage->Allocate(true);
+  elx::CoreMainGTestUtilities::FillImageRegion(*movingImage, fixedImageRegionIndex + translationOffset, regionSize);
+
+  const std::map<std::string, std::vector<std::string>> parameterMap{
+    { "ImageSampler", { "Full" } },
+    { "MaximumNumberOfIterations", { "2" } },
+    { "Metric", { "AdvancedNormalizedCorrelation" } },
+    { "Optimizer", { "AdaptiveStochasticGradientDescent" } },
+    { "Transform", { "TranslationTransform" } }
+  };
+
+  constexpr unsigned int                numberOfRegistrations = 4;
+  std::vector<std::vector<std::string>> transformParametersPerRegistration(numberOfRegistrations);
+  std::vector<std::string>              errorMessages(numberOfRegistrations);
+  std::vector<std::thread>              threads;
+
+  for (unsigned int n = 0; n < numberOfRegistrations; ++n)
+  {
+    threads.emplace_back([n,
+                          &fixedImage,
+                          &movingImage,
+                          &parameterMap,
+                          &transformParametersPerRegistration,
+                          &errorMessages] {
+      try
+      {
+        const auto parameterObject = elastix::ParameterObject::New();
+        parameterObject->SetParameterMap(parameterMap);
+
+        const auto filter = itk::ElastixRegistrationMethod<ImageType, ImageType>::New();
+        filter->SetFixedImage(fixedImage);
+        filter->SetMovingImage(movingImage);
+        filter->SetParameterObject(parameterObject);
+        filter->SetNumberOfThreads(1);
+        filter->Update();
+
+        const auto & transformParameterMap = filter->GetTransformParameterObject()->GetParameterMap().front();
+        transformParametersPerRegistration[n] = transformParameterMap.at("TransformParameters");
+      }
+      catch (const std::exception & exception)
+      {
+        errorMessages[n] = exception.what();
+      }
+    });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  // The registrations do not influence each other, so they should all have the same result.
+  for (unsigned int n = 0; n < numberOfRegistrations; ++n)
+  {
+    EXPECT_EQ(errorMessages[n], "");
+    ASSERT_EQ(transformParametersPerRegistration[n].size(), ImageDimension);
+    EXPECT_EQ(transformParametersPerRegistration[n], transformParametersPerRegistration.front());
+
+    for (unsigned i{}; i < ImageDimension; ++i)
+    {
+      EXPECT_EQ(std::round(std::stod(transformParametersPerRegistration[n][i])), translationOffset[i]);
+    }
+  }
+}
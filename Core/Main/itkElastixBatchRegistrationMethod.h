@@ -0,0 +1,185 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkElastixBatchRegistrationMethod_h
+#define itkElastixBatchRegistrationMethod_h
+
+#include "itkElastixRegistrationMethod.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * \class ElastixBatchRegistrationMethod
+ * \brief Registers one fixed image to many moving images, or many fixed images to one moving image.
+ *
+ * Each pair of a fixed and a moving image is registered by its own ElastixRegistrationMethod,
+ * with the same parameter maps. The registrations run concurrently, each on its own thread,
+ * and each with at most NumberOfThreadsPerRegistration threads. Many small registrations
+ * with one thread each use the cores better than a sequence of registrations that each try
+ * to use all cores. By default, as many registrations run concurrently as fit in the global
+ * default number of threads of ITK.
+ *
+ * The image that is common to all pairs is shared, and so are the masks. Unless the
+ * parameter maps specify otherwise, the registrations use the shared image cache
+ * (see the UseSharedImageCache parameter), so that the images that are derived from
+ * the common image, like its pyramid, the eroded masks, and its B-spline coefficients
+ * or gradient image, are computed only once, instead of once for each pair.
+ *
+ * When a registration fails, the others still run. Update() throws an exception
+ * afterwards, which mentions the pairs that failed.
+ *
+ * \ingroup Elastix
+ */
+
+namespace itk
+{
+
+template <typename TFixedImage, typename TMovingImage>
+class ITK_TEMPLATE_EXPORT ElastixBatchRegistrationMethod : public Object
+{
+public:
+  /** Standard ITK typedefs. */
+  typedef ElastixBatchRegistrationMethod Self;
+  typedef Object                         Superclass;
+  typedef SmartPointer<Self>             Pointer;
+  typedef SmartPointer<const Self>       ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ElastixBatchRegistrationMethod, Object);
+
+  /** Typedefs. */
+  typedef ElastixRegistrationMethod<TFixedImage, TMovingImage> RegistrationMethodType;
+  typedef typename RegistrationMethodType::FixedImageType      FixedImageType;
+  typedef typename RegistrationMethodType::MovingImageType     MovingImageType;
+  typedef typename RegistrationMethodType::ResultImageType     ResultImageType;
+  typedef typename RegistrationMethodType::FixedMaskType       FixedMaskType;
+  typedef typename RegistrationMethodType::MovingMaskType      MovingMaskType;
+  typedef typename RegistrationMethodType::ParameterObjectType ParameterObjectType;
+  typedef typename RegistrationMethodType::ParameterMapType    ParameterMapType;
+  typedef typename ParameterObjectType::ParameterMapVectorType ParameterMapVectorType;
+
+  /** Add a fixed image. Either the fixed or the moving images should consist of a single image. */
+  void
+  AddFixedImage(const FixedImageType * fixedImage);
+
+  /** Add a moving image. Either the fixed or the moving images should consist of a single image. */
+  void
+  AddMovingImage(const MovingImageType * movingImage);
+
+  /** Remove all fixed and moving images, and the results. */
+  void
+  RemoveImages(void);
+
+  /** Get the number of fixed and moving images. */
+  unsigned int
+  GetNumberOfFixedImages(void) const
+  {
+    return static_cast<unsigned int>(this->m_FixedImages.size());
+  }
+
+
+  unsigned int
+  GetNumberOfMovingImages(void) const
+  {
+    return static_cast<unsigned int>(this->m_MovingImages.size());
+  }
+
+
+  /** Set/Get the fixed and the moving mask, which are used for all pairs. */
+  itkSetConstObjectMacro(FixedMask, FixedMaskType);
+  itkGetConstObjectMacro(FixedMask, FixedMaskType);
+  itkSetConstObjectMacro(MovingMask, MovingMaskType);
+  itkGetConstObjectMacro(MovingMask, MovingMaskType);
+
+  /** Set/Get the parameter maps, which are used for all pairs. */
+  itkSetObjectMacro(ParameterObject, ParameterObjectType);
+  itkGetModifiableObjectMacro(ParameterObject, ParameterObjectType);
+
+  /** Set/Get the maximum number of threads of each registration. Default: 1. */
+  itkSetClampMacro(NumberOfThreadsPerRegistration, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(NumberOfThreadsPerRegistration, unsigned int);
+
+  /** Set/Get the maximum number of registrations that run at the same time. Zero (the default)
+   * means the global default number of threads of ITK, divided by the number of threads per
+   * registration.
+   */
+  itkSetMacro(MaximumNumberOfConcurrentRegistrations, unsigned int);
+  itkGetConstMacro(MaximumNumberOfConcurrentRegistrations, unsigned int);
+
+  /** Log to console on/off. The logs of concurrent registrations are interleaved. */
+  itkSetMacro(LogToConsole, bool);
+  itkGetConstMacro(LogToConsole, bool);
+  itkBooleanMacro(LogToConsole);
+
+  /** Register all pairs. */
+  virtual void
+  Update(void);
+
+  /** Get the number of pairs, which is the largest of the number of fixed and moving images. */
+  unsigned int
+  GetNumberOfRegistrations(void) const;
+
+  /** Get the result image and the transform parameters of a pair, after Update(). */
+  ResultImageType *
+  GetResultImage(const unsigned int index) const;
+
+  ParameterObjectType *
+  GetTransformParameterObject(const unsigned int index) const;
+
+protected:
+  ElastixBatchRegistrationMethod();
+  ~ElastixBatchRegistrationMethod() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ElastixBatchRegistrationMethod(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  /** Register the pair with the specified index. */
+  void
+  RegisterPair(const unsigned int index, const ParameterMapVectorType & parameterMaps);
+
+  std::vector<typename FixedImageType::ConstPointer>  m_FixedImages;
+  std::vector<typename MovingImageType::ConstPointer> m_MovingImages;
+  typename FixedMaskType::ConstPointer                m_FixedMask;
+  typename MovingMaskType::ConstPointer               m_MovingMask;
+  typename ParameterObjectType::Pointer               m_ParameterObject;
+
+  unsigned int m_NumberOfThreadsPerRegistration;
+  unsigned int m_MaximumNumberOfConcurrentRegistrations;
+  bool         m_LogToConsole;
+
+  /** The results, and the error messages of the pairs that failed. */
+  std::vector<typename ResultImageType::Pointer>     m_ResultImages;
+  std::vector<typename ParameterObjectType::Pointer> m_TransformParameterObjects;
+  std::vector<std::string>                           m_ErrorMessages;
+};
+
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkElastixBatchRegistrationMethod.hxx"
+#endif
+
+#endif // itkElastixBatchRegistrationMethod_h
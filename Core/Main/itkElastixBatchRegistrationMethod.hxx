@@ -0,0 +1,269 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkElastixBatchRegistrationMethod_hxx
+#define itkElastixBatchRegistrationMethod_hxx
+
+#include "itkElastixBatchRegistrationMethod.h"
+
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+namespace itk
+{
+
+template <typename TFixedImage, typename TMovingImage>
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::ElastixBatchRegistrationMethod()
+{
+  this->m_NumberOfThreadsPerRegistration = 1;
+  this->m_MaximumNumberOfConcurrentRegistrations = 0;
+  this->m_LogToConsole = false;
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::AddFixedImage(const FixedImageType * fixedImage)
+{
+  if (fixedImage == nullptr)
+  {
+    itkExceptionMacro("The fixed image should not be null.");
+  }
+  this->m_FixedImages.push_back(fixedImage);
+  this->Modified();
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::AddMovingImage(const MovingImageType * movingImage)
+{
+  if (movingImage == nullptr)
+  {
+    itkExceptionMacro("The moving image should not be null.");
+  }
+  this->m_MovingImages.push_back(movingImage);
+  this->Modified();
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::RemoveImages(void)
+{
+  this->m_FixedImages.clear();
+  this->m_MovingImages.clear();
+  this->m_ResultImages.clear();
+  this->m_TransformParameterObjects.clear();
+  this->m_ErrorMessages.clear();
+  this->Modified();
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+unsigned int
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::GetNumberOfRegistrations(void) const
+{
+  if (this->m_FixedImages.empty() || this->m_MovingImages.empty())
+  {
+    return 0;
+  }
+  return static_cast<unsigned int>(std::max(this->m_FixedImages.size(), this->m_MovingImages.size()));
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::Update(void)
+{
+  if (this->m_FixedImages.empty() || this->m_MovingImages.empty())
+  {
+    itkExceptionMacro("At least one fixed and one moving image are required.");
+  }
+  if (this->m_FixedImages.size() > 1 && this->m_MovingImages.size() > 1)
+  {
+    itkExceptionMacro("Either the fixed or the moving images should consist of a single image.");
+  }
+  if (this->m_ParameterObject.IsNull() || this->m_ParameterObject->GetParameterMap().empty())
+  {
+    itkExceptionMacro("Empty parameter map in parameter object.");
+  }
+
+  /** Let the registrations share the images derived from the common image,
+   * unless the parameter maps say otherwise.
+   */
+  ParameterMapVectorType parameterMaps = this->m_ParameterObject->GetParameterMap();
+  for (ParameterMapType & parameterMap : parameterMaps)
+  {
+    if (parameterMap.count("UseSharedImageCache") == 0)
+    {
+      parameterMap["UseSharedImageCache"] = { "true" };
+    }
+  }
+
+  const unsigned int numberOfRegistrations = this->GetNumberOfRegistrations();
+  this->m_ResultImages.assign(numberOfRegistrations, nullptr);
+  this->m_TransformParameterObjects.assign(numberOfRegistrations, nullptr);
+  this->m_ErrorMessages.assign(numberOfRegistrations, std::string());
+
+  unsigned int numberOfConcurrentRegistrations = this->m_MaximumNumberOfConcurrentRegistrations;
+  if (numberOfConcurrentRegistrations == 0)
+  {
+    numberOfConcurrentRegistrations = std::max(
+      MultiThreaderBase::GetGlobalDefaultNumberOfThreads() / this->m_NumberOfThreadsPerRegistration, 1U);
+  }
+  numberOfConcurrentRegistrations = std::min(numberOfConcurrentRegistrations, numberOfRegistrations);
+
+  /** Each registration runs on a thread of its own, and takes the next pair that is not
+   * yet started. The WorkStealingThreadPool is not used for this, so that its threads
+   * remain available to the metrics of the registrations.
+   */
+  std::atomic<unsigned int> nextPair(0);
+  const auto                registerPairs = [this, &nextPair, &parameterMaps, numberOfRegistrations] {
+    for (unsigned int i = nextPair++; i < numberOfRegistrations; i = nextPair++)
+    {
+      this->RegisterPair(i, parameterMaps);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < numberOfConcurrentRegistrations; ++t)
+  {
+    threads.emplace_back(registerPairs);
+  }
+  for (std::thread & thread : threads)
+  {
+    thread.join();
+  }
+
+  /** Report the pairs that failed. */
+  std::ostringstream errors;
+  unsigned int       numberOfFailures = 0;
+  for (unsigned int i = 0; i < numberOfRegistrations; ++i)
+  {
+    if (!this->m_ErrorMessages[i].empty())
+    {
+      ++numberOfFailures;
+      errors << "\nPair " << i << ": " << this->m_ErrorMessages[i];
+    }
+  }
+  if (numberOfFailures > 0)
+  {
+    itkExceptionMacro(<< numberOfFailures << " of " << numberOfRegistrations
+                      << " registrations failed:" << errors.str());
+  }
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::RegisterPair(const unsigned int             index,
+                                                                          const ParameterMapVectorType & parameterMaps)
+{
+  try
+  {
+    /** Each registration gets its own image objects, which share the pixel buffers,
+     * because the pipeline of a registration modifies its inputs, like their requested region.
+     */
+    const auto fixedImage = FixedImageType::New();
+    fixedImage->Graft(this->m_FixedImages[this->m_FixedImages.size() == 1 ? 0 : index]);
+    const auto movingImage = MovingImageType::New();
+    movingImage->Graft(this->m_MovingImages[this->m_MovingImages.size() == 1 ? 0 : index]);
+
+    const auto registration = RegistrationMethodType::New();
+    registration->SetFixedImage(fixedImage);
+    registration->SetMovingImage(movingImage);
+    if (this->m_FixedMask.IsNotNull())
+    {
+      const auto fixedMask = FixedMaskType::New();
+      fixedMask->Graft(this->m_FixedMask);
+      registration->SetFixedMask(fixedMask);
+    }
+    if (this->m_MovingMask.IsNotNull())
+    {
+      const auto movingMask = MovingMaskType::New();
+      movingMask->Graft(this->m_MovingMask);
+      registration->SetMovingMask(movingMask);
+    }
+
+    const auto parameterObject = ParameterObjectType::New();
+    parameterObject->SetParameterMap(parameterMaps);
+    registration->SetParameterObject(parameterObject);
+    registration->SetNumberOfThreads(static_cast<int>(this->m_NumberOfThreadsPerRegistration));
+    registration->SetLogToConsole(this->m_LogToConsole);
+    registration->Update();
+
+    const typename ResultImageType::Pointer resultImage = registration->GetOutput();
+    resultImage->DisconnectPipeline();
+    const typename ParameterObjectType::Pointer transformParameterObject =
+      registration->GetTransformParameterObject();
+    transformParameterObject->DisconnectPipeline();
+
+    this->m_ResultImages[index] = resultImage;
+    this->m_TransformParameterObjects[index] = transformParameterObject;
+  }
+  catch (const std::exception & exception)
+  {
+    this->m_ErrorMessages[index] = exception.what();
+  }
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+typename ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::ResultImageType *
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::GetResultImage(const unsigned int index) const
+{
+  if (index >= this->m_ResultImages.size())
+  {
+    itkExceptionMacro("Index " << index << " is out of range, or Update() has not been called.");
+  }
+  return this->m_ResultImages[index];
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+typename ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::ParameterObjectType *
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::GetTransformParameterObject(const unsigned int index) const
+{
+  if (index >= this->m_TransformParameterObjects.size())
+  {
+    itkExceptionMacro("Index " << index << " is out of range, or Update() has not been called.");
+  }
+  return this->m_TransformParameterObjects[index];
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfFixedImages: " << this->m_FixedImages.size() << std::endl;
+  os << indent << "NumberOfMovingImages: " << this->m_MovingImages.size() << std::endl;
+  os << indent << "NumberOfThreadsPerRegistration: " << this->m_NumberOfThreadsPerRegistration << std::endl;
+  os << indent << "MaximumNumberOfConcurrentRegistrations: " << this->m_MaximumNumberOfConcurrentRegistrations
+     << std::endl;
+  os << indent << "LogToConsole: " << this->m_LogToConsole << std::endl;
+}
+
+} // namespace itk
+
+#endif // itkElastixBatchRegistrationMethod_hxx
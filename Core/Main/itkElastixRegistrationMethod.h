@@ -44,6 +44,10 @@
  * \class ElastixRegistrationMethod
  * \brief ITK Filter interface to the Elastix registration library.
  *
+ * Several registration methods may be updated concurrently, each on its own thread.
+ * The log, the random generator and the maximum number of threads are kept per thread,
+ * so these registrations do not influence each other.
+ *
  * \ingroup Elastix
  */
 
@@ -238,6 +242,10 @@ public:
   itkGetConstReferenceMacro(LogToFile, bool);
   itkBooleanMacro(LogToFile);
 
+  /** The maximum number of threads used by this registration. Zero (the default) means
+   * the global default number of threads of ITK. Unlike the -threads argument of the
+   * elastix executable, it does not change the global maximum number of threads of ITK.
+   */
   itkSetMacro(NumberOfThreads, int);
   itkGetMacro(NumberOfThreads, int);
 
@@ -19,6 +19,7 @@
 #include "itkArray.h"
 #include <vector>
 #include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include "itkNumericTraits.h"
 
@@ -57,6 +58,10 @@ public:
   unsigned long                       m_NumberOfParameters;
   mutable std::vector<DerivativeType> m_ThreaderDerivatives;
 
+  /** For the sparse accumulation: which tiles of each thread derivative are touched. */
+  static const unsigned int                       m_TileSize = 256;
+  mutable std::vector<std::vector<unsigned char>> m_ThreaderTouchedTiles;
+
   typedef itk::PlatformMultiThreader ThreaderType;
   typedef ThreaderType::WorkUnitInfo ThreadInfoType;
   ThreaderType::Pointer              m_Threader;
@@ -64,6 +69,7 @@ public:
   ThreadIdType                       m_NumberOfThreads;
   bool                               m_UseOpenMP;
   bool                               m_UseMultiThreaded;
+  bool                               m_UseSparse;
 
   struct MultiThreaderParameterType
   {
@@ -87,6 +93,7 @@ public:
     this->m_NumberOfThreads = this->m_Threader->GetNumberOfWorkUnits();
     this->m_UseOpenMP = false;
     this->m_UseMultiThreaded = false;
+    this->m_UseSparse = false;
     this->m_NormalSum = 3.1415926;
 
 #ifdef ELASTIX_USE_OPENMP
@@ -163,6 +170,40 @@ public:
     unsigned int       jmax = (threadID + 1) * subSize;
     jmax = (jmax > numPar) ? numPar : jmax;
 
+    /** Sparse: accumulate whole tiles, only from the threads that touched them.
+     * Contrary to the metric, the touched tiles are not reset, to be able to repeat.
+     */
+    if (temp->st_Metric->m_UseSparse)
+    {
+      const unsigned int numTiles = (numPar + m_TileSize - 1) / m_TileSize;
+      const unsigned int tilesPerThread = (numTiles + nrOfThreads - 1) / nrOfThreads;
+      const unsigned int tmin = std::min(threadID * tilesPerThread, numTiles);
+      const unsigned int tmax = std::min((threadID + 1) * tilesPerThread, numTiles);
+      for (unsigned int tile = tmin; tile < tmax; ++tile)
+      {
+        const unsigned int tileBegin = tile * m_TileSize;
+        const unsigned int tileEnd = std::min(tileBegin + m_TileSize, numPar);
+        std::fill(temp->st_DerivativePointer + tileBegin,
+                  temp->st_DerivativePointer + tileEnd,
+                  itk::NumericTraits<DerivativeValueType>::Zero);
+        for (ThreadIdType i = 0; i < nrOfThreads; ++i)
+        {
+          if (temp->st_Metric->m_ThreaderTouchedTiles[i][tile])
+          {
+            for (unsigned int j = tileBegin; j < tileEnd; ++j)
+            {
+              temp->st_DerivativePointer[j] += temp->st_Metric->m_ThreaderDerivatives[i][j];
+            }
+          }
+        }
+        for (unsigned int j = tileBegin; j < tileEnd; ++j)
+        {
+          temp->st_DerivativePointer[j] /= temp->st_NormalizationFactor;
+        }
+      }
+      return ITK_THREAD_RETURN_DEFAULT_VALUE;
+    }
+
     for (unsigned int j = jmin; j < jmax; ++j)
     {
       DerivativeValueType tmp = itk::NumericTraits<DerivativeValueType>::Zero;
@@ -227,16 +268,29 @@ main(int argc, char * argv[])
     derivative.Fill(0.0);
 
     metric->m_ThreaderDerivatives.resize(nrThreads);
+    metric->m_ThreaderTouchedTiles.resize(nrThreads);
     metric->m_NumberOfParameters = arraySizes[s];
+    const unsigned int numTiles = (arraySizes[s] + MetricClass::m_TileSize - 1) / MetricClass::m_TileSize;
     for (ThreadIdType t = 0; t < nrThreads; ++t)
     {
       // Allocate
       metric->m_ThreaderDerivatives[t].SetSize(metric->m_NumberOfParameters);
       metric->m_ThreaderDerivatives[t].Fill(0);
 
+      // Each thread touches every 8th tile, like a thread that handles a few
+      // samples of a fine B-spline grid.
+      metric->m_ThreaderTouchedTiles[t].assign(numTiles, 0);
+      for (unsigned int tile = t % 8; tile < numTiles; tile += 8)
+      {
+        metric->m_ThreaderTouchedTiles[t][tile] = 1;
+      }
+
       for (unsigned int i = 0; i < arraySizes[s]; ++i)
       {
-        metric->m_ThreaderDerivatives[t][i] = 2.1;
+        if (metric->m_ThreaderTouchedTiles[t][i / MetricClass::m_TileSize])
+        {
+          metric->m_ThreaderDerivatives[t][i] = 2.1;
+        }
       }
     }
 
@@ -272,6 +326,28 @@ main(int argc, char * argv[])
       timeCollector.Stop("ITK (mt)");
     }
 
+    /** Time the sparse ITK multi-threaded implementation, and check that it
+     * gives the same result as the dense one.
+     */
+    const DerivativeType denseDerivative = derivative;
+    metric->m_UseSparse = true;
+    for (unsigned int i = 0; i < rep; ++i)
+    {
+      timeCollector.Start("ITK sparse (mt)");
+      metric->AccumulateDerivatives(derivative);
+      timeCollector.Stop("ITK sparse (mt)");
+    }
+    metric->m_UseSparse = false;
+    for (unsigned int i = 0; i < arraySizes[s]; ++i)
+    {
+      if (std::abs(derivative[i] - denseDerivative[i]) > 1e-6 * std::abs(denseDerivative[i]))
+      {
+        std::cerr << "ERROR: sparse and dense accumulation differ at index " << i << ": " << derivative[i]
+                  << " != " << denseDerivative[i] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
     /** Time the OpenMP multi-threaded implementation. */
 #ifdef ELASTIX_USE_OPENMP
     metric->m_UseOpenMP = true;
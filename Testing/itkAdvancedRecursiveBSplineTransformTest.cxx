@@ -27,6 +27,7 @@
 #include "itkMersenneTwisterRandomVariateGenerator.h"
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
 
 //-------------------------------------------------------------------------------------
 
@@ -253,6 +254,8 @@ main(int argc, char * argv[])
   std::vector<InputPointType>  pointList(N);
   std::vector<OutputPointType> transformedPointList1(N);
   std::vector<OutputPointType> transformedPointList2(N);
+  std::vector<OutputPointType> transformedPointList3(N);
+  std::vector<OutputPointType> transformedPointList4(N);
 
   IndexType               dummyIndex;
   CoefficientImagePointer coefficientImage = transform->GetCoefficientImages()[0];
@@ -280,6 +283,14 @@ main(int argc, char * argv[])
   }
   timeCollector.Stop("TransformPoint recursive         ");
 
+  timeCollector.Start("TransformPoint elastix batch     ");
+  transform->TransformPointBatch(pointList.data(), transformedPointList3.data(), N);
+  timeCollector.Stop("TransformPoint elastix batch     ");
+
+  timeCollector.Start("TransformPoint recursive batch   ");
+  recursiveTransform->TransformPointBatch(pointList.data(), transformedPointList4.data(), N);
+  timeCollector.Stop("TransformPoint recursive batch   ");
+
   /** Time the implementation of the Jacobian. */
   timeCollector.Start("Jacobian elastix                 ");
   for (unsigned int i = 0; i < N; ++i)
@@ -397,6 +408,36 @@ main(int argc, char * argv[])
     return EXIT_FAILURE;
   }
 
+  /** TransformPointBatch should give the same results as TransformPoint. */
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    if (transformedPointList3[i].EuclideanDistanceTo(transformedPointList1[i]) > 1e-10 ||
+        transformedPointList4[i].EuclideanDistanceTo(transformedPointList2[i]) > 1e-10)
+    {
+      std::cerr << "ERROR: B-spline TransformPointBatch() differs from TransformPoint()." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  /** GetJacobianBatch should give the same results as GetJacobian. */
+  {
+    const unsigned int                      numberOfBatchPoints = std::min(N, 100u);
+    std::vector<JacobianType>               jacobians(numberOfBatchPoints);
+    std::vector<NonZeroJacobianIndicesType> nzjis(numberOfBatchPoints);
+    recursiveTransform->GetJacobianBatch(pointList.data(), jacobians.data(), nzjis.data(), numberOfBatchPoints);
+    for (unsigned int i = 0; i < numberOfBatchPoints; ++i)
+    {
+      JacobianType               jacobianSingle;
+      NonZeroJacobianIndicesType nzjiSingle;
+      transform->GetJacobian(pointList[i], jacobianSingle, nzjiSingle);
+      if ((jacobians[i] - jacobianSingle).frobenius_norm() > 1e-10 || nzjis[i] != nzjiSingle)
+      {
+        std::cerr << "ERROR: Recursive B-spline GetJacobianBatch() returning incorrect result." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
   /** Jacobian. */
   JacobianType jacobianElastix;
   jacobianElastix.SetSize(Dimension, nzji.size());
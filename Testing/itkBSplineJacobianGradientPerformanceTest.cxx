@@ -61,13 +61,14 @@ main(int argc, char * argv[])
   typedef itk::AdvancedBSplineDeformableTransform<CoordinateRepresentationType, Dimension, SplineOrder> TransformType;
   typedef itk::RecursiveBSplineTransform<CoordinateRepresentationType, Dimension, SplineOrder> RecursiveTransformType;
 
-  typedef TransformType::NumberOfParametersType     NumberOfParametersType;
-  typedef TransformType::InputPointType             InputPointType;
-  typedef TransformType::ParametersType             ParametersType;
-  typedef TransformType::NonZeroJacobianIndicesType NonZeroJacobianIndicesType;
-  typedef TransformType::DerivativeType             DerivativeType;
-  typedef TransformType::JacobianType               JacobianType;
-  typedef TransformType::MovingImageGradientType    MovingImageGradientType;
+  typedef TransformType::NumberOfParametersType        NumberOfParametersType;
+  typedef TransformType::InputPointType                InputPointType;
+  typedef TransformType::ParametersType                ParametersType;
+  typedef TransformType::NonZeroJacobianIndicesType    NonZeroJacobianIndicesType;
+  typedef TransformType::DerivativeType                DerivativeType;
+  typedef TransformType::JacobianType                  JacobianType;
+  typedef TransformType::MovingImageGradientType       MovingImageGradientType;
+  typedef TransformType::JacobianOfSpatialJacobianType JacobianOfSpatialJacobianType;
 
   typedef itk::Image<CoordinateRepresentationType, Dimension> InputImageType;
   typedef InputImageType::RegionType                          RegionType;
@@ -143,14 +144,16 @@ main(int argc, char * argv[])
   movingImageGradient[0] = 29.43;
   movingImageGradient[1] = 18.21;
   movingImageGradient[2] = 1.7;
-  const NumberOfParametersType nnzji = transform->GetNumberOfNonZeroJacobianIndices();
-  JacobianType                 jacobian(Dimension, nnzji);
-  DerivativeType               imageJacobian_old(nnzji);
-  DerivativeType               imageJacobian_new(nnzji);
-  DerivativeType               imageJacobian_recursive(nnzji);
-  NonZeroJacobianIndicesType   nzji(nnzji);
-  itk::TimeProbesCollectorBase timeCollector;
-  double                       sum = 0.0;
+  const NumberOfParametersType  nnzji = transform->GetNumberOfNonZeroJacobianIndices();
+  JacobianType                  jacobian(Dimension, nnzji);
+  DerivativeType                imageJacobian_old(nnzji);
+  DerivativeType                imageJacobian_new(nnzji);
+  DerivativeType                imageJacobian_recursive(nnzji);
+  NonZeroJacobianIndicesType    nzji(nnzji);
+  JacobianOfSpatialJacobianType jsj_scalar, jsj_vectorized;
+  itk::TimeProbesCollectorBase  timeCollector;
+  itk::TimeProbe                timeProbeScalar, timeProbeVectorized, timeProbeJSJScalar, timeProbeJSJVectorized;
+  double                        sum = 0.0;
 
   /** Time the plain old way. */
   timeCollector.Start("JacobianGradient plain old");
@@ -211,8 +214,10 @@ main(int argc, char * argv[])
   }
   timeCollector.Stop("JacobianGradient recursive old");
 
-  /** Time the recursive new way. */
+  /** Time the recursive new way, with the scalar implementation. */
+  recursiveTransform->SetUseVectorizedImplementation(false);
   timeCollector.Start("JacobianGradient recursive new");
+  timeProbeScalar.Start();
   for (unsigned int i = 0; i < N; ++i)
   {
     /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
@@ -221,10 +226,57 @@ main(int argc, char * argv[])
 
     sum += imageJacobian_new(0); // just to avoid compiler to optimize away
   }
+  timeProbeScalar.Stop();
   timeCollector.Stop("JacobianGradient recursive new");
 
+  /** Time the recursive new way, with the vectorized implementation. */
+  recursiveTransform->SetUseVectorizedImplementation(true);
+  timeCollector.Start("JacobianGradient recursive vectorized");
+  timeProbeVectorized.Start();
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
+    recursiveTransform->EvaluateJacobianWithImageGradientProduct(
+      inputPoint, movingImageGradient, imageJacobian_recursive, nzji);
+
+    sum += imageJacobian_recursive(0); // just to avoid compiler to optimize away
+  }
+  timeProbeVectorized.Stop();
+  timeCollector.Stop("JacobianGradient recursive vectorized");
+
+  /** Time the Jacobian of the spatial Jacobian, with the scalar implementation. */
+  recursiveTransform->SetUseVectorizedImplementation(false);
+  timeCollector.Start("JacobianOfSpatialJacobian recursive");
+  timeProbeJSJScalar.Start();
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    recursiveTransform->GetJacobianOfSpatialJacobian(inputPoint, jsj_scalar, nzji);
+    sum += jsj_scalar[0](0, 0); // just to avoid compiler to optimize away
+  }
+  timeProbeJSJScalar.Stop();
+  timeCollector.Stop("JacobianOfSpatialJacobian recursive");
+
+  /** Time the Jacobian of the spatial Jacobian, with the vectorized implementation. */
+  recursiveTransform->SetUseVectorizedImplementation(true);
+  timeCollector.Start("JacobianOfSpatialJacobian recursive vectorized");
+  timeProbeJSJVectorized.Start();
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    recursiveTransform->GetJacobianOfSpatialJacobian(inputPoint, jsj_vectorized, nzji);
+    sum += jsj_vectorized[0](0, 0); // just to avoid compiler to optimize away
+  }
+  timeProbeJSJVectorized.Stop();
+  timeCollector.Stop("JacobianOfSpatialJacobian recursive vectorized");
+
   /** Report timings. */
   timeCollector.Report();
+  std::cerr << "Instruction set = " << RecursiveTransformType::ImplementationType::GetInstructionSet()
+            << " (0: scalar, 1: AVX2, 2: AVX-512)" << std::endl;
+  std::cerr << std::setprecision(4);
+  std::cerr << "Speedup factor vectorized JacobianGradient = "
+            << timeProbeScalar.GetMean() / timeProbeVectorized.GetMean() << std::endl;
+  std::cerr << "Speedup factor vectorized JacobianOfSpatialJacobian = "
+            << timeProbeJSJScalar.GetMean() / timeProbeJSJVectorized.GetMean() << std::endl;
 
   // Avoid compiler optimizations, so use sum
   std::cerr << sum << std::endl; // works but ugly on screen
@@ -249,6 +301,33 @@ main(int argc, char * argv[])
     return EXIT_FAILURE;
   }
 
+  /** The vectorized implementation should give the same results as the scalar one. */
+  diffNorm = (imageJacobian_new - imageJacobian_recursive).magnitude();
+  std::cerr << "Vectorized B-spline MSD with scalar: " << diffNorm << std::endl;
+  if (diffNorm > 1e-10)
+  {
+    std::cerr << "ERROR: Vectorized B-spline EvaluateJacobianWithImageGradientProduct() returning incorrect result."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (jsj_scalar.size() != jsj_vectorized.size())
+  {
+    std::cerr << "ERROR: Vectorized B-spline GetJacobianOfSpatialJacobian() returning incorrect size." << std::endl;
+    return EXIT_FAILURE;
+  }
+  double jsjDiffNorm = 0.0;
+  for (unsigned int i = 0; i < jsj_scalar.size(); ++i)
+  {
+    jsjDiffNorm += (jsj_scalar[i] - jsj_vectorized[i]).GetVnlMatrix().frobenius_norm();
+  }
+  std::cerr << "Vectorized B-spline JacobianOfSpatialJacobian difference with scalar: " << jsjDiffNorm << std::endl;
+  if (jsjDiffNorm > 1e-10)
+  {
+    std::cerr << "ERROR: Vectorized B-spline GetJacobianOfSpatialJacobian() returning incorrect result." << std::endl;
+    return EXIT_FAILURE;
+  }
+
   /** Return a value. */
   return EXIT_SUCCESS;
 
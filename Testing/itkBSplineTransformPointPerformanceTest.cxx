@@ -16,6 +16,7 @@
  *
  *=========================================================================*/
 #include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkRecursiveBSplineTransform.h"
 
 #include "itkImageRegionIterator.h"
 
@@ -190,7 +191,8 @@ main(int argc, char * argv[])
   }
 
   /** Typedefs. */
-  typedef itk::BSplineTransform_TEST<CoordinateRepresentationType, Dimension, SplineOrder> TransformType;
+  typedef itk::BSplineTransform_TEST<CoordinateRepresentationType, Dimension, SplineOrder>     TransformType;
+  typedef itk::RecursiveBSplineTransform<CoordinateRepresentationType, Dimension, SplineOrder> RecursiveTransformType;
 
   typedef TransformType::InputPointType  InputPointType;
   typedef TransformType::OutputPointType OutputPointType;
@@ -204,8 +206,9 @@ main(int argc, char * argv[])
   typedef InputImageType::PointType                           OriginType;
   typedef InputImageType::DirectionType                       DirectionType;
 
-  /** Create the transform. */
-  TransformType::Pointer transform = TransformType::New();
+  /** Create the transforms. */
+  TransformType::Pointer          transform = TransformType::New();
+  RecursiveTransformType::Pointer recursiveTransform = RecursiveTransformType::New();
 
   /** Setup the B-spline transform:
    * (GridSize 44 43 35)
@@ -238,6 +241,11 @@ main(int argc, char * argv[])
   transform->SetGridRegion(gridRegion);
   transform->SetGridDirection(gridDirection);
 
+  recursiveTransform->SetGridOrigin(gridOrigin);
+  recursiveTransform->SetGridSpacing(gridSpacing);
+  recursiveTransform->SetGridRegion(gridRegion);
+  recursiveTransform->SetGridDirection(gridDirection);
+
   /** Now read the parameters as defined in the file par.txt. */
   ParametersType parameters(transform->GetNumberOfParameters());
   std::ifstream  input(argv[1]);
@@ -255,13 +263,14 @@ main(int argc, char * argv[])
     return 1;
   }
   transform->SetParameters(parameters);
+  recursiveTransform->SetParameters(parameters);
 
   /** Declare variables. */
   InputPointType inputPoint;
   inputPoint.Fill(4.1);
   OutputPointType outputPoint;
   double          sum = 0.0;
-  itk::TimeProbe  timeProbeOLD, timeProbeNEW;
+  itk::TimeProbe  timeProbeOLD, timeProbeNEW, timeProbeScalar, timeProbeVectorized;
 
   /** Time the TransformPoint with the old region iterator. */
   timeProbeOLD.Start();
@@ -287,6 +296,34 @@ main(int argc, char * argv[])
   timeProbeNEW.Stop();
   const double newTime = timeProbeNEW.GetMean();
 
+  /** Time the recursive TransformPoint with the scalar implementation. */
+  recursiveTransform->SetUseVectorizedImplementation(false);
+  timeProbeScalar.Start();
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    outputPoint = recursiveTransform->TransformPoint(inputPoint);
+    sum += outputPoint[0];
+    sum += outputPoint[1];
+    sum += outputPoint[2];
+  }
+  timeProbeScalar.Stop();
+  const double          scalarTime = timeProbeScalar.GetMean();
+  const OutputPointType scalarOutputPoint = recursiveTransform->TransformPoint(inputPoint);
+
+  /** Time the recursive TransformPoint with the vectorized implementation. */
+  recursiveTransform->SetUseVectorizedImplementation(true);
+  timeProbeVectorized.Start();
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    outputPoint = recursiveTransform->TransformPoint(inputPoint);
+    sum += outputPoint[0];
+    sum += outputPoint[1];
+    sum += outputPoint[2];
+  }
+  timeProbeVectorized.Stop();
+  const double          vectorizedTime = timeProbeVectorized.GetMean();
+  const OutputPointType vectorizedOutputPoint = recursiveTransform->TransformPoint(inputPoint);
+
   // Avoid compiler optimizations, so use sum
   std::cerr << sum << std::endl; // works but ugly on screen
   //  volatile double a = sum; // works but gives unused variable warning
@@ -298,6 +335,19 @@ main(int argc, char * argv[])
   std::cerr << "Time OLD = " << oldTime << " " << timeProbeOLD.GetUnit() << std::endl;
   std::cerr << "Time NEW = " << newTime << " " << timeProbeNEW.GetUnit() << std::endl;
   std::cerr << "Speedup factor = " << oldTime / newTime << std::endl;
+  std::cerr << "Instruction set = " << RecursiveTransformType::ImplementationType::GetInstructionSet()
+            << " (0: scalar, 1: AVX2, 2: AVX-512)" << std::endl;
+  std::cerr << "Time recursive scalar = " << scalarTime << " " << timeProbeScalar.GetUnit() << std::endl;
+  std::cerr << "Time recursive vectorized = " << vectorizedTime << " " << timeProbeVectorized.GetUnit() << std::endl;
+  std::cerr << "Speedup factor vectorized = " << scalarTime / vectorizedTime << std::endl;
+
+  /** The vectorized implementation should give the same result, up to the summation order. */
+  const double distance = scalarOutputPoint.EuclideanDistanceTo(vectorizedOutputPoint);
+  if (distance > 1e-10)
+  {
+    std::cerr << "ERROR: the vectorized TransformPoint differs from the scalar one: " << distance << std::endl;
+    return 1;
+  }
 
   /** Return a value. */
   return 0;
@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImage.h"
+#include "itkImageSampleSoAContainer.h"
+#include "itkVectorDataContainer.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+// Report timings
+#include "itkTimeProbe.h"
+
+#include <cmath>
+#include <iomanip>
+
+//-------------------------------------------------------------------------------------
+// This test compares the speed of a typical metric inner loop over image samples,
+// stored as an array of structures (the regular sampler output) and as a
+// structure of arrays. The inner loop applies an affine map to each sample
+// and accumulates a squared difference, mimicking a mean squares metric.
+
+int
+main()
+{
+  /** Some basic type definitions. */
+  const unsigned int Dimension = 3;
+  typedef float      PixelType;
+
+  /** The number of samples. Distinguish between Debug and Release mode. */
+#ifndef NDEBUG
+  const std::size_t N = static_cast<std::size_t>(1e3);
+#else
+  const std::size_t N = static_cast<std::size_t>(1e5);
+#endif
+  const unsigned int numberOfRepetitions = 100;
+  std::cerr << "N = " << N << std::endl;
+
+  /** Typedefs. */
+  typedef itk::Image<PixelType, Dimension>                       ImageType;
+  typedef itk::ImageSample<ImageType>                            ImageSampleType;
+  typedef itk::VectorDataContainer<std::size_t, ImageSampleType> ImageSampleContainerType;
+  typedef itk::ImageSampleSoAContainer<ImageType>                ImageSampleSoAContainerType;
+  typedef ImageSampleType::PointType                             PointType;
+  typedef ImageSampleType::RealType                              RealType;
+  typedef ImageSampleSoAContainerType::CoordinateValueType       CoordinateValueType;
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+
+  /** Create the samples. */
+  RandomGeneratorType::Pointer randomGenerator = RandomGeneratorType::GetInstance();
+  randomGenerator->SetSeed(12345);
+
+  ImageSampleContainerType::Pointer aosContainer = ImageSampleContainerType::New();
+  aosContainer->resize(N);
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      aosContainer->ElementAt(i).m_ImageCoordinates[d] = randomGenerator->GetUniformVariate(-100.0, 100.0);
+    }
+    aosContainer->ElementAt(i).m_ImageValue = randomGenerator->GetUniformVariate(0.0, 1000.0);
+  }
+
+  ImageSampleSoAContainerType::Pointer soaContainer = ImageSampleSoAContainerType::New();
+  soaContainer->CopyFrom(*aosContainer);
+
+  /** Check that the conversion is exact. */
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    PointType point;
+    soaContainer->GetPoint(i, point);
+    if (point != aosContainer->ElementAt(i).m_ImageCoordinates ||
+        soaContainer->GetValues()[i] != aosContainer->ElementAt(i).m_ImageValue)
+    {
+      std::cerr << "ERROR: sample " << i << " differs between the two containers." << std::endl;
+      return 1;
+    }
+  }
+
+  /** An affine map. */
+  double matrix[Dimension][Dimension] = { { 1.01, 0.02, -0.03 }, { -0.01, 0.99, 0.04 }, { 0.02, -0.02, 1.03 } };
+  double offset[Dimension] = { 1.5, -2.5, 3.5 };
+
+  itk::TimeProbe timeProbeAoS, timeProbeSoA;
+  double         sumAoS = 0.0;
+  double         sumSoA = 0.0;
+
+  /** Time the loop over the array of structures. */
+  timeProbeAoS.Start();
+  for (unsigned int r = 0; r < numberOfRepetitions; ++r)
+  {
+    const ImageSampleType * samples = aosContainer->data();
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      const PointType & point = samples[i].m_ImageCoordinates;
+      double            measure = 0.0;
+      for (unsigned int j = 0; j < Dimension; ++j)
+      {
+        double mapped = offset[j];
+        for (unsigned int k = 0; k < Dimension; ++k)
+        {
+          mapped += matrix[j][k] * point[k];
+        }
+        measure += mapped;
+      }
+      const double diff = measure - samples[i].m_ImageValue;
+      sumAoS += diff * diff;
+    }
+  }
+  timeProbeAoS.Stop();
+  const double aosTime = timeProbeAoS.GetMean();
+
+  /** Time the loop over the structure of arrays. */
+  timeProbeSoA.Start();
+  for (unsigned int r = 0; r < numberOfRepetitions; ++r)
+  {
+    const CoordinateValueType * x = soaContainer->GetCoordinates(0);
+    const CoordinateValueType * y = soaContainer->GetCoordinates(1);
+    const CoordinateValueType * z = soaContainer->GetCoordinates(2);
+    const RealType *            values = soaContainer->GetValues();
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      double measure = 0.0;
+      for (unsigned int j = 0; j < Dimension; ++j)
+      {
+        measure += offset[j] + matrix[j][0] * x[i] + matrix[j][1] * y[i] + matrix[j][2] * z[i];
+      }
+      const double diff = measure - values[i];
+      sumSoA += diff * diff;
+    }
+  }
+  timeProbeSoA.Stop();
+  const double soaTime = timeProbeSoA.GetMean();
+
+  /** Check that both layouts give the same result. */
+  std::cerr << std::setprecision(10);
+  std::cerr << "Sum AoS = " << sumAoS << std::endl;
+  std::cerr << "Sum SoA = " << sumSoA << std::endl;
+  if (std::abs(sumAoS - sumSoA) > 1e-8 * std::abs(sumAoS))
+  {
+    std::cerr << "ERROR: the results of both layouts differ." << std::endl;
+    return 1;
+  }
+
+  /** Report timings. */
+  std::cerr << std::setprecision(4);
+  std::cerr << "Time AoS = " << aosTime << " " << timeProbeAoS.GetUnit() << std::endl;
+  std::cerr << "Time SoA = " << soaTime << " " << timeProbeSoA.GetUnit() << std::endl;
+  std::cerr << "Speedup factor = " << aosTime / soaTime << std::endl;
+
+  /** Return a value. */
+  return 0;
+
+} // end main
@@ -0,0 +1,373 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkTransformixFilter.h"
+#include "elxParameterObject.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkDefaultStaticMeshTraits.h"
+#include "itkPointSet.h"
+#include "itkTransformixBinaryPointFile.h"
+#include "itkTransformixInputPointFileReader.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itksys/SystemTools.hxx"
+
+// Report timings
+#include "itkTimeProbe.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------------------------
+// This test compares the speed of transformix for a text input point file, with
+// the verbose output line per point and with WriteOutputPointsOnly, to the speed
+// for the equivalent binary input point file. All runs go through the
+// TransformixFilter, and their output points are compared to the transform.
+
+namespace
+{
+const unsigned int Dimension = 3;
+typedef float                                         PixelType;
+typedef itk::Image<PixelType, Dimension>              ImageType;
+typedef itk::TransformixFilter<ImageType>             TransformixFilterType;
+typedef elastix::ParameterObject                      ParameterObjectType;
+typedef ParameterObjectType::ParameterMapType         ParameterMapType;
+typedef ParameterObjectType::ParameterValueVectorType ParameterValueVectorType;
+
+// Converts a vector of numbers to parameter values.
+template <class TContainer>
+ParameterValueVectorType
+ToParameterValues(const TContainer & container, const unsigned int size)
+{
+  ParameterValueVectorType values(size);
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    std::ostringstream stream;
+    stream << std::setprecision(17) << container[i];
+    values[i] = stream.str();
+  }
+  return values;
+}
+
+
+// Runs transformix on the input point file, writing to the output directory, and returns the time it took.
+double
+RunTransformix(const ParameterMapType & parameterMap,
+               const std::string &      inputPointFileName,
+               const std::string &      outputDirectory)
+{
+  itksys::SystemTools::MakeDirectory(outputDirectory);
+
+  const auto parameterObject = ParameterObjectType::New();
+  parameterObject->SetParameterMap(parameterMap);
+
+  const auto transformix = TransformixFilterType::New();
+  transformix->SetTransformParameterObject(parameterObject);
+  transformix->SetFixedPointSetFileName(inputPointFileName);
+  transformix->SetOutputDirectory(outputDirectory);
+
+  itk::TimeProbe timer;
+  timer.Start();
+  transformix->Update();
+  timer.Stop();
+  return timer.GetMean();
+}
+
+
+// Reads the output points of the verbose outputpoints.txt, from the "OutputPoint = [ x y z ]" fields.
+std::vector<double>
+ReadVerboseOutputPoints(const std::string & fileName)
+{
+  std::vector<double> coordinates;
+  std::ifstream       file(fileName);
+  std::string         line;
+  const std::string   field = "OutputPoint = [";
+  while (std::getline(file, line))
+  {
+    const std::size_t position = line.find(field);
+    if (position == std::string::npos)
+    {
+      continue;
+    }
+    std::istringstream stream(line.substr(position + field.size()));
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      double coordinate = 0.0;
+      stream >> coordinate;
+      coordinates.push_back(coordinate);
+    }
+  }
+  return coordinates;
+}
+
+
+// Reads the output points of an outputpoints.txt written with WriteOutputPointsOnly.
+std::vector<double>
+ReadOutputPointsOnly(const std::string & fileName)
+{
+  std::vector<double> coordinates;
+  std::ifstream       file(fileName);
+  double              coordinate = 0.0;
+  while (file >> coordinate)
+  {
+    coordinates.push_back(coordinate);
+  }
+  return coordinates;
+}
+
+
+// Reads the output points of an outputpoints.bin.
+std::vector<double>
+ReadBinaryOutputPoints(const std::string & fileName)
+{
+  std::ifstream file(fileName, std::ios::in | std::ios::binary);
+  unsigned int  dimension = 0;
+  bool          pointsAreIndices = false;
+  uint64_t      numberOfPoints = 0;
+  if (!itk::TransformixBinaryPointFile::ReadHeader(file, dimension, pointsAreIndices, numberOfPoints) ||
+      dimension != Dimension)
+  {
+    return std::vector<double>();
+  }
+  std::vector<float> coordinates(numberOfPoints * dimension);
+  file.read(reinterpret_cast<char *>(coordinates.data()),
+            static_cast<std::streamsize>(coordinates.size() * sizeof(float)));
+  return file ? std::vector<double>(coordinates.begin(), coordinates.end()) : std::vector<double>();
+}
+
+
+// Returns the maximum difference between the output points and the expected points, or -1 if the numbers differ.
+double
+ComputeMaximumDifference(const std::vector<double> & coordinates, const std::vector<double> & expectedCoordinates)
+{
+  if (coordinates.size() != expectedCoordinates.size())
+  {
+    return -1.0;
+  }
+  double maxDifference = 0.0;
+  for (std::size_t i = 0; i < coordinates.size(); ++i)
+  {
+    maxDifference = std::max(maxDifference, std::abs(coordinates[i] - expectedCoordinates[i]));
+  }
+  return maxDifference;
+}
+
+} // end namespace
+
+
+int
+main(int argc, char * argv[])
+{
+  /** Check. */
+  if (argc != 2)
+  {
+    std::cerr << "ERROR: Usage: " << argv[0] << " <outputDirectory>" << std::endl;
+    return 1;
+  }
+  const std::string outputDirectory = std::string(argv[1]) + "/TransformixPointFilePerformanceTest";
+  itksys::SystemTools::MakeDirectory(outputDirectory);
+
+  /** The number of points. Distinguish between Debug and Release mode. */
+#ifndef NDEBUG
+  const unsigned long N = static_cast<unsigned long>(1e3);
+#else
+  const unsigned long N = static_cast<unsigned long>(1e6);
+#endif
+  std::cerr << "N = " << N << std::endl;
+
+  /** Typedefs. */
+  typedef itk::AdvancedBSplineDeformableTransform<double, Dimension, 3>             TransformType;
+  typedef TransformType::InputPointType                                             InputPointType;
+  typedef TransformType::OutputPointType                                            OutputPointType;
+  typedef itk::DefaultStaticMeshTraits<unsigned char, Dimension, Dimension, double> MeshTraitsType;
+  typedef itk::PointSet<unsigned char, Dimension, MeshTraitsType>                   PointSetType;
+  typedef itk::TransformixInputPointFileReader<PointSetType>                        ReaderType;
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator                    RandomGeneratorType;
+
+  /** Create a B-spline transform on a 20 x 20 x 20 grid, to compute the expected output points. */
+  TransformType::OriginType origin;
+  origin.Fill(-10.0);
+  TransformType::SpacingType spacing;
+  spacing.Fill(10.0);
+  TransformType::SizeType gridSize;
+  gridSize.Fill(20);
+  TransformType::RegionType region;
+  region.SetSize(gridSize);
+
+  const auto transform = TransformType::New();
+  transform->SetGridOrigin(origin);
+  transform->SetGridSpacing(spacing);
+  transform->SetGridRegion(region);
+
+  TransformType::ParametersType parameters(transform->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = std::sin(0.37 * i);
+  }
+  transform->SetParameters(parameters);
+
+  /** The same transform as transform parameter map, on a fixed image of 160 x 160 x 160 voxels. */
+  ParameterMapType parameterMap;
+  parameterMap["Transform"] = { "BSplineTransform" };
+  parameterMap["NumberOfParameters"] = { std::to_string(parameters.GetSize()) };
+  parameterMap["TransformParameters"] = ToParameterValues(parameters, parameters.GetSize());
+  parameterMap["InitialTransformParametersFileName"] = { "NoInitialTransform" };
+  parameterMap["HowToCombineTransforms"] = { "Compose" };
+  parameterMap["FixedImageDimension"] = { std::to_string(Dimension) };
+  parameterMap["MovingImageDimension"] = { std::to_string(Dimension) };
+  parameterMap["FixedInternalImagePixelType"] = { "float" };
+  parameterMap["MovingInternalImagePixelType"] = { "float" };
+  parameterMap["Size"] = { "160", "160", "160" };
+  parameterMap["Index"] = { "0", "0", "0" };
+  parameterMap["Spacing"] = { "1", "1", "1" };
+  parameterMap["Origin"] = { "0", "0", "0" };
+  parameterMap["Direction"] = { "1", "0", "0", "0", "1", "0", "0", "0", "1" };
+  parameterMap["UseDirectionCosines"] = { "true" };
+  parameterMap["BSplineTransformSplineOrder"] = { "3" };
+  parameterMap["UseCyclicTransform"] = { "false" };
+  parameterMap["GridSize"] = ToParameterValues(gridSize, Dimension);
+  parameterMap["GridIndex"] = { "0", "0", "0" };
+  parameterMap["GridSpacing"] = ToParameterValues(spacing, Dimension);
+  parameterMap["GridOrigin"] = ToParameterValues(origin, Dimension);
+  parameterMap["GridDirection"] = { "1", "0", "0", "0", "1", "0", "0", "0", "1" };
+  parameterMap["ResampleInterpolator"] = { "FinalBSplineInterpolator" };
+  parameterMap["FinalBSplineInterpolationOrder"] = { "3" };
+  parameterMap["Resampler"] = { "DefaultResampler" };
+  parameterMap["DefaultPixelValue"] = { "0" };
+  parameterMap["ResultImageFormat"] = { "mhd" };
+  parameterMap["ResultImagePixelType"] = { "float" };
+  parameterMap["CompressResultImage"] = { "false" };
+
+  /** Create random points inside the valid region of the transform, and their expected output points. */
+  const auto randomGenerator = RandomGeneratorType::GetInstance();
+  randomGenerator->SetSeed(1234);
+  std::vector<float> coordinates(N * Dimension);
+  for (auto & coordinate : coordinates)
+  {
+    coordinate = static_cast<float>(randomGenerator->GetUniformVariate(10.0, 150.0));
+  }
+  std::vector<double> expectedCoordinates(N * Dimension);
+  for (unsigned long j = 0; j < N; ++j)
+  {
+    InputPointType inputPoint;
+    for (unsigned int i = 0; i < Dimension; i++)
+    {
+      inputPoint[i] = coordinates[j * Dimension + i];
+    }
+    const OutputPointType outputPoint = transform->TransformPoint(inputPoint);
+    for (unsigned int i = 0; i < Dimension; i++)
+    {
+      expectedCoordinates[j * Dimension + i] = outputPoint[i];
+    }
+  }
+
+  /** Write the input points as text and as binary point file. */
+  const std::string textInputFileName = outputDirectory + "/inputpoints.txt";
+  const std::string binaryInputFileName = outputDirectory + "/inputpoints.bin";
+  {
+    std::ofstream textFile(textInputFileName);
+    textFile << std::setprecision(9) << "point\n" << N << "\n";
+    for (unsigned long j = 0; j < N; ++j)
+    {
+      textFile << coordinates[j * Dimension] << " " << coordinates[j * Dimension + 1] << " "
+               << coordinates[j * Dimension + 2] << "\n";
+    }
+    std::ofstream binaryFile(binaryInputFileName, std::ios::out | std::ios::binary);
+    itk::TransformixBinaryPointFile::WriteHeader(binaryFile, Dimension, false, N);
+    binaryFile.write(reinterpret_cast<const char *>(coordinates.data()),
+                     static_cast<std::streamsize>(coordinates.size() * sizeof(float)));
+  }
+
+  /** Run transformix for the text input with verbose output, the text input with only
+   * the output points, and the binary input.
+   */
+  double textTime = 0.0;
+  double textOnlyTime = 0.0;
+  double binaryTime = 0.0;
+  try
+  {
+    textTime = RunTransformix(parameterMap, textInputFileName, outputDirectory + "/text");
+
+    ParameterMapType outputPointsOnlyParameterMap = parameterMap;
+    outputPointsOnlyParameterMap["WriteOutputPointsOnly"] = { "true" };
+    textOnlyTime = RunTransformix(outputPointsOnlyParameterMap, textInputFileName, outputDirectory + "/textonly");
+
+    binaryTime = RunTransformix(parameterMap, binaryInputFileName, outputDirectory + "/binary");
+  }
+  catch (itk::ExceptionObject & excp)
+  {
+    std::cerr << "ERROR: transformix failed:\n" << excp << std::endl;
+    return 1;
+  }
+
+  /** Report timings. */
+  std::cerr << std::setprecision(4);
+  std::cerr << "Time text input, verbose output:     " << textTime << " s" << std::endl;
+  std::cerr << "Time text input, output points only: " << textOnlyTime << " s" << std::endl;
+  std::cerr << "Time binary input and output:        " << binaryTime << " s" << std::endl;
+  std::cerr << "Speedup factor binary vs verbose:    " << textTime / binaryTime << std::endl;
+
+  /** Check the output points of all runs, up to the six decimals of the text output,
+   * and the float precision of the binary output.
+   */
+  const double textDifference = ComputeMaximumDifference(
+    ReadVerboseOutputPoints(outputDirectory + "/text/outputpoints.txt"), expectedCoordinates);
+  const double textOnlyDifference = ComputeMaximumDifference(
+    ReadOutputPointsOnly(outputDirectory + "/textonly/outputpoints.txt"), expectedCoordinates);
+  const double binaryDifference = ComputeMaximumDifference(
+    ReadBinaryOutputPoints(outputDirectory + "/binary/outputpoints.bin"), expectedCoordinates);
+  std::cerr << "Maximum difference verbose output:     " << textDifference << std::endl;
+  std::cerr << "Maximum difference output points only: " << textOnlyDifference << std::endl;
+  std::cerr << "Maximum difference binary output:      " << binaryDifference << std::endl;
+
+  const double tolerance = 1e-4;
+  if (textDifference < 0.0 || textDifference > tolerance || textOnlyDifference < 0.0 ||
+      textOnlyDifference > tolerance || binaryDifference < 0.0 || binaryDifference > tolerance)
+  {
+    std::cerr << "ERROR: the output points of transformix differ from the transform." << std::endl;
+    return 1;
+  }
+
+  /** Check that a binary point file with fewer coordinates than its header specifies is refused. */
+  const std::string truncatedFileName = outputDirectory + "/inputpoints_truncated.bin";
+  {
+    std::ofstream truncatedFile(truncatedFileName, std::ios::out | std::ios::binary);
+    itk::TransformixBinaryPointFile::WriteHeader(truncatedFile, Dimension, false, N + 1);
+    truncatedFile.write(reinterpret_cast<const char *>(coordinates.data()),
+                        static_cast<std::streamsize>(coordinates.size() * sizeof(float)));
+  }
+  const auto reader = ReaderType::New();
+  reader->SetFileName(truncatedFileName);
+  try
+  {
+    reader->Update();
+    std::cerr << "ERROR: the truncated binary point file was not refused." << std::endl;
+    return 1;
+  }
+  catch (itk::ExceptionObject &)
+  {
+    /** The expected exception. */
+  }
+
+  /** Return a value. */
+  return 0;
+
+} // end main